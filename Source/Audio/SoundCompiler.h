@@ -13,6 +13,8 @@ namespace aud
 	class SoundCompiler final: public res::IResourceCompiler
 	{
 	public:
+		static const constexpr Char* COMPILER_MARK = TXT( "snd_1" );
+
 		SoundCompiler();
 		~SoundCompiler();
 
@@ -25,6 +27,11 @@ namespace aud
 
 			return ext == TXT( "wav" );
 		}
+
+		String compilerMark() const override
+		{
+			return COMPILER_MARK;
+		}
 	};
 }
 }
\ No newline at end of file
@@ -4650,6 +4650,7 @@ void CCompiler::CompileFunctionDecl()
 
 	// Get function name.
 	Function->Name = GetIdentifier( L"function name" );
+	Function->InternedName = NameId( Function->Name );
 	if( (FindFunction( Script->Methods, Function->Name ) != Function && FindFunction( Script->Methods, Function->Name ) != nullptr) ||
 		(FindFunction( Script->StaticFunctions, Function->Name ) != Function && FindFunction( Script->StaticFunctions, Function->Name ) != nullptr)	)
 			Error( L"Function '%s' redeclarated", *Function->Name );
@@ -6081,6 +6082,9 @@ Bool Compiler::CompileAllScripts
 	if( !InDatabase )
 		return false;
 
+	// Old bytecode is about to be destroyed.
+	profile::ScriptProfiler::instance().forgetCode();
+
 	CCompiler Compiler( InDatabase, OutWarnings, OutFatalError );
 
 	return Compiler.CompileAll();
@@ -6095,6 +6099,8 @@ Bool Compiler::DropAllScripts( CObjectDatabase* InDatabase )
 	if( !InDatabase )
 		return false;
 
+	profile::ScriptProfiler::instance().forgetCode();
+
 	// Walk through all objects.
 	for( Int32 i=0; i<InDatabase->GObjects.size(); i++ )
 	{
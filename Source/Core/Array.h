@@ -359,6 +359,22 @@ namespace flu
 			return *this;
 		}
 
+		Array<T>& operator=( Array<T>&& other )
+		{
+			if( this != &other )
+			{
+				empty();
+
+				m_data = other.m_data;
+				m_size = other.m_size;
+
+				other.m_data = nullptr;
+				other.m_size = 0;
+			}
+
+			return *this;
+		}
+
 		void setSize( Int32 newSize )
 		{
 			assert( newSize >= 0 );
@@ -45,6 +45,11 @@ namespace concurrency
 		return m_value;
 	}
 
+	Int32 Atomic::compareExchange( Int32 exchange, Int32 comparand )
+	{
+		return (Int32)InterlockedCompareExchange( (LPLONG)&m_value, exchange, comparand );
+	}
+
 #else
 #error Atomic is not implemented for current platform
 #endif
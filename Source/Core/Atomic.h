@@ -30,6 +30,12 @@ namespace concurrency
 		Int32 setValue( Int32 newValue );
 		Int32 getValue() const;
 
+		/**
+		 *	Set exchange value if current value equals comparand,
+		 *	return the initial value
+		 */
+		Int32 compareExchange( Int32 exchange, Int32 comparand );
+
 	private:
 		volatile Int32 m_value;
 	};
@@ -113,7 +113,7 @@ namespace flu
 
 		void seek( SizeT offset ) override
 		{
-			assert( offset > 0 && offset < SizeT( m_data.size() ) );
+			assert( offset <= SizeT( m_data.size() ) );
 			m_position = offset;
 		}
 
@@ -40,6 +40,7 @@
 #define FLU_ENABLE_PROFILER 1 || FLU_DEBUG
 #define FLU_PROFILE_MEMORY FLU_DEBUG
 #define FLU_PROFILE_GPU FLU_DEBUG
+#define FLU_PROFILE_SCRIPT FLU_ENABLE_PROFILER
 
 // Memory leaks
 #define FLU_ENABLE_MEM_TRACKING FLU_DEBUG && FLU_PLATFORM_WINDOWS && !FLU_PLATFORM_XBOX
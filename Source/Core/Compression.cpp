@@ -0,0 +1,344 @@
+//-----------------------------------------------------------------------------
+//	Compression.cpp: A fast LZ77 data compression implementation
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Core.h"
+
+namespace flu
+{
+namespace lz
+{
+	static const SizeT MIN_MATCH = 4;
+	static const SizeT LAST_LITERALS = 5;
+	static const SizeT MATCH_LIMIT = 12;
+	static const SizeT MAX_OFFSET = 65535;
+
+	static const UInt32 HASH_LOG = 12;
+	static const UInt32 HC_HASH_LOG = 15;
+	static const Int32 HC_ATTEMPTS = 64;
+
+	// chain keeps previous positions within the max offset only
+	static const SizeT HC_WINDOW_SIZE = 64 * 1024;
+	static const SizeT HC_WINDOW_MASK = HC_WINDOW_SIZE - 1;
+
+	struct HighRatioWork
+	{
+	public:
+		UInt32 head[1 << HC_HASH_LOG];
+		UInt32 chain[HC_WINDOW_SIZE];
+	};
+
+	static inline UInt32 read32( const UInt8* data )
+	{
+		UInt32 result;
+		mem::copy( &result, data, sizeof( UInt32 ) );
+		return result;
+	}
+
+	static inline UInt32 hashSequence( UInt32 sequence, UInt32 hashLog )
+	{
+		return ( sequence * 2654435761u ) >> ( 32 - hashLog );
+	}
+
+	static inline SizeT countEqual( const UInt8* a, const UInt8* b, const UInt8* limit )
+	{
+		const UInt8* start = a;
+
+		while( a + 4 <= limit && read32( a ) == read32( b ) )
+		{
+			a += 4;
+			b += 4;
+		}
+
+		while( a < limit && *a == *b )
+		{
+			++a;
+			++b;
+		}
+
+		return a - start;
+	}
+
+	static inline UInt8* writeLength( UInt8* output, SizeT length )
+	{
+		for( ; length >= 255; length -= 255 )
+		{
+			*output++ = 255;
+		}
+
+		*output++ = static_cast<UInt8>( length );
+		return output;
+	}
+
+	static inline Bool readLength( const UInt8*& input, const UInt8* inputEnd, SizeT& length )
+	{
+		UInt8 byte;
+
+		do
+		{
+			if( input == inputEnd )
+			{
+				return false;
+			}
+
+			byte = *input++;
+			length += byte;
+		} while( byte == 255 );
+
+		return true;
+	}
+
+	static inline UInt8* writeLiterals( UInt8* output, UInt8* token, const UInt8* literals, SizeT length )
+	{
+		*token = static_cast<UInt8>( min<SizeT>( length, 15 ) << 4 );
+
+		if( length >= 15 )
+		{
+			output = writeLength( output, length - 15 );
+		}
+
+		mem::copy( output, literals, length );
+		return output + length;
+	}
+
+	SizeT compress( const UInt8* source, SizeT sourceSize, UInt8* destination,
+		SizeT destinationCapacity, Bool highRatio )
+	{
+		assert( ( source || sourceSize == 0 ) && destination );
+
+		const UInt8* input = source;
+		const UInt8* anchor = source;
+		const UInt8* const inputEnd = source + sourceSize;
+
+		UInt8* output = destination;
+		UInt8* const outputEnd = destination + destinationCapacity;
+
+		if( sourceSize > MATCH_LIMIT )
+		{
+			const UInt8* const matchLimit = inputEnd - MATCH_LIMIT;
+			const UInt8* const matchEnd = inputEnd - LAST_LITERALS;
+
+			const UInt32 hashLog = highRatio ? HC_HASH_LOG : HASH_LOG;
+
+			UInt32 fastHead[1 << HASH_LOG] = {};
+			HighRatioWork* work = nullptr;
+
+			if( highRatio )
+			{
+				work = reinterpret_cast<HighRatioWork*>( mem::alloc( sizeof( HighRatioWork ) ) );
+				mem::zero( work->head, sizeof( work->head ) );
+			}
+
+			SizeT nextInsert = 0;
+
+			while( input < matchLimit )
+			{
+				const SizeT position = input - source;
+				const UInt32 sequence = read32( input );
+
+				SizeT bestLength = 0;
+				SizeT bestPosition = 0;
+
+				if( highRatio )
+				{
+					// insert all skipped positions to the chains
+					for( ; nextInsert <= position; ++nextInsert )
+					{
+						const UInt32 hash = hashSequence( read32( source + nextInsert ), hashLog );
+						work->chain[nextInsert & HC_WINDOW_MASK] = work->head[hash];
+						work->head[hash] = static_cast<UInt32>( nextInsert );
+					}
+
+					// walk through the chain and find the longest match
+					SizeT candidate = work->chain[position & HC_WINDOW_MASK];
+
+					for( Int32 i = 0; i < HC_ATTEMPTS && candidate < position && position - candidate <= MAX_OFFSET; ++i )
+					{
+						if( read32( source + candidate ) == sequence )
+						{
+							const SizeT length = MIN_MATCH + countEqual( input + MIN_MATCH,
+								source + candidate + MIN_MATCH, matchEnd );
+
+							if( length > bestLength )
+							{
+								bestLength = length;
+								bestPosition = candidate;
+							}
+						}
+
+						const SizeT next = work->chain[candidate & HC_WINDOW_MASK];
+
+						if( next >= candidate )
+						{
+							break;
+						}
+
+						candidate = next;
+					}
+				}
+				else
+				{
+					// single candidate from the hash
+					const UInt32 hash = hashSequence( sequence, hashLog );
+					const SizeT candidate = fastHead[hash];
+					fastHead[hash] = static_cast<UInt32>( position );
+
+					if( candidate < position && position - candidate <= MAX_OFFSET &&
+						read32( source + candidate ) == sequence )
+					{
+						bestLength = MIN_MATCH + countEqual( input + MIN_MATCH, source + candidate + MIN_MATCH, matchEnd );
+						bestPosition = candidate;
+					}
+				}
+
+				if( bestLength < MIN_MATCH )
+				{
+					// no match, skip faster through incompressible data
+					input += highRatio ? 1 : 1 + ( ( input - anchor ) >> 6 );
+					continue;
+				}
+
+				// emit a sequence
+				const SizeT literalsLength = input - anchor;
+				const SizeT matchLength = bestLength - MIN_MATCH;
+				const SizeT offset = position - bestPosition;
+
+				if( SizeT( outputEnd - output ) < 1 + literalsLength + literalsLength / 255 + 1 + 2 + matchLength / 255 + 1 )
+				{
+					if( work )
+					{
+						mem::free( work );
+					}
+
+					return 0;
+				}
+
+				UInt8* token = output++;
+				output = writeLiterals( output, token, anchor, literalsLength );
+
+				*output++ = static_cast<UInt8>( offset & 0xff );
+				*output++ = static_cast<UInt8>( offset >> 8 );
+
+				*token |= static_cast<UInt8>( min<SizeT>( matchLength, 15 ) );
+
+				if( matchLength >= 15 )
+				{
+					output = writeLength( output, matchLength - 15 );
+				}
+
+				input += bestLength;
+				anchor = input;
+			}
+
+			if( work )
+			{
+				mem::free( work );
+			}
+		}
+
+		// the last sequence has literals only
+		const SizeT literalsLength = inputEnd - anchor;
+
+		if( SizeT( outputEnd - output ) < 1 + literalsLength + literalsLength / 255 + 1 )
+		{
+			return 0;
+		}
+
+		UInt8* token = output++;
+		output = writeLiterals( output, token, anchor, literalsLength );
+
+		return output - destination;
+	}
+
+	Bool decompress( const UInt8* source, SizeT sourceSize, UInt8* destination, SizeT destinationSize )
+	{
+		assert( source && ( destination || destinationSize == 0 ) );
+
+		const UInt8* input = source;
+		const UInt8* const inputEnd = source + sourceSize;
+
+		UInt8* output = destination;
+		UInt8* const outputEnd = destination + destinationSize;
+
+		for( ; ; )
+		{
+			if( input == inputEnd )
+			{
+				// at least one sequence is expected
+				return false;
+			}
+
+			const UInt8 token = *input++;
+
+			SizeT literalsLength = token >> 4;
+
+			if( literalsLength == 15 && !readLength( input, inputEnd, literalsLength ) )
+			{
+				return false;
+			}
+
+			if( SizeT( inputEnd - input ) < literalsLength || SizeT( outputEnd - output ) < literalsLength )
+			{
+				return false;
+			}
+
+			mem::copy( output, input, literalsLength );
+			input += literalsLength;
+			output += literalsLength;
+
+			if( input == inputEnd )
+			{
+				// the last sequence has no match
+				break;
+			}
+
+			if( inputEnd - input < 2 )
+			{
+				return false;
+			}
+
+			const SizeT offset = input[0] | ( input[1] << 8 );
+			input += 2;
+
+			if( offset == 0 || offset > SizeT( output - destination ) )
+			{
+				return false;
+			}
+
+			SizeT matchLength = token & 15;
+
+			if( matchLength == 15 && !readLength( input, inputEnd, matchLength ) )
+			{
+				return false;
+			}
+
+			matchLength += MIN_MATCH;
+
+			if( SizeT( outputEnd - output ) < matchLength )
+			{
+				return false;
+			}
+
+			const UInt8* match = output - offset;
+
+			if( offset >= matchLength )
+			{
+				mem::copy( output, match, matchLength );
+			}
+			else
+			{
+				// overlapped match, copy byte by byte
+				for( SizeT i = 0; i < matchLength; ++i )
+				{
+					output[i] = match[i];
+				}
+			}
+
+			output += matchLength;
+		}
+
+		return output == outputEnd;
+	}
+}
+}
@@ -0,0 +1,32 @@
+//-----------------------------------------------------------------------------
+//	Compression.h: A fast LZ77 data compression
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+namespace lz
+{
+	/**
+	 *	Return the worst case size of compressed data
+	 */
+	inline SizeT compressBound( SizeT size )
+	{
+		return size + size / 255 + 16;
+	}
+
+	/**
+	 *	Compress data, the format is close to LZ4 block. High ratio mode searches
+	 *	for longer matches, it's slower for compression only. Return size of
+	 *	compressed data or 0 if it doesn't fit destination
+	 */
+	extern SizeT compress( const UInt8* source, SizeT sourceSize, UInt8* destination,
+		SizeT destinationCapacity, Bool highRatio = false );
+
+	/**
+	 *	Decompress data. Return false if data is corrupted or
+	 *	doesn't match the expected size
+	 */
+	extern Bool decompress( const UInt8* source, SizeT sourceSize, UInt8* destination, SizeT destinationSize );
+}
+}
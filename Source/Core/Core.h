@@ -27,6 +27,7 @@
 #include "Atomic.h"
 #include "Concurrency.h"
 #include "Threading.h"
+#include "LogQueue.h"
 #include "Stack.h"
 #include "Array.h"
 #include "GrowOnlyArray.h"
@@ -35,18 +36,23 @@
 #include "Profiler.h"
 #include "StringManager.h"
 #include "String.h"
+#include "Name.h"
 #include "HandleArray.h"
 #include "Text.h"
 #include "Time.h"
 #include "FileManager.h"
 #include "TextWriter.h"
 #include "Buffer.h"
+#include "Compression.h"
 #include "ConfigManager.h"
+#include "TraceProfiler.h"
 
 #include "Lexer/Token.h"
 #include "Lexer/Lexer.h"
 
+#include "JSon/JSonDocument.h"
 #include "JSon/JSon.h"
+#include "JSon/JSonStream.h"
 
 #include "JobSystem/JobSystem.h"
 
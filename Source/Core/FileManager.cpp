@@ -479,5 +479,170 @@ namespace fm
 		}
 	}
 
+	Bool touchFile( const Char* fileName )
+	{
+		HANDLE file = CreateFile( fileName, FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, 
+			nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+
+		if( file == INVALID_HANDLE_VALUE )
+		{
+			return false;
+		}
+
+		FILETIME now;
+		GetSystemTimeAsFileTime( &now );
+
+		const Bool result = SetFileTime( file, nullptr, nullptr, &now ) != 0;
+		CloseHandle( file );
+
+		return result;
+	}
+
+	Int64 getFileSize( const Char* fileName )
+	{
+		WIN32_FILE_ATTRIBUTE_DATA fileData;
+
+		if( GetFileAttributesEx( fileName, GetFileExInfoStandard, &fileData ) )
+		{
+			return ( Int64( fileData.nFileSizeHigh ) << 32 ) | fileData.nFileSizeLow;
+		}
+		else
+		{
+			return -1;
+		}
+	}
+
+	Bool deleteFile( const Char* fileName )
+	{
+		return DeleteFile( fileName ) != 0;
+	}
+
+	Bool moveFile( const Char* sourceFileName, const Char* destFileName )
+	{
+		return MoveFileEx( sourceFileName, destFileName, MOVEFILE_REPLACE_EXISTING ) != 0;
+	}
+
+#if FLU_PLATFORM_WINDOWS && !FLU_PLATFORM_XBOX
+	/**
+	 *	A directory watcher based on ReadDirectoryChangesW
+	 */
+	class DirectoryWatcher final: public IDirectoryWatcher
+	{
+	public:
+		DirectoryWatcher( HANDLE directory )
+			:	m_directory( directory )
+		{
+			assert( m_directory != INVALID_HANDLE_VALUE );
+
+			mem::zero( &m_overlapped, sizeof( OVERLAPPED ) );
+			m_overlapped.hEvent = CreateEvent( nullptr, TRUE, FALSE, nullptr );
+		}
+
+		~DirectoryWatcher()
+		{
+			DWORD bytesTransferred;
+
+			// wait for cancellation, the buffer is still in use
+			if( CancelIoEx( m_directory, &m_overlapped ) )
+			{
+				GetOverlappedResult( m_directory, &m_overlapped, &bytesTransferred, TRUE );
+			}
+
+			CloseHandle( m_overlapped.hEvent );
+			CloseHandle( m_directory );
+		}
+
+		Bool start()
+		{
+			ResetEvent( m_overlapped.hEvent );
+
+			return ReadDirectoryChangesW( m_directory, m_buffer, BUFFER_SIZE, TRUE, NOTIFY_FILTER, 
+				nullptr, &m_overlapped, nullptr ) != 0;
+		}
+
+		Bool pollChanges( Array<String>& outChangedFiles ) override
+		{
+			DWORD bytesTransferred = 0;
+
+			if( !GetOverlappedResult( m_directory, &m_overlapped, &bytesTransferred, FALSE ) )
+			{
+				if( GetLastError() == ERROR_IO_INCOMPLETE )
+				{
+					// nothing happened
+					return true;
+				}
+				else
+				{
+					start();
+					return false;
+				}
+			}
+
+			// zero bytes means buffer overflow
+			Bool isComplete = bytesTransferred > 0;
+
+			if( isComplete )
+			{
+				const UInt8* ptr = m_buffer;
+
+				while( true )
+				{
+					const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>( ptr );
+					outChangedFiles.push( String( info->FileName, info->FileNameLength / sizeof( WCHAR ) ) );
+
+					if( info->NextEntryOffset == 0 )
+					{
+						break;
+					}
+
+					ptr += info->NextEntryOffset;
+				}
+			}
+
+			if( !start() )
+			{
+				isComplete = false;
+			}
+
+			return isComplete;
+		}
+
+	private:
+		static const DWORD BUFFER_SIZE = 64 * 1024;
+		static const DWORD NOTIFY_FILTER = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | 
+			FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+		HANDLE m_directory;
+		OVERLAPPED m_overlapped;
+		alignas( DWORD ) UInt8 m_buffer[BUFFER_SIZE];
+	};
+#endif
+
+	IDirectoryWatcher* watchDirectory( const Char* directory )
+	{
+#if FLU_PLATFORM_WINDOWS && !FLU_PLATFORM_XBOX
+		HANDLE handle = CreateFile( directory, FILE_LIST_DIRECTORY, 
+			FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, 
+			FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr );
+
+		if( handle == INVALID_HANDLE_VALUE )
+		{
+			return nullptr;
+		}
+
+		DirectoryWatcher* watcher = new DirectoryWatcher( handle );
+
+		if( !watcher->start() )
+		{
+			delete watcher;
+			return nullptr;
+		}
+
+		return watcher;
+#else
+		return nullptr;
+#endif
+	}
+
 } /* namespace fm */
 } /* namespace flu */
\ No newline at end of file
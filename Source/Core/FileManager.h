@@ -40,6 +40,24 @@ namespace fm
 		virtual String fileName() const = 0;
 	};
 
+	/**
+	 *	An OS driven watcher of changes in the directory and its subdirectories
+	 */
+	class IDirectoryWatcher: public NonCopyable
+	{
+	public:
+		using UPtr = UniquePtr<IDirectoryWatcher>;
+
+		virtual ~IDirectoryWatcher() = default;
+
+		/**
+		 *	Append relative names of files changed, created, removed or renamed
+		 *	since the last call. Return false if some changes were lost, so
+		 *	everything should be rechecked
+		 */
+		virtual Bool pollChanges( Array<String>& outChangedFiles ) = 0;
+	};
+
 	/**
 	 *	Read a binary file. Return null if file is not found.
 	 */
@@ -154,5 +172,31 @@ namespace fm
 	 */
 	extern Int64 getFileModificationTime( const Char* fileName );
 
+	/**
+	 *	Set file modification time to now, return false if file is not found
+	 */
+	extern Bool touchFile( const Char* fileName );
+
+	/**
+	 *	Return file size in bytes or -1 if file is not found
+	 */
+	extern Int64 getFileSize( const Char* fileName );
+
+	/**
+	 *	Delete a file
+	 */
+	extern Bool deleteFile( const Char* fileName );
+
+	/**
+	 *	Move or rename a file, destination file will be replaced
+	 */
+	extern Bool moveFile( const Char* sourceFileName, const Char* destFileName );
+
+	/**
+	 *	Start watching the directory. Return null if the platform doesn't
+	 *	support change notifications, so files should be polled
+	 */
+	extern IDirectoryWatcher* watchDirectory( const Char* directory );
+
 } /* namespace fm */
 } /* namespace flu */
\ No newline at end of file
@@ -7,110 +7,231 @@
 
 namespace flu 
 {
-	JSon::Ptr JSon::loadFromStream( IInputStream& inputStream, String* error )
+	/**
+	 *	A binary JSon writer. Containers are prefixed with number of items,
+	 *	it's unknown until container end, so a placeholder is patched later
+	 */
+	class BinaryJSonWriter: public JSonWriter
+	{
+	public:
+		BinaryJSonWriter( IOutputStream& outputStream )
+			:	m_stream( outputStream )
+		{
+		}
+
+		void writeBool( Bool value ) override
+		{
+			beginValue( JSon::ENodeType::BOOL );
+			m_stream << value;
+		}
+
+		void writeInt( Int32 value ) override
+		{
+			beginValue( JSon::ENodeType::INT );
+			m_stream << value;
+		}
+
+		void writeFloat( Float value ) override
+		{
+			beginValue( JSon::ENodeType::FLOAT );
+			m_stream << value;
+		}
+
+		void writeString( const Char* value ) override
+		{
+			beginValue( JSon::ENodeType::STRING );
+			m_stream << String( value );
+		}
+
+		void beginObject() override
+		{
+			beginValue( JSon::ENodeType::OBJECT );
+			beginContainer( true );
+		}
+
+		void writeKey( const Char* name ) override
+		{
+			assert( m_containers.size() > 0 && m_containers.last().isObject );
+
+			m_containers.last().count++;
+			m_stream << String( name );
+		}
+
+		void endObject() override
+		{
+			assert( m_containers.size() > 0 && m_containers.last().isObject );
+			endContainer();
+		}
+
+		void beginArray() override
+		{
+			beginValue( JSon::ENodeType::ARRAY );
+			beginContainer( false );
+		}
+
+		void endArray() override
+		{
+			assert( m_containers.size() > 0 && !m_containers.last().isObject );
+			endContainer();
+		}
+
+	private:
+		struct Container
+		{
+			SizeT countPosition;
+			Int32 count;
+			Bool isObject;
+		};
+
+		IOutputStream& m_stream;
+		Array<Container> m_containers;
+
+		void beginValue( JSon::ENodeType nodeType )
+		{
+			if( m_containers.size() > 0 && !m_containers.last().isObject )
+			{
+				m_containers.last().count++;
+			}
+
+			m_stream << static_cast<UInt8>( nodeType );
+		}
+
+		void beginContainer( Bool isObject )
+		{
+			Container container;
+			container.countPosition = m_stream.tell();
+			container.count = 0;
+			container.isObject = isObject;
+
+			m_containers.push( container );
+			m_stream << container.count;
+		}
+
+		void endContainer()
+		{
+			const Container container = m_containers.pop();
+			const SizeT endPosition = m_stream.tell();
+
+			m_stream.seek( container.countPosition );
+			m_stream << container.count;
+			m_stream.seek( endPosition );
+		}
+	};
+
+	JSonWriter* JSonWriter::createBinaryWriter( IOutputStream& outputStream )
+	{
+		return new BinaryJSonWriter( outputStream );
+	}
+
+	Bool JSonReader::readBinary( IInputStream& inputStream, IJSonHandler& handler, String* error )
 	{
 		struct Deserializer
 		{
 		public:
-			static JSon::Ptr deserializeJSonNode( IInputStream& inputStream, String& error )
+			static Bool deserializeJSonNode( IInputStream& inputStream, IJSonHandler& handler, String& key, String& error )
 			{
 				UInt8 nodeTypeId;
 				inputStream >> nodeTypeId;
-				ENodeType nodeType = static_cast<ENodeType>( nodeTypeId );
+				JSon::ENodeType nodeType = static_cast<JSon::ENodeType>( nodeTypeId );
 
 				if( inputStream.hasError() )
 				{
 					error = L"unexpected end of stream";
-					return nullptr;
+					return false;
 				}
 
 				switch( nodeType )
 				{
-					case ENodeType::BOOL:
+					case JSon::ENodeType::BOOL:
 					{
 						Bool value;
 						inputStream >> value;
-						return JSon::createBoolNode( value );
+						return handleResult( handler.onBool( value ), error );
 					}
-					case ENodeType::INT:
+					case JSon::ENodeType::INT:
 					{
 						Int32 value;
 						inputStream >> value;
-						return JSon::createIntNode( value );
+						return handleResult( handler.onInt( value ), error );
 					}
-					case ENodeType::FLOAT:
+					case JSon::ENodeType::FLOAT:
 					{
 						Float value;
 						inputStream >> value;
-						return JSon::createFloatNode( value );
+						return handleResult( handler.onFloat( value ), error );
 					}
-					case ENodeType::STRING:
+					case JSon::ENodeType::STRING:
 					{
-						String value;
-						inputStream >> value;
-						return JSon::createStringNode( value );
+						inputStream >> key;
+						return handleResult( handler.onString( *key, key.len() ), error );
 					}
-					case ENodeType::ARRAY:
+					case JSon::ENodeType::ARRAY:
 					{
 						Int32 arraySize;
 						inputStream >> arraySize;
 
-						JSon::Ptr arrayNode = JSon::createArrayNode();
+						if( !handleResult( handler.onBeginArray(), error ) )
+						{
+							return false;
+						}
 
 						for( Int32 i = 0; i < arraySize; ++i )
 						{
-							JSon::Ptr value = deserializeJSonNode( inputStream, error );
-
-							if( value )
-							{
-								arrayNode->insertElement( value );
-							}
-							else
+							if( !deserializeJSonNode( inputStream, handler, key, error ) )
 							{
-								return nullptr;
+								return false;
 							}
 						}
 
-						return arrayNode;
+						return handleResult( handler.onEndArray(), error );
 					}
-					case ENodeType::OBJECT:
+					case JSon::ENodeType::OBJECT:
 					{
 						Int32 fieldsCount;
 						inputStream >> fieldsCount;
 
-						JSon::Ptr objectNode = JSon::createObjectNode();
+						if( !handleResult( handler.onBeginObject(), error ) )
+						{
+							return false;
+						}
 
 						for( Int32 i = 0; i < fieldsCount; ++i )
 						{
-							String key;
 							inputStream >> key;
 
-							JSon::Ptr value = deserializeJSonNode( inputStream, error );
-
-							if( value )
-							{
-								objectNode->addField( key, value );
-							}
-							else
+							if( !handleResult( handler.onKey( *key, key.len() ), error ) ||
+								!deserializeJSonNode( inputStream, handler, key, error ) )
 							{
-								return nullptr;
+								return false;
 							}
 						}
 
-						return objectNode;
+						return handleResult( handler.onEndObject(), error );
 					}
-					case ENodeType::STUB:
+					case JSon::ENodeType::STUB:
 					default:
 					{
 						error = L"unknown JSon node type";
-						return nullptr;
+						return false;
 					}
 				}
 			}
+
+			static Bool handleResult( Bool result, String& error )
+			{
+				if( !result )
+				{
+					error = L"reading stopped by handler";
+				}
+
+				return result;
+			}
 		};
 
+		// a single buffer for all keys and strings
+		String key;
 		String tempError;
-		JSon::Ptr result = Deserializer::deserializeJSonNode( inputStream, tempError );
+		Bool result = Deserializer::deserializeJSonNode( inputStream, handler, key, tempError );
 
 		if( !result && error )
 		{
@@ -120,95 +241,104 @@ namespace flu
 		return result;
 	}
 
-	Bool JSon::saveToStream( IOutputStream& outputStream, JSon::Ptr json, String* error )
+	/**
+	 *	A handler, which builds a JSon tree
+	 */
+	class JSonTreeBuilder: public IJSonHandler
 	{
-		struct Serializer
+	public:
+		JSon::Ptr getResult() const
 		{
-		public:
-			static Bool serializeJSonNode( IOutputStream& outputStream, JSon::Ptr json, String& error )
-			{
-				if( json.hasObject() )
-				{
-					const ENodeType nodeType = json->getNodeType();				
-					outputStream << static_cast<UInt8>( nodeType );
+			return m_result;
+		}
 
-					switch( nodeType )
-					{
-						case ENodeType::BOOL:
-						{
-							outputStream << json->asBool();
-							return true;
-						}
-						case ENodeType::INT:
-						{
-							outputStream << json->asInt();
-							return true;
-						}
-						case ENodeType::FLOAT:
-						{
-							outputStream << json->asFloat();
-							return true;
-						}
-						case ENodeType::STRING:
-						{
-							outputStream << json->asString();
-							return true;
-						}
-						case ENodeType::ARRAY:
-						{
-							outputStream << json->arraySize();
+		Bool onBool( Bool value ) override
+		{
+			return addNode( JSon::createBoolNode( value ) );
+		}
 
-							for( Int32 i = 0; i < json->arraySize(); ++i )
-							{
-								if( !serializeJSonNode( outputStream, json->getElement( i ), error ) )
-								{
-									return false;
-								}
-							}
+		Bool onInt( Int32 value ) override
+		{
+			return addNode( JSon::createIntNode( value ) );
+		}
 
-							return true;
-						}
-						case ENodeType::OBJECT:
-						{
-							outputStream << json->fieldsCount();
+		Bool onFloat( Float value ) override
+		{
+			return addNode( JSon::createFloatNode( value ) );
+		}
 
-							for( auto it = json->firstField(); it != json->endField(); it++  )
-							{
-								outputStream << it->key;
+		Bool onString( const Char* value, SizeT length ) override
+		{
+			return addNode( JSon::createStringNode( String( value, length ) ) );
+		}
 
-								if( !serializeJSonNode( outputStream, it->value, error ) )
-								{
-									return false;
-								}
-							}
+		Bool onBeginObject() override
+		{
+			JSon::Ptr objectNode = JSon::createObjectNode();
+			addNode( objectNode );
+			m_containers.push( objectNode );
+			return true;
+		}
 
-							return true;
-						}
-						case ENodeType::STUB:
-						default:
-						{
-							error = L"unknown json node type";
-							return false;
-						}
-					}
-				}
-				else
-				{
-					error = L"null json node found";
-					return false;
-				}
-			}
-		};
+		Bool onKey( const Char* name, SizeT length ) override
+		{
+			m_key = String( name, length );
+			return true;
+		}
 
-		// todo: stream to intermediate buffer and then copy
-		String tempError;
-		Bool result = Serializer::serializeJSonNode( outputStream, json, tempError );
+		Bool onEndObject() override
+		{
+			m_containers.pop();
+			return true;
+		}
 
-		if( !result && error )
+		Bool onBeginArray() override
 		{
-			*error = tempError;
+			JSon::Ptr arrayNode = JSon::createArrayNode();
+			addNode( arrayNode );
+			m_containers.push( arrayNode );
+			return true;
 		}
 
-		return result;
+		Bool onEndArray() override
+		{
+			m_containers.pop();
+			return true;
+		}
+
+	private:
+		JSon::Ptr m_result;
+		Array<JSon::Ptr> m_containers;
+		String m_key;
+
+		Bool addNode( JSon::Ptr node )
+		{
+			if( m_containers.size() == 0 )
+			{
+				m_result = node;
+			}
+			else if( m_containers.last()->isObject() )
+			{
+				m_containers.last()->addField( m_key, node );
+			}
+			else
+			{
+				m_containers.last()->insertElement( node );
+			}
+
+			return true;
+		}
+	};
+
+	JSon::Ptr JSon::loadFromStream( IInputStream& inputStream, String* error )
+	{
+		JSonTreeBuilder builder;
+		return JSonReader::readBinary( inputStream, builder, error ) ? builder.getResult() : nullptr;
+	}
+
+	Bool JSon::saveToStream( IOutputStream& outputStream, JSon::Ptr json, String* error )
+	{
+		BinaryJSonWriter writer( outputStream );
+		return writer.writeNode( json, error );
 	}
 }
\ No newline at end of file
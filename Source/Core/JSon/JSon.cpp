@@ -218,6 +218,19 @@ namespace flu
 			return m_fields.size();
 		}
 
+		JSon::Ptr getFieldAt( Int32 i, String* name ) const override
+		{
+			assert( i >= 0 && i < m_fields.size() );
+			const auto& pair = m_fields.begin()[i];
+
+			if( name )
+			{
+				*name = pair.key;
+			}
+
+			return pair.value;
+		}
+
 		JSon::Ptr getField( String name, EMissingPolicy policy ) const override 
 		{
 			const JSon::Ptr* member = m_fields.get( name );
@@ -243,6 +256,9 @@ namespace flu
 		}
 
 	private:
+		// keys stay strings, unlike JSonDocument ones: the map order defines fields
+		// order of getFieldAt and of the written text, and keys of this mutable
+		// node may be arbitrary user strings, which would be interned forever
 		Map<String, JSon::Ptr> m_fields;
 
 		ENodeType getNodeType() const override
@@ -341,6 +357,171 @@ namespace flu
 		}
 	};
 
+	/**
+	 *	A read-only node of the JSon document. Nodes are created on access
+	 *	and keep the whole document alive
+	 */
+	class JSonDocumentValue: public JSon
+	{
+	public:
+		JSonDocumentValue( JSonDocument::Ptr document, const JSonDocument::Value* value )
+			:	m_document( document ),
+				m_value( value )
+		{
+			assert( m_document.hasObject() && m_value );
+		}
+
+		Bool asBool( Bool _default ) const override
+		{
+			switch( m_value->type )
+			{
+				case JSonDocument::EValueType::Bool:	return m_value->boolValue;
+				case JSonDocument::EValueType::Int:		return m_value->intValue != 0;
+				case JSonDocument::EValueType::Float:	return m_value->floatValue != 0.f;
+				case JSonDocument::EValueType::String:	return m_value->stringValue.length != 0;
+				case JSonDocument::EValueType::Object:	return m_value->object.count != 0;
+				case JSonDocument::EValueType::Array:	return m_value->array.count != 0;
+				default:								return _default;
+			}
+		}
+
+		Int32 asInt( Int32 _default ) const override
+		{
+			switch( m_value->type )
+			{
+				case JSonDocument::EValueType::Bool:	return m_value->boolValue ? 1 : 0;
+				case JSonDocument::EValueType::Int:		return m_value->intValue;
+				case JSonDocument::EValueType::Float:	return static_cast<Int32>( m_value->floatValue );
+				case JSonDocument::EValueType::String:
+				{
+					Int32 result;
+					m_value->stringValue.toString().toInteger( result, _default );
+					return result;
+				}
+				default:								return _default;
+			}
+		}
+
+		Float asFloat( Float _default ) const override
+		{
+			switch( m_value->type )
+			{
+				case JSonDocument::EValueType::Bool:	return m_value->boolValue ? 1.f : 0.f;
+				case JSonDocument::EValueType::Int:		return static_cast<Float>( m_value->intValue );
+				case JSonDocument::EValueType::Float:	return m_value->floatValue;
+				case JSonDocument::EValueType::String:
+				{
+					Float result;
+					m_value->stringValue.toString().toFloat( result, _default );
+					return result;
+				}
+				default:								return _default;
+			}
+		}
+
+		String asString( String _default ) const override
+		{
+			switch( m_value->type )
+			{
+				case JSonDocument::EValueType::Bool:	return m_value->boolValue ? L"true" : L"false";
+				case JSonDocument::EValueType::Int:		return String::fromInteger( m_value->intValue );
+				case JSonDocument::EValueType::Float:	return String::fromFloat( m_value->floatValue );
+				case JSonDocument::EValueType::String:	return m_value->stringValue.toString();
+				default:								return _default;
+			}
+		}
+
+		void addField( String name, JSon::Ptr field ) override
+		{
+			fatal( L"Attempt to modify read-only JSon document" );
+		}
+
+		Bool hasField( String name ) const override
+		{ 
+			return m_value->getField( *name, name.len() ) != nullptr;
+		}
+
+		void removeField( String name ) override
+		{
+			fatal( L"Attempt to modify read-only JSon document" );
+		}
+
+		Int32 fieldsCount() const override
+		{ 
+			return m_value->type == JSonDocument::EValueType::Object ? m_value->object.count : 0;
+		}
+
+		JSon::Ptr getFieldAt( Int32 i, String* name ) const override
+		{
+			assert( i >= 0 && i < fieldsCount() );
+			const JSonDocument::Member& member = m_value->object.members[i];
+
+			if( name )
+			{
+				*name = member.key.toString();
+			}
+
+			return new JSonDocumentValue( m_document, &member.value );
+		}
+
+		JSon::Ptr getField( String name, EMissingPolicy policy ) const override 
+		{
+			const JSonDocument::Value* field = m_value->getField( *name, name.len() );
+
+			if( field )
+			{
+				return new JSonDocumentValue( m_document, field );
+			}
+			else
+			{
+				return policy == EMissingPolicy::USE_NULL ? nullptr : JSon::createStubNode();
+			}
+		}
+
+		Int32 arraySize() const override
+		{ 
+			return m_value->type == JSonDocument::EValueType::Array ? m_value->array.count : 0;
+		}
+
+		Int32 insertElement( JSon::Ptr element ) override
+		{ 
+			fatal( L"Attempt to modify read-only JSon document" );
+			return -1;
+		}
+
+		JSon::Ptr getElement( Int32 i, EMissingPolicy policy ) override
+		{ 
+			const JSonDocument::Value* element = m_value->getElement( i );
+
+			if( element )
+			{
+				return new JSonDocumentValue( m_document, element );
+			}
+			else
+			{
+				return policy == EMissingPolicy::USE_NULL ? nullptr : JSon::createStubNode();
+			}
+		}
+
+	private:
+		JSonDocument::Ptr m_document;
+		const JSonDocument::Value* m_value;
+
+		ENodeType getNodeType() const override
+		{
+			switch( m_value->type )
+			{
+				case JSonDocument::EValueType::Bool:	return ENodeType::BOOL;
+				case JSonDocument::EValueType::Int:		return ENodeType::INT;
+				case JSonDocument::EValueType::Float:	return ENodeType::FLOAT;
+				case JSonDocument::EValueType::String:	return ENodeType::STRING;
+				case JSonDocument::EValueType::Object:	return ENodeType::OBJECT;
+				case JSonDocument::EValueType::Array:	return ENodeType::ARRAY;
+				default:								return ENodeType::STUB;
+			}
+		}
+	};
+
 	JSon::Ptr JSon::createBoolNode( Bool inValue )
 	{
 		return new JSonBoolValue( inValue );
@@ -376,6 +557,11 @@ namespace flu
 		return new JSonStubValue();
 	}
 
+	JSon::Ptr JSon::createDocumentNode( JSonDocument::Ptr document, const JSonDocument::Value* value )
+	{
+		return new JSonDocumentValue( document, value );
+	}
+
 	JSon::JSon()
 	{
 	}
@@ -438,4 +624,95 @@ namespace flu
 
 		return policy == EMissingPolicy::USE_STUB ? JSon::createStubNode() : nullptr;
 	}
+	Bool JSonWriter::writeNode( JSon::Ptr json, String* error )
+	{
+		struct Walker
+		{
+		public:
+			static Bool writeJSonNode( JSonWriter& writer, JSon::Ptr json, String& error )
+			{
+				if( json.hasObject() )
+				{
+					switch( json->getNodeType() )
+					{
+						case JSon::ENodeType::BOOL:
+						{
+							writer.writeBool( json->asBool() );
+							return true;
+						}
+						case JSon::ENodeType::INT:
+						{
+							writer.writeInt( json->asInt() );
+							return true;
+						}
+						case JSon::ENodeType::FLOAT:
+						{
+							writer.writeFloat( json->asFloat() );
+							return true;
+						}
+						case JSon::ENodeType::STRING:
+						{
+							writer.writeString( *json->asString() );
+							return true;
+						}
+						case JSon::ENodeType::ARRAY:
+						{
+							writer.beginArray();
+
+							for( Int32 i = 0; i < json->arraySize(); ++i )
+							{
+								if( !writeJSonNode( writer, json->getElement( i, JSon::EMissingPolicy::USE_NULL ), error ) )
+								{
+									return false;
+								}
+							}
+
+							writer.endArray();
+							return true;
+						}
+						case JSon::ENodeType::OBJECT:
+						{
+							writer.beginObject();
+
+							for( Int32 i = 0; i < json->fieldsCount(); ++i )
+							{
+								String fieldName;
+								JSon::Ptr field = json->getFieldAt( i, &fieldName );
+								writer.writeKey( *fieldName );
+
+								if( !writeJSonNode( writer, field, error ) )
+								{
+									return false;
+								}
+							}
+
+							writer.endObject();
+							return true;
+						}
+						case JSon::ENodeType::STUB:
+						default:
+						{
+							error = L"temporal node found in json";
+							return false;
+						}
+					}
+				}
+				else
+				{
+					error = L"null json node found";
+					return false;
+				}
+			}
+		};
+
+		String tempError;
+		Bool result = Walker::writeJSonNode( *this, json, tempError );
+
+		if( !result && error )
+		{
+			*error = tempError;
+		}
+
+		return result;
+	}
 }
\ No newline at end of file
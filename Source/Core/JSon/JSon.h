@@ -28,6 +28,7 @@ namespace flu
 		virtual Bool hasField( String name ) const { return false; }	
 		virtual void removeField( String name ) {  }
 		virtual Int32 fieldsCount() const { return 0; };
+		virtual JSon::Ptr getFieldAt( Int32 i, String* name = nullptr ) const { return nullptr; }
 		virtual Map<String, JSon::Ptr>::Iterator firstField() { return nullptr; };
 		virtual Map<String, JSon::Ptr>::Iterator endField() { return nullptr; }
 
@@ -94,6 +95,9 @@ namespace flu
 
 		JSon::Ptr dotgetNode( const Char* name, EMissingPolicy policy = EMissingPolicy::USE_NULL ) const;
 
+		friend class JSonReader;
+		friend class JSonWriter;
+
 	public:
 		static JSon::Ptr createBoolNode( Bool inValue );
 		static JSon::Ptr createIntNode( Int32 inValue );
@@ -102,12 +106,15 @@ namespace flu
 		static JSon::Ptr createObjectNode();
 		static JSon::Ptr createArrayNode();
 		static JSon::Ptr createStubNode();
+		static JSon::Ptr createDocumentNode( JSonDocument::Ptr document, const JSonDocument::Value* value );
 
 		static JSon::Ptr loadFromStream( IInputStream& inputStream, String* error = nullptr );
 		static Bool saveToStream( IOutputStream& outputStream, JSon::Ptr json, String* error = nullptr );
 
 		static JSon::Ptr loadFromText( Text::Ptr text, String* error = nullptr );
 		static Text::Ptr saveToText( JSon::Ptr json, String* error = nullptr );
+
+		static void benchmarkLoaders( const Char* fileName, Int32 numIterations = 100 );
 	};
 
 } // namespace flu
\ No newline at end of file
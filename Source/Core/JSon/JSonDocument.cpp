@@ -0,0 +1,623 @@
+//-----------------------------------------------------------------------------
+//	JSonDocument.cpp: An arena allocated JSon document implementation
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Core/Core.h"
+
+namespace flu
+{
+	static const SizeT JSON_MIN_BLOCK_SIZE = 4 * 1024;
+	static const SizeT JSON_ARENA_ALIGNMENT = 8;
+
+	// nesting limit keeps the recursive parser within the stack
+	static const UInt32 JSON_MAX_DEPTH = 256;
+
+	// larger exponents are out of Float range anyway
+	static const Int32 JSON_MAX_EXPONENT = 400;
+	static const Double JSON_MAX_FLOAT = 3.402823466e+38;
+
+	/**
+	 *	A temporary stack of the values, which are not placed into
+	 *	the arena yet. It grows twice, so even huge arrays are fast
+	 */
+	template<typename T> class JSonScratchStack
+	{
+	public:
+		JSonScratchStack()
+			:	m_data( nullptr ),
+				m_size( 0 ),
+				m_capacity( 0 )
+		{
+		}
+
+		~JSonScratchStack()
+		{
+			mem::free( m_data );
+		}
+
+		void push( const T& value )
+		{
+			if( m_size == m_capacity )
+			{
+				m_capacity = max<UInt32>( m_capacity * 2, 64 );
+				m_data = reinterpret_cast<T*>( mem::realloc( m_data, m_capacity * sizeof( T ) ) );
+			}
+
+			m_data[m_size++] = value;
+		}
+
+		UInt32 size() const
+		{
+			return m_size;
+		}
+
+		const T* data( UInt32 from ) const
+		{
+			return &m_data[from];
+		}
+
+		void shrink( UInt32 newSize )
+		{
+			assert( newSize <= m_size );
+			m_size = newSize;
+		}
+
+	private:
+		T* m_data;
+		UInt32 m_size;
+		UInt32 m_capacity;
+	};
+
+	/**
+	 *	A single pass JSon parser. It accepts the same dialect as the
+	 *	legacy lexer based loader: identifiers as keys, strings without
+	 *	escape sequences, case insensitive booleans and trailing commas
+	 */
+	class JSonDocument::Parser
+	{
+	public:
+		Parser( JSonDocument& document, const Char* text, SizeT length )
+			:	m_document( document ),
+				m_begin( text ),
+				m_cursor( text ),
+				m_end( text + length ),
+				m_depth( 0 ),
+				m_errorPosition( nullptr )
+		{
+		}
+
+		Bool parse( Value& root )
+		{
+			if( !parseValue( root ) )
+			{
+				return false;
+			}
+
+			skipSpaces();
+
+			if( m_cursor != m_end )
+			{
+				return error( TXT("unexpected symbols after the root value") );
+			}
+
+			return true;
+		}
+
+		String getError() const
+		{
+			Int32 line = 1;
+
+			for( const Char* c = m_begin; c < m_errorPosition && c < m_end; ++c )
+			{
+				line += *c == TXT('\n') ? 1 : 0;
+			}
+
+			return String::format( TXT("%s at line: %d"), *m_error, line );
+		}
+
+	private:
+		JSonDocument& m_document;
+
+		const Char* const m_begin;
+		const Char* m_cursor;
+		const Char* const m_end;
+
+		UInt32 m_depth;
+
+		JSonScratchStack<Value> m_elements;
+		JSonScratchStack<Member> m_members;
+
+		String m_error;
+		const Char* m_errorPosition;
+
+		Bool error( const Char* message )
+		{
+			m_error = message;
+			m_errorPosition = m_cursor;
+			return false;
+		}
+
+		void skipSpaces()
+		{
+			while( m_cursor < m_end && ( *m_cursor == 0x20 || *m_cursor == 0x09 ||
+				*m_cursor == 0x0d || *m_cursor == 0x0a ) )
+			{
+				++m_cursor;
+			}
+		}
+
+		Bool matchSymbol( Char symbol )
+		{
+			skipSpaces();
+
+			if( m_cursor < m_end && *m_cursor == symbol )
+			{
+				++m_cursor;
+				return true;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		Bool readString( StringView& result )
+		{
+			assert( *m_cursor == TXT('\"') );
+			const Char* start = ++m_cursor;
+
+			while( m_cursor < m_end && *m_cursor != TXT('\"') )
+			{
+				++m_cursor;
+			}
+
+			if( m_cursor == m_end )
+			{
+				return error( TXT("unterminated string") );
+			}
+
+			result.data = start;
+			result.length = static_cast<UInt32>( m_cursor - start );
+
+			++m_cursor;
+			return true;
+		}
+
+		void readIdentifier( StringView& result )
+		{
+			assert( cstr::isLetter( *m_cursor ) );
+			result.data = m_cursor;
+
+			while( m_cursor < m_end && cstr::isDigitLetter( *m_cursor ) )
+			{
+				++m_cursor;
+			}
+
+			result.length = static_cast<UInt32>( m_cursor - result.data );
+		}
+
+		static Bool isKeyword( const StringView& identifier, const Char* keyword )
+		{
+			for( UInt32 i = 0; i < identifier.length; ++i )
+			{
+				if( keyword[i] == TXT('\0') || cstr::toLower( identifier.data[i] ) != keyword[i] )
+				{
+					return false;
+				}
+			}
+
+			return keyword[identifier.length] == TXT('\0');
+		}
+
+		Bool readNumber( Value& result )
+		{
+			const Bool isNegative = *m_cursor == TXT('-');
+
+			if( isNegative )
+			{
+				++m_cursor;
+
+				if( m_cursor == m_end || !cstr::isDigit( *m_cursor ) )
+				{
+					return error( TXT("unexpected symbol \"-\"") );
+				}
+			}
+
+			Int64 integerPart = 0;
+			Double value = 0.0;
+
+			while( m_cursor < m_end && cstr::isDigit( *m_cursor ) )
+			{
+				const Int32 digit = *m_cursor++ - TXT('0');
+
+				// too long integers are truncated, as it was in the lexer
+				if( integerPart <= MAX_INT64 / 10 - 1 )
+				{
+					integerPart = integerPart * 10 + digit;
+				}
+
+				value = value * 10.0 + digit;
+			}
+
+			Bool isFloat = false;
+
+			if( m_cursor < m_end && *m_cursor == TXT('.') )
+			{
+				Double scale = 0.1;
+				isFloat = true;
+				++m_cursor;
+
+				while( m_cursor < m_end && cstr::isDigit( *m_cursor ) )
+				{
+					value += ( *m_cursor++ - TXT('0') ) * scale;
+					scale *= 0.1;
+				}
+			}
+
+			if( m_cursor < m_end && ( *m_cursor == TXT('e') || *m_cursor == TXT('E') ) )
+			{
+				isFloat = true;
+				++m_cursor;
+
+				const Bool isNegativeExponent = m_cursor < m_end && *m_cursor == TXT('-');
+
+				if( m_cursor < m_end && ( *m_cursor == TXT('-') || *m_cursor == TXT('+') ) )
+				{
+					++m_cursor;
+				}
+
+				Int32 exponent = 0;
+
+				while( m_cursor < m_end && cstr::isDigit( *m_cursor ) )
+				{
+					exponent = min( exponent * 10 + ( *m_cursor++ - TXT('0') ), JSON_MAX_EXPONENT );
+				}
+
+				for( Int32 i = 0; i < exponent; ++i )
+				{
+					value = isNegativeExponent ? value * 0.1 : value * 10.0;
+				}
+			}
+
+			// legacy float suffix
+			if( m_cursor < m_end && *m_cursor == TXT('f') )
+			{
+				isFloat = true;
+				++m_cursor;
+			}
+
+			if( isFloat )
+			{
+				if( value > JSON_MAX_FLOAT )
+				{
+					return error( TXT("number is out of range") );
+				}
+
+				result.type = EValueType::Float;
+				result.floatValue = static_cast<Float>( isNegative ? -value : value );
+			}
+			else
+			{
+				result.type = EValueType::Int;
+				result.intValue = static_cast<Int32>( isNegative ? -integerPart : integerPart );
+			}
+
+			return true;
+		}
+
+		Bool parseObject( Value& result )
+		{
+			assert( *m_cursor == TXT('{') );
+			++m_cursor;
+
+			const UInt32 firstMember = m_members.size();
+
+			while( !matchSymbol( TXT('}') ) )
+			{
+				Member member;
+
+				if( m_cursor == m_end )
+				{
+					return error( TXT("unexpected end of text") );
+				}
+				else if( *m_cursor == TXT('\"') )
+				{
+					if( !readString( member.key ) )
+						return false;
+				}
+				else if( cstr::isLetter( *m_cursor ) )
+				{
+					readIdentifier( member.key );
+				}
+				else
+				{
+					return error( TXT("unexpected token") );
+				}
+
+				if( !matchSymbol( TXT(':') ) )
+				{
+					return error( TXT("missing \":\"") );
+				}
+
+				member.name = NameId( member.key.data, member.key.length );
+
+				// nested containers leave the members stack as it was
+				if( !parseValue( member.value ) )
+				{
+					return false;
+				}
+
+				m_members.push( member );
+
+				if( matchSymbol( TXT('}') ) )
+				{
+					break;
+				}
+				else if( !matchSymbol( TXT(',') ) )
+				{
+					return error( TXT("missing \",\"") );
+				}
+			}
+
+			const UInt32 count = m_members.size() - firstMember;
+			Member* members = nullptr;
+
+			if( count > 0 )
+			{
+				members = reinterpret_cast<Member*>( m_document.allocate( count * sizeof( Member ) ) );
+				mem::copy( members, m_members.data( firstMember ), count * sizeof( Member ) );
+				m_members.shrink( firstMember );
+			}
+
+			result.type = EValueType::Object;
+			result.object.members = members;
+			result.object.count = count;
+			return true;
+		}
+
+		Bool parseArray( Value& result )
+		{
+			assert( *m_cursor == TXT('[') );
+			++m_cursor;
+
+			const UInt32 firstElement = m_elements.size();
+
+			while( !matchSymbol( TXT(']') ) )
+			{
+				Value element;
+
+				if( !parseValue( element ) )
+				{
+					return false;
+				}
+
+				m_elements.push( element );
+
+				if( matchSymbol( TXT(']') ) )
+				{
+					break;
+				}
+				else if( !matchSymbol( TXT(',') ) )
+				{
+					return error( TXT("missing \",\"") );
+				}
+			}
+
+			const UInt32 count = m_elements.size() - firstElement;
+			Value* elements = nullptr;
+
+			if( count > 0 )
+			{
+				elements = reinterpret_cast<Value*>( m_document.allocate( count * sizeof( Value ) ) );
+				mem::copy( elements, m_elements.data( firstElement ), count * sizeof( Value ) );
+				m_elements.shrink( firstElement );
+			}
+
+			result.type = EValueType::Array;
+			result.array.elements = elements;
+			result.array.count = count;
+			return true;
+		}
+
+		Bool parseValue( Value& result )
+		{
+			skipSpaces();
+
+			if( m_cursor == m_end )
+			{
+				return error( TXT("unexpected end of text") );
+			}
+
+			m_document.m_valuesCount++;
+			const Char c = *m_cursor;
+
+			if( c == TXT('{') || c == TXT('[') )
+			{
+				if( m_depth == JSON_MAX_DEPTH )
+				{
+					return error( TXT("too deep nesting") );
+				}
+
+				m_depth++;
+				const Bool parsed = c == TXT('{') ? parseObject( result ) : parseArray( result );
+				m_depth--;
+
+				return parsed;
+			}
+			else if( c == TXT('\"') )
+			{
+				result.type = EValueType::String;
+				return readString( result.stringValue );
+			}
+			else if( cstr::isDigit( c ) || c == TXT('-') )
+			{
+				return readNumber( result );
+			}
+			else if( cstr::isLetter( c ) )
+			{
+				StringView identifier;
+				readIdentifier( identifier );
+
+				if( isKeyword( identifier, TXT("true") ) || isKeyword( identifier, TXT("false") ) )
+				{
+					result.type = EValueType::Bool;
+					result.boolValue = identifier.length == 4;
+					return true;
+				}
+				else
+				{
+					m_cursor = identifier.data;
+					return error( *String::format( TXT("unexpected identifier \"%s\""), *identifier.toString() ) );
+				}
+			}
+			else
+			{
+				return error( *String::format( TXT("unexpected symbol \"%c\""), c ) );
+			}
+		}
+	};
+
+	const JSonDocument::Value* JSonDocument::Value::getField( NameId name ) const
+	{
+		if( type == EValueType::Object )
+		{
+			// the last duplicate wins, as it was in the map based loader
+			for( UInt32 i = object.count; i-- > 0; )
+			{
+				if( object.members[i].name == name )
+				{
+					return &object.members[i].value;
+				}
+			}
+		}
+
+		return nullptr;
+	}
+
+	const JSonDocument::Value* JSonDocument::Value::getField( const Char* name, SizeT length ) const
+	{
+		// all the keys are interned, so never interned name is not in the document
+		const NameId interned = NameId::find( name, length );
+		return interned || length == 0 ? getField( interned ) : nullptr;
+	}
+
+	JSonDocument::JSonDocument()
+		:	m_blocks( nullptr ),
+			m_arenaSize( 0 ),
+			m_root( nullptr ),
+			m_valuesCount( 0 )
+	{
+	}
+
+	JSonDocument::~JSonDocument()
+	{
+		while( m_blocks )
+		{
+			Block* next = m_blocks->next;
+			mem::free( m_blocks );
+			m_blocks = next;
+		}
+	}
+
+	void* JSonDocument::allocate( SizeT size )
+	{
+		size = alignValue<SizeT>( size, JSON_ARENA_ALIGNMENT );
+		const SizeT headerSize = alignValue<SizeT>( sizeof( Block ), JSON_ARENA_ALIGNMENT );
+
+		if( !m_blocks || m_blocks->used + size > m_blocks->size )
+		{
+			// each next block is twice larger
+			const SizeT blockSize = max( size, max( m_arenaSize, JSON_MIN_BLOCK_SIZE ) );
+
+			Block* block = reinterpret_cast<Block*>( mem::malloc( headerSize + blockSize ) );
+			block->next = m_blocks;
+			block->size = blockSize;
+			block->used = 0;
+
+			m_blocks = block;
+			m_arenaSize += blockSize;
+		}
+
+		void* result = reinterpret_cast<UInt8*>( m_blocks ) + headerSize + m_blocks->used;
+		m_blocks->used += size;
+
+		return result;
+	}
+
+	void JSonDocument::reserve( SizeT sourceSize )
+	{
+		assert( m_blocks == nullptr );
+
+		// values usually take about twice as much memory as the source
+		// text, so most of documents fit into the single block
+		allocate( sourceSize * 3 );
+		m_blocks->used = 0;
+	}
+
+	Bool JSonDocument::parseSource( const Char* source, SizeT length, String* error )
+	{
+		Value* root = reinterpret_cast<Value*>( allocate( sizeof( Value ) ) );
+		Parser parser( *this, source, length );
+
+		if( parser.parse( *root ) )
+		{
+			m_root = root;
+			return true;
+		}
+		else
+		{
+			if( error )
+			{
+				*error = parser.getError();
+			}
+
+			return false;
+		}
+	}
+
+	JSonDocument::Ptr JSonDocument::parse( Text::Ptr text, String* error )
+	{
+		assert( text.hasObject() );
+
+		// join lines right in the arena
+		SizeT length = 0;
+
+		for( Int32 i = 0; i < text->size(); ++i )
+		{
+			length += (*text)[i].len() + 1;
+		}
+
+		JSonDocument::Ptr document = new JSonDocument();
+		document->reserve( ( length + 1 ) * sizeof( Char ) );
+
+		Char* source = reinterpret_cast<Char*>( document->allocate( ( length + 1 ) * sizeof( Char ) ) );
+		Char* walk = source;
+
+		for( Int32 i = 0; i < text->size(); ++i )
+		{
+			const String& line = (*text)[i];
+
+			mem::copy( walk, *line, line.len() * sizeof( Char ) );
+			walk += line.len();
+			*walk++ = TXT('\n');
+		}
+
+		*walk = TXT('\0');
+		return document->parseSource( source, length, error ) ? document : nullptr;
+	}
+
+	JSonDocument::Ptr JSonDocument::parse( const Char* text, SizeT length, String* error )
+	{
+		assert( text );
+
+		JSonDocument::Ptr document = new JSonDocument();
+		document->reserve( ( length + 1 ) * sizeof( Char ) );
+
+		Char* source = reinterpret_cast<Char*>( document->allocate( ( length + 1 ) * sizeof( Char ) ) );
+		mem::copy( source, text, length * sizeof( Char ) );
+		source[length] = TXT('\0');
+
+		return document->parseSource( source, length, error ) ? document : nullptr;
+	}
+}
@@ -0,0 +1,155 @@
+//-----------------------------------------------------------------------------
+//	JSonDocument.h: An arena allocated read-only JSon document
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+	/**
+	 *	A read-only JSon document. The document is parsed with a single
+	 *	pass scanner, all the values live in one arena and strings are
+	 *	views into the document's copy of the source text
+	 */
+	class JSonDocument: public ReferenceCount
+	{
+	public:
+		using Ptr = SharedPtr<JSonDocument>;
+
+		enum class EValueType : UInt8
+		{
+			Bool,
+			Int,
+			Float,
+			String,
+			Object,
+			Array
+		};
+
+		/**
+		 *	A not terminated string in the document
+		 */
+		struct StringView
+		{
+			const Char* data;
+			UInt32 length;
+
+			Bool equals( const Char* other, SizeT otherLength ) const
+			{
+				return length == otherLength && mem::cmp( data, other, length * sizeof( Char ) );
+			}
+
+			String toString() const
+			{
+				return String( data, length );
+			}
+		};
+
+		struct Member;
+
+		/**
+		 *	A document value, containers refer to the
+		 *	contiguous arrays of their elements
+		 */
+		struct Value
+		{
+			EValueType type;
+
+			union
+			{
+				Bool boolValue;
+				Int32 intValue;
+				Float floatValue;
+				StringView stringValue;
+
+				struct
+				{
+					const Member* members;
+					UInt32 count;
+				} object;
+
+				struct
+				{
+					const Value* elements;
+					UInt32 count;
+				} array;
+			};
+
+			/**
+			 *	Return object's field or nullptr if no such field
+			 */
+			const Value* getField( NameId name ) const;
+			const Value* getField( const Char* name, SizeT length ) const;
+
+			const Value* getField( const Char* name ) const
+			{
+				return getField( name, cstr::length( name ) );
+			}
+
+			/**
+			 *	Return array's element or nullptr if out of bounds
+			 */
+			const Value* getElement( Int32 i ) const
+			{
+				return type == EValueType::Array && i >= 0 && static_cast<UInt32>( i ) < array.count ?
+					&array.elements[i] : nullptr;
+			}
+		};
+
+		/**
+		 *	An object's field, key is interned while parsing, so
+		 *	fields are looked up by NameId comparison
+		 */
+		struct Member
+		{
+			StringView key;
+			NameId name;
+			Value value;
+		};
+
+		~JSonDocument();
+
+		static JSonDocument::Ptr parse( Text::Ptr text, String* error = nullptr );
+		static JSonDocument::Ptr parse( const Char* text, SizeT length, String* error = nullptr );
+
+		const Value* root() const
+		{
+			return m_root;
+		}
+
+		UInt32 valuesCount() const
+		{
+			return m_valuesCount;
+		}
+
+		SizeT arenaSize() const
+		{
+			return m_arenaSize;
+		}
+
+	private:
+		struct Block
+		{
+			Block* next;
+			SizeT size;
+			SizeT used;
+		};
+
+		Block* m_blocks;
+		SizeT m_arenaSize;
+		const Value* m_root;
+		UInt32 m_valuesCount;
+
+		JSonDocument();
+
+		void* allocate( SizeT size );
+		void reserve( SizeT sourceSize );
+		Bool parseSource( const Char* source, SizeT length, String* error );
+
+		class Parser;
+		friend class Parser;
+
+		JSonDocument( const JSonDocument& ) = delete;
+		JSonDocument& operator=( const JSonDocument& ) = delete;
+	};
+
+} // namespace flu
@@ -0,0 +1,77 @@
+//-----------------------------------------------------------------------------
+//	JSonStream.h: Streaming JSon reading and writing
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+	/**
+	 *	A JSon events handler. Strings and keys are valid only during
+	 *	the call, return false to stop reading
+	 */
+	class IJSonHandler
+	{
+	public:
+		virtual ~IJSonHandler() = default;
+
+		virtual Bool onBool( Bool value ) = 0;
+		virtual Bool onInt( Int32 value ) = 0;
+		virtual Bool onFloat( Float value ) = 0;
+		virtual Bool onString( const Char* value, SizeT length ) = 0;
+
+		virtual Bool onBeginObject() = 0;
+		virtual Bool onKey( const Char* name, SizeT length ) = 0;
+		virtual Bool onEndObject() = 0;
+
+		virtual Bool onBeginArray() = 0;
+		virtual Bool onEndArray() = 0;
+	};
+
+	/**
+	 *	An event based JSon reader, it never builds a tree, so
+	 *	memory usage depends on nesting depth only
+	 */
+	class JSonReader final
+	{
+	public:
+		static Bool readText( IInputStream& inputStream, IJSonHandler& handler, String* error = nullptr );
+		static Bool readBinary( IInputStream& inputStream, IJSonHandler& handler, String* error = nullptr );
+
+	private:
+		JSonReader() = delete;
+	};
+
+	/**
+	 *	A streaming JSon writer. Values go right to the output stream, the
+	 *	writer keeps only a stack of opened containers
+	 */
+	class JSonWriter: public NonCopyable
+	{
+	public:
+		using UPtr = UniquePtr<JSonWriter>;
+
+		virtual void writeBool( Bool value ) = 0;
+		virtual void writeInt( Int32 value ) = 0;
+		virtual void writeFloat( Float value ) = 0;
+		virtual void writeString( const Char* value ) = 0;
+
+		virtual void beginObject() = 0;
+		virtual void writeKey( const Char* name ) = 0;
+		virtual void endObject() = 0;
+
+		virtual void beginArray() = 0;
+		virtual void endArray() = 0;
+
+		/**
+		 *	Write a whole tree
+		 */
+		Bool writeNode( JSon::Ptr json, String* error = nullptr );
+
+		static JSonWriter* createTextWriter( IOutputStream& outputStream );
+		static JSonWriter* createBinaryWriter( IOutputStream& outputStream );
+
+	protected:
+		JSonWriter() = default;
+	};
+
+} // namespace flu
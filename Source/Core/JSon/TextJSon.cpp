@@ -12,165 +12,169 @@ namespace flu
 
 	static const Int32 JSON_INDENT_SIZE = 4;
 
-	JSon::Ptr JSon::loadFromText( Text::Ptr text, String* error )
+	/**
+	 *	An old lexer based loader, it's kept only to compare with the
+	 *	document's parser
+	 */
+	struct LegacyJSonLoader
 	{
-		struct Loader
+	public:
+		static JSon::Ptr loadJSonNode( lexer::Lexer& parser, String& error )
 		{
-		public:
-			static JSon::Ptr loadJSonNode( lexer::Lexer& parser, String& error )
+			lexer::Token token;
+			if( parser.getToken( token, true ) )
 			{
-				lexer::Token token;
-				if( parser.getToken( token, true ) )
+				switch ( token.getType() )
 				{
-					switch ( token.getType() )
+					case lexer::ETokenType::Symbol:
 					{
-						case lexer::ETokenType::Symbol:
+						if( token.getText() == L"{" )
 						{
-							if( token.getText() == L"{" )
+							JSon::Ptr objectNode = JSon::createObjectNode();
+
+							for( ; ; )
 							{
-								JSon::Ptr objectNode = JSon::createObjectNode();
+								lexer::Token nextToken;
 
-								for( ; ; )
+								if( parser.getToken( nextToken, false ) )
 								{
-									lexer::Token nextToken;
-
-									if( parser.getToken( nextToken, false ) )
+									if( nextToken.getText() == L"}" )
+									{
+										return objectNode;
+									}
+									else if( nextToken.getType() == lexer::ETokenType::Identifier )
 									{
-										if( nextToken.getText() == L"}" )
+										if( !parser.matchSymbol( L":" ) )
 										{
-											return objectNode;
+											error = L"missing \":\"";
+											return nullptr;
 										}
-										else if( nextToken.getType() == lexer::ETokenType::Identifier )
+
+										JSon::Ptr valueNode = loadJSonNode( parser, error );
+										if( valueNode.hasObject() )
 										{
-											if( !parser.matchSymbol( L":" ) )
-											{
-												error = L"missing \":\"";
-												return nullptr;
-											}
+											objectNode->addField( nextToken.getText(), valueNode );
 
-											JSon::Ptr valueNode = loadJSonNode( parser, error );
-											if( valueNode.hasObject() )
+											if( parser.matchSymbol( L"}" ) )
 											{
-												objectNode->addField( nextToken.getText(), valueNode );
-
-												if( parser.matchSymbol( L"}" ) )
-												{
-													return objectNode;
-												}
-												else
-												{
-													if( !parser.matchSymbol( L"," ) )
-													{
-														error = L"missing \",\"";
-														return nullptr;
-													}
-												}
+												return objectNode;
 											}
 											else
 											{
-												return nullptr;
+												if( !parser.matchSymbol( L"," ) )
+												{
+													error = L"missing \",\"";
+													return nullptr;
+												}
 											}
 										}
 										else
 										{
-											error = String::format( L"unexpected token \"%s\"", *nextToken.getText() );
 											return nullptr;
 										}
 									}
 									else
 									{
-										error = L"unexpected end of text";
+										error = String::format( L"unexpected token \"%s\"", *nextToken.getText() );
 										return nullptr;
 									}
 								}
+								else
+								{
+									error = L"unexpected end of text";
+									return nullptr;
+								}
 							}
-							else if( token.getText() == L"[" )
-							{					
-								JSon::Ptr arrayNode = JSon::createArrayNode();
+						}
+						else if( token.getText() == L"[" )
+						{					
+							JSon::Ptr arrayNode = JSon::createArrayNode();
 
-								for( ; ; )
-								{							
-									if( parser.peekSymbol() == L"]" )
-									{
-										return arrayNode;
-									}
-									else
+							for( ; ; )
+							{							
+								if( parser.peekSymbol() == L"]" )
+								{
+									return arrayNode;
+								}
+								else
+								{
+									JSon::Ptr valueNode = loadJSonNode( parser, error );
+									if( valueNode.hasObject() )
 									{
-										JSon::Ptr valueNode = loadJSonNode( parser, error );
-										if( valueNode.hasObject() )
-										{
-											arrayNode->insertElement( valueNode );
+										arrayNode->insertElement( valueNode );
 
-											if( parser.matchSymbol( L"]" ) )
-											{
-												return arrayNode;
-											}
-											else
-											{
-												if( !parser.matchSymbol( L"," ) )
-												{
-													error = L"missing \",\"";
-													return nullptr;
-												}
-											}
+										if( parser.matchSymbol( L"]" ) )
+										{
+											return arrayNode;
 										}
 										else
 										{
-											return nullptr;
+											if( !parser.matchSymbol( L"," ) )
+											{
+												error = L"missing \",\"";
+												return nullptr;
+											}
 										}
 									}
+									else
+									{
+										return nullptr;
+									}
 								}
 							}
-							else
-							{
-								error = String::format( L"unexpected symbol \"%s\"", *token.getText() );
-								return nullptr;
-							}
 						}
-						case lexer::ETokenType::Identifier:
+						else
 						{
-							if( cstr::insensitiveCompare( *token.getText(), JSON_BOOL_TRUE ) == 0 )
-							{
-								return JSon::createBoolNode( true );
-							}
-							else if( cstr::insensitiveCompare( *token.getText(), JSON_BOOL_FALSE ) == 0 )
-							{
-								return JSon::createBoolNode( false );
-							}
-							else
-							{
-								error = String::format( L"unexpected identifier \"%s\"", *token.getText() );
-								return nullptr;
-							}
-						}
-						case lexer::ETokenType::String:
-						{
-							return JSon::createStringNode( token.getStringConst() );
+							error = String::format( L"unexpected symbol \"%s\"", *token.getText() );
+							return nullptr;
 						}
-						case lexer::ETokenType::Integer:
+					}
+					case lexer::ETokenType::Identifier:
+					{
+						if( cstr::insensitiveCompare( *token.getText(), JSON_BOOL_TRUE ) == 0 )
 						{
-							return JSon::createIntNode( token.getIntConst() );
+							return JSon::createBoolNode( true );
 						}
-						case lexer::ETokenType::Float:
+						else if( cstr::insensitiveCompare( *token.getText(), JSON_BOOL_FALSE ) == 0 )
 						{
-							return JSon::createFloatNode( token.getFloatConst() );
+							return JSon::createBoolNode( false );
 						}
-						case lexer::ETokenType::Unknown:
-						default:
+						else
 						{
-							error = L"unexpected token";
+							error = String::format( L"unexpected identifier \"%s\"", *token.getText() );
 							return nullptr;
 						}
 					}
-				}
-				else
-				{
-					error = L"unexpected end of text";
-					return nullptr;
+					case lexer::ETokenType::String:
+					{
+						return JSon::createStringNode( token.getStringConst() );
+					}
+					case lexer::ETokenType::Integer:
+					{
+						return JSon::createIntNode( token.getIntConst() );
+					}
+					case lexer::ETokenType::Float:
+					{
+						return JSon::createFloatNode( token.getFloatConst() );
+					}
+					case lexer::ETokenType::Unknown:
+					default:
+					{
+						error = L"unexpected token";
+						return nullptr;
+					}
 				}
 			}
-		};
+			else
+			{
+				error = L"unexpected end of text";
+				return nullptr;
+			}
+		}
+	};
 
+	static JSon::Ptr loadLegacyJSon( Text::Ptr text, String* error )
+	{
 		const lexer::LexerConfig jsonConfig =
 		{
 			{ },
@@ -179,7 +183,7 @@ namespace flu
 
 		String tempError;
 		lexer::Lexer parser( text, jsonConfig );
-		JSon::Ptr result = Loader::loadJSonNode( parser, tempError );
+		JSon::Ptr result = LegacyJSonLoader::loadJSonNode( parser, tempError );
 
 		if( !result && error )
 		{
@@ -189,6 +193,53 @@ namespace flu
 		return result;
 	}
 
+	JSon::Ptr JSon::loadFromText( Text::Ptr text, String* error )
+	{
+		JSonDocument::Ptr document = JSonDocument::parse( text, error );
+		return document.hasObject() ? JSon::createDocumentNode( document, document->root() ) : nullptr;
+	}
+
+	void JSon::benchmarkLoaders( const Char* fileName, Int32 numIterations )
+	{
+		Text::Ptr text = fm::readTextFile( fileName );
+
+		if( !text.hasObject() )
+		{
+			error( L"JSon benchmark: unable to read \"%s\"", fileName );
+			return;
+		}
+
+		String legacyError, documentError;
+		UInt64 legacyCycles = 0, documentCycles = 0;
+		UInt32 valuesCount = 0;
+		SizeT arenaSize = 0;
+
+		for( Int32 i = 0; i < numIterations; ++i )
+		{
+			UInt64 startCycles = time::cycles64();
+			JSon::Ptr legacy = loadLegacyJSon( text, &legacyError );
+			legacyCycles += time::cycles64() - startCycles;
+
+			startCycles = time::cycles64();
+			JSonDocument::Ptr document = JSonDocument::parse( text, &documentError );
+			documentCycles += time::cycles64() - startCycles;
+
+			if( !legacy.hasObject() || !document.hasObject() )
+			{
+				error( L"JSon benchmark: \"%s\" failed with \"%s\" / \"%s\"", fileName, *legacyError, *documentError );
+				return;
+			}
+
+			valuesCount = document->valuesCount();
+			arenaSize = document->arenaSize();
+		}
+
+		info( L"JSon benchmark: \"%s\", %d iterations", fileName, numIterations );
+		info( L"  Lexer loader: %.4f ms per file", time::cyclesToMs( legacyCycles ) / numIterations );
+		info( L"  Document parser: %.4f ms per file", time::cyclesToMs( documentCycles ) / numIterations );
+		info( L"  Values: %d; Arena: %d KB", valuesCount, static_cast<Int32>( arenaSize / 1024 ) );
+	}
+
 	Text::Ptr JSon::saveToText( JSon::Ptr json, String* error )
 	{
 		struct Saver
@@ -221,15 +272,16 @@ namespace flu
 							String indent = String::ofChar( ' ', ( indentLevel + 1 ) * JSON_INDENT_SIZE );
 							String result = L"{\n";
 
-							for( auto it = json->firstField(); it != json->endField(); it++ )
+							for( Int32 i = 0; i < json->fieldsCount(); ++i )
 							{
-								String fieldText = saveJSonNode( it->value, error, indentLevel + 1 );
+								String fieldName;
+								String fieldText = saveJSonNode( json->getFieldAt( i, &fieldName ), error, indentLevel + 1 );
 
 								if( fieldText )
 								{
 									result += String::format( L"%s%s: %s%s\n", *indent, 
-										*it->key, *fieldText, 
-										it != ( json->endField() - 1 ) ? L"," : L"" );
+										*fieldName, *fieldText, 
+										i != ( json->fieldsCount() - 1 ) ? L"," : L"" );
 								}
 								else
 								{
@@ -288,4 +340,533 @@ namespace flu
 
 		return result ? new Text( result ) : nullptr;
 	}
+
+	/**
+	 *	A text JSon writer. Its output matches JSon::saveToText, characters
+	 *	are stored as 8-bit, as text files are written
+	 */
+	class TextJSonWriter: public JSonWriter
+	{
+	public:
+		TextJSonWriter( IOutputStream& outputStream )
+			:	m_stream( outputStream ),
+				m_bufferSize( 0 )
+		{
+		}
+
+		~TextJSonWriter()
+		{
+			flush();
+		}
+
+		void writeBool( Bool value ) override
+		{
+			beginValue();
+			write( value ? JSON_BOOL_TRUE : JSON_BOOL_FALSE );
+			endValue();
+		}
+
+		void writeInt( Int32 value ) override
+		{
+			beginValue();
+			write( *String::fromInteger( value ) );
+			endValue();
+		}
+
+		void writeFloat( Float value ) override
+		{
+			beginValue();
+			write( *String::fromFloat( value ) );
+			endValue();
+		}
+
+		void writeString( const Char* value ) override
+		{
+			beginValue();
+			write( L"\"" );
+			write( value );
+			write( L"\"" );
+			endValue();
+		}
+
+		void beginObject() override
+		{
+			beginValue();
+			write( L"{" );
+			m_containers.push( Container{ 0, true } );
+		}
+
+		void writeKey( const Char* name ) override
+		{
+			assert( m_containers.size() > 0 && m_containers.last().isObject );
+
+			beginItem();
+			write( name );
+			write( L": " );
+		}
+
+		void endObject() override
+		{
+			assert( m_containers.size() > 0 && m_containers.last().isObject );
+
+			m_containers.pop();
+			write( L"\n" );
+			writeIndent( m_containers.size() );
+			write( L"}" );
+			endValue();
+		}
+
+		void beginArray() override
+		{
+			beginValue();
+			write( L"[" );
+			m_containers.push( Container{ 0, false } );
+		}
+
+		void endArray() override
+		{
+			assert( m_containers.size() > 0 && !m_containers.last().isObject );
+
+			m_containers.pop();
+			write( L"\n" );
+			writeIndent( m_containers.size() );
+			write( L"]" );
+			endValue();
+		}
+
+	private:
+		struct Container
+		{
+			Int32 count;
+			Bool isObject;
+		};
+
+		IOutputStream& m_stream;
+		Array<Container> m_containers;
+
+		AnsiChar m_buffer[1024];
+		SizeT m_bufferSize;
+
+		void beginItem()
+		{
+			Container& container = m_containers.last();
+			write( container.count > 0 ? L",\n" : L"\n" );
+			writeIndent( m_containers.size() );
+			container.count++;
+		}
+
+		void beginValue()
+		{
+			// object's values are prefixed by keys
+			if( m_containers.size() > 0 && !m_containers.last().isObject )
+			{
+				beginItem();
+			}
+		}
+
+		void endValue()
+		{
+			if( m_containers.size() == 0 )
+			{
+				write( L"\n" );
+				flush();
+			}
+		}
+
+		void writeIndent( Int32 indentLevel )
+		{
+			for( Int32 i = 0; i < indentLevel * JSON_INDENT_SIZE; ++i )
+			{
+				write( L" " );
+			}
+		}
+
+		void write( const Char* text )
+		{
+			for( ; *text; ++text )
+			{
+				if( m_bufferSize == arraySize( m_buffer ) )
+				{
+					flush();
+				}
+
+				m_buffer[m_bufferSize++] = *text < 256 ? static_cast<AnsiChar>( *text ) : '?';
+			}
+		}
+
+		void flush()
+		{
+			if( m_bufferSize > 0 )
+			{
+				m_stream.writeData( m_buffer, m_bufferSize );
+				m_bufferSize = 0;
+			}
+		}
+	};
+
+	JSonWriter* JSonWriter::createTextWriter( IOutputStream& outputStream )
+	{
+		return new TextJSonWriter( outputStream );
+	}
+
+	/**
+	 *	A text JSon reader. It reads the stream by small chunks and accepts
+	 *	the same dialect as JSonDocument's parser
+	 */
+	class TextJSonReader
+	{
+	public:
+		TextJSonReader( IInputStream& inputStream, IJSonHandler& handler )
+			:	m_stream( inputStream ),
+				m_handler( handler ),
+				m_bufferPosition( 0 ),
+				m_bufferSize( 0 ),
+				m_line( 0 ),
+				m_token( nullptr ),
+				m_tokenLength( 0 ),
+				m_tokenCapacity( 0 )
+		{
+		}
+
+		~TextJSonReader()
+		{
+			mem::free( m_token );
+		}
+
+		Bool read()
+		{
+			return readValue();
+		}
+
+		String getError() const
+		{
+			return String::format( L"%s at line: %d", *m_error, m_line );
+		}
+
+	private:
+		IInputStream& m_stream;
+		IJSonHandler& m_handler;
+
+		AnsiChar m_buffer[4096];
+		SizeT m_bufferPosition;
+		SizeT m_bufferSize;
+		Int32 m_line;
+
+		// current string, identifier or number, it's never shrunk
+		Char* m_token;
+		SizeT m_tokenLength;
+		SizeT m_tokenCapacity;
+		String m_error;
+
+		Bool error( const Char* message )
+		{
+			m_error = message;
+			return false;
+		}
+
+		void pushToken( Char c )
+		{
+			if( m_tokenLength == m_tokenCapacity )
+			{
+				m_tokenCapacity = max<SizeT>( m_tokenCapacity * 2, 64 );
+				m_token = reinterpret_cast<Char*>( mem::realloc( m_token, m_tokenCapacity * sizeof( Char ) ) );
+			}
+
+			m_token[m_tokenLength++] = c;
+		}
+
+		void endToken()
+		{
+			pushToken( '\0' );
+			m_tokenLength--;
+		}
+
+		Bool handleResult( Bool result )
+		{
+			return result ? true : error( L"reading stopped by handler" );
+		}
+
+		Char peekChar()
+		{
+			if( m_bufferPosition == m_bufferSize )
+			{
+				const SizeT bytesToRead = min<SizeT>( arraySize( m_buffer ), m_stream.totalSize() - m_stream.tell() );
+				m_bufferSize = bytesToRead > 0 ? m_stream.readData( m_buffer, bytesToRead ) : 0;
+				m_bufferPosition = 0;
+
+				if( m_bufferSize == 0 )
+				{
+					return '\0';
+				}
+			}
+
+			return static_cast<UInt8>( m_buffer[m_bufferPosition] );
+		}
+
+		Char nextChar()
+		{
+			const Char c = peekChar();
+
+			if( c != '\0' )
+			{
+				m_bufferPosition++;
+				m_line += c == '\n' ? 1 : 0;
+			}
+
+			return c;
+		}
+
+		void skipSpaces()
+		{
+			for( Char c = peekChar(); c == 0x20 || c == 0x09 || c == 0x0d || c == 0x0a; c = peekChar() )
+			{
+				nextChar();
+			}
+		}
+
+		Bool matchSymbol( Char symbol )
+		{
+			skipSpaces();
+
+			if( peekChar() == symbol )
+			{
+				nextChar();
+				return true;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		Bool readString()
+		{
+			assert( peekChar() == '\"' );
+			nextChar();
+			m_tokenLength = 0;
+
+			for( Char c = nextChar(); c != '\"'; c = nextChar() )
+			{
+				if( c == '\0' )
+				{
+					return error( L"unterminated string" );
+				}
+
+				pushToken( c );
+			}
+
+			endToken();
+			return true;
+		}
+
+		void readIdentifier()
+		{
+			assert( cstr::isLetter( peekChar() ) );
+			m_tokenLength = 0;
+
+			while( cstr::isDigitLetter( peekChar() ) )
+			{
+				pushToken( nextChar() );
+			}
+
+			endToken();
+		}
+
+		Bool readNumber()
+		{
+			m_tokenLength = 0;
+			Bool isFloat = false;
+
+			if( peekChar() == '-' )
+			{
+				pushToken( nextChar() );
+
+				if( !cstr::isDigit( peekChar() ) )
+				{
+					return error( L"unexpected symbol \"-\"" );
+				}
+			}
+
+			for( Char c = peekChar(); cstr::isDigit( c ) || c == '.' || c == 'e' || c == 'E' ||
+				( ( c == '-' || c == '+' ) && ( m_token[m_tokenLength - 1] == 'e' || m_token[m_tokenLength - 1] == 'E' ) ); c = peekChar() )
+			{
+				isFloat |= !cstr::isDigit( c );
+				pushToken( nextChar() );
+			}
+
+			// legacy float suffix
+			if( peekChar() == 'f' )
+			{
+				isFloat = true;
+				nextChar();
+			}
+
+			endToken();
+			String number( m_token, m_tokenLength );
+
+			if( isFloat )
+			{
+				Float value;
+				number.toFloat( value, 0.f );
+				return handleResult( m_handler.onFloat( value ) );
+			}
+			else
+			{
+				Int32 value;
+				number.toInteger( value, 0 );
+				return handleResult( m_handler.onInt( value ) );
+			}
+		}
+
+		Bool readObject()
+		{
+			assert( peekChar() == '{' );
+			nextChar();
+
+			if( !handleResult( m_handler.onBeginObject() ) )
+			{
+				return false;
+			}
+
+			while( !matchSymbol( '}' ) )
+			{
+				const Char c = peekChar();
+
+				if( c == '\0' )
+				{
+					return error( L"unexpected end of text" );
+				}
+				else if( c == '\"' )
+				{
+					if( !readString() )
+						return false;
+				}
+				else if( cstr::isLetter( c ) )
+				{
+					readIdentifier();
+				}
+				else
+				{
+					return error( L"unexpected token" );
+				}
+
+				if( !handleResult( m_handler.onKey( m_token, m_tokenLength ) ) )
+				{
+					return false;
+				}
+
+				if( !matchSymbol( ':' ) )
+				{
+					return error( L"missing \":\"" );
+				}
+
+				if( !readValue() )
+				{
+					return false;
+				}
+
+				if( matchSymbol( '}' ) )
+				{
+					break;
+				}
+				else if( !matchSymbol( ',' ) )
+				{
+					return error( L"missing \",\"" );
+				}
+			}
+
+			return handleResult( m_handler.onEndObject() );
+		}
+
+		Bool readArray()
+		{
+			assert( peekChar() == '[' );
+			nextChar();
+
+			if( !handleResult( m_handler.onBeginArray() ) )
+			{
+				return false;
+			}
+
+			while( !matchSymbol( ']' ) )
+			{
+				if( !readValue() )
+				{
+					return false;
+				}
+
+				if( matchSymbol( ']' ) )
+				{
+					break;
+				}
+				else if( !matchSymbol( ',' ) )
+				{
+					return error( L"missing \",\"" );
+				}
+			}
+
+			return handleResult( m_handler.onEndArray() );
+		}
+
+		Bool readValue()
+		{
+			skipSpaces();
+			const Char c = peekChar();
+
+			if( c == '\0' )
+			{
+				return error( L"unexpected end of text" );
+			}
+			else if( c == '{' )
+			{
+				return readObject();
+			}
+			else if( c == '[' )
+			{
+				return readArray();
+			}
+			else if( c == '\"' )
+			{
+				return readString() && handleResult( m_handler.onString( m_token, m_tokenLength ) );
+			}
+			else if( cstr::isDigit( c ) || c == '-' )
+			{
+				return readNumber();
+			}
+			else if( cstr::isLetter( c ) )
+			{
+				readIdentifier();
+
+				if( cstr::insensitiveCompare( m_token, JSON_BOOL_TRUE ) == 0 )
+				{
+					return handleResult( m_handler.onBool( true ) );
+				}
+				else if( cstr::insensitiveCompare( m_token, JSON_BOOL_FALSE ) == 0 )
+				{
+					return handleResult( m_handler.onBool( false ) );
+				}
+				else
+				{
+					return error( *String::format( L"unexpected identifier \"%s\"", m_token ) );
+				}
+			}
+			else
+			{
+				return error( *String::format( L"unexpected symbol \"%c\"", c ) );
+			}
+		}
+	};
+
+	Bool JSonReader::readText( IInputStream& inputStream, IJSonHandler& handler, String* error )
+	{
+		TextJSonReader reader( inputStream, handler );
+		Bool result = reader.read();
+
+		if( !result && error )
+		{
+			*error = reader.getError();
+		}
+
+		return result;
+	}
 }
\ No newline at end of file
@@ -28,6 +28,9 @@ namespace job
 
 		Task* nextAvailable = nullptr;
 		TaskId thisId = INVALID_TASK_ID;
+
+		// waited task is released by the waiter, so its id is never reused while waiting
+		Bool autoRelease = true;
 	};
 
 	/**
@@ -41,8 +44,9 @@ namespace job
 		JobSystem( UInt32 numWorkerThreads );
 		~JobSystem();
 
-		void createTasks( UInt32 numTasks, Task** outTaskList );
+		Bool createTasks( UInt32 numTasks, Task** outTaskList );
 		void submitTasks( UInt32 numTasks, Task** taskList );
+		void releaseTask( Task* task );
 
 		Bool isTaskFinished( TaskId taskId ) const;
 		void helpWithTasks();
@@ -52,6 +56,7 @@ namespace job
 		
 		StaticArray<Task, TASK_POOL_SIZE> m_taskPool;
 		Task* m_firstAvailableTask;
+		UInt32 m_numAvailableTasks;
 		concurrency::CriticalSection::UPtr m_poolCS;
 
 		Array<threading::Thread::UPtr> m_threads;
@@ -87,6 +92,7 @@ namespace job
 		}
 
 		m_firstAvailableTask = &m_taskPool[0];
+		m_numAvailableTasks = TASK_POOL_SIZE;
 
 		// create working threads
 		m_threads.setSize( numWorkerThreads );
@@ -121,17 +127,27 @@ namespace job
 		debug( L"Job System shutdown" );
 	}
 
-	void JobSystem::createTasks( UInt32 numTasks, Task** outTaskList )
+	Bool JobSystem::createTasks( UInt32 numTasks, Task** outTaskList )
 	{
 		assert( numTasks > 0 && outTaskList );
 
 		concurrency::CriticalSection::Guard csg( m_poolCS );
 
+		// nested graphs may drain the pool, caller has to do the work itself then
+		if( numTasks > m_numAvailableTasks )
+		{
+			return false;
+		}
+
 		for( UInt32 i = 0; i < numTasks; ++i )
 		{
 			outTaskList[i] = m_firstAvailableTask;
+			outTaskList[i]->autoRelease = true;
 			m_firstAvailableTask = m_firstAvailableTask->nextAvailable;
 		}
+
+		m_numAvailableTasks -= numTasks;
+		return true;
 	}
 
 	void JobSystem::submitTasks( UInt32 numTasks, Task** taskList )
@@ -148,6 +164,15 @@ namespace job
 		m_taskQueueSemaphore->push( numTasks );
 	}
 
+	void JobSystem::releaseTask( Task* task )
+	{
+		concurrency::CriticalSection::Guard csg( m_poolCS );
+
+		task->nextAvailable = m_firstAvailableTask;
+		m_firstAvailableTask = task;
+		m_numAvailableTasks++;
+	}
+
 	Bool JobSystem::isTaskFinished( TaskId taskId ) const
 	{
 		return m_taskPool[taskId].openTasks.getValue() == 0;
@@ -182,23 +207,31 @@ namespace job
 
 	void JobSystem::processTask( Task* task )
 	{
-		while( task->openTasks.getValue() > 1 )
-		{
-			threading::yield();
-		}
+		// only tasks without open children are queued, so nobody ever spins
+		// here waiting for a task, which is deeper in the own stack
+		assert( task->openTasks.getValue() == 1 );
+
+		const TaskId parentTask = task->parentTask;
+		const Bool autoRelease = task->autoRelease;
 
 		task->func( task->userData );
 		task->openTasks.decrement();
 
-		if( task->parentTask != INVALID_TASK_ID )
+		// the last child makes parent ready
+		if( parentTask != INVALID_TASK_ID )
 		{
-			m_taskPool[task->parentTask].openTasks.decrement();
+			Task* parent = &m_taskPool[parentTask];
+
+			if( parent->openTasks.decrement() == 1 )
+			{
+				submitTasks( 1, &parent );
+			}
 		}
 
-		// return to pool
-		concurrency::CriticalSection::Guard csg( m_poolCS );
-		task->nextAvailable = m_firstAvailableTask;
-		m_firstAvailableTask = task;
+		if( autoRelease )
+		{
+			releaseTask( task );
+		}
 	}
 
 	void JobSystem::workerThreadEntry( void* context )
@@ -236,6 +269,56 @@ namespace job
 		return g_jobSystem.hasObject();
 	}
 
+	Int32 parallelFor( Int32 count, Int32 itemsPerTask, Int32 maxTasks, 
+		RangeFunc func, void* userData, Int32 alignment )
+	{
+		assert( count >= 0 && itemsPerTask > 0 && maxTasks > 0 );
+		assert( alignment > 0 && ( alignment & ( alignment - 1 ) ) == 0 );
+		assert( func );
+
+		const Int32 numTasks = isInitialized() ? 
+			clamp( count / itemsPerTask, 1, min( maxTasks, MAX_PARALLEL_TASKS ) ) : 1;
+
+		if( numTasks == 1 )
+		{
+			func( userData, 0, 0, count );
+			return 1;
+		}
+
+		struct RangeTask
+		{
+		public:
+			RangeFunc func;
+			void* userData;
+			Int32 taskIndex;
+			Int32 first;
+			Int32 last;
+		};
+
+		RangeTask tasks[MAX_PARALLEL_TASKS];
+		TaskGraph graph( numTasks );
+
+		for( Int32 i = 0; i < numTasks; ++i )
+		{
+			RangeTask& task = tasks[i];
+			task.func = func;
+			task.userData = userData;
+			task.taskIndex = i;
+			task.first = static_cast<Int32>( Int64( count ) * i / numTasks ) & ~( alignment - 1 );
+			task.last = i < numTasks - 1 ? 
+				static_cast<Int32>( Int64( count ) * ( i + 1 ) / numTasks ) & ~( alignment - 1 ) : count;
+
+			graph.addTask( []( void* userData )
+			{
+				const RangeTask* task = reinterpret_cast<const RangeTask*>( userData );
+				task->func( task->userData, task->taskIndex, task->first, task->last );
+			}, &task );
+		}
+
+		graph.wait();
+		return numTasks;
+	}
+
 	TaskGraph::TaskGraph( UInt32 maxTasks )
 		:	m_numNodes( 0 )
 	{
@@ -294,7 +377,18 @@ namespace job
 
 		// create and fill tasks
 		Task* tasks[MAX_NODES];
-		g_jobSystem->createTasks( m_numNodes, tasks );
+
+		if( !g_jobSystem->createTasks( m_numNodes, tasks ) )
+		{
+			// pool is exhausted, just do everything here, root is the last
+			for( UInt32 i = 0; i < m_numNodes; ++i )
+			{
+				m_nodes[i].func( m_nodes[i].userData );
+			}
+
+			m_numNodes = 0;
+			return;
+		}
 
 		for( UInt32 i = 0; i < m_numNodes; ++i )
 		{
@@ -307,18 +401,21 @@ namespace job
 			task->openTasks.setValue( node.openTasks );
 		}
 
-		// submit
-		g_jobSystem->submitTasks( m_numNodes, tasks );
+		Task* rootTask = tasks[m_numNodes - 1];
+		rootTask->autoRelease = !waitForComplete;
+
+		// submit all, but root, it's queued by the last finished child
+		g_jobSystem->submitTasks( m_numNodes - 1, tasks );
 
 		// wait and help with tasks
 		if( waitForComplete )
 		{
-			TaskId rootTaskId = tasks[m_numNodes - 1]->thisId;
-
-			while( !g_jobSystem->isTaskFinished( rootTaskId ) )
+			while( !g_jobSystem->isTaskFinished( rootTask->thisId ) )
 			{
 				g_jobSystem->helpWithTasks();
 			}
+
+			g_jobSystem->releaseTask( rootTask );
 		}
 
 		m_numNodes = 0;
@@ -12,6 +12,7 @@ namespace job
 	 */
 	using NodeId = UInt32;
 	using TaskFunc = void(*)( void* userData ); 
+	using RangeFunc = void(*)( void* userData, Int32 taskIndex, Int32 first, Int32 last );
 
 	static const NodeId INVALID_NODE_ID = -1;
 
@@ -55,5 +56,47 @@ namespace job
 	extern void initialize( UInt32 numWorkerThreads );
 	extern void shutdown();
 	extern Bool isInitialized();
+
+	/**
+	 *	Split [0..count) into contiguous ranges of at least itemsPerTask items and
+	 *	process them across job workers and the calling thread. Range bounds are
+	 *	multiple of the power of two alignment. Whole range is processed inline if
+	 *	the job system isn't initialized. Returns number of used tasks, taskIndex
+	 *	passed to func is less than it
+	 */
+	static const Int32 MAX_PARALLEL_TASKS = 64;
+
+	extern Int32 parallelFor( Int32 count, Int32 itemsPerTask, Int32 maxTasks, 
+		RangeFunc func, void* userData, Int32 alignment = 1 );
+
+	/**
+	 *	A job system lifetime scope, initializes the job system
+	 *	if nobody did it before and shuts it down on leave
+	 */
+	class ScopedJobSystem: public NonCopyable
+	{
+	public:
+		ScopedJobSystem( UInt32 numWorkerThreads )
+			:	m_owner( !isInitialized() )
+		{
+			if( m_owner )
+			{
+				initialize( numWorkerThreads );
+			}
+		}
+
+		~ScopedJobSystem()
+		{
+			if( m_owner )
+			{
+				shutdown();
+			}
+		}
+
+	private:
+		Bool m_owner;
+
+		ScopedJobSystem() = delete;
+	};
 }
 }
\ No newline at end of file
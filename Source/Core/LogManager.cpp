@@ -22,23 +22,73 @@ namespace flu
 		void addCallback( ILogCallback* callback ) override;
 		void removeCallback( ILogCallback* callback ) override;
 
+		void addAsyncCallback( ILogCallback* callback ) override;
+		void setOverflowPolicy( ELogOverflow policy ) override;
+		void flush() override;
+
 	private:
+		static const Int32 MAX_BATCH_SIZE = 64;
+		static const UInt32 IDLE_SLEEP_MS = 5;
+
 		Array<ILogCallback*> m_callbacks;
+
+		Array<ILogCallback*> m_asyncCallbacks;
+		concurrency::CriticalSection::UPtr m_asyncLock;
+
+		LogQueue m_queue;
+		ELogOverflow m_overflowPolicy;
+
+		threading::Thread::UPtr m_logThread;
+		threading::ThreadId m_logThreadId;
+
+		concurrency::Atomic m_hasAsyncCallbacks;
+		concurrency::Atomic m_exitRequested;
+		concurrency::Atomic m_deliveredPosition;
+		concurrency::Atomic m_droppedCount;
+
+		void enqueueMessage( ELogLevel level, Bool isScript, const Char* message );
+		void deliverMessage( ELogLevel level, Bool isScript, const Char* message );
+		Int32 deliverBatch( Char* buffer, SizeT bufferSize );
+
+		void logThreadLoop();
+		static void logThreadEntry( void* arg );
 	};
 
 	LogManagerImpl::LogManagerImpl()
+		:	m_overflowPolicy( ELogOverflow::Block ),
+			m_logThreadId( 0 ),
+			m_hasAsyncCallbacks( 0 ),
+			m_exitRequested( 0 ),
+			m_deliveredPosition( 0 ),
+			m_droppedCount( 0 )
 	{
+		m_asyncLock = concurrency::CriticalSection::create();
 	}
 
 	LogManagerImpl::~LogManagerImpl()
 	{
+		// deliver the rest of messages before callbacks destruction
+		if( m_logThread.hasObject() )
+		{
+			m_exitRequested.setValue( 1 );
+			m_logThread->wait();
+			m_logThread = nullptr;
+		}
+
 		for( auto& it : m_callbacks )
 		{
 			delete it;
 			it = nullptr;
 		}
 
+		for( auto& it : m_asyncCallbacks )
+		{
+			delete it;
+			it = nullptr;
+		}
+
 		m_callbacks.empty();
+		m_asyncCallbacks.empty();
 	}
 
 #define bufferize_vaargs	\
@@ -56,6 +106,11 @@ namespace flu
 		{
 			it->handleMessage( level, buffer );
 		}
+
+		if( m_hasAsyncCallbacks.getValue() )
+		{
+			enqueueMessage( level, false, buffer );
+		}
 	}
 
 	void LogManagerImpl::handleScriptMessage( ELogLevel level, const Char* fmt, ... )
@@ -66,11 +121,29 @@ namespace flu
 		{
 			it->handleScriptMessage( level, buffer );
 		}
+
+		if( m_hasAsyncCallbacks.getValue() )
+		{
+			enqueueMessage( level, true, buffer );
+		}
 	}
 
 	void LogManagerImpl::handleFatalMessage( const Char* fmt, ... )
 	{
 		bufferize_vaargs;
+
+		// async callbacks go first, since sync ones may terminate the process
+		if( m_hasAsyncCallbacks.getValue() )
+		{
+			flush();
+
+			concurrency::CriticalSection::Guard guard( m_asyncLock );
+
+			for( auto it : m_asyncCallbacks )
+			{
+				it->handleFatalMessage( buffer );
+			}
+		}
 		
 		for( auto it : m_callbacks )
 		{
@@ -81,6 +154,19 @@ namespace flu
 	void LogManagerImpl::handleFatalScriptMessage( const Char* fmt, ... )
 	{
 		bufferize_vaargs;
+
+		// async callbacks go first, since sync ones may terminate the process
+		if( m_hasAsyncCallbacks.getValue() )
+		{
+			flush();
+
+			concurrency::CriticalSection::Guard guard( m_asyncLock );
+
+			for( auto it : m_asyncCallbacks )
+			{
+				it->handleFatalScriptMessage( buffer );
+			}
+		}
 		
 		for( auto it : m_callbacks )
 		{
@@ -100,6 +186,141 @@ namespace flu
 	{
 		assert( callback );
 		m_callbacks.removeUnique( callback, true );
+
+		concurrency::CriticalSection::Guard guard( m_asyncLock );
+		m_asyncCallbacks.removeUnique( callback, true );
+
+		// stop queueing messages nobody will receive
+		m_hasAsyncCallbacks.setValue( m_asyncCallbacks.size() > 0 ? 1 : 0 );
+	}
+
+	void LogManagerImpl::addAsyncCallback( ILogCallback* callback )
+	{
+		assert( callback );
+
+		{
+			concurrency::CriticalSection::Guard guard( m_asyncLock );
+			m_asyncCallbacks.addUnique( callback );
+			m_hasAsyncCallbacks.setValue( 1 );
+		}
+
+		if( !m_logThread.hasObject() )
+		{
+			m_logThread = threading::Thread::create( logThreadEntry, this, "Log Thread" );
+		}
+	}
+
+	void LogManagerImpl::setOverflowPolicy( ELogOverflow policy )
+	{
+		m_overflowPolicy = policy;
+	}
+
+	void LogManagerImpl::flush()
+	{
+		if( !m_logThread.hasObject() || threading::getCurrentThreadId() == m_logThreadId )
+		{
+			return;
+		}
+
+		const UInt32 position = m_queue.getTail();
+
+		while( static_cast<Int32>( position - static_cast<UInt32>( m_deliveredPosition.getValue() ) ) > 0 )
+		{
+			threading::yield();
+		}
+	}
+
+	void LogManagerImpl::enqueueMessage( ELogLevel level, Bool isScript, const Char* message )
+	{
+		if( threading::getCurrentThreadId() == m_logThreadId )
+		{
+			// log thread can't wait for itself
+			concurrency::CriticalSection::Guard guard( m_asyncLock );
+			deliverMessage( level, isScript, message );
+			return;
+		}
+
+		const SizeT length = cstr::length( message );
+
+		while( !m_queue.tryPush( level, isScript, message, length ) )
+		{
+			if( m_overflowPolicy == ELogOverflow::Drop && ( level == ELogLevel::Info || level == ELogLevel::Debug ) )
+			{
+				m_droppedCount.increment();
+				return;
+			}
+
+			threading::yield();
+		}
+	}
+
+	void LogManagerImpl::deliverMessage( ELogLevel level, Bool isScript, const Char* message )
+	{
+		for( auto it : m_asyncCallbacks )
+		{
+			if( isScript )
+			{
+				it->handleScriptMessage( level, message );
+			}
+			else
+			{
+				it->handleMessage( level, message );
+			}
+		}
+	}
+
+	Int32 LogManagerImpl::deliverBatch( Char* buffer, SizeT bufferSize )
+	{
+		concurrency::CriticalSection::Guard guard( m_asyncLock );
+
+		ELogLevel level;
+		Bool isScript;
+		Int32 numMessages = 0;
+
+		while( numMessages < MAX_BATCH_SIZE && m_queue.tryPop( level, isScript, buffer, bufferSize ) )
+		{
+			deliverMessage( level, isScript, buffer );
+			++numMessages;
+		}
+
+		const Int32 numDropped = m_droppedCount.setValue( 0 );
+
+		if( numDropped > 0 )
+		{
+			String message = String::format( L"%d log messages were dropped due to queue overflow", numDropped );
+			deliverMessage( ELogLevel::Warning, false, *message );
+		}
+
+		return numMessages;
+	}
+
+	void LogManagerImpl::logThreadLoop()
+	{
+		m_logThreadId = threading::getCurrentThreadId();
+
+		Char buffer[MAX_MESSAGE_LENGTH];
+
+		while( true )
+		{
+			const Int32 numMessages = deliverBatch( buffer, MAX_MESSAGE_LENGTH );
+			m_deliveredPosition.setValue( static_cast<Int32>( m_queue.getHead() ) );
+
+			if( numMessages == 0 )
+			{
+				if( m_exitRequested.getValue() && m_queue.getHead() == m_queue.getTail() )
+				{
+					break;
+				}
+
+				threading::sleep( IDLE_SLEEP_MS );
+			}
+		}
+	}
+
+	void LogManagerImpl::logThreadEntry( void* arg )
+	{
+		assert( arg );
+		static_cast<LogManagerImpl*>( arg )->logThreadLoop();
 	}
 
 	LogManager& LogManager::instance()
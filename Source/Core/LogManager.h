@@ -5,6 +5,15 @@
 
 namespace flu
 {
+	/**
+	 *	What to do with a message if the async queue is full
+	 */
+	enum class ELogOverflow
+	{
+		Block,		// wait until log thread frees space
+		Drop		// drop info and debug messages, warnings and errors still wait
+	};
+
 	/**
 	 * A singleton Log manager
 	 */
@@ -24,6 +33,19 @@ namespace flu
 		virtual void addCallback( ILogCallback* callback ) = 0;
 		virtual void removeCallback( ILogCallback* callback ) = 0;
 
+		/**
+		 *	Add a callback which is called on the log thread. Messages are
+		 *	formatted on caller's thread and delivered in batches
+		 */
+		virtual void addAsyncCallback( ILogCallback* callback ) = 0;
+
+		virtual void setOverflowPolicy( ELogOverflow policy ) = 0;
+
+		/**
+		 *	Wait until all the queued messages are delivered
+		 */
+		virtual void flush() = 0;
+
 		static LogManager& instance();
 	};
 
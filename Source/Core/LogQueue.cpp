@@ -0,0 +1,121 @@
+//-----------------------------------------------------------------------------
+//	LogQueue.cpp: A lock-free queue of log records implementation
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Core.h"
+
+namespace flu
+{
+	LogQueue::LogQueue()
+		:	m_tail( 0 ),
+			m_head( 0 )
+	{
+		for( Int32 i = 0; i < NUM_SLOTS; ++i )
+		{
+			m_slots[i].sequence.setValue( i );
+		}
+	}
+
+	LogQueue::~LogQueue()
+	{
+	}
+
+	Bool LogQueue::tryPush( ELogLevel level, Bool isScript, const Char* message, SizeT length )
+	{
+		assert( message );
+
+		const UInt32 numSlots = max<UInt32>( static_cast<UInt32>( ( length + SLOT_LENGTH - 1 ) / SLOT_LENGTH ), 1 );
+		assert( numSlots <= NUM_SLOTS / 2 && numSlots <= 255 );
+
+		// claim consecutive slots. Slots are released in order, so if the
+		// last one is free, all the previous are free as well
+		UInt32 position;
+
+		while( true )
+		{
+			position = static_cast<UInt32>( m_tail.getValue() );
+
+			const UInt32 lastPosition = position + numSlots - 1;
+			const Int32 difference = static_cast<Int32>( static_cast<UInt32>( getSlot( lastPosition ).sequence.getValue() ) - lastPosition );
+
+			if( difference == 0 )
+			{
+				if( static_cast<UInt32>( m_tail.compareExchange( static_cast<Int32>( position + numSlots ), 
+					static_cast<Int32>( position ) ) ) == position )
+				{
+					break;
+				}
+			}
+			else if( difference < 0 )
+			{
+				// consumer is behind
+				return false;
+			}
+		}
+
+		// write and publish slots
+		for( UInt32 i = 0; i < numSlots; ++i )
+		{
+			Slot& slot = getSlot( position + i );
+
+			const SizeT offset = i * SLOT_LENGTH;
+			const SizeT slotLength = min<SizeT>( length - min<SizeT>( length, offset ), SLOT_LENGTH );
+
+			slot.level = level;
+			slot.isScript = isScript;
+			slot.numSlots = static_cast<UInt8>( numSlots );
+			slot.length = static_cast<UInt8>( slotLength );
+
+			mem::copy( slot.text, message + offset, slotLength * sizeof( Char ) );
+
+			slot.sequence.setValue( static_cast<Int32>( position + i + 1 ) );
+		}
+
+		return true;
+	}
+
+	Bool LogQueue::tryPop( ELogLevel& level, Bool& isScript, Char* buffer, SizeT bufferSize )
+	{
+		assert( buffer && bufferSize > 0 );
+
+		const UInt32 position = static_cast<UInt32>( m_head.getValue() );
+		Slot& first = getSlot( position );
+
+		if( static_cast<UInt32>( first.sequence.getValue() ) != position + 1 )
+		{
+			// nothing is published
+			return false;
+		}
+
+		level = first.level;
+		isScript = first.isScript;
+
+		const UInt32 numSlots = first.numSlots;
+		SizeT length = 0;
+
+		for( UInt32 i = 0; i < numSlots; ++i )
+		{
+			Slot& slot = getSlot( position + i );
+
+			// producer is still writing the rest of record
+			while( static_cast<UInt32>( slot.sequence.getValue() ) != position + i + 1 )
+			{
+				threading::yield();
+			}
+
+			const SizeT slotLength = min<SizeT>( slot.length, bufferSize - 1 - length );
+
+			mem::copy( buffer + length, slot.text, slotLength * sizeof( Char ) );
+			length += slotLength;
+
+			// release for the next round
+			slot.sequence.setValue( static_cast<Int32>( position + i + NUM_SLOTS ) );
+		}
+
+		buffer[length] = 0;
+
+		m_head.setValue( static_cast<Int32>( position + numSlots ) );
+		return true;
+	}
+}
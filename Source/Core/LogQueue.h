@@ -0,0 +1,75 @@
+//-----------------------------------------------------------------------------
+//	LogQueue.h: A lock-free queue of log records
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+	/**
+	 *	A bounded lock-free queue of log records with many producers and a
+	 *	single consumer. Each record takes one or more consecutive slots
+	 */
+	class LogQueue final: public NonCopyable
+	{
+	public:
+		static const Int32 NUM_SLOTS = 1024;
+		static const Int32 SLOT_LENGTH = 120;
+
+		LogQueue();
+		~LogQueue();
+
+		/**
+		 *	Try to enqueue a message, return false if queue is full
+		 */
+		Bool tryPush( ELogLevel level, Bool isScript, const Char* message, SizeT length );
+
+		/**
+		 *	Try to dequeue a message to the buffer, return false if nothing
+		 *	is ready yet. Must be called from the consumer thread only
+		 */
+		Bool tryPop( ELogLevel& level, Bool& isScript, Char* buffer, SizeT bufferSize );
+
+		/**
+		 *	Return position after the last claimed record
+		 */
+		UInt32 getTail() const
+		{
+			return static_cast<UInt32>( m_tail.getValue() );
+		}
+
+		/**
+		 *	Return position of the first not consumed record
+		 */
+		UInt32 getHead() const
+		{
+			return static_cast<UInt32>( m_head.getValue() );
+		}
+
+	private:
+		struct Slot
+		{
+			// position of the slot, +1 when written, +NUM_SLOTS when released
+			concurrency::Atomic sequence;
+
+			ELogLevel level;
+			Bool isScript;
+			UInt8 numSlots;
+			UInt8 length;
+
+			Char text[SLOT_LENGTH];
+		};
+
+		static_assert( ( NUM_SLOTS & ( NUM_SLOTS - 1 ) ) == 0, "Number of slots should be power of two" );
+		static_assert( SLOT_LENGTH <= 255, "Slot length doesn't fit UInt8" );
+
+		Slot m_slots[NUM_SLOTS];
+
+		concurrency::Atomic m_tail;
+		concurrency::Atomic m_head;
+
+		Slot& getSlot( UInt32 position )
+		{
+			return m_slots[position & ( NUM_SLOTS - 1 )];
+		}
+	};
+}
@@ -0,0 +1,236 @@
+//-----------------------------------------------------------------------------
+//	Name.cpp: An interned names implementation
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Core.h"
+
+namespace flu
+{
+	/**
+	 *	Names table. Lookups walk buckets without any locks, insertions are
+	 *	serialized with the spin lock. An entry is completely filled before it is
+	 *	published in the bucket and msvc's volatile store has release semantic,
+	 *	so readers never see partially built entries. The table is zero
+	 *	initialized, so names are available during static initialization
+	 */
+	const NameId::Entry* volatile NameId::s_buckets[NameId::HASH_SIZE];
+	concurrency::Atomic NameId::s_lock;
+	UInt8* NameId::s_blockCursor;
+	UInt8* NameId::s_blockEnd;
+	UInt32 NameId::s_count;
+
+	/**
+	 *	A lower case copy of the name, short names are converted on the stack
+	 */
+	class LowerCaseName
+	{
+	public:
+		LowerCaseName( const Char* name, SizeT length )
+			:	m_data( length < arraySize( m_buffer ) ? m_buffer :
+					reinterpret_cast<Char*>( mem::malloc( ( length + 1 ) * sizeof( Char ) ) ) ),
+				m_isLower( true )
+		{
+			for( SizeT i = 0; i < length; ++i )
+			{
+				m_data[i] = cstr::toLower( name[i] );
+				m_isLower &= m_data[i] == name[i];
+			}
+
+			m_data[length] = TXT('\0');
+		}
+
+		~LowerCaseName()
+		{
+			if( m_data != m_buffer )
+			{
+				mem::free( m_data );
+			}
+		}
+
+		const Char* data() const
+		{
+			return m_data;
+		}
+
+		Bool isLower() const
+		{
+			return m_isLower;
+		}
+
+	private:
+		Char m_buffer[128];
+		Char* m_data;
+		Bool m_isLower;
+	};
+
+	NameId::NameId( const Char* name )
+		:	m_entry( nullptr )
+	{
+		if( name && *name )
+		{
+			m_entry = internEntry( name, cstr::length( name ) );
+		}
+	}
+
+	NameId::NameId( const Char* name, SizeT length )
+		:	m_entry( nullptr )
+	{
+		if( name && length > 0 )
+		{
+			m_entry = internEntry( name, length );
+		}
+	}
+
+	NameId::NameId( const String& name )
+		:	m_entry( nullptr )
+	{
+		if( name.len() > 0 )
+		{
+			m_entry = internEntry( *name, name.len() );
+		}
+	}
+
+	NameId NameId::find( const Char* name )
+	{
+		NameId result;
+
+		if( name && *name )
+		{
+			const SizeT length = cstr::length( name );
+			result.m_entry = findEntry( name, length, hashName( name, length ) );
+		}
+
+		return result;
+	}
+
+	NameId NameId::find( const Char* name, SizeT length )
+	{
+		NameId result;
+
+		if( name && length > 0 )
+		{
+			result.m_entry = findEntry( name, length, hashName( name, length ) );
+		}
+
+		return result;
+	}
+
+	NameId NameId::findInsensitive( const Char* name )
+	{
+		NameId result;
+
+		if( name && *name )
+		{
+			const SizeT length = cstr::length( name );
+			LowerCaseName lowerName( name, length );
+
+			result.m_entry = findEntry( lowerName.data(), length, hashName( lowerName.data(), length ) );
+		}
+
+		return result;
+	}
+
+	UInt32 NameId::count()
+	{
+		return s_count;
+	}
+
+	UInt32 NameId::hashName( const Char* name, SizeT length )
+	{
+		return hashing::murmur32( name, length * sizeof( Char ) );
+	}
+
+	const NameId::Entry* NameId::findEntry( const Char* name, SizeT length, UInt32 hash )
+	{
+		for( const Entry* entry = s_buckets[hash & ( HASH_SIZE - 1 )]; entry; entry = entry->next )
+		{
+			if( entry->hash == hash && entry->length == length &&
+				mem::cmp( entry->data, name, length * sizeof( Char ) ) )
+			{
+				return entry;
+			}
+		}
+
+		return nullptr;
+	}
+
+	const NameId::Entry* NameId::internEntry( const Char* name, SizeT length )
+	{
+		assert( length > 0 );
+		const UInt32 hash = hashName( name, length );
+
+		// most of names are already interned
+		if( const Entry* entry = findEntry( name, length, hash ) )
+		{
+			return entry;
+		}
+
+		while( s_lock.setValue( 1 ) != 0 )
+		{
+			threading::yield();
+		}
+
+		// other thread may intern this name while we were waiting
+		const Entry* entry = findEntry( name, length, hash );
+
+		if( !entry )
+		{
+			LowerCaseName lowerName( name, length );
+
+			if( lowerName.isLower() )
+			{
+				entry = allocateEntry( name, length, hash, nullptr );
+			}
+			else
+			{
+				const UInt32 lowerHash = hashName( lowerName.data(), length );
+				const Entry* caseless = findEntry( lowerName.data(), length, lowerHash );
+
+				if( !caseless )
+				{
+					caseless = allocateEntry( lowerName.data(), length, lowerHash, nullptr );
+				}
+
+				entry = allocateEntry( name, length, hash, caseless );
+			}
+		}
+
+		s_lock.setValue( 0 );
+		return entry;
+	}
+
+	const NameId::Entry* NameId::allocateEntry( const Char* name, SizeT length, UInt32 hash, const Entry* caseless )
+	{
+		const SizeT entrySize = alignValue( sizeof( Entry ) + ( length + 1 ) * sizeof( Char ), sizeof( void* ) );
+
+		if( s_blockCursor + entrySize > s_blockEnd )
+		{
+			// names are never released
+			const SizeT blockSize = max( BLOCK_SIZE, entrySize );
+
+			mem::enterKnownMemLeaksZone();
+			s_blockCursor = reinterpret_cast<UInt8*>( mem::malloc( blockSize ) );
+			mem::leaveKnownMemLeaksZone();
+
+			s_blockEnd = s_blockCursor + blockSize;
+		}
+
+		Entry* entry = reinterpret_cast<Entry*>( s_blockCursor );
+		s_blockCursor += entrySize;
+
+		entry->caseless = caseless ? caseless : entry;
+		entry->hash = hash;
+		entry->length = static_cast<UInt32>( length );
+		mem::copy( entry->data, name, length * sizeof( Char ) );
+		entry->data[length] = TXT('\0');
+
+		const UInt32 bucket = hash & ( HASH_SIZE - 1 );
+		entry->next = s_buckets[bucket];
+		s_buckets[bucket] = entry;
+
+		s_count++;
+		return entry;
+	}
+
+} // namespace flu
@@ -0,0 +1,124 @@
+//-----------------------------------------------------------------------------
+//	Name.h: An interned names
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+	/**
+	 *	An interned name. Each unique string is stored once in the global
+	 *	names table, so names comparison is a pointer comparison and hash
+	 *	is precomputed. Names are never released. Zero filled memory is a
+	 *	valid none name
+	 */
+	class NameId
+	{
+	public:
+		NameId()
+			:	m_entry( nullptr )
+		{
+		}
+
+		explicit NameId( const Char* name );
+		explicit NameId( const Char* name, SizeT length );
+		explicit NameId( const String& name );
+
+		/**
+		 *	Return an already interned name or none name, this
+		 *	function never adds a new name to the table
+		 */
+		static NameId find( const Char* name );
+		static NameId find( const Char* name, SizeT length );
+
+		/**
+		 *	Return an interned lower case name or none name
+		 */
+		static NameId findInsensitive( const Char* name );
+
+		/**
+		 *	Return total number of interned names
+		 */
+		static UInt32 count();
+
+		Bool operator==( const NameId& other ) const
+		{
+			return m_entry == other.m_entry;
+		}
+
+		Bool operator!=( const NameId& other ) const
+		{
+			return m_entry != other.m_entry;
+		}
+
+		Bool equalsInsensitive( const NameId& other ) const
+		{
+			return m_entry == other.m_entry || 
+				( m_entry && other.m_entry && m_entry->caseless == other.m_entry->caseless );
+		}
+
+		NameId caseless() const
+		{
+			NameId result;
+			result.m_entry = m_entry ? m_entry->caseless : nullptr;
+			return result;
+		}
+
+		Bool isNone() const
+		{
+			return m_entry == nullptr;
+		}
+
+		operator Bool() const
+		{
+			return m_entry != nullptr;
+		}
+
+		UInt32 hashCode() const
+		{
+			return m_entry ? m_entry->hash : 0;
+		}
+
+		SizeT len() const
+		{
+			return m_entry ? m_entry->length : 0;
+		}
+
+		const Char* operator*() const
+		{
+			return m_entry ? m_entry->data : TXT("");
+		}
+
+		String toString() const
+		{
+			return m_entry ? String( m_entry->data, m_entry->length ) : String();
+		}
+
+	private:
+#pragma warning( disable : 4200 )
+		struct Entry
+		{
+			const Entry* next;
+			const Entry* caseless;
+			UInt32 hash;
+			UInt32 length;
+			Char data[0];
+		};
+
+		static const UInt32 HASH_SIZE = 16384;
+		static const SizeT BLOCK_SIZE = 64 * 1024;
+
+		static const Entry* volatile s_buckets[HASH_SIZE];
+		static concurrency::Atomic s_lock;
+		static UInt8* s_blockCursor;
+		static UInt8* s_blockEnd;
+		static UInt32 s_count;
+
+		const Entry* m_entry;
+
+		static const Entry* findEntry( const Char* name, SizeT length, UInt32 hash );
+		static const Entry* internEntry( const Char* name, SizeT length );
+		static const Entry* allocateEntry( const Char* name, SizeT length, UInt32 hash, const Entry* caseless );
+		static UInt32 hashName( const Char* name, SizeT length );
+	};
+
+} // namespace flu
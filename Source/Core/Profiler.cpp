@@ -31,7 +31,7 @@ namespace profile
 		{
 		}
 
-		void enterZone( EGroup group, const Char* zoneName ) override
+		void enterZone( ZoneId zoneId ) override
 		{
 		}
 
@@ -39,7 +39,7 @@ namespace profile
 		{
 		}
 
-		void updateCounter( EGroup group, const Char* counterName, Double value ) override
+		void updateCounter( ZoneId counterId, Double value ) override
 		{
 		}
 	};
@@ -68,6 +68,84 @@ namespace profile
 		return g_activeProfiler == &g_nullProfiler;
 	}
 
+	/**
+	 *	Zones registry
+	 */
+	static const UInt32 MAX_ZONES = 1024;
+	static const SizeT ZONE_NAMES_POOL_SIZE = 32 * 1024;
+
+	struct ZoneInfo
+	{
+		EGroup group;
+		const Char* name;
+	};
+
+	static ZoneInfo g_zones[MAX_ZONES];
+	static concurrency::Atomic g_numZones;
+
+	// names may be built at runtime, so registry keeps own copies
+	static Char g_zoneNames[ZONE_NAMES_POOL_SIZE];
+	static SizeT g_zoneNamesUsed = 0;
+	static concurrency::Atomic g_zonesLock;
+
+	ZoneId internZone( EGroup group, const Char* zoneName )
+	{
+		assert( zoneName );
+
+		// interning happens once per call site, so spinning is fine here
+		while( g_zonesLock.setValue( 1 ) != 0 )
+		{
+			threading::yield();
+		}
+
+		const UInt32 numZones = g_numZones.getValue();
+		ZoneId result = INVALID_ZONE_ID;
+
+		for( UInt32 i = 0; i < numZones; ++i )
+		{
+			if( g_zones[i].group == group && cstr::compare( g_zones[i].name, zoneName ) == 0 )
+			{
+				result = i;
+				break;
+			}
+		}
+
+		const SizeT nameSize = cstr::length( zoneName ) + 1;
+
+		// when registry is full, zone is just not tracked
+		if( result == INVALID_ZONE_ID && numZones < MAX_ZONES && 
+			g_zoneNamesUsed + nameSize <= ZONE_NAMES_POOL_SIZE )
+		{
+			Char* name = &g_zoneNames[g_zoneNamesUsed];
+			mem::copy( name, zoneName, nameSize * sizeof( Char ) );
+			g_zoneNamesUsed += nameSize;
+
+			g_zones[numZones].group = group;
+			g_zones[numZones].name = name;
+
+			result = numZones;
+			g_numZones.increment();
+		}
+
+		g_zonesLock.setValue( 0 );
+		return result;
+	}
+
+	EGroup getZoneGroup( ZoneId zoneId )
+	{
+		return zoneId < getZonesCount() ? g_zones[zoneId].group : EGroup::MAX;
+	}
+
+	const Char* getZoneName( ZoneId zoneId )
+	{
+		return zoneId < getZonesCount() ? g_zones[zoneId].name : TXT("Unknown");
+	}
+
+	UInt32 getZonesCount()
+	{
+		return g_numZones.getValue();
+	}
+
 	const Char* getGroupName( EGroup group )
 	{
 		switch( group )
@@ -79,6 +157,7 @@ namespace profile
 			case EGroup::GPU_Memory:	return TXT("GPU Memory");
 			case EGroup::Draw_Calls:	return TXT("Draw Calls");
 			case EGroup::Render:		return TXT("Render");
+			case EGroup::Script:		return TXT("Script");
 			default:					return TXT("Unknown");
 		}
 	}
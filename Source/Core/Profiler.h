@@ -19,9 +19,22 @@ namespace profile
 		GPU_Memory,
 		Draw_Calls,
 		Render, // todo: clarify metric
+		Script,
 		MAX
 	};
 
+	/**
+	 *	An interned zone or counter id
+	 */
+	using ZoneId = UInt32;
+	static const ZoneId INVALID_ZONE_ID = -1;
+
+	/**
+	 *	Initial id for zones interned lazily. Failed interning gives INVALID_ZONE_ID,
+	 *	which is cached as well, so a full registry is not locked over and over
+	 */
+	static const ZoneId UNINTERNED_ZONE_ID = -2;
+
 	/**
 	 *	An abstraact profiler interface
 	 */
@@ -44,12 +57,19 @@ namespace profile
 		virtual void beginFrame() = 0;
 		virtual void endFrame() = 0;
 
-		virtual void enterZone( EGroup group, const Char* zoneName ) = 0;
+		virtual void enterZone( ZoneId zoneId ) = 0;
 		virtual void leaveZone() = 0;
 
-		virtual void updateCounter( EGroup group, const Char* counterName, Double value ) = 0;
+		virtual void updateCounter( ZoneId counterId, Double value ) = 0;
 	};
 
+	// zones registry, zones are interned once and never released, name is copied.
+	// INVALID_ZONE_ID is returned when registry is full, profilers should skip such zones
+	extern ZoneId internZone( EGroup group, const Char* zoneName );
+	extern EGroup getZoneGroup( ZoneId zoneId );
+	extern const Char* getZoneName( ZoneId zoneId );
+	extern UInt32 getZonesCount();
+
 	// global accessors
 	extern IProfiler* getProfiler();
 	extern void setProfiler( IProfiler* newProfiler );
@@ -62,9 +82,9 @@ namespace profile
 	class ZoneTracker final
 	{
 	public:
-		ZoneTracker( EGroup group, const Char* zoneName )
+		ZoneTracker( ZoneId zoneId )
 		{
-			getProfiler()->enterZone( group, zoneName );
+			getProfiler()->enterZone( zoneId );
 		}
 
 		~ZoneTracker()
@@ -83,11 +103,13 @@ namespace profile
   */
 #if FLU_ENABLE_PROFILER
 
-	#define profile_zone( group, zoneName ) flu::profile::ZoneTracker zoneTracker( \
-		flu::profile::EGroup::##group, L#zoneName );
+	#define profile_zone( group, zoneName ) static const flu::profile::ZoneId zoneId_##zoneName = \
+		flu::profile::internZone( flu::profile::EGroup::##group, L#zoneName ); \
+		flu::profile::ZoneTracker zoneTracker( zoneId_##zoneName );
 
-	#define profile_counter( group, counterName, value ) flu::profile::getProfiler()->updateCounter( \
-		flu::profile::EGroup::##group, L#counterName, value );
+	#define profile_counter( group, counterName, value ) { static const flu::profile::ZoneId counterId = \
+		flu::profile::internZone( flu::profile::EGroup::##group, L#counterName ); \
+		flu::profile::getProfiler()->updateCounter( counterId, value ); }
 
 	#define profile_begin_frame() flu::profile::getProfiler()->beginFrame();
 
@@ -6,148 +6,161 @@
 namespace flu
 {
 	/**
-	 *	An universal string template
+	 *	An universal string template. Short strings are stored inline
+	 *	and never allocate, longer ones are shared with the manager's
+	 *	reference counted data. String is position independent and zero
+	 *	filled memory is a valid empty string, so arrays may move strings
+	 *	bitwise
 	 */
 	template<typename MANAGER_TYPE, MANAGER_TYPE& MANAGER> class StringBase
 	{
 	public:
 		using CHAR_TYPE = typename MANAGER_TYPE::CHAR_TYPE;
 
+		static const SizeT INLINE_CAPACITY = 24 / sizeof(CHAR_TYPE) - 1;
+
 		StringBase()
-			:	m_data( nullptr )
+			:	m_data( nullptr ),
+				m_inlineLength( 0 )
 		{
 		}
 
 		StringBase( StringBase<MANAGER_TYPE, MANAGER>&& other )
 		{
-			m_data = other.m_data;
+			mem::copy( this, &other, sizeof(StringBase<MANAGER_TYPE, MANAGER>) );
 			other.m_data = nullptr;
+			other.m_inlineLength = 0;
 		}
 
 		StringBase( const StringBase<MANAGER_TYPE, MANAGER>& other )
-			:	m_data( other.m_data )
+			:	m_data( nullptr ),
+				m_inlineLength( 0 )
 		{
-			if( m_data )
-			{
-				m_data->refsCount++;
-			}
+			assign( other );
 		}
 
 		StringBase( const CHAR_TYPE* other )
-			:	m_data( nullptr )
+			:	m_data( nullptr ),
+				m_inlineLength( 0 )
 		{
 			if( other && *other )
 			{
 				SizeT realLength = cstr::length( other );
-				MANAGER.initializeString( m_data, realLength );
-				mem::copy( m_data->data, other, realLength * sizeof(CHAR_TYPE) );
+				mem::copy( allocate( realLength ), other, realLength * sizeof(CHAR_TYPE) );
 			}
 		}
 
 		StringBase( const CHAR_TYPE* other, SizeT length )
-			:	m_data( nullptr )
+			:	m_data( nullptr ),
+				m_inlineLength( 0 )
 		{
 			if( other && *other && length > 0 )
 			{
-				MANAGER.initializeString( m_data, length );
-				mem::copy( m_data->data, other, length * sizeof(CHAR_TYPE) );
+				mem::copy( allocate( length ), other, length * sizeof(CHAR_TYPE) );
 			}
 		}
 
 		StringBase( const CHAR_TYPE* firstSymbol, const CHAR_TYPE* lastSymbol )
-			:	m_data( nullptr )
+			:	m_data( nullptr ),
+				m_inlineLength( 0 )
 		{
 			if( firstSymbol && lastSymbol && *firstSymbol && *lastSymbol && 
 				lastSymbol > firstSymbol )
 			{
 				SizeT length = ( reinterpret_cast<SizeT>( lastSymbol ) - reinterpret_cast<SizeT>( firstSymbol ) ) / sizeof(CHAR_TYPE);
-				MANAGER.initializeString( m_data, length );
-				mem::copy( m_data->data, firstSymbol, length * sizeof(CHAR_TYPE) );
+				mem::copy( allocate( length ), firstSymbol, length * sizeof(CHAR_TYPE) );
 			}
 		}
 
 		~StringBase()
 		{
-			MANAGER.deinitializeString( m_data );
+			release();
 		}
 
 		SizeT len() const
 		{
-			return m_data ? m_data->length : 0;
+			return m_inlineLength ? m_inlineLength : m_data ? m_data->length : 0;
 		}
 
 		UInt32 refsCount() const
 		{
-			return m_data ? m_data->refsCount : 0;
+			return m_inlineLength ? 1 : m_data ? m_data->refsCount.getValue() : 0;
+		}
+
+		Bool isInline() const
+		{
+			return m_inlineLength != 0;
 		}
 
 		UInt32 hashCode() const
 		{
 			UInt32 hash = 2139062143;
 
-			if( m_data )
-			{
-				for( CHAR_TYPE* c = m_data->data; *c; c++ )
-					hash = 37 * hash + *c;
-			}
+			for( const CHAR_TYPE* c = chars(); *c; c++ )
+				hash = 37 * hash + *c;
 
 			return hash;
 		}
 
 		CHAR_TYPE* operator*() const
 		{
-			static const CHAR_TYPE EMPTY_STRING = CHAR_TYPE(0);
-			return m_data ? m_data->data : const_cast<CHAR_TYPE*>( &EMPTY_STRING );
+			return chars();
 		}
 
 		StringBase<MANAGER_TYPE, MANAGER>& operator=( const StringBase<MANAGER_TYPE, MANAGER>& other )
 		{
-			MANAGER.deinitializeString( m_data );
-
-			if( other.m_data )
+			if( this != &other )
 			{
-				m_data = other.m_data;
-				m_data->refsCount++;
+				release();
+				assign( other );
 			}
 
 			return *this;
 		}
 
-		StringBase<MANAGER_TYPE, MANAGER>& operator=( const CHAR_TYPE* other )
+		StringBase<MANAGER_TYPE, MANAGER>& operator=( StringBase<MANAGER_TYPE, MANAGER>&& other )
 		{
-			MANAGER.deinitializeString( m_data );
-			SizeT realLength = cstr::length( other );
-
-			if( realLength )
+			if( this != &other )
 			{
-				MANAGER.initializeString( m_data, realLength );
-				mem::copy( m_data->data, other, realLength * sizeof(CHAR_TYPE) );
+				release();
+				mem::copy( this, &other, sizeof(StringBase<MANAGER_TYPE, MANAGER>) );
+				other.m_data = nullptr;
+				other.m_inlineLength = 0;
 			}
 
 			return *this;
 		}
 
+		StringBase<MANAGER_TYPE, MANAGER>& operator=( const CHAR_TYPE* other )
+		{
+			// source may point to our own buffer
+			return *this = StringBase<MANAGER_TYPE, MANAGER>( other );
+		}
+
 		CHAR_TYPE operator()( SizeT i ) const
 		{
-			return m_data ? m_data->data[i] : 0;
+			return chars()[i];
 		}
 
 		const CHAR_TYPE& operator[]( SizeT i ) const
 		{
-			static CHAR_TYPE tmp = 0;
-			return m_data ? m_data->data[i] : tmp;
+			return chars()[i];
 		}
 
 		CHAR_TYPE& operator[]( SizeT i )
 		{
-			if( m_data )
+			if( m_inlineLength )
 			{
-				if( m_data->refsCount > 1 )
+				return m_inline[i];
+			}
+			else if( m_data )
+			{
+				if( m_data->refsCount.getValue() > 1 )
 				{
 					StringData* indirect = nullptr;
 					MANAGER.initializeString( indirect, m_data->length );
 					mem::copy( indirect->data, m_data->data, m_data->length * sizeof(CHAR_TYPE) );
-					m_data->refsCount--;
+					MANAGER.deinitializeString( m_data );
 					m_data = indirect;
 				}
 
@@ -162,40 +175,35 @@ namespace flu
 
 		Bool operator==( const StringBase<MANAGER_TYPE, MANAGER>& other ) const
 		{
-			if( m_data != other.m_data )
+			if( !m_inlineLength && m_data == other.m_data && !other.m_inlineLength )
 			{
-				if( !other.m_data ) return m_data == nullptr;
-				if( !m_data ) return other.m_data == nullptr;
+				return true;
+			}
 
-				SizeT len1 = m_data->length;
-				SizeT len2 = other.m_data->length;
+			SizeT len1 = len();
+			SizeT len2 = other.len();
 
-				if( len1 == len2 )
-				{
-					return cstr::compare( m_data->data, other.m_data->data ) == 0;
-				}
-				else
-				{
-					return false;
-				}
+			if( len1 == len2 )
+			{
+				return len1 == 0 || cstr::compare( chars(), other.chars() ) == 0;
 			}
 			else
 			{
-				return true;
+				return false;
 			}
 		}
 
 		Bool operator==( const CHAR_TYPE* other ) const
 		{
-			if( !other || !*other ) return m_data == nullptr;
-			if( !m_data ) return false;
+			if( !other || !*other ) return isEmpty();
+			if( isEmpty() ) return false;
 
-			SizeT len1 = m_data->length;
+			SizeT len1 = len();
 			SizeT len2 = cstr::length( other );
 
 			if( len1 == len2 )
 			{
-				return cstr::compare( m_data->data, other ) == 0;
+				return cstr::compare( chars(), other ) == 0;
 			}
 			else
 			{
@@ -215,60 +223,39 @@ namespace flu
 
 		Bool operator>( const StringBase<MANAGER_TYPE, MANAGER>& other ) const
 		{
-			return m_data && other.m_data ? cstr::compare( m_data->data, other.m_data->data ) > 0 : m_data != other.m_data;
+			return !isEmpty() && !other.isEmpty() ? cstr::compare( chars(), other.chars() ) > 0 : isEmpty() != other.isEmpty();
 		}
 
 		Bool operator<( const StringBase<MANAGER_TYPE, MANAGER>& other ) const
 		{
-			return m_data && other.m_data ? cstr::compare( m_data->data, other.m_data->data ) < 0 : m_data != other.m_data;
+			return !isEmpty() && !other.isEmpty() ? cstr::compare( chars(), other.chars() ) < 0 : isEmpty() != other.isEmpty();
 		}
 
 		Bool operator>=( const StringBase<MANAGER_TYPE, MANAGER>& other ) const
 		{
-			return m_data && other.m_data ? cstr::compare( m_data->data, other.m_data->data ) >= 0 : m_data == other.m_data;
+			return !isEmpty() && !other.isEmpty() ? cstr::compare( chars(), other.chars() ) >= 0 : isEmpty() == other.isEmpty();
 		}
 
 		Bool operator<=( const StringBase<MANAGER_TYPE, MANAGER>& other ) const
 		{
-			return m_data && other.m_data ? cstr::compare( m_data->data, other.m_data->data ) <= 0 : m_data == other.m_data;
+			return !isEmpty() && !other.isEmpty() ? cstr::compare( chars(), other.chars() ) <= 0 : isEmpty() == other.isEmpty();
 		}
 
 		StringBase<MANAGER_TYPE, MANAGER>& operator+=( const CHAR_TYPE* other )
 		{
-			if( SizeT len2 = cstr::length( other ) )
-			{
-				if( m_data )
-				{
-					SizeT len1 = m_data->length;
-					SizeT resultLen = len1 + len2;
-					MANAGER.reinitializeString( m_data, resultLen );
-					mem::copy( &m_data->data[len1], other, len2 * sizeof(CHAR_TYPE) );
-				}
-				else
-				{
-					*this = other;
-				}
-
-			}
-
+			append( other, cstr::length( other ) );
 			return *this;
 		}
 
 		StringBase<MANAGER_TYPE, MANAGER>& operator+=( const StringBase<MANAGER_TYPE, MANAGER>& other )
 		{
-			if( SizeT len2 = other.len() )
+			if( isEmpty() )
 			{
-				if( m_data )
-				{
-					SizeT len1 = m_data->length;
-					SizeT resultLen = len1 + len2;
-					MANAGER.reinitializeString( m_data, resultLen );
-					mem::copy( &m_data->data[len1], other.m_data->data, len2 * sizeof(CHAR_TYPE) );
-				}
-				else
-				{
-					*this = other;
-				}
+				*this = other;
+			}
+			else
+			{
+				append( other.chars(), other.len() );
 			}
 
 			return *this;
@@ -286,7 +273,7 @@ namespace flu
 
 		operator Bool() const
 		{
-			return m_data != nullptr;
+			return !isEmpty();
 		}
 
 		template<typename INT_TYPE> Bool toInteger( INT_TYPE& value, INT_TYPE _default = 0 ) const
@@ -301,12 +288,12 @@ namespace flu
 			Bool isNegative = false;
 			value = _default;
 
-			if( m_data->data[0] == '-' )
+			if( chars()[0] == '-' )
 			{
 				++charId;
 				isNegative = true;
 			}
-			else if( m_data->data[0] == '+' )
+			else if( chars()[0] == '+' )
 			{
 				++charId;
 				isNegative = false;
@@ -315,10 +302,10 @@ namespace flu
 			INT_TYPE result = 0;
 			for( SizeT i = charId; i < len(); ++i )
 			{
-				if( cstr::isDigit( m_data->data[i] ) )
+				if( cstr::isDigit( chars()[i] ) )
 				{
 					result *= 10;
-					result += static_cast< INT_TYPE >( m_data->data[i] - '0' );
+					result += static_cast< INT_TYPE >( chars()[i] - '0' );
 				}
 				else
 				{
@@ -344,12 +331,12 @@ namespace flu
 			Float ceilPart = 0.f;
 			value = _default;
 
-			if( m_data->data[0] == '-' )
+			if( chars()[0] == '-' )
 			{
 				charId++;
 				isNegative = true;
 			}
-			else if( m_data->data[0] == '+' )
+			else if( chars()[0] == '+' )
 			{
 				charId++;
 				isNegative = false;
@@ -357,7 +344,7 @@ namespace flu
 
 			if( charId < len() )
 			{
-				if( m_data->data[charId] == '.' )
+				if( chars()[charId] == '.' )
 				{
 				ParseFrac:
 					charId++;
@@ -365,9 +352,9 @@ namespace flu
 
 					for( ; charId < len(); ++charId )
 					{
-						if( cstr::isDigit( m_data->data[charId] ) )
+						if( cstr::isDigit( chars()[charId] ) )
 						{
-							fracPart += static_cast<Int32>( m_data->data[charId] - '0' ) * m;
+							fracPart += static_cast<Int32>( chars()[charId] - '0' ) * m;
 							m /= 10.f;
 						}
 						else
@@ -376,16 +363,16 @@ namespace flu
 						}
 					}
 				}
-				else if( cstr::isDigit( m_data->data[charId] ) )
+				else if( cstr::isDigit( chars()[charId] ) )
 				{
 					for( ; charId < len(); ++charId )
 					{
-						if( cstr::isDigit( m_data->data[charId] ) )
+						if( cstr::isDigit( chars()[charId] ) )
 						{
 							ceilPart *= 10.f;
-							ceilPart += static_cast<Int32>( m_data->data[charId] - '0' );
+							ceilPart += static_cast<Int32>( chars()[charId] - '0' );
 						}
-						else if( m_data->data[charId] == '.' )
+						else if( chars()[charId] == '.' )
 						{
 							goto ParseFrac;
 						}
@@ -474,11 +461,11 @@ namespace flu
 			if( string )
 			{
 				StringBase<MANAGER_TYPE, MANAGER> newString;
-				MANAGER.initializeString( newString.m_data, string.m_data->length );
+				CHAR_TYPE* dest = newString.allocate( string.len() );
 
-				for( SizeT i = 0; i < newString.m_data->length; ++i )
+				for( SizeT i = 0; i < string.len(); ++i )
 				{
-					newString.m_data->data[i] = cstr::toUpper( string.m_data->data[i] );
+					dest[i] = cstr::toUpper( string(i) );
 				}
 
 				return newString;
@@ -494,11 +481,11 @@ namespace flu
 			if( string )
 			{
 				StringBase<MANAGER_TYPE, MANAGER> newString;
-				MANAGER.initializeString( newString.m_data, string.m_data->length );
+				CHAR_TYPE* dest = newString.allocate( string.len() );
 
-				for( SizeT i = 0; i < newString.m_data->length; ++i )
+				for( SizeT i = 0; i < string.len(); ++i )
 				{
-					newString.m_data->data[i] = cstr::toLower( string.m_data->data[i] );
+					dest[i] = cstr::toLower( string(i) );
 				}
 
 				return newString;
@@ -514,11 +501,11 @@ namespace flu
 			if( count )
 			{
 				StringBase<MANAGER_TYPE, MANAGER> newString;
-				MANAGER.initializeString( newString.m_data, count );
+				CHAR_TYPE* dest = newString.allocate( count );
 
 				for( SizeT i = 0; i < count; ++i )
 				{
-					newString.m_data->data[i] = repeat;
+					dest[i] = repeat;
 				}
 
 				return newString;
@@ -551,7 +538,7 @@ namespace flu
 
 			if( count )
 			{
-				return StringBase<MANAGER_TYPE, MANAGER>( &source.m_data->data[startChar], count );
+				return StringBase<MANAGER_TYPE, MANAGER>( source.chars() + startChar, count );
 			}
 			else
 			{
@@ -624,14 +611,12 @@ namespace flu
 
 			if( length > 0 )
 			{
-				MANAGER.deinitializeString( x.m_data );
-				MANAGER.initializeString( x.m_data, length );
+				x.allocate( length );
 				stream.readData( *x, sizeof( CHAR_TYPE ) * length );
 			}
 			else
 			{
-				MANAGER.deinitializeString( x.m_data );
-				MANAGER.initializeString( x.m_data, -length );
+				x.allocate( -length );
 
 				for( SizeT i = 0; i < x.len(); ++i )
 				{
@@ -654,14 +639,12 @@ namespace flu
 
 				if( length > 0 )
 				{
-					MANAGER.deinitializeString( v.m_data );
-					MANAGER.initializeString( v.m_data, length );
+					v.allocate( length );
 					s.SerializeData( *v, sizeof(CHAR_TYPE) * length );
 				}
 				else if( length < 0 )
 				{
-					MANAGER.deinitializeString( v.m_data );
-					MANAGER.initializeString( v.m_data, -length );
+					v.allocate( -length );
 
 					for( SizeT i = 0; i < v.len(); ++i )
 					{
@@ -709,10 +692,134 @@ namespace flu
 			}
 		}
 
+		Bool isEmpty() const
+		{
+			return !m_inlineLength && !m_data;
+		}
+
 	protected:
 		using StringData = typename MANAGER_TYPE::StringData;
 
-		StringData* m_data;
+		union
+		{
+			StringData* m_data;
+			CHAR_TYPE m_inline[INLINE_CAPACITY + 1];
+		};
+
+		UInt8 m_inlineLength;
+
+		CHAR_TYPE* chars() const
+		{
+			static const CHAR_TYPE EMPTY_STRING = CHAR_TYPE(0);
+
+			if( m_inlineLength )
+			{
+				return const_cast<CHAR_TYPE*>( m_inline );
+			}
+			else
+			{
+				return m_data ? m_data->data : const_cast<CHAR_TYPE*>( &EMPTY_STRING );
+			}
+		}
+
+		/**
+		 *	Release current string and allocate a new one, return
+		 *	pointer to the uninitialized, but terminated characters
+		 */
+		CHAR_TYPE* allocate( SizeT length )
+		{
+			release();
+
+			if( length == 0 )
+			{
+				return chars();
+			}
+			else if( length <= INLINE_CAPACITY )
+			{
+				m_inlineLength = static_cast<UInt8>( length );
+				m_inline[length] = 0;
+				return m_inline;
+			}
+			else
+			{
+				MANAGER.initializeString( m_data, length );
+				return m_data->data;
+			}
+		}
+
+		void release()
+		{
+			if( m_inlineLength )
+			{
+				m_inlineLength = 0;
+				m_data = nullptr;
+			}
+			else
+			{
+				MANAGER.deinitializeString( m_data );
+			}
+		}
+
+		void assign( const StringBase<MANAGER_TYPE, MANAGER>& other )
+		{
+			assert( isEmpty() );
+
+			if( other.m_inlineLength )
+			{
+				mem::copy( m_inline, other.m_inline, sizeof(m_inline) );
+				m_inlineLength = other.m_inlineLength;
+			}
+			else if( other.m_data )
+			{
+				m_data = other.m_data;
+				MANAGER.addRef( m_data );
+			}
+		}
+
+		void append( const CHAR_TYPE* other, SizeT len2 )
+		{
+			if( len2 == 0 )
+			{
+				return;
+			}
+
+			const SizeT len1 = len();
+			const CHAR_TYPE* buffer = chars();
+
+			if( other >= buffer && other <= buffer + len1 )
+			{
+				// appending own characters
+				StringBase<MANAGER_TYPE, MANAGER> tmp( other, len2 );
+				append( *tmp, tmp.len() );
+				return;
+			}
+
+			const SizeT resultLen = len1 + len2;
+
+			if( resultLen <= INLINE_CAPACITY )
+			{
+				// still fits
+				mem::copy( &m_inline[len1], other, len2 * sizeof(CHAR_TYPE) );
+				m_inline[resultLen] = 0;
+				m_inlineLength = static_cast<UInt8>( resultLen );
+			}
+			else if( m_inlineLength )
+			{
+				// move from inline storage to the heap
+				StringData* newData = nullptr;
+				MANAGER.initializeString( newData, resultLen );
+				mem::copy( newData->data, m_inline, len1 * sizeof(CHAR_TYPE) );
+				mem::copy( &newData->data[len1], other, len2 * sizeof(CHAR_TYPE) );
+
+				m_inlineLength = 0;
+				m_data = newData;
+			}
+			else
+			{
+				MANAGER.reinitializeString( m_data, resultLen );
+				mem::copy( &m_data->data[len1], other, len2 * sizeof(CHAR_TYPE) );
+			}
+		}
 	};
 
 #if 0
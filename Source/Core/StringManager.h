@@ -6,7 +6,9 @@
 namespace flu
 {
 	/**
-	 *	An universal string manager template
+	 *	An universal string manager template. Strings data is shared between
+	 *	threads with atomic references counter, released data is cached in the
+	 *	caller thread's pool, so threads never contend for the pool
 	 */
 	template<typename T> class StringManager final
 	{
@@ -16,35 +18,30 @@ namespace flu
 #pragma warning( disable : 4200 )
 		struct StringData
 		{
-			union
-			{
-				struct{ SizeT length; UInt32 refsCount; };
-				struct{ StringData* nextInPool; };
-			};
+			SizeT length;
+			SizeT capacity;
+			concurrency::Atomic refsCount;
+			StringData* nextInPool;
 			CHAR_TYPE data[0];
 		};
 
+		/**
+		 *	A thread's strings statistics
+		 */
+		struct Stats
+		{
+			UInt32 heapAllocations;
+			UInt32 heapReleases;
+			UInt32 poolReuses;
+		};
+
 		StringManager()
 		{
-			mem::zero( m_reusePool, sizeof(m_reusePool) );
-			m_reusePoolLock = concurrency::SpinLock::create();
 		}
 
 		~StringManager()
 		{
-			for( SizeT i = 0; i < REUSE_POOL_SIZE; ++i )
-			{
-				StringData* stringData = m_reusePool[i];
-
-				while( stringData != nullptr )
-				{
-					 StringData* tmp = stringData;
-					 stringData = stringData->nextInPool;
-					 mem::free( tmp );
-				}
-			}
-
-			mem::zero( m_reusePool, sizeof(m_reusePool) );
+			cleanupPool( false );
 		}
 
 		void initializeString( StringData*& data, SizeT requiredLength )
@@ -54,44 +51,54 @@ namespace flu
 				deinitializeString( data );
 			}
 
-			concurrency::SpinLock::Guard slg( m_reusePoolLock );
+			ThreadPool& pool = s_threadPool;
+			const Int32 bucket = getBucket( requiredLength );
 
-			if( requiredLength < REUSE_POOL_SIZE && m_reusePool[requiredLength] )
+			if( bucket != -1 && pool.buckets[bucket] )
 			{
-				data = m_reusePool[requiredLength];
-				m_reusePool[requiredLength] = data->nextInPool;
+				data = pool.buckets[bucket];
+				pool.buckets[bucket] = data->nextInPool;
+				pool.depth[bucket]--;
+				pool.stats.poolReuses++;
 			}
 			else
 			{
-				data = reinterpret_cast<StringData*>( 
-					mem::malloc( sizeof(StringData) + sizeof(CHAR_TYPE) * ( requiredLength + 1 ) ) );
-				data->data[requiredLength] = 0;
+				const SizeT capacity = bucket != -1 ? getBucketCapacity( bucket ) : requiredLength;
+
+				data = reinterpret_cast<StringData*>(
+					mem::malloc( sizeof(StringData) + sizeof(CHAR_TYPE) * ( capacity + 1 ) ) );
+
+				data->capacity = capacity;
+				pool.stats.heapAllocations++;
 			}
-			
+
 			data->length = requiredLength;
-			data->refsCount = 1;
+			data->data[requiredLength] = 0;
+			data->refsCount.setValue( 1 );
 		}
 
 		void deinitializeString( StringData*& data )
 		{
 			if( data )
 			{
-				if( --data->refsCount == 0 )
+				if( data->refsCount.decrement() == 0 )
 				{
-					if( data->length < REUSE_POOL_SIZE )
-					{
-						concurrency::SpinLock::Guard slg( m_reusePoolLock );
+					ThreadPool& pool = s_threadPool;
+					const Int32 bucket = getBucket( data->capacity );
 
-						SizeT len = data->length;
-						data->nextInPool = m_reusePool[len];
-						m_reusePool[len] = data;
+					if( bucket != -1 && pool.depth[bucket] < MAX_POOL_DEPTH )
+					{
+						data->nextInPool = pool.buckets[bucket];
+						pool.buckets[bucket] = data;
+						pool.depth[bucket]++;
 					}
 					else
 					{
 						mem::free( data );
+						pool.stats.heapReleases++;
 					}
 				}
-			
+
 				data = nullptr;
 			}
 		}
@@ -102,13 +109,21 @@ namespace flu
 			{
 				if( data )
 				{
-					StringData* newData = nullptr;
-					initializeString( newData, newLength );
-					SizeT minLength = min( newData->length, data->length );
-					mem::copy( newData->data, data->data, minLength * sizeof(CHAR_TYPE) );
-					newData->data[minLength] = 0;
-					deinitializeString( data );
-					data = newData;
+					if( data->refsCount.getValue() == 1 && data->capacity >= newLength )
+					{
+						// we are the only owner, so resize in place
+						data->length = newLength;
+						data->data[newLength] = 0;
+					}
+					else
+					{
+						StringData* newData = nullptr;
+						initializeString( newData, newLength );
+						SizeT minLength = min( newData->length, data->length );
+						mem::copy( newData->data, data->data, minLength * sizeof(CHAR_TYPE) );
+						deinitializeString( data );
+						data = newData;
+					}
 				}
 				else
 				{
@@ -121,23 +136,33 @@ namespace flu
 			}
 		}
 
+		void addRef( StringData* data )
+		{
+			assert( data );
+			data->refsCount.increment();
+		}
+
+		/**
+		 *	Release all cached strings of the caller thread. Should be
+		 *	called by any thread before exit
+		 */
 		void cleanupPool( Bool showInfo = true )
 		{
+			ThreadPool& pool = s_threadPool;
+
 			Int32 slotsInUse = 0;
 			Int32 maxDepth = 0;
-			Int32 totalLength = 0;
+			SizeT totalLength = 0;
 			Int32 totalStrings = 0;
 
-			concurrency::SpinLock::Guard slg( m_reusePoolLock );
-
-			for( SizeT i = 0; i < REUSE_POOL_SIZE; ++i )
+			for( Int32 i = 0; i < NUM_BUCKETS; ++i )
 			{
-				StringData* stringData = m_reusePool[i];
+				StringData* stringData = pool.buckets[i];
 
 				if( stringData )
 				{
-					Int32 depth = 0;
 					++slotsInUse;
+					maxDepth = max<Int32>( maxDepth, pool.depth[i] );
 
 					while( stringData != nullptr )
 					{
@@ -145,17 +170,12 @@ namespace flu
 						 stringData = stringData->nextInPool;
 						 mem::free( tmp );
 
-						 ++depth;
 						 ++totalStrings;
-						 totalLength += i;
-					}
-
-					if( depth > maxDepth )
-					{
-						maxDepth = depth;
+						 totalLength += getBucketCapacity( i );
 					}
 
-					m_reusePool[i] = nullptr;
+					pool.buckets[i] = nullptr;
+					pool.depth[i] = 0;
 				}
 			}
 
@@ -163,16 +183,56 @@ namespace flu
 			{
 				info( L"String ReusePool info: " );
 				info( L"  SlotsInUse: %d; MaxDepth: %d", slotsInUse, maxDepth );
-				info( L"  TotalStrings: %d; TotalLength: %d", totalStrings, totalLength );
+				info( L"  TotalStrings: %d; TotalLength: %d", totalStrings, static_cast<Int32>( totalLength ) );
+				info( L"  HeapAllocations: %d; HeapReleases: %d; PoolReuses: %d", pool.stats.heapAllocations,
+					pool.stats.heapReleases, pool.stats.poolReuses );
 			}
 		}
 
+		/**
+		 *	Return statistics of the caller thread
+		 */
+		const Stats& threadStats() const
+		{
+			return s_threadPool.stats;
+		}
+
 	private:
-		enum{ REUSE_POOL_SIZE = 8192 };
-		static_assert( isPowerOfTwo( REUSE_POOL_SIZE ), "Reuse pool size should be power of two" );
+		static const Int32 MIN_POOLED_CAPACITY = 32;
+		static const Int32 NUM_BUCKETS = 8;
+		static const UInt32 MAX_POOL_DEPTH = 256;
+
+		/**
+		 *	A per-thread pool, it's zero initialized, so no
+		 *	any thread-exit destruction order issues
+		 */
+		struct ThreadPool
+		{
+			StringData* buckets[NUM_BUCKETS];
+			UInt32 depth[NUM_BUCKETS];
+			Stats stats;
+		};
 
-		StringData* m_reusePool[REUSE_POOL_SIZE];
-		concurrency::SpinLock::UPtr m_reusePoolLock;
+		static thread_local ThreadPool s_threadPool;
+
+		static Int32 getBucket( SizeT length )
+		{
+			for( Int32 i = 0; i < NUM_BUCKETS; ++i )
+			{
+				if( length <= getBucketCapacity( i ) )
+				{
+					return i;
+				}
+			}
+
+			return -1;
+		}
+
+		static SizeT getBucketCapacity( Int32 bucket )
+		{
+			// null terminator is included into the power of two
+			return ( MIN_POOLED_CAPACITY << bucket ) - 1;
+		}
 
 		StringManager( StringManager<T>&& ) = delete;
 		StringManager( const StringManager<T>& ) = delete;
@@ -180,6 +240,8 @@ namespace flu
 		StringManager<T>& operator=( StringManager<T>&& ) = delete;
 	};
 
+	template<typename T> thread_local typename StringManager<T>::ThreadPool StringManager<T>::s_threadPool;
+
 	/**
 	 *	String managers
 	 */
@@ -188,4 +250,4 @@ namespace flu
 
 	extern AnsiStringManager g_ansiStringManager;
 	extern WideStringManager g_wideStringManager;
-}
\ No newline at end of file
+}
@@ -109,6 +109,11 @@ namespace threading
 		{
 			WinThread* thisThread = reinterpret_cast<WinThread*>( pThis );
 			thisThread->m_entryFunction( thisThread->m_args );
+
+			// release thread's cached strings
+			g_ansiStringManager.cleanupPool( false );
+			g_wideStringManager.cleanupPool( false );
+
 			return 0;		
 		}
 	};
@@ -140,6 +145,15 @@ namespace threading
 #endif
 	}
 
+	UInt32 getCurrentProcessId()
+	{
+#if FLU_PLATFORM_WINDOWS
+		return static_cast<UInt32>( GetCurrentProcessId() );
+#else
+#error threading::getCurrentProcessId is not implemented for current platform
+#endif
+	}
+
 	Bool isMainThread()
 	{
 #if FLU_PLATFORM_WINDOWS
@@ -58,6 +58,11 @@ namespace threading
 	 */
 	extern ThreadId getCurrentThreadId();
 
+	/**
+	 *	Return the id of the caller's process
+	 */
+	extern UInt32 getCurrentProcessId();
+
 	/**
 	 *	Return true, if caller's thread is main
 	 */
@@ -0,0 +1,301 @@
+//-----------------------------------------------------------------------------
+//	TraceProfiler.cpp: A multithreaded trace profiler implementation
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Core.h"
+
+namespace flu
+{
+namespace profile
+{
+	/**
+	 *	Each profiler instance gets an unique generation, so thread's
+	 *	cached buffer is never used with other profiler
+	 */
+	static concurrency::Atomic g_profilerGeneration;
+
+	struct ThreadBufferCache
+	{
+		Int32 generation = 0;
+		void* buffer = nullptr;
+	};
+
+	static thread_local ThreadBufferCache t_bufferCache;
+
+	TraceProfiler::TraceProfiler( UInt32 eventsPerThread )
+		:	m_eventsPerThread( eventsPerThread ),
+			m_numThreads( 0 ),
+			m_captureId( 0 ),
+			m_capturing( false ),
+			m_capturePending( false ),
+			m_captureStartTime( 0 ),
+			m_captureEndTime( 0 ),
+			m_capturedFrames( 0 ),
+			m_framesToCapture( 0 ),
+			m_generation( g_profilerGeneration.increment() )
+	{
+		assert( m_eventsPerThread > 0 && ( m_eventsPerThread & ( m_eventsPerThread - 1 ) ) == 0 );
+
+		mem::zero( m_threads, sizeof( m_threads ) );
+		m_frameZone = internZone( EGroup::Common, TXT("Frame") );
+	}
+
+	TraceProfiler::~TraceProfiler()
+	{
+		m_capturing = false;
+
+		for( UInt32 i = 0; i < MAX_THREADS; ++i )
+		{
+			if( m_threads[i] )
+			{
+				mem::free( m_threads[i]->events );
+				delete m_threads[i];
+			}
+		}
+	}
+
+	void TraceProfiler::beginFrame()
+	{
+		if( m_capturePending )
+		{
+			// buffers are reused by the each capture, but only owner thread
+			// may reset its buffer, it does so on the first event of new capture
+			m_captureId.increment();
+
+			m_captureStartTime = time::cycles64();
+			m_capturedFrames = 0;
+			m_capturePending = false;
+			m_capturing = true;
+		}
+
+		pushEvent( EEventType::Enter, m_frameZone, 0.0 );
+	}
+
+	void TraceProfiler::endFrame()
+	{
+		if( !m_capturing )
+			return;
+
+		pushEvent( EEventType::Leave, m_frameZone, 0.0 );
+		m_capturedFrames++;
+
+		if( m_framesToCapture != 0 && m_capturedFrames >= m_framesToCapture )
+		{
+			stopCapture();
+
+			if( m_captureFileName )
+			{
+				exportTrace( m_captureFileName );
+			}
+		}
+	}
+
+	void TraceProfiler::enterZone( ZoneId zoneId )
+	{
+		pushEvent( EEventType::Enter, zoneId, 0.0 );
+	}
+
+	void TraceProfiler::leaveZone()
+	{
+		pushEvent( EEventType::Leave, INVALID_ZONE_ID, 0.0 );
+	}
+
+	void TraceProfiler::updateCounter( ZoneId counterId, Double value )
+	{
+		if( counterId == INVALID_ZONE_ID )
+			return;
+
+		pushEvent( EEventType::Counter, counterId, value );
+	}
+
+	void TraceProfiler::startCapture( UInt32 numFrames, String fileName )
+	{
+		assert( threading::isMainThread() );
+
+		m_framesToCapture = numFrames;
+		m_captureFileName = fileName;
+		m_capturePending = true;
+
+		info( L"TraceProfiler: Capture started" );
+	}
+
+	void TraceProfiler::stopCapture()
+	{
+		assert( threading::isMainThread() );
+
+		if( m_capturing )
+		{
+			m_capturing = false;
+			m_captureEndTime = time::cycles64();
+
+			info( L"TraceProfiler: Capture stopped after %d frames", m_capturedFrames );
+		}
+
+		m_capturePending = false;
+	}
+
+	Bool TraceProfiler::exportTrace( String fileName ) const
+	{
+		assert( !m_capturing );
+		UInt64 exportStartTime = time::cycles64();
+
+		Text::Ptr trace = new Text();
+		trace->appendLine( TXT("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") );
+
+		auto timeToUs = [this]( UInt64 timestamp )->Double
+		{
+			return timestamp > m_captureStartTime ? time::cyclesToMs( timestamp - m_captureStartTime ) * 1000.0 : 0.0;
+		};
+
+		UInt32 numEvents = 0;
+		const Int32 numThreads = min<Int32>( m_numThreads.getValue(), MAX_THREADS );
+
+		for( Int32 i = 0; i < numThreads; ++i )
+		{
+			const ThreadBuffer* buffer = m_threads[i];
+
+			// skip threads without events in the last capture
+			if( !buffer || buffer->captureId.getValue() != m_captureId.getValue() )
+				continue;
+
+			const threading::ThreadId threadId = buffer->threadId;
+			const Bool isMain = threadId == threading::getMainThreadId();
+
+			trace->appendLine( String::format( TXT("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}},"),
+				threadId, isMain ? TXT("Main") : *String::format( TXT("Thread %u"), threadId ) ) );
+
+			// only last events are valid, if ring buffer is overflowed
+			const UInt32 numWritten = static_cast<UInt32>( buffer->numWritten.getValue() );
+			const UInt32 first = numWritten > m_eventsPerThread ? numWritten - m_eventsPerThread : 0;
+
+			Array<ZoneId> zonesStack;
+
+			for( UInt32 j = first; j < numWritten; ++j )
+			{
+				const Event& event = buffer->events[j & ( m_eventsPerThread - 1 )];
+				const Double ts = timeToUs( event.timestamp );
+
+				switch( event.type )
+				{
+					case EEventType::Enter:
+					{
+						trace->appendLine( String::format( TXT("{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":0,\"tid\":%u},"),
+							getZoneName( event.zoneId ), getGroupName( getZoneGroup( event.zoneId ) ), ts, threadId ) );
+
+						zonesStack.push( event.zoneId );
+						break;
+					}
+					case EEventType::Leave:
+					{
+						// enter event is lost, when zone is started before
+						// capture or overwritten in the ring buffer
+						if( zonesStack.size() == 0 )
+							continue;
+
+						trace->appendLine( String::format( TXT("{\"ph\":\"E\",\"ts\":%.3f,\"pid\":0,\"tid\":%u},"), ts, threadId ) );
+						zonesStack.pop();
+						break;
+					}
+					case EEventType::Counter:
+					{
+						trace->appendLine( String::format( TXT("{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":0,\"tid\":%u,\"args\":{\"value\":%f}},"),
+							getZoneName( event.zoneId ), getGroupName( getZoneGroup( event.zoneId ) ), ts, threadId, event.value ) );
+						break;
+					}
+					default:
+						fatal( L"Unknown trace event type %d", static_cast<Int32>( event.type ) );
+				}
+
+				numEvents++;
+			}
+
+			// close zones, which were active when capture stopped
+			while( zonesStack.size() > 0 )
+			{
+				trace->appendLine( String::format( TXT("{\"ph\":\"E\",\"ts\":%.3f,\"pid\":0,\"tid\":%u},"),
+					timeToUs( m_captureEndTime ), threadId ) );
+
+				zonesStack.pop();
+			}
+		}
+
+		// json doesn't allow trailing comma, so close with an empty metadata event
+		trace->appendLine( TXT("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"Fluorine\"}}") );
+		trace->appendLine( TXT("]}") );
+
+		if( !fm::writeTextFile( *fileName, trace ) )
+			return false;
+
+		info( L"TraceProfiler: %d events of %d threads exported to \"%s\" in %.2f ms", numEvents, numThreads,
+			*fileName, time::elapsedMsFrom( exportStartTime ) );
+
+		return true;
+	}
+
+	TraceProfiler::ThreadBuffer* TraceProfiler::getThreadBuffer()
+	{
+		if( t_bufferCache.generation == m_generation )
+		{
+			return reinterpret_cast<ThreadBuffer*>( t_bufferCache.buffer );
+		}
+
+		// first event of this thread, register a new buffer
+		const Int32 slot = m_numThreads.increment() - 1;
+
+		if( slot >= static_cast<Int32>( MAX_THREADS ) )
+		{
+			// too many threads, this one will not be traced
+			t_bufferCache.generation = m_generation;
+			t_bufferCache.buffer = nullptr;
+			return nullptr;
+		}
+
+		ThreadBuffer* buffer = new ThreadBuffer();
+		buffer->threadId = threading::getCurrentThreadId();
+		buffer->events = reinterpret_cast<Event*>( mem::alloc( sizeof( Event ) * m_eventsPerThread ) );
+		buffer->numWritten.setValue( 0 );
+		buffer->captureId.setValue( m_captureId.getValue() );
+
+		m_threads[slot] = buffer;
+
+		t_bufferCache.generation = m_generation;
+		t_bufferCache.buffer = buffer;
+
+		return buffer;
+	}
+
+	void TraceProfiler::pushEvent( EEventType type, ZoneId zoneId, Double value )
+	{
+		if( !m_capturing )
+			return;
+
+		ThreadBuffer* buffer = getThreadBuffer();
+
+		if( !buffer )
+			return;
+
+		// first event of the new capture
+		const Int32 captureId = m_captureId.getValue();
+
+		if( buffer->captureId.getValue() != captureId )
+		{
+			buffer->numWritten.setValue( 0 );
+			buffer->captureId.setValue( captureId );
+		}
+
+		// only owner thread writes to the buffer, so just fill
+		// the slot and publish it with counter
+		const Int32 index = buffer->numWritten.getValue();
+		Event& event = buffer->events[static_cast<UInt32>( index ) & ( m_eventsPerThread - 1 )];
+
+		event.timestamp = time::cycles64();
+		event.value = value;
+		event.zoneId = zoneId;
+		event.type = type;
+
+		buffer->numWritten.setValue( index + 1 );
+	}
+
+} // namespace profile
+} // namespace flu
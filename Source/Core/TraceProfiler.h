@@ -0,0 +1,101 @@
+//-----------------------------------------------------------------------------
+//	TraceProfiler.h: A multithreaded trace profiler
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+namespace profile
+{
+	/**
+	 *	A multithreaded profiler. Every thread writes its events into
+	 *	own ring buffer without any locks, so zones of the job system
+	 *	workers and resource server are captured too. Captured events
+	 *	are exported in the Chrome trace format (chrome://tracing, Perfetto)
+	 */
+	class TraceProfiler final: public IProfiler
+	{
+	public:
+		TraceProfiler( UInt32 eventsPerThread = DEFAULT_EVENTS_PER_THREAD );
+		~TraceProfiler();
+
+		void beginFrame() override;
+		void endFrame() override;
+
+		void enterZone( ZoneId zoneId ) override;
+		void leaveZone() override;
+
+		void updateCounter( ZoneId counterId, Double value ) override;
+
+		/**
+		 *	Start capturing from the next frame. If numFrames is not zero, the capture
+		 *	stops automatically after numFrames frames and trace is saved to fileName
+		 */
+		void startCapture( UInt32 numFrames = 0, String fileName = String() );
+		void stopCapture();
+
+		Bool exportTrace( String fileName ) const;
+
+		Bool isCapturing() const
+		{
+			return m_capturing;
+		}
+
+		UInt32 capturedFrames() const
+		{
+			return m_capturedFrames;
+		}
+
+	private:
+		static const UInt32 DEFAULT_EVENTS_PER_THREAD = 64 * 1024;
+		static const UInt32 MAX_THREADS = 64;
+
+		enum class EEventType : UInt32
+		{
+			Enter,
+			Leave,
+			Counter
+		};
+
+		struct Event
+		{
+			UInt64 timestamp;
+			Double value;
+			ZoneId zoneId;
+			EEventType type;
+		};
+
+		struct ThreadBuffer
+		{
+			threading::ThreadId threadId;
+			Event* events;
+			concurrency::Atomic numWritten;
+			concurrency::Atomic captureId;
+		};
+
+		const UInt32 m_eventsPerThread;
+
+		ThreadBuffer* m_threads[MAX_THREADS];
+		concurrency::Atomic m_numThreads;
+		concurrency::Atomic m_captureId;
+
+		volatile Bool m_capturing;
+		Bool m_capturePending;
+		UInt64 m_captureStartTime;
+		UInt64 m_captureEndTime;
+		UInt32 m_capturedFrames;
+		UInt32 m_framesToCapture;
+		String m_captureFileName;
+
+		const Int32 m_generation;
+		ZoneId m_frameZone;
+
+		ThreadBuffer* getThreadBuffer();
+		void pushEvent( EEventType type, ZoneId zoneId, Double value );
+
+		TraceProfiler( const TraceProfiler& ) = delete;
+		TraceProfiler& operator=( const TraceProfiler& ) = delete;
+	};
+
+} // namespace profile
+} // namespace flu
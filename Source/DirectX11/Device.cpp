@@ -865,6 +865,8 @@ namespace dx11
 					fatal( L"Unable to set shader resources to unknown shader %d", shader );
 					break;
 			}		
+
+			GPU_STAT( m_drawStats.m_srvSwitches++ );
 		}
 	}
 
@@ -1135,6 +1137,14 @@ namespace dx11
 		return hash;
 	}
 
+	Bool Device::isFormatSupported( rend::EFormat format ) const
+	{
+		UINT formatSupport = 0;
+		HRESULT result = m_device->CheckFormatSupport( fluorineFormatToDirectX( format ), &formatSupport );
+
+		return SUCCEEDED( result ) && ( formatSupport & D3D11_FORMAT_SUPPORT_TEXTURE2D );
+	}
+
 	const rend::MemoryStats& Device::getMemoryStats() const
 	{
 		return m_memoryStats;
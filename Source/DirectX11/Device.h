@@ -113,6 +113,8 @@ namespace dx11
 		Bool copyTextureToCPU( rend::Texture2DHandle handle, rend::EFormat& outFormat,
 			UInt32& outWidth, UInt32& outHeight, Array<UInt8>& outData ) override;
 
+		Bool isFormatSupported( rend::EFormat format ) const override;
+
 		const rend::MemoryStats& getMemoryStats() const override;
 		const rend::DrawStats& getDrawStats() const override;
 
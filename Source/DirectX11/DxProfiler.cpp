@@ -145,7 +145,7 @@ namespace dx11
 			const Double metricTime = static_cast<Double>( endTimestamp - startTimestamp ) / 
 				static_cast<Double>( timestampDisjoint.Frequency ) * 1000.0;
 
-			profile::getProfiler()->updateCounter( profile::EGroup::Render, metric.name, metricTime );
+			profile::getProfiler()->updateCounter( metric.counterId, metricTime );
 		}
 	}
 
@@ -183,6 +183,7 @@ namespace dx11
 		Metric metric;
 		metric.index = m_metrics.size();
 		metric.name = name;
+		metric.counterId = profile::internZone( profile::EGroup::Render, name );
 
 		D3D11_QUERY_DESC queryDesc;
 		mem::zero( &queryDesc, sizeof( D3D11_QUERY_DESC ) );
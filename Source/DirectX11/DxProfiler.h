@@ -35,6 +35,7 @@ namespace dx11
 		public:
 			UInt32 index = -1;
 			const Char* name = nullptr;
+			profile::ZoneId counterId = profile::INVALID_ZONE_ID;
 			Queries startQueries;
 			Queries endtQueries;
 			profile::IProfiler::Samples samples;
@@ -94,7 +94,8 @@ namespace dx11
 		assert( format != rend::EFormat::Unknown );
 		assert( width > 0 && height > 0 );
 		assert( isPowerOfTwo( width ) && isPowerOfTwo( height ) );
-		assert( mips == 1 && "Mips chain is not supported yet" );
+		assert( mips > 0 && mips <= rend::getMipsCount( width, height ) );
+		assert( mips == 1 || usage != rend::EUsage::Dynamic );
 
 		D3D11_TEXTURE2D_DESC description;
 		mem::zero( &description, sizeof( D3D11_TEXTURE2D_DESC ) );
@@ -117,12 +118,24 @@ namespace dx11
 		{
 			auto formatInfo = rend::getFormatInfo( m_format );
 
-			D3D11_SUBRESOURCE_DATA subresourceData;
-			subresourceData.pSysMem = initialData;
-			subresourceData.SysMemPitch = m_width * formatInfo.blockBytes / formatInfo.blockSizeX;
-			subresourceData.SysMemSlicePitch = subresourceData.SysMemPitch / formatInfo.blockSizeY;
+			// initial data contains all levels one after another
+			D3D11_SUBRESOURCE_DATA subresourceData[D3D11_REQ_MIP_LEVELS];
+			const UInt8* levelData = reinterpret_cast<const UInt8*>( initialData );
+
+			for( Int32 i = 0; i < m_levels; ++i )
+			{
+				const Int32 levelWidth = max( m_width >> i, 1 );
+				const Int32 levelHeight = max( m_height >> i, 1 );
+				const UInt32 blocksX = ( levelWidth + formatInfo.blockSizeX - 1 ) / formatInfo.blockSizeX;
+
+				subresourceData[i].pSysMem = levelData;
+				subresourceData[i].SysMemPitch = blocksX * formatInfo.blockBytes;
+				subresourceData[i].SysMemSlicePitch = 0;
+
+				levelData += rend::getLevelSize( m_format, levelWidth, levelHeight );
+			}
 
-			result = device->CreateTexture2D( &description, &subresourceData, &m_texture );
+			result = device->CreateTexture2D( &description, subresourceData, &m_texture );
 			assert( SUCCEEDED( result ) );	
 		}
 		else
@@ -151,10 +164,14 @@ namespace dx11
 
 	SizeT DxTexture2D::memoryUsage() const
 	{
-		auto formatInfo = rend::getFormatInfo( m_format );
-		
-		return ( m_width * m_height * formatInfo.blockBytes ) /
-			( formatInfo.blockSizeX * formatInfo.blockSizeY );
+		SizeT result = 0;
+
+		for( Int32 i = 0; i < m_levels; ++i )
+		{
+			result += rend::getLevelSize( m_format, max( m_width >> i, 1 ), max( m_height >> i, 1 ) );
+		}
+
+		return result;
 	}
 
 	DxRenderTarget::~DxRenderTarget()
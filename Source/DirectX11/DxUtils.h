@@ -40,6 +40,9 @@ namespace dx11
 			case rend::EFormat::RGBA32_I:		return DXGI_FORMAT_R32G32B32A32_SINT;
 			case rend::EFormat::RGBA32_U:		return DXGI_FORMAT_R32G32B32A32_UINT;
 			case rend::EFormat::D24S8:			return DXGI_FORMAT_D24_UNORM_S8_UINT;
+			case rend::EFormat::BC1_UNORM:		return DXGI_FORMAT_BC1_UNORM;
+			case rend::EFormat::BC3_UNORM:		return DXGI_FORMAT_BC3_UNORM;
+			case rend::EFormat::BC7_UNORM:		return DXGI_FORMAT_BC7_UNORM;
 
 			default:
 				fatal( L"Unknown format %hs", rend::getFormatInfo( format ).name );
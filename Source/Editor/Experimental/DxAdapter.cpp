@@ -92,6 +92,8 @@ namespace flu
 
 	void CDirectX11Canvas::DrawPoly( const TRenderPoly& poly )
 	{
+		FlushBatches();
+
 		if( poly.Flags & POLY_FlatShade )
 		{
 			m_coloredEffect->setColor( 0, poly.Color );
@@ -156,6 +158,8 @@ namespace flu
 
 	void CDirectX11Canvas::DrawRect( const TRenderRect& rect )
 	{
+		FlushBatches();
+
 		math::Vector Verts[4];
 
 		// Compute sprite vertices.
@@ -91,7 +91,7 @@ public:
 		// Copyright.
 		Render->DrawText
 		(
-			TPoint( Base.X+(Size.Width-WWindow::Font1->textWidth(*Lines[3]))/2, Base.Y+Size.Height-18 ),
+			TPoint( Base.X+(Size.Width-Render->TextWidth( Lines[3], WWindow::Font1 ))/2, Base.Y+Size.Height-18 ),
 			Lines[3],
 			GUI_COLOR_TEXT,
 			WWindow::Font1
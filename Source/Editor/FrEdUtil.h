@@ -26,6 +26,7 @@ public:
 	void DrawImage( TPoint P, TSize S, TPoint BP, TSize BS, img::Image::Ptr image );
 	void DrawTexture( TPoint P, TSize S, TPoint BP, TSize BS, rend::Texture2DHandle image, UInt32 width, UInt32 height );
 	void SetBrightness( Float Brig );
+	Float TextWidth( const Char* Text, Int32 Len, fnt::Font::Ptr Font );
 
 private:
 	Float m_brightness;
@@ -42,6 +43,9 @@ private:
 	rend::VertexBufferHandle m_texturedVB;
 
 	gfx::DrawContext* m_drawContext;
+
+	static math::Rect GetTexCoords( TPoint BP, TSize BS, UInt32 width, UInt32 height );
+	void DrawTexCoords( TPoint P, TSize S, const math::Rect& tc, rend::Texture2DHandle image );
 };
 
 
@@ -59,7 +63,7 @@ extern void CSGDifference( FBrushComponent* Brush, FLevel* Level );
 //
 // Experimental stuff
 //
-JSon::Ptr exportLevel( FLevel* level );
+void exportLevel( FLevel* level, JSonWriter& writer );
 
 
 /*-----------------------------------------------------------------------------
@@ -42,14 +42,14 @@ CEditor::CEditor()
 	:	CApplication()
 {
 	// Initial logging
-	LogManager::instance().addCallback( new LogCallbackFile( L"Editor.log" ) );
+	LogManager::instance().addAsyncCallback( new LogCallbackFile( L"Editor.log" ) );
 
 #if FLU_DEBUG
-	LogManager::instance().addCallback( new LogCallbackDebug( true ) );
+	LogManager::instance().addAsyncCallback( new LogCallbackDebug( true ) );
 
 	if( !IsDebuggerPresent() )
 	{
-		LogManager::instance().addCallback( new LogCallbackConsole() );
+		LogManager::instance().addAsyncCallback( new LogCallbackConsole() );
 	}
 #endif
 
@@ -340,6 +340,22 @@ void CEditor::Init( HINSTANCE InhInstance )
 	ShowWindow( hWnd, SW_SHOWMAXIMIZED );
 	UpdateWindow( hWnd );
 
+#if FLU_ENABLE_PROFILER
+	// Headless trace capture, editor quits when it's done.
+	Int32 NumTraceFrames = CCmdLineParser::ParseIntParam( GetCommandLine(), L"trace" );
+	if( NumTraceFrames > 0 )
+	{
+		m_traceProfiler = new profile::TraceProfiler();
+		profile::setProfiler( m_traceProfiler.get() );
+
+		m_traceProfiler->startCapture
+		(
+			NumTraceFrames,
+			CCmdLineParser::ParseStringParam( GetCommandLine(), L"tracefile", L"Trace.json" )
+		);
+	}
+#endif
+
 	// Notify.
 	info( L"Ed: Editor initialized" );
 }
@@ -381,6 +397,13 @@ void CEditor::Exit()
 	delete m_legacyRender;
 
 
+	if( m_traceProfiler.hasObject() )
+	{
+		m_traceProfiler->stopCapture();
+		profile::setDefaultProfiler();
+		m_traceProfiler = nullptr;
+	}
+
 	m_world = nullptr;
 	m_renderDevice = nullptr;
 	m_audioDevice = nullptr;
@@ -510,6 +533,10 @@ void CEditor::MainLoop()
 				}
 			}
 			profile_end_frame();
+
+			// Headless trace is captured.
+			if( m_traceProfiler.hasObject() && !m_traceProfiler->isCapturing() )
+				goto ExitLoop;
 		} 
 		
 	ExitLoop:;
@@ -50,6 +50,8 @@ public:
 	in::Device::UPtr		m_inputDevice;
 	World::UPtr				m_world;
 
+	UniquePtr<profile::TraceProfiler>	m_traceProfiler;
+
 
 	// foooooooooooooooooooooooooooooooooooooooo
 	CDirectX11Render* m_legacyRender;
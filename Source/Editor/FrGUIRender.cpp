@@ -192,21 +192,36 @@ void CGUIRender::DrawRegion( TPoint P, TSize S, math::Color Color, math::Color B
 
 void CGUIRender::DrawImage( TPoint P, TSize S, TPoint BP, TSize BS, img::Image::Ptr image )
 {
-	DrawTexture( P, S, BP, BS, image->getHandle(), image->getUSize(), image->getVSize() );
+	math::Rect tc = GetTexCoords( BP, BS, image->getUSize(), image->getVSize() );
+
+	// Packed into atlas?
+	if( image->isAtlasRegion() )
+		tc = image->mapTexCoords( tc );
+
+	DrawTexCoords( P, S, tc, image->getHandle() );
 }
 
 void CGUIRender::DrawTexture( TPoint P, TSize S, TPoint BP, TSize BS, rend::Texture2DHandle image, UInt32 width, UInt32 height )
+{
+	DrawTexCoords( P, S, GetTexCoords( BP, BS, width, height ), image );
+}
+
+math::Rect CGUIRender::GetTexCoords( TPoint BP, TSize BS, UInt32 width, UInt32 height )
 {
 	Float invUSize = 1.f / width;
 	Float invVSize = 1.f / height;
 
-	// Texture coords.
 	math::Rect tc;
 	tc.min.x	= BP.X * invUSize;
 	tc.min.y	= BP.Y * invVSize;
 	tc.max.x	= ( BP.X + BS.Width )  * invUSize;
 	tc.max.y	= ( BP.Y + BS.Height ) * invVSize;
 
+	return tc;
+}
+
+void CGUIRender::DrawTexCoords( TPoint P, TSize S, const math::Rect& tc, rend::Texture2DHandle image )
+{
 	math::Vector4 verts[4] = 
 	{
 		{ Float(P.X), Float(P.Y + S.Height), tc.min.x, tc.max.y },
@@ -241,6 +256,16 @@ void CGUIRender::DrawText( TPoint P, const Char* Text, Int32 Len, math::Color Co
 }
 
 
+//
+// Return width of the GUI text, it's taken from
+// the same layout cache, which is used to draw it.
+//
+Float CGUIRender::TextWidth( const Char* Text, Int32 Len, fnt::Font::Ptr Font )
+{
+	return m_textDrawer.textWidth( Text, Len, Font );
+}
+
+
 //
 // Set render clipping area.
 //
@@ -89,7 +89,7 @@ void WHelloPage::OnPaint( CGUIRenderBase* Render )
 	);
 	Render->DrawText
 	(
-		TPoint( Base.X+(Size.Width-Root->Font1->textWidth(FLU_COPYRIGHT))/2 ,Base.Y+Size.Height-30 ),
+		TPoint( Base.X+(Size.Width-Render->TextWidth( FLU_COPYRIGHT, Root->Font1 ))/2 ,Base.Y+Size.Height-30 ),
 		FLU_COPYRIGHT,
 		GUI_COLOR_TEXT,
 		Root->Font1
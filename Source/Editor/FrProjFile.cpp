@@ -1821,116 +1821,127 @@ FResource* CEditor::PreloadResource( String Name )
 
 
 ///////////////////////////////////////////////////////////////////////////////
-JSon::Ptr exportLevel( FLevel* level )
+void exportLevel( FLevel* level, JSonWriter& writer )
 {
 	assert( level );
 
+	// Fields go right to the writer, so no tree is built
+	// whatever the level size is.
 	class JSonExporter: public CExporterBase
 	{
 	public:
-		JSon::Ptr rootNode;
+		JSonExporter( JSonWriter& InWriter )
+			:	Writer( InWriter )
+		{
+		}
 
 		void ExportByte	( const Char* FieldName, UInt8 Value )
 		{
-			rootNode->addField( FieldName, JSon::createIntNode( Value ) );
+			Writer.writeKey( FieldName );
+			Writer.writeInt( Value );
 		}
 		void ExportInteger( const Char* FieldName, Int32 Value )
 		{
-			rootNode->addField( FieldName, JSon::createIntNode( Value ) );
+			Writer.writeKey( FieldName );
+			Writer.writeInt( Value );
 		}
 		void ExportFloat( const Char* FieldName, Float Value )
 		{
-			rootNode->addField( FieldName, JSon::createFloatNode( Value ) );
+			Writer.writeKey( FieldName );
+			Writer.writeFloat( Value );
 		}
 		void ExportString( const Char* FieldName, String Value )
 		{
-			rootNode->addField( FieldName, JSon::createStringNode( Value ) );
+			Writer.writeKey( FieldName );
+			Writer.writeString( *Value );
 		}
 		void ExportBool( const Char* FieldName, Bool Value	)
 		{
-			rootNode->addField( FieldName, JSon::createBoolNode( Value ) );
+			Writer.writeKey( FieldName );
+			Writer.writeBool( Value );
 		}
 		void ExportColor( const Char* FieldName, math::Color Value	)
 		{
-			JSon::Ptr colorNode = JSon::createObjectNode();
-			colorNode->addField( L"r", JSon::createIntNode( Value.r ) );
-			colorNode->addField( L"g", JSon::createIntNode( Value.g ) );
-			colorNode->addField( L"b", JSon::createIntNode( Value.b ) );
-			colorNode->addField( L"a", JSon::createIntNode( Value.a ) );
-
-			rootNode->addField( FieldName, colorNode );
+			Writer.writeKey( FieldName );
+			Writer.beginObject();
+			Writer.writeKey( L"r" );
+			Writer.writeInt( Value.r );
+			Writer.writeKey( L"g" );
+			Writer.writeInt( Value.g );
+			Writer.writeKey( L"b" );
+			Writer.writeInt( Value.b );
+			Writer.writeKey( L"a" );
+			Writer.writeInt( Value.a );
+			Writer.endObject();
 		}
 		void ExportVector( const Char* FieldName, math::Vector Value )
 		{
-			JSon::Ptr vectorNode = JSon::createArrayNode();
-			vectorNode->insertElement( JSon::createFloatNode( Value.x ) );
-			vectorNode->insertElement( JSon::createFloatNode( Value.y ) );
-
-			rootNode->addField( FieldName, vectorNode );
+			Writer.writeKey( FieldName );
+			Writer.beginArray();
+			Writer.writeFloat( Value.x );
+			Writer.writeFloat( Value.y );
+			Writer.endArray();
 		}
 		void ExportAABB( const Char* FieldName, math::Rect Value )
 		{
-			JSon::Ptr aabbNode = JSon::createArrayNode();
-			aabbNode->insertElement( JSon::createFloatNode( Value.min.x ) );
-			aabbNode->insertElement( JSon::createFloatNode( Value.min.y ) );
-			aabbNode->insertElement( JSon::createFloatNode( Value.max.x ) );
-			aabbNode->insertElement( JSon::createFloatNode( Value.max.y ) );
+			Writer.writeKey( FieldName );
+			Writer.beginArray();
+			Writer.writeFloat( Value.min.x );
+			Writer.writeFloat( Value.min.y );
+			Writer.writeFloat( Value.max.x );
+			Writer.writeFloat( Value.max.y );
+			Writer.endArray();
 		}
 		void ExportAngle( const Char* FieldName, math::Angle Value )
 		{
-			rootNode->addField( FieldName, JSon::createFloatNode(  Value.toDegs() ) );
-
+			Writer.writeKey( FieldName );
+			Writer.writeFloat( Value.toDegs() );
 		}
 		void ExportObject( const Char* FieldName, FObject* Value )
 		{
-			String objName = Value ? Value->GetFullName() : L"null";
-			rootNode->addField( FieldName, JSon::createStringNode(objName) );
+			Writer.writeKey( FieldName );
+			Writer.writeString( Value ? *Value->GetFullName() : L"null" );
 		}
-	};
 
-	JSon::Ptr rootNode = JSon::createObjectNode();
+	private:
+		JSonWriter& Writer;
+	};
 
-	JSonExporter exporter;
-	exporter.rootNode = rootNode;
+	JSonExporter exporter( writer );
+	writer.beginObject();
 
 	// level itself
 	level->Export( exporter );
 
 	// all entities
-	JSon::Ptr entitiesNode = JSon::createArrayNode();
-	rootNode->addField( L"Entity", entitiesNode );
+	writer.writeKey( L"Entity" );
+	writer.beginArray();
 
 	for( Int32 j = 0; j < level->Entities.size(); ++j )
 	{
 		FEntity* entity = level->Entities[j];
 
-		JSon::Ptr entityNode = JSon::createObjectNode();
-		entitiesNode->insertElement( entityNode );
-
 		// entity itself
-		exporter.rootNode = entitiesNode;
+		writer.beginObject();
 		entity->Export( exporter );
 
-		JSon::Ptr componentsNode = JSon::createArrayNode(  );
-		entitiesNode->insertElement( componentsNode );
-
 		// all components
+		writer.writeKey( L"Components" );
+		writer.beginArray();
+
 		for( Int32 i = 0; i < entity->Components.size(); ++i  )
 		{
-			FComponent* component = entity->Components[i];
-
-			JSon::Ptr componentNode = JSon::createObjectNode();
-			componentsNode->insertElement( componentNode );
-
-			exporter.rootNode = componentNode;
-			component->Export( exporter );
-		
+			writer.beginObject();
+			entity->Components[i]->Export( exporter );
+			writer.endObject();
 		}
-	}
-
 
+		writer.endArray();
+		writer.endObject();
+	}
 
-	return rootNode;
+	writer.endArray();
+	writer.endObject();
 }
 
 
@@ -1443,7 +1443,7 @@ void WResourcePane::OnPaint( CGUIRenderBase* Render )
 		}
 
 		// Draw overlay label.
-		Int32 Width = Root->Font1->textWidth( Icon.TypeName );
+		Int32 Width = Render->TextWidth( Icon.TypeName, Root->Font1 );
 		Render->DrawText
 		( 
 			Base + Icon.Position + TPoint( RES_ICON_SIZE/2-Width/2, RES_ICON_SIZE - 17 ),
@@ -2722,8 +2722,8 @@ void WCodeEditor::SaveToUndoStack( Int32 iSlot )
 	// Compress text.
 	void*	Compressed;
 	SizeT	ComSize;
-	CLZWCompressor LZW;
-	LZW.Encode
+	CLZCompressor LZ;
+	LZ.Encode
 	(
 		Buffer,
 		ReqMem,
@@ -2759,11 +2759,11 @@ void WCodeEditor::LoadFromUndoStack( Int32 iSlot )
 	// Unpack compressed data.
 	void*			Data;
 	SizeT			DataSize;
-	CLZWCompressor	LZW;
-	LZW.Decode
+	CLZCompressor	LZ;
+	LZ.Decode
 	(
 		UndoStack[iSlot],
-		-1000,				// LZW, doesn't really need it.
+		-1000,				// LZ, doesn't really need it.
 		Data,
 		DataSize
 	);
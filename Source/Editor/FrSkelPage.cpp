@@ -1498,7 +1498,7 @@ void WSkeletonPage::OnPaint( CGUIRenderBase* Render )
 	{
 		TPoint P = ClientToWindow( TPoint::Zero );
 
-		TSize HintSize = TSize( WWindow::Font1->textWidth(*BoneHint), WWindow::Font1->maxHeight() );
+		TSize HintSize = TSize( Render->TextWidth( BoneHint, WWindow::Font1 ), WWindow::Font1->maxHeight() );
 		TPoint DrawPos( BoneHintFrom.X+16, BoneHintFrom.Y+8 );
 
 		// Avoid out of window.
@@ -1697,7 +1697,7 @@ void WAnimationTrack::OnPaint( CGUIRenderBase* Render )
 			);
 
 			// Track line.
-			Int32 TrackX1 =  12 + Root->Font1->textWidth(*TrackName);
+			Int32 TrackX1 =  12 + Render->TextWidth( TrackName, Root->Font1 );
 			Render->DrawRegion
 			(
 				TPoint( Base.X + TrackX1, TrackY+8 ),
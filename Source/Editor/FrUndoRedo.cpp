@@ -17,8 +17,9 @@ CLevelTransactor::CLevelTransactor( FLevel* InLevel )
 	assert(InLevel);
 	assert(!InLevel->IsTemporal());
 	bLocked			= false;
-	TopTransaction	= 0;;
+	TopTransaction	= 0;
 	Level			= InLevel;
+	bShadowValid	= false;
 
 	// Notify.
 	info( L"Editor: Undo/Redo subsystem initialized for '%s'", *Level->GetFullName() );
@@ -31,13 +32,28 @@ CLevelTransactor::CLevelTransactor( FLevel* InLevel )
 CLevelTransactor::~CLevelTransactor()
 {
 	// Destroy transactions.
+	DropTransactions();
+
+	// Notify.
+	info( L"Editor: Undo/Redo subsystem shutdown for '%s'", *Level->GetFullName() );
+}
+
+
+//
+// Destroy all transactions and forget
+// the level's state.
+//
+void CLevelTransactor::DropTransactions()
+{
 	for( Int32 i=0; i<Transactions.size(); i++ )
 		delete Transactions[i];
-
 	Transactions.empty();
 
-	// Notify.
-	info( L"Editor: Undo/Redo subsystem shutdown for '%s'", *Level->GetFullName() );
+	TopTransaction	= 0;
+	bShadowValid	= false;
+	Shadow.empty();
+	ShadowVariables.empty();
+	Detached.empty();
 }
 
 
@@ -49,12 +65,7 @@ void CLevelTransactor::Reset()
 	assert(!bLocked);
 
 	// Destroy transactions.
-	for( Int32 i=0; i<Transactions.size(); i++ )
-		delete Transactions[i];
-	Transactions.empty();
-
-	// Pop transaction stack.
-	TopTransaction	= 0;
+	DropTransactions();
 
 	// Notify.
 	info( L"Editor: Undo transactor '%s' has been reset", *Level->GetName() );
@@ -69,7 +80,7 @@ void CLevelTransactor::Undo()
 	if( CanUndo() )
 	{
 		TopTransaction--;
-		Transactions[TopTransaction]->Restore();
+		ApplyTransaction( Transactions[TopTransaction], true );
 	}
 }
 
@@ -81,8 +92,8 @@ void CLevelTransactor::Redo()
 {
 	if( CanRedo() )
 	{
+		ApplyTransaction( Transactions[TopTransaction], false );
 		TopTransaction++;
-		Transactions[TopTransaction]->Restore();
 	}
 }
 
@@ -101,7 +112,7 @@ Bool CLevelTransactor::CanUndo() const
 //
 Bool CLevelTransactor::CanRedo() const
 {
-	return TopTransaction < (Transactions.size()-1);
+	return TopTransaction < Transactions.size();
 }
 
 
@@ -114,13 +125,8 @@ void CLevelTransactor::TrackEnter()
 	bLocked	= true;
 
 	// Store only first initial state.
-	if( TopTransaction == 0 )
-	{
-		Transactions.setSize( 1 );
-		Transactions[0]			= new TTransaction(Level);
-		Transactions[0]->Store();
-		TopTransaction	= 0;
-	}
+	if( !bShadowValid )
+		CaptureShadow();
 }
 
 
@@ -133,29 +139,32 @@ void CLevelTransactor::TrackLeave()
 	bLocked	= false;
 
 	// Destroy transactions after top.
-	for( Int32 i=TopTransaction+1; i<Transactions.size(); i++ )	
-		freeandnil(Transactions[i]);
+	for( Int32 i=TopTransaction; i<Transactions.size(); i++ )
+		delete Transactions[i];
+	Transactions.setSize( TopTransaction );
 
-	// Store current state.
-	Transactions.setSize(TopTransaction+2);
-	if( Transactions.size() > HISTORY_LIMIT )
+	// Store difference, if something changed.
+	TTransaction* Tran = MakeTransaction();
+	if( Tran->IsEmpty() )
 	{
-		// Destroy first record and shift others.
-		Transactions.setSize(HISTORY_LIMIT);
-		delete Transactions[0];
-
-		mem::copy
-		(
-			&Transactions[0],
-			&Transactions[1],
-			(Transactions.size()-1)*sizeof(TTransaction*)
-		);
+		delete Tran;
+		return;
 	}
-	TopTransaction	= Transactions.size()-1;
+	Transactions.push( Tran );
+
+	// Forget oldest transactions, if history is too large.
+	SizeT Mem = 0;
+	for( Int32 i=0; i<Transactions.size(); i++ )
+		Mem += Transactions[i]->CountMem();
 
-	// Create new transaction.
-	Transactions[TopTransaction]	= new TTransaction(Level);
-	Transactions[TopTransaction]->Store();
+	while( Transactions.size() > 1 &&
+		( Transactions.size() > HISTORY_LIMIT || Mem > HISTORY_MEM_LIMIT ) )
+	{
+		Mem -= Transactions[0]->CountMem();
+		delete Transactions[0];
+		Transactions.removeShift( 0 );
+	}
+	TopTransaction	= Transactions.size();
 }
 
 
@@ -166,16 +175,35 @@ void CLevelTransactor::TrackLeave()
 void CLevelTransactor::CountRefs( CSerializer& S )
 {
 	// Serialize everything.
+	Serialize( S, Detached );
+
+	for( Int32 i=0; i<Shadow.size(); i++ )
+	{
+		// Test if some script has been destroyed. Slot
+		// might be empty while transaction applied.
+		Bool bHadScript = Shadow[i].Script != nullptr;
+		Serialize( S, Shadow[i].Script );
+
+		if( bHadScript && !Shadow[i].Script )
+			goto ResetAll;
+	}
+
 	for( Int32 iTran=0; iTran<Transactions.size(); iTran++ )
 	{
 		TTransaction* Tran = Transactions[iTran];
-		Serialize( S, Tran->Detached );
-		Serialize( S, Tran->Entities );
 
-		// Test if some script has been destroyed.
 		for( Int32 i=0; i<Tran->Entities.size(); i++ )
-			if( Tran->Entities[i] == nullptr )
+		{
+			TEntityDelta& Delta = Tran->Entities[i];
+			Bool bHadOld = Delta.OldScript != nullptr;
+			Bool bHadNew = Delta.NewScript != nullptr;
+
+			Serialize( S, Delta.OldScript );
+			Serialize( S, Delta.NewScript );
+
+			if( ( bHadOld && !Delta.OldScript ) || ( bHadNew && !Delta.NewScript ) )
 				goto ResetAll;
+		}
 	}
 
 	// Everything fine.
@@ -183,10 +211,7 @@ void CLevelTransactor::CountRefs( CSerializer& S )
 
 ResetAll:
 	// Reset tracker.
-	for( Int32 iTran=0; iTran<Transactions.size(); iTran++ )
-		delete Transactions[iTran];
-	Transactions.empty();
-	TopTransaction	= 0;
+	DropTransactions();
 	info( L"Undo/Redo subsystem reset" );
 }
 
@@ -200,9 +225,13 @@ void CLevelTransactor::Debug()
 	for( Int32 i=0; i<Transactions.size(); i++ )
 		Mem += Transactions[i]->CountMem();
 
+	SizeT ShadowMem = ShadowVariables.size();
+	for( Int32 i=0; i<Shadow.size(); i++ )
+		ShadowMem += sizeof(TEntityImage) + Shadow[i].Data.size();
+
 	// Output.
 	debug( L"** UNDO/REDO for '%s' **", *Level->GetFullName() );
-	debug( L"Used %d kBs", Mem/1024 );
+	debug( L"Used %d kBs, level state %d kBs", Mem/1024, ShadowMem/1024 );
 	debug( L"TopTran=%d, Trans.Count=%d", TopTransaction, Transactions.size() );
 }
 
@@ -212,27 +241,32 @@ void CLevelTransactor::Debug()
 -----------------------------------------------------------------------------*/
 
 //
-// A writer to store level into transaction.
+// A writer to store level's entity into image.
 //
 class CTransactionWriter: public CSerializer
 {
 public:
 	// Variables.
-	TTransaction*	Transaction;
+	CLevelTransactor*	Transactor;
+	Array<UInt8>&		Data;
 
 	// CTransactionWriter interface.
-	CTransactionWriter( TTransaction* InTransaction )
+	CTransactionWriter( CLevelTransactor* InTransactor, Array<UInt8>& InData )
+		:	Transactor( InTransactor ),
+			Data( InData )
 	{
 		Mode		= SM_Save;
-		Transaction	= InTransaction;
 	}
 
 	// CSerializer interface.
 	void SerializeData( void* Mem, SizeT Count )
 	{
-		SizeT i	= Transaction->Data.size();
-		Transaction->Data.setSize(i+Count);
-		mem::copy( &Transaction->Data[i], Mem, Count );
+		if( !Count )
+			return;
+
+		SizeT i	= Data.size();
+		Data.setSize(i+Count);
+		mem::copy( &Data[i], Mem, Count );
 	}
 	void SerializeRef( FObject*& Obj )
 	{
@@ -246,7 +280,7 @@ public:
 		{
 			// Pointer to entity.
 			UInt8	b = 1;
-			Int32	i = Transaction->Level->GetEntityIndex((FEntity*)Obj);
+			Int32	i = GetEntityIndex((FEntity*)Obj);
 			Serialize( *this, b );
 			Serialize( *this, i );
 		}
@@ -255,7 +289,7 @@ public:
 			// Pointer to component.
 			FComponent* Component = As<FComponent>(Obj);
 			UInt8	b = 2;
-			Int32	i = Transaction->Level->GetEntityIndex(Component->Entity);
+			Int32	i = GetEntityIndex(Component->Entity);
 			Int32 j = Component == Component->Entity->Base ? 0xff : Component->Entity->Components.find((FExtraComponent*)Component);
 			assert(j != -1);
 			Serialize( *this, b );
@@ -267,22 +301,33 @@ public:
 			// Resource.
 			assert(Obj->IsA(FResource::MetaClass));
 			UInt8	b = 3;
-			Int32	i = Transaction->Detached.addUnique(Obj);
+			Int32	i = Transactor->Detached.addUnique(Obj);
 			Serialize( *this, b );
 			Serialize( *this, i );
 		}
 	}
 	SizeT TotalSize()
 	{
-		return Transaction->Data.size();
+		return Data.size();
 	}
 	SizeT Tell()
 	{
-		return Transaction->Data.size();
+		return Data.size();
 	}
 	void Seek( SizeT NewPos )
 	{
 	}
+
+private:
+	// Entity index via lookup table, instead of
+	// slow FLevel::GetEntityIndex.
+	Int32 GetEntityIndex( FEntity* Entity )
+	{
+		assert(Entity->GetId() < Transactor->EntityIndex.size());
+		Int32 i = Transactor->EntityIndex[Entity->GetId()];
+		assert(i != -1);
+		return i;
+	}
 };
 
 
@@ -291,31 +336,39 @@ public:
 -----------------------------------------------------------------------------*/
 
 //
-// A reader to restore level from transaction.
+// A reader to restore level's entity from image.
 //
 class CTransactionReader: public CSerializer
 {
 public:
 	// Variables.
-	TTransaction*	Transaction;
-	SizeT			StreamPos;
+	CLevelTransactor*		Transactor;
+	const Array<UInt8>&		Data;
+	SizeT					StreamPos;
 
 	// CTransactionReader interface.
-	CTransactionReader( TTransaction* InTransaction )
+	CTransactionReader( CLevelTransactor* InTransactor, const Array<UInt8>& InData )
+		:	Transactor( InTransactor ),
+			Data( InData ),
+			StreamPos( 0 )
 	{
 		Mode		= SM_Load;
-		Transaction	= InTransaction;
-		StreamPos	= 0;
 	}
 
 	// CSerializer interface.
 	void SerializeData( void* Mem, SizeT Count )
 	{
-		mem::copy( Mem, &Transaction->Data[StreamPos], Count );
+		if( !Count )
+			return;
+
+		assert(StreamPos+Count <= SizeT(Data.size()));
+		mem::copy( Mem, &Data[StreamPos], Count );
 		StreamPos	+= Count;
 	}
 	void SerializeRef( FObject*& Obj )
 	{
+		FLevel* Level = Transactor->Level;
+
 		UInt8 b;
 		Serialize( *this, b );
 		if( b == 0 )
@@ -328,7 +381,7 @@ public:
 			// Pointer to entity.
 			Int32 iEntity;
 			Serialize( *this, iEntity );
-			Obj	= Transaction->Level->Entities[iEntity];
+			Obj	= Level->Entities[iEntity];
 		}
 		else if( b == 2 )
 		{
@@ -336,7 +389,7 @@ public:
 			Int32 iEntity, iCom;
 			Serialize( *this, iEntity );
 			Serialize( *this, iCom );
-			FEntity* Entity = Transaction->Level->Entities[iEntity];
+			FEntity* Entity = Level->Entities[iEntity];
 			Obj	= iCom == 0xff ? (FComponent*)Entity->Base : (FComponent*)Entity->Components[iCom];
 		}
 		else
@@ -345,12 +398,12 @@ public:
 			assert(b==3);
 			Int32 iObj;
 			Serialize( *this, iObj );
-			Obj	= Transaction->Detached[iObj];
+			Obj	= Transactor->Detached[iObj];
 		}
 	}
 	SizeT TotalSize()
 	{
-		return Transaction->Data.size();
+		return Data.size();
 	}
 	SizeT Tell()
 	{
@@ -363,236 +416,301 @@ public:
 
 
 /*-----------------------------------------------------------------------------
-    TTransaction implementation.
+    Level state tracking.
 -----------------------------------------------------------------------------*/
 
 //
-// Transaction constructor.
+// Build table to find entity's index by it id.
 //
-TTransaction::TTransaction( FLevel* InLevel )
+void CLevelTransactor::BuildEntityIndex()
 {
-	assert(InLevel);
-	Level			= InLevel;
-	ComSourceSize	= 0;
-	ComSize			= 0;
-	ComData			= nullptr;
+	EntityIndex.setSize( GObjectDatabase->GObjects.size() );
+	for( Int32 i=0; i<EntityIndex.size(); i++ )
+		EntityIndex[i] = -1;
+
+	for( Int32 i=0; i<Level->Entities.size(); i++ )
+		EntityIndex[Level->Entities[i]->GetId()] = i;
 }
 
 
 //
-// Transaction destructor.
+// Serialize an entity into image.
 //
-TTransaction::~TTransaction()
+void CLevelTransactor::CaptureEntity( Int32 iEntity, TEntityImage& Image )
+{
+	FEntity* Entity	= Level->Entities[iEntity];
+
+	Image.Script	= Entity->Script;
+	Image.Name		= Entity->GetName();
+	Image.Data.empty();
+
+	CTransactionWriter Writer( this, Image.Data );
+
+	// Serialize only component's because they are refer.
+	Entity->Base->SerializeThis( Writer );
+	for( Int32 e=0; e<Entity->Components.size(); e++ )
+		Entity->Components[e]->SerializeThis( Writer );
+
+	// ..but also store the instance buffer.
+	if( Entity->InstanceBuffer )
+		Entity->InstanceBuffer->SerializeValues( Writer );
+}
+
+
+//
+// Serialize level variables.
+//
+void CLevelTransactor::CaptureVariables( Array<UInt8>& Data )
 {
 	Data.empty();
-	Entities.empty();
-	Detached.empty();
-	Names.empty();
+	CTransactionWriter Writer( this, Data );
 
-	if( ComData )
-		mem::free( ComData );
+	//Serialize( Writer, Level->RndFlags );
+	Serialize( Writer, Level->Camera );
+	Serialize( Writer, Level->Sky );
+	Serialize( Writer, Level->GameSpeed );
+	Writer.SerializeData( Level->Effect, sizeof(Level->Effect) );
 }
 
 
 //
-// Store a level into this transaction.
+// Store entire level's state, the next
+// transactions are computed relative it.
 //
-void TTransaction::Store()
+void CLevelTransactor::CaptureShadow()
 {
-	assert(Level);
+	BuildEntityIndex();
 
-	// Cleanup old data.
-	Entities.empty();
-	Names.empty();
-	Detached.empty();
-	Data.empty();
+	Shadow.setSize( Level->Entities.size() );
+	for( Int32 i=0; i<Shadow.size(); i++ )
+		CaptureEntity( i, Shadow[i] );
 
-	// Store list of script being each entity.
-	Entities.setSize(Level->Entities.size());
-	Names.setSize(Level->Entities.size());
-	for( Int32 i=0; i<Entities.size(); i++ )
-	{
-		Entities[i]	= Level->Entities[i]->Script;
-		Names[i]	= Level->Entities[i]->GetName();
-	}
+	CaptureVariables( ShadowVariables );
+	bShadowValid	= true;
+}
 
-	// Store each entity and their ref.
-	{
-		CTransactionWriter Writer(this);
 
-		// Serialize each entity.
-		for( Int32 i=0; i<Level->Entities.size(); i++ )
-		{
-			FEntity* Entity	= Level->Entities[i];
+//
+// Return true, if two images are equal.
+//
+static Bool ImagesEqual( const Array<UInt8>& A, const Array<UInt8>& B )
+{
+	return A.size() == B.size() && ( A.size() == 0 || mem::cmp( &A[0], &B[0], A.size() ) );
+}
 
-			// Serialize only component's because they are refer.
-			Entity->Base->SerializeThis( Writer );
-			for( Int32 e=0; e<Entity->Components.size(); e++ )
-				Entity->Components[e]->SerializeThis( Writer );
 
-			// ..but also store the instance buffer.
-			if( Entity->InstanceBuffer )
-				Entity->InstanceBuffer->SerializeValues( Writer );
-		}
+//
+// Compute difference between stored and current level's
+// state and make it current.
+//
+TTransaction* CLevelTransactor::MakeTransaction()
+{
+	assert(bShadowValid);
+	BuildEntityIndex();
 
-		// Level variables.
-		//Serialize( Writer, Level->RndFlags );
-		Serialize( Writer, Level->Camera );
-		Serialize( Writer, Level->Sky );
-		Serialize( Writer, Level->GameSpeed );
-		Writer.SerializeData( Level->Effect, sizeof(Level->Effect) );
-	}
+	TTransaction* Tran = new TTransaction();
+	Tran->OldCount	= Shadow.size();
+	Tran->NewCount	= Level->Entities.size();
+
+	Array<UInt8> Empty;
+	TEntityImage Image;
 
-#if TRAN_COMPRESS
-	// Compress the buffer.
-	ComSourceSize	= Data.size();
+	Shadow.setSize( max( Tran->OldCount, Tran->NewCount ) );
+	for( Int32 i=0; i<Shadow.size(); i++ )
 	{
-		CLZWCompressor LZW;
-		LZW.Encode
+		Bool bHasOld = i < Tran->OldCount;
+		Bool bHasNew = i < Tran->NewCount;
+
+		if( bHasNew )
+			CaptureEntity( i, Image );
+
+		if( bHasOld && bHasNew &&
+			Shadow[i].Script == Image.Script &&
+			Shadow[i].Name == Image.Name &&
+			ImagesEqual( Shadow[i].Data, Image.Data ) )
+				continue;
+
+		// Entity changed.
+		TEntityDelta Delta;
+		Delta.iSlot		= i;
+		Delta.OldScript	= bHasOld ? Shadow[i].Script : nullptr;
+		Delta.NewScript	= bHasNew ? Image.Script : nullptr;
+		Delta.OldName	= bHasOld ? Shadow[i].Name : String();
+		Delta.NewName	= bHasNew ? Image.Name : String();
+
+		// Only images of the same script might be compared.
+		Delta.Data.Make
 		(
-			&Data[0],
-			Data.size(),
-			ComData,
-			ComSize
+			bHasOld ? Shadow[i].Data : Empty,
+			bHasNew ? Image.Data : Empty,
+			Delta.OldScript != Delta.NewScript
 		);
 
-#if 0
-		// Realloc to real size.
-		assert(ComSize<=Data.Num());		// I'm afraid of it.
-		ComData = MemRealloc( ComData, ComSize );
-#endif
+		Tran->Entities.push( Delta );
+
+		if( bHasNew )
+			Shadow[i] = Image;
 	}
-	//log( L"Transaction compress: %d->%d", Data.Num(), ComSize );
-	if( ComSize > Data.size() )
-		error( L"Undo/Redo record failure. But don't worry, it's not fatal." );
-	Data.empty();
-#endif
+	Shadow.setSize( Tran->NewCount );
+
+	// Level variables.
+	Array<UInt8> Variables;
+	CaptureVariables( Variables );
+	if( !ImagesEqual( ShadowVariables, Variables ) )
+	{
+		Tran->bVariablesChanged	= true;
+		Tran->Variables.Make( ShadowVariables, Variables, false );
+		ShadowVariables	= Variables;
+	}
+
+	return Tran;
 }
 
 
 //
-// Restore an level from byte sequence.
+// Rollback or repeat transaction. Only changed entities are
+// touched, so others keep their objects.
 //
-void TTransaction::Restore()
+void CLevelTransactor::ApplyTransaction( const TTransaction* Tran, Bool bUndo )
 {
-	assert(Level);
-
-#if 0
-	// Anyway destroy navigator.
-	freeandnil(Level->Navigator);
-#endif
+	assert(bShadowValid);
+	assert(Shadow.size() == (bUndo ? Tran->NewCount : Tran->OldCount));
+	assert(Level->Entities.size() == Shadow.size());
 
-	// Erase old level's objects.
-	for( Int32 i=0; i<Level->Entities.size(); i++ )
-		DestroyObject( Level->Entities[i], true );
+	Int32 TargetCount = bUndo ? Tran->OldCount : Tran->NewCount;
 
-	Level->Entities.empty();
-	assert(Level->RenderObjects.size()==0);
-	assert(Level->TickObjects.size()==0);
-	assert(!Level->FirstPuppet);
+	// Compute target images from the current.
+	Shadow.setSize( max( Shadow.size(), TargetCount ) );
+	for( Int32 i=0; i<Tran->Entities.size(); i++ )
+	{
+		const TEntityDelta& Delta = Tran->Entities[i];
+		TEntityImage& Image = Shadow[Delta.iSlot];
 
-	Level->Sky		= nullptr;
+		Delta.Data.Apply( Image.Data, bUndo );
+		Image.Script	= bUndo ? Delta.OldScript : Delta.NewScript;
+		Image.Name		= bUndo ? Delta.OldName : Delta.NewName;
+	}
 
-#if TRAN_COMPRESS
-	// Uncompress the buffer.
-	Data.setSize( ComSourceSize );
+	// Destroy entities which are gone or
+	// replaced with other script.
+	for( Int32 i=0; i<Tran->Entities.size(); i++ )
 	{
-		void* DData;
-		SizeT DSize;
-		CLZWCompressor LZW;
+		Int32 iSlot = Tran->Entities[i].iSlot;
+		if( iSlot >= Level->Entities.size() )
+			continue;
 
-		LZW.Decode
-		(
-			ComData,
-			ComSize,
-			DData,
-			DSize
-		);
-
-		assert(DSize==ComSourceSize);
-		mem::copy( &Data[0], DData, DSize );
-		mem::free( DData );
+		FEntity* Entity = Level->Entities[iSlot];
+		if( iSlot >= TargetCount || Entity->Script != Shadow[iSlot].Script )
+		{
+			DestroyObject( Entity, true );
+			Level->Entities[iSlot]	= nullptr;
+		}
 	}
-#endif
 
-	// Restore all actors.
+	// Rename survived entities, after destruction
+	// since names might be released.
+	for( Int32 i=0; i<Tran->Entities.size(); i++ )
 	{
-		CTransactionReader Reader(this);
+		Int32 iSlot = Tran->Entities[i].iSlot;
+		if( iSlot >= Level->Entities.size() || !Level->Entities[iSlot] || iSlot >= TargetCount )
+			continue;
 
-		// Allocate a list of entities and all it's 
-		// components.
-		for( Int32 iEntity=0; iEntity<Entities.size(); iEntity++ )
-		{
-			FEntity* Entity = NewObject<FEntity>( Names[iEntity], Level );
+		FEntity* Entity = Level->Entities[iSlot];
+		if( Entity->GetName() != Shadow[iSlot].Name )
+			GObjectDatabase->RenameObject( Entity, Shadow[iSlot].Name );
+	}
 
-			Entity->Level	= Level;
-			Entity->Script	= Entities[iEntity];
+	Int32 OldCount = Level->Entities.size();
+	Level->Entities.setSize( TargetCount );
+	for( Int32 i=OldCount; i<TargetCount; i++ )
+		Level->Entities[i]	= nullptr;
+	Shadow.setSize( TargetCount );
 
-			// Base.
-			FBaseComponent* Base = NewObject<FBaseComponent>
-													( 
-														Entity->Script->Base->GetClass(), 
-														Entity->Script->Base->GetName(), 
-														Entity 
+	// Allocate new entities and all it's components.
+	for( Int32 i=0; i<Tran->Entities.size(); i++ )
+	{
+		Int32 iSlot = Tran->Entities[i].iSlot;
+		if( iSlot >= TargetCount || Level->Entities[iSlot] )
+			continue;
+
+		FEntity* Entity = NewObject<FEntity>( Shadow[iSlot].Name, Level );
+
+		Entity->Level	= Level;
+		Entity->Script	= Shadow[iSlot].Script;
+
+		// Base.
+		FBaseComponent* Base = NewObject<FBaseComponent>
+												(
+													Entity->Script->Base->GetClass(),
+													Entity->Script->Base->GetName(),
+													Entity
+												);
+		Base->InitForEntity( Entity );
+
+		// Extra components.
+		for( Int32 e=0; e<Entity->Script->Components.size(); e++ )
+		{
+			FExtraComponent* Extra = Entity->Script->Components[e];
+			FExtraComponent* Com = NewObject<FExtraComponent>
+													(
+														Extra->GetClass(),
+														Extra->GetName(),
+														Entity
 													);
-			Base->InitForEntity( Entity );
-
-			// Extra components.
-			for( Int32 i=0; i<Entity->Script->Components.size(); i++ )
-			{
-				FExtraComponent* Extra = Entity->Script->Components[i];
-				FExtraComponent* Com = NewObject<FExtraComponent>
-														( 
-															Extra->GetClass(), 
-															Extra->GetName(), 
-															Entity 
-														);
-				Com->InitForEntity( Entity );
-			}
-
-			// Initialize instance buffer.
-			if( Entity->Script->InstanceBuffer )
-			{
-				Entity->InstanceBuffer = new CInstanceBuffer( Entity->Script->Properties );
-				Entity->InstanceBuffer->Data.setSize( Entity->Script->InstanceSize );
-			}
-
-			// Add entity to the level's db.
-			Level->Entities.push( Entity );
+			Com->InitForEntity( Entity );
 		}
 
-		// Serialize each entity.
-		for( Int32 i=0; i<Level->Entities.size(); i++ )
+		// Initialize instance buffer.
+		if( Entity->Script->InstanceBuffer )
 		{
-			FEntity* Entity	= Level->Entities[i];
+			Entity->InstanceBuffer = new CInstanceBuffer( Entity->Script->Properties );
+			Entity->InstanceBuffer->Data.setSize( Entity->Script->InstanceSize );
+		}
 
-			// Serialize only component's because they are refer.
-			Entity->Base->SerializeThis( Reader );
-			for( Int32 e=0; e<Entity->Components.size(); e++ )
-				Entity->Components[e]->SerializeThis( Reader );
+		Level->Entities[iSlot]	= Entity;
+	}
 
-			// ..but also store the instance buffer.
-			if( Entity->InstanceBuffer )
-				Entity->InstanceBuffer->SerializeValues( Reader );
-		}
+	// Restore changed entities.
+	for( Int32 i=0; i<Tran->Entities.size(); i++ )
+	{
+		Int32 iSlot = Tran->Entities[i].iSlot;
+		if( iSlot >= TargetCount )
+			continue;
+
+		FEntity* Entity	= Level->Entities[iSlot];
+		CTransactionReader Reader( this, Shadow[iSlot].Data );
+
+		// Serialize only component's because they are refer.
+		Entity->Base->SerializeThis( Reader );
+		for( Int32 e=0; e<Entity->Components.size(); e++ )
+			Entity->Components[e]->SerializeThis( Reader );
+
+		// ..but also store the instance buffer.
+		if( Entity->InstanceBuffer )
+			Entity->InstanceBuffer->SerializeValues( Reader );
+	}
 
-		// Level variables.
-		//Serialize( Writer, Level->RndFlags );
+	// Level variables.
+	if( Tran->bVariablesChanged )
+	{
+		Tran->Variables.Apply( ShadowVariables, bUndo );
+		CTransactionReader Reader( this, ShadowVariables );
+
+		//Serialize( Reader, Level->RndFlags );
 		Serialize( Reader, Level->Camera );
 		Serialize( Reader, Level->Sky );
 		Serialize( Reader, Level->GameSpeed );
 		Reader.SerializeData( Level->Effect, sizeof(Level->Effect) );
 	}
 
-#if TRAN_COMPRESS
-	// Release decompressed data.
-	Data.empty();
-#endif
-
-	// Notify each object.
-	for( Int32 iEntity=0; iEntity<Level->Entities.size(); iEntity++ )
+	// Notify each changed object.
+	for( Int32 i=0; i<Tran->Entities.size(); i++ )
 	{
-		FEntity* Entity	= Level->Entities[iEntity];
+		Int32 iSlot = Tran->Entities[i].iSlot;
+		if( iSlot >= TargetCount )
+			continue;
+
+		FEntity* Entity	= Level->Entities[iSlot];
 
 		Entity->PostLoad();
 		Entity->Base->PostLoad();
@@ -602,19 +720,128 @@ void TTransaction::Restore()
 }
 
 
+/*-----------------------------------------------------------------------------
+    TBinaryDelta implementation.
+-----------------------------------------------------------------------------*/
+
+//
+// Delta constructor.
+//
+TBinaryDelta::TBinaryDelta()
+	:	Prefix( 0 ),
+		Suffix( 0 )
+{
+}
+
+
+//
+// Compute difference between two images. If bFull
+// images are stored entirely.
+//
+void TBinaryDelta::Make( const Array<UInt8>& Old, const Array<UInt8>& New, Bool bFull )
+{
+	Prefix	= 0;
+	Suffix	= 0;
+
+	if( !bFull )
+	{
+		Int32 Common = min( Old.size(), New.size() );
+
+		while( Prefix < Common && Old[Prefix] == New[Prefix] )
+			Prefix++;
+
+		while( Suffix < Common-Prefix && Old[Old.size()-1-Suffix] == New[New.size()-1-Suffix] )
+			Suffix++;
+	}
+
+	OldBytes.setSize( Old.size() - Prefix - Suffix );
+	if( OldBytes.size() )
+		mem::copy( &OldBytes[0], &Old[Prefix], OldBytes.size() );
+
+	NewBytes.setSize( New.size() - Prefix - Suffix );
+	if( NewBytes.size() )
+		mem::copy( &NewBytes[0], &New[Prefix], NewBytes.size() );
+}
+
+
+//
+// Turn image of the one state to another.
+//
+void TBinaryDelta::Apply( Array<UInt8>& Image, Bool bUndo ) const
+{
+	const Array<UInt8>& From	= bUndo ? NewBytes : OldBytes;
+	const Array<UInt8>& To		= bUndo ? OldBytes : NewBytes;
+	assert(Image.size() == Prefix + From.size() + Suffix);
+
+	Array<UInt8> Result( Prefix + To.size() + Suffix );
+
+	if( Prefix )
+		mem::copy( &Result[0], &Image[0], Prefix );
+	if( To.size() )
+		mem::copy( &Result[Prefix], &To[0], To.size() );
+	if( Suffix )
+		mem::copy( &Result[Prefix+To.size()], &Image[Image.size()-Suffix], Suffix );
+
+	Image	= Result;
+}
+
+
+//
+// Count a memory used by this delta.
+//
+SizeT TBinaryDelta::CountMem() const
+{
+	return OldBytes.size() + NewBytes.size();
+}
+
+
+/*-----------------------------------------------------------------------------
+    TTransaction implementation.
+-----------------------------------------------------------------------------*/
+
+//
+// Transaction constructor.
+//
+TTransaction::TTransaction()
+{
+	OldCount			= 0;
+	NewCount			= 0;
+	bVariablesChanged	= false;
+}
+
+
+//
+// Transaction destructor.
+//
+TTransaction::~TTransaction()
+{
+	Entities.empty();
+}
+
+
+//
+// Return true, if nothing changed.
+//
+Bool TTransaction::IsEmpty() const
+{
+	return OldCount == NewCount && Entities.size() == 0 && !bVariablesChanged;
+}
+
+
 //
 // Count a memory used by this transaction.
 //
 SizeT TTransaction::CountMem() const
 {
-	return	Entities.size() * sizeof(FScript*) +
-			Detached.size() * sizeof(FObject*) +
-			Names.size() * sizeof(String) +
-			Data.size() * sizeof(UInt8) +
-			ComSourceSize;
+	SizeT Mem = sizeof(TTransaction) + Variables.CountMem();
+
+	for( Int32 i=0; i<Entities.size(); i++ )
+		Mem += sizeof(TEntityDelta) + Entities[i].Data.CountMem();
+
+	return Mem;
 }
 
 
 /*-----------------------------------------------------------------------------
     The End.
------------------------------------------------------------------------------*/
\ No newline at end of file
+-----------------------------------------------------------------------------*/
@@ -7,33 +7,73 @@
     TTransaction.
 -----------------------------------------------------------------------------*/
 
-// Whether compress transactions?
-#define TRAN_COMPRESS		1
+//
+// A binary difference between two images, common prefix and
+// suffix are omitted, so single property change costs a few bytes.
+//
+struct TBinaryDelta
+{
+public:
+	Int32			Prefix;
+	Int32			Suffix;
+	Array<UInt8>	OldBytes;
+	Array<UInt8>	NewBytes;
+
+	TBinaryDelta();
+	void Make( const Array<UInt8>& Old, const Array<UInt8>& New, Bool bFull );
+	void Apply( Array<UInt8>& Image, Bool bUndo ) const;
+	SizeT CountMem() const;
+};
 
 
 //
-// A single transaction.
+// A serialized entity.
+//
+struct TEntityImage
+{
+public:
+	FScript*		Script;
+	String			Name;
+	Array<UInt8>	Data;
+};
+
+
+//
+// A change of the level's entity slot. Script is
+// nullptr, if slot is empty in the state.
+//
+struct TEntityDelta
+{
+public:
+	Int32			iSlot;
+	FScript*		OldScript;
+	FScript*		NewScript;
+	String			OldName;
+	String			NewName;
+	TBinaryDelta	Data;
+};
+
+
+//
+// A single transaction, difference between two
+// level's states.
 //
 class TTransaction
 {
 public:
-	// General info.
-	Array<UInt8>		Data;
-	FLevel*				Level;
-	Array<FScript*>		Entities;
-	Array<String>		Names;
-	Array<FObject*>		Detached;
-
-	// Compressed data.
-	SizeT				ComSourceSize;
-	SizeT				ComSize;
-	void*				ComData;
+	// Entities changes.
+	Int32					OldCount;
+	Int32					NewCount;
+	Array<TEntityDelta>		Entities;
+
+	// Level variables change.
+	Bool					bVariablesChanged;
+	TBinaryDelta			Variables;
 
 	// TTransaction interface.
-	TTransaction( FLevel* InLevel );
+	TTransaction();
 	~TTransaction();
-	void Store();
-	void Restore();
+	Bool IsEmpty() const;
 	SizeT CountMem() const;
 };
 
@@ -49,7 +89,8 @@ class CLevelTransactor: public CRefsHolder
 {
 public:
 	// Constants.
-	enum{ HISTORY_LIMIT	= 20 };
+	enum{ HISTORY_LIMIT	= 256 };
+	enum{ HISTORY_MEM_LIMIT = 16 * 1024 * 1024 };
 
 	// CLevelTransactor interface.
 	CLevelTransactor( FLevel* InLevel );
@@ -72,6 +113,25 @@ private:
 	Array<TTransaction*>	Transactions;
 	Int32					TopTransaction;
 	FLevel*					Level;
+
+	// Last tracked level state.
+	Bool					bShadowValid;
+	Array<TEntityImage>		Shadow;
+	Array<UInt8>			ShadowVariables;
+	Array<FObject*>			Detached;
+	Array<Int32>			EntityIndex;
+
+	// Internal.
+	void CaptureShadow();
+	void CaptureEntity( Int32 iEntity, TEntityImage& Image );
+	void CaptureVariables( Array<UInt8>& Data );
+	void BuildEntityIndex();
+	TTransaction* MakeTransaction();
+	void ApplyTransaction( const TTransaction* Tran, Bool bUndo );
+	void DropTransactions();
+
+	friend class CTransactionWriter;
+	friend class CTransactionReader;
 };
 
 
@@ -13,6 +13,8 @@ namespace flu
 	static const Char CHART_FONT_NAME[] = TXT( "Fonts.CourierNew_9" );
 	static const Char CHART_EFFECT_NAME[] = TXT( "System.Shaders.Colored" );
 
+	static const Char SCRIPT_PROFILE_FILE_NAME[] = TXT( "ScriptProfile.json" );
+
 	EngineChart::EngineChart()
 		:	m_profiler(),
 			m_invTimelineLength( 0.0 ),
@@ -34,6 +36,7 @@ namespace flu
 		{
 			m_helpString += String::format( L"[%d] %s; ", i, getGroupName( static_cast<profile::EGroup>( i ) ) );
 		}
+		m_helpString += L"[F9] Toggle script profiling; [F10] Export script statistics";
 
 		// obtain resources
 		m_font = res::ResourceManager::get<fnt::Font>( CHART_FONT_NAME, res::EFailPolicy::FATAL );
@@ -59,6 +62,8 @@ namespace flu
 		profile_gpu_zone( GPU_Chart );
 		gfx::ScopedRenderingZone srz( TXT( "Profiler" ) );
 
+		profile::ScriptProfiler::instance().flushFrame();
+
 		const Float screenW = drawContext.backbufferWidth();
 		const Float screenH = drawContext.backbufferHeight();
 
@@ -230,6 +235,31 @@ namespace flu
 			return true;
 		}
 
+		if( isEnabled() && button == in::EKeyboardButton::KB_F9 && !repeat )
+		{
+			profile::ScriptProfiler& scriptProfiler = profile::ScriptProfiler::instance();
+
+			if( scriptProfiler.isEnabled() )
+			{
+				scriptProfiler.disable();
+			}
+			else
+			{
+				scriptProfiler.reset();
+				scriptProfiler.enable();
+				m_profiler.selectGroup( static_cast<Int32>( profile::EGroup::Script ) );
+			}
+
+			return true;
+		}
+
+		if( isEnabled() && button == in::EKeyboardButton::KB_F10 && !repeat )
+		{
+			profile::ScriptProfiler::instance().exportToFile( 
+				*fm::resolveFileName( SCRIPT_PROFILE_FILE_NAME, fm::EPathBase::Exe ) );
+			return true;
+		}
+
 		return false;
 	}
 
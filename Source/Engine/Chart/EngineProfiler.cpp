@@ -40,9 +40,24 @@ namespace profile
 		{
 			for( auto& it : group )
 			{
-				while( it.samples.size() != 0 && it.samples[0].time < minimalTime )
+				Int32 numExpired = 0;
+
+				while( numExpired < it.samples.size() && it.samples[numExpired].time < minimalTime )
 				{
-					it.samples.removeShift( 0 );
+					numExpired++;
+				}
+
+				// remove all expired samples at once
+				if( numExpired > 0 )
+				{
+					const Int32 numLeft = it.samples.size() - numExpired;
+
+					for( Int32 i = 0; i < numLeft; ++i )
+					{
+						it.samples[i] = it.samples[i + numExpired];
+					}
+
+					it.samples.setSize( numLeft );
 				}
 			}		
 		}
@@ -50,21 +65,29 @@ namespace profile
 		m_frameLocked = false;
 	}
 
-	void EngineProfiler::enterZone( EGroup group, const Char* zoneName )
+	void EngineProfiler::enterZone( ZoneId zoneId )
 	{
+		// chart shows only main thread timings
+		if( !threading::isMainThread() )
+			return;
+
+		// untracked zone still keeps the stack balanced
 		Zone zone;
 		zone.enterTimeStamp = time::cycles64();
-		zone.groupId = group;
-		zone.metric = &findOrAddMetric( group, zoneName );
+		zone.groupId = getZoneGroup( zoneId );
+		zone.metric = zoneId != INVALID_ZONE_ID ? &findOrAddMetric( zoneId ) : nullptr;
 
 		m_zonesStack.push( zone );
 	}
 
 	void EngineProfiler::leaveZone()
 	{
+		if( !threading::isMainThread() )
+			return;
+
 		Zone zone = m_zonesStack.pop();
 
-		if( zone.groupId == m_selectedGroup )
+		if( zone.metric && zone.groupId == m_selectedGroup )
 		{
 			if( zone.metric->samples.size() == 0 || zone.metric->samples.last().time != m_frameEnterTime )
 			{
@@ -77,11 +100,11 @@ namespace profile
 		}
 	}
 
-	void EngineProfiler::updateCounter( EGroup group, const Char* counterName, Double value )
+	void EngineProfiler::updateCounter( ZoneId counterId, Double value )
 	{
-		if( group == m_selectedGroup )
+		if( counterId != INVALID_ZONE_ID && getZoneGroup( counterId ) == m_selectedGroup )
 		{
-			Metric& metric = findOrAddMetric( group, counterName );
+			Metric& metric = findOrAddMetric( counterId );
 
 			if( metric.samples.size() == 0 || metric.samples.last().time != m_frameEnterTime )
 			{
@@ -89,7 +112,7 @@ namespace profile
 			}
 			else
 			{
-				fatal( L"Counter \"%s\" updated twice per frame", counterName );
+				fatal( L"Counter \"%s\" updated twice per frame", metric.name );
 			}
 		}
 	}
@@ -120,19 +143,28 @@ namespace profile
 		m_samplesLifetime = lifeTime;
 	}
 
-	EngineProfiler::Metric& EngineProfiler::findOrAddMetric( EGroup group, const Char* name )
+	EngineProfiler::Metric& EngineProfiler::findOrAddMetric( ZoneId zoneId )
 	{
-		for( auto& it : m_groups[static_cast<Int32>( group )] )
+		const EGroup group = getZoneGroup( zoneId );
+
+		if( zoneId < static_cast<ZoneId>( m_zoneToMetric.size() ) && m_zoneToMetric[zoneId] != -1 )
+		{
+			return m_groups[static_cast<Int32>( group )][m_zoneToMetric[zoneId]];
+		}
+
+		// first time zone appears in the chart
+		while( static_cast<ZoneId>( m_zoneToMetric.size() ) <= zoneId )
 		{
-			if( it.name == name )
-				return it;
+			m_zoneToMetric.push( -1 );
 		}
 
+		const Char* name = getZoneName( zoneId );
+
 		Metric newMetric;
 		newMetric.name = name;
 		newMetric.color = hashing::murmur32( name, cstr::length( name ) * sizeof( Char ) );
 		
-		m_groups[static_cast<Int32>( group )].push( newMetric );
+		m_zoneToMetric[zoneId] = m_groups[static_cast<Int32>( group )].push( newMetric );
 		return m_groups[static_cast<Int32>( group )].last();
 	}
 
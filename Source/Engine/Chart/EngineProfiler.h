@@ -19,10 +19,10 @@ namespace profile
 		void beginFrame() override;
 		void endFrame() override;
 
-		void enterZone( EGroup group, const Char* zoneName ) override;
+		void enterZone( ZoneId zoneId ) override;
 		void leaveZone() override;
 
-		void updateCounter( EGroup group, const Char* counterName, Double value ) override;
+		void updateCounter( ZoneId counterId, Double value ) override;
 
 		struct Metric
 		{
@@ -65,7 +65,9 @@ namespace profile
 		Groups m_groups;
 		EGroup m_selectedGroup;
 
-		Metric& findOrAddMetric( EGroup group, const Char* name );
+		Array<Int32> m_zoneToMetric;
+
+		Metric& findOrAddMetric( ZoneId zoneId );
 	};
 
 } // namespace profile
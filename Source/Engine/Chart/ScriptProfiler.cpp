@@ -0,0 +1,320 @@
+//-----------------------------------------------------------------------------
+//	ScriptProfiler.cpp: FluScript virtual machine profiler
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Engine/Engine.h"
+
+namespace flu
+{
+namespace profile
+{
+	/**
+	 *	Names of all opcodes in EOpCode order
+	 */
+	static const Char* OPCODE_NAMES[] =
+	{
+		TXT("CODE_EOC"), TXT("CODE_Jump"), TXT("CODE_JumpZero"), TXT("CODE_Switch"), TXT("CODE_Foreach"),
+		TXT("CODE_LToR"), TXT("CODE_LToRDWord"), TXT("CODE_LToRString"), TXT("CODE_Assign"),
+		TXT("CODE_AssignDWord"), TXT("CODE_AssignString"), TXT("CODE_LocalVar"),
+		TXT("CODE_EntityProperty"), TXT("CODE_BaseProperty"), TXT("CODE_ComponentProperty"),
+		TXT("CODE_ResourceProperty"), TXT("CODE_ProtoProperty"), TXT("CODE_StaticProperty"),
+		TXT("CODE_ConstByte"), TXT("CODE_ConstBool"), TXT("CODE_ConstInteger"), TXT("CODE_ConstFloat"),
+		TXT("CODE_ConstAngle"), TXT("CODE_ConstColor"), TXT("CODE_ConstString"), TXT("CODE_ConstVector"),
+		TXT("CODE_ConstAABB"), TXT("CODE_ConstResource"), TXT("CODE_ConstEntity"),
+		TXT("CODE_ConstDelegate"), TXT("CODE_ArrayElem"), TXT("CODE_DynArrayElem"),
+		TXT("CODE_DynSetLength"), TXT("CODE_DynGetLength"), TXT("CODE_DynPush"), TXT("CODE_DynPop"),
+		TXT("CODE_DynRemove"), TXT("CODE_RMember"), TXT("CODE_LMember"), TXT("CODE_This"),
+		TXT("CODE_New"), TXT("CODE_Delete"), TXT("CODE_EntityCast"), TXT("CODE_FamilyCast"),
+		TXT("CODE_Is"), TXT("CODE_In"), TXT("CODE_Context"), TXT("CODE_ThisContext"), TXT("CODE_Assert"),
+		TXT("CODE_Log"), TXT("CODE_Length"), TXT("CODE_Equal"), TXT("CODE_NotEqual"), TXT("CODE_Label"),
+		TXT("CODE_Stop"), TXT("CODE_Sleep"), TXT("CODE_Wait"), TXT("CODE_Goto"), TXT("CODE_Interrupt"),
+		TXT("CODE_BaseMethod"), TXT("CODE_ComponentMethod"), TXT("CODE_ResourceMethod"),
+		TXT("CODE_CallMethod"), TXT("CODE_CallVF"), TXT("CODE_CallDelegate"), TXT("CODE_CallExtended"),
+		TXT("CODE_CallStatic"), TXT("CODE_VectorCnstr"), TXT("CODE_ConditionalOp"),
+		TXT("CODE_DelegateCnstr"), TXT("CAST_ByteToBool"), TXT("CAST_ByteToInteger"),
+		TXT("CAST_ByteToFloat"), TXT("CAST_ByteToString"), TXT("CAST_BoolToInteger"),
+		TXT("CAST_BoolToString"), TXT("CAST_IntegerToByte"), TXT("CAST_IntegerToBool"),
+		TXT("CAST_IntegerToFloat"), TXT("CAST_IntegerToAngle"), TXT("CAST_IntegerToColor"),
+		TXT("CAST_IntegerToString"), TXT("CAST_FloatToByte"), TXT("CAST_FloatToBool"),
+		TXT("CAST_FloatToInteger"), TXT("CAST_FloatToAngle"), TXT("CAST_FloatToString"),
+		TXT("CAST_AngleToInteger"), TXT("CAST_AngleToFloat"), TXT("CAST_AngleToString"),
+		TXT("CAST_AngleToVector"), TXT("CAST_ColorToInteger"), TXT("CAST_ColorToString"),
+		TXT("CAST_StringToByte"), TXT("CAST_StringToBool"), TXT("CAST_StringToInteger"),
+		TXT("CAST_StringToFloat"), TXT("CAST_VectorToBool"), TXT("CAST_VectorToAngle"),
+		TXT("CAST_VectorToString"), TXT("CAST_AabbToBool"), TXT("CAST_AabbToStrnig"),
+		TXT("CAST_ResourceToBool"), TXT("CAST_ResourceToString"), TXT("CAST_EntityToBool"),
+		TXT("CAST_EntityToString"), TXT("CAST_DelegateToBool"), TXT("CAST_DelegateToString"),
+		TXT("UN_Inc_Integer"), TXT("UN_Inc_Float"), TXT("UN_Dec_Integer"), TXT("UN_Dec_Float"),
+		TXT("UN_Plus_Integer"), TXT("UN_Plus_Float"), TXT("UN_Plus_Vector"), TXT("UN_Plus_Color"),
+		TXT("UN_Minus_Integer"), TXT("UN_Minus_Float"), TXT("UN_Minus_Vector"), TXT("UN_Minus_Color"),
+		TXT("UN_Not_Bool"), TXT("UN_Not_Integer"), TXT("BIN_Mult_Integer"), TXT("BIN_Mult_Float"),
+		TXT("BIN_Mult_Color"), TXT("BIN_Mult_Vector"), TXT("BIN_Div_Integer"), TXT("BIN_Div_Float"),
+		TXT("BIN_Mod_Integer"), TXT("BIN_Add_Integer"), TXT("BIN_Add_Float"), TXT("BIN_Add_Color"),
+		TXT("BIN_Add_String"), TXT("BIN_Add_Vector"), TXT("BIN_Sub_Integer"), TXT("BIN_Sub_Float"),
+		TXT("BIN_Sub_Color"), TXT("BIN_Sub_Vector"), TXT("BIN_Shr_Integer"), TXT("BIN_Shl_Integer"),
+		TXT("BIN_Less_Integer"), TXT("BIN_Less_Float"), TXT("BIN_LessEq_Integer"),
+		TXT("BIN_LessEq_Float"), TXT("BIN_Greater_Integer"), TXT("BIN_Greater_Float"),
+		TXT("BIN_GreaterEq_Integer"), TXT("BIN_GreaterEq_Float"), TXT("BIN_And_Integer"),
+		TXT("BIN_Xor_Integer"), TXT("BIN_Cross_Vector"), TXT("BIN_Or_Integer"), TXT("BIN_Dot_Vector"),
+		TXT("BIN_AddEqual_Integer"), TXT("BIN_AddEqual_Float"), TXT("BIN_AddEqual_Vector"),
+		TXT("BIN_AddEqual_String"), TXT("BIN_AddEqual_Color"), TXT("BIN_SubEqual_Integer"),
+		TXT("BIN_SubEqual_Float"), TXT("BIN_SubEqual_Vector"), TXT("BIN_SubEqual_Color"),
+		TXT("BIN_MulEqual_Integer"), TXT("BIN_MulEqual_Float"), TXT("BIN_MulEqual_Color"),
+		TXT("BIN_DivEqual_Integer"), TXT("BIN_DivEqual_Float"), TXT("BIN_ModEqual_Integer"),
+		TXT("BIN_ShlEqual_Integer"), TXT("BIN_ShrEqual_Integer"), TXT("BIN_AndEqual_Integer"),
+		TXT("BIN_XorEqual_Integer"), TXT("BIN_OrEqual_Integer"), TXT("OP_Abs"), TXT("OP_ArcTan"),
+		TXT("OP_ArcTan2"), TXT("OP_Cos"), TXT("OP_Sin"), TXT("OP_Sqrt"), TXT("OP_Distance"),
+		TXT("OP_Exp"), TXT("OP_Ln"), TXT("OP_Frac"), TXT("OP_Round"), TXT("OP_Normalize"),
+		TXT("OP_Random"), TXT("OP_RandomF"), TXT("OP_MinF"), TXT("OP_MaxF"), TXT("OP_ClampF"),
+		TXT("OP_VectorSize"), TXT("OP_RGBA"), TXT("OP_CharAt"), TXT("OP_IndexOf"), TXT("OP_Execute"),
+		TXT("OP_Now"), TXT("OP_PlaySoundFX"), TXT("OP_PlayMusic"), TXT("OP_KeyIsPressed"),
+		TXT("OP_GetScreenCursor"), TXT("OP_GetWorldCursor"), TXT("OP_Localize"), TXT("OP_GetScript"),
+		TXT("OP_StaticPush"), TXT("OP_StaticPop"), TXT("OP_TravelTo"), TXT("OP_FindEntity"),
+		TXT("OP_MatchKeyCombo"), TXT("IT_AllEntities"), TXT("IT_RectEntities"),
+		TXT("IT_TouchedEntities")
+	};
+
+	static_assert( arraySize( OPCODE_NAMES ) == IT_TouchedEntities + 1, "Opcodes names table is outdated" );
+	static_assert( arraySize( OPCODE_NAMES ) <= ScriptProfiler::OPCODES_COUNT, "Opcodes are not fit into byte" );
+
+	Bool ScriptProfiler::ms_enabled = false;
+
+	ScriptProfiler::ScriptProfiler()
+	{
+		mem::zero( m_opCounters, sizeof( m_opCounters ) );
+	}
+
+	ScriptProfiler::~ScriptProfiler()
+	{
+		ms_enabled = false;
+	}
+
+	ScriptProfiler& ScriptProfiler::instance()
+	{
+		static ScriptProfiler scriptProfiler;
+		return scriptProfiler;
+	}
+
+	void ScriptProfiler::enable()
+	{
+		if( !ms_enabled )
+		{
+			ms_enabled = true;
+			info( L"ScriptProfiler: Enabled" );
+		}
+	}
+
+	void ScriptProfiler::disable()
+	{
+		if( ms_enabled )
+		{
+			ms_enabled = false;
+			info( L"ScriptProfiler: Disabled" );
+		}
+	}
+
+	void ScriptProfiler::reset()
+	{
+		// keep entries, because their names may be referenced by the active profiler
+		for( auto& it : m_stats )
+		{
+			it.value.callsCount = 0;
+			it.value.instructionsCount = 0;
+			it.value.inclusiveCycles = 0;
+			it.value.exclusiveCycles = 0;
+			it.value.frameExclusiveCycles = 0;
+		}
+
+		mem::zero( m_opCounters, sizeof( m_opCounters ) );
+	}
+
+	void ScriptProfiler::forgetCode()
+	{
+		// registry keeps own copies of counters names, so entries may be dropped
+		assert( m_zonesStack.size() == 0 );
+		m_stats.empty();
+	}
+
+	void ScriptProfiler::enterCode( FScript* script, CBytecode* bytecode )
+	{
+		assert( script && bytecode );
+		assert( threading::isMainThread() );
+
+		if( !m_stats.hasKey( bytecode ) )
+		{
+			CodeStats codeStats;
+			codeStats.name = String::format( L"%s::%s", *script->GetName(), 
+				bytecode == script->Thread ? L"Thread" : *static_cast<CFunction*>( bytecode )->Name );
+
+			m_stats.put( bytecode, codeStats );
+		}
+
+		Zone zone;
+		zone.bytecode = bytecode;
+		zone.childrenCycles = 0;
+		zone.enterTimeStamp = time::cycles64();
+
+		m_zonesStack.push( zone );
+	}
+
+	void ScriptProfiler::leaveCode( UInt64 instructionsCount )
+	{
+		assert( m_zonesStack.size() > 0 );
+
+		Zone zone = m_zonesStack.pop();
+
+		const UInt64 inclusiveCycles = time::cycles64() - zone.enterTimeStamp;
+		const UInt64 exclusiveCycles = inclusiveCycles > zone.childrenCycles ? inclusiveCycles - zone.childrenCycles : 0;
+
+		CodeStats& codeStats = m_stats.getRef( zone.bytecode );
+		codeStats.callsCount++;
+		codeStats.instructionsCount += instructionsCount;
+		codeStats.inclusiveCycles += inclusiveCycles;
+		codeStats.exclusiveCycles += exclusiveCycles;
+		codeStats.frameExclusiveCycles += exclusiveCycles;
+
+		if( m_zonesStack.size() > 0 )
+		{
+			m_zonesStack.last().childrenCycles += inclusiveCycles;
+		}
+	}
+
+	void ScriptProfiler::flushFrame()
+	{
+		if( !ms_enabled )
+		{
+			return;
+		}
+
+		// report only the heaviest functions, the chart has no room for all of them
+		CodeStats* heaviest[MAX_CHART_FUNCTIONS] = {};
+
+		for( auto& it : m_stats )
+		{
+			if( it.value.frameExclusiveCycles == 0 )
+			{
+				continue;
+			}
+
+			CodeStats* candidate = &it.value;
+
+			for( SizeT i = 0; i < MAX_CHART_FUNCTIONS && candidate; ++i )
+			{
+				if( !heaviest[i] || heaviest[i]->frameExclusiveCycles < candidate->frameExclusiveCycles )
+				{
+					exchange( heaviest[i], candidate );
+				}
+			}
+		}
+
+		for( SizeT i = 0; i < MAX_CHART_FUNCTIONS && heaviest[i]; ++i )
+		{
+			CodeStats& stats = *heaviest[i];
+
+			// intern once, registry keeps own copy of the name. If registry
+			// is full, invalid id is kept and counter is skipped by profiler
+			if( stats.counterId == UNINTERNED_ZONE_ID )
+			{
+				stats.counterId = internZone( EGroup::Script, *stats.name );
+			}
+
+			getProfiler()->updateCounter( stats.counterId, time::cyclesToMs( stats.frameExclusiveCycles ) );
+		}
+
+		for( auto& it : m_stats )
+		{
+			it.value.frameExclusiveCycles = 0;
+		}
+	}
+
+	JSon::Ptr ScriptProfiler::saveToJSon() const
+	{
+		struct Helper
+		{
+			static Bool sortByExclusiveTime( const CodeStats& a, const CodeStats& b )
+			{
+				return a.exclusiveCycles > b.exclusiveCycles;
+			}
+
+			static JSon::Ptr createCounterNode( UInt64 value )
+			{
+				return JSon::createIntNode( static_cast<Int32>( min<UInt64>( value, MAX_INT32 ) ) );
+			}
+		};
+
+		JSon::Ptr result = JSon::createObjectNode();
+
+		// functions and threads
+		Array<CodeStats> sortedStats;
+
+		for( const auto& it : m_stats )
+		{
+			if( it.value.callsCount > 0 )
+			{
+				sortedStats.push( it.value );
+			}
+		}
+
+		sortedStats.sort( Helper::sortByExclusiveTime );
+		JSon::Ptr functionsNode = JSon::createArrayNode();
+
+		for( const auto& it : sortedStats )
+		{
+			JSon::Ptr functionNode = JSon::createObjectNode();
+
+			functionNode->addField( L"name", JSon::createStringNode( it.name ) );
+			functionNode->addField( L"calls", Helper::createCounterNode( it.callsCount ) );
+			functionNode->addField( L"instructions", Helper::createCounterNode( it.instructionsCount ) );
+			functionNode->addField( L"inclusiveMs", JSon::createFloatNode( time::cyclesToMs( it.inclusiveCycles ) ) );
+			functionNode->addField( L"exclusiveMs", JSon::createFloatNode( time::cyclesToMs( it.exclusiveCycles ) ) );
+
+			functionsNode->insertElement( functionNode );
+		}
+
+		result->addField( L"functions", functionsNode );
+
+		// opcodes histogram
+		JSon::Ptr opcodesNode = JSon::createArrayNode();
+
+		for( SizeT i = 0; i < arraySize( OPCODE_NAMES ); ++i )
+		{
+			if( m_opCounters[i] > 0 )
+			{
+				JSon::Ptr opcodeNode = JSon::createObjectNode();
+
+				opcodeNode->addField( L"name", JSon::createStringNode( OPCODE_NAMES[i] ) );
+				opcodeNode->addField( L"count", Helper::createCounterNode( m_opCounters[i] ) );
+
+				opcodesNode->insertElement( opcodeNode );
+			}
+		}
+
+		result->addField( L"opcodes", opcodesNode );
+
+		return result;
+	}
+
+	Bool ScriptProfiler::exportToFile( const Char* fileName ) const
+	{
+		String error;
+		Text::Ptr text = JSon::saveToText( saveToJSon(), &error );
+
+		if( !text )
+		{
+			warn( L"ScriptProfiler: Unable to export statistics with error \"%s\"", *error );
+			return false;
+		}
+
+		if( !fm::writeTextFile( fileName, text ) )
+		{
+			warn( L"ScriptProfiler: Unable to write file \"%s\"", fileName );
+			return false;
+		}
+
+		info( L"ScriptProfiler: Statistics exported to \"%s\"", fileName );
+		return true;
+	}
+
+} // namespace profile
+} // namespace flu
@@ -0,0 +1,129 @@
+//-----------------------------------------------------------------------------
+//	ScriptProfiler.h: FluScript virtual machine profiler
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+namespace profile
+{
+	/**
+	 *	A FluScript VM profiler. Gathers calls count, inclusive and exclusive
+	 *	time and executed instructions per each function or thread,
+	 *	and an opcodes histogram. Idle until enabled
+	 */
+	class ScriptProfiler final: public NonCopyable
+	{
+	public:
+		static const SizeT OPCODES_COUNT = 256;
+		static const SizeT MAX_CHART_FUNCTIONS = 8;
+
+		struct CodeStats
+		{
+			String name;
+			UInt64 callsCount = 0;
+			UInt64 instructionsCount = 0;
+			UInt64 inclusiveCycles = 0;
+			UInt64 exclusiveCycles = 0;
+			UInt64 frameExclusiveCycles = 0;
+			ZoneId counterId = UNINTERNED_ZONE_ID;
+		};
+
+		using Stats = Map<const CBytecode*, CodeStats>;
+
+		/**
+		 *	A profiling scope of the single code execution
+		 */
+		class Scope final
+		{
+		public:
+			Scope( FScript* script, CBytecode* bytecode )
+				:	m_profiler( nullptr ),
+					m_instructionsCount( 0 )
+			{
+				if( ms_enabled )
+				{
+					m_profiler = &ScriptProfiler::instance();
+					m_profiler->enterCode( script, bytecode );
+				}
+			}
+
+			~Scope()
+			{
+				if( m_profiler )
+				{
+					m_profiler->leaveCode( m_instructionsCount );
+				}
+			}
+
+			/**
+			 *	Return opcodes histogram to fill or nullptr, if profiler is disabled
+			 */
+			UInt64* opCounters() const
+			{
+				return m_profiler ? m_profiler->m_opCounters : nullptr;
+			}
+
+			void countInstruction()
+			{
+				m_instructionsCount++;
+			}
+
+		private:
+			ScriptProfiler* m_profiler;
+			UInt64 m_instructionsCount;
+
+			Scope() = delete;
+			Scope( const Scope& ) = delete;
+		};
+
+		static ScriptProfiler& instance();
+
+		void enable();
+		void disable();
+		void reset();
+
+		/**
+		 *	Drop stats of all the code. Stats are keyed by bytecode, so it
+		 *	should be called whenever scripts are recompiled or destroyed
+		 */
+		void forgetCode();
+
+		Bool isEnabled() const
+		{
+			return ms_enabled;
+		}
+
+		void flushFrame();
+
+		JSon::Ptr saveToJSon() const;
+		Bool exportToFile( const Char* fileName ) const;
+
+		const Stats& getStats() const
+		{
+			return m_stats;
+		}
+
+	private:
+		struct Zone
+		{
+			const CBytecode* bytecode = nullptr;
+			UInt64 enterTimeStamp = 0;
+			UInt64 childrenCycles = 0;
+		};
+
+		static Bool ms_enabled;
+
+		Stats m_stats;
+		Array<Zone> m_zonesStack;
+		UInt64 m_opCounters[OPCODES_COUNT];
+
+		ScriptProfiler();
+		~ScriptProfiler();
+
+		void enterCode( FScript* script, CBytecode* bytecode );
+		void leaveCode( UInt64 instructionsCount );
+	};
+
+} // namespace profile
+} // namespace flu
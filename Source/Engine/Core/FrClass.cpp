@@ -143,7 +143,7 @@ CClass::~CClass()
 //
 void CClass::AddProperty( CProperty* InProp )
 {
-	assert(FindProperty(*InProp->Name) == nullptr);
+	assert(FindProperty(InProp->InternedName) == nullptr);
 	Properties.push( InProp );
 }
 
@@ -153,7 +153,7 @@ void CClass::AddProperty( CProperty* InProp )
 //
 void CClass::AddMethod( CNativeFunction* InMeth )
 {
-	assert(FindMethod(*InMeth->Name) == nullptr);
+	assert(FindMethod(InMeth->InternedName) == nullptr);
 	Methods.push( InMeth );
 }
 
@@ -163,9 +163,20 @@ void CClass::AddMethod( CNativeFunction* InMeth )
 // found return null.
 //
 CProperty* CClass::FindProperty( const Char* InName ) const
+{
+	// Never interned name is never used by any property.
+	NameId Interned = NameId::find( InName );
+	return Interned ? FindProperty( Interned ) : nullptr;
+}
+
+
+//
+// Find a property by interned name.
+//
+CProperty* CClass::FindProperty( NameId InName ) const
 {
 	for( Int32 iProp=0; iProp<Properties.size(); iProp++ )
-		if( Properties[iProp]->Name == InName )
+		if( Properties[iProp]->InternedName == InName )
 			return Properties[iProp];
 
 	// Property not found, but maybe it in the super class.
@@ -178,9 +189,19 @@ CProperty* CClass::FindProperty( const Char* InName ) const
 // found return null.
 //
 CNativeFunction* CClass::FindMethod( const Char* InName ) const
+{
+	NameId Interned = NameId::find( InName );
+	return Interned ? FindMethod( Interned ) : nullptr;
+}
+
+
+//
+// Find a method by interned name.
+//
+CNativeFunction* CClass::FindMethod( NameId InName ) const
 {
 	for( Int32 iMeth=0; iMeth<Methods.size(); iMeth++ )
-		if( Methods[iMeth]->Name == InName )
+		if( Methods[iMeth]->InternedName == InName )
 			return Methods[iMeth];
 
 	// Method not found, but maybe it in the super class.
@@ -212,6 +233,7 @@ Bool CClass::IsA( CClass* SomeClass )
 CNativeFunction::CNativeFunction( const Char* InName, UInt32 InFlags, Int32 InOpCode )
 	:	Flags( InFlags ),
 		Name( InName ),
+		InternedName( InName ),
 		Class( nullptr ),
 		iOpCode( InOpCode ),
 		NumParams( 0 ),
@@ -223,7 +245,7 @@ CNativeFunction::CNativeFunction( const Char* InName, UInt32 InFlags, Int32 InOp
 		{
 			CNativeFunction* Other = CClassDatabase::GFuncs[i];
 
-			if( Class == Other->Class && Name == Other->Name )
+			if( Class == Other->Class && InternedName == Other->InternedName )
 				fatal( L"Function \"%s\" redeclarated", *Name );
 		}
 }
@@ -235,6 +257,7 @@ CNativeFunction::CNativeFunction( const Char* InName, UInt32 InFlags, Int32 InOp
 CNativeFunction::CNativeFunction( const Char* InName, UInt32 InFlags, TNativeFunction InFunction )
 	:	Flags( InFlags ),
 		Name( InName ),
+		InternedName( InName ),
 		Class( nullptr ),
 		ptrFunction( InFunction ),
 		NumParams( 0 ),
@@ -246,7 +269,7 @@ CNativeFunction::CNativeFunction( const Char* InName, UInt32 InFlags, TNativeFun
 	{
 		CNativeFunction* Other = CClassDatabase::GFuncs[i];
 
-		if( Class == Other->Class && Name == Other->Name )
+		if( Class == Other->Class && InternedName == Other->InternedName )
 			fatal( L"Function \"%s\" redeclarated", *Name );
 	}
 }
@@ -258,6 +281,7 @@ CNativeFunction::CNativeFunction( const Char* InName, UInt32 InFlags, TNativeFun
 CNativeFunction::CNativeFunction( const Char* InName, CClass* InClass, TNativeMethod InMethod )
 	:	Flags( NFUN_Method ),
 		Name( InName ),
+		InternedName( InName ),
 		Class( InClass ),
 		NumParams( 0 ),
 		Priority( 0 ),
@@ -266,7 +290,7 @@ CNativeFunction::CNativeFunction( const Char* InName, CClass* InClass, TNativeMe
 	// Horrible tests.
 	assert(Class);
 	assert(Class->IsA(FComponent::MetaClass) || Class->IsA(FResource::MetaClass));
-	if( Class->FindMethod(*Name) )
+	if( Class->FindMethod(InternedName) )
 		fatal( L"Method \"%s\" redeclarated in class \"%s\"", *Name, *Class->GetAltName() );
 }
 
@@ -434,9 +458,19 @@ CStruct::~CStruct()
 // Find member.
 //
 CProperty* CStruct::FindMember( const Char* InName ) const
+{
+	NameId Interned = NameId::find( InName );
+	return Interned ? FindMember( Interned ) : nullptr;
+}
+
+
+//
+// Find member by interned name.
+//
+CProperty* CStruct::FindMember( NameId InName ) const
 {
 	for( Int32 i=0; i<Members.size(); i++ )
-		if( Members[i]->Name == InName )
+		if( Members[i]->InternedName == InName )
 			return Members[i];
 	return nullptr;
 }
@@ -563,6 +597,7 @@ CProperty::CProperty
 )
 	:	CTypeInfo( PropType, InArrDim, InInner ),
 		Name( InName ),
+		InternedName( InName ),
 		Flags( PROP_Native | InFlags ),
 		Offset( InOffset )
 {
@@ -575,6 +610,7 @@ CProperty::CProperty
 CProperty::CProperty( CTypeInfo InType, String InName, UInt32 InFlags, SizeT InOffset )
 	:	CTypeInfo( InType ),
 		Name( InName ),
+		InternedName( InName ),
 		Flags( InFlags ),
 		Offset( InOffset )
 {
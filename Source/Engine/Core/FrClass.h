@@ -145,6 +145,7 @@ class CProperty: public CTypeInfo
 public:
 	// Variables.
 	String		Name;
+	NameId		InternedName;
 	UInt32		Flags;
 	SizeT		Offset;
 
@@ -213,6 +214,7 @@ public:
 	// CStruct interface.
 	~CStruct();
 	CProperty* FindMember( const Char* InName ) const;
+	CProperty* FindMember( NameId InName ) const;
 	void CopyValues( void* Dst, const void* Src ) const;
 	void DestroyValues( void* Addr ) const;
 	void SerializeValues( void* Addr, CSerializer& S ) const;
@@ -305,6 +307,7 @@ public:
 	// Variables.
 	UInt32			Flags;
 	String			Name;
+	NameId			InternedName;
 	CClass*			Class;		// Class this method being or null.
 	CTypeInfo		ResultType;
 	TParameter		Params[MAX_PARAMETERS];
@@ -379,7 +382,9 @@ public:
 	void AddProperty( CProperty* InProp );
 	void AddMethod( CNativeFunction* InMeth );
 	CProperty* FindProperty( const Char* InName ) const;
+	CProperty* FindProperty( NameId InName ) const;
 	CNativeFunction* FindMethod( const Char* InName ) const;
+	CNativeFunction* FindMethod( NameId InName ) const;
 	Bool IsA( CClass* SomeClass );
 
 	// Utils.
@@ -331,6 +331,237 @@ SizeT CLZWCompressor::ForecastSize( const void* InBuffer, SizeT InSize )
 }
 
 
+/*-----------------------------------------------------------------------------
+    CLZCompressor.
+-----------------------------------------------------------------------------*/
+
+//
+// LZ constants. Stream is a header with source size and
+// size of each frame, followed by frames data. Frames are
+// independent from each other and compressed with lz codec.
+//
+#define LZ_FRAME_SIZE		(64*1024)
+#define LZ_FRAME_STORED		0x80000000
+#define LZ_SAMPLE_FRAMES	4
+#define LZ_MAX_TASKS		32
+
+
+//
+// A frame to decode.
+//
+struct TLZFrame
+{
+public:
+	const UInt8*	Src;
+	SizeT			SrcSize;
+	UInt8*			Dst;
+	SizeT			DstSize;
+	Bool			bStored;
+};
+
+
+//
+// Frames to decode in the jobs.
+//
+struct TLZDecodeContext
+{
+public:
+	TLZFrame*			Frames;
+	concurrency::Atomic	NumFailed;
+};
+
+
+//
+// Decode a range of frames.
+//
+static void LZDecodeTask( void* Data, Int32 iTask, Int32 First, Int32 Last )
+{
+	TLZDecodeContext* Context	= (TLZDecodeContext*)Data;
+	Bool bSuccess				= true;
+
+	for( Int32 i=First; i<Last && bSuccess; i++ )
+	{
+		TLZFrame& Frame = Context->Frames[i];
+
+		if( Frame.bStored )
+		{
+			if( Frame.SrcSize == Frame.DstSize )
+				mem::copy( Frame.Dst, Frame.Src, Frame.DstSize );
+			else
+				bSuccess	= false;
+		}
+		else
+		{
+			bSuccess	= lz::decompress( Frame.Src, Frame.SrcSize, Frame.Dst, Frame.DstSize );
+		}
+	}
+
+	if( !bSuccess )
+		Context->NumFailed.increment();
+}
+
+
+//
+// LZ constructor.
+//
+CLZCompressor::CLZCompressor( Bool bInHighRatio )
+	:	bHighRatio( bInHighRatio )
+{
+}
+
+
+//
+// Encode data using LZ compression.
+//
+void CLZCompressor::Encode( const void* InBuffer, SizeT InSize, void*& OutBuffer, SizeT& OutSize )
+{
+	UInt32	NumFrames	= UInt32( ( InSize + LZ_FRAME_SIZE - 1 ) / LZ_FRAME_SIZE );
+	SizeT	HeaderSize	= sizeof(UInt32) * ( 2 + NumFrames );
+
+	// Allocate out buffer for the worst case, frames are never
+	// larger than source, since incompressible ones are stored.
+	OutBuffer	= mem::alloc( HeaderSize + InSize );
+
+	const UInt8*	In		= (const UInt8*)InBuffer;
+	UInt8*			Out		= (UInt8*)OutBuffer;
+	UInt32*			Header	= (UInt32*)Out;
+	UInt8*			Op		= Out + HeaderSize;
+
+	Header[0]	= UInt32( InSize );
+	Header[1]	= NumFrames;
+
+	for( UInt32 iFrame=0; iFrame<NumFrames; iFrame++ )
+	{
+		SizeT Offset	= SizeT( iFrame ) * LZ_FRAME_SIZE;
+		SizeT FrameSize	= min<SizeT>( LZ_FRAME_SIZE, InSize - Offset );
+		SizeT ComSize	= lz::compress( In + Offset, FrameSize, Op, FrameSize - 1, bHighRatio );
+
+		if( ComSize == 0 )
+		{
+			// Incompressible frame, store it as is.
+			mem::copy( Op, In + Offset, FrameSize );
+			Header[2 + iFrame]	= UInt32( FrameSize ) | LZ_FRAME_STORED;
+			Op	+= FrameSize;
+		}
+		else
+		{
+			Header[2 + iFrame]	= UInt32( ComSize );
+			Op	+= ComSize;
+		}
+	}
+
+	// Set out buffer length.
+	OutSize		= (SizeT)( Op - Out );
+	OutBuffer	= mem::realloc( OutBuffer, OutSize );
+}
+
+
+//
+// Decode LZ compressed data. Frames are decoded
+// in parallel, if job system is available.
+//
+void CLZCompressor::Decode( const void* InBuffer, SizeT InSize, void*& OutBuffer, SizeT& OutSize )
+{
+	const UInt8*	In		= (const UInt8*)InBuffer;
+	const UInt32*	Header	= (const UInt32*)In;
+
+	// Validate header, frames count should match the source size.
+	if( InSize < sizeof(UInt32) * 2 )
+		fatal( L"LZ: Compressed data is corrupted" );
+
+	UInt32	NumFrames	= Header[1];
+	SizeT	HeaderSize	= sizeof(UInt32) * ( 2 + SizeT( NumFrames ) );
+
+	if( NumFrames != UInt32( ( SizeT( Header[0] ) + LZ_FRAME_SIZE - 1 ) / LZ_FRAME_SIZE ) || HeaderSize > InSize )
+		fatal( L"LZ: Compressed data is corrupted" );
+
+	// Validate frames table, before anything is allocated.
+	SizeT DataSize = 0;
+
+	for( UInt32 iFrame=0; iFrame<NumFrames; iFrame++ )
+	{
+		UInt32 Info		= Header[2 + iFrame];
+		SizeT SrcSize	= Info & ~LZ_FRAME_STORED;
+
+		if( SrcSize == 0 || SrcSize > InSize - HeaderSize - DataSize )
+			fatal( L"LZ: Compressed data is corrupted" );
+
+		DataSize	+= SrcSize;
+	}
+
+	if( HeaderSize + DataSize != InSize )
+		fatal( L"LZ: Compressed data is corrupted" );
+
+	OutSize		= Header[0];
+	OutBuffer	= mem::alloc( OutSize );
+
+	// Prepare frames, each frame is decoded exactly to its size.
+	Array<TLZFrame> Frames( NumFrames );
+	{
+		const UInt8*	Ip	= In + HeaderSize;
+		UInt8*			Op	= (UInt8*)OutBuffer;
+
+		for( UInt32 iFrame=0; iFrame<NumFrames; iFrame++ )
+		{
+			TLZFrame& Frame	= Frames[iFrame];
+			UInt32 Info		= Header[2 + iFrame];
+
+			Frame.bStored	= ( Info & LZ_FRAME_STORED ) != 0;
+			Frame.Src		= Ip;
+			Frame.SrcSize	= Info & ~LZ_FRAME_STORED;
+			Frame.Dst		= Op;
+			Frame.DstSize	= min<SizeT>( LZ_FRAME_SIZE, OutSize - SizeT( iFrame ) * LZ_FRAME_SIZE );
+
+			Ip	+= Frame.SrcSize;
+			Op	+= Frame.DstSize;
+		}
+	}
+
+	// Split frames into tasks, small data is decoded in place.
+	TLZDecodeContext Context;
+	Context.Frames	= NumFrames ? &Frames[0] : nullptr;
+
+	job::parallelFor( NumFrames, 1, NumFrames >= LZ_SAMPLE_FRAMES ? LZ_MAX_TASKS : 1, LZDecodeTask, &Context );
+
+	if( Context.NumFailed.getValue() != 0 )
+		fatal( L"LZ: Compressed data is corrupted" );
+}
+
+
+//
+// Forecast the size of the source data after a LZ
+// compression. Only a few sample frames are compressed
+// for large data.
+//
+SizeT CLZCompressor::ForecastSize( const void* InBuffer, SizeT InSize )
+{
+	const UInt8* In		= (const UInt8*)InBuffer;
+	UInt32 NumFrames	= UInt32( ( InSize + LZ_FRAME_SIZE - 1 ) / LZ_FRAME_SIZE );
+	UInt32 NumSamples	= min<UInt32>( NumFrames, LZ_SAMPLE_FRAMES );
+
+	if( NumSamples == 0 )
+		return sizeof(UInt32) * 2;
+
+	UInt8* Buffer	= (UInt8*)mem::alloc( lz::compressBound( LZ_FRAME_SIZE ) );
+
+	SizeT SampledSize = 0, SampledComSize = 0;
+	for( UInt32 i=0; i<NumSamples; i++ )
+	{
+		SizeT Offset	= SizeT( i * NumFrames / NumSamples ) * LZ_FRAME_SIZE;
+		SizeT FrameSize	= min<SizeT>( LZ_FRAME_SIZE, InSize - Offset );
+		SizeT ComSize	= lz::compress( In + Offset, FrameSize, Buffer, FrameSize - 1, bHighRatio );
+
+		SampledSize		+= FrameSize;
+		SampledComSize	+= ComSize != 0 ? ComSize : FrameSize;
+	}
+
+	mem::free( Buffer );
+
+	// Extrapolate to the entire data.
+	return sizeof(UInt32) * ( 2 + NumFrames ) + SizeT( Double( InSize ) * SampledComSize / SampledSize );
+}
+
+
 /*-----------------------------------------------------------------------------
     CFutileCompressor.
 -----------------------------------------------------------------------------*/
@@ -27,7 +27,7 @@ public:
 //
 // Run-Length-Encoding compressor.
 //
-class CRLECompressor
+class CRLECompressor: public CCompressor
 {
 public:
 	// CCompressor interface.
@@ -45,7 +45,7 @@ public:
 //
 // Lempel-Ziv-Welch compressor.
 //
-class CLZWCompressor
+class CLZWCompressor: public CCompressor
 {
 public:
 	// CCompressor interface.
@@ -56,6 +56,29 @@ public:
 };
 
 
+/*-----------------------------------------------------------------------------
+    CLZCompressor.
+-----------------------------------------------------------------------------*/
+
+//
+// A fast LZ77-family compressor. Data is split into
+// independent frames, which are decoded in parallel.
+// High ratio mode is slower for encoding only.
+//
+class CLZCompressor: public CCompressor
+{
+public:
+	// CCompressor interface.
+	CLZCompressor( Bool bInHighRatio = false );
+	void Encode( const void* InBuffer, SizeT InSize, void*& OutBuffer, SizeT& OutSize );
+	void Decode( const void* InBuffer, SizeT InSize, void*& OutBuffer, SizeT& OutSize );
+	SizeT ForecastSize( const void* InBuffer, SizeT InSize );
+
+private:
+	Bool		bHighRatio;
+};
+
+
 /*-----------------------------------------------------------------------------
     CFutileCompressor.
 -----------------------------------------------------------------------------*/
@@ -63,7 +86,7 @@ public:
 //
 // A futile compressor for testing and research.
 //
-class CFutileCompressor
+class CFutileCompressor: public CCompressor
 {
 public:
 	// CCompressor interface.
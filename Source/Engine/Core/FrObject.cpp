@@ -23,6 +23,7 @@ FObject::FObject()
 	:	Id( -1 ),
 		Class( FObject::MetaClass ),
 		Name(),
+		InternedName(),
 		Owner( nullptr ),
 		HashNext( nullptr )
 {
@@ -334,7 +335,9 @@ FObject* CObjectDatabase::CreateObject( CClass* InCls, String InName, FObject* I
 //
 void CObjectDatabase::HashObject( FObject* Obj )
 {
-	Int32 iHash	= 2047 & Obj->GetName().hashCode();
+	Obj->InternedName	= NameId( Obj->Name );
+
+	Int32 iHash	= 2047 & Obj->InternedName.hashCode();
 	Obj->HashNext	= GHash[iHash];
 	GHash[iHash]	= Obj;
 }
@@ -345,7 +348,7 @@ void CObjectDatabase::HashObject( FObject* Obj )
 //
 void CObjectDatabase::UnhashObject( FObject* Obj )
 {
-	Int32 iHash	= 2047 & Obj->GetName().hashCode();
+	Int32 iHash	= 2047 & Obj->InternedName.hashCode();
 	FObject** Link	= &GHash[iHash];
 	while( *Link )
 	{
@@ -381,10 +384,21 @@ void CObjectDatabase::RenameObject( FObject* Obj, String NewName )
 
 
 //
-// Find the object in object's table, really SLOW, so try to call it very
-// seldom.
+// Find the object in object's table. Names are interned,
+// so the name is never compared char by char.
 //
 FObject* CObjectDatabase::FindObject( String InName, CClass* InCls, FObject* InOwner )
+{ 
+	// If the name was never interned, there is no such object.
+	NameId Interned = NameId::find( *InName );
+	return Interned ? FindObject( Interned, InCls, InOwner ) : nullptr;
+}
+
+
+//
+// Find the object by interned name.
+//
+FObject* CObjectDatabase::FindObject( NameId InName, CClass* InCls, FObject* InOwner )
 { 
 	assert(InCls);
 
@@ -396,9 +410,9 @@ FObject* CObjectDatabase::FindObject( String InName, CClass* InCls, FObject* InO
 
 		while( Obj )
 		{
-			if	(	Obj->IsOwnedBy(InOwner) &&
-					Obj->IsA(InCls) &&
-					Obj->GetName() == InName
+			if	(	Obj->InternedName == InName &&
+					Obj->IsOwnedBy(InOwner) &&
+					Obj->IsA(InCls)
 				)
 					return Obj;
 
@@ -413,8 +427,8 @@ FObject* CObjectDatabase::FindObject( String InName, CClass* InCls, FObject* InO
 
 		while( Obj )
 		{
-			if	(	Obj->IsA(InCls) &&
-					Obj->GetName() == InName
+			if	(	Obj->InternedName == InName &&
+					Obj->IsA(InCls)
 				)
 					return Obj;
 
@@ -18,6 +18,7 @@ protected:
 	Int32		Id;
 	CClass*		Class;
 	String		Name;
+	NameId		InternedName;
 	FObject*	Owner;
 	FObject*	HashNext;
 
@@ -39,6 +40,10 @@ public:
 	{
 		return Name;
 	}
+	inline NameId GetNameId()
+	{
+		return InternedName;
+	}
 	inline CClass* GetClass()
 	{
 		return Class;
@@ -59,6 +64,7 @@ public:
 	// Friendly classes.
 	friend class CObjectDatabase;
 	friend class CApplication;
+	friend class CProject;
 };
 
 
@@ -85,6 +91,7 @@ public:
 	// CObjectDatabase interface.
 	FObject* CreateObject( CClass* InCls, String InName, FObject* InOwner = nullptr );
 	FObject* FindObject( String InName, CClass* InCls = FObject::MetaClass, FObject* InOwner = nullptr );
+	FObject* FindObject( NameId InName, CClass* InCls = FObject::MetaClass, FObject* InOwner = nullptr );
 	FObject* CopyObject( FObject* Source, String CopyName = L"", FObject* NewOwner = nullptr );
 	String MakeName( CClass* InClass, FObject* InOwner = nullptr );
 	void DestroyObject( FObject* InObj, Bool bReleaseRefs = false );
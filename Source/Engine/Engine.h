@@ -38,7 +38,9 @@ class FObject;
 		class FMaterialLayer;
 class CCanvas;
 class CBlockManager;
+class CLevelSnapshot;
 class CInstanceBuffer;
+class CBytecode;
 class CFrame;
 class CThreadFrame;
 class CCollisionHash;
@@ -91,6 +93,7 @@ namespace envi
 #include "Rendering/GridDrawer.h"
 #include "Rendering/TextDrawer.h"
 #include "Rendering/PrimitiveDrawer.h"
+#include "Rendering/ParticleDrawer.h"
 
 #include "RenderPipeline/SharedConstants.h"
 #include "RenderPipeline/DrawContext.h"
@@ -98,6 +101,7 @@ namespace envi
 
 // Profiling
 #include "Chart/EngineProfiler.h"
+#include "Chart/ScriptProfiler.h"
 #include "Chart/EngineChart.h"
 
 // Environment
@@ -140,6 +144,7 @@ namespace envi
 #include "FrGFX.h"
 #include "FrInput.h"
 #include "FrLevel.h"
+#include "FrSnapshot.h"
 #include "FrCollHash.h"
 #include "FrProject.h"
 #include "FrApp.h"
@@ -57,6 +57,11 @@ namespace envi
 		rr.TexCoords.min = { 0.f, 0.f };
 		rr.TexCoords.max = { 1.f, 1.f };
 
+		if( m_bitmap && m_bitmap->m_image->isAtlasRegion() )
+		{
+			rr.TexCoords = m_bitmap->m_image->mapTexCoords( rr.TexCoords );
+		}
+
 		canvas->DrawRect( rr );*/
 	}
 
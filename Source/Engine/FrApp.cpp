@@ -110,24 +110,11 @@ public:
 
 
 //
-// An Information relative to Flu object.
+// Game file control values. Legacy files have no
+// level chunks and are loaded entirely.
 //
-struct TObjectHeader
-{
-public:
-	Int32		Id;
-	String		Name;
-	UInt16		iClass;
-	Int32		iOwner;
-
-	friend void Serialize( CSerializer& S, TObjectHeader& V )
-	{
-		Serialize( S, V.Id );
-		Serialize( S, V.Name );
-		Serialize( S, V.iClass );
-		Serialize( S, V.iOwner );
-	}
-};
+#define GAME_FILE_CONTROL_LEGACY	2528
+#define GAME_FILE_CONTROL			2529
 
 
 //
@@ -143,6 +130,69 @@ Int32 GetClassIndex( CClass* Class )
 }
 
 
+//
+// Make a header for the object.
+//
+static TObjectHeader MakeObjectHeader( FObject* Object )
+{
+	TObjectHeader Header;
+	Header.Id		= Object->GetId();
+	Header.Name		= Object->GetName();
+	Header.iClass	= GetClassIndex(Object->GetClass());
+	Header.iOwner	= Object->GetOwner() ? Object->GetOwner()->GetId() : -1;
+	return Header;
+}
+
+
+//
+// Return level which owns an object, or nullptr
+// if object is shared.
+//
+static FLevel* GetOwnerLevel( FObject* Object )
+{
+	for( FObject* Owner = Object->GetOwner(); Owner; Owner = Owner->GetOwner() )
+		if( Owner->IsA(FLevel::MetaClass) )
+			return (FLevel*)Owner;
+
+	return nullptr;
+}
+
+
+//
+// CChunkRefsValidator - serializer to detect
+// references from the objects into the foreign
+// level chunk, such refs will be lost, while
+// chunk is unloaded.
+//
+class CChunkRefsValidator: public CSerializer
+{
+public:
+	// Variables.
+	const Array<Int32>&		ChunkOf;
+	Int32					iChunk;
+	FObject*				Referrer;
+
+	// CChunkRefsValidator interface.
+	CChunkRefsValidator( const Array<Int32>& InChunkOf )
+		:	ChunkOf( InChunkOf ),
+			iChunk( -1 ),
+			Referrer( nullptr )
+	{
+		Mode	= SM_Undefined;
+	}
+
+	// CSerializer interface.
+	void SerializeData( void* Mem, SizeT Count )
+	{}
+	void SerializeRef( FObject*& Obj )
+	{
+		if( Obj && ChunkOf[Obj->GetId()] != -1 && ChunkOf[Obj->GetId()] != iChunk )
+			warn( L"Game: Object '%s' refers to the '%s' from the foreign level", 
+				*Referrer->GetFullName(), *Obj->GetFullName() );
+	}
+};
+
+
 //
 // Save entire game to file and
 // entire resources. Warning Name should be without
@@ -162,7 +212,7 @@ Bool CApplication::SaveGame( String Directory, String Name )
 	// Save general file information.
 	{
 		TGameFileInfo	Info;
-		Info.Control	= 2528;
+		Info.Control	= GAME_FILE_CONTROL;
 		Info.EngineVer	= FLU_VERSION;
 		Serialize( Saver, Info );
 	}
@@ -179,29 +229,77 @@ Bool CApplication::SaveGame( String Directory, String Name )
 		}
 	}
 
-	// Save global objects database info.
+	// Split database into shared objects and level chunks. Levels
+	// itself are shared, but their content goes to chunk.
+	Array<TLevelChunk> Chunks;
+	Array<Int32> ChunkOf( Project->GObjects.size() );
+	{
+		for( Int32 i=0; i<Project->GObjects.size(); i++ )
+		{
+			ChunkOf[i] = -1;
+
+			if( Project->GObjects[i] && Project->GObjects[i]->IsA(FLevel::MetaClass) )
+			{
+				TLevelChunk Chunk;
+				Chunk.iLevel = i;
+				Chunks.push( Chunk );
+			}
+		}
+
+		Array<Int32> LevelChunk( Project->GObjects.size() );
+		for( Int32 i=0; i<Project->GObjects.size(); i++ )
+			LevelChunk[i] = -1;
+		for( Int32 iChunk=0; iChunk<Chunks.size(); iChunk++ )
+			LevelChunk[Chunks[iChunk].iLevel] = iChunk;
+
+		for( Int32 i=0; i<Project->GObjects.size(); i++ )
+			if( Project->GObjects[i] )
+			{
+				FLevel* Level = GetOwnerLevel( Project->GObjects[i] );
+				if( Level )
+				{
+					ChunkOf[i] = LevelChunk[Level->GetId()];
+					Chunks[ChunkOf[i]].ObjectIds.push( i );
+				}
+			}
+	}
+
+	// Warn about references into the foreign chunks.
+	{
+		CChunkRefsValidator Validator( ChunkOf );
+		for( Int32 i=0; i<Project->GObjects.size(); i++ )
+			if( Project->GObjects[i] )
+			{
+				Validator.Referrer	= Project->GObjects[i];
+				Validator.iChunk	= ChunkOf[i];
+
+				// Level's content is stored in its own chunk.
+				if( Project->GObjects[i]->IsA(FLevel::MetaClass) )
+					for( Int32 iChunk=0; iChunk<Chunks.size(); iChunk++ )
+						if( Chunks[iChunk].iLevel == i )
+							Validator.iChunk = iChunk;
+
+				Project->GObjects[i]->SerializeThis( Validator );
+			}
+	}
+
+	// Save shared objects database info.
 	{
 		Int32 DbSize = Project->GObjects.size();
 		Serialize( Saver, DbSize );
 
-		// Count how much non-null objects.
+		// Count how much shared non-null objects.
 		Int32 DbRealSize = 0;
 		for( Int32 i=0; i<Project->GObjects.size(); i++ )
-			if( Project->GObjects[i] )
+			if( Project->GObjects[i] && ChunkOf[i] == -1 )
 				DbRealSize++;
 		Serialize( Saver, DbRealSize );
 
-		// List of non-null object headers.
+		// List of shared object headers.
 		for( Int32 i=0; i<Project->GObjects.size(); i++ )
-			if( Project->GObjects[i] )
+			if( Project->GObjects[i] && ChunkOf[i] == -1 )
 			{
-				TObjectHeader Header;
-				FObject* Object = Project->GObjects[i];
-
-				Header.Id			= Object->GetId();
-				Header.Name			= Object->GetName();
-				Header.iClass		= GetClassIndex(Object->GetClass());
-				Header.iOwner		= Object->GetOwner() ? Object->GetOwner()->GetId() : -1;
+				TObjectHeader Header = MakeObjectHeader( Project->GObjects[i] );
 				Serialize( Saver, Header );
 			}
 	}
@@ -211,14 +309,47 @@ Bool CApplication::SaveGame( String Directory, String Name )
 		if( Project->GObjects[i] && Project->GObjects[i]->IsA(FScript::MetaClass) )
 			Project->GObjects[i]->SerializeThis( Saver );
 
-	// Save content of each object, without scripts.
+	// Save content of each shared object, without scripts and levels.
 	for( Int32 i=0; i<Project->GObjects.size(); i++ )
-		if( Project->GObjects[i] && !Project->GObjects[i]->IsA(FScript::MetaClass) )
-			Project->GObjects[i]->SerializeThis( Saver );
+		if( Project->GObjects[i] && ChunkOf[i] == -1 && 
+			!Project->GObjects[i]->IsA(FScript::MetaClass) &&
+			!Project->GObjects[i]->IsA(FLevel::MetaClass) )
+				Project->GObjects[i]->SerializeThis( Saver );
 
 	// Save all project stuff.
 	Project->SerializeProject( Saver );
 
+	// Save each level chunk: headers of level's objects,
+	// level content and objects content.
+	for( Int32 iChunk=0; iChunk<Chunks.size(); iChunk++ )
+	{
+		TLevelChunk& Chunk = Chunks[iChunk];
+		Chunk.Offset = UInt32( Saver.Tell() );
+
+		Int32 NumObjects = Chunk.ObjectIds.size();
+		Serialize( Saver, NumObjects );
+
+		for( Int32 i=0; i<Chunk.ObjectIds.size(); i++ )
+		{
+			TObjectHeader Header = MakeObjectHeader( Project->GObjects[Chunk.ObjectIds[i]] );
+			Serialize( Saver, Header );
+		}
+
+		Project->GObjects[Chunk.iLevel]->SerializeThis( Saver );
+
+		for( Int32 i=0; i<Chunk.ObjectIds.size(); i++ )
+			Project->GObjects[Chunk.ObjectIds[i]]->SerializeThis( Saver );
+
+		Chunk.Size = UInt32( Saver.Tell() ) - Chunk.Offset;
+	}
+
+	// Save chunks table, it's offset stored at the end of file.
+	{
+		UInt32 TableOffset = UInt32( Saver.Tell() );
+		Serialize( Saver, Chunks );
+		Serialize( Saver, TableOffset );
+	}
+
 	// Save all resources to the other file.
 	String ResFile = Name + RES_FILE_EXT;
 	Project->BlockMan->SaveAllBlocks(RealDir+ResFile);
@@ -229,12 +360,16 @@ Bool CApplication::SaveGame( String Directory, String Name )
 
 
 //
-// Load entire game from file and
-// entire resources. Warning Name should be without
+// Load game from file and entire resources. Levels
+// content is not loaded here, it's streamed on demand
+// via CProject::LoadLevel. Warning Name should be without
 // file extension.
 //
 Bool CApplication::LoadGame( String Directory, String Name )
 {	
+	UInt64 StartTime = time::cycles64();
+	const WideStringManager::Stats StringsBefore = g_wideStringManager.threadStats();
+
 	// Unload old cache.
 	Flush();
 
@@ -253,19 +388,23 @@ Bool CApplication::LoadGame( String Directory, String Name )
 	FileLoaderAdapter Loader( fm::readBinaryFile( *(RealDir + ProjFile) ) );
 
 	// Load general file information.
+	Bool bHasChunks;
 	{
 		TGameFileInfo	Info;
 		Serialize( Loader, Info );
 
-		if( Info.Control != 2528 )
+		if( Info.Control != GAME_FILE_CONTROL && Info.Control != GAME_FILE_CONTROL_LEGACY )
 			fatal( L"File '%s' is not a Fluorine Game", *(RealDir + ProjFile) );
 
 		if( Info.EngineVer != FLU_VERSION )
 			fatal( L"Old Fluorine File" );
+
+		bHasChunks	= Info.Control == GAME_FILE_CONTROL;
 	}
 	
 	// Load classes remap table.
-	Array<CClass*>	Classes(CClassDatabase::GClasses.size());
+	Array<CClass*>&	Classes = Project->ClassesRemap;
+	Classes.setSize( CClassDatabase::GClasses.size() );
 	{
 		Int32 NumCls;
 		Serialize( Loader, NumCls );
@@ -285,6 +424,21 @@ Bool CApplication::LoadGame( String Directory, String Name )
 		}
 	}
 
+	// Load table of level chunks.
+	if( bHasChunks )
+	{
+		SizeT OldPos = Loader.Tell();
+		UInt32 TableOffset;
+
+		Loader.Seek( Loader.TotalSize() - sizeof(UInt32) );
+		Serialize( Loader, TableOffset );
+		Loader.Seek( TableOffset );
+		Serialize( Loader, Project->LevelChunks );
+		Loader.Seek( OldPos );
+
+		Project->GameFileName	= RealDir + ProjFile;
+	}
+
 	// Load global objects database.
 	{
 		Int32 DbSize, DbRealSize;
@@ -323,10 +477,18 @@ Bool CApplication::LoadGame( String Directory, String Name )
 			Project->HashObject( Object );
 		}
 
-		// Fill list of available slots.
+		// Fill list of available slots, slots of level's
+		// objects are reserved.
+		Array<Bool> Reserved( Project->GObjects.size() );
+		for( Int32 i=0; i<Reserved.size(); i++ )
+			Reserved[i] = false;
+		for( Int32 iChunk=0; iChunk<Project->LevelChunks.size(); iChunk++ )
+			for( Int32 i=0; i<Project->LevelChunks[iChunk].ObjectIds.size(); i++ )
+				Reserved[Project->LevelChunks[iChunk].ObjectIds[i]] = true;
+
 		Project->GAvailable.empty();
 		for( Int32 i=0; i<Project->GObjects.size(); i++ )
-			if( Project->GObjects[i] == nullptr )
+			if( Project->GObjects[i] == nullptr && !Reserved[i] )
 				Project->GAvailable.push( i );
 	}
 	
@@ -335,31 +497,20 @@ Bool CApplication::LoadGame( String Directory, String Name )
 		if( Project->GObjects[i] && Project->GObjects[i]->IsA(FScript::MetaClass) )
 			Project->GObjects[i]->SerializeThis( Loader );
 	
-	// Load content of each object, without scripts.
+	// Load content of each object, without scripts. Chunked
+	// levels are loaded later.
 	for( Int32 i=0; i<Project->GObjects.size(); i++ )
-		if( Project->GObjects[i] && !Project->GObjects[i]->IsA(FScript::MetaClass) )
-			Project->GObjects[i]->SerializeThis( Loader );
+		if( Project->GObjects[i] && !Project->GObjects[i]->IsA(FScript::MetaClass) &&
+			!( bHasChunks && Project->GObjects[i]->IsA(FLevel::MetaClass) ) )
+				Project->GObjects[i]->SerializeThis( Loader );
 	
 	// Refill database for each level.
-	for( Int32 i=0; i<Project->GObjects.size(); i++ )
-		if( Project->GObjects[i] && Project->GObjects[i]->IsA(FLevel::MetaClass) )
-		{
-			FLevel* Level = (FLevel*)Project->GObjects[i];
-
-			for( Int32 iEntity=0; iEntity<Level->Entities.size(); iEntity++ )
-			{
-				FEntity* Entity = Level->Entities[iEntity];
-
-				FBaseComponent* Base = Entity->Base;
-				Entity->Base	= nullptr;
-				Base->InitForEntity( Entity );
-
-				Array<FExtraComponent*> Comps = Entity->Components;
-				Entity->Components.empty();
-				for( Int32 e=0; e<Comps.size(); e++ )
-					Comps[e]->InitForEntity( Entity );
-			}
-		}
+	if( !bHasChunks )
+	{
+		for( Int32 i=0; i<Project->GObjects.size(); i++ )
+			if( Project->GObjects[i] && Project->GObjects[i]->IsA(FLevel::MetaClass) )
+				((FLevel*)Project->GObjects[i])->InitEntities();
+	}
 
 	// Load all project stuff.
 	Project->SerializeProject( Loader );
@@ -381,8 +532,18 @@ Bool CApplication::LoadGame( String Directory, String Name )
 	
 	// Notify all objects about loading.
 	for( Int32 i=0; i<Project->GObjects.size(); i++ )
-		if( Project->GObjects[i] )
-			Project->GObjects[i]->PostLoad();
+		if( Project->GObjects[i] && 
+			!( bHasChunks && Project->GObjects[i]->IsA(FLevel::MetaClass) ) )
+				Project->GObjects[i]->PostLoad();
+
+	info( L"Game: '%s' loaded in %.2f ms with %d level chunks deferred; peak memory %d Kb", 
+		*Name, time::elapsedMsFrom( StartTime ), Project->LevelChunks.size(), 
+		Int32( mem::stats().peakAllocatedBytes / 1024 ) );
+
+	const WideStringManager::Stats& StringsAfter = g_wideStringManager.threadStats();
+	info( L"Game: strings heap allocations %d; pool reuses %d", 
+		StringsAfter.heapAllocations - StringsBefore.heapAllocations, 
+		StringsAfter.poolReuses - StringsBefore.poolReuses );
 
 	// Ok.
 	return true;
@@ -189,30 +189,22 @@ void CBlockManager::SaveAllBlocks( String InFileName )
 			// Valid block.
 			TDataBlock*	B	= Blocks[i];
 
-			// Select best compression for resource.
+			// Select compression for resource. LZ decodes much faster
+			// than LZW and RLE, so legacy codecs are only loaded now. Forecast
+			// is sampled, so it's cheap even for huge blocks.
 			{
-				B->Flags	&= ~(BLOCK_LZW | BLOCK_RLE);
+				B->Flags	&= ~(BLOCK_LZW | BLOCK_RLE | BLOCK_LZ);
 
-				SizeT RealSize, RLESize, LZWSize;
-				CRLECompressor RLE;
-				CLZWCompressor LZW;
+				SizeT RealSize, LZSize;
+				CLZCompressor LZ( true );
 				
 				RealSize	= B->Size;
-				RLESize		= RLE.ForecastSize( B->Data, B->Size );
-				LZWSize		= LZW.ForecastSize( B->Data, B->Size );
+				LZSize		= LZ.ForecastSize( B->Data, B->Size );
 				
-				// Make decision.
-				if( RealSize-min(RLESize, LZWSize) <= 8*1024 )
-				{
-					// Uncompressed data is smaller than compressed, yes
-					// this can happen, but really seldom.
-				}
-				else
-				{
-					// Select better compression, but we prefer RLE, since it much faster.
-					// 16 Kb is not too much.
-					B->Flags	|= ( RLESize-LZWSize <= 16*1024 ) ? BLOCK_RLE : BLOCK_LZW;
-				}
+				// Make decision, don't waste loading time on
+				// almost incompressible data.
+				if( LZSize + max<SizeT>( RealSize/8, 4*1024 ) < RealSize )
+					B->Flags	|= BLOCK_LZ;
 
 #if 1
 				// Dbg.
@@ -220,9 +212,9 @@ void CBlockManager::SaveAllBlocks( String InFileName )
 				( 
 					L"ResMan: %i's resource used %s (%i -> %i)kB", 
 					i,  
-					(B->Flags&BLOCK_LZW)?L"LZW":(B->Flags&BLOCK_RLE)?L"RLE":L"None",
+					(B->Flags&BLOCK_LZ)?L"LZ":L"None",
 					RealSize/1024,
-					((B->Flags&BLOCK_LZW)?LZWSize:(B->Flags&BLOCK_RLE)?RLESize:RealSize)/1024		
+					((B->Flags&BLOCK_LZ)?LZSize:RealSize)/1024		
 				);
 #endif
 			}
@@ -252,25 +244,16 @@ void CBlockManager::SaveAllBlocks( String InFileName )
 			saver->writeData( &B->FileRecord, sizeof( B->FileRecord ) );
 			saver->seek( B->FileRecord );
 
-			if( B->Flags & BLOCK_LZW )
-			{
-				// Apply LZW compression.
-				CLZWCompressor LZW;
-				void* OutBuffer;
-				SizeT OutSize;
-				LZW.Encode( B->Data, B->Size, OutBuffer, OutSize );	
-				saver->writeData( &OutSize, sizeof( OutSize ) );
-				saver->writeData( OutBuffer, OutSize );
-				mem::free( OutBuffer );
-			}
-			else if( B->Flags & BLOCK_RLE )
+			if( B->Flags & BLOCK_LZ )
 			{
-				// Apply RLE compression.
-				CRLECompressor RLE;
+				// Apply LZ compression.
+				CLZCompressor LZ( true );
 				void* OutBuffer;
 				SizeT OutSize;
-				RLE.Encode( B->Data, B->Size, OutBuffer, OutSize );
-				saver->writeData( &OutSize, sizeof( OutSize ) );
+				LZ.Encode( B->Data, B->Size, OutBuffer, OutSize );
+
+				UInt32 ComSize = UInt32( OutSize );
+				saver->writeData( &ComSize, sizeof( ComSize ) );
 				saver->writeData( OutBuffer, OutSize );
 				mem::free( OutBuffer );
 			}
@@ -325,37 +308,7 @@ void CBlockManager::LoadAllBlocks( String InFileName )
 
 			// Goto data.
 			loader->seek( B->FileRecord );
-			
-			// Load and uncompress data.
-			if( B->Flags & BLOCK_LZW )
-			{
-				// Load LZW data and uncompress it.
-				UInt32 InSize;
-				loader->readData( &InSize, sizeof( InSize ) );
-				void* InBuffer	= mem::malloc( InSize );
-				loader->readData( InBuffer, InSize );
-				CLZWCompressor LZW;
-				LZW.Decode( InBuffer, InSize, B->Data, B->Size );
-				mem::free( InBuffer );
-				B->Data	= InBuffer;
-			}
-			else if( B->Flags & BLOCK_RLE )
-			{
-				// Load RLE data and uncompress it.
-				UInt32 InSize;
-				loader->readData( &InSize, sizeof( InSize ) );
-				void* InBuffer	= mem::malloc( InSize );
-				loader->readData( InBuffer, InSize );
-				CRLECompressor RLE;
-				RLE.Decode( InBuffer, InSize, B->Data, B->Size );
-				mem::free( InBuffer );
-			}
-			else
-			{
-				// Load not compressed data.
-				B->Data	= mem::malloc( B->Size );
-				loader->readData( B->Data, B->Size );
-			}
+			ReadBlockData( loader, B );
 		}
 
 	// Mark each resource as loaded.
@@ -450,36 +403,7 @@ void CBlockManager::UploadBlock( Int32 iBlock )
 	// Load it.
 	TDataBlock* B		= Blocks[iBlock];
 	ResFile->seek( B->FileRecord );
-
-	// Load and uncompress data.
-	if( B->Flags & BLOCK_LZW )
-	{
-		// Load LZW data and uncompress it.
-		UInt32 InSize;
-		ResFile->readData( &InSize, sizeof( InSize ) );
-		void* InBuffer	= mem::malloc( InSize );
-		ResFile->readData( InBuffer, InSize );
-		CLZWCompressor LZW;
-		LZW.Decode( InBuffer, InSize, B->Data, B->Size );
-		mem::free( InBuffer );
-	}
-	else if( B->Flags & BLOCK_RLE )
-	{
-		// Load RLE data and uncompress it.
-		UInt32 InSize;
-		ResFile->readData( &InSize, sizeof( InSize ) );
-		void* InBuffer	= mem::malloc( InSize );
-		ResFile->readData( InBuffer, InSize );
-		CRLECompressor RLE;
-		RLE.Decode( InBuffer, InSize, B->Data, B->Size );
-		mem::free( InBuffer );
-	}
-	else
-	{
-		// Load not compressed data.
-		B->Data	= mem::malloc(B->Size);
-		ResFile->readData( B->Data, B->Size );
-	}
+	ReadBlockData( ResFile, B );
 
 	// Mark block as loaded. And let it live 
 	// about one minute.
@@ -526,6 +450,125 @@ void CBlockManager::Tick( Float Delta )
     Utility.
 -----------------------------------------------------------------------------*/
 
+//
+// Read block's data from the current position
+// of the file and uncompress it.
+//
+void CBlockManager::ReadBlockData( fm::IBinaryFileReader::Ptr& Reader, TDataBlock* B )
+{
+	if( B->Flags & (BLOCK_LZ | BLOCK_LZW | BLOCK_RLE) )
+	{
+		// Load compressed data.
+		UInt32 InSize;
+		Reader->readData( &InSize, sizeof( InSize ) );
+		void* InBuffer	= mem::malloc( InSize );
+		Reader->readData( InBuffer, InSize );
+
+		CLZCompressor	LZ;
+		CLZWCompressor	LZW;
+		CRLECompressor	RLE;
+		CCompressor*	Compressor	= (B->Flags & BLOCK_LZ) ? (CCompressor*)&LZ :
+									  (B->Flags & BLOCK_LZW) ? (CCompressor*)&LZW : (CCompressor*)&RLE;
+
+		// Uncompress it.
+		SizeT OutSize;
+		Compressor->Decode( InBuffer, InSize, B->Data, OutSize );
+		mem::free( InBuffer );
+
+		assert(OutSize == B->Size);
+	}
+	else
+	{
+		// Load not compressed data.
+		B->Data	= mem::malloc( B->Size );
+		Reader->readData( B->Data, B->Size );
+	}
+}
+
+
+//
+// Measure speed and ratio of the each compressor
+// on the loaded blocks.
+//
+void CBlockManager::BenchmarkCodecs()
+{
+	// Gather loaded blocks.
+	Array<TDataBlock*> Loaded;
+	SizeT TotalSize = 0;
+
+	for( Int32 i=0; i<Blocks.size(); i++ )
+		if( Blocks[i] && (Blocks[i]->Flags & BLOCK_Loaded) && Blocks[i]->Data )
+		{
+			Loaded.push( Blocks[i] );
+			TotalSize += Blocks[i]->Size;
+		}
+
+	if( TotalSize == 0 )
+	{
+		info( L"**Codec benchmark: No loaded blocks" );
+		return;
+	}
+
+	CRLECompressor	RLE;
+	CLZWCompressor	LZW;
+	CLZCompressor	LZFast( false );
+	CLZCompressor	LZHigh( true );
+
+	struct TCodec
+	{
+		const Char*		Name;
+		CCompressor*	Compressor;
+	} Codecs[] = 
+	{
+		{ L"RLE", &RLE },
+		{ L"LZW", &LZW },
+		{ L"LZ", &LZFast },
+		{ L"LZ HC", &LZHigh }
+	};
+
+	info( L"**Codec benchmark on %i blocks (%i kB):", Loaded.size(), Int32( TotalSize / 1024 ) );
+
+	for( Int32 c=0; c<Int32( arraySize(Codecs) ); c++ )
+	{
+		CCompressor* Compressor = Codecs[c].Compressor;
+		Double EncodeTime = 0.0, DecodeTime = 0.0;
+		SizeT ComSize = 0;
+
+		for( Int32 i=0; i<Loaded.size(); i++ )
+		{
+			TDataBlock* B = Loaded[i];
+			void *ComBuffer, *OutBuffer;
+			SizeT OutSize;
+
+			UInt64 StartTime = time::cycles64();
+			Compressor->Encode( B->Data, B->Size, ComBuffer, OutSize );
+			EncodeTime	+= time::elapsedMsFrom( StartTime );
+			ComSize		+= OutSize;
+
+			StartTime = time::cycles64();
+			Compressor->Decode( ComBuffer, OutSize, OutBuffer, OutSize );
+			DecodeTime	+= time::elapsedMsFrom( StartTime );
+
+			if( OutSize != B->Size || !mem::cmp( OutBuffer, B->Data, B->Size ) )
+				warn( L"   %s: Block roundtrip mismatch", Codecs[c].Name );
+
+			mem::free( ComBuffer );
+			mem::free( OutBuffer );
+		}
+
+		Double MBytes = Double( TotalSize ) / ( 1024.0 * 1024.0 );
+		info
+		( 
+			L"   %s: ratio %.3f, encode %.1f MB/s, decode %.1f MB/s", 
+			Codecs[c].Name,
+			Double( ComSize ) / Double( TotalSize ),
+			MBytes * 1000.0 / max( EncodeTime, 0.001 ),
+			MBytes * 1000.0 / max( DecodeTime, 0.001 )
+		);
+	}
+}
+
+
 //
 // Output debug information about the manager.
 //
@@ -17,6 +17,7 @@
 #define BLOCK_RLE				0x0008		// Simple and fast RLE compression used.
 #define BLOCK_LZW				0x0010		// Improved compression, but not so fast.
 #define BLOCK_Reserved			0x0020
+#define BLOCK_LZ				0x0040		// Fast LZ compression, decoded in parallel.
 
 
 //
@@ -84,12 +85,15 @@ public:
 
 	// Debug.
 	void DebugManager();
+	void BenchmarkCodecs();
 
 private:
 	// Internal.
 	Array<TDataBlock*>			Blocks;
 	String						FileName;
 	fm::IBinaryFileReader::Ptr	ResFile;
+
+	void ReadBlockData( fm::IBinaryFileReader::Ptr& Reader, TDataBlock* B );
 };
 
 
@@ -308,11 +308,25 @@ void CFrame::ProcessCode( TRegister* Result )
 	// Current execution context.
 	FEntity* Context = This;
 
+#if FLU_PROFILE_SCRIPT
+	// VM profiling, counters are null while profiler is disabled.
+	profile::ScriptProfiler::Scope ProfilerScope( Script, Bytecode );
+	UInt64* OpCounters = ProfilerScope.opCounters();
+#endif
+
 	// Execute it!
 	while( *Code != CODE_EOC )
 	{
 		EOpCode Op = (EOpCode)*Code++;
 
+#if FLU_PROFILE_SCRIPT
+		if( OpCounters )
+		{
+			OpCounters[Op]++;
+			ProfilerScope.countInstruction();
+		}
+#endif
+
 		switch( Op )
 		{
 			case CODE_Jump:
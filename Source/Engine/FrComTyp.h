@@ -826,6 +826,110 @@ enum EParticleParam
 };
 
 
+//
+// A particles motion law.
+//
+enum EParticleMotion
+{
+	PMT_Physics,
+	PMT_Lissajous,
+	PMT_Snow,
+	PMT_Rain
+};
+
+
+//
+// A parameters of particles update.
+//
+struct TParticleStep
+{
+public:
+	EParticleMotion	Motion;
+	Float			Delta;
+	Bool			bLinearSize;
+	Float			SizeRange[2];
+
+	// Physics motion.
+	math::Vector	Acceleration;
+
+	// Lissajous motion.
+	Float			Alpha, Beta;
+	Float			Shift;
+	Float			X, Y;
+
+	TParticleStep( EParticleMotion InMotion, Float InDelta );
+};
+
+
+//
+// A particles storage. Particles are stored as
+// structure of arrays, so the update processes four
+// particles at once. Large sets are split across
+// job system workers.
+//
+class CParticleSet
+{
+public:
+	// Constants.
+	enum{ PARTICLES_PER_TASK = 2048 };
+	enum{ MAX_TASKS = 16 };
+
+	// Streams, each is padded to multiple of four.
+	Float*			LocationX;
+	Float*			LocationY;
+	Float*			SpeedX;
+	Float*			SpeedY;
+	Float*			Rotation;		// Not wrapped angle.
+	Float*			SpinRate;		// Radians per second, as Angle( Float ) takes.
+	Float*			Size;
+	Float*			Life;
+	Float*			MaxLifeInv;
+	Float*			Phase;
+	UInt8*			iTile;
+
+	// CParticleSet interface.
+	CParticleSet();
+	CParticleSet( const CParticleSet& Other );
+	~CParticleSet();
+	CParticleSet& operator=( const CParticleSet& Other );
+	void SetLimit( Int32 NewLimit );
+	void Add( const TParticle& P );
+	TParticle Get( Int32 i ) const;
+	void Update( const TParticleStep& Step );
+	void Update( const TParticleStep& Step, Int32 First, Int32 Last, math::Rect& OutBounds );
+	void RemoveDead();
+	void BuildQuads( gfx::ParticleDrawer::Vertex* OutVerts, const math::Vector TileCoords[][4], const math::Color* ColorTable ) const;
+
+	// Accessors.
+	inline Int32 Num() const
+	{
+		return NumPrts;
+	}
+	inline Int32 Limit() const
+	{
+		return MaxPrts;
+	}
+	inline Bool HasBounds() const
+	{
+		return NumPrts > 0;
+	}
+	inline const math::Rect& Bounds() const
+	{
+		return CloudBounds;
+	}
+
+private:
+	// Internal.
+	UInt8*			Data;
+	Int32			NumPrts;
+	Int32			MaxPrts;
+	math::Rect		CloudBounds;
+
+	void BindStreams();
+	void Move( Int32 iDst, Int32 iSrc );
+};
+
+
 //
 // An abstract emitter.
 //
@@ -835,6 +939,8 @@ REGISTER_CLASS_H(FEmitterComponent);
 public:
 	// Constants.
 	enum{ MAX_PARTICLES	= 10000 };
+	enum{ MAX_TILES		= 16 };
+	enum{ COLOR_TABLE_SIZE	= 256 };
 
 	// Variables.
 	Int32					MaxParticles;
@@ -872,9 +978,17 @@ public:
 
 protected:
 	// Emitter internal.
-	Array<TParticle>		Particles;
-	Int32					NumPrts;
+	CParticleSet			Particles;
 	Float					Accumulator;
+
+	// Render tables cache.
+	math::Vector			TileCoords[MAX_TILES][4];
+	math::Color				ColorTable[COLOR_TABLE_SIZE];
+	UInt8					CachedUTiles;
+	UInt8					CachedVTiles;
+	math::Color				CachedColors[3];
+
+	void UpdateRenderTables();
 };
 
 
@@ -1306,6 +1420,7 @@ public:
 	// FComponent interface.
 	void InitForEntity( FEntity* InEntity );
 	void Tick( Float Delta );
+	void TickNonPlay( Float Delta );
 	void Render( CCanvas* Canvas );
 
 	// FObject interface.
@@ -1317,6 +1432,18 @@ private:
 	Float		Frame;
 	Int32		iAction;
 
+	// Own pose, computed by level's animator.
+	TSkelPose	Pose;
+	Int32		PoseAction;
+	Float		PoseFrame;
+
+	// Pose update LOD.
+	UInt32		LastSeenFrame;
+	Float		ScreenSize;
+	Int32		LODCounter;
+
+	void SubmitPose( Bool bForce );
+
 	// Natives.
 	void nativePlayAnim( CFrame& Frame );
 };
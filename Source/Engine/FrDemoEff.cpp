@@ -5,6 +5,789 @@
 
 #include "Engine.h"
 
+/*-----------------------------------------------------------------------------
+    Demo effects kernels.
+-----------------------------------------------------------------------------*/
+
+// Rows splitting limits.
+#define DEMO_PIXELS_PER_TASK	16384
+#define DEMO_MAX_TASKS			16
+
+
+//
+// A demo kernel to run over rows.
+//
+struct TDemoRows
+{
+	void		(*Kernel)( const void* Params, Int32 First, Int32 Last );
+	const void*	Params;
+};
+
+
+//
+// Job entry point.
+//
+static void DemoRowsTask( void* Data, Int32 iTask, Int32 First, Int32 Last )
+{
+	TDemoRows* Rows	= (TDemoRows*)Data;
+	Rows->Kernel( Rows->Params, First, Last );
+}
+
+
+//
+// Process [0..NumRows) rows, split them across job
+// workers if the frame is large enough.
+//
+static void DemoForRows( Int32 NumRows, Int32 RowSize, void(*Kernel)( const void*, Int32, Int32 ), const void* Params, Bool bScalar )
+{
+	TDemoRows Rows;
+	Rows.Kernel	= Kernel;
+	Rows.Params	= Params;
+
+	job::parallelFor( NumRows, max( DEMO_PIXELS_PER_TASK / max( RowSize, 1 ), 1 ), bScalar ? 1 : DEMO_MAX_TASKS, DemoRowsTask, &Rows );
+}
+
+
+//
+// Demo kernels parameters.
+//
+struct TDemoParams
+{
+	const UInt8*	Src;
+	const UInt8*	Aux;
+	UInt8*			Dst;
+	UInt8*			Work;
+	Int32			UBits;
+	Int32			VBits;
+	Int32			USize;
+	Int32			VSize;
+	Int32			UMask;
+	Int32			VMask;
+	const UInt8*	Table1;
+	const UInt8*	Table2;
+	const Int32*	Offsets;
+	UInt8*			Seeds;
+	UInt32			Phase;
+	Int32			PosX;
+	Int32			PosY;
+	Int32			Freq;
+	Int32			Ampl;
+
+	TDemoParams( Int32 InUBits, Int32 InVBits )
+		:	Src( nullptr ), Aux( nullptr ), Dst( nullptr ), Work( nullptr ),
+			UBits( InUBits ), VBits( InVBits ),
+			USize( 1 << InUBits ), VSize( 1 << InVBits ),
+			UMask( USize - 1 ), VMask( VSize - 1 ),
+			Table1( nullptr ), Table2( nullptr ),
+			Offsets( nullptr ), Seeds( nullptr ),
+			Phase( 0 ), PosX( 0 ), PosY( 0 ),
+			Freq( 0 ), Ampl( 0 )
+	{}
+};
+
+
+//
+// Wave filter of 8 words, it's computes WaveTab[512+A+B+C+D-2*W]
+// with arithmetic. Result is not clamped, pack it with saturation.
+//
+static inline __m128i WaveFilter8( __m128i A, __m128i B, __m128i C, __m128i D, __m128i W )
+{
+	__m128i Sum	= _mm_sub_epi16( _mm_add_epi16( _mm_add_epi16( A, B ), _mm_add_epi16( C, D ) ), _mm_slli_epi16( W, 1 ) );
+	__m128i Res	= _mm_srai_epi16( Sum, 1 );
+
+	return _mm_sub_epi16( Res, _mm_cmplt_epi16( Sum, _mm_set1_epi16( 256 ) ) );
+}
+
+
+//
+// Wave filter of 16 bytes.
+//
+static inline __m128i WaveFilter16( const UInt8* A, const UInt8* B, const UInt8* C, const UInt8* D, const UInt8* W )
+{
+	__m128i Zero	= _mm_setzero_si128();
+	__m128i VA		= _mm_loadu_si128( (const __m128i*)A );
+	__m128i VB		= _mm_loadu_si128( (const __m128i*)B );
+	__m128i VC		= _mm_loadu_si128( (const __m128i*)C );
+	__m128i VD		= _mm_loadu_si128( (const __m128i*)D );
+	__m128i VW		= _mm_loadu_si128( (const __m128i*)W );
+
+	__m128i Lo	= WaveFilter8(	_mm_unpacklo_epi8( VA, Zero ), _mm_unpacklo_epi8( VB, Zero ),
+								_mm_unpacklo_epi8( VC, Zero ), _mm_unpacklo_epi8( VD, Zero ),
+								_mm_unpacklo_epi8( VW, Zero ) );
+
+	__m128i Hi	= WaveFilter8(	_mm_unpackhi_epi8( VA, Zero ), _mm_unpackhi_epi8( VB, Zero ),
+								_mm_unpackhi_epi8( VC, Zero ), _mm_unpackhi_epi8( VD, Zero ),
+								_mm_unpackhi_epi8( VW, Zero ) );
+
+	return _mm_packus_epi16( Lo, Hi );
+}
+
+
+//
+// Rising fire row. ThisLine should contain previous
+// values, since not all pixels are written.
+//
+static UInt8 FireRow( const UInt8* NextLine, const UInt8* NextLine2, UInt8* ThisLine, Int32 USize, Int32 UMask,
+	const UInt8* FireTable, const Int32* ShiftTab, UInt8 Seed )
+{
+	for( Int32 U=0; U<USize; U++ )
+	{
+		UInt8	Value	= FireTable[NextLine[U]+NextLine2[U]];
+		if( Value )
+		{
+			Int32 Bias = ShiftTab[++Seed];
+			ThisLine[(U+Bias) & UMask]	= Value;
+		}
+		else
+		{
+			ThisLine[U]	= 0;
+		}
+	}
+
+	return Seed;
+}
+
+
+//
+// Count seed advances of the rising fire rows.
+//
+static void FireHeatRows( const void* Params, Int32 First, Int32 Last )
+{
+	const TDemoParams& P = *(const TDemoParams*)Params;
+
+	for( Int32 V=First; V<Last; V++ )
+	{
+		const UInt8*	NextLine	= &P.Src[((V-1) & P.VMask) << P.UBits];
+		const UInt8*	NextLine2	= &P.Src[V << P.UBits];
+		UInt8			NumHot		= 0;
+
+		for( Int32 U=0; U<P.USize; U++ )
+			NumHot	+= P.Table1[NextLine[U]+NextLine2[U]] != 0;
+
+		P.Seeds[V]	= NumHot;
+	}
+}
+
+
+//
+// Render rising fire rows, which are depends
+// on the previous frame only.
+//
+static void FireRenderRows( const void* Params, Int32 First, Int32 Last )
+{
+	const TDemoParams& P = *(const TDemoParams*)Params;
+
+	for( Int32 V=First; V<Last; V++ )
+	{
+		UInt8*	ThisLine	= &P.Dst[((V-2) & P.VMask) << P.UBits];
+
+		mem::copy( ThisLine, &P.Src[((V-2) & P.VMask) << P.UBits], P.USize );
+
+		FireRow( &P.Src[((V-1) & P.VMask) << P.UBits], &P.Src[V << P.UBits], ThisLine,
+			P.USize, P.UMask, P.Table1, P.Offsets, P.Seeds[V] );
+	}
+}
+
+
+//
+// Render rising fire from Src frame to Dst frame. Each row depends
+// on the seed, advanced by all the previous rows, so heat is counted
+// first and rows are rendered then. The last two rows are depends
+// on the new rows, they are rendered at the end.
+//
+void DemoRisingFire( const UInt8* Src, UInt8* Dst, Int32 UBits, Int32 VBits, const UInt8* FireTable, const Int32* ShiftTab, UInt8 Seed, Bool bScalar )
+{
+	TDemoParams P( UBits, VBits );
+
+	if( bScalar || P.VSize < 8 )
+	{
+		// Original in-place algorithm.
+		mem::copy( Dst, Src, P.USize * P.VSize );
+
+		UInt8*	ThisLine	= &Dst[(P.VSize-2) << UBits];
+		UInt8*	NextLine	= &Dst[(P.VSize-1) << UBits];
+
+		for( Int32 V=0; V<P.VSize; V++ )
+		{
+			UInt8*	NextLine2	= &Dst[V << UBits];
+
+			Seed		= FireRow( NextLine, NextLine2, ThisLine, P.USize, P.UMask, FireTable, ShiftTab, Seed );
+			ThisLine	= NextLine;
+			NextLine	= NextLine2;
+		}
+		return;
+	}
+
+	Array<UInt8> Seeds( P.VSize );
+
+	P.Src		= Src;
+	P.Dst		= Dst;
+	P.Table1	= FireTable;
+	P.Offsets	= ShiftTab;
+	P.Seeds		= &Seeds[0];
+
+	DemoForRows( P.VSize-2, P.USize, FireHeatRows, &P, false );
+
+	for( Int32 V=0; V<P.VSize-2; V++ )
+	{
+		UInt8 NumHot	= Seeds[V];
+		Seeds[V]		= Seed;
+		Seed			+= NumHot;
+	}
+
+	DemoForRows( P.VSize-2, P.USize, FireRenderRows, &P, false );
+
+	// Row VSize-3 is still old, rows VSize-2 and VSize-1 are new.
+	UInt8*	Line3	= &Dst[(P.VSize-4) << UBits];
+	UInt8*	Line4	= &Dst[(P.VSize-3) << UBits];
+
+	mem::copy( Line3, &Src[(P.VSize-4) << UBits], P.USize );
+	mem::copy( Line4, &Src[(P.VSize-3) << UBits], P.USize );
+
+	Seed	= FireRow( &Src[(P.VSize-3) << UBits], &Dst[(P.VSize-2) << UBits], Line3, P.USize, P.UMask, FireTable, ShiftTab, Seed );
+	FireRow( &Dst[(P.VSize-2) << UBits], &Dst[(P.VSize-1) << UBits], Line4, P.USize, P.UMask, FireTable, ShiftTab, Seed );
+}
+
+
+//
+// Compute plasma heat rows.
+//
+static void PlasmaHeatRows( const void* Params, Int32 First, Int32 Last )
+{
+	const TDemoParams& P = *(const TDemoParams*)Params;
+	const UInt8* SineTab = P.Src;
+	Int32 U2Size	= P.USize >> 1;
+	Int32 U2Bits	= P.UBits - 1;
+	UInt32 Phase	= P.Phase;
+	Int32 A, B, C, D;
+
+	for( Int32 V=First; V<Last; V++ )
+	{
+		UInt8*	HeatLine	= &P.Dst[V << U2Bits];
+
+		B		= P.Table1[256*1+((V-Phase) & 0xff)];
+
+		for( Int32 U=0; U<U2Size; U++ )
+		{
+			A	= P.Table1[256*0+((U-Phase) & 0xff)];
+			C	= P.Table1[256*2+(((U+V)+Phase) & 0xff)];
+			D	= P.Table1[256*3+((SineTab[(U*2+Phase) & 0xff]+SineTab[(V*2+Phase) & 0xff]) & 0xff)];
+
+			HeatLine[U]		= A + B + C + D;
+		}
+	}
+}
+
+
+//
+// Compute a plasma heat buffer of half resolution.
+//
+void DemoPlasmaHeat( UInt8* Heat, Int32 UBits, Int32 VBits, const UInt8 PlasmaTable[4][256], const UInt8* SineTab, UInt32 Phase, Bool bScalar )
+{
+	TDemoParams P( UBits, VBits );
+
+	P.Src		= SineTab;
+	P.Dst		= Heat;
+	P.Table1	= &PlasmaTable[0][0];
+	P.Phase		= Phase;
+
+	DemoForRows( P.VSize >> 1, P.USize >> 1, PlasmaHeatRows, &P, bScalar );
+}
+
+
+//
+// Render plasma rows.
+//
+static void PlasmaRenderRows( const void* Params, Int32 First, Int32 Last )
+{
+	const TDemoParams& P = *(const TDemoParams*)Params;
+	Int32 U2Size		= P.USize >> 1;
+	Int32 U2Bits		= P.UBits - 1;
+	Int32 U2Mask		= P.UMask >> 1;
+	Int32 V2Mask		= P.VMask >> 1;
+
+	for( Int32 V=First; V<Last; V++ )
+	{
+		// Get lines and apply some phase panning.
+		const UInt8*	HeatLine	= &P.Src[((V+0+P.Phase) & V2Mask) << U2Bits];
+		const UInt8*	NextLine	= &P.Src[((V+1+P.Phase) & V2Mask) << U2Bits];
+		UInt8*			Data0Line	= &P.Dst[V*2+0 << P.UBits];
+		UInt8*			Data1Line	= &P.Dst[V*2+1 << P.UBits];
+
+		for( Int32 U=0; U<U2Size; U++ )
+		{
+			// Sample heat values.
+			Int32 A	= HeatLine[(U+HeatLine[(U+0)&U2Mask]+0) & U2Mask];
+			Int32 B	= HeatLine[(U+HeatLine[(U+1)&U2Mask]+1) & U2Mask];
+			Int32 C	= NextLine[(U+NextLine[(U+0)&U2Mask]+0) & U2Mask];
+			Int32 D	= NextLine[(U+NextLine[(U+1)&U2Mask]+1) & U2Mask];
+
+			// Super sampling.
+			Data0Line[U*2+0]	= A;
+			Data0Line[U*2+1]	= (A+B) >> 1;
+			Data1Line[U*2+0]	= (A+C) >> 1;
+			Data1Line[U*2+1]	= (A+B+C+D) >> 2;
+		}
+	}
+}
+
+
+//
+// Render the plasma from heat buffer.
+//
+void DemoPlasmaRender( const UInt8* Heat, UInt8* Dst, Int32 UBits, Int32 VBits, UInt32 Phase, Bool bScalar )
+{
+	TDemoParams P( UBits, VBits );
+
+	P.Src		= Heat;
+	P.Dst		= Dst;
+	P.Phase		= Phase;
+
+	DemoForRows( P.VSize >> 1, P.USize, PlasmaRenderRows, &P, bScalar );
+}
+
+
+//
+// Odd water filter rows, SIMD version.
+//
+static void WaterOddRows( const void* Params, Int32 First, Int32 Last )
+{
+	const TDemoParams& P = *(const TDemoParams*)Params;
+	const UInt8* WaveTab	= P.Table1;
+	const UInt8* DistTable	= P.Table2;
+	Int32 U2Size		= P.USize >> 1;
+	Int32 V2Size		= P.VSize >> 1;
+	Int32 U2Mask		= P.UMask >> 1;
+
+	for( Int32 V=First; V<Last; V++ )
+	{
+		const UInt8*	ThisWater1	= P.Work + (((V-1) & (V2Size-1)) << P.UBits);
+		UInt8*			ThisWater2	= P.Work + (((V-1) & (V2Size-1)) << P.UBits) + U2Size;
+		const UInt8*	NextWater1	= P.Work + (V << P.UBits);
+		UInt8*			Data0		= &P.Dst[((V*2+0) & P.VMask) << P.UBits];
+		UInt8*			Data1		= &P.Dst[((V*2+1) & P.VMask) << P.UBits];
+		Int32			U			= 0;
+
+		// Put pixels, 16 per step, while U+1 doesn't wrap.
+		for( ; U+16<U2Size; U+=16 )
+		{
+			_mm_storeu_si128( (__m128i*)&ThisWater2[U], WaveFilter16( &ThisWater1[U], &ThisWater1[U+1],
+				&NextWater1[U], &NextWater1[U+1], &ThisWater2[U] ) );
+		}
+
+		for( ; U<U2Size; U++ )
+		{
+			Int32 A = ThisWater1[U];
+			Int32 B = ThisWater1[(U+1) & U2Mask];
+			Int32 C = NextWater1[U];
+			Int32 D = NextWater1[(U+1) & U2Mask];
+
+			ThisWater2[U] = WaveTab[512+A+B+C+D-2*ThisWater2[U]];
+		}
+
+		// Resample water depth to bitmap.
+		for( U=0; U<U2Size; U++ )
+		{
+			Int32 A = ThisWater1[U];
+			Int32 B = ThisWater1[(U+1) & U2Mask];
+			Int32 C = NextWater1[U];
+			Int32 D = NextWater1[(U+1) & U2Mask];
+			Int32 E = ThisWater1[(U+2) & U2Mask];
+			Int32 F = NextWater1[(U+2) & U2Mask];
+			Int32 G = ThisWater1[(U+3) & U2Mask];
+			Int32 H = NextWater1[(U+3) & U2Mask];
+
+			Int32 DH = D-H;
+			Int32 BG = B-G;
+			Int32 AE = A-E;
+			Int32 CF = C-F;
+
+			Data0[U*2+0]	= DistTable[512+AE*2];
+			Data1[U*2+0]	= DistTable[512+CF+AE];
+			Data0[U*2+1]	= DistTable[512+BG+AE];
+			Data1[U*2+1]	= DistTable[512+(DH+BG+AE+CF)/2];
+		}
+	}
+}
+
+
+//
+// Even water filter rows, SIMD version.
+//
+static void WaterEvenRows( const void* Params, Int32 First, Int32 Last )
+{
+	const TDemoParams& P = *(const TDemoParams*)Params;
+	const UInt8* WaveTab	= P.Table1;
+	Int32 U2Size		= P.USize >> 1;
+	Int32 V2Size		= P.VSize >> 1;
+	Int32 U2Mask		= P.UMask >> 1;
+
+	for( Int32 V=First; V<Last; V++ )
+	{
+		const UInt8*	PrevWater2	= P.Work + (((V-1) & (V2Size-1)) << P.UBits) + U2Size;
+		UInt8*			ThisWater1	= P.Work + (V << P.UBits);
+		const UInt8*	ThisWater2	= ThisWater1 + U2Size;
+		Int32			U;
+
+		// Put pixels, 16 per step, U-1 wraps only for the first one.
+		for( U=1; U+16<=U2Size; U+=16 )
+		{
+			_mm_storeu_si128( (__m128i*)&ThisWater1[U], WaveFilter16( &PrevWater2[U-1], &PrevWater2[U],
+				&ThisWater2[U-1], &ThisWater2[U], &ThisWater1[U] ) );
+		}
+
+		for( ; U<=U2Size; U++ )
+		{
+			Int32 X = U & U2Mask;
+			Int32 A = PrevWater2[(X-1) & U2Mask];
+			Int32 B = PrevWater2[X];
+			Int32 C = ThisWater2[(X-1) & U2Mask];
+			Int32 D = ThisWater2[X];
+
+			ThisWater1[X] = WaveTab[512+A+B+C+D-2*ThisWater1[X]];
+		}
+	}
+}
+
+
+//
+// Calculate the water surface and render it's distortion to Dst. The
+// ZBuffer contains two half sized water buffers in each row. WaveTab
+// should be built with InitTables, SIMD path computes it inplace.
+//
+void DemoWaterFilter( UInt8* ZBuffer, UInt8* Dst, Int32 UBits, Int32 VBits, const UInt8* WaveTab, const UInt8* DistTable, Bool bOdd, Bool bScalar )
+{
+	TDemoParams P( UBits, VBits );
+	Int32 U2Size		= P.USize >> 1;
+	Int32 V2Size		= P.VSize >> 1;
+	Int32 U2Mask		= P.UMask >> 1;
+
+	if( !bScalar && U2Size >= 32 )
+	{
+		P.Dst		= Dst;
+		P.Work		= ZBuffer;
+		P.Table1	= WaveTab;
+		P.Table2	= DistTable;
+
+		DemoForRows( V2Size, P.USize, bOdd ? WaterOddRows : WaterEvenRows, &P, false );
+		return;
+	}
+
+	if( bOdd )
+	{
+		// Apply odd water filter.
+		UInt8*	ThisWater1	= ZBuffer + ((V2Size-1) << UBits);
+		UInt8*	ThisWater2	= ThisWater1 + U2Size;
+
+		for( Int32 V=0; V<V2Size; V++ )
+		{
+			UInt8*	NextWater1	= ZBuffer + (V << UBits);
+			UInt8*	NextWater2	= NextWater1 + U2Size;
+			UInt8*	Data0		= &Dst[((V*2+0) & P.VMask) << UBits];
+			UInt8*	Data1		= &Dst[((V*2+1) & P.VMask) << UBits];
+
+			for( Int32 U=0; U<U2Size; U++ )
+			{
+				// Sample values.
+				Int32 A = ThisWater1[U];
+				Int32 B = ThisWater1[(U+1) & U2Mask];
+				Int32 C = NextWater1[U];
+				Int32 D = NextWater1[(U+1) & U2Mask];
+				Int32 E = ThisWater1[(U+2) & U2Mask];
+				Int32 F = NextWater1[(U+2) & U2Mask];
+				Int32 G = ThisWater1[(U+3) & U2Mask];
+				Int32 H = NextWater1[(U+3) & U2Mask];
+
+				// Put pixel.
+				ThisWater2[U] = WaveTab[512+A+B+C+D-2*ThisWater2[U]];
+
+				// Compute deltas.
+				Int32 DH = D-H;
+				Int32 BG = B-G;
+				Int32 AE = A-E;
+				Int32 CF = C-F;
+
+				// Resample water depth to bitmap.
+				Data0[U*2+0]	= DistTable[512+AE*2];
+				Data1[U*2+0]	= DistTable[512+CF+AE];
+				Data0[U*2+1]	= DistTable[512+BG+AE];
+				Data1[U*2+1]	= DistTable[512+(DH+BG+AE+CF)/2];
+			}
+
+			ThisWater1 = NextWater1;
+			ThisWater2 = NextWater2;
+		}
+	}
+	else
+	{
+		// Apply even water filter.
+		UInt8*	PrevWater1	= ZBuffer + ((V2Size-1) << UBits);
+		UInt8*	PrevWater2	= PrevWater1 + U2Size;
+
+		for( Int32 V=0; V<V2Size; V++ )
+		{
+			UInt8*	ThisWater1	= ZBuffer + (V << UBits);
+			UInt8*	ThisWater2	= ThisWater1 + U2Size;
+
+			for( Int32 U=0; U<U2Size; U++ )
+			{
+				// Sample values.
+				Int32 A = PrevWater2[(U-1) & U2Mask];
+				Int32 B = PrevWater2[U];
+				Int32 C = ThisWater2[(U-1) & U2Mask];
+				Int32 D = ThisWater2[U];
+
+				// Put pixel.
+				ThisWater1[U] = WaveTab[512+A+B+C+D-2*ThisWater1[U]];
+			}
+
+			PrevWater1 = ThisWater1;
+			PrevWater2 = ThisWater2;
+		}
+	}
+}
+
+
+//
+// Apply water dispersion rows.
+//
+static void WaterRenderRows( const void* Params, Int32 First, Int32 Last )
+{
+	const TDemoParams& P = *(const TDemoParams*)Params;
+
+	for( Int32 V=First; V<Last; V++ )
+	{
+		UInt8*			WaterLine	= &P.Dst[V << P.UBits];
+		const UInt8*	DataLine	= &P.Src[V << P.UBits];
+
+		for( Int32 U=0; U<P.USize; U++ )
+		{
+			WaterLine[U] = DataLine[(U+WaterLine[U]) & P.UMask];
+		}
+	}
+}
+
+
+//
+// Apply water dispersion to the image.
+//
+void DemoWaterRender( const UInt8* Image, UInt8* Water, Int32 UBits, Int32 VBits, Bool bScalar )
+{
+	TDemoParams P( UBits, VBits );
+
+	P.Src	= Image;
+	P.Dst	= Water;
+
+	DemoForRows( P.VSize, P.USize, WaterRenderRows, &P, bScalar );
+}
+
+
+//
+// Bump map rows.
+//
+static void BumpMapRows( const void* Params, Int32 First, Int32 Last )
+{
+	const TDemoParams& P = *(const TDemoParams*)Params;
+
+	for( Int32 V=First; V<Last; V++ )
+	{
+		UInt8* DataLine = P.Dst + (V << P.UBits);
+		const UInt8* SourceLine = P.Src + (V << P.UBits);
+
+		for( Int32 U=0; U<P.USize; U++ )
+		{
+			Int32 A = SourceLine[(U+1) & P.UMask];
+			Int32 B = SourceLine[(U-1) & P.UMask];
+
+			DataLine[U] = P.Table1[255 + A + (B >> 2) - B];
+		}
+	}
+}
+
+
+//
+// Compute cheap water-like bump map.
+//
+void DemoBumpMap( const UInt8* Source, UInt8* Dst, Int32 UBits, Int32 VBits, const UInt8* LightTable, Bool bScalar )
+{
+	TDemoParams P( UBits, VBits );
+
+	P.Src		= Source;
+	P.Dst		= Dst;
+	P.Table1	= LightTable;
+
+	DemoForRows( P.VSize, P.USize, BumpMapRows, &P, bScalar );
+}
+
+
+//
+// Movable glass rows.
+//
+static void GlassIRows( const void* Params, Int32 First, Int32 Last )
+{
+	const TDemoParams& P = *(const TDemoParams*)Params;
+
+	for( Int32 V=First; V<Last; V++ )
+	{
+		UInt8*			DstLine	= &P.Dst[V << P.UBits];
+		const UInt8*	ImgLine	= &P.Src[V << P.UBits];
+		const UInt8*	GlsLine	= &P.Aux[((V+P.PosY) & P.VMask) << P.UBits];
+
+		for( Int32 U=0; U<P.USize; U++ )
+		{
+			DstLine[U]	= ImgLine[(GlsLine[(P.PosX+U) & P.UMask]+U) & P.UMask];
+		}
+	}
+}
+
+
+//
+// Movable image rows.
+//
+static void GlassIIRows( const void* Params, Int32 First, Int32 Last )
+{
+	const TDemoParams& P = *(const TDemoParams*)Params;
+
+	for( Int32 V=First; V<Last; V++ )
+	{
+		UInt8*			DstLine	= &P.Dst[V << P.UBits];
+		const UInt8*	ImgLine	= &P.Src[((V+P.PosY) & P.VMask) << P.UBits];
+		const UInt8*	GlsLine	= &P.Aux[V << P.UBits];
+
+		for( Int32 U=0; U<P.USize; U++ )
+		{
+			DstLine[U]	= ImgLine[(GlsLine[U]+U+P.PosX) & P.UMask];
+		}
+	}
+}
+
+
+//
+// Render the image through the glass.
+//
+void DemoGlass( const UInt8* Image, const UInt8* Glass, UInt8* Dst, Int32 UBits, Int32 VBits, Int32 PosX, Int32 PosY, Bool bMoveGlass, Bool bScalar )
+{
+	TDemoParams P( UBits, VBits );
+
+	P.Src	= Image;
+	P.Aux	= Glass;
+	P.Dst	= Dst;
+	P.PosX	= PosX;
+	P.PosY	= PosY;
+
+	DemoForRows( P.VSize, P.USize, bMoveGlass ? GlassIRows : GlassIIRows, &P, bScalar );
+}
+
+
+//
+// Horizontal harmonic rows, each one is just a rotated
+// source line.
+//
+static void HarmonicHRows( const void* Params, Int32 First, Int32 Last )
+{
+	const TDemoParams& P = *(const TDemoParams*)Params;
+
+	for( Int32 V=First; V<Last; V++ )
+	{
+		UInt8*			DstLine	= &P.Dst[V << P.UBits];
+		const UInt8*	SrcLine	= &P.Src[((V+P.PosY) & P.VMask) << P.UBits];
+		Int32 WaveOff	= (P.PosX + ((P.Table1[(P.Phase+((V*P.Freq)>>4)) & 0xff]*P.Ampl) >> 8)) & P.UMask;
+
+		mem::copy( DstLine, &SrcLine[WaveOff], P.USize - WaveOff );
+		mem::copy( &DstLine[P.USize - WaveOff], SrcLine, WaveOff );
+	}
+}
+
+
+//
+// Vertical harmonic rows, columns offsets are
+// precomputed.
+//
+static void HarmonicVRows( const void* Params, Int32 First, Int32 Last )
+{
+	const TDemoParams& P = *(const TDemoParams*)Params;
+	const Int32* WaveOff = P.Offsets;
+
+	for( Int32 V=First; V<Last; V++ )
+	{
+		UInt8*	DstLine	= &P.Dst[V << P.UBits];
+
+		for( Int32 U=0; U<P.USize; U++ )
+		{
+			DstLine[U]	= P.Src[(((V+WaveOff[U]) & P.VMask) << P.UBits) + ((U+P.PosX) & P.UMask)];
+		}
+	}
+}
+
+
+//
+// Render harmonic wave of the image.
+//
+void DemoHarmonic( const UInt8* Src, UInt8* Dst, Int32 UBits, Int32 VBits, const UInt8* SineTab, UInt32 Phase, Int32 Freq, Int32 Ampl, Int32 HOffset, Int32 VOffset, Bool bVertical, Bool bScalar )
+{
+	TDemoParams P( UBits, VBits );
+
+	if( bScalar )
+	{
+		// Original column and row walks.
+		if( bVertical )
+		{
+			for( Int32 U=0; U<P.USize; U++ )
+			{
+				UInt8*			DstRow	= &Dst[U];
+				const UInt8*	SrcRow	= &Src[(U+HOffset) & P.UMask];
+				Int32 WaveOff	= VOffset + ((SineTab[(Phase+((U*Freq)>>4)) & 0xff]*Ampl) >> 8);
+
+				for( Int32 V=0; V<P.VSize; V++ )
+				{
+					DstRow[V << UBits]	= SrcRow[((V+WaveOff) & P.VMask) << UBits];
+				}
+			}
+		}
+		else
+		{
+			for( Int32 V=0; V<P.VSize; V++ )
+			{
+				UInt8*			DstLine	= &Dst[V << UBits];
+				const UInt8*	SrcLine	= &Src[((V+VOffset) & P.VMask) << UBits];
+				Int32 WaveOff	= HOffset + ((SineTab[(Phase+((V*Freq)>>4)) & 0xff]*Ampl) >> 8);
+
+				for( Int32 U=0; U<P.USize; U++ )
+				{
+					DstLine[U] = SrcLine[(U+WaveOff) & P.UMask];
+				}
+			}
+		}
+		return;
+	}
+
+	P.Src		= Src;
+	P.Dst		= Dst;
+	P.Table1	= SineTab;
+	P.Phase		= Phase;
+	P.PosX		= HOffset;
+	P.PosY		= VOffset;
+	P.Freq		= Freq;
+	P.Ampl		= Ampl;
+
+	if( bVertical )
+	{
+		// Walk rows instead of columns, it's much more cache friendly.
+		Array<Int32> WaveOff( P.USize );
+
+		for( Int32 U=0; U<P.USize; U++ )
+			WaveOff[U]	= VOffset + ((SineTab[(Phase+((U*Freq)>>4)) & 0xff]*Ampl) >> 8);
+
+		P.Offsets	= &WaveOff[0];
+		DemoForRows( P.VSize, P.USize, HarmonicVRows, &P, false );
+	}
+	else
+	{
+		DemoForRows( P.VSize, P.USize, HarmonicHRows, &P, false );
+	}
+}
+
+
 #if DEMO_EFFECTS_ENABLED
 
 /*-----------------------------------------------------------------------------
@@ -337,26 +1120,7 @@ void FPlasmaBitmap::Init( Int32 InU, Int32 InV )
 //
 void FPlasmaBitmap::CalculatePlasma()
 {
-	Int32 U2Size	= USize >> 1;
-	Int32 V2Size	= VSize >> 1;
-	Int32 U2Bits	= UBits - 1;
-	Int32 A, B, C, D;
-
-	for( Int32 V=0; V<V2Size; V++ )
-	{
-		UInt8*	HeatLine	= &HeatBuffer[V << U2Bits];
-
-		B		= PlasmaTable[1][(V-Phase) & 0xff];
-
-		for( Int32 U=0; U<U2Size; U++ )
-		{
-			A	= PlasmaTable[0][(U-Phase) & 0xff];
-			C	= PlasmaTable[2][((U+V)+Phase) & 0xff];
-			D	= PlasmaTable[3][(SineTab[(U*2+Phase) & 0xff]+SineTab[(V*2+Phase) & 0xff]) & 0xff];
-
-			HeatLine[U]		= A + B + C + D;
-		}
-	}
+	DemoPlasmaHeat( HeatBuffer, UBits, VBits, PlasmaTable, SineTab, Phase );
 }
 
 
@@ -365,36 +1129,7 @@ void FPlasmaBitmap::CalculatePlasma()
 //
 void FPlasmaBitmap::RenderPlasma()
 {
-	UInt8*	Data		= (UInt8*)GetData();
-	Int32 U2Size		= USize >> 1;
-	Int32 V2Size		= VSize >> 1;
-	Int32 U2Bits		= UBits - 1;
-	Int32 U2Mask		= UMask >> 1;
-	Int32 V2Mask		= VMask >> 1;
-
-	for( Int32 V=0; V<V2Size; V++ )
-	{
-		// Get lines and apply some phase panning.
-		UInt8*	HeatLine	= &HeatBuffer[((V+0+Phase) & V2Mask) << U2Bits];
-		UInt8*	NextLine	= &HeatBuffer[((V+1+Phase) & V2Mask) << U2Bits];
-		UInt8*	Data0Line	= &Data[V*2+0 << UBits];
-		UInt8*	Data1Line	= &Data[V*2+1 << UBits];
-
-		for( Int32 U=0; U<U2Size; U++ )
-		{
-			// Sample heat values.
-			Int32 A	= HeatLine[(U+HeatLine[(U+0)&U2Mask]+0) & U2Mask];
-			Int32 B	= HeatLine[(U+HeatLine[(U+1)&U2Mask]+1) & U2Mask];
-			Int32 C	= NextLine[(U+NextLine[(U+0)&U2Mask]+0) & U2Mask];
-			Int32 D	= NextLine[(U+NextLine[(U+1)&U2Mask]+1) & U2Mask];
-			
-			// Super sampling.
-			Data0Line[U*2+0]	= A;
-			Data0Line[U*2+1]	= (A+B) >> 1;
-			Data1Line[U*2+0]	= (A+C) >> 1;
-			Data1Line[U*2+1]	= (A+B+C+D) >> 2;
-		}
-	}
+	DemoPlasmaRender( HeatBuffer, (UInt8*)GetData(), UBits, VBits, Phase );
 }
 
 
@@ -539,8 +1274,19 @@ void FPlasmaBitmap::Erase()
 // Fire constructor.
 //
 FFireBitmap::FFireBitmap()
-	:	FDemoBitmap()
+	:	FDemoBitmap(),
+		BackBuffer( nullptr )
+{
+}
+
+
+//
+// Fire destructor.
+//
+FFireBitmap::~FFireBitmap()
 {
+	if( BackBuffer )
+		mem::free( BackBuffer );
 }
 
 
@@ -560,6 +1306,9 @@ void FFireBitmap::Init( Int32 InU, Int32 InV )
 
 	// Fire pal.
 	paletteFire( &Palette.Colors[0] );
+
+	// Rising fire back buffer.
+	BackBuffer		= (UInt8*)mem::alloc( USize * VSize );
 }
 
 
@@ -672,6 +1421,7 @@ void FFireBitmap::PostLoad()
 {
 	FDemoBitmap::PostLoad();
 	SetFireTable();
+	BackBuffer		= (UInt8*)mem::alloc( USize * VSize );
 }
 
 
@@ -712,53 +1462,9 @@ void FFireBitmap::DeleteSparks( Int32 X, Int32 Y, Int32 Size )
 //
 void FFireBitmap::RenderRisingFire()
 {
-	UInt8*	Data	= (UInt8*)GetData();
-	UInt8	Seed	= Phase;
-
-#if 0
-	// Naive algorithm.
-	for( Integer V=0; V<VSize; V++ )
-		for( Integer U=0; U<USize; U++ )
-		{
-			Integer Value = FireTable[ Data[U+(((V+2)&VMask)<<UBits)]+Data[U+(((V+1)&VMask)<<UBits)] ];
-
-			if( Value )
-			{
-				Integer Offset = ShiftTab[++Seed];
-				Data[ ((U+Offset)&UMask) +(V<<UBits)] = Value;
-			}
-			else
-			{
-				Data[U+(V << UBits)]	= 0;
-			}
-		}
-#else
-	// Cool algorithm.
-	UInt8*	ThisLine	= &Data[(VSize-2) << UBits];
-	UInt8*	NextLine	= &Data[(VSize-1) << UBits];
-
-	for( Int32 V=0; V<VSize; V++ )
-	{
-		UInt8*	NextLine2	= &Data[V << UBits];
-
-		for( Int32 U=0; U<USize; U++ )
-		{
-			UInt8	Value	= FireTable[NextLine[U]+NextLine2[U]];
-			if( Value )
-			{
-				Int32 Bias = ShiftTab[++Seed];
-				ThisLine[(U+Bias) & UMask]	= Value;
-			}
-			else
-			{
-				ThisLine[U]	= 0;
-			}
-		}
-
-		ThisLine	= NextLine;
-		NextLine	= NextLine2;
-	}
-#endif
+	// Render to the back buffer and flip.
+	DemoRisingFire( EffectPtr, BackBuffer, UBits, VBits, FireTable, ShiftTab, (UInt8)Phase );
+	exchange( EffectPtr, BackBuffer );
 }
 
 
@@ -1626,20 +2332,7 @@ void FWaterBitmap::RenderWater()
 	if( Phase & 1 )
 	{
 		assert(Image);
-
-		UInt8* Data = (UInt8*)Image->GetData();
-		UInt8* Water	= (UInt8*)GetData();
-
-		for( Int32 V=0; V<VSize; V++ )
-		{
-			UInt8* WaterLine = &Water[V << UBits];
-			UInt8* DataLine  = &Data[V << UBits];
-
-			for( Int32 U=0; U<USize; U++ )
-			{
-				WaterLine[U] = DataLine[(U+WaterLine[U]) & UMask];
-			}
-		}
+		DemoWaterRender( (UInt8*)Image->GetData(), (UInt8*)GetData(), UBits, VBits );
 	}
 }
 
@@ -1649,84 +2342,7 @@ void FWaterBitmap::RenderWater()
 //
 void FWaterBitmap::CalculateWater()
 {
-	UInt8* Data			= (UInt8*)GetData();
-	Int32 U2Size		= USize >> 1;
-	Int32 V2Size		= VSize >> 1;
-	Int32 U2Mask		= UMask >> 1;
-	Int32 V2Mask		= VMask >> 1;
-	
-	if( Phase & 1 )
-	{
-		// Apply odd water filter.
-		UInt8*	ThisWater1	= ZBuffer + ((V2Size-1) << UBits);
-		UInt8*	ThisWater2	= ThisWater1 + U2Size;
-
-		for( Int32 V=0; V<V2Size; V++ )
-		{
-			UInt8*	NextWater1	= ZBuffer + (V << UBits);
-			UInt8*	NextWater2	= NextWater1 + U2Size;
-			UInt8*	Data0		= &Data[((V*2+0) & VMask) << UBits];
-			UInt8*	Data1		= &Data[((V*2+1) & VMask) << UBits];
-
-			for( Int32 U=0; U<U2Size; U++ )
-			{
-				// Sample values.
-				Int32 A = ThisWater1[U];
-				Int32 B = ThisWater1[(U+1) & U2Mask];
-				Int32 C = NextWater1[U];
-				Int32 D = NextWater1[(U+1) & U2Mask];
-				Int32 E = ThisWater1[(U+2) & U2Mask];
-				Int32 F = NextWater1[(U+2) & U2Mask];
-				Int32 G = ThisWater1[(U+3) & U2Mask];
-				Int32 H = NextWater1[(U+3) & U2Mask];
-
-				// Put pixel.
-				ThisWater2[U] = WaveTab[512+A+B+C+D-2*ThisWater2[U]];
-
-				// Compute deltas.
-				Int32 DH = D-H;
-				Int32 BG = B-G;
-				Int32 AE = A-E;
-				Int32 CF = C-F;
-
-				// Resample water depth to bitmap.
-				Data0[U*2+0]	= DistTable[512+AE*2];
-				Data1[U*2+0]	= DistTable[512+CF+AE];
-				Data0[U*2+1]	= DistTable[512+BG+AE];
-				Data1[U*2+1]	= DistTable[512+(DH+BG+AE+CF)/2];
-			}
-
-			ThisWater1 = NextWater1;
-			ThisWater2 = NextWater2;
-		}
-	}
-	else
-	{
-		// Apply even water filter.
-		UInt8*	PrevWater1	= ZBuffer + ((V2Size-1) << UBits);
-		UInt8*	PrevWater2	= PrevWater1 + U2Size;
-
-		for( Int32 V=0; V<V2Size; V++ )
-		{
-			UInt8*	ThisWater1	= ZBuffer + (V << UBits);
-			UInt8*	ThisWater2	= ThisWater1 + U2Size;
-
-			for( Int32 U=0; U<U2Size; U++ )
-			{
-				// Sample values.
-				Int32 A = PrevWater2[(U-1) & U2Mask];
-				Int32 B = PrevWater2[U];
-				Int32 C = ThisWater2[(U-1) & U2Mask];
-				Int32 D = ThisWater2[U];
-
-				// Put pixel.
-				ThisWater1[U] = WaveTab[512+A+B+C+D-2*ThisWater1[U]];
-			}
-
-			PrevWater1 = ThisWater1;
-			PrevWater2 = ThisWater2;
-		}
-	}
+	DemoWaterFilter( ZBuffer, (UInt8*)GetData(), UBits, VBits, WaveTab, DistTable, Phase & 1 );
 }
 
 
@@ -2423,22 +3039,7 @@ void FTechBitmap::Redraw()
 //
 void FTechBitmap::CalculateBumpMap()
 {
-	UInt8* Data = static_cast<UInt8*>(GetData());
-	UInt8* Source = ZBuffer;
-
-	for( Int32 V=0; V<VSize; V++ )
-	{
-		UInt8* DataLine = Data + (V << UBits);
-		UInt8* SourceLine = Source + (V << UBits);
-
-		for( Int32 U=0; U<USize; U++ )
-		{
-			Int32 A = SourceLine[(U+1) & UMask];
-			Int32 B = SourceLine[(U-1) & UMask];
-
-			DataLine[U] = LightTable[255 + A + (B >> 2) - B];
-		}
-	}
+	DemoBumpMap( ZBuffer, (UInt8*)GetData(), UBits, VBits, LightTable );
 }
 
 
@@ -2694,21 +3295,7 @@ void FGlassBitmap::RenderGlassI()
 	Int32 PosX = (HOffset + math::round(Time*HSpeed)) & UMask;
 	Int32 PosY = (VOffset + math::round(Time*VSpeed)) & VMask;
 
-	UInt8* Dst = (UInt8*)GetData();
-	UInt8* Img = (UInt8*)Image->GetData();
-	UInt8* Gls = (UInt8*)Glass->GetData();
-
-	for( Int32 V=0; V<VSize; V++ )
-	{
-		UInt8* DstLine	= &Dst[V << UBits];
-		UInt8* ImgLine	= &Img[V << UBits];
-		UInt8* GlsLine	= &Gls[((V+PosY) & VMask) << UBits];
-
-		for( Int32 U=0; U<USize; U++ )
-		{
-			DstLine[U]	= ImgLine[(GlsLine[(PosX+U) & UMask]+U) & UMask];
-		}
-	}
+	DemoGlass( (UInt8*)Image->GetData(), (UInt8*)Glass->GetData(), (UInt8*)GetData(), UBits, VBits, PosX, PosY, true );
 }
 
 
@@ -2722,21 +3309,7 @@ void FGlassBitmap::RenderGlassII()
 	Int32 PosX = (HOffset + math::round(Time*HSpeed)) & UMask;
 	Int32 PosY = (VOffset + math::round(Time*VSpeed)) & VMask;
 
-	UInt8* Dst = (UInt8*)GetData();
-	UInt8* Img = (UInt8*)Image->GetData();
-	UInt8* Gls = (UInt8*)Glass->GetData();
-
-	for( Int32 V=0; V<VSize; V++ )
-	{
-		UInt8* DstLine	= &Dst[V << UBits];
-		UInt8* ImgLine	= &Img[((V+PosY) & VMask) << UBits];
-		UInt8* GlsLine	= &Gls[V << UBits];
-
-		for( Int32 U=0; U<USize; U++ )
-		{
-			DstLine[U]	= ImgLine[(GlsLine[U]+U+PosX) & UMask];
-		}
-	}
+	DemoGlass( (UInt8*)Image->GetData(), (UInt8*)Glass->GetData(), (UInt8*)GetData(), UBits, VBits, PosX, PosY, false );
 }
 
 
@@ -2907,20 +3480,7 @@ void FHarmonicBitmap::Export( CExporterBase& Ex )
 //
 void FHarmonicBitmap::RenderHarmonicV()
 {
-	UInt8* Dst	= (UInt8*)GetData();
-	UInt8* Src	= (UInt8*)Image->GetData();
-
-	for( Int32 U=0; U<USize; U++ )
-	{
-		UInt8*	DstRow	= &Dst[U];
-		UInt8*	SrcRow	= &Src[(U+HOffset) & VMask];
-		Int32 WaveOff	= VOffset + ((SineTab[(Phase+((U*WaveFreq)>>4)) & 0xff]*WaveAmpl) >> 8);
-
-		for( Int32 V=0; V<VSize; V++ )
-		{
-			DstRow[V << UBits]	= SrcRow[((V+WaveOff) & VMask) << UBits];
-		}
-	}
+	DemoHarmonic( (UInt8*)Image->GetData(), (UInt8*)GetData(), UBits, VBits, SineTab, Phase, WaveFreq, WaveAmpl, HOffset, VOffset, true );
 }
 
 
@@ -2929,20 +3489,7 @@ void FHarmonicBitmap::RenderHarmonicV()
 //
 void FHarmonicBitmap::RenderHarmonicH()
 {
-	UInt8* Dst	= (UInt8*)GetData();
-	UInt8* Src	= (UInt8*)Image->GetData();
-
-	for( Int32 V=0; V<VSize; V++ )
-	{
-		UInt8*	DstLine	= &Dst[V << UBits];
-		UInt8*	SrcLine	= &Src[((V+VOffset) & VMask) << UBits];
-		Int32 WaveOff	= HOffset + ((SineTab[(Phase+((V*WaveFreq)>>4)) & 0xff]*WaveAmpl) >> 8);
-
-		for( Int32 U=0; U<USize; U++ )
-		{
-			DstLine[U] = SrcLine[(U+WaveOff) & UMask];
-		}
-	}
+	DemoHarmonic( (UInt8*)Image->GetData(), (UInt8*)GetData(), UBits, VBits, SineTab, Phase, WaveFreq, WaveAmpl, HOffset, VOffset, false );
 }
 
 
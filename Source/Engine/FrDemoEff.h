@@ -5,6 +5,25 @@
 
 #define DEMO_EFFECTS_ENABLED 0
 
+/*-----------------------------------------------------------------------------
+    Demo effects kernels.
+-----------------------------------------------------------------------------*/
+
+//
+// Per-pixel kernels of the demo bitmaps, they work with power of
+// two 8-bit frames. Rows are split across job workers and the pure
+// arithmetic filters use SSE2. The bScalar flag forces the original
+// single threaded code, output of both paths is bit-identical.
+//
+extern void DemoRisingFire( const UInt8* Src, UInt8* Dst, Int32 UBits, Int32 VBits, const UInt8* FireTable, const Int32* ShiftTab, UInt8 Seed, Bool bScalar = false );
+extern void DemoPlasmaHeat( UInt8* Heat, Int32 UBits, Int32 VBits, const UInt8 PlasmaTable[4][256], const UInt8* SineTab, UInt32 Phase, Bool bScalar = false );
+extern void DemoPlasmaRender( const UInt8* Heat, UInt8* Dst, Int32 UBits, Int32 VBits, UInt32 Phase, Bool bScalar = false );
+extern void DemoWaterFilter( UInt8* ZBuffer, UInt8* Dst, Int32 UBits, Int32 VBits, const UInt8* WaveTab, const UInt8* DistTable, Bool bOdd, Bool bScalar = false );
+extern void DemoWaterRender( const UInt8* Image, UInt8* Water, Int32 UBits, Int32 VBits, Bool bScalar = false );
+extern void DemoBumpMap( const UInt8* Source, UInt8* Dst, Int32 UBits, Int32 VBits, const UInt8* LightTable, Bool bScalar = false );
+extern void DemoGlass( const UInt8* Image, const UInt8* Glass, UInt8* Dst, Int32 UBits, Int32 VBits, Int32 PosX, Int32 PosY, Bool bMoveGlass, Bool bScalar = false );
+extern void DemoHarmonic( const UInt8* Src, UInt8* Dst, Int32 UBits, Int32 VBits, const UInt8* SineTab, UInt32 Phase, Int32 Freq, Int32 Ampl, Int32 HOffset, Int32 VOffset, Bool bVertical, Bool bScalar = false );
+
 #if DEMO_EFFECTS_ENABLED
 
 /*-----------------------------------------------------------------------------
@@ -160,6 +179,7 @@ public:
 
 	// FFireBitmap interface.
 	FFireBitmap();
+	~FFireBitmap();
 
 	// FBitmap interface.
 	void Init( Int32 InU, Int32 InV );
@@ -180,6 +200,7 @@ private:
 	UInt8		FireTable[512];
 	Int32		NumSparks;
 	TSpark		Sparks[MAX_FIRE_SPARKS];
+	UInt8*		BackBuffer;
 
 	// FFireBitmap interface.
 	void AddSpark( Int32 X, Int32 Y );
@@ -5,6 +5,488 @@
 
 #include "Engine.h"
 
+/*-----------------------------------------------------------------------------
+    CParticleSet implementation.
+-----------------------------------------------------------------------------*/
+
+//
+// Number of float streams in set.
+//
+#define PARTICLE_FLOAT_STREAMS		10
+
+//
+// Particles update step constructor.
+//
+TParticleStep::TParticleStep( EParticleMotion InMotion, Float InDelta )
+	:	Motion( InMotion ),
+		Delta( InDelta ),
+		bLinearSize( false ),
+		Acceleration( 0.f, 0.f ),
+		Alpha( 1.f ),
+		Beta( 1.f ),
+		Shift( 0.f ),
+		X( 0.f ),
+		Y( 0.f )
+{
+	SizeRange[0]	= 1.f;
+	SizeRange[1]	= 1.f;
+}
+
+
+//
+// Particle set constructor.
+//
+CParticleSet::CParticleSet()
+	:	Data( nullptr ),
+		NumPrts( 0 ),
+		MaxPrts( 0 )
+{
+	BindStreams();
+}
+
+
+//
+// Particle set copy constructor.
+//
+CParticleSet::CParticleSet( const CParticleSet& Other )
+	:	Data( nullptr ),
+		NumPrts( 0 ),
+		MaxPrts( 0 )
+{
+	*this	= Other;
+}
+
+
+//
+// Particle set destructor.
+//
+CParticleSet::~CParticleSet()
+{
+	if( Data )
+		mem::free( Data );
+}
+
+
+//
+// Particle set copy.
+//
+CParticleSet& CParticleSet::operator=( const CParticleSet& Other )
+{
+	if( this != &Other )
+	{
+		SetLimit( Other.MaxPrts );
+
+		Int32 Capacity	= alignValue<Int32>( MaxPrts, 4 );
+		if( Capacity > 0 )
+			mem::copy( Data, Other.Data, Capacity * ( PARTICLE_FLOAT_STREAMS * sizeof(Float) + sizeof(UInt8) ) );
+
+		NumPrts		= Other.NumPrts;
+		CloudBounds	= Other.CloudBounds;
+	}
+	return *this;
+}
+
+
+//
+// Setup streams pointers.
+//
+void CParticleSet::BindStreams()
+{
+	Int32 Capacity	= alignValue<Int32>( MaxPrts, 4 );
+	Float* Streams	= (Float*)Data;
+
+	LocationX	= Streams + Capacity * 0;
+	LocationY	= Streams + Capacity * 1;
+	SpeedX		= Streams + Capacity * 2;
+	SpeedY		= Streams + Capacity * 3;
+	Rotation	= Streams + Capacity * 4;
+	SpinRate	= Streams + Capacity * 5;
+	Size		= Streams + Capacity * 6;
+	Life		= Streams + Capacity * 7;
+	MaxLifeInv	= Streams + Capacity * 8;
+	Phase		= Streams + Capacity * 9;
+	iTile		= (UInt8*)( Streams + Capacity * PARTICLE_FLOAT_STREAMS );
+}
+
+
+//
+// Change particles limit, all the
+// particles are killed.
+//
+void CParticleSet::SetLimit( Int32 NewLimit )
+{
+	assert( NewLimit >= 0 );
+
+	if( NewLimit != MaxPrts )
+	{
+		if( Data )
+			mem::free( Data );
+
+		// Pad streams, so the last four are always valid.
+		Int32 Capacity	= alignValue<Int32>( NewLimit, 4 );
+		Data	= Capacity > 0 ? (UInt8*)mem::alloc( Capacity * ( PARTICLE_FLOAT_STREAMS * sizeof(Float) + sizeof(UInt8) ) ) : nullptr;
+		MaxPrts	= NewLimit;
+
+		BindStreams();
+	}
+
+	NumPrts	= 0;
+}
+
+
+//
+// Add a new particle.
+//
+void CParticleSet::Add( const TParticle& P )
+{
+	assert( NumPrts < MaxPrts );
+	Int32 i	= NumPrts++;
+
+	LocationX[i]	= P.Location.x;
+	LocationY[i]	= P.Location.y;
+	SpeedX[i]		= P.Speed.x;
+	SpeedY[i]		= P.Speed.y;
+	Rotation[i]		= P.Rotation.toRads();
+	SpinRate[i]		= P.SpinRate;
+	Size[i]			= P.Size;
+	Life[i]			= P.Life;
+	MaxLifeInv[i]	= P.MaxLifeInv;
+	Phase[i]		= P.Phase;
+	iTile[i]		= P.iTile;
+
+	// Keep bounds valid until next update.
+	if( NumPrts == 1 )
+	{
+		CloudBounds.min	= P.Location;
+		CloudBounds.max	= P.Location;
+	}
+	else
+	{
+		CloudBounds.min.x	= min( CloudBounds.min.x, P.Location.x );
+		CloudBounds.min.y	= min( CloudBounds.min.y, P.Location.y );
+		CloudBounds.max.x	= max( CloudBounds.max.x, P.Location.x );
+		CloudBounds.max.y	= max( CloudBounds.max.y, P.Location.y );
+	}
+}
+
+
+//
+// Gather a particle from streams.
+//
+TParticle CParticleSet::Get( Int32 i ) const
+{
+	assert( i >= 0 && i < NumPrts );
+	TParticle P;
+
+	P.Location.x	= LocationX[i];
+	P.Location.y	= LocationY[i];
+	P.Speed.x		= SpeedX[i];
+	P.Speed.y		= SpeedY[i];
+	P.Rotation		= math::Angle::fromRads( Rotation[i] );
+	P.SpinRate		= SpinRate[i];
+	P.Size			= Size[i];
+	P.Life			= Life[i];
+	P.MaxLifeInv	= MaxLifeInv[i];
+	P.Phase			= Phase[i];
+	P.iTile			= iTile[i];
+
+	return P;
+}
+
+
+//
+// Move particle from one slot to another.
+//
+void CParticleSet::Move( Int32 iDst, Int32 iSrc )
+{
+	LocationX[iDst]		= LocationX[iSrc];
+	LocationY[iDst]		= LocationY[iSrc];
+	SpeedX[iDst]		= SpeedX[iSrc];
+	SpeedY[iDst]		= SpeedY[iSrc];
+	Rotation[iDst]		= Rotation[iSrc];
+	SpinRate[iDst]		= SpinRate[iSrc];
+	Size[iDst]			= Size[iSrc];
+	Life[iDst]			= Life[iSrc];
+	MaxLifeInv[iDst]	= MaxLifeInv[iSrc];
+	Phase[iDst]			= Phase[iSrc];
+	iTile[iDst]			= iTile[iSrc];
+}
+
+
+//
+// Kill outlived particles.
+//
+void CParticleSet::RemoveDead()
+{
+	for( Int32 i=0; i<NumPrts; )
+	{
+		if( Life[i] <= 0.f )
+		{
+			NumPrts--;
+			Move( i, NumPrts );
+		}
+		else
+			i++;
+	}
+}
+
+
+//
+// Update four particles at once. Motion is a template
+// parameter, so branches are resolved at compile time.
+// Bounds of particles which are still alive are gathered
+// on the way, outlived ones are removed later.
+//
+template<EParticleMotion MOTION> static void UpdateParticlesKernel( CParticleSet& Set, const TParticleStep& Step, 
+	Int32 First, Int32 Last, math::Rect& OutBounds )
+{
+	using namespace math::simd;
+	assert( First % 4 == 0 );
+
+	const Float4 One		= splat( 1.f );
+	const Float4 Delta		= splat( Step.Delta );
+	const Float4 AccX		= splat( Step.Acceleration.x * Step.Delta );
+	const Float4 AccY		= splat( Step.Acceleration.y * Step.Delta );
+	const Float4 Alpha		= splat( Step.Alpha );
+	const Float4 Beta		= splat( Step.Beta );
+	const Float4 Shift		= splat( Step.Shift );
+	const Float4 AmpX		= splat( Step.X );
+	const Float4 AmpY		= splat( Step.Y );
+	const Float4 TwoPi		= splat( 2.f * math::PI );
+	const Float4 Jitter		= splat( 5.f );
+	const Float4 SizeFrom	= splat( Step.SizeRange[0] );
+	const Float4 SizeSpan	= splat( Step.SizeRange[1] - Step.SizeRange[0] );
+	const Float4 Zero		= _mm_setzero_ps();
+	const Float4 Big		= splat( 1.0e+30f );
+	const Float4 NegBig		= splat( -1.0e+30f );
+
+	Float4 MinX = Big, MinY = Big;
+	Float4 MaxX = NegBig, MaxY = NegBig;
+
+	for( Int32 i=First; i<Last; i+=4 )
+	{
+		Float4 LocX		= load( &Set.LocationX[i] );
+		Float4 LocY		= load( &Set.LocationY[i] );
+		Float4 SpdX		= load( &Set.SpeedX[i] );
+		Float4 SpdY		= load( &Set.SpeedY[i] );
+		Float4 Life		= load( &Set.Life[i] );
+		Float4 LifeInv	= load( &Set.MaxLifeInv[i] );
+
+		if( MOTION == PMT_Physics )
+		{
+			LocX	= _mm_add_ps( LocX, _mm_mul_ps( SpdX, Delta ) );
+			LocY	= _mm_add_ps( LocY, _mm_mul_ps( SpdY, Delta ) );
+			store( &Set.SpeedX[i], _mm_add_ps( SpdX, AccX ) );
+			store( &Set.SpeedY[i], _mm_add_ps( SpdY, AccY ) );
+		}
+		else if( MOTION == PMT_Lissajous )
+		{
+			// Individual 'time' for each particle, speed stores spawn location.
+			Float4 T	= _mm_add_ps( _mm_mul_ps( _mm_mul_ps( Life, LifeInv ), TwoPi ), load( &Set.Phase[i] ) );
+			LocX	= _mm_add_ps( SpdX, _mm_mul_ps( AmpX, sin( _mm_add_ps( _mm_mul_ps( Alpha, T ), Shift ) ) ) );
+			LocY	= _mm_add_ps( SpdY, _mm_mul_ps( AmpY, sin( _mm_mul_ps( Beta, T ) ) ) );
+		}
+		else if( MOTION == PMT_Snow )
+		{
+			// Speed.x stores origin, to apply jitter effect.
+			Float4 Phase	= load( &Set.Phase[i] );
+			LocX	= _mm_add_ps( SpdX, _mm_mul_ps( sin( Phase ), Jitter ) );
+			LocY	= _mm_sub_ps( LocY, _mm_mul_ps( SpdY, Delta ) );
+			store( &Set.Phase[i], _mm_add_ps( Phase, Delta ) );
+		}
+		else
+		{
+			LocY	= _mm_sub_ps( LocY, _mm_mul_ps( SpdY, Delta ) );
+		}
+
+		store( &Set.LocationX[i], LocX );
+		store( &Set.LocationY[i], LocY );
+
+		Life	= _mm_sub_ps( Life, Delta );
+		store( &Set.Life[i], Life );
+		store( &Set.Rotation[i], _mm_add_ps( load( &Set.Rotation[i] ), _mm_mul_ps( load( &Set.SpinRate[i] ), Delta ) ) );
+
+		// Padding lanes of the last four are never alive.
+		Float4 Alive	= _mm_cmpgt_ps( Life, Zero );
+
+		if( i + 4 > Last )
+			Alive	= _mm_and_ps( Alive, laneMask( Last - i ) );
+
+		MinX	= _mm_min_ps( MinX, select( Alive, LocX, Big ) );
+		MinY	= _mm_min_ps( MinY, select( Alive, LocY, Big ) );
+		MaxX	= _mm_max_ps( MaxX, select( Alive, LocX, NegBig ) );
+		MaxY	= _mm_max_ps( MaxY, select( Alive, LocY, NegBig ) );
+
+		if( Step.bLinearSize )
+		{
+			Float4 Age	= _mm_sub_ps( One, _mm_mul_ps( Life, LifeInv ) );
+			store( &Set.Size[i], _mm_add_ps( SizeFrom, _mm_mul_ps( SizeSpan, Age ) ) );
+		}
+	}
+
+	OutBounds.min.x	= horizontalMin( MinX );
+	OutBounds.min.y	= horizontalMin( MinY );
+	OutBounds.max.x	= horizontalMax( MaxX );
+	OutBounds.max.y	= horizontalMax( MaxY );
+}
+
+
+//
+// Update particles in range [First..Last), First should
+// be multiple of four. Outlived particles are not removed,
+// bounds of alive ones are returned, min is greater than max
+// if no one survived.
+//
+void CParticleSet::Update( const TParticleStep& Step, Int32 First, Int32 Last, math::Rect& OutBounds )
+{
+	assert( First >= 0 && Last <= NumPrts );
+
+	switch( Step.Motion )
+	{
+		case PMT_Physics:
+			UpdateParticlesKernel<PMT_Physics>( *this, Step, First, Last, OutBounds );
+			break;
+
+		case PMT_Lissajous:
+			UpdateParticlesKernel<PMT_Lissajous>( *this, Step, First, Last, OutBounds );
+			break;
+
+		case PMT_Snow:
+			UpdateParticlesKernel<PMT_Snow>( *this, Step, First, Last, OutBounds );
+			break;
+
+		case PMT_Rain:
+			UpdateParticlesKernel<PMT_Rain>( *this, Step, First, Last, OutBounds );
+			break;
+	}
+}
+
+
+//
+// A particles update context.
+//
+struct TParticleUpdate
+{
+	CParticleSet*			Set;
+	const TParticleStep*	Step;
+	math::Rect				TaskBounds[CParticleSet::MAX_TASKS];
+};
+
+
+//
+// Job system entry.
+//
+static void ParticleUpdateTask( void* Data, Int32 iTask, Int32 First, Int32 Last )
+{
+	TParticleUpdate* Update	= (TParticleUpdate*)Data;
+	Update->Set->Update( *Update->Step, First, Last, Update->TaskBounds[iTask] );
+}
+
+
+//
+// Update all the particles, compute cloud bounds 
+// and kill outlived ones.
+//
+void CParticleSet::Update( const TParticleStep& Step )
+{
+	if( NumPrts == 0 )
+		return;
+
+	// Split large set into tasks, ranges are aligned to SIMD width.
+	TParticleUpdate Update;
+	Update.Set	= this;
+	Update.Step	= &Step;
+
+	Int32 NumTasks	= job::parallelFor( NumPrts, PARTICLES_PER_TASK, MAX_TASKS, ParticleUpdateTask, &Update, 4 );
+	RemoveDead();
+
+	// Merge bounds of survived particles.
+	if( NumPrts > 0 )
+	{
+		CloudBounds	= Update.TaskBounds[0];
+
+		for( Int32 iTask=1; iTask<NumTasks; iTask++ )
+		{
+			const math::Rect& Bounds	= Update.TaskBounds[iTask];
+
+			CloudBounds.min.x	= min( CloudBounds.min.x, Bounds.min.x );
+			CloudBounds.min.y	= min( CloudBounds.min.y, Bounds.min.y );
+			CloudBounds.max.x	= max( CloudBounds.max.x, Bounds.max.x );
+			CloudBounds.max.y	= max( CloudBounds.max.y, Bounds.max.y );
+		}
+	}
+}
+
+
+//
+// Write four vertices for each particle. Rotated corners
+// are computed for four particles at once, color is taken
+// from the table by particle age.
+//
+void CParticleSet::BuildQuads( gfx::ParticleDrawer::Vertex* OutVerts, const math::Vector TileCoords[][4], const math::Color* ColorTable ) const
+{
+	using namespace math::simd;
+	assert( OutVerts && TileCoords && ColorTable );
+
+	const Float4 Zero		= _mm_setzero_ps();
+	const Float4 One		= splat( 1.f );
+	const Float4 Half		= splat( 0.5f );
+	const Float4 HalfPi		= splat( 0.5f * math::PI );
+	const Float4 ColorScale	= splat( (Float)(FEmitterComponent::COLOR_TABLE_SIZE-1) );
+
+	alignas(16) Float	CornerX[4][4];
+	alignas(16) Float	CornerY[4][4];
+	alignas(16) Int32	iColor[4];
+
+	for( Int32 i=0; i<NumPrts; i+=4 )
+	{
+		Float4 LocX		= load( &LocationX[i] );
+		Float4 LocY		= load( &LocationY[i] );
+		Float4 Side		= _mm_mul_ps( load( &Size[i] ), Half );
+		Float4 Rot		= load( &Rotation[i] );
+
+		// Axes are ( cos, sin ) and ( -sin, cos ).
+		Float4 Cos		= _mm_mul_ps( sin( _mm_add_ps( Rot, HalfPi ) ), Side );
+		Float4 Sin		= _mm_mul_ps( sin( Rot ), Side );
+
+		Float4 X1		= _mm_sub_ps( LocX, Cos );
+		Float4 X2		= _mm_add_ps( LocX, Cos );
+		Float4 Y1		= _mm_sub_ps( LocY, Sin );
+		Float4 Y2		= _mm_add_ps( LocY, Sin );
+
+		_mm_store_ps( CornerX[0], _mm_add_ps( X1, Sin ) );
+		_mm_store_ps( CornerY[0], _mm_sub_ps( Y1, Cos ) );
+		_mm_store_ps( CornerX[1], _mm_sub_ps( X1, Sin ) );
+		_mm_store_ps( CornerY[1], _mm_add_ps( Y1, Cos ) );
+		_mm_store_ps( CornerX[2], _mm_sub_ps( X2, Sin ) );
+		_mm_store_ps( CornerY[2], _mm_add_ps( Y2, Cos ) );
+		_mm_store_ps( CornerX[3], _mm_add_ps( X2, Sin ) );
+		_mm_store_ps( CornerY[3], _mm_sub_ps( Y2, Cos ) );
+
+		// Particle age in [0..1].
+		Float4 Age		= _mm_sub_ps( One, _mm_mul_ps( load( &Life[i] ), load( &MaxLifeInv[i] ) ) );
+		Age				= _mm_min_ps( _mm_max_ps( Age, Zero ), One );
+		_mm_store_si128( (__m128i*)iColor, _mm_cvttps_epi32( _mm_mul_ps( Age, ColorScale ) ) );
+
+		Int32 NumLanes	= min( 4, NumPrts - i );
+
+		for( Int32 iLane=0; iLane<NumLanes; iLane++ )
+		{
+			gfx::ParticleDrawer::Vertex*	V = &OutVerts[(i+iLane)*4];
+			const math::Vector*				TC = TileCoords[iTile[i+iLane]];
+			math::Color						Color = ColorTable[iColor[iLane]];
+
+			for( Int32 iCorner=0; iCorner<4; iCorner++ )
+			{
+				V[iCorner].pos		= math::Vector( CornerX[iCorner][iLane], CornerY[iCorner][iLane] );
+				V[iCorner].tc		= TC[iCorner];
+				V[iCorner].color	= Color;
+			}
+		}
+	}
+}
+
+
 /*-----------------------------------------------------------------------------
     FEmitterComponent implementation.
 -----------------------------------------------------------------------------*/
@@ -23,8 +505,9 @@ FEmitterComponent::FEmitterComponent()
 		NumUTiles( 1 ),
 		NumVTiles( 1 ),
 		Particles(),
-		NumPrts( 0 ),
-		Accumulator( 0.f )
+		Accumulator( 0.f ),
+		CachedUTiles( 0 ),
+		CachedVTiles( 0 )
 {
 	bRenderable			= true;
 
@@ -99,7 +582,8 @@ void FEmitterComponent::UpdateEmitter( Float Delta )
 
 
 //
-// Return particle system cloud bound.
+// Return particle system cloud bound. Particles
+// bounds are computed during the update.
 //
 math::Rect FEmitterComponent::GetCloudRect()
 {
@@ -107,15 +591,14 @@ math::Rect FEmitterComponent::GetCloudRect()
 	Result.min		= Base->Location;
 	Result.max		= Base->Location;
 
-	for( Int32 i=0; i<NumPrts; i++ )
+	if( Particles.HasBounds() )
 	{
-		TParticle& P = Particles[i];
+		const math::Rect& Bounds = Particles.Bounds();
 
-		// Update bounds.
-		Result.min.x	= min( Result.min.x, P.Location.x );
-		Result.min.y	= min( Result.min.y, P.Location.y );
-		Result.max.x	= max( Result.max.x, P.Location.x );
-		Result.max.y	= max( Result.max.y, P.Location.y );
+		Result.min.x	= min( Result.min.x, Bounds.min.x );
+		Result.min.y	= min( Result.min.y, Bounds.min.y );
+		Result.max.x	= max( Result.max.x, Bounds.max.x );
+		Result.max.y	= max( Result.max.y, Bounds.max.y );
 	}
 
     // Cloud bound is compute, but necessary to consider
@@ -144,11 +627,10 @@ void FEmitterComponent::TickNonPlay( Float Delta )
 void FEmitterComponent::Tick( Float Delta )
 {
 	// Reallocate list, if need.
-	if( MaxParticles != Particles.size() )
+	if( MaxParticles != Particles.Limit() )
 	{
 		MaxParticles	= clamp<Int32>( MaxParticles, 1, MAX_PARTICLES );
-		NumPrts			= 0;
-		Particles.setSize( MaxParticles );
+		Particles.SetLimit( MaxParticles );
 	}
 
 	// Not really good way to determinate
@@ -204,24 +686,35 @@ void FEmitterComponent::SerializeThis( CSerializer& S )
 	Serialize( S, Texture );
 	Serialize( S, NumUTiles );
 	Serialize( S, NumVTiles );
+
+	Int32 NumPrts = Particles.Num();
 	Serialize( S, NumPrts );
 
 	// Temporally shrink particles tables,
-	// to store only "active" particles.
+	// to store only "active" particles. Particles
+	// are stored as an array of TParticle.
 	if( S.GetMode() == SM_Save )
 	{
 		// Really reduce particles count, it's can crash
 		// even CObjectDatabase!
 		Int32 NumToSave = min( 100, NumPrts );
-		if( NumToSave )
-			S.SerializeData( &Particles[0], NumToSave*sizeof(TParticle) );
+		for( Int32 i=0; i<NumToSave; i++ )
+		{
+			TParticle P = Particles.Get( i );
+			S.SerializeData( &P, sizeof(TParticle) );
+		}
 	}
 	else if( S.GetMode() == SM_Load )
 	{
 		Int32 NumToLoad = min( 100, NumPrts );
-		Particles.setSize(NumToLoad);
-		if( NumToLoad )
-			S.SerializeData( &Particles[0], NumToLoad*sizeof(TParticle) );
+		Particles.SetLimit( clamp<Int32>( MaxParticles, 1, MAX_PARTICLES ) );
+		for( Int32 i=0; i<NumToLoad; i++ )
+		{
+			TParticle P;
+			S.SerializeData( &P, sizeof(TParticle) );
+			if( Particles.Num() < Particles.Limit() )
+				Particles.Add( P );
+		}
 	}
 }
 
@@ -278,7 +771,7 @@ void FLissajousEmitterComponent::UpdateEmitter( Float DeltaTime )
 	Int32 NewPrts = math::trunc( Accumulator * EmitPerSec );
 	if( NewPrts > 0 )
 		Accumulator = 0.f;
-	while( NewPrts>0 && NumPrts<MaxParticles )
+	while( NewPrts>0 && Particles.Num()<Particles.Limit() )
 	{
 		TParticle P;
 		P.Location.x	= RandomRange( Basis.x-SpawnArea.x, Basis.x+SpawnArea.x );
@@ -305,40 +798,22 @@ void FLissajousEmitterComponent::UpdateEmitter( Float DeltaTime )
 		}
 
 		// Add to list.
-		Particles[NumPrts]	= P;
-		NumPrts++;
+		Particles.Add( P );
 		NewPrts--;
 	}
 	
 	// Process Lissajous physics.
-	for( Int32 i=0; i<NumPrts;  )
-	{
-		TParticle& P = Particles[i];
-
-		// Individual 'time' for each particle.
-		Float T = P.Life * P.MaxLifeInv * (2.f*math::PI) + P.Phase;
-
-		P.Location.x	= P.Speed.x + X * math::sin( Alpha * T + Delta );
-		P.Location.y	= P.Speed.y + Y * math::sin( Beta * T );
-
-		P.Rotation		+= DeltaTime * P.SpinRate;
-		P.Life			-= DeltaTime;
-
-		if( SizeParam == PPT_Linear )
-		{
-			Float Alpha = 1.f - P.Life * P.MaxLifeInv;
-			P.Size		= SizeRange[0] + (SizeRange[1]-SizeRange[0]) * Alpha;
-		}
-
-		// Kill outlived.
-		if( P.Life <= 0.f )
-		{
-			NumPrts--;
-			Particles[i]	= Particles[NumPrts];
-		}
-		else
-			i++;
-	}
+	TParticleStep Step( PMT_Lissajous, DeltaTime );
+	Step.bLinearSize	= SizeParam == PPT_Linear;
+	Step.SizeRange[0]	= SizeRange[0];
+	Step.SizeRange[1]	= SizeRange[1];
+	Step.Alpha			= Alpha;
+	Step.Beta			= Beta;
+	Step.Shift			= Delta;
+	Step.X				= X;
+	Step.Y				= Y;
+
+	Particles.Update( Step );
 }
 
 
@@ -407,7 +882,7 @@ void FWeatherEmitterComponent::UpdateEmitter( Float Delta )
 	Int32 NewPrts = math::trunc( Accumulator * EmitPerSec );
 	if( NewPrts > 0 )
 		Accumulator = 0.f;
-	while( NewPrts>0 && NumPrts<MaxParticles )
+	while( NewPrts>0 && Particles.Num()<Particles.Limit() )
 	{
 		TParticle P;
 		P.Location.x	= RandomRange( -SpawnArea.x, SpawnArea.x ) + Level->Camera.Location.x;
@@ -446,41 +921,13 @@ void FWeatherEmitterComponent::UpdateEmitter( Float Delta )
 		}
 		
 		// Add to list.
-		Particles[NumPrts]	= P;
-		NumPrts++;
+		Particles.Add( P );
 		NewPrts--;
 	}
 
 	// Process weather physics.
-	for( Int32 i=0; i<NumPrts;  )
-	{
-		TParticle& P = Particles[i];
-
-		if( WeatherType == WEATHER_Snow )
-		{
-			// Snowflake physics.
-			P.Location.x	= P.Speed.x + math::sin(P.Phase)*5.f;
-			P.Location.y	-= P.Speed.y * Delta;
-			P.Phase			+= Delta;
-		}
-		else
-		{
-			// Raindrop physics.
-			P.Location.y -= P.Speed.y * Delta;
-		}
-
-		P.Rotation		+= Delta * P.SpinRate;
-		P.Life			-= Delta;
-
-		// Kill outlived.
-		if( P.Life <= 0.f )
-		{
-			NumPrts--;
-			Particles[i]	= Particles[NumPrts];
-		}
-		else
-			i++;
-	}
+	TParticleStep Step( WeatherType == WEATHER_Snow ? PMT_Snow : PMT_Rain, Delta );
+	Particles.Update( Step );
 }
 
 
@@ -526,7 +973,7 @@ void FPhysEmitterComponent::UpdateEmitter( Float Delta )
 	Int32 NewPrts = math::trunc( Accumulator * EmitPerSec );
 	if( NewPrts > 0 )
 		Accumulator = 0.f;
-	while( NewPrts>0 && NumPrts<MaxParticles )
+	while( NewPrts>0 && Particles.Num()<Particles.Limit() )
 	{
 		TParticle P;
 		P.Location.x	= RandomRange( Basis.x-SpawnArea.x, Basis.x+SpawnArea.x );
@@ -555,36 +1002,18 @@ void FPhysEmitterComponent::UpdateEmitter( Float Delta )
 		}
 
 		// Add to list.
-		Particles[NumPrts]	= P;
-		NumPrts++;
+		Particles.Add( P );
 		NewPrts--;
 	}
 
 	// Process physics.
-	for( Int32 i=0; i<NumPrts;  )
-	{
-		TParticle& P = Particles[i];
-
-		P.Location		+= P.Speed * Delta;
-		P.Speed			+= WorldAcc * Delta;
-		P.Life			-= Delta;
-		P.Rotation		+= Delta * P.SpinRate;
+	TParticleStep Step( PMT_Physics, Delta );
+	Step.bLinearSize	= SizeParam == PPT_Linear;
+	Step.SizeRange[0]	= SizeRange[0];
+	Step.SizeRange[1]	= SizeRange[1];
+	Step.Acceleration	= WorldAcc;
 
-		if( SizeParam == PPT_Linear )
-		{
-			Float Alpha = 1.f - P.Life * P.MaxLifeInv;
-			P.Size		= SizeRange[0] + (SizeRange[1]-SizeRange[0]) * Alpha;
-		}
-
-		// Kill outlived.
-		if( P.Life <= 0.f )
-		{
-			NumPrts--;
-			Particles[i]	= Particles[NumPrts];
-		}
-		else
-			i++;
-	}
+	Particles.Update( Step );
 }
 
 
@@ -611,6 +1040,65 @@ inline math::Color ColorLerp( math::Color Color1, math::Color Color2, UInt8 Alph
 }
 
 
+//
+// Rebuild tile and color tables, if emitter
+// was changed.
+//
+void FEmitterComponent::UpdateRenderTables()
+{
+	Bool bFirstTime	= CachedUTiles == 0;
+
+	NumUTiles	= clamp<UInt8>( NumUTiles, 1, 4 );
+	NumVTiles	= clamp<UInt8>( NumVTiles, 1, 4 );
+
+	// Texture coords for each tile. Out of range tiles
+	// are wrapped, since tiles count may be changed.
+	if( CachedUTiles != NumUTiles || CachedVTiles != NumVTiles )
+	{
+		Int32 NumTiles	= NumUTiles * NumVTiles;
+
+		for( Int32 iSlot=0; iSlot<MAX_TILES; iSlot++ )
+		{
+			Int32	iTile	= iSlot % NumTiles;
+			Int32	U		= iTile % NumUTiles;
+			Int32	V		= iTile / NumUTiles;
+
+			Float	X1		= (Float)(U+0.f) / (Float)NumUTiles;
+			Float	X2		= (Float)(U+1.f) / (Float)NumUTiles;
+
+			Float	Y1		= 1.f - (Float)(V+0.f) / (Float)NumVTiles;
+			Float	Y2		= 1.f - (Float)(V+1.f) / (Float)NumVTiles;
+
+			TileCoords[iSlot][0]	= math::Vector( X1, Y1 );
+			TileCoords[iSlot][1]	= math::Vector( X1, Y2 );
+			TileCoords[iSlot][2]	= math::Vector( X2, Y2 );
+			TileCoords[iSlot][3]	= math::Vector( X2, Y1 );
+		}
+
+		CachedUTiles	= NumUTiles;
+		CachedVTiles	= NumVTiles;
+	}
+
+	// Color for each particle age.
+	if( bFirstTime || CachedColors[0] != Colors[0] || CachedColors[1] != Colors[1] || CachedColors[2] != Colors[2] )
+	{
+		for( Int32 i=0; i<COLOR_TABLE_SIZE; i++ )
+		{
+			Float Alpha = (Float)i / (Float)(COLOR_TABLE_SIZE-1);
+
+			if( Alpha < 0.5f )
+				ColorTable[i]	= ColorLerp( Colors[0], Colors[1], (UInt8)(Alpha*512) );
+			else
+				ColorTable[i]	= ColorLerp( Colors[1], Colors[2], (UInt8)min( (Alpha-0.5f)*512, 255.f ) );
+		}
+
+		CachedColors[0]	= Colors[0];
+		CachedColors[1]	= Colors[1];
+		CachedColors[2]	= Colors[2];
+	}
+}
+
+
 //
 // Render particles.
 //
@@ -625,112 +1113,34 @@ void FEmitterComponent::Render( CCanvas* Canvas )
 	if( !Canvas->viewInfo().bounds.isOverlap( Cloud ) )
 		return;
 
-#if 0
-	// Compute texture coords for each tile, will
-	// be cool to cache it.
-	TRect CoordTable[16];
-	for( Integer V=0; V<NumVTiles; V++ )
-		for( Integer U=0; U<NumUTiles; U++ )
-		{
-			CoordTable[V*NumUTiles+U].Min.X	= (Float)(U+0.f) / (Float)NumUTiles;
-			CoordTable[V*NumUTiles+U].Max.X	= (Float)(U+1.f) / (Float)NumUTiles;
-
-			CoordTable[V*NumUTiles+U].Min.Y	= 1.f - (Float)(V+0.f) / (Float)NumVTiles;
-			CoordTable[V*NumUTiles+U].Max.Y	= 1.f - (Float)(V+1.f) / (Float)NumVTiles;
-		}
-
-	// Initialize shared fields of render rect.
-	TRenderRect Rect;
-	Rect.Flags			= POLY_Unlit*bUnlit | !(Level->RndFlags & RND_Lighting);
-	Rect.Rotation		= 0;
-	Rect.Bitmap			= Bitmap;
-	
-	// Render particles.
-	for( Integer i=0; i<NumPrts; i++ )
-	{
-		TParticle&	P = Particles[i];
-		Float		Side = P.Size * 0.5f;
-		Float		Alpha = 1.f - P.Life * P.MaxLifeInv;
-
-		// Interpolate color.
-		if( Alpha < 0.5f )
-			Rect.Color	= ColorLerp( Colors[0], Colors[1], (Byte)(Alpha*512) );
-		else
-			Rect.Color	= ColorLerp( Colors[1], Colors[2], (Byte)((Alpha-0.5f)*512) );
-
-		// Draw.
-		Rect.Bounds		= TRect( P.Location, Side );
-		Rect.TexCoords	= CoordTable[P.iTile];
-		Rect.Rotation	= P.Rotation;
-		Canvas->DrawRect( Rect );
-	}
-#else
-	// Compute texture coords for each tile, will
-	// be cool to cache it.
-	math::Vector CoordTable[16][4];
-	for( Int32 V=0; V<NumVTiles; V++ )
-	for( Int32 U=0; U<NumUTiles; U++ )
+	// Write quads right into the level's particles batch, canvas
+	// flushes it before any other drawing.
+	if( Texture && Particles.Num() > 0 )
 	{
-		Int32 iSlot	= V*NumUTiles+U;
+		UpdateRenderTables();
+		auto Image	= As<FBitmap>(Texture)->m_image;
 
-		Float	X1		= (Float)(U+0.f) / (Float)NumUTiles;
-		Float	X2		= (Float)(U+1.f) / (Float)NumUTiles;
+		gfx::ParticleDrawer::Vertex* Verts = Canvas->BatchParticles( Level->m_particleDrawer ).batchQuads
+		(
+			Image->getHandle(),
+			Particles.Num()
+		);
 
-		Float	Y1		= 1.f - (Float)(V+0.f) / (Float)NumVTiles;
-		Float	Y2		= 1.f - (Float)(V+1.f) / (Float)NumVTiles;
-
-		CoordTable[iSlot][0]	= math::Vector( X1, Y1 );
-		CoordTable[iSlot][1]	= math::Vector( X1, Y2 );
-		CoordTable[iSlot][2]	= math::Vector( X2, Y2 );
-		CoordTable[iSlot][3]	= math::Vector( X2, Y1 );
-	}
+		// Atlas packed image, remap tiles to its region.
+		if( Image->isAtlasRegion() )
+		{
+			math::Vector MappedCoords[MAX_TILES][4];
 
-	// Initialize list.
-	TRenderList List( NumPrts );
-	List.Image			= Texture ? As<FBitmap>(Texture)->m_image->getHandle() : INVALID_HANDLE<rend::Texture2DHandle>();
-	List.Flags			= POLY_Unlit*bUnlit | !(Level->RndFlags & RND_Lighting);
+			for( Int32 iSlot=0; iSlot<MAX_TILES; iSlot++ )
+				for( Int32 i=0; i<4; i++ )
+					MappedCoords[iSlot][i]	= Image->mapTexCoords( TileCoords[iSlot][i] );
 
-	// Initialize list.
-	for( Int32 i=0; i<NumPrts; i++ )
-	{
-		TParticle&	P = Particles[i];
-		Float		Side = P.Size * 0.5f;
-		Float		Alpha = 1.f - P.Life * P.MaxLifeInv;
-		math::Color	Color;
-
-		// Interpolate color.
-		if( Alpha < 0.5f )
-			Color	= ColorLerp( Colors[0], Colors[1], (UInt8)(Alpha*512) );
+			Particles.BuildQuads( Verts, MappedCoords, ColorTable );
+		}
 		else
-			Color	= ColorLerp( Colors[1], Colors[2], (UInt8)((Alpha-0.5f)*512) );
-
-		// Particle color.
-		List.Colors[i*4+0]	= Color;
-		List.Colors[i*4+1]	= Color;
-		List.Colors[i*4+2]	= Color;
-		List.Colors[i*4+3]	= Color;
-
-		// Texture coords.
-		List.TexCoords[i*4+0]	= CoordTable[P.iTile][0];
-		List.TexCoords[i*4+1]	= CoordTable[P.iTile][1];
-		List.TexCoords[i*4+2]	= CoordTable[P.iTile][2];
-		List.TexCoords[i*4+3]	= CoordTable[P.iTile][3];
-
-		// Vertices.
-		math::Coords Coords		= math::Coords( P.Location, P.Rotation );
-		math::Vector XAxis = Coords.xAxis * Side,
-				YAxis = Coords.yAxis * Side;
-
-		List.Vertices[i*4+0]	= P.Location - YAxis - XAxis;
-		List.Vertices[i*4+1]	= P.Location + YAxis - XAxis;
-		List.Vertices[i*4+2]	= P.Location + YAxis + XAxis;
-		List.Vertices[i*4+3]	= P.Location - YAxis + XAxis;
+			Particles.BuildQuads( Verts, TileCoords, ColorTable );
 	}
 
-	// Render particles.
-	Canvas->DrawList( List );
-#endif
-
 	// Render cloud boundS if emitter are selected.
 	if( Base->bSelected )
 		Level->m_primitiveDrawer.batchLineRect
@@ -193,10 +193,10 @@ Int32 FFont::TextWidth( const Char* Text )
 	for( const Char* C=Text; *C; C++ )
 	{
 		const auto& glyph = GetGlyph(*C);
-		width += glyph.width;
+		width += glyph.pixelWidth;
 	}
 
-	return width * m_font->getImage()->getUSize();
+	return width;
 }
 
 /*-----------------------------------------------------------------------------
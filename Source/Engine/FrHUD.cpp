@@ -167,6 +167,11 @@ void FPainterComponent::nativeTile( CFrame& Frame )
 			R.TexCoords.min.y	= T.y * Rescale[Texture->getVBits()];
 			R.TexCoords.max.x	= (T.x+TL.x)  * Rescale[Texture->getUBits()];
 			R.TexCoords.max.y	= (T.y+TL.y) * Rescale[Texture->getVBits()];
+
+			// Packed into atlas?
+			auto Image = As<FBitmap>(Texture)->m_image;
+			if( Image->isAtlasRegion() )
+				R.TexCoords	= Image->mapTexCoords( R.TexCoords );
 		}
 		else
 		{
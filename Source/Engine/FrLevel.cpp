@@ -154,6 +154,28 @@ void FLevel::PostLoad()
 }
 
 
+//
+// Refill level's fast access tables after loading, by
+// initializing entities components again.
+//
+void FLevel::InitEntities()
+{
+	for( Int32 iEntity=0; iEntity<Entities.size(); iEntity++ )
+	{
+		FEntity* Entity = Entities[iEntity];
+
+		FBaseComponent* Base = Entity->Base;
+		Entity->Base	= nullptr;
+		Base->InitForEntity( Entity );
+
+		Array<FExtraComponent*> Comps = Entity->Components;
+		Entity->Components.empty();
+		for( Int32 e=0; e<Comps.size(); e++ )
+			Comps[e]->InitForEntity( Entity );
+	}
+}
+
+
 //
 // Export the level.
 //
@@ -424,6 +446,12 @@ void FLevel::Tick( Float Delta )
 			TickObjects[i]->TickNonPlay( Delta );
 	}
 
+	// Compute requested skeleton poses.
+	{
+		profile_zone( Entity, SkelAnimation );
+		SkelAnimator.Flush();
+	}
+
 	// Destroy all marked entities.
 	{
 		profile_zone( Entity, Cleanup );
@@ -578,9 +606,19 @@ void FLevel::renderLevel( CCanvas* canvas, Int32 x, Int32 y, Int32 width, Int32
 			m_gridDrawer->render( canvas->viewInfo() );
 
 
-			// Render all objects in master view.
+			// Render all objects in master view. Consequent emitters
+			// are batched, objects which draw with own drawers
+			// should go after them.
 			for( Int32 i=0; i<RenderObjects.size(); i++ )
+			{
+				if( !RenderObjects[i]->IsA( FEmitterComponent::MetaClass ) )
+					canvas->FlushBatches();
+
 				RenderObjects[i]->Render( canvas );
+			}
+
+			canvas->FlushBatches();
+			m_particleDrawer.reportStats();
 
 			// Draw debug stuff.
 			// !!todo: add special flag for level.
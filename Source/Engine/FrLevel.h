@@ -95,6 +95,7 @@ public:
 	FSkyComponent*			Sky;
 	CCollisionHash*			CollHash;
 	CGFXManager*			GFXManager;
+	CSkeletonAnimator		SkelAnimator;
 	navi::Navigator m_navigator;
 
 	// Level variables.
@@ -156,6 +157,7 @@ public:
 	FEntity* FindEntity( String InName );
 	Int32 GetEntityIndex( FEntity* Entity );
 	void ReleaseEntity( Int32 iEntity );
+	void InitEntities();
 
 	// Collisions.
 	FBrushComponent* TestPointGeom( const math::Vector& P );
@@ -171,6 +173,7 @@ public:
 	gfx::GridDrawer::UPtr m_gridDrawer;
 
 	gfx::PrimitiveDrawer m_primitiveDrawer; // fooooooooooooooooooooooooooooooo, move somewhere else!!!!
+	gfx::ParticleDrawer m_particleDrawer;
 
 	// Level rendering
 	void renderLevel( CCanvas* canvas, Int32 x, Int32 y, Int32 width, Int32 height );
@@ -205,6 +205,11 @@ void FModelComponent::Render( CCanvas* Canvas )
 	Int32 XMax = min( math::ceil((View.max.x - Location.x) / TileSize.x), MapXSize );
 	Int32 YMax = min( math::ceil((View.max.y - Location.y) / TileSize.y), MapYSize );
 
+	// Packed into atlas? Tiles are remapped to its region.
+	img::Image::Ptr AtlasImage;
+	if( Texture && As<FBitmap>(Texture)->m_image->isAtlasRegion() )
+		AtlasImage	= As<FBitmap>(Texture)->m_image;
+
 	// Setup shared tile info.
 #if 0
 	TRenderRect Tile;
@@ -263,7 +268,7 @@ void FModelComponent::Render( CCanvas* Canvas )
 #define DRAW_TILE(itile)\
 	if( itile )\
 	{\
-		math::Rect T					= AtlasTable[itile];\
+		math::Rect T					= AtlasImage ? AtlasImage->mapTexCoords( AtlasTable[itile] ) : AtlasTable[itile];\
 		List.Vertices[NumTiles*4+0]		= math::Vector( MinX, MinY );\
 		List.Vertices[NumTiles*4+1]		= math::Vector( MinX, MaxY );\
 		List.Vertices[NumTiles*4+2]		= math::Vector( MaxX, MaxY );\
@@ -361,7 +366,7 @@ void FModelComponent::Render( CCanvas* Canvas )
 
 					if( iTile )
 					{
-						Tile.TexCoords		= AtlasTable[iTile];
+						Tile.TexCoords		= AtlasImage ? AtlasImage->mapTexCoords( AtlasTable[iTile] ) : AtlasTable[iTile];
 						Tile.Bounds.min.x	= (X + 0.f)*TileSize.x + Location.x;
 						Tile.Bounds.min.y	= (Y + 0.f)*TileSize.y + Location.y;
 						Tile.Bounds.max.x	= (X + 1.f)*TileSize.x + Location.x;
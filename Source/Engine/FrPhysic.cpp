@@ -125,6 +125,11 @@ void FSpringComponent::Render( CCanvas* Canvas )
 		Rect.Flags				= POLY_Unlit;
 		Rect.Rotation			= math::vectorToAngle((Point1-Point2).cross());
 		Rect.TexCoords			= math::Rect( math::Vector( 0.5f, 0.f ), 1.f, NumSegs );
+
+		// Packed into atlas? Segments tile, so it should be single one.
+		auto Image = As<FBitmap>(Segment)->m_image;
+		if( Image->isAtlasRegion() )
+			Rect.TexCoords	= Image->mapTexCoords( Rect.TexCoords );
 		Rect.Bounds				= math::Rect
 									( 
 										(Point1+Point2) * 0.5, 
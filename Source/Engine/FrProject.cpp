@@ -25,8 +25,16 @@ CProject::CProject()
 //
 CProject::~CProject()
 {  
-	// Kill database of FObjects.
+	// Release level snapshots.
+	for( auto& It : Snapshots )
+		delete It.value;
+	Snapshots.empty();
+	SnapshotsOrder.empty();
+
+	// Kill database of FObjects, profiled scripts
+	// bytecode goes away as well.
 	DropDatabase();
+	profile::ScriptProfiler::instance().forgetCode();
 
 	// Release BlockManager.
 	delete BlockMan;
@@ -56,190 +64,252 @@ CProject*	GProject	= nullptr;
 -----------------------------------------------------------------------------*/
 
 //
-// CLevelRefChanger - simple modification of
-// the CRefChanger to make deal with levels and their entities 
-// and components.
+// Duplicate a level, used clone used to play on it. Level
+// is captured into the snapshot, since it's might be changed
+// since last duplication.
 //
-class CLevelRefChanger: public CSerializer
+FLevel* CProject::DuplicateLevel( FLevel* Source )
 {
-public:
-	// Variables.
-	FLevel*			NewLevel;
-	FLevel*			OldLevel;
-
-	// CLevelRefChanger interface.
-	CLevelRefChanger( FLevel* InNewLevel, FLevel* InOldLevel )
-		:	NewLevel( InNewLevel ),
-			OldLevel( InOldLevel )
+	assert(Source);
+	assert(!Source->IsTemporal());
+
+	CLevelSnapshot Snapshot( Source );
+	return Snapshot.Instantiate();
+}
+
+
+//
+// Return cached level snapshot, level is captured
+// only once, so it's should be used only when levels are
+// not edited. Return nullptr, if level is not available.
+// Only MAX_LEVEL_SNAPSHOTS recently used snapshots are
+// kept, so returned snapshot is valid until next call.
+//
+CLevelSnapshot* CProject::GetLevelSnapshot( FLevel* Level )
+{
+	assert(Level);
+	assert(!Level->IsTemporal());
+
+	CLevelSnapshot** Cached = Snapshots.get( Level );
+	if( Cached )
 	{
-		Mode	= SM_Undefined;
+		SnapshotsOrder.removeShift( SnapshotsOrder.find( Level ) );
+		SnapshotsOrder.push( Level );
+		return *Cached;
 	}
 
-	// CSerializer interface.
-	void SerializeData( void* Mem, SizeT Count );
-	void SerializeRef( FObject*& Obj );		
-};
+	// Capture level, it's content is not required after,
+	// so it might be unloaded.
+	Bool bWasLoaded = IsLevelLoaded( Level );
+	if( !LoadLevel( Level ) )
+		return nullptr;
+
+	// Evict least recently used snapshot.
+	if( SnapshotsOrder.size() >= MAX_LEVEL_SNAPSHOTS )
+	{
+		FLevel* Oldest = SnapshotsOrder[0];
+		SnapshotsOrder.removeShift( 0 );
+
+		delete *Snapshots.get( Oldest );
+		Snapshots.remove( Oldest );
+	}
+
+	CLevelSnapshot* Snapshot = new CLevelSnapshot( Level );
+	Snapshots.put( Level, Snapshot );
+	SnapshotsOrder.push( Level );
 
+	if( !bWasLoaded )
+		UnloadLevel( Level );
 
-void CLevelRefChanger::SerializeData( void* Mem, SizeT Count )
+	return Snapshot;
+}
+
+
+/*-----------------------------------------------------------------------------
+	Level streaming.
+-----------------------------------------------------------------------------*/
+
+//
+// Return chunk of the level, or nullptr if level
+// is not streamed.
+//
+TLevelChunk* CProject::FindLevelChunk( FLevel* Level )
 {
+	assert(Level);
+
+	for( Int32 i=0; i<LevelChunks.size(); i++ )
+		if( LevelChunks[i].iLevel == Level->GetId() )
+			return &LevelChunks[i];
+
+	return nullptr;
 }
 
 
-void CLevelRefChanger::SerializeRef( FObject*& Obj )
+//
+// Return true, if level's content is in database.
+//
+Bool CProject::IsLevelLoaded( FLevel* Level )
 {
-	if( !Obj )
-		return;
+	TLevelChunk* Chunk = FindLevelChunk( Level );
+	return !Chunk || Chunk->bLoaded;
+}
+
+
+//
+// Load level's chunk from the game file. Objects are
+// constructed in their reserved slots, so all references
+// to them are remain valid. Return true, if level is ready.
+//
+Bool CProject::LoadLevel( FLevel* Level )
+{
+	TLevelChunk* Chunk = FindLevelChunk( Level );
+	if( !Chunk || Chunk->bLoaded )
+		return true;
+
+	UInt64 StartTime = time::cycles64();
 
-	if( Obj->IsA(FEntity::MetaClass) )
+	fm::IBinaryFileReader::Ptr File = fm::readBinaryFile( *GameFileName );
+	if( !File )
 	{
-		FEntity* Entity = (FEntity*)Obj;
-		if( Entity->Level == OldLevel )
-		{
-			Obj	= NewLevel->Entities[OldLevel->GetEntityIndex(Entity)];
-		}
+		warn( L"Game: Unable to stream level '%s' from '%s'", *Level->GetName(), *GameFileName );
+		return false;
 	}
-	else if( Obj->IsA(FBaseComponent::MetaClass) )
+
+	FileLoaderAdapter Loader( File );
+	Loader.Seek( Chunk->Offset );
+
+	// Load headers and allocate objects.
+	Int32 NumObjects;
+	Serialize( Loader, NumObjects );
+
+	Array<TObjectHeader> Headers( NumObjects );
+	for( Int32 i=0; i<NumObjects; i++ )
 	{
-		FBaseComponent* Base = (FBaseComponent*)Obj;
-		if( Base->Entity->Level == OldLevel )
-		{
-			Obj = NewLevel->Entities[OldLevel->GetEntityIndex(Base->Entity)]->Base;
-		}
+		Serialize( Loader, Headers[i] );
+
+		TObjectHeader& H = Headers[i];
+		assert(GObjects[H.Id] == nullptr);
+
+		FObject* Result = ClassesRemap[H.iClass]->Constructor();
+		assert(Result);
+
+		GObjects[H.Id]	= Result;
 	}
-	else if( Obj->IsA(FExtraComponent::MetaClass) )
+
+	// Initialize general object's fields.
+	for( Int32 i=0; i<NumObjects; i++ )
 	{
-		FExtraComponent* Extra = (FExtraComponent*)Obj;
-		if( Extra->Entity->Level == OldLevel )
-		{
-			Obj = NewLevel->Entities[OldLevel->GetEntityIndex(Extra->Entity)]->Components[Extra->Entity->Components.find(Extra)];
-		}
+		TObjectHeader& H	= Headers[i];
+		FObject*	Object	= GObjects[H.Id];
+
+		Object->Id		= H.Id;
+		Object->Class	= ClassesRemap[H.iClass];
+		Object->Name	= H.Name;
+		Object->Owner	= H.iOwner!=-1 ? GObjects[H.iOwner] : nullptr;
+
+		HashObject( Object );
 	}
-	// All others types of objects are shared, such
-	// as FResource derived.
+
+	// Load content of level and it objects.
+	Level->SerializeThis( Loader );
+
+	for( Int32 i=0; i<NumObjects; i++ )
+		GObjects[Headers[i].Id]->SerializeThis( Loader );
+
+	if( Loader.Tell() != Chunk->Offset + Chunk->Size )
+		fatal( L"Game: Level '%s' chunk is corrupted", *Level->GetName() );
+
+	// Refill level database and notify about loading.
+	Level->InitEntities();
+
+	Level->PostLoad();
+	for( Int32 i=0; i<NumObjects; i++ )
+		GObjects[Headers[i].Id]->PostLoad();
+
+	Chunk->bLoaded	= true;
+
+	info( L"Game: Level '%s' streamed in %.2f ms (%d objects, %d Kb)", *Level->GetName(), 
+		time::elapsedMsFrom( StartTime ), NumObjects, Chunk->Size / 1024 );
+
+	return true;
 }
 
 
 //
-// Duplicate a level, used clone used to play on it.
+// Unload level's content, level itself is still alive
+// and might be loaded again.
 //
-FLevel* CProject::DuplicateLevel( FLevel* Source )
+void CProject::UnloadLevel( FLevel* Level )
 {
-	// Validate.
-	assert(Source);
-	assert(!Source->IsTemporal());
+	TLevelChunk* Chunk = FindLevelChunk( Level );
+	if( !Chunk || !Chunk->bLoaded )
+		return;
 
-	// Allocate a new level and make some initialization.
-	FLevel* Result			= NewObject<FLevel>( Source->GetName()+L"Copy" );
-	Result->Original		= Source;
-	Result->RndFlags		= Source->RndFlags;
+	assert(!Level->bIsPlaying);
 
-	// Allocate a list of the entities matched as Source level.
-	// it's important to store proper order, since refs will be
-	// changed using it's index in level's database.
-	// Warning should be works like FEntity::Init.
-	for( Int32 iEntity=0; iEntity<Source->Entities.size(); iEntity++ )
+	// Detach components from entities, to avoid
+	// its destruction with refs releasing.
+	for( Int32 i=0; i<Level->Entities.size(); i++ )
 	{
-		FEntity* OldEntity = Source->Entities[iEntity];
-		FEntity* NewEntity = NewObject<FEntity>( OldEntity->GetName(), Result );
-
-		NewEntity->Level		= Result;
-		NewEntity->Script		= OldEntity->Script;
-
-		// Copy components.
-		FBaseComponent* BasCom = (FBaseComponent*)GObjectDatabase->CopyObject
-																		( 
-																			OldEntity->Base, 
-																			OldEntity->Base->GetName(), 
-																			NewEntity 
-																		);
-		BasCom->InitForEntity( NewEntity );
-
-		// Extra components.
-		for( Int32 i=0; i<OldEntity->Components.size(); i++ )
-		{
-			FExtraComponent* Extra = OldEntity->Components[i];
-			FExtraComponent* Com = (FExtraComponent*)GObjectDatabase->CopyObject
-																			( 
-																				Extra, 
-																				Extra->GetName(), 
-																				NewEntity 
-																			);
-			Com->InitForEntity( NewEntity );
-		}
-
-		// Initialize instance buffer.
-		if( NewEntity->Script->InstanceBuffer )
-		{
-			NewEntity->InstanceBuffer = new CInstanceBuffer( NewEntity->Script->Properties );
-			NewEntity->InstanceBuffer->Data.setSize( NewEntity->Script->InstanceSize );
-
-			// Copy data from the source entity.
-			if( NewEntity->Script->Properties.size() )
-				NewEntity->InstanceBuffer->CopyValues( &OldEntity->InstanceBuffer->Data[0] );
-		}
-
-		// Add entity to the level's db.
-		Result->Entities.push( NewEntity );
+		FEntity* Entity = Level->Entities[i];
+		Entity->Base	= nullptr;
+		Entity->Components.empty();
 	}
 
-	// Level's entities and their components are initialized
-	// now, but still object's has references to the objects
-	// on the old level, here we fix them.
-	CLevelRefChanger RefChanger( Result, Source );
-	for( Int32 iEntity=0; iEntity<Result->Entities.size(); iEntity++ )
+	// Unlink all components from the level at once, otherwise
+	// each component destructor searches level's lists for
+	// itself, which is quadratic in the number of objects.
+	for( Int32 i=0; i<Chunk->ObjectIds.size(); i++ )
 	{
-		FEntity* Entity	= Result->Entities[iEntity];
-
-		// Serialize only component's because they are refer.
-		Entity->Base->SerializeThis( RefChanger );
-		for( Int32 e=0; e<Entity->Components.size(); e++ )
-			Entity->Components[e]->SerializeThis( RefChanger );
-
-		// ..but also change references in the instance buffer.
-		if( Entity->InstanceBuffer )
-			Entity->InstanceBuffer->SerializeValues( RefChanger );
+		FObject* Object = GObjects[Chunk->ObjectIds[i]];
+		if( Object && Object->IsA(FComponent::MetaClass) )
+			((FComponent*)Object)->Level = nullptr;
 	}
 
-	// Send after loading notification to the each
-	// entity and component to set up temporal stuff.
-	// This action is logically has sense.
-	for( Int32 iEntity=0; iEntity<Result->Entities.size(); iEntity++ )
+	Level->TickObjects.empty();
+	Level->RenderObjects.empty();
+	Level->FirstInput			= nullptr;
+	Level->FirstPortal			= nullptr;
+	Level->FirstPuppet			= nullptr;
+	Level->FirstLight			= nullptr;
+	Level->FirstLogicElement	= nullptr;
+	Level->FirstPainter			= nullptr;
+
+	// Evict components first, since they are still
+	// linked to the level.
+	for( Int32 i=Chunk->ObjectIds.size()-1; i>=0; i-- )
 	{
-		FEntity* Entity	= Result->Entities[iEntity];
-
-		Entity->PostLoad();
-		Entity->Base->PostLoad();
-		for( Int32 e=0; e<Entity->Components.size(); e++ )
-			Entity->Components[e]->PostLoad();
+		FObject* Object = GObjects[Chunk->ObjectIds[i]];
+		if( Object && !Object->IsA(FEntity::MetaClass) )
+			EvictObject( Object );
+	}
+	for( Int32 i=Chunk->ObjectIds.size()-1; i>=0; i-- )
+	{
+		FObject* Object = GObjects[Chunk->ObjectIds[i]];
+		if( Object )
+			EvictObject( Object );
 	}
 
-	// Copy navigator.
-	Result->m_navigator = Source->m_navigator;
-	Serialize( RefChanger, Result->m_navigator );
-
-	// Copy level's variables.
-	Result->GameSpeed		= Source->GameSpeed;
-	Result->Soundtrack		= Source->Soundtrack;
-	Result->Camera			= Source->Camera;
-	Result->AmbientLight	= Source->AmbientLight;
-	Result->BlurIntensity	= Source->BlurIntensity;
-	mem::copy( Result->Effect, Source->Effect, sizeof(FLevel::Effect) );
+	Level->Entities.empty();
+	Level->Sky		= nullptr;
 
-	Result->m_ambientColors = Source->m_ambientColors;
-	Result->m_dawnBitmap = Source->m_dawnBitmap;
-	Result->m_midnightBitmap = Source->m_midnightBitmap;
-	Result->m_noonBitmap = Source->m_noonBitmap;
-	Result->m_duskBitmap = Source->m_duskBitmap;
+	Chunk->bLoaded	= false;
+	info( L"Game: Level '%s' unloaded", *Level->GetName() );
+}
 
-	Result->m_enableFXAA = Source->m_enableFXAA;
-	Result->m_vignette = Source->m_vignette;
 
-	Result->m_environment = Source->m_environment;
-	Result->m_environmentContext = Source->m_environmentContext;
+//
+// Destroy an object, but keep it slot reserved for 
+// the next level loading. No refs will be released, since
+// only level's objects refer to it.
+//
+void CProject::EvictObject( FObject* Object )
+{
+	assert(Object);
 
-	warn( L"World: Level \"%s\" duplicated", *Source->GetName() );
-	return Result;
+	UnhashObject( Object );
+	GObjects[Object->GetId()]	= nullptr;
+	delete Object;
 }
 
 
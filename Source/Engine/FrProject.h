@@ -13,6 +13,60 @@
 #define PROJ_FILE_EXT		L".flg"
 #define RES_FILE_EXT		L".flr"
 
+// Maximum number of level snapshots kept in memory.
+#define MAX_LEVEL_SNAPSHOTS		4
+
+
+//
+// An Information relative to Flu object.
+//
+struct TObjectHeader
+{
+public:
+	Int32		Id;
+	String		Name;
+	UInt16		iClass;
+	Int32		iOwner;
+
+	friend void Serialize( CSerializer& S, TObjectHeader& V )
+	{
+		Serialize( S, V.Id );
+		Serialize( S, V.Name );
+		Serialize( S, V.iClass );
+		Serialize( S, V.iOwner );
+	}
+};
+
+
+//
+// A level's chunk in the game file. Level's own objects
+// are stored in the chunk and loaded only on demand.
+//
+struct TLevelChunk
+{
+public:
+	Int32			iLevel;		// Id of the level object.
+	UInt32			Offset;		// Chunk offset in the game file.
+	UInt32			Size;		// Chunk size in bytes.
+	Array<Int32>	ObjectIds;	// Reserved ids of level's objects.
+	Bool			bLoaded;	// Whether objects are in database now.
+
+	TLevelChunk()
+		:	iLevel( -1 ),
+			Offset( 0 ),
+			Size( 0 ),
+			bLoaded( false )
+	{}
+
+	friend void Serialize( CSerializer& S, TLevelChunk& V )
+	{
+		Serialize( S, V.iLevel );
+		Serialize( S, V.Offset );
+		Serialize( S, V.Size );
+		Serialize( S, V.ObjectIds );
+	}
+};
+
 
 /*-----------------------------------------------------------------------------
     CProject.
@@ -30,6 +84,15 @@ public:
 	FProjectInfo*		Info;
 	CBlockManager*		BlockMan;
 
+	// Level snapshots, most recently used is last.
+	Map<FLevel*, CLevelSnapshot*>	Snapshots;
+	Array<FLevel*>					SnapshotsOrder;
+
+	// Level streaming.
+	String				GameFileName;
+	Array<CClass*>		ClassesRemap;
+	Array<TLevelChunk>	LevelChunks;
+
 	// CProject interface.
 	CProject();		
 	~CProject();
@@ -37,6 +100,16 @@ public:
 
 	// Level management functions.
 	FLevel* DuplicateLevel( FLevel* Source ); 
+	CLevelSnapshot* GetLevelSnapshot( FLevel* Level );
+
+	// Level streaming functions.
+	Bool LoadLevel( FLevel* Level );
+	void UnloadLevel( FLevel* Level );
+	Bool IsLevelLoaded( FLevel* Level );
+	TLevelChunk* FindLevelChunk( FLevel* Level );
+
+private:
+	void EvictObject( FObject* Object );
 };
 
 
@@ -95,7 +95,8 @@ class CCanvas
 {
 public:
 	CCanvas( gfx::DrawContext& drawContext )
-		:	m_drawContext( drawContext )
+		:	m_drawContext( drawContext ),
+			m_pendingParticles( nullptr )
 	{
 	}
 
@@ -111,14 +112,40 @@ public:
 	// Transformations stack.
 	void PushTransform( const gfx::ViewInfo& Info )
 	{
+		FlushBatches();
 		m_drawContext.pushViewInfo( Info );
 	}
 
 	void PopTransform()
 	{
+		FlushBatches();
 		m_drawContext.popViewInfo();
 	}
 
+	// Deferred batches. Particles of consequent emitters are merged,
+	// so the batch is kept open until anything else is drawn or
+	// the view is changed. Canvas implementations should flush it
+	// before their own drawing.
+	gfx::ParticleDrawer& BatchParticles( gfx::ParticleDrawer& Drawer )
+	{
+		if( m_pendingParticles != &Drawer )
+		{
+			FlushBatches();
+			m_pendingParticles	= &Drawer;
+		}
+
+		return Drawer;
+	}
+
+	void FlushBatches()
+	{
+		if( m_pendingParticles )
+		{
+			m_pendingParticles->flush();
+			m_pendingParticles	= nullptr;
+		}
+	}
+
 	const gfx::ViewInfo& viewInfo() const
 	{
 		return m_drawContext.getViewInfo();
@@ -127,6 +154,7 @@ public:
 protected:
 	// Canvas internal.
 	gfx::DrawContext& m_drawContext;
+	gfx::ParticleDrawer* m_pendingParticles;
 };
 
 
@@ -101,9 +101,19 @@ FScript::~FScript()
 // If component not found return nullptr.
 //
 FComponent* FScript::FindComponent( String InName )
+{
+	NameId Interned = NameId::find( *InName );
+	return Interned ? FindComponent( Interned ) : nullptr;
+}
+
+
+//
+// Find component by interned name. If not found return nullptr.
+//
+FComponent* FScript::FindComponent( NameId InName )
 {
 	for( Int32 e=0; e<Components.size(); e++ )
-		if( Components[e]->GetName() == InName )
+		if( Components[e]->GetNameId() == InName )
 			return Components[e];
 
 	return nullptr;
@@ -114,9 +124,19 @@ FComponent* FScript::FindComponent( String InName )
 // Find script function. If not found return nullptr.
 //
 CFunction* FScript::FindMethod( String TestName )
+{
+	NameId Interned = NameId::find( *TestName );
+	return Interned ? FindMethod( Interned ) : nullptr;
+}
+
+
+//
+// Find script function by interned name. If not found return nullptr.
+//
+CFunction* FScript::FindMethod( NameId TestName )
 {
 	for( Int32 i=0; i<Methods.size(); i++ )
-		if( TestName == Methods[i]->Name )
+		if( TestName == Methods[i]->InternedName )
 			return Methods[i];
 
 	return nullptr;
@@ -127,9 +147,19 @@ CFunction* FScript::FindMethod( String TestName )
 // Find a static function. If not found return nullptr.
 //
 CFunction* FScript::FindStaticFunction( String TestName )
+{
+	NameId Interned = NameId::find( *TestName );
+	return Interned ? FindStaticFunction( Interned ) : nullptr;
+}
+
+
+//
+// Find a static function by interned name. If not found return nullptr.
+//
+CFunction* FScript::FindStaticFunction( NameId TestName )
 {
 	for( Int32 i=0; i<StaticFunctions.size(); i++ )
-		if( TestName == StaticFunctions[i]->Name )
+		if( TestName == StaticFunctions[i]->InternedName )
 			return StaticFunctions[i];
 
 	return nullptr;
@@ -366,6 +396,7 @@ void Serialize( CSerializer& S, CProperty*& V )
 	}
 
 	Serialize( S, V->Name );
+	V->InternedName	= NameId( V->Name );
 	Serialize( S, V->Flags );
 	Serialize( S, V->Offset );
 
@@ -440,6 +471,7 @@ void Serialize( CSerializer& S, CFunction*& V )
 	}
 
 	Serialize( S, V->Name );
+	V->InternedName	= NameId( V->Name );
 	Serialize( S, V->Flags ); 
 	Serialize( S, V->Locals );
 	Serialize( S, V->FrameSize );
@@ -68,6 +68,7 @@ class CFunction: public CBytecode
 public:
 	// Variables.
 	String				Name;
+	NameId				InternedName;
 	UInt32				Flags;
 	Array<CProperty*>	Locals;
 	SizeT				FrameSize;
@@ -164,8 +165,11 @@ public:
 	FScript();
 	~FScript();
 	FComponent* FindComponent( String InName );
+	FComponent* FindComponent( NameId InName );
 	CFunction* FindMethod( String TestName );
+	CFunction* FindMethod( NameId TestName );
 	CFunction* FindStaticFunction( String TestName );
+	CFunction* FindStaticFunction( NameId TestName );
 
 	// Static functions execution.
 	void CallStaticFunction
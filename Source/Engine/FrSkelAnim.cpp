@@ -8,6 +8,16 @@
 /*-----------------------------------------------------------------------------
 	FSkeletonComponent implementation.
 -----------------------------------------------------------------------------*/
+
+// Pose update intervals in frames.
+#define SKEL_LOD_HIDDEN		8
+#define SKEL_LOD_SMALL		4
+#define SKEL_LOD_MEDIUM		2
+
+// Screen size thresholds in pixels.
+#define SKEL_SMALL_SIZE		48.f
+#define SKEL_MEDIUM_SIZE	128.f
+
 
 //
 // Skeleton component constructor.
@@ -26,6 +36,12 @@ FSkeletonComponent::FSkeletonComponent()
 	Frame			= 0.f;
 	iAction			= -1;
 
+	PoseAction		= -1;
+	PoseFrame		= 0.f;
+	LastSeenFrame	= 0;
+	ScreenSize		= 0.f;
+	LODCounter		= 0;
+
 	bTickable	= true;
 }
 
@@ -39,22 +55,47 @@ void FSkeletonComponent::InitForEntity( FEntity* InEntity )
 }
 
 
-// BEGIN HACKS.
-
+//
+// Render skeleton with the last computed pose.
+//
 void FSkeletonComponent::Render( CCanvas* Canvas )
 {
-	if( Skeleton )
+	if( !Skeleton || Skeleton->Bones.size() == 0 )
+		return;
+
+	// Pose is not computed yet, so use ref pose.
+	if( Pose.BonesPose.size() != Skeleton->Bones.size() )
 	{
-		if( iAction != -1 )
-			Skeleton->RefPose.CumputeAnimFrame( Skeleton, Skeleton->Actions[iAction], Frame );
-		else
-			Skeleton->RefPose.ComputeRefTransform( Skeleton );
+		Pose	= Skeleton->RefPose;
+		Pose.ComputeRefTransform( Skeleton );
+	}
 
-		Skeleton->Render( Canvas, Base->Location, Scale, Skeleton->RefPose );
+	// Skeleton bounds.
+	math::Rect Bounds( Pose.BonesPose[0].Location, 0.f );
+	for( Int32 i=0; i<Pose.BonesPose.size(); i++ )
+	{
+		math::Rect BoneBounds( Pose.BonesPose[i].Location, Skeleton->Bones[i].Scale * 2.f );
+		Bounds	+= BoneBounds.min;
+		Bounds	+= BoneBounds.max;
 	}
+
+	// Skip invisible.
+	const gfx::ViewInfo& View = Canvas->viewInfo();
+	if( !View.bounds.isOverlap( Bounds ) )
+		return;
+
+	// Remember how large skeleton is on the screen.
+	LastSeenFrame	= GFrameStamp;
+	ScreenSize		= max( Bounds.sizeX(), Bounds.sizeY() ) * View.width / max( View.bounds.sizeX(), 0.01f );
+
+	Skeleton->Render( Canvas, Base->Location, Scale, Pose );
 }
 
 
+//
+// Advance animation and request a new pose. Hidden and small
+// skeletons are updated less often.
+//
 void FSkeletonComponent::Tick( Float Delta )
 {
 	if( iAction != -1 )
@@ -63,9 +104,52 @@ void FSkeletonComponent::Tick( Float Delta )
 		if( Frame > 1.f )
 			Frame = 0.f;		// Only 1-sec animation works now.
 	}
+
+	Int32 Interval;
+	if( GFrameStamp - LastSeenFrame > 1 )
+		Interval	= SKEL_LOD_HIDDEN;
+	else if( ScreenSize < SKEL_SMALL_SIZE )
+		Interval	= SKEL_LOD_SMALL;
+	else if( ScreenSize < SKEL_MEDIUM_SIZE )
+		Interval	= SKEL_LOD_MEDIUM;
+	else
+		Interval	= 1;
+
+	if( ++LODCounter >= Interval )
+		SubmitPose( false );
 }
 
-// END HACKS.
+
+//
+// Editor tick, skeleton may be changed, so
+// update pose every frame.
+//
+void FSkeletonComponent::TickNonPlay( Float Delta )
+{
+	SubmitPose( true );
+}
+
+
+//
+// Submit pose request to the level's animator, the
+// pose will be computed at the end of level tick.
+//
+void FSkeletonComponent::SubmitPose( Bool bForce )
+{
+	if( !Skeleton || !Level )
+		return;
+
+	// Don't recompute the same frame.
+	if( !bForce && PoseAction == iAction && PoseFrame == Frame && 
+		Pose.BonesPose.size() == Skeleton->Bones.size() )
+		return;
+
+	LODCounter	= 0;
+	PoseAction	= iAction;
+	PoseFrame	= Frame;
+
+	Level->SkelAnimator.Submit( Skeleton, iAction, Frame, &Pose );
+}
 
 
 //
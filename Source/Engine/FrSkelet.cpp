@@ -927,6 +927,351 @@ TSkeletonAction::TSkeletonAction( String InName )
 
 
 /*-----------------------------------------------------------------------------
+	CSkeletonAnimator implementation.
+-----------------------------------------------------------------------------*/
+
+//
+// Animator constructor.
+//
+CSkeletonAnimator::CSkeletonAnimator()
+	:	Requests(),
+		Unique(),
+		Batches(),
+		Locations(),
+		Rotations()
+{
+}
+
+
+//
+// Submit a pose request. The pose will be computed during
+// next Flush, so it should be alive until this moment.
+//
+void CSkeletonAnimator::Submit( FSkeleton* Skeleton, Int32 iAction, Float Time, TSkelPose* Pose )
+{
+	assert(Skeleton && Pose);
+
+	// Skip not linked skeletons.
+	if( Skeleton->TransformTable.size() != Skeleton->Bones.size() ||
+		Skeleton->RefPose.BonesPose.size() != Skeleton->Bones.size() )
+		return;
+
+	if( iAction < 0 || iAction >= Skeleton->Actions.size() )
+	{
+		// Ref pose doesn't depend on time.
+		iAction	= -1;
+		Time	= 0.f;
+	}
+
+	if( Pose->BonesPose.size() != Skeleton->Bones.size() )
+		*Pose	= Skeleton->RefPose;
+
+	TRequest Request;
+	Request.Skeleton	= Skeleton;
+	Request.iAction		= iAction;
+	Request.Time		= Time;
+	Request.Pose		= Pose;
+	Request.iUnique		= -1;
+	Requests.push( Request );
+}
+
+
+//
+// Compute all the submitted poses.
+//
+void CSkeletonAnimator::Flush()
+{
+	if( Requests.size() == 0 )
+		return;
+
+	// Sort, so equal requests go one after another.
+	Requests.sort( []( const TRequest& A, const TRequest& B )->Bool
+	{
+		if( A.Skeleton != B.Skeleton )
+			return A.Skeleton < B.Skeleton;
+
+		if( A.iAction != B.iAction )
+			return A.iAction < B.iAction;
+
+		return A.Time < B.Time;
+	} );
+
+	// Collect unique poses.
+	Unique.setSize( 0 );
+
+	for( Int32 i=0; i<Requests.size(); i++ )
+	{
+		TRequest& Request = Requests[i];
+
+		if( Unique.size() == 0 || 
+			Unique.last().Skeleton != Request.Skeleton || 
+			Unique.last().iAction != Request.iAction || 
+			Unique.last().Time != Request.Time )
+		{
+			Unique.push( Request );
+		}
+
+		Request.iUnique	= Unique.size() - 1;
+	}
+
+	// Split unique poses into batches.
+	Int32 NumFloats = 0, NumInts = 0;
+	Batches.setSize( 0 );
+
+	for( Int32 i=0; i<Unique.size(); )
+	{
+		TBatch Batch;
+		Batch.Skeleton	= Unique[i].Skeleton;
+		Batch.Poses		= &Unique[i];
+		Batch.NumPoses	= 0;
+		Batch.Locations	= nullptr;
+		Batch.Rotations	= nullptr;
+
+		while( i < Unique.size() && Unique[i].Skeleton == Batch.Skeleton && Batch.NumPoses < SKEL_POSES_PER_BATCH )
+		{
+			Batch.NumPoses++;
+			i++;
+		}
+
+		// Local and world space locations, local and world space rotations.
+		NumFloats	+= Batch.Skeleton->Bones.size() * Batch.NumPoses * 4;
+		NumInts		+= Batch.Skeleton->Bones.size() * Batch.NumPoses * 2;
+		Batches.push( Batch );
+	}
+
+	// Allocate scratch memory.
+	if( Locations.size() < NumFloats )
+		Locations.setSize( NumFloats );
+
+	if( Rotations.size() < NumInts )
+		Rotations.setSize( NumInts );
+
+	for( Int32 i=0, iFloat=0, iInt=0; i<Batches.size(); i++ )
+	{
+		TBatch& Batch = Batches[i];
+		Batch.Locations	= &Locations[iFloat];
+		Batch.Rotations	= &Rotations[iInt];
+
+		iFloat	+= Batch.Skeleton->Bones.size() * Batch.NumPoses * 4;
+		iInt	+= Batch.Skeleton->Bones.size() * Batch.NumPoses * 2;
+	}
+
+	// Evaluate batches.
+	job::parallelFor( Batches.size(), 1, SKEL_MAX_TASKS, EvaluateTask, Batches.size() ? &Batches[0] : nullptr );
+
+	// Share results with equal requests.
+	for( Int32 i=0; i<Requests.size(); i++ )
+	{
+		TRequest& Request	= Requests[i];
+		TSkelPose* Source	= Unique[Request.iUnique].Pose;
+
+		if( Request.Pose != Source )
+			Request.Pose->BonesPose	= Source->BonesPose;
+	}
+
+	profile_counter( Entity, Skeleton_Requests, Requests.size() );
+	profile_counter( Entity, Skeleton_Poses, Unique.size() );
+
+	Requests.setSize( 0 );
+}
+
+
+//
+// Evaluate a range of batches.
+//
+void CSkeletonAnimator::EvaluateTask( void* Data, Int32 iTask, Int32 First, Int32 Last )
+{
+	const TBatch* Batches = reinterpret_cast<const TBatch*>( Data );
+
+	for( Int32 i=First; i<Last; i++ )
+		EvaluateBatch( Batches[i] );
+}
+
+
+//
+// Solve poses of the batch. Data stored bone-major, so each
+// bone's controllers are resolved once for all the instances
+// and inner loops run over contiguous arrays.
+//
+void CSkeletonAnimator::EvaluateBatch( const TBatch& Batch )
+{
+	FSkeleton*	Skel		= Batch.Skeleton;
+	Int32		NumBones	= Skel->Bones.size();
+	Int32		NumPoses	= Batch.NumPoses;
+	Int32		Stride		= NumBones * NumPoses;
+
+	Float* LocalX		= Batch.Locations;
+	Float* LocalY		= LocalX + Stride;
+	Float* ResultX		= LocalY + Stride;
+	Float* ResultY		= ResultX + Stride;
+	Int32* LocalRot		= Batch.Rotations;
+	Int32* ResultRot	= LocalRot + Stride;
+
+	// Start from the ref pose, rotation is extracted once per bone.
+	for( Int32 b=0; b<NumBones; b++ )
+	{
+		const math::Coords& Ref	= Skel->RefPose.BonesPose[b].Coords;
+		math::Angle	RefRot		= math::vectorToAngle( Ref.xAxis );
+
+		for( Int32 k=b*NumPoses; k<(b+1)*NumPoses; k++ )
+		{
+			LocalX[k]	= Ref.origin.x;
+			LocalY[k]	= Ref.origin.y;
+			LocalRot[k]	= RefRot;
+		}
+	}
+
+	// Apply animation tracks.
+	for( Int32 k=0; k<NumPoses; k++ )
+	{
+		const TRequest& Request = Batch.Poses[k];
+
+		if( Request.iAction == -1 )
+			continue;
+
+		TSkeletonAction& Action = Skel->Actions[Request.iAction];
+		for( Int32 t=0; t<Action.BoneTracks.size(); t++ )
+		{
+			TBoneTrack& Track	= Action.BoneTracks[t];
+			Int32 i				= Track.iBone * NumPoses + k;
+
+			math::Vector Origin	= Track.PosKeys.sampleLinear( Request.Time, math::Vector( LocalX[i], LocalY[i] ) );
+			LocalX[i]	= Origin.x;
+			LocalY[i]	= Origin.y;
+			LocalRot[i]	= Track.RotKeys.sampleLinear( Request.Time, math::Angle( LocalRot[i] ) );
+		}
+	}
+
+	// Solve bones in transformation order.
+	for( Int32 j=0; j<NumBones; j++ )
+	{
+		Int32		iBone		= Skel->TransformTable[j];
+		TBoneInfo&	ThisInfo	= Skel->Bones[iBone];
+
+		const Float* OwnX	= &LocalX[iBone * NumPoses];
+		const Float* OwnY	= &LocalY[iBone * NumPoses];
+		const Int32* OwnRot	= &LocalRot[iBone * NumPoses];
+		Float* BoneX		= &ResultX[iBone * NumPoses];
+		Float* BoneY		= &ResultY[iBone * NumPoses];
+		Int32* BoneRot		= &ResultRot[iBone * NumPoses];
+
+		// Compute position of current bone.
+		if( ThisInfo.iPosCtrl != -1 )
+		{
+			const Float* ParentX	= &ResultX[ThisInfo.iPosCtrl * NumPoses];
+			const Float* ParentY	= &ResultY[ThisInfo.iPosCtrl * NumPoses];
+			const Int32* ParentRot	= &ResultRot[ThisInfo.iPosCtrl * NumPoses];
+
+			// Expanded transformPointBy( Origin, Coords( Parent ).transpose() ).
+			for( Int32 k=0; k<NumPoses; k++ )
+			{
+				math::Angle Rot( ParentRot[k] );
+				Float C = Rot.getCos(), S = Rot.getSin();
+
+				Float DX	= OwnX[k] + ( ParentX[k] * C + ParentY[k] * S );
+				Float DY	= OwnY[k] + ( ParentX[k] * -S + ParentY[k] * C );
+
+				BoneX[k]	= DX * C + DY * -S;
+				BoneY[k]	= DX * S + DY * C;
+			}
+		}
+		else
+		{
+			for( Int32 k=0; k<NumPoses; k++ )
+			{
+				BoneX[k]	= OwnX[k];
+				BoneY[k]	= OwnY[k];
+			}
+		}
+
+		// Compute rotation of current bone.
+		if( ThisInfo.iRotCtrl != -1 )
+		{
+			TBoneInfo& ParentInfo	= Skel->Bones[ThisInfo.iRotCtrl];
+			const Float* ParentX	= &ResultX[ThisInfo.iRotCtrl * NumPoses];
+			const Float* ParentY	= &ResultY[ThisInfo.iRotCtrl * NumPoses];
+			const Int32* ParentRot	= &ResultRot[ThisInfo.iRotCtrl * NumPoses];
+
+			Int32 iChain1 = ParentInfo.Type == SC_IKSolver && ParentInfo.iEndJoint != -1 ? 
+				Skel->Bones[ParentInfo.iEndJoint].iPosCtrl : -1;
+
+			if( iChain1 != -1 )
+			{
+				// Solve IK equation.
+				Float Scale1	= Skel->Bones[iChain1].Scale;
+				Float Scale2	= Skel->Bones[ParentInfo.iEndJoint].Scale;
+				Bool bEndJoint	= iBone == ParentInfo.iEndJoint;
+
+				const Float* Chain1X	= &ResultX[iChain1 * NumPoses];
+				const Float* Chain1Y	= &ResultY[iChain1 * NumPoses];
+
+				for( Int32 k=0; k<NumPoses; k++ )
+				{
+					math::Vector Dir( ParentX[k] - Chain1X[k], ParentY[k] - Chain1Y[k] );
+
+					if( Dir.size() < ( Scale1 + Scale2 ) )
+					{
+						Float Cos2 = (sqr(Dir.x)+sqr(Dir.y)-sqr(Scale1)-sqr(Scale2))/(2.f*Scale1*Scale2);
+						math::Angle Angle2 = math::Angle(acosf(Cos2));
+
+						if( ParentInfo.bFlipIK )
+							Angle2 = -Angle2;
+
+						Float Sin2 = Angle2.getSin();
+
+						Float P3 = math::arcTan2( Dir.y, Dir.x );
+						Float P4 = math::arcTan((Scale2*Sin2)/(Scale1+Scale2*Cos2));
+						math::Angle Angle1 = math::Angle(P3-P4);
+
+						BoneRot[k]	= bEndJoint ? Angle1+Angle2 : Angle1;
+					}
+					else
+					{
+						// We cant compute IK.
+						BoneRot[k]	= math::vectorToAngle(Dir);
+					}
+				}
+			}
+			else if( ParentInfo.Type == SC_IKSolver )
+			{
+				// IK broken, so no computations.
+				for( Int32 k=0; k<NumPoses; k++ )
+					BoneRot[k]	= OwnRot[k];
+			}
+			else if( ThisInfo.bLookAt )
+			{
+				for( Int32 k=0; k<NumPoses; k++ )
+					BoneRot[k]	= math::vectorToAngle( math::Vector( ParentX[k] - BoneX[k], ParentY[k] - BoneY[k] ) );
+			}
+			else
+			{
+				for( Int32 k=0; k<NumPoses; k++ )
+					BoneRot[k]	= math::Angle( ParentRot[k] ) + math::Angle( OwnRot[k] );
+			}
+		}
+		else
+		{
+			// No rotation controller, so use transform.
+			for( Int32 k=0; k<NumPoses; k++ )
+				BoneRot[k]	= OwnRot[k];
+		}
+	}
+
+	// Store results.
+	for( Int32 k=0; k<NumPoses; k++ )
+	{
+		Array<TBonePose>& Result = Batch.Poses[k].Pose->BonesPose;
+
+		for( Int32 b=0; b<NumBones; b++ )
+		{
+			Result[b].Location	= math::Vector( ResultX[b * NumPoses + k], ResultY[b * NumPoses + k] );
+			Result[b].Rotation	= ResultRot[b * NumPoses + k];
+		}
+	}
+}
+
+
+/*-----------------------------------------------------------------------------
 	Registration.
 -----------------------------------------------------------------------------*/
 
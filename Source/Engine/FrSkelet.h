@@ -241,5 +241,68 @@ public:
 
 
 /*-----------------------------------------------------------------------------
+	CSkeletonAnimator.
+-----------------------------------------------------------------------------*/
+
+// Animator limits.
+#define SKEL_POSES_PER_BATCH	64
+#define SKEL_MAX_TASKS			16
+
+
+//
+// A batched skeleton poses evaluator. Components submit requests
+// while tick, then all of them are computed at once. Unique poses of
+// the same skeleton are solved bone-by-bone for many instances in SoA
+// layout on job workers. Identical (action, time) requests are
+// computed only once and shared.
+//
+class CSkeletonAnimator
+{
+public:
+	// CSkeletonAnimator interface.
+	CSkeletonAnimator();
+	void Submit( FSkeleton* Skeleton, Int32 iAction, Float Time, TSkelPose* Pose );
+	void Flush();
+
+	// Accessors.
+	Int32 NumRequests() const
+	{
+		return Requests.size();
+	}
+
+private:
+	// A pose request.
+	struct TRequest
+	{
+		FSkeleton*		Skeleton;
+		Int32			iAction;
+		Float			Time;
+		TSkelPose*		Pose;
+		Int32			iUnique;
+	};
+
+	// A group of unique poses of the single skeleton.
+	struct TBatch
+	{
+		FSkeleton*		Skeleton;
+		const TRequest*	Poses;
+		Int32			NumPoses;
+		Float*			Locations;
+		Int32*			Rotations;
+	};
+
+	// Internal.
+	Array<TRequest>		Requests;
+	Array<TRequest>		Unique;
+	Array<TBatch>		Batches;
+	Array<Float>		Locations;
+	Array<Int32>		Rotations;
+
+	static void EvaluateBatch( const TBatch& Batch );
+	static void EvaluateTask( void* Data, Int32 iTask, Int32 First, Int32 Last );
+};
+
+
+/*-----------------------------------------------------------------------------
 	The End.
 -----------------------------------------------------------------------------*/
\ No newline at end of file
@@ -0,0 +1,255 @@
+/*=============================================================================
+    FrSnapshot.cpp: Level snapshot.
+    Copyright Oct.2019 Vlad Gordienko.
+=============================================================================*/
+
+#include "Engine.h"
+
+/*-----------------------------------------------------------------------------
+    Snapshot serializers.
+-----------------------------------------------------------------------------*/
+
+//
+// Serializer to store level's objects into the snapshot blob.
+//
+class CSnapshotWriter: public CSerializer
+{
+public:
+	CLevelSnapshot&		Snapshot;
+	Array<Int32>		RecordOf;
+	Int32				Size;
+
+	// CSnapshotWriter interface.
+	CSnapshotWriter( CLevelSnapshot& InSnapshot )
+		:	Snapshot( InSnapshot ),
+			RecordOf( GObjectDatabase->GObjects.size() ),
+			Size( 0 )
+	{
+		Mode	= SM_Save;
+
+		for( Int32 i=0; i<RecordOf.size(); i++ )
+			RecordOf[i] = -1;
+	}
+
+	// Add object to the snapshot.
+	Int32 AddRecord( FObject* Object, String Name, Int32 iOwner )
+	{
+		CLevelSnapshot::TRecord Record;
+		Record.Class	= Object->GetClass();
+		Record.Name		= Name;
+		Record.iOwner	= iOwner;
+
+		RecordOf[Object->GetId()] = Snapshot.Records.push( Record );
+		return RecordOf[Object->GetId()];
+	}
+
+	// CSerializer interface.
+	void SerializeData( void* Mem, SizeT Count )
+	{
+		if( !Count )
+			return;
+
+		// Grow blob geometrically, it's trimmed after capturing.
+		if( Size + Int32(Count) > Snapshot.Data.size() )
+			Snapshot.Data.setSize( max<Int32>( Snapshot.Data.size() * 2, Size + Int32(Count) ) );
+
+		mem::copy( &Snapshot.Data[Size], Mem, Count );
+		Size += Int32(Count);
+	}
+	void SerializeRef( FObject*& Obj )
+	{
+		Int32 Id = Obj ? Obj->GetId() : -1;
+
+		if( Id != -1 && RecordOf[Id] != -1 )
+		{
+			CLevelSnapshot::TReloc Reloc;
+			Reloc.Offset	= Size;
+			Reloc.iRecord	= RecordOf[Id];
+			Snapshot.Relocs.push( Reloc );
+		}
+
+		Serialize( *this, Id );
+	}
+};
+
+
+//
+// Serializer to restore objects from the patched blob.
+//
+class CSnapshotReader: public CSerializer
+{
+public:
+	const Array<UInt8>&		Data;
+	Int32					Offset;
+
+	// CSnapshotReader interface.
+	CSnapshotReader( const Array<UInt8>& InData )
+		:	Data( InData ),
+			Offset( 0 )
+	{
+		Mode	= SM_Load;
+	}
+
+	// CSerializer interface.
+	void SerializeData( void* Mem, SizeT Count )
+	{
+		if( !Count )
+			return;
+
+		assert(Offset + Int32(Count) <= Data.size());
+		mem::copy( Mem, &Data[Offset], Count );
+		Offset += Int32(Count);
+	}
+	void SerializeRef( FObject*& Obj )
+	{
+		Int32 Id;
+		Serialize( *this, Id );
+		Obj = Id != -1 ? GObjectDatabase->GObjects[Id] : nullptr;
+	}
+};
+
+
+/*-----------------------------------------------------------------------------
+    CLevelSnapshot implementation.
+-----------------------------------------------------------------------------*/
+
+//
+// Capture level's entities and components.
+//
+CLevelSnapshot::CLevelSnapshot( FLevel* InSource )
+	:	Source( InSource )
+{
+	assert(Source);
+	assert(!Source->IsTemporal());
+
+	UInt64 StartTime = time::cycles64();
+	CSnapshotWriter Writer( *this );
+
+	// Enumerate objects, refs to them will be relocated. Order
+	// is the same as in FEntity::Init.
+	Array<FObject*> Objects;
+	Objects.push( Source );
+	Writer.AddRecord( Source, Source->GetName()+L"Copy", -1 );
+
+	for( Int32 iEntity=0; iEntity<Source->Entities.size(); iEntity++ )
+	{
+		FEntity* Entity = Source->Entities[iEntity];
+
+		Objects.push( Entity );
+		Int32 iRecord = Writer.AddRecord( Entity, Entity->GetName(), 0 );
+
+		Objects.push( Entity->Base );
+		Writer.AddRecord( Entity->Base, Entity->Base->GetName(), iRecord );
+
+		for( Int32 e=0; e<Entity->Components.size(); e++ )
+		{
+			Objects.push( Entity->Components[e] );
+			Writer.AddRecord( Entity->Components[e], Entity->Components[e]->GetName(), iRecord );
+		}
+	}
+
+	// Store objects content, except level.
+	for( Int32 i=1; i<Objects.size(); i++ )
+		Objects[i]->SerializeThis( Writer );
+
+	Serialize( Writer, Source->m_navigator );
+
+	Data.setSize( Writer.Size );
+
+	info( L"World: Level \"%s\" snapshot captured in %.2f ms (%d objects, %d Kb)", *Source->GetName(),
+		time::elapsedMsFrom( StartTime ), Records.size(), Int32( GetMemoryUsage() / 1024 ) );
+}
+
+
+//
+// Snapshot destructor.
+//
+CLevelSnapshot::~CLevelSnapshot()
+{
+	Records.empty();
+	Relocs.empty();
+	Data.empty();
+}
+
+
+//
+// Make a new temporal copy of the source level.
+//
+FLevel* CLevelSnapshot::Instantiate()
+{
+	UInt64 StartTime = time::cycles64();
+
+	// Allocate all objects at once.
+	Array<FObject*> Objects( Records.size() );
+	for( Int32 i=0; i<Records.size(); i++ )
+	{
+		const TRecord& Record = Records[i];
+		Objects[i] = GObjectDatabase->CreateObject
+										(
+											Record.Class,
+											Record.Name,
+											Record.iOwner != -1 ? Objects[Record.iOwner] : nullptr
+										);
+	}
+
+	FLevel* Result		= (FLevel*)Objects[0];
+	Result->Original	= Source;
+	Result->RndFlags	= Source->RndFlags;
+
+	// Patch references to the new objects.
+	Array<UInt8> Patched = Data;
+	for( Int32 i=0; i<Relocs.size(); i++ )
+	{
+		Int32 Id = Objects[Relocs[i].iRecord]->GetId();
+		mem::copy( &Patched[Relocs[i].Offset], &Id, sizeof(Int32) );
+	}
+
+	// Restore objects content.
+	CSnapshotReader Reader( Patched );
+	for( Int32 i=1; i<Objects.size(); i++ )
+	{
+		Objects[i]->SerializeThis( Reader );
+
+		if( Objects[i]->IsA(FEntity::MetaClass) )
+			Result->Entities.push( (FEntity*)Objects[i] );
+	}
+
+	Serialize( Reader, Result->m_navigator );
+	assert(Reader.Offset == Patched.size());
+
+	// Refill level's database.
+	Result->InitEntities();
+
+	// Send after loading notification to the each
+	// entity and component to set up temporal stuff.
+	for( Int32 i=1; i<Objects.size(); i++ )
+		Objects[i]->PostLoad();
+
+	// Copy level's variables.
+	Result->GameSpeed		= Source->GameSpeed;
+	Result->Soundtrack		= Source->Soundtrack;
+	Result->Camera			= Source->Camera;
+	Result->AmbientLight	= Source->AmbientLight;
+	Result->BlurIntensity	= Source->BlurIntensity;
+	mem::copy( Result->Effect, Source->Effect, sizeof(FLevel::Effect) );
+
+	Result->m_ambientColors = Source->m_ambientColors;
+	Result->m_dawnBitmap = Source->m_dawnBitmap;
+	Result->m_midnightBitmap = Source->m_midnightBitmap;
+	Result->m_noonBitmap = Source->m_noonBitmap;
+	Result->m_duskBitmap = Source->m_duskBitmap;
+
+	Result->m_enableFXAA = Source->m_enableFXAA;
+	Result->m_vignette = Source->m_vignette;
+
+	Result->m_environment = Source->m_environment;
+	Result->m_environmentContext = Source->m_environmentContext;
+
+	info( L"World: Level \"%s\" instantiated in %.2f ms", *Source->GetName(), time::elapsedMsFrom( StartTime ) );
+	return Result;
+}
+
+
+/*-----------------------------------------------------------------------------
+    The End.
+-----------------------------------------------------------------------------*/
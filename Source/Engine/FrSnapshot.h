@@ -0,0 +1,61 @@
+/*=============================================================================
+    FrSnapshot.h: Level snapshot.
+    Copyright Oct.2019 Vlad Gordienko.
+=============================================================================*/
+
+/*-----------------------------------------------------------------------------
+    CLevelSnapshot.
+-----------------------------------------------------------------------------*/
+
+//
+// A level snapshot. Entities and components of the level are
+// serialized once into the single blob, references to the
+// snapshot's objects are stored in the relocation table. Copies
+// of level are instantiated by allocating all objects at once
+// and patching references.
+//
+class CLevelSnapshot
+{
+public:
+	// Variables.
+	FLevel*			Source;
+
+	// CLevelSnapshot interface.
+	CLevelSnapshot( FLevel* InSource );
+	~CLevelSnapshot();
+	FLevel* Instantiate();
+
+	// Accessors.
+	inline SizeT GetMemoryUsage() const
+	{
+		return Data.size() + Relocs.size() * sizeof(TReloc) + Records.size() * sizeof(TRecord);
+	}
+
+private:
+	// Snapshot's object info. Record 0 is the level.
+	struct TRecord
+	{
+		CClass*		Class;
+		String		Name;
+		Int32		iOwner;
+	};
+
+	// Place in the blob where reference to
+	// the snapshot's object is stored.
+	struct TReloc
+	{
+		UInt32		Offset;
+		Int32		iRecord;
+	};
+
+	Array<TRecord>	Records;
+	Array<TReloc>	Relocs;
+	Array<UInt8>	Data;
+
+	friend class CSnapshotWriter;
+};
+
+
+/*-----------------------------------------------------------------------------
+    The End.
+-----------------------------------------------------------------------------*/
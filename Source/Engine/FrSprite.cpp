@@ -104,6 +104,10 @@ void FSpriteComponent::Render( CCanvas* Canvas )
 	Rect.TexCoords.min.y	= TexCoords.max.y * GRescale[Image->getVBits()];
 	Rect.TexCoords.max.y	= TexCoords.min.y * GRescale[Image->getVBits()];	
 
+	// Packed into atlas?
+	if( Image->isAtlasRegion() )
+		Rect.TexCoords	= Image->mapTexCoords( Rect.TexCoords );
+
 	if( Base->bFrozen )
 		Rect.Color	= Rect.Color * 0.55f;
 
@@ -211,6 +215,11 @@ void FDecoComponent::Render( CCanvas* Canvas )
 	Poly.TexCoords[2]	= math::Vector( U2, V1 );
 	Poly.TexCoords[3]	= math::Vector( U2, V2 );
 
+	// Packed into atlas?
+	if( Image->isAtlasRegion() )
+		for( Int32 i=0; i<4; i++ )
+			Poly.TexCoords[i]	= Image->mapTexCoords( Poly.TexCoords[i] );
+
 	// Untransformed vertices in local coords.
 	Poly.Vertices[0]	= math::Vector( -Scale.x, -Scale.y )*0.5;
 	Poly.Vertices[1]	= math::Vector( -Scale.x, +Scale.y )*0.5;
@@ -403,8 +412,12 @@ void FAnimatedSpriteComponent::Render( CCanvas* Canvas )
 		TAnimSequence* Seq	= &Animation->Sequences[iSequence];
 		Int32 iDrawFrame	= math::floor(Frame) + Seq->Start;
 
-		Rect.Image		= As<FBitmap>(Animation->Sheet)->m_image->getHandle();
+		auto Sheet		= As<FBitmap>(Animation->Sheet)->m_image;
+		Rect.Image		= Sheet->getHandle();
 		Rect.TexCoords	= Animation->GetTexCoords( iDrawFrame );
+
+		if( Sheet->isAtlasRegion() )
+			Rect.TexCoords	= Sheet->mapTexCoords( Rect.TexCoords );
 	}
 	else
 	{
@@ -619,6 +632,10 @@ void FParallaxLayerComponent::Render( CCanvas* Canvas )
 	Rect.TexCoords.min.y	= TexCoords.max.y * GRescale[Image->getVBits()];
 	Rect.TexCoords.max.y	= TexCoords.min.y * GRescale[Image->getVBits()];	
 
+	// Packed into atlas?
+	if( Image->isAtlasRegion() )
+		Rect.TexCoords	= Image->mapTexCoords( Rect.TexCoords );
+
 	// Apply flipping.
 	if( bFlipH )
 		exchange( Rect.TexCoords.min.x, Rect.TexCoords.max.x );
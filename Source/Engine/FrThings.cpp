@@ -494,6 +494,13 @@ void FBrushComponent::Render( CCanvas* Canvas )
 		for( Int32 i=0; i<NumVerts; i++ )
 			Poly.TexCoords[i]	= math::transformPointBy( Vertices[i], Coords );
 
+		// Packed into atlas? Atlas regions never tile, tiled images
+		// are kept out of atlases by "Wrap" setting.
+		auto Image = As<FBitmap>(Texture)->m_image;
+		if( Image->isAtlasRegion() )
+			for( Int32 i=0; i<NumVerts; i++ )
+				Poly.TexCoords[i]	= Image->mapTexCoords( Poly.TexCoords[i] );
+
 		Canvas->DrawPoly( Poly );
 	}
 
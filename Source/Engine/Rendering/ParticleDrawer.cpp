@@ -0,0 +1,127 @@
+//-----------------------------------------------------------------------------
+//	ParticleDrawer.cpp: ParticleDrawer implementation
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Engine/Engine.h"
+
+namespace flu
+{
+namespace gfx
+{
+	static const Char PARTICLE_EFFECT_NAME[] = TXT( "System.Shaders.Particle" );
+
+	ParticleDrawer::ParticleDrawer()
+		:	m_vertexBuffer( "ParticleDrawer_VB" ),
+			m_indexBuffer( INVALID_HANDLE<rend::IndexBufferHandle>() ),
+			m_indexBufferQuads( 0 ),
+			m_currentTexture( INVALID_HANDLE<rend::Texture2DHandle>() ),
+			m_numQuads( 0 ),
+			m_numDrawCalls( 0 ),
+			m_numVertices( 0 ),
+			m_effect( nullptr )
+	{
+		m_effect = res::ResourceManager::get<ffx::Effect>( PARTICLE_EFFECT_NAME, res::EFailPolicy::FATAL );
+
+		m_samplerState = api::getSamplerState( { rend::ESamplerFilter::Point, rend::ESamplerAddressMode::Wrap } );
+
+		m_blendState = api::getBlendState( { rend::EBlendFactor::SrcAlpha, rend::EBlendFactor::InvSrcAlpha, 
+			rend::EBlendOp::Add, rend::EBlendFactor::SrcAlpha, rend::EBlendFactor::InvSrcAlpha, rend::EBlendOp::Add } );
+	}
+
+	ParticleDrawer::~ParticleDrawer()
+	{
+		if( m_indexBuffer != INVALID_HANDLE<rend::IndexBufferHandle>() )
+		{
+			api::destroyIndexBuffer( m_indexBuffer );
+			m_indexBuffer = INVALID_HANDLE<rend::IndexBufferHandle>();
+		}
+
+		m_effect = nullptr;
+	}
+
+	ParticleDrawer::Vertex* ParticleDrawer::batchQuads( rend::Texture2DHandle texture, Int32 numQuads )
+	{
+		assert( numQuads > 0 );
+
+		// flush old batch
+		if( texture != m_currentTexture && m_numQuads > 0 )
+		{
+			flush();
+		}
+
+		m_currentTexture = texture;
+		m_numQuads += numQuads;
+
+		return m_vertexBuffer.reserve( numQuads * 4 );
+	}
+
+	void ParticleDrawer::flush()
+	{
+		if( m_numQuads > 0 )
+		{
+			prepareIndexBuffer( m_numQuads );
+
+			m_vertexBuffer.flushAndBind();
+			api::setIndexBuffer( m_indexBuffer );
+
+			m_effect->setBlendState( m_blendState );
+			m_effect->setTexture( 0, m_currentTexture );
+			m_effect->setSamplerState( 0, m_samplerState );
+			m_effect->apply();
+
+			api::setTopology( rend::EPrimitiveTopology::TriangleList );
+			api::drawIndexed( m_numQuads * 6, 0, 0 );
+
+			m_numDrawCalls++;
+			m_numVertices += m_numQuads * 4;
+			m_numQuads = 0;
+		}
+
+		m_currentTexture = INVALID_HANDLE<rend::Texture2DHandle>();
+	}
+
+	void ParticleDrawer::reportStats()
+	{
+		profile_counter( Draw_Calls, Particles_Draw_Calls, m_numDrawCalls );
+		profile_counter( Render, Particles_Vertices, m_numVertices );
+
+		m_numDrawCalls = 0;
+		m_numVertices = 0;
+	}
+
+	void ParticleDrawer::prepareIndexBuffer( Int32 numQuads )
+	{
+		if( numQuads <= m_indexBufferQuads )
+		{
+			return;
+		}
+
+		// quads pattern never changes, so buffer is rebuilt only to grow
+		if( m_indexBuffer != INVALID_HANDLE<rend::IndexBufferHandle>() )
+		{
+			api::destroyIndexBuffer( m_indexBuffer );
+		}
+
+		m_indexBufferQuads = max<Int32>( alignValue<Int32>( numQuads, 1024 ), m_indexBufferQuads * 2 );
+
+		Array<UInt32> indices( m_indexBufferQuads * 6 );
+
+		for( Int32 i = 0; i < m_indexBufferQuads; ++i )
+		{
+			const UInt32 firstVertId = i * 4;
+
+			indices[i * 6 + 0] = firstVertId + 0;
+			indices[i * 6 + 1] = firstVertId + 1;
+			indices[i * 6 + 2] = firstVertId + 2;
+
+			indices[i * 6 + 3] = firstVertId + 0;
+			indices[i * 6 + 4] = firstVertId + 3;
+			indices[i * 6 + 5] = firstVertId + 2;
+		}
+
+		m_indexBuffer = api::createIndexBuffer( rend::EFormat::R32_U, indices.size(), 
+			rend::EUsage::Immutable, &indices[0], "ParticleDrawer_IB" );
+	}
+}
+}
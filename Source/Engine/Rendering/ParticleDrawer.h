@@ -0,0 +1,63 @@
+//-----------------------------------------------------------------------------
+//	ParticleDrawer.h: A batched particles drawer
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+namespace gfx
+{
+	/**
+	 *	A particles drawer. Quads of consequent emitters with the
+	 *	same texture are merged into a single draw call
+	 */
+	class ParticleDrawer: public NonCopyable
+	{
+	public:
+		using UPtr = UniquePtr<ParticleDrawer>;
+
+		struct Vertex
+		{
+			math::Vector	pos;
+			math::Vector	tc;
+			math::Color		color;
+		};
+
+		ParticleDrawer();
+		~ParticleDrawer();
+
+		/**
+		 *	Return space for numQuads quads, four vertices per quad.
+		 *	The pointer is valid until the next call
+		 */
+		Vertex* batchQuads( rend::Texture2DHandle texture, Int32 numQuads );
+
+		void flush();
+
+		/**
+		 *	Send draw calls and vertices count to the profiler and
+		 *	reset them, should be called once per frame
+		 */
+		void reportStats();
+
+	private:
+		GrowOnlyVB<Vertex, 4096> m_vertexBuffer;
+
+		rend::IndexBufferHandle m_indexBuffer;
+		Int32 m_indexBufferQuads;
+
+		rend::Texture2DHandle m_currentTexture;
+		Int32 m_numQuads;
+
+		UInt32 m_numDrawCalls;
+		UInt32 m_numVertices;
+
+		ffx::Effect::Ptr m_effect;
+
+		rend::SamplerStateId m_samplerState;
+		rend::BlendStateId m_blendState;
+
+		void prepareIndexBuffer( Int32 numQuads );
+	};
+}
+}
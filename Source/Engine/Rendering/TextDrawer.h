@@ -28,31 +28,31 @@ namespace gfx
 		}
 
 		Float textHeight( fnt::Font::Ptr font, Float yScale ) const;
-		Float textWidth( const Char* text, Int32 len, fnt::Font::Ptr font, Float xScale ) const;
+		Float textWidth( const Char* text, Int32 len, fnt::Font::Ptr font, 
+			Float xScale = 1.f, Float yScale = 1.f );
 
-		Float textWidth( String text, fnt::Font::Ptr font, Float xScale ) const
+		Float textWidth( String text, fnt::Font::Ptr font, Float xScale = 1.f, Float yScale = 1.f )
 		{
-			return textWidth( *text, text.len(), font, xScale );
+			return textWidth( *text, text.len(), font, xScale, yScale );
 		}
 
 		void flush();
 
 	private:
-		struct Vertex
-		{
-			math::Vector	pos;
-			math::Vector	tc;
-			math::Color		color;
-		};
+		using Vertex = fnt::TextVertex;
 
 		GrowOnlyVB<Vertex, 1024> m_vertexBuffer;
 		GrowOnlyIB<UInt16, 1024> m_indexBuffer;
 
 		fnt::Font::Ptr m_currentFont;
+		fnt::LayoutCache m_layoutCache;
 
 		ffx::Effect::Ptr m_effect;
+		ffx::TechniqueId m_mainTech;
+		ffx::TechniqueId m_distanceFieldTech;
 
 		rend::SamplerStateId m_samplerState;
+		rend::SamplerStateId m_distanceFieldSamplerState;
 		rend::BlendStateId m_blendState;
 	};
 }
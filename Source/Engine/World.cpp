@@ -201,5 +201,6 @@ namespace flu
 		profile_counter( Draw_Calls, Draw_Calls,	m_renderDevice->getDrawStats().m_drawCalls );
 		profile_counter( Draw_Calls, BS_Switches,	m_renderDevice->getDrawStats().m_blendStateSwitches );
 		profile_counter( Draw_Calls, RS_Switches,	m_renderDevice->getDrawStats().m_renderStateSwitches );
+		profile_counter( Draw_Calls, SRV_Switches,	m_renderDevice->getDrawStats().m_srvSwitches );
 	}
 }
\ No newline at end of file
@@ -13,6 +13,8 @@ namespace ffx
 	class Compiler final: public res::IResourceCompiler
 	{
 	public:
+		static const constexpr Char* COMPILER_MARK = TXT( "ffx_1" );
+
 		Compiler( rend::ShaderCompiler* apiCompiler );
 		~Compiler();
 
@@ -21,6 +23,12 @@ namespace ffx
 
 		Bool isSupportedFile( String relativePath ) const override;
 
+		String compilerMark() const override
+		{
+			// output depends on the api compiler as well
+			return String( COMPILER_MARK ) + TXT( "/" ) + m_apiCompiler->compilerMark();
+		}
+
 	private:
 		rend::ShaderCompiler::UPtr m_apiCompiler;
 
@@ -23,10 +23,6 @@ namespace fnt
 			return;
 		}
 
-		img::Image::Ptr atlas = font->getImage();
-		const Float atlasUSize = static_cast<Float>( atlas->getUSize() );
-		const Float atlasVSize = static_cast<Float>( atlas->getVSize() );
-
 		const UInt16 firstVertId = firstVtxIndex;
 
 		math::Vector walker = from;
@@ -35,8 +31,8 @@ namespace fnt
 		{
 			const fnt::Glyph glyph = font->getGlyph( text[i] );
 			
-			const Float xCharSize = atlasUSize * glyph.width * xScale;
-			const Float yCharSize = atlasVSize * glyph.height * yScale;
+			const Float xCharSize = glyph.pixelWidth * xScale;
+			const Float yCharSize = glyph.pixelHeight * yScale;
 
 			const math::Vector tc0 = { glyph.x, glyph.y };
 			const math::Vector tc1 = { glyph.x + glyph.width, glyph.y + glyph.height };
@@ -50,6 +50,17 @@ namespace fnt
 		output.references.put( imageResourceId, imageName );
 		// todo: add missing image handling
 
+		// distance field font { "DistanceField": { "Scale": 0.25 } } has an image region
+		// per glyph, scale turns source glyphs size into the text size
+		const Bool distanceField = rootNode->getField( TXT( "DistanceField" ), JSon::EMissingPolicy::USE_NULL ).hasObject();
+		const Float pixelScale = rootNode->dotgetFloat( TXT( "DistanceField.Scale" ), 1.f );
+
+		if( pixelScale <= 0.f )
+		{
+			output.errorMsg = TXT( "Bad distance field scale" );
+			return false;
+		}
+
 
 		// make table of all glyphs
 		Array<Glyph> glyphs;
@@ -90,6 +101,8 @@ namespace fnt
 		UserBufferWriter writer( output.compiledResource.data );
 
 		writer << imageResourceId;
+		writer << distanceField;
+		writer << pixelScale;
 		writer << glyphs;
 		writer << remap;
 
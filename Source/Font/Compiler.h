@@ -13,18 +13,25 @@ namespace fnt
 	class Compiler final: public res::IResourceCompiler
 	{
 	public:
+		static const constexpr Char* COMPILER_MARK = TXT( "fnt_2" );
+
 		Compiler() = default;
 		~Compiler() = default;
 
 		Bool compile( String relativePath, res::IDependencyProvider& dependencyProvider, 
 			res::CompilationOutput& output ) const override;
-;
+
 		Bool isSupportedFile( String relativePath ) const override
 		{
 			const String ext = fm::getFileExt( *relativePath );
 
 			return ext == TXT( "ffnt" );
 		}
+
+		String compilerMark() const override
+		{
+			return COMPILER_MARK;
+		}
 	};
 }
 }
\ No newline at end of file
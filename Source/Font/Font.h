@@ -16,4 +16,5 @@
 #include "FontType.h"
 #include "Compiler.h"
 #include "System.h"
-#include "Batching.h"
\ No newline at end of file
+#include "Batching.h"
+#include "LayoutCache.h"
\ No newline at end of file
@@ -9,11 +9,15 @@ namespace flu
 {
 namespace fnt
 {
+	static concurrency::Atomic g_fontVersion;
+
 	Font::Font( String name )
 		:	Resource( name ),
 			m_image(),
 			m_glyphs(),
-			m_remap()
+			m_remap(),
+			m_distanceField( false ),
+			m_version( 0 )
 	{
 	}
 
@@ -32,19 +36,63 @@ namespace fnt
 		*reader >> imageResourceId;
 		m_image = res::ResourceManager::get<img::Image>( imageResourceId, res::EFailPolicy::FATAL ); // todo: add handler!
 
+		m_version = g_fontVersion.increment();
+
+		Float pixelScale;
+		*reader >> m_distanceField;
+		*reader >> pixelScale;
 		*reader >> m_glyphs;
 		*reader >> m_remap;
 
-		// rescale glyphs
-		for( auto& it : m_glyphs )
+		if( reader->hasError() )
+		{
+			return false;
+		}
+
+		const Array<img::AtlasRect>& regions = m_image->getRegions();
+
+		if( m_distanceField && regions.size() != m_glyphs.size() )
+		{
+			error( TXT( "Font \"%s\" has %d glyphs, but its image has %d regions" ), 
+				*m_name, m_glyphs.size(), regions.size() );
+			return false;
+		}
+
+		// rescale glyphs, distance field glyphs are placed by image converter
+		for( Int32 i = 0; i < m_glyphs.size(); ++i )
 		{
-			it.x /= m_image->getUSize();
-			it.y /= m_image->getVSize();
-			it.width /= m_image->getUSize();
-			it.height /= m_image->getVSize();
+			Glyph& glyph = m_glyphs[i];
+
+			glyph.pixelWidth = glyph.width * pixelScale;
+			glyph.pixelHeight = glyph.height * pixelScale;
+
+			if( m_distanceField )
+			{
+				glyph.x = regions[i].x;
+				glyph.y = regions[i].y;
+				glyph.width = regions[i].width;
+				glyph.height = regions[i].height;
+			}
+
+			glyph.x /= m_image->getUSize();
+			glyph.y /= m_image->getVSize();
+			glyph.width /= m_image->getUSize();
+			glyph.height /= m_image->getVSize();
 		}
 
-		return !reader->hasError();
+		return true;
+	}
+
+	Font::Ptr Font::createFromGlyphs( String name, const Array<Glyph>& glyphs, const Array<UInt16>& remap )
+	{
+		assert( glyphs.size() > 0 && remap.size() > 0 );
+
+		Font* font = new Font( name );
+		font->m_glyphs = glyphs;
+		font->m_remap = remap;
+		font->m_version = g_fontVersion.increment();
+
+		return font;
 	}
 
 	void Font::destroy()
@@ -52,41 +100,42 @@ namespace fnt
 		m_image = nullptr;
 		m_glyphs.empty();
 		m_remap.empty();
+		m_distanceField = false;
 	}
 
 	Float Font::maxHeight() const
 	{
 		// todo: assumed all glyphs are equal
-		assert( m_image.hasObject() );
-		return getGlyph( 'A' ).height * m_image->getVSize();
+		assert( m_glyphs.size() > 0 );
+		return getGlyph( 'A' ).pixelHeight;
 	}
 
 	Float Font::textWidth( const Char* text ) const
 	{
 		assert( text );
-		assert( m_image.hasObject() );
+		assert( m_glyphs.size() > 0 );
 
 		Float width = 0.f;
 		for( const Char* symbol = text; *symbol; ++symbol )
 		{
-			width += getGlyph( *symbol ).width;
+			width += getGlyph( *symbol ).pixelWidth;
 		}
 
-		return width * m_image->getUSize();
+		return width;
 	}
 
 	Float Font::textWidth( const Char* text, Int32 len ) const
 	{
 		assert( text );
-		assert( m_image.hasObject() );
+		assert( m_glyphs.size() > 0 );
 
 		Float width = 0.f;
 		for( Int32 i = 0; i < len; ++i )
 		{
-			width += getGlyph( text[i] ).width;
+			width += getGlyph( text[i] ).pixelWidth;
 		}
 
-		return width * m_image->getUSize();
+		return width;
 	}
 }
 }
\ No newline at end of file
@@ -17,8 +17,27 @@ namespace fnt
 
 		~Font();
 
+		/**
+		 *	Create a font from already prepared glyphs, without image and
+		 *	resource system. Such font is able to measure and lay out text
+		 *	only, glyphs pixel sizes should be set. It's used by tools and tests
+		 */
+		static Ptr createFromGlyphs( String name, const Array<Glyph>& glyphs, const Array<UInt16>& remap );
+
 		img::Image::Ptr getImage() const { return m_image; }
 
+		/**
+		 *	Whether glyphs are stored as signed distance field, such fonts
+		 *	should be drawn with distance field technique and linear filter
+		 */
+		Bool isDistanceField() const { return m_distanceField; }
+
+		/**
+		 *	Unique stamp of the font data, it changes on reload, so
+		 *	cached layouts of the old data are never used
+		 */
+		UInt32 getVersion() const { return m_version; }
+
 		const Glyph& getGlyph( Char c ) const
 		{
 			const UInt32 glyphId = m_remap[min<Int32>( c, m_remap.size() - 1 )];
@@ -34,6 +53,8 @@ namespace fnt
 		img::Image::Ptr m_image;
 		Array<Glyph> m_glyphs;
 		Array<UInt16> m_remap;
+		Bool m_distanceField;
+		UInt32 m_version;
 
 		Font() = delete;
 		Font( String name );
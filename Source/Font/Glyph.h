@@ -18,6 +18,10 @@ namespace fnt
 		Float width;
 		Float height;
 
+		// not serialized, size on screen
+		Float pixelWidth = 0.f;
+		Float pixelHeight = 0.f;
+
 		friend IOutputStream& operator<<( IOutputStream& stream, const Glyph& glyph )
 		{
 			stream << glyph.x << glyph.y << glyph.width << glyph.height;
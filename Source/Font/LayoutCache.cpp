@@ -0,0 +1,197 @@
+//-----------------------------------------------------------------------------
+//	LayoutCache.cpp: A text layout cache implementation
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Font.h"
+
+namespace flu
+{
+namespace fnt
+{
+	static UInt64 makeLayoutKey( const Char* text, Int32 len, UInt32 fontVersion, Float xScale, Float yScale )
+	{
+		struct KeyData
+		{
+			UInt64 textHash;
+			UInt32 fontVersion;
+			Float xScale;
+			Float yScale;
+			UInt32 padding;
+		};
+
+		KeyData keyData;
+		keyData.textHash = hashing::murmur64( text, len * sizeof( Char ) );
+		keyData.fontVersion = fontVersion;
+		keyData.xScale = xScale;
+		keyData.yScale = yScale;
+		keyData.padding = 0;
+
+		return hashing::murmur64( &keyData, sizeof( KeyData ) );
+	}
+
+	LayoutCache::LayoutCache( Int32 capacity )
+		:	m_capacity( capacity ),
+			m_clock( 0 ),
+			m_numMisses( 0 ),
+			m_entries(),
+			m_lookup(),
+			m_indices()
+	{
+		assert( capacity > 0 );
+	}
+
+	LayoutCache::~LayoutCache()
+	{
+		empty();
+	}
+
+	const LayoutCache::Layout& LayoutCache::getLayout( const Char* text, Int32 len, Font::Ptr font,
+		Float xScale, Float yScale )
+	{
+		assert( text && len >= 0 );
+		assert( font.hasObject() );
+
+		const UInt32 fontVersion = font->getVersion();
+		const UInt64 key = makeLayoutKey( text, len, fontVersion, xScale, yScale );
+
+		++m_clock;
+
+		Int32 entryIndex;
+
+		if( const Int32* foundIndex = m_lookup.get( key ) )
+		{
+			Entry& entry = m_entries[*foundIndex];
+
+			if( entry.fontVersion == fontVersion && entry.xScale == xScale && entry.yScale == yScale &&
+				entry.text.size() == len && ( len == 0 || mem::cmp( &entry.text[0], text, len * sizeof( Char ) ) ) )
+			{
+				entry.lastUsed = m_clock;
+				return entry.layout;
+			}
+
+			// hash collision, reuse entry for the new line
+			entryIndex = *foundIndex;
+		}
+		else
+		{
+			entryIndex = allocateEntry();
+			m_lookup.put( key, entryIndex );
+		}
+
+		Entry& entry = m_entries[entryIndex];
+		entry.fontVersion = fontVersion;
+		entry.xScale = xScale;
+		entry.yScale = yScale;
+		entry.lastUsed = m_clock;
+		entry.key = key;
+
+		entry.text.setSize( len );
+
+		if( len > 0 )
+		{
+			mem::copy( &entry.text[0], text, len * sizeof( Char ) );
+		}
+
+		layoutLine( entry, text, len, font );
+		++m_numMisses;
+
+		return entry.layout;
+	}
+
+	void LayoutCache::batchLine( const Char* text, Int32 len, Font::Ptr font, math::Color color,
+		TextVertex* vb, UInt32 firstVtxIndex, UInt16* ib, const math::Vector& from,
+		Float xScale, Float yScale )
+	{
+		assert( font.hasObject() );
+		assert( vb && ib );
+		assert( xScale != 0.f && yScale != 0.f );
+
+		// nothing to draw
+		if( !text || !*text || len == 0 )
+		{
+			return;
+		}
+
+		const Layout& layout = getLayout( text, len, font, xScale, yScale );
+		const TextVertex* source = &layout.vertices[0];
+
+		for( Int32 i = 0; i < layout.vertices.size(); ++i )
+		{
+			vb[i].pos = { source[i].pos.x + from.x, source[i].pos.y + from.y };
+			vb[i].tc = source[i].tc;
+			vb[i].color = color;
+		}
+
+		const UInt16 firstVertId = firstVtxIndex;
+
+		for( Int32 i = 0; i < len; ++i )
+		{
+			const UInt16 vertId = firstVertId + i * 4;
+			const UInt16 indexId = i * 6;
+
+			ib[indexId + 0] = vertId + 0;
+			ib[indexId + 1] = vertId + 1;
+			ib[indexId + 2] = vertId + 2;
+
+			ib[indexId + 3] = vertId + 0;
+			ib[indexId + 4] = vertId + 3;
+			ib[indexId + 5] = vertId + 2;
+		}
+	}
+
+	void LayoutCache::empty()
+	{
+		m_entries.empty();
+		m_lookup.empty();
+		m_indices.empty();
+		m_clock = 0;
+		m_numMisses = 0;
+	}
+
+	Int32 LayoutCache::allocateEntry()
+	{
+		if( m_entries.size() < m_capacity )
+		{
+			m_entries.setSize( m_entries.size() + 1 );
+			return m_entries.size() - 1;
+		}
+
+		// evict least recently used, O(n) is ok since it happens on miss only
+		Int32 oldest = 0;
+
+		for( Int32 i = 1; i < m_entries.size(); ++i )
+		{
+			if( m_entries[i].lastUsed < m_entries[oldest].lastUsed )
+			{
+				oldest = i;
+			}
+		}
+
+		m_lookup.remove( m_entries[oldest].key );
+
+		return oldest;
+	}
+
+	void LayoutCache::layoutLine( Entry& entry, const Char* text, Int32 len, Font::Ptr font )
+	{
+		Layout& layout = entry.layout;
+
+		layout.vertices.setSize( getBatchVertexCount( len ) );
+		layout.width = 0.f;
+		layout.height = getLineHeight( font, entry.yScale );
+
+		if( len > 0 && *text )
+		{
+			// indices are generated on copy
+			m_indices.setSize( max<Int32>( m_indices.size(), getBatchIndexCount( len ) ) );
+
+			fnt::batchLine( text, len, font, math::colors::WHITE, &layout.vertices[0], 0, &m_indices[0],
+				{ 0.f, 0.f }, entry.xScale, entry.yScale );
+
+			// the line starts at origin, so the right edge of the last glyph is the width
+			layout.width = layout.vertices[layout.vertices.size() - 2].pos.x;
+		}
+	}
+}
+}
@@ -0,0 +1,92 @@
+//-----------------------------------------------------------------------------
+//	LayoutCache.h: A text layout cache
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+namespace fnt
+{
+	/**
+	 *	A cache of laid out text lines, keyed by font, text and scale. Each line
+	 *	keeps positioned glyphs quads and its size, so text which doesn't change
+	 *	is only translated and copied. Least recently used lines are evicted
+	 */
+	class LayoutCache: public NonCopyable
+	{
+	public:
+		static const Int32 DEFAULT_CAPACITY = 256;
+
+		/**
+		 *	A laid out line, white glyphs quads from the origin
+		 */
+		struct Layout
+		{
+		public:
+			Array<TextVertex> vertices;
+			Float width;
+			Float height;
+		};
+
+		LayoutCache( Int32 capacity = DEFAULT_CAPACITY );
+		~LayoutCache();
+
+		/**
+		 *	Find or lay out the line, result is valid until the next call
+		 */
+		const Layout& getLayout( const Char* text, Int32 len, Font::Ptr font,
+			Float xScale = 1.f, Float yScale = 1.f );
+
+		/**
+		 *	Return the width of the line, so text measured and drawn with
+		 *	the same scale is laid out only once
+		 */
+		Float textWidth( const Char* text, Int32 len, Font::Ptr font,
+			Float xScale = 1.f, Float yScale = 1.f )
+		{
+			return getLayout( text, len, font, xScale, yScale ).width;
+		}
+
+		/**
+		 *	Same as fnt::batchLine, but reuses cached layout
+		 */
+		void batchLine( const Char* text, Int32 len, Font::Ptr font, math::Color color,
+			TextVertex* vb, UInt32 firstVtxIndex, UInt16* ib, const math::Vector& from,
+			Float xScale = 1.f, Float yScale = 1.f );
+
+		void empty();
+
+		/**
+		 *	Number of lines laid out, i.e. cache misses
+		 */
+		Int32 getNumMisses() const
+		{
+			return m_numMisses;
+		}
+
+	private:
+		struct Entry
+		{
+		public:
+			UInt32 fontVersion;
+			Float xScale;
+			Float yScale;
+			UInt32 lastUsed;
+			UInt64 key;
+			Array<Char> text;
+			Layout layout;
+		};
+
+		Int32 m_capacity;
+		UInt32 m_clock;
+		Int32 m_numMisses;
+
+		Array<Entry> m_entries;
+		Map<UInt64, Int32> m_lookup;
+		Array<UInt16> m_indices;
+
+		Int32 allocateEntry();
+		void layoutLine( Entry& entry, const Char* text, Int32 len, Font::Ptr font );
+	};
+}
+}
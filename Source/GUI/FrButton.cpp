@@ -109,7 +109,7 @@ void WCheckBox::OnPaint( CGUIRenderBase* Render )
 	WWidget::OnPaint( Render );
 
 	TPoint Base = ClientToWindow(TPoint(0, 0));
-	TSize  TextSize = TSize( Root->Font1->textWidth(*Caption), Root->Font1->maxHeight() );
+	TSize  TextSize = TSize( Render->TextWidth( Caption, Root->Font1 ), Root->Font1->maxHeight() );
 
 	Render->DrawRegion
 			( 
@@ -241,7 +241,7 @@ void WRadioButton::OnPaint( CGUIRenderBase* Render )
 	WWidget::OnPaint( Render );
 
 	TPoint Base	= ClientToWindow(TPoint::Zero);
-	TSize  TextSize = TSize( Root->Font1->textWidth(*Caption), Root->Font1->maxHeight() );
+	TSize  TextSize = TSize( Render->TextWidth( Caption, Root->Font1 ), Root->Font1->maxHeight() );
 
 	Int32 iState = bChecked ? 1 : bHold ? 2 : 0;
 
@@ -388,7 +388,7 @@ void WButton::OnPaint( CGUIRenderBase* Render )
 	WWidget::OnPaint( Render );
 
 	TPoint Base = ClientToWindow(TPoint(0, 0));
-	TSize  TextSize = TSize( Root->Font1->textWidth(*Caption), Root->Font1->maxHeight() );
+	TSize  TextSize = TSize( Render->TextWidth( Caption, Root->Font1 ), Root->Font1->maxHeight() );
 
 	Render->DrawRegion
 			( 
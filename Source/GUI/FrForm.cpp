@@ -163,7 +163,7 @@ void WForm::OnPaint( CGUIRenderBase* Render )
 					);
 
 	// Caption.
-	TSize TextSize	= TSize( Root->Font1->textWidth(*Caption), Root->Font1->maxHeight() );
+	TSize TextSize	= TSize( Render->TextWidth( Caption, Root->Font1 ), Root->Font1->maxHeight() );
 
 	Render->DrawText
 				( 
@@ -874,7 +874,7 @@ void WWindow::DrawTooltip( CGUIRenderBase* Render )
 			(GPlat->Now()-LastHighlightTime) > 0.5f 
 		)
 	{
-		TSize HintSize = TSize( Font1->textWidth(*Highlight->Tooltip), Font1->maxHeight() );
+		TSize HintSize = TSize( Render->TextWidth( Highlight->Tooltip, Font1 ), Font1->maxHeight() );
 		TPoint DrawPos = TPoint( MousePos.X+16, MousePos.Y+8 );
 		Render->SetClipArea( TPoint(0, 0), Size );		
 
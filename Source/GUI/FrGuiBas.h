@@ -308,12 +308,17 @@ public:
 	virtual void DrawTexture( TPoint P, TSize S, TPoint BP, TSize BS, rend::Texture2DHandle image, UInt32 width, UInt32 height ) = 0;
 	virtual void DrawText( TPoint P, const Char* Text, Int32 Len, math::Color Color, fnt::Font::Ptr Font ) = 0;
 	virtual void SetBrightness( Float Brig ) = 0;
+	virtual Float TextWidth( const Char* Text, Int32 Len, fnt::Font::Ptr Font ) = 0;
 
 	// CGUIRenderBase utility.
 	void DrawText( TPoint P, String Text, math::Color Color, fnt::Font::Ptr Font )
 	{
 		DrawText( P, *Text, Text.len(), Color, Font );
 	}
+	Float TextWidth( String Text, fnt::Font::Ptr Font )
+	{
+		return TextWidth( *Text, Text.len(), Font );
+	}
 };
 
 
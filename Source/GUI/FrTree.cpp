@@ -272,7 +272,7 @@ void WTreeView::OnPaint( CGUIRenderBase* Render )
 		// Selection mark, if required.
 		if( iNode == iSelected )
 		{
-			Int32 TextWidth = Root->Font1->textWidth(*Node.Name);
+			Int32 TextWidth = Render->TextWidth( Node.Name, Root->Font1 );
 
 			Render->DrawRegion
 			(
@@ -50,14 +50,14 @@ CGame::CGame()
 		Level( nullptr )
 {
 	// Initial logging
-	LogManager::instance().addCallback( new LogCallbackFile( L"Client.log" ) );
+	LogManager::instance().addAsyncCallback( new LogCallbackFile( L"Client.log" ) );
 
 #if FLU_DEBUG
-	LogManager::instance().addCallback( new LogCallbackDebug( true ) );
+	LogManager::instance().addAsyncCallback( new LogCallbackDebug( true ) );
 
 	if( !IsDebuggerPresent() )
 	{
-		LogManager::instance().addCallback( new LogCallbackConsole() );
+		LogManager::instance().addAsyncCallback( new LogCallbackConsole() );
 	}
 #endif
 
@@ -755,21 +755,40 @@ void CGame::RunLevel( FLevel* Source, Bool bCopy )
 	assert(Source);
 
 	// Shutdown previous level.
+	FLevel* Leaving = nullptr;
 	if( Level )
 	{
 		assert(Level->bIsPlaying);
 		Level->EndPlay();
 
-		// If level is temporal - eliminate it.
+		// If level is temporal - eliminate it, otherwise
+		// its content will be unloaded after switching.
 		if( Level->IsTemporal() )
 			DestroyObject( Level, true );
+		else
+			Leaving	= Level;
 
 		Level	= nullptr;
 	}
 
-	// Duplicate level, if required.
+	// Duplicate level from snapshot, if required. Otherwise
+	// stream level's content, if it's not loaded yet.
 	if( bCopy )
-		Source	= Project->DuplicateLevel(Source);
+	{
+		CLevelSnapshot* Snapshot = Project->GetLevelSnapshot( Source );
+		if( !Snapshot )
+			fatal( L"Level '%s' is not available", *Source->GetName() );
+
+		Source	= Snapshot->Instantiate();
+	}
+	else if( !Project->LoadLevel( Source ) )
+	{
+		fatal( L"Level '%s' is not available", *Source->GetName() );
+	}
+
+	// Release streamed content of the left level.
+	if( Leaving && Leaving != Source )
+		Project->UnloadLevel( Leaving );
 
 	// Unload cache.
 	Flush();
@@ -791,9 +810,14 @@ void CGame::RunLevel( FLevel* Source, Bool bCopy )
 //
 FLevel* CGame::FindLevel( String LevName )
 {
+	// Lower case version of each object name is interned too,
+	// so if there is no such name, there is no such level.
+	NameId Caseless = NameId::findInsensitive( *LevName );
+	if( !Caseless )
+		return nullptr;
+
 	for( Int32 i=0; i<LevelList.size(); i++ )
-		if(	String::upperCase(LevelList[i]->GetName()) == 
-			String::upperCase(LevName) )
+		if(	LevelList[i]->GetNameId().caseless() == Caseless )
 				return LevelList[i];
 
 	return nullptr;
@@ -822,6 +846,26 @@ void CGame::ConsoleExecute( String CmdLine )
 		if( Project )
 			Project->BlockMan->DebugManager();
 	}
+	else if( String::insensitiveCompare(Token, L"CodecBench") == 0 )
+	{
+		// Benchmark data compressors.
+		if( Project )
+			Project->BlockMan->BenchmarkCodecs();
+	}
+	else if( String::insensitiveCompare(Token, L"JSonBench") == 0 )
+	{
+		// Benchmark json loaders.
+		String FileName = CCmdLineParser::ParseStringParam(CmdLine, L"file");
+		if( FileName )
+		{
+			JSon::benchmarkLoaders( *FileName );
+		}
+		else
+		{
+			JSon::benchmarkLoaders( L"Packages\\Fonts\\Verdana_14.ffnt" );
+			JSon::benchmarkLoaders( L"Packages\\Experimental\\TestUI.layout" );
+		}
+	}
 	else if( String::insensitiveCompare(Token, L"Quit") == 0 )
 	{
 		// Shutdown application.
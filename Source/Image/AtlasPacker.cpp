@@ -0,0 +1,302 @@
+//-----------------------------------------------------------------------------
+//	AtlasPacker.cpp: Sprites atlas packing
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Image.h"
+
+namespace flu
+{
+namespace img
+{
+	static inline Bool isContained( const AtlasRect& a, const AtlasRect& b )
+	{
+		return a.x >= b.x && a.y >= b.y && a.x + a.width <= b.x + b.width &&
+			a.y + a.height <= b.y + b.height;
+	}
+
+	static inline Bool isOverlapped( const AtlasRect& a, const AtlasRect& b )
+	{
+		return a.x < b.x + b.width && b.x < a.x + a.width &&
+			a.y < b.y + b.height && b.y < a.y + a.height;
+	}
+
+	AtlasPacker::AtlasPacker( Int32 width, Int32 height )
+		:	m_width( width ),
+			m_height( height ),
+			m_usedArea( 0 ),
+			m_freeRects()
+	{
+		assert( width > 0 && height > 0 );
+		m_freeRects.push( { 0, 0, width, height } );
+	}
+
+	AtlasPacker::~AtlasPacker()
+	{
+	}
+
+	Bool AtlasPacker::insert( Int32 width, Int32 height, AtlasRect& result )
+	{
+		assert( width > 0 && height > 0 );
+
+		Int32 bestShortSide = MAX_INT32;
+		Int32 bestLongSide = MAX_INT32;
+		Int32 bestIndex = -1;
+
+		for( Int32 i = 0; i < m_freeRects.size(); ++i )
+		{
+			const AtlasRect& freeRect = m_freeRects[i];
+
+			if( freeRect.width >= width && freeRect.height >= height )
+			{
+				const Int32 leftoverX = freeRect.width - width;
+				const Int32 leftoverY = freeRect.height - height;
+				const Int32 shortSide = min( leftoverX, leftoverY );
+				const Int32 longSide = max( leftoverX, leftoverY );
+
+				if( shortSide < bestShortSide || ( shortSide == bestShortSide && longSide < bestLongSide ) )
+				{
+					bestShortSide = shortSide;
+					bestLongSide = longSide;
+					bestIndex = i;
+				}
+			}
+		}
+
+		if( bestIndex == -1 )
+		{
+			return false;
+		}
+
+		result = { m_freeRects[bestIndex].x, m_freeRects[bestIndex].y, width, height };
+
+		splitFreeRects( result );
+		pruneFreeRects();
+
+		m_usedArea += Int64( width ) * height;
+		return true;
+	}
+
+	Float AtlasPacker::getOccupancy() const
+	{
+		return Float( Double( m_usedArea ) / ( Double( m_width ) * m_height ) );
+	}
+
+	void AtlasPacker::splitFreeRects( const AtlasRect& usedRect )
+	{
+		for( Int32 i = 0; i < m_freeRects.size(); )
+		{
+			const AtlasRect freeRect = m_freeRects[i];
+
+			if( !isOverlapped( usedRect, freeRect ) )
+			{
+				++i;
+				continue;
+			}
+
+			m_freeRects.removeFast( i );
+
+			// keep maximal free rectangles around used one, they may overlap
+			if( usedRect.x > freeRect.x )
+			{
+				m_freeRects.push( { freeRect.x, freeRect.y, usedRect.x - freeRect.x, freeRect.height } );
+			}
+
+			if( usedRect.x + usedRect.width < freeRect.x + freeRect.width )
+			{
+				const Int32 x = usedRect.x + usedRect.width;
+				m_freeRects.push( { x, freeRect.y, freeRect.x + freeRect.width - x, freeRect.height } );
+			}
+
+			if( usedRect.y > freeRect.y )
+			{
+				m_freeRects.push( { freeRect.x, freeRect.y, freeRect.width, usedRect.y - freeRect.y } );
+			}
+
+			if( usedRect.y + usedRect.height < freeRect.y + freeRect.height )
+			{
+				const Int32 y = usedRect.y + usedRect.height;
+				m_freeRects.push( { freeRect.x, y, freeRect.width, freeRect.y + freeRect.height - y } );
+			}
+		}
+	}
+
+	void AtlasPacker::pruneFreeRects()
+	{
+		for( Int32 i = 0; i < m_freeRects.size(); ++i )
+		{
+			for( Int32 j = i + 1; j < m_freeRects.size(); )
+			{
+				if( isContained( m_freeRects[i], m_freeRects[j] ) )
+				{
+					m_freeRects.removeShift( i );
+					--i;
+					break;
+				}
+				else if( isContained( m_freeRects[j], m_freeRects[i] ) )
+				{
+					m_freeRects.removeShift( j );
+				}
+				else
+				{
+					++j;
+				}
+			}
+		}
+	}
+
+	/**
+	 *	An atlas cell, measured in alignment units
+	 */
+	struct AtlasCell
+	{
+	public:
+		Int32 source;
+		Int32 width;
+		Int32 height;
+	};
+
+	static Bool packCells( const Array<AtlasCell>& cells, Int32 width, Int32 height, Array<AtlasRect>& placement )
+	{
+		AtlasPacker packer( width, height );
+
+		for( const auto& it : cells )
+		{
+			if( !packer.insert( it.width, it.height, placement[it.source] ) )
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	static void copyExtruded( const AtlasSource& source, Int32 extrusion, math::Color* atlas,
+		Int32 atlasWidth, Int32 x, Int32 y )
+	{
+		for( Int32 v = -extrusion; v < source.height + extrusion; ++v )
+		{
+			const math::Color* sourceRow = &source.image[clamp( v, 0, source.height - 1 ) * source.width];
+			math::Color* atlasRow = &atlas[( y + v ) * atlasWidth + x];
+
+			for( Int32 u = -extrusion; u < 0; ++u )
+			{
+				atlasRow[u] = sourceRow[0];
+			}
+
+			mem::copy( atlasRow, sourceRow, source.width * sizeof( math::Color ) );
+
+			for( Int32 u = source.width; u < source.width + extrusion; ++u )
+			{
+				atlasRow[u] = sourceRow[source.width - 1];
+			}
+		}
+	}
+
+	Bool buildAtlas( const Array<AtlasSource>& sources, const AtlasSettings& settings,
+		Array<math::Color>& atlas, Int32& width, Int32& height, Array<AtlasRect>& regions )
+	{
+		assert( sources.size() > 0 );
+		assert( settings.padding >= 0 && settings.extrusion >= 0 && settings.mipSafeLevels >= 0 );
+
+		const Int32 alignment = 1 << settings.mipSafeLevels;
+		const Int32 border = settings.extrusion * 2 + settings.padding;
+
+		// measure cells in alignment units, so every cell starts on aligned pixel
+		Array<AtlasCell> cells( sources.size() );
+		Int64 totalArea = 0;
+		Int32 maxSide = 0;
+
+		for( Int32 i = 0; i < sources.size(); ++i )
+		{
+			cells[i].source = i;
+			cells[i].width = ( sources[i].width + border + alignment - 1 ) / alignment;
+			cells[i].height = ( sources[i].height + border + alignment - 1 ) / alignment;
+
+			totalArea += Int64( cells[i].width ) * cells[i].height;
+			maxSide = max( maxSide, max( cells[i].width, cells[i].height ) );
+		}
+
+		// big ones first
+		cells.sort( []( const AtlasCell& a, const AtlasCell& b )->Bool
+		{
+			const Int32 aSide = max( a.width, a.height );
+			const Int32 bSide = max( b.width, b.height );
+
+			if( aSide != bSide )
+			{
+				return aSide > bSide;
+			}
+			else if( a.width * a.height != b.width * b.height )
+			{
+				return a.width * a.height > b.width * b.height;
+			}
+			else
+			{
+				return a.source < b.source;
+			}
+		} );
+
+		// grow the page from the smallest one which may fit
+		const Int32 maxUnits = settings.maxSize / alignment;
+		Int32 unitsX = 1;
+		Int32 unitsY = 1;
+
+		while( unitsX < maxSide || Int64( unitsX ) * unitsX < totalArea )
+		{
+			unitsX *= 2;
+		}
+
+		unitsY = unitsX;
+
+		if( Int64( unitsX ) * ( unitsY / 2 ) >= totalArea && unitsY / 2 >= maxSide )
+		{
+			unitsY /= 2;
+		}
+
+		Array<AtlasRect> placement( sources.size() );
+
+		for( ; ; )
+		{
+			if( unitsX > maxUnits || unitsY > maxUnits )
+			{
+				return false;
+			}
+
+			if( packCells( cells, unitsX, unitsY, placement ) )
+			{
+				break;
+			}
+
+			if( unitsY < unitsX )
+			{
+				unitsY *= 2;
+			}
+			else
+			{
+				unitsX *= 2;
+			}
+		}
+
+		width = unitsX * alignment;
+		height = unitsY * alignment;
+
+		atlas.setSize( width * height );
+		mem::zero( &atlas[0], atlas.size() * sizeof( math::Color ) );
+
+		regions.setSize( sources.size() );
+
+		for( Int32 i = 0; i < sources.size(); ++i )
+		{
+			regions[i].x = placement[i].x * alignment + settings.extrusion;
+			regions[i].y = placement[i].y * alignment + settings.extrusion;
+			regions[i].width = sources[i].width;
+			regions[i].height = sources[i].height;
+
+			copyExtruded( sources[i], settings.extrusion, &atlas[0], width, regions[i].x, regions[i].y );
+		}
+
+		return true;
+	}
+}
+}
@@ -0,0 +1,80 @@
+//-----------------------------------------------------------------------------
+//	AtlasPacker.h: Sprites atlas packing
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+namespace img
+{
+	/**
+	 *	A rectangle within an atlas, in pixels
+	 */
+	struct AtlasRect
+	{
+	public:
+		Int32 x;
+		Int32 y;
+		Int32 width;
+		Int32 height;
+	};
+
+	/**
+	 *	A MaxRects bin packer, places each rectangle into the free
+	 *	area with the best short side fit
+	 */
+	class AtlasPacker: public NonCopyable
+	{
+	public:
+		AtlasPacker( Int32 width, Int32 height );
+		~AtlasPacker();
+
+		Bool insert( Int32 width, Int32 height, AtlasRect& result );
+
+		Float getOccupancy() const;
+
+	private:
+		Int32 m_width;
+		Int32 m_height;
+		Int64 m_usedArea;
+
+		Array<AtlasRect> m_freeRects;
+
+		AtlasPacker() = delete;
+
+		void splitFreeRects( const AtlasRect& usedRect );
+		void pruneFreeRects();
+	};
+
+	/**
+	 *	An atlas building settings
+	 */
+	struct AtlasSettings
+	{
+	public:
+		Int32 maxSize = 2048;
+		Int32 padding = 2;
+		Int32 extrusion = 1;
+		Int32 mipSafeLevels = 2;
+	};
+
+	/**
+	 *	An image to pack into atlas
+	 */
+	struct AtlasSource
+	{
+	public:
+		const math::Color* image;
+		Int32 width;
+		Int32 height;
+	};
+
+	/**
+	 *	Pack all sources into a single power of two atlas page. Each image gets
+	 *	extruded edges and its own cell aligned to 2^mipSafeLevels pixels, so the
+	 *	first mipSafeLevels mips never mix neighbours. Regions are in sources order
+	 */
+	extern Bool buildAtlas( const Array<AtlasSource>& sources, const AtlasSettings& settings,
+		Array<math::Color>& atlas, Int32& width, Int32& height, Array<AtlasRect>& regions );
+}
+}
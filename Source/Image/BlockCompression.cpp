@@ -0,0 +1,1057 @@
+//-----------------------------------------------------------------------------
+//	BlockCompression.cpp: BC1/BC3/BC7 texture blocks encoder and decoder
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Image.h"
+
+namespace flu
+{
+namespace img
+{
+	static const Int32 BLOCK_SIZE = 4;
+	static const Int32 BLOCK_PIXELS = BLOCK_SIZE * BLOCK_SIZE;
+	static const UInt32 ALL_PIXELS = 0xffff;
+
+	static const Int32 BLOCK_ROWS_PER_TASK = 4;
+	static const Int32 MAX_TASKS = 32;
+
+	static const Int32 POWER_ITERATIONS = 8;
+	static const Float BC1_ALPHA_THRESHOLD = 128.f;
+
+	// weights of the first endpoint in the palette order
+	static const Float BC1_OPAQUE_WEIGHTS[4] = { 1.f, 0.f, 2.f / 3.f, 1.f / 3.f };
+	static const Float BC1_TRANSPARENT_WEIGHTS[3] = { 1.f, 0.f, 0.5f };
+
+	static const Int32 BC7_MODE5_WEIGHTS[4] = { 0, 21, 43, 64 };
+	static const Int32 BC7_MODE6_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	/**
+	 *	A 4x4 pixels block in structure of arrays layout, so
+	 *	four pixels are processed at once
+	 */
+	struct BlockPixels
+	{
+	public:
+		alignas( 16 ) Float channels[4][BLOCK_PIXELS];
+	};
+
+	struct BlockPalette
+	{
+	public:
+		Float colors[16][4];
+		Int32 numColors;
+	};
+
+	struct ColorBlock
+	{
+	public:
+		UInt16 color0;
+		UInt16 color1;
+		UInt8 indices[BLOCK_PIXELS];
+		Float error;
+	};
+
+	struct BC7Mode5Block
+	{
+	public:
+		Int32 colorEndpoints[2][3];
+		Int32 alphaEndpoints[2];
+		UInt8 colorIndices[BLOCK_PIXELS];
+		UInt8 alphaIndices[BLOCK_PIXELS];
+		Float error;
+	};
+
+	struct BC7Mode6Block
+	{
+	public:
+		Int32 endpoints[2][4];
+		Int32 pbits[2];
+		UInt8 indices[BLOCK_PIXELS];
+		Float error;
+	};
+
+	static void fetchBlock( const math::Color* image, Int32 width, Int32 height,
+		Int32 blockX, Int32 blockY, BlockPixels& block )
+	{
+		for( Int32 y = 0; y < BLOCK_SIZE; ++y )
+		{
+			const math::Color* row = &image[min( blockY * BLOCK_SIZE + y, height - 1 ) * width];
+
+			for( Int32 x = 0; x < BLOCK_SIZE; ++x )
+			{
+				// levels smaller than a block are padded with edge pixels
+				const math::Color pixel = row[min( blockX * BLOCK_SIZE + x, width - 1 )];
+				const Int32 i = y * BLOCK_SIZE + x;
+
+				block.channels[0][i] = pixel.r;
+				block.channels[1][i] = pixel.g;
+				block.channels[2][i] = pixel.b;
+				block.channels[3][i] = pixel.a;
+			}
+		}
+	}
+
+	/**
+	 *	Return lanes mask of four pixels starting from first
+	 */
+	static inline math::simd::Float4 pixelsMask( UInt32 mask, Int32 first )
+	{
+		const __m128i bits = _mm_setr_epi32( 1, 2, 4, 8 );
+		return _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_and_si128( _mm_set1_epi32( mask >> first ), bits ), bits ) );
+	}
+
+	/**
+	 *	Find endpoints as extent of masked pixels along their principal axis
+	 */
+	static void findEndpoints( const BlockPixels& block, UInt32 mask, Int32 numChannels,
+		Float start[4], Float end[4] )
+	{
+		Float mean[4] = { 0.f, 0.f, 0.f, 0.f };
+		Float minColor[4] = { 255.f, 255.f, 255.f, 255.f };
+		Float maxColor[4] = { 0.f, 0.f, 0.f, 0.f };
+		Int32 numPixels = 0;
+
+		for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+		{
+			if( mask & ( 1 << i ) )
+			{
+				for( Int32 c = 0; c < numChannels; ++c )
+				{
+					mean[c] += block.channels[c][i];
+					minColor[c] = min( minColor[c], block.channels[c][i] );
+					maxColor[c] = max( maxColor[c], block.channels[c][i] );
+				}
+
+				++numPixels;
+			}
+		}
+
+		assert( numPixels > 0 );
+
+		for( Int32 c = 0; c < numChannels; ++c )
+		{
+			mean[c] /= numPixels;
+		}
+
+		Float covariance[4][4] = {};
+
+		for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+		{
+			if( mask & ( 1 << i ) )
+			{
+				for( Int32 j = 0; j < numChannels; ++j )
+				{
+					for( Int32 k = 0; k < numChannels; ++k )
+					{
+						covariance[j][k] += ( block.channels[j][i] - mean[j] ) * ( block.channels[k][i] - mean[k] );
+					}
+				}
+			}
+		}
+
+		// power iteration, starting from the bounding box diagonal
+		Float axis[4] = { 0.f, 0.f, 0.f, 0.f };
+
+		for( Int32 c = 0; c < numChannels; ++c )
+		{
+			axis[c] = maxColor[c] - minColor[c];
+		}
+
+		for( Int32 iteration = 0; iteration < POWER_ITERATIONS; ++iteration )
+		{
+			Float next[4] = { 0.f, 0.f, 0.f, 0.f };
+			Float largest = 0.f;
+
+			for( Int32 j = 0; j < numChannels; ++j )
+			{
+				for( Int32 k = 0; k < numChannels; ++k )
+				{
+					next[j] += covariance[j][k] * axis[k];
+				}
+
+				largest = max( largest, abs( next[j] ) );
+			}
+
+			if( largest < 1e-6f )
+			{
+				break;
+			}
+
+			for( Int32 j = 0; j < numChannels; ++j )
+			{
+				axis[j] = next[j] / largest;
+			}
+		}
+
+		Float axisLength = 0.f;
+		Float minProjection = 0.f;
+		Float maxProjection = 0.f;
+
+		for( Int32 c = 0; c < numChannels; ++c )
+		{
+			axisLength += sqr( axis[c] );
+		}
+
+		if( axisLength > 1e-6f )
+		{
+			axisLength = math::sqrt( axisLength );
+
+			for( Int32 c = 0; c < numChannels; ++c )
+			{
+				axis[c] /= axisLength;
+			}
+
+			for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+			{
+				if( mask & ( 1 << i ) )
+				{
+					Float projection = 0.f;
+
+					for( Int32 c = 0; c < numChannels; ++c )
+					{
+						projection += ( block.channels[c][i] - mean[c] ) * axis[c];
+					}
+
+					minProjection = min( minProjection, projection );
+					maxProjection = max( maxProjection, projection );
+				}
+			}
+		}
+
+		for( Int32 c = 0; c < numChannels; ++c )
+		{
+			start[c] = clamp( mean[c] + axis[c] * minProjection, 0.f, 255.f );
+			end[c] = clamp( mean[c] + axis[c] * maxProjection, 0.f, 255.f );
+		}
+	}
+
+	/**
+	 *	Least squares endpoints for the given indices. Return false
+	 *	if all the pixels have the same weight
+	 */
+	static Bool refineEndpoints( const BlockPixels& block, UInt32 mask, Int32 numChannels,
+		const UInt8 indices[BLOCK_PIXELS], const Float* weights, Float start[4], Float end[4] )
+	{
+		Float startStart = 0.f, endEnd = 0.f, startEnd = 0.f;
+		Float startSum[4] = { 0.f, 0.f, 0.f, 0.f };
+		Float endSum[4] = { 0.f, 0.f, 0.f, 0.f };
+
+		for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+		{
+			if( mask & ( 1 << i ) )
+			{
+				const Float startWeight = weights[indices[i]];
+				const Float endWeight = 1.f - startWeight;
+
+				startStart += startWeight * startWeight;
+				endEnd += endWeight * endWeight;
+				startEnd += startWeight * endWeight;
+
+				for( Int32 c = 0; c < numChannels; ++c )
+				{
+					startSum[c] += startWeight * block.channels[c][i];
+					endSum[c] += endWeight * block.channels[c][i];
+				}
+			}
+		}
+
+		const Float determinant = startStart * endEnd - startEnd * startEnd;
+
+		if( abs( determinant ) < 1e-6f )
+		{
+			return false;
+		}
+
+		for( Int32 c = 0; c < numChannels; ++c )
+		{
+			start[c] = clamp( ( startSum[c] * endEnd - endSum[c] * startEnd ) / determinant, 0.f, 255.f );
+			end[c] = clamp( ( endSum[c] * startStart - startSum[c] * startEnd ) / determinant, 0.f, 255.f );
+		}
+
+		return true;
+	}
+
+	/**
+	 *	Pick the nearest palette color for every pixel, four pixels
+	 *	at once. Return squared error of masked pixels
+	 */
+	static Float selectIndices( const BlockPixels& block, UInt32 mask, Int32 numChannels,
+		const BlockPalette& palette, UInt8 indices[BLOCK_PIXELS] )
+	{
+		using namespace math::simd;
+
+		Float4 totalError = _mm_setzero_ps();
+
+		for( Int32 i = 0; i < BLOCK_PIXELS; i += 4 )
+		{
+			Float4 bestError = splat( 1e30f );
+			__m128i bestIndex = _mm_setzero_si128();
+
+			for( Int32 j = 0; j < palette.numColors; ++j )
+			{
+				Float4 error = _mm_setzero_ps();
+
+				for( Int32 c = 0; c < numChannels; ++c )
+				{
+					const Float4 delta = _mm_sub_ps( load( &block.channels[c][i] ), splat( palette.colors[j][c] ) );
+					error = _mm_add_ps( error, _mm_mul_ps( delta, delta ) );
+				}
+
+				const __m128i better = _mm_castps_si128( _mm_cmplt_ps( error, bestError ) );
+				bestIndex = _mm_or_si128( _mm_and_si128( better, _mm_set1_epi32( j ) ), _mm_andnot_si128( better, bestIndex ) );
+				bestError = _mm_min_ps( error, bestError );
+			}
+
+			Int32 pixelIndices[4];
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( pixelIndices ), bestIndex );
+
+			for( Int32 k = 0; k < 4; ++k )
+			{
+				indices[i + k] = static_cast<UInt8>( pixelIndices[k] );
+			}
+
+			totalError = _mm_add_ps( totalError, _mm_and_ps( bestError, pixelsMask( mask, i ) ) );
+		}
+
+		Float errors[4];
+		store( errors, totalError );
+
+		return errors[0] + errors[1] + errors[2] + errors[3];
+	}
+
+	static inline UInt16 packColor565( const Float color[4] )
+	{
+		return static_cast<UInt16>( ( math::round( color[0] * ( 31.f / 255.f ) ) << 11 ) |
+			( math::round( color[1] * ( 63.f / 255.f ) ) << 5 ) | math::round( color[2] * ( 31.f / 255.f ) ) );
+	}
+
+	static inline math::Color unpackColor565( UInt16 packed )
+	{
+		const UInt8 r = ( packed >> 11 ) & 0x1f;
+		const UInt8 g = ( packed >> 5 ) & 0x3f;
+		const UInt8 b = packed & 0x1f;
+
+		return math::Color( ( r << 3 ) | ( r >> 2 ), ( g << 2 ) | ( g >> 4 ), ( b << 3 ) | ( b >> 2 ), 0xff );
+	}
+
+	/**
+	 *	Build BC1 palette the same way as decoder does
+	 */
+	static void buildColorPalette( UInt16 color0, UInt16 color1, Bool fourColors, math::Color palette[4] )
+	{
+		const math::Color a = unpackColor565( color0 );
+		const math::Color b = unpackColor565( color1 );
+
+		palette[0] = a;
+		palette[1] = b;
+
+		if( fourColors )
+		{
+			palette[2] = math::Color( ( 2 * a.r + b.r ) / 3, ( 2 * a.g + b.g ) / 3, ( 2 * a.b + b.b ) / 3, 0xff );
+			palette[3] = math::Color( ( a.r + 2 * b.r ) / 3, ( a.g + 2 * b.g ) / 3, ( a.b + 2 * b.b ) / 3, 0xff );
+		}
+		else
+		{
+			palette[2] = math::Color( ( a.r + b.r ) / 2, ( a.g + b.g ) / 2, ( a.b + b.b ) / 2, 0xff );
+			palette[3] = math::Color( 0x00, 0x00, 0x00, 0x00 );
+		}
+	}
+
+	/**
+	 *	Quantize endpoints and select indices. Transparent mode keeps
+	 *	color0 <= color1 and the last index for transparent pixels
+	 */
+	static void fitColorBlock( const BlockPixels& block, UInt32 opaqueMask, Bool transparentMode,
+		const Float start[4], const Float end[4], ColorBlock& result )
+	{
+		result.color0 = packColor565( start );
+		result.color1 = packColor565( end );
+
+		if( transparentMode ? result.color0 > result.color1 : result.color0 < result.color1 )
+		{
+			exchange( result.color0, result.color1 );
+		}
+
+		// equal colors also fall into three colors mode, so the last index is never used
+		const Bool fourColors = result.color0 > result.color1;
+
+		math::Color colors[4];
+		buildColorPalette( result.color0, result.color1, fourColors, colors );
+
+		BlockPalette palette;
+		palette.numColors = fourColors ? 4 : 3;
+
+		for( Int32 i = 0; i < palette.numColors; ++i )
+		{
+			palette.colors[i][0] = colors[i].r;
+			palette.colors[i][1] = colors[i].g;
+			palette.colors[i][2] = colors[i].b;
+		}
+
+		result.error = selectIndices( block, opaqueMask, 3, palette, result.indices );
+
+		for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+		{
+			if( !( opaqueMask & ( 1 << i ) ) )
+			{
+				result.indices[i] = 3;
+			}
+		}
+	}
+
+	static void encodeColorBlock( const BlockPixels& block, Bool allowTransparent, UInt8* output )
+	{
+		UInt32 opaqueMask = ALL_PIXELS;
+
+		if( allowTransparent )
+		{
+			opaqueMask = 0;
+
+			for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+			{
+				opaqueMask |= block.channels[3][i] >= BC1_ALPHA_THRESHOLD ? 1 << i : 0;
+			}
+		}
+
+		const Bool transparentMode = opaqueMask != ALL_PIXELS;
+		ColorBlock best;
+
+		if( opaqueMask != 0 )
+		{
+			Float start[4], end[4];
+			findEndpoints( block, opaqueMask, 3, start, end );
+			fitColorBlock( block, opaqueMask, transparentMode, start, end, best );
+
+			// a single least squares pass is enough for most of blocks
+			const Float* weights = best.color0 > best.color1 ? BC1_OPAQUE_WEIGHTS : BC1_TRANSPARENT_WEIGHTS;
+
+			if( refineEndpoints( block, opaqueMask, 3, best.indices, weights, start, end ) )
+			{
+				ColorBlock refined;
+				fitColorBlock( block, opaqueMask, transparentMode, start, end, refined );
+
+				if( refined.error < best.error )
+				{
+					best = refined;
+				}
+			}
+		}
+		else
+		{
+			// fully transparent block
+			best.color0 = best.color1 = 0;
+			mem::set( best.indices, sizeof( best.indices ), 3 );
+		}
+
+		UInt32 bits = 0;
+
+		for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+		{
+			bits |= UInt32( best.indices[i] ) << ( i * 2 );
+		}
+
+		output[0] = best.color0 & 0xff;
+		output[1] = best.color0 >> 8;
+		output[2] = best.color1 & 0xff;
+		output[3] = best.color1 >> 8;
+
+		for( Int32 i = 0; i < 4; ++i )
+		{
+			output[4 + i] = static_cast<UInt8>( bits >> ( i * 8 ) );
+		}
+	}
+
+	static void encodeAlphaBlock( const BlockPixels& block, UInt8* output )
+	{
+		using namespace math::simd;
+
+		Float4 minAlpha = load( &block.channels[3][0] );
+		Float4 maxAlpha = minAlpha;
+
+		for( Int32 i = 4; i < BLOCK_PIXELS; i += 4 )
+		{
+			minAlpha = _mm_min_ps( minAlpha, load( &block.channels[3][i] ) );
+			maxAlpha = _mm_max_ps( maxAlpha, load( &block.channels[3][i] ) );
+		}
+
+		const Int32 alpha0 = math::round( horizontalMax( maxAlpha ) );
+		const Int32 alpha1 = math::round( horizontalMin( minAlpha ) );
+
+		UInt64 bits = 0;
+
+		if( alpha0 > alpha1 )
+		{
+			// eight evenly spaced levels, so the nearest one is just a rounded projection
+			static const UInt8 LEVEL_TO_INDEX[8] = { 1, 7, 6, 5, 4, 3, 2, 0 };
+
+			const Float4 offset = splat( Float( alpha1 ) );
+			const Float4 scale = splat( 7.f / Float( alpha0 - alpha1 ) );
+
+			for( Int32 i = 0; i < BLOCK_PIXELS; i += 4 )
+			{
+				const __m128i levels = _mm_cvtps_epi32( _mm_mul_ps( _mm_sub_ps( load( &block.channels[3][i] ), offset ), scale ) );
+
+				Int32 pixelLevels[4];
+				_mm_storeu_si128( reinterpret_cast<__m128i*>( pixelLevels ), levels );
+
+				for( Int32 k = 0; k < 4; ++k )
+				{
+					bits |= UInt64( LEVEL_TO_INDEX[clamp( pixelLevels[k], 0, 7 )] ) << ( ( i + k ) * 3 );
+				}
+			}
+		}
+
+		output[0] = static_cast<UInt8>( alpha0 );
+		output[1] = static_cast<UInt8>( alpha1 );
+
+		for( Int32 i = 0; i < 6; ++i )
+		{
+			output[2 + i] = static_cast<UInt8>( bits >> ( i * 8 ) );
+		}
+	}
+
+	static inline Int32 interpolateBC7( Int32 a, Int32 b, Int32 weight )
+	{
+		return ( ( 64 - weight ) * a + weight * b + 32 ) >> 6;
+	}
+
+	static inline void writeBits( UInt8* data, Int32& offset, UInt32 value, Int32 numBits )
+	{
+		for( Int32 i = 0; i < numBits; ++i, ++offset )
+		{
+			data[offset >> 3] |= ( ( value >> i ) & 1 ) << ( offset & 7 );
+		}
+	}
+
+	static inline UInt32 readBits( const UInt8* data, Int32& offset, Int32 numBits )
+	{
+		UInt32 value = 0;
+
+		for( Int32 i = 0; i < numBits; ++i, ++offset )
+		{
+			value |= ( ( data[offset >> 3] >> ( offset & 7 ) ) & 1 ) << i;
+		}
+
+		return value;
+	}
+
+	/**
+	 *	Quantize endpoint to 7 bits per channel and a p-bit. Opaque
+	 *	blocks always set p-bit, so alpha stays exactly 255
+	 */
+	static void quantizeBC7Endpoint( const Float color[4], Bool opaque, Int32 endpoint[4], Int32& pbit )
+	{
+		Float bestError = 1e30f;
+
+		for( Int32 p = opaque ? 1 : 0; p < 2; ++p )
+		{
+			Int32 quantized[4];
+			Float error = 0.f;
+
+			for( Int32 c = 0; c < 4; ++c )
+			{
+				quantized[c] = clamp( math::round( ( color[c] - p ) * 0.5f ), 0, 127 );
+				error += sqr( Float( quantized[c] * 2 + p ) - color[c] );
+			}
+
+			if( error < bestError )
+			{
+				bestError = error;
+				mem::copy( endpoint, quantized, sizeof( quantized ) );
+				pbit = p;
+			}
+		}
+	}
+
+	static void fitBC7Mode6( const BlockPixels& block, Bool opaque, const Float start[4], const Float end[4], 
+		BC7Mode6Block& result )
+	{
+		quantizeBC7Endpoint( start, opaque, result.endpoints[0], result.pbits[0] );
+		quantizeBC7Endpoint( end, opaque, result.endpoints[1], result.pbits[1] );
+
+		BlockPalette palette;
+		palette.numColors = 16;
+
+		for( Int32 i = 0; i < palette.numColors; ++i )
+		{
+			for( Int32 c = 0; c < 4; ++c )
+			{
+				palette.colors[i][c] = Float( interpolateBC7( ( result.endpoints[0][c] << 1 ) | result.pbits[0],
+					( result.endpoints[1][c] << 1 ) | result.pbits[1], BC7_MODE6_WEIGHTS[i] ) );
+			}
+		}
+
+		result.error = selectIndices( block, ALL_PIXELS, 4, palette, result.indices );
+	}
+
+	/**
+	 *	BC7 mode 6: a single subset with RGBA endpoints and 4 bits indices
+	 */
+	static void encodeBC7Mode6( const BlockPixels& block, Bool opaque, BC7Mode6Block& result )
+	{
+		Float start[4], end[4];
+		findEndpoints( block, ALL_PIXELS, 4, start, end );
+		fitBC7Mode6( block, opaque, start, end, result );
+
+		Float weights[16];
+
+		for( Int32 i = 0; i < 16; ++i )
+		{
+			weights[i] = 1.f - BC7_MODE6_WEIGHTS[i] / 64.f;
+		}
+
+		if( refineEndpoints( block, ALL_PIXELS, 4, result.indices, weights, start, end ) )
+		{
+			BC7Mode6Block refined;
+			fitBC7Mode6( block, opaque, start, end, refined );
+
+			if( refined.error < result.error )
+			{
+				result = refined;
+			}
+		}
+
+		// the first index is stored without its top bit
+		if( result.indices[0] & 8 )
+		{
+			for( Int32 c = 0; c < 4; ++c )
+			{
+				exchange( result.endpoints[0][c], result.endpoints[1][c] );
+			}
+
+			exchange( result.pbits[0], result.pbits[1] );
+
+			for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+			{
+				result.indices[i] = 15 - result.indices[i];
+			}
+		}
+	}
+
+	static void fitBC7Mode5Colors( const BlockPixels& block, const Float start[4], const Float end[4], 
+		BC7Mode5Block& result )
+	{
+		BlockPalette palette;
+		palette.numColors = 4;
+
+		for( Int32 c = 0; c < 3; ++c )
+		{
+			result.colorEndpoints[0][c] = math::round( start[c] * ( 127.f / 255.f ) );
+			result.colorEndpoints[1][c] = math::round( end[c] * ( 127.f / 255.f ) );
+
+			const Int32 a = ( result.colorEndpoints[0][c] << 1 ) | ( result.colorEndpoints[0][c] >> 6 );
+			const Int32 b = ( result.colorEndpoints[1][c] << 1 ) | ( result.colorEndpoints[1][c] >> 6 );
+
+			for( Int32 i = 0; i < palette.numColors; ++i )
+			{
+				palette.colors[i][c] = Float( interpolateBC7( a, b, BC7_MODE5_WEIGHTS[i] ) );
+			}
+		}
+
+		result.error = selectIndices( block, ALL_PIXELS, 3, palette, result.colorIndices );
+	}
+
+	/**
+	 *	BC7 mode 5: a single subset with separate RGB and alpha indices,
+	 *	good for sprites with independent mask
+	 */
+	static void encodeBC7Mode5( const BlockPixels& block, BC7Mode5Block& result )
+	{
+		Float start[4], end[4];
+		findEndpoints( block, ALL_PIXELS, 3, start, end );
+		fitBC7Mode5Colors( block, start, end, result );
+
+		Float weights[4];
+
+		for( Int32 i = 0; i < 4; ++i )
+		{
+			weights[i] = 1.f - BC7_MODE5_WEIGHTS[i] / 64.f;
+		}
+
+		if( refineEndpoints( block, ALL_PIXELS, 3, result.colorIndices, weights, start, end ) )
+		{
+			BC7Mode5Block refined;
+			fitBC7Mode5Colors( block, start, end, refined );
+
+			if( refined.error < result.error )
+			{
+				mem::copy( result.colorEndpoints, refined.colorEndpoints, sizeof( refined.colorEndpoints ) );
+				mem::copy( result.colorIndices, refined.colorIndices, sizeof( refined.colorIndices ) );
+				result.error = refined.error;
+			}
+		}
+
+		// alpha is a separate single channel block
+		BlockPixels alphaBlock;
+		mem::copy( alphaBlock.channels[0], block.channels[3], sizeof( alphaBlock.channels[0] ) );
+
+		result.alphaEndpoints[0] = math::round( math::simd::horizontalMin( _mm_min_ps( 
+			_mm_min_ps( math::simd::load( &block.channels[3][0] ), math::simd::load( &block.channels[3][4] ) ),
+			_mm_min_ps( math::simd::load( &block.channels[3][8] ), math::simd::load( &block.channels[3][12] ) ) ) ) );
+		result.alphaEndpoints[1] = math::round( math::simd::horizontalMax( _mm_max_ps( 
+			_mm_max_ps( math::simd::load( &block.channels[3][0] ), math::simd::load( &block.channels[3][4] ) ),
+			_mm_max_ps( math::simd::load( &block.channels[3][8] ), math::simd::load( &block.channels[3][12] ) ) ) ) );
+
+		BlockPalette palette;
+		palette.numColors = 4;
+
+		for( Int32 i = 0; i < palette.numColors; ++i )
+		{
+			palette.colors[i][0] = Float( interpolateBC7( result.alphaEndpoints[0], result.alphaEndpoints[1], BC7_MODE5_WEIGHTS[i] ) );
+		}
+
+		result.error += selectIndices( alphaBlock, ALL_PIXELS, 1, palette, result.alphaIndices );
+
+		// the first indices are stored without their top bits
+		if( result.colorIndices[0] & 2 )
+		{
+			for( Int32 c = 0; c < 3; ++c )
+			{
+				exchange( result.colorEndpoints[0][c], result.colorEndpoints[1][c] );
+			}
+
+			for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+			{
+				result.colorIndices[i] = 3 - result.colorIndices[i];
+			}
+		}
+
+		if( result.alphaIndices[0] & 2 )
+		{
+			exchange( result.alphaEndpoints[0], result.alphaEndpoints[1] );
+
+			for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+			{
+				result.alphaIndices[i] = 3 - result.alphaIndices[i];
+			}
+		}
+	}
+
+	/**
+	 *	Encode block with the best of BC7 modes 5 and 6
+	 */
+	static void encodeBC7Block( const BlockPixels& block, UInt8* output )
+	{
+		Bool opaque = true;
+
+		for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+		{
+			opaque &= block.channels[3][i] == 255.f;
+		}
+
+		BC7Mode6Block mode6;
+		encodeBC7Mode6( block, opaque, mode6 );
+
+		BC7Mode5Block mode5;
+		mode5.error = 1e30f;
+
+		if( !opaque )
+		{
+			encodeBC7Mode5( block, mode5 );
+		}
+
+		mem::zero( output, 16 );
+		Int32 offset = 0;
+
+		if( mode5.error < mode6.error )
+		{
+			writeBits( output, offset, 1 << 5, 6 );
+			writeBits( output, offset, 0, 2 );	// no rotation
+
+			for( Int32 c = 0; c < 3; ++c )
+			{
+				writeBits( output, offset, mode5.colorEndpoints[0][c], 7 );
+				writeBits( output, offset, mode5.colorEndpoints[1][c], 7 );
+			}
+
+			writeBits( output, offset, mode5.alphaEndpoints[0], 8 );
+			writeBits( output, offset, mode5.alphaEndpoints[1], 8 );
+
+			for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+			{
+				writeBits( output, offset, mode5.colorIndices[i], i == 0 ? 1 : 2 );
+			}
+
+			for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+			{
+				writeBits( output, offset, mode5.alphaIndices[i], i == 0 ? 1 : 2 );
+			}
+		}
+		else
+		{
+			writeBits( output, offset, 1 << 6, 7 );
+
+			for( Int32 c = 0; c < 4; ++c )
+			{
+				writeBits( output, offset, mode6.endpoints[0][c], 7 );
+				writeBits( output, offset, mode6.endpoints[1][c], 7 );
+			}
+
+			writeBits( output, offset, mode6.pbits[0], 1 );
+			writeBits( output, offset, mode6.pbits[1], 1 );
+
+			for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+			{
+				writeBits( output, offset, mode6.indices[i], i == 0 ? 3 : 4 );
+			}
+		}
+
+		assert( offset == 128 );
+	}
+
+	static void decodeColorBlock( const UInt8* data, Bool alwaysFourColors, math::Color colors[BLOCK_PIXELS] )
+	{
+		const UInt16 color0 = data[0] | ( data[1] << 8 );
+		const UInt16 color1 = data[2] | ( data[3] << 8 );
+		const UInt32 bits = data[4] | ( data[5] << 8 ) | ( data[6] << 16 ) | ( UInt32( data[7] ) << 24 );
+
+		math::Color palette[4];
+		buildColorPalette( color0, color1, alwaysFourColors || color0 > color1, palette );
+
+		for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+		{
+			colors[i] = palette[( bits >> ( i * 2 ) ) & 3];
+		}
+	}
+
+	static void decodeAlphaBlock( const UInt8* data, math::Color colors[BLOCK_PIXELS] )
+	{
+		Int32 palette[8] = { data[0], data[1] };
+
+		if( palette[0] > palette[1] )
+		{
+			for( Int32 i = 2; i < 8; ++i )
+			{
+				palette[i] = ( ( 8 - i ) * palette[0] + ( i - 1 ) * palette[1] ) / 7;
+			}
+		}
+		else
+		{
+			for( Int32 i = 2; i < 6; ++i )
+			{
+				palette[i] = ( ( 6 - i ) * palette[0] + ( i - 1 ) * palette[1] ) / 5;
+			}
+
+			palette[6] = 0x00;
+			palette[7] = 0xff;
+		}
+
+		UInt64 bits = 0;
+
+		for( Int32 i = 0; i < 6; ++i )
+		{
+			bits |= UInt64( data[2 + i] ) << ( i * 8 );
+		}
+
+		for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+		{
+			colors[i].a = static_cast<UInt8>( palette[( bits >> ( i * 3 ) ) & 7] );
+		}
+	}
+
+	static void decodeBC7Block( const UInt8* data, math::Color colors[BLOCK_PIXELS] )
+	{
+		Int32 offset = 0;
+		Int32 endpoints[2][4];
+
+		if( ( data[0] & 0x7f ) == 0x40 )
+		{
+			// mode 6
+			offset = 7;
+
+			for( Int32 c = 0; c < 4; ++c )
+			{
+				endpoints[0][c] = readBits( data, offset, 7 ) << 1;
+				endpoints[1][c] = readBits( data, offset, 7 ) << 1;
+			}
+
+			for( Int32 e = 0; e < 2; ++e )
+			{
+				const Int32 pbit = readBits( data, offset, 1 );
+
+				for( Int32 c = 0; c < 4; ++c )
+				{
+					endpoints[e][c] |= pbit;
+				}
+			}
+
+			for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+			{
+				const Int32 weight = BC7_MODE6_WEIGHTS[readBits( data, offset, i == 0 ? 3 : 4 )];
+
+				colors[i] = math::Color( interpolateBC7( endpoints[0][0], endpoints[1][0], weight ),
+					interpolateBC7( endpoints[0][1], endpoints[1][1], weight ),
+					interpolateBC7( endpoints[0][2], endpoints[1][2], weight ),
+					interpolateBC7( endpoints[0][3], endpoints[1][3], weight ) );
+			}
+		}
+		else if( ( data[0] & 0x3f ) == 0x20 )
+		{
+			// mode 5
+			offset = 6;
+			const Int32 rotation = readBits( data, offset, 2 );
+
+			for( Int32 c = 0; c < 3; ++c )
+			{
+				for( Int32 e = 0; e < 2; ++e )
+				{
+					const Int32 value = readBits( data, offset, 7 );
+					endpoints[e][c] = ( value << 1 ) | ( value >> 6 );
+				}
+			}
+
+			endpoints[0][3] = readBits( data, offset, 8 );
+			endpoints[1][3] = readBits( data, offset, 8 );
+
+			for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+			{
+				const Int32 weight = BC7_MODE5_WEIGHTS[readBits( data, offset, i == 0 ? 1 : 2 )];
+
+				colors[i].r = interpolateBC7( endpoints[0][0], endpoints[1][0], weight );
+				colors[i].g = interpolateBC7( endpoints[0][1], endpoints[1][1], weight );
+				colors[i].b = interpolateBC7( endpoints[0][2], endpoints[1][2], weight );
+			}
+
+			for( Int32 i = 0; i < BLOCK_PIXELS; ++i )
+			{
+				const Int32 weight = BC7_MODE5_WEIGHTS[readBits( data, offset, i == 0 ? 1 : 2 )];
+				colors[i].a = interpolateBC7( endpoints[0][3], endpoints[1][3], weight );
+
+				if( rotation == 1 )
+				{
+					exchange( colors[i].a, colors[i].r );
+				}
+				else if( rotation == 2 )
+				{
+					exchange( colors[i].a, colors[i].g );
+				}
+				else if( rotation == 3 )
+				{
+					exchange( colors[i].a, colors[i].b );
+				}
+			}
+		}
+		else
+		{
+			// encoder produces modes 5 and 6 only
+			mem::zero( colors, BLOCK_PIXELS * sizeof( math::Color ) );
+		}
+	}
+
+	struct BlocksContext
+	{
+	public:
+		const math::Color* image;
+		Int32 width;
+		Int32 height;
+		rend::EFormat format;
+		UInt8* output;
+	};
+
+	static void encodeBlockRows( const BlocksContext& context, Int32 firstRow, Int32 lastRow )
+	{
+		const Int32 blocksX = ( context.width + BLOCK_SIZE - 1 ) / BLOCK_SIZE;
+		const UInt32 blockBytes = rend::getFormatInfo( context.format ).blockBytes;
+
+		BlockPixels block;
+
+		for( Int32 y = firstRow; y < lastRow; ++y )
+		{
+			for( Int32 x = 0; x < blocksX; ++x )
+			{
+				UInt8* output = &context.output[( y * blocksX + x ) * blockBytes];
+				fetchBlock( context.image, context.width, context.height, x, y, block );
+
+				switch( context.format )
+				{
+					case rend::EFormat::BC1_UNORM:
+						encodeColorBlock( block, true, output );
+						break;
+
+					case rend::EFormat::BC3_UNORM:
+						encodeAlphaBlock( block, output );
+						encodeColorBlock( block, false, output + 8 );
+						break;
+
+					case rend::EFormat::BC7_UNORM:
+						encodeBC7Block( block, output );
+						break;
+
+					default:
+						fatal( TXT( "Unsupported block compressed format %s" ), rend::getFormatInfo( context.format ).name );
+						break;
+				}
+			}
+		}
+	}
+
+	Bool isBlockCompressed( rend::EFormat format )
+	{
+		return format == rend::EFormat::BC1_UNORM ||
+			format == rend::EFormat::BC3_UNORM ||
+			format == rend::EFormat::BC7_UNORM;
+	}
+
+	void encodeBlocks( const math::Color* image, Int32 width, Int32 height,
+		rend::EFormat format, UInt8* output )
+	{
+		assert( image && output );
+		assert( width > 0 && height > 0 );
+		assert( isBlockCompressed( format ) );
+
+		const Int32 blocksY = ( height + BLOCK_SIZE - 1 ) / BLOCK_SIZE;
+		BlocksContext context = { image, width, height, format, output };
+
+		job::parallelFor( blocksY, BLOCK_ROWS_PER_TASK, MAX_TASKS, []( void* userData, Int32 taskIndex, Int32 first, Int32 last )
+		{
+			encodeBlockRows( *reinterpret_cast<const BlocksContext*>( userData ), first, last );
+		}, &context );
+	}
+
+	void decodeBlocks( const UInt8* data, Int32 width, Int32 height,
+		rend::EFormat format, math::Color* output )
+	{
+		assert( data && output );
+		assert( width > 0 && height > 0 );
+		assert( isBlockCompressed( format ) );
+
+		const Int32 blocksX = ( width + BLOCK_SIZE - 1 ) / BLOCK_SIZE;
+		const Int32 blocksY = ( height + BLOCK_SIZE - 1 ) / BLOCK_SIZE;
+		const UInt32 blockBytes = rend::getFormatInfo( format ).blockBytes;
+
+		math::Color colors[BLOCK_PIXELS];
+
+		for( Int32 y = 0; y < blocksY; ++y )
+		{
+			for( Int32 x = 0; x < blocksX; ++x )
+			{
+				const UInt8* block = &data[( y * blocksX + x ) * blockBytes];
+
+				if( format == rend::EFormat::BC1_UNORM )
+				{
+					decodeColorBlock( block, false, colors );
+				}
+				else if( format == rend::EFormat::BC3_UNORM )
+				{
+					decodeColorBlock( block + 8, true, colors );
+					decodeAlphaBlock( block, colors );
+				}
+				else
+				{
+					decodeBC7Block( block, colors );
+				}
+
+				const Int32 numRows = min( BLOCK_SIZE, height - y * BLOCK_SIZE );
+				const Int32 numColumns = min( BLOCK_SIZE, width - x * BLOCK_SIZE );
+
+				for( Int32 j = 0; j < numRows; ++j )
+				{
+					mem::copy( &output[( y * BLOCK_SIZE + j ) * width + x * BLOCK_SIZE],
+						&colors[j * BLOCK_SIZE], numColumns * sizeof( math::Color ) );
+				}
+			}
+		}
+	}
+}
+}
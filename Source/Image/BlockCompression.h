@@ -0,0 +1,30 @@
+//-----------------------------------------------------------------------------
+//	BlockCompression.h: BC1/BC3/BC7 texture blocks encoder and decoder
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+namespace img
+{
+	/**
+	 *	Return true if format is one of block compressed formats
+	 *	supported by encoder and decoder
+	 */
+	extern Bool isBlockCompressed( rend::EFormat format );
+
+	/**
+	 *	Encode a single RGBA level into 4x4 blocks. Output should have
+	 *	rend::getLevelSize( format, width, height ) bytes. BC1 keeps
+	 *	pixels with alpha below 128 transparent, BC7 uses modes 5 and 6 only
+	 */
+	extern void encodeBlocks( const math::Color* image, Int32 width, Int32 height,
+		rend::EFormat format, UInt8* output );
+
+	/**
+	 *	Decode a single level, encoded with encodeBlocks, back to RGBA
+	 */
+	extern void decodeBlocks( const UInt8* data, Int32 width, Int32 height,
+		rend::EFormat format, math::Color* output );
+}
+}
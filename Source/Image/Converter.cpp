@@ -10,9 +10,129 @@ namespace flu
 namespace img
 {
 	static const math::Color MASK_COLOR = { 0xff, 0x00, 0xff, 0xff };
+	static const SizeT READ_PADDING = 16;
+	static const Int32 MAX_GLYPH_TASKS = 8;
+
+	/**
+	 *	Per image compilation settings, stored in optional json file next
+	 *	to the image, i.e. "Tiles.png" -> "Tiles.image":
+	 *		{ "MipFilter": "Kaiser", "Wrap": true, "Format": "BC1_UNORM" }
+	 *	Image may be packed into atlas with { "Atlas": "Sprites.UI" }, where
+	 *	"Sprites\UI.atlas" lists the image file, wrapped images can't be packed.
+	 *	Font glyphs sheet may be turned into distance field atlas with
+	 *	{ "DistanceField": { "Font": "Fonts\\Arial.ffnt", "Spread": 4, "Downscale": 4 } }
+	 */
+	struct ImageSettings
+	{
+	public:
+		EMipFilter mipFilter = EMipFilter::MAX;	// auto
+		Bool wrap = false;
+		rend::EFormat format = rend::EFormat::RGBA8_UNORM;
+		UInt32 maxMips = MAX_UINT32;
+		String atlas;
+		String distanceField;
+		Int32 spread = 4;
+		Int32 downscale = 4;
+	};
+
+	/**
+	 *	Convert BGR(A) rows to RGBA, four pixels at once. Source rows
+	 *	go bottom-up if flip is set, 24 bits rows should have 4 bytes
+	 *	readable after the last pixel
+	 */
+	static void convertRows( const UInt8* source, SizeT sourcePitch, Int32 bytesPerPixel, Bool flip,
+		Bool forceOpaque, Bool colorKey, math::Color* image, Int32 width, Int32 height )
+	{
+		assert( bytesPerPixel == 3 || bytesPerPixel == 4 );
 
-	static Bool compileBmp( String relativePath, res::IDependencyProvider& dependencyProvider, 
-		res::CompilationOutput& output )
+		const __m128i lowMask = _mm_set1_epi32( 0x000000ff );
+		const __m128i greenAlphaMask = _mm_set1_epi32( 0xff00ff00 );
+		const __m128i alphaMask = _mm_set1_epi32( 0xff000000 );
+		const __m128i keyColor = _mm_set1_epi32( MASK_COLOR.d );
+
+		for( Int32 y = 0; y < height; ++y )
+		{
+			const UInt8* sourceRow = &source[y * sourcePitch];
+			math::Color* destRow = &image[( flip ? height - 1 - y : y ) * width];
+
+			Int32 x = 0;
+
+			for( ; x + 4 <= width; x += 4 )
+			{
+				__m128i pixels;
+
+				if( bytesPerPixel == 4 )
+				{
+					pixels = _mm_loadu_si128( reinterpret_cast<const __m128i*>( &sourceRow[x * 4] ) );
+				}
+				else
+				{
+					// spread 12 bytes into four dwords, the top bytes are garbage
+					const __m128i packed = _mm_loadu_si128( reinterpret_cast<const __m128i*>( &sourceRow[x * 3] ) );
+
+					pixels = _mm_unpacklo_epi64( 
+						_mm_unpacklo_epi32( packed, _mm_srli_si128( packed, 3 ) ),
+						_mm_unpacklo_epi32( _mm_srli_si128( packed, 6 ), _mm_srli_si128( packed, 9 ) ) );
+				}
+
+				// swap red and blue
+				pixels = _mm_or_si128( _mm_and_si128( pixels, greenAlphaMask ), 
+					_mm_or_si128( _mm_and_si128( _mm_srli_epi32( pixels, 16 ), lowMask ), 
+						_mm_slli_epi32( _mm_and_si128( pixels, lowMask ), 16 ) ) );
+
+				if( forceOpaque )
+				{
+					pixels = _mm_or_si128( pixels, alphaMask );
+				}
+
+				if( colorKey )
+				{
+					pixels = _mm_andnot_si128( _mm_and_si128( _mm_cmpeq_epi32( pixels, keyColor ), alphaMask ), pixels );
+				}
+
+				_mm_storeu_si128( reinterpret_cast<__m128i*>( &destRow[x] ), pixels );
+			}
+
+			for( ; x < width; ++x )
+			{
+				const UInt8* pixel = &sourceRow[x * bytesPerPixel];
+				math::Color color( pixel[2], pixel[1], pixel[0], forceOpaque ? 0xff : pixel[3] );
+
+				if( colorKey && color == MASK_COLOR )
+				{
+					color.a = 0x00;
+				}
+
+				destRow[x] = color;
+			}
+		}
+	}
+
+	/**
+	 *	Read the whole file at once, with a few zero bytes after the end
+	 *	for the vectorized reads
+	 */
+	static Bool readWholeFile( String relativePath, res::IDependencyProvider& dependencyProvider, 
+		res::CompilationOutput& output, Array<UInt8>& fileData, SizeT& fileSize )
+	{
+		auto loader = dependencyProvider.getBinaryFile( relativePath );
+		assert( loader.hasObject() );
+
+		fileSize = loader->totalSize();
+		fileData.setSize( fileSize + READ_PADDING );
+		mem::zero( &fileData[fileSize], READ_PADDING );
+
+		if( loader->readData( &fileData[0], fileSize ) != fileSize )
+		{
+			output.errorMsg = String::format( TXT( "Unable to read \"%s\"" ), *relativePath );
+			return false;
+		}
+
+		return true;
+	}
+
+	static Bool loadBmp( String relativePath, res::IDependencyProvider& dependencyProvider, 
+		res::CompilationOutput& output, Array<math::Color>& image, UInt32& width, UInt32& height )
 	{
 #pragma pack( push, 1 )
 		struct BitmapFileHeader
@@ -49,13 +169,22 @@ namespace img
 
 #pragma pack( pop )
 
-		auto loader = dependencyProvider.getBinaryFile( relativePath );
-		assert( loader.hasObject() );
+		Array<UInt8> fileData;
+		SizeT fileSize = 0;
+
+		if( !readWholeFile( relativePath, dependencyProvider, output, fileData, fileSize ) )
+		{
+			return false;
+		}
+
+		if( fileSize < sizeof( BitmapFileHeader ) + sizeof( BitmapInfoHeader ) )
+		{
+			output.errorMsg = String::format( TXT( "\"%s\" is not a bmp file" ), *relativePath );
+			return false;
+		}
 
-		BitmapFileHeader bmpHeader;
-		BitmapInfoHeader bmpInfo;
-		loader->readData( &bmpHeader, sizeof( BitmapFileHeader ) );
-		loader->readData( &bmpInfo, sizeof( BitmapInfoHeader ) );
+		const BitmapFileHeader& bmpHeader = *reinterpret_cast<const BitmapFileHeader*>( &fileData[0] );
+		const BitmapInfoHeader& bmpInfo = *reinterpret_cast<const BitmapInfoHeader*>( &fileData[sizeof( BitmapFileHeader )] );
 
 		if( bmpHeader.bfType != 0x4d42 )
 		{
@@ -63,78 +192,62 @@ namespace img
 			return false;
 		}
 
-		if( !isPowerOfTwo( bmpInfo.biWidth ) || !isPowerOfTwo( bmpInfo.biHeight ) )
+		// negative height means top-down rows
+		const Bool bottomUp = bmpInfo.biHeight > 0;
+		width = bmpInfo.biWidth;
+		height = abs( bmpInfo.biHeight );
+
+		if( !isPowerOfTwo( width ) || !isPowerOfTwo( height ) )
 		{
 			output.errorMsg = String::format( TXT( "\"%s\" size is not power of two" ), *relativePath );
 			return false;
 		}
 
-		// read palette is present
-		BitmapPaletteEntry bmpPalette[256];
-		if( bmpInfo.biClrUsed )
+		// rows are aligned to 4 bytes
+		const SizeT pitch = ( ( width * bmpInfo.biBitCount + 31 ) / 32 ) * 4;
+
+		if( bmpHeader.bfOffBits + pitch * height > fileSize )
 		{
-			bmpInfo.biClrUsed = min<UInt32>( bmpInfo.biClrUsed, 256 );
-			loader->readData( bmpPalette, sizeof( BitmapPaletteEntry ) * bmpInfo.biClrUsed );
+			output.errorMsg = String::format( TXT( "\"%s\" is truncated" ), *relativePath );
+			return false;
 		}
 
-		Array<math::Color> tempData( bmpInfo.biWidth * bmpInfo.biHeight );
-		UInt32 uMask = bmpInfo.biWidth - 1;
-		UInt32 uBits = intLog2( bmpInfo.biWidth );
-		UInt32 vMask = ( bmpInfo.biHeight - 1 ) << uBits;
-
-		loader->seek( bmpHeader.bfOffBits );
+		image.setSize( width * height );
+		const UInt8* pixels = &fileData[bmpHeader.bfOffBits];
 
-		if( bmpInfo.biBitCount == 24 )
+		if( bmpInfo.biBitCount == 24 || bmpInfo.biBitCount == 32 )
 		{
-			// 24 bits
-			for( Int32 i = 0; i < bmpInfo.biWidth * bmpInfo.biHeight; i++ )
-			{
-				UInt8 pixData[3];
-				loader->readData( pixData, 3 * sizeof( UInt8 ) );
-				
-				math::Color color( pixData[2], pixData[1], pixData[0], 0xff );
-				if( color == MASK_COLOR )
-				{
-					color.a = 0x00;
-				}
-
-				tempData[( vMask & ~i ) | ( i & uMask )] = color;
-			}
+			convertRows( pixels, pitch, bmpInfo.biBitCount / 8, bottomUp, true, true, &image[0], width, height );
 		}
-		else if( bmpInfo.biBitCount == 32 )
+		else if( bmpInfo.biBitCount == 8 )
 		{
-			// 32 bits
-			for( Int32 i = 0; i < bmpInfo.biWidth * bmpInfo.biHeight; i++ )
+			// 8 bits, palette is right after the headers
+			const UInt32 numColors = bmpInfo.biClrUsed ? min<UInt32>( bmpInfo.biClrUsed, 256 ) : 256;
+			const BitmapPaletteEntry* bmpPalette = reinterpret_cast<const BitmapPaletteEntry*>( 
+				&fileData[sizeof( BitmapFileHeader ) + bmpInfo.biSize] );
+
+			math::Color palette[256];
+
+			for( UInt32 i = 0; i < 256; ++i )
 			{
-				UInt8 pixData[4];
-				loader->readData( pixData, 4 * sizeof( UInt8 ) );
+				palette[i] = i < numColors ? math::Color( bmpPalette[i].rgbRed, bmpPalette[i].rgbGreen, bmpPalette[i].rgbBlue, 0xff ) : 
+					math::colors::BLACK;
 
-				math::Color color( pixData[2], pixData[1], pixData[0], 0xff );
-				if( color == MASK_COLOR )
+				if( palette[i] == MASK_COLOR )
 				{
-					color.a = 0x00;
+					palette[i].a = 0x00;
 				}
-
-				tempData[( vMask & ~i ) | ( i & uMask )] = color;
 			}
-		}
-		else if( bmpInfo.biBitCount == 8 )
-		{
-			// 8 bits
-			assert( bmpInfo.biClrUsed > 0 );
 
-			for( Int32 i = 0; i < bmpInfo.biWidth * bmpInfo.biHeight; i++ )
+			for( UInt32 y = 0; y < height; ++y )
 			{
-				UInt8 colorId;
-				loader->readData( &colorId, sizeof( UInt8 ) );
+				const UInt8* sourceRow = &pixels[y * pitch];
+				math::Color* destRow = &image[( bottomUp ? height - 1 - y : y ) * width];
 
-				math::Color color( bmpPalette[colorId].rgbRed, bmpPalette[colorId].rgbGreen, bmpPalette[colorId].rgbBlue, 0xff );
-				if( color == MASK_COLOR )
+				for( UInt32 x = 0; x < width; ++x )
 				{
-					color.a = 0x00;
+					destRow[x] = palette[sourceRow[x]];
 				}
-
-				tempData[( vMask & ~i ) | ( i & uMask )] = color;
 			}
 		}
 		else
@@ -143,117 +256,11 @@ namespace img
 			return false;
 		}
 
-		// make a palette image if possible
-		Array<math::Color> palette;
-		for( Int32 i = 0; i < bmpInfo.biWidth * bmpInfo.biHeight; ++i )
-		{
-			if( palette.addUnique( tempData[i] ) > 255 )
-			{
-				break;
-			}
-		}
-
-		if( palette.size() <= 256 )
-		{
-			// save as palette
-			palette.sort( []( const math::Color& a, const math::Color& b )->Bool
-			{
-				return a.d < b.d;
-			} );
-
-			Array<UInt8> palettedImage( tempData.size() );
-			for( Int32 i = 0; i < tempData.size(); ++i )
-			{
-				palettedImage[i] = palette.find( tempData[i] );
-			}
-
-			LodePNGState state;
-			lodepng_state_init( &state );
-
-			state.info_png.color.colortype = LCT_PALETTE;
-			state.info_png.color.bitdepth = 8;
-			state.info_raw.colortype = LCT_PALETTE;
-			state.info_raw.bitdepth = 8;
-			state.encoder.auto_convert = false;
-
-			palette.setSize( 256 );
-			for( Int32 i = 0; i < 256; ++i )
-			{
-				UInt8 r = palette[i].r;
-				UInt8 g = palette[i].g;
-				UInt8 b = palette[i].b;
-				UInt8 a = palette[i].a;
-
-				lodepng_palette_add( &state.info_png.color, r, g, b, a );
-				lodepng_palette_add( &state.info_raw, r, g, b, a );
-			}
-
-			UInt8* encodedData;
-			SizeT encodedSize;
-			auto pngError = lodepng_encode( &encodedData, &encodedSize, reinterpret_cast<unsigned char*>( &palettedImage[0] ), 
-				bmpInfo.biWidth, bmpInfo.biHeight, &state );
-
-			if( pngError )
-			{
-				output.errorMsg = String::format( TXT( "Unable to encode to png with error \"%s\"" ), 
-					lodepng_error_text( pngError ) );
-
-				lodepng_state_cleanup( &state );
-				return false;
-			}
-
-			assert( encodedData && encodedSize > 0 );
-
-			output.compiledResource.data.setSize( encodedSize );
-			mem::copy( &output.compiledResource.data[0], encodedData, encodedSize );
-
-			mem::free( encodedData );
-
-			lodepng_state_cleanup( &state );
-
-			return true;
-		}
-		else
-		{
-			// save as rgba
-			LodePNGState state;
-			lodepng_state_init( &state );
-
-			state.info_png.color.colortype = LCT_RGBA;
-			state.info_png.color.bitdepth = 8;
-			state.info_raw.colortype = LCT_RGBA;
-			state.info_raw.bitdepth = 8;
-			state.encoder.auto_convert = false;
-
-			UInt8* encodedData;
-			SizeT encodedSize;
-			auto pngError = lodepng_encode( &encodedData, &encodedSize, reinterpret_cast<unsigned char*>( &tempData[0] ), 
-				bmpInfo.biWidth, bmpInfo.biHeight, &state );
-
-			if( pngError )
-			{
-				output.errorMsg = String::format( TXT( "Unable to encode to png with error \"%s\"" ), 
-					lodepng_error_text( pngError ) );
-
-				lodepng_state_cleanup( &state );
-				return false;
-			}
-
-			assert( encodedData && encodedSize > 0 );
-
-			output.compiledResource.data.setSize( encodedSize );
-			mem::copy( &output.compiledResource.data[0], encodedData, encodedSize );
-
-			mem::free( encodedData );
-
-			lodepng_state_cleanup( &state );
-
-			return true;
-		}
+		return true;
 	}
 
-	static Bool compileTga( String relativePath, res::IDependencyProvider& dependencyProvider, 
-		res::CompilationOutput& output )
+	static Bool loadTga( String relativePath, res::IDependencyProvider& dependencyProvider, 
+		res::CompilationOutput& output, Array<math::Color>& image, UInt32& width, UInt32& height )
 	{
 #pragma pack(push,1)
 		struct TGAHeader
@@ -271,11 +278,21 @@ namespace img
 		};
 #pragma pack(pop)
 
-		auto loader = dependencyProvider.getBinaryFile( relativePath );
-		assert( loader.hasObject() );
-	
-		TGAHeader tgaHeader;
-		loader->readData( &tgaHeader, sizeof( TGAHeader ) );
+		Array<UInt8> fileData;
+		SizeT fileSize = 0;
+
+		if( !readWholeFile( relativePath, dependencyProvider, output, fileData, fileSize ) )
+		{
+			return false;
+		}
+
+		if( fileSize < sizeof( TGAHeader ) )
+		{
+			output.errorMsg = String::format( TXT( "\"%s\" is not a tga file" ), *relativePath );
+			return false;
+		}
+
+		const TGAHeader& tgaHeader = *reinterpret_cast<const TGAHeader*>( &fileData[0] );
 
 		if( tgaHeader.imageType != 2 && tgaHeader.imageType != 10 )
 		{
@@ -289,8 +306,8 @@ namespace img
 			return false;
 		}
 
-		const UInt32 width = tgaHeader.width[0] + tgaHeader.width[1] * 256;
-		const UInt32 height = tgaHeader.height[0] + tgaHeader.height[1] * 256;
+		width = tgaHeader.width[0] + tgaHeader.width[1] * 256;
+		height = tgaHeader.height[0] + tgaHeader.height[1] * 256;
 		const UInt32 colorDepth = tgaHeader.bpp;
 
 		if( !isPowerOfTwo( width ) || !isPowerOfTwo( height ) )
@@ -299,168 +316,280 @@ namespace img
 			return false;
 		}
 
-		if( colorDepth < 24 )
+		if( colorDepth != 24 && colorDepth != 32 )
 		{
 			output.errorMsg = String::format( TXT( "\"%s\" only 24 and 32 bits TGA supported" ), *relativePath );
 			return false;
 		}
 
-		const UInt32 uMask = width - 1;
-		const UInt32 uBits = intLog2( width );
-		const UInt32 vMask = ( height - 1 ) << uBits;
+		const UInt32 stride = colorDepth / 8;
+		const SizeT imageSize = width * height * stride;
+		const SizeT dataOffset = sizeof( TGAHeader ) + tgaHeader.fileType;
 
-		Array<math::Color> image( width * height );
+		const UInt8* pixels = nullptr;
+		Array<UInt8> unpackedPixels;
 
 		if( tgaHeader.imageType == 2 )
 		{
 			// not compressed tga
-			SizeT imageSize = width * height * ( colorDepth / 8 );
-			Array<UInt8> tempImage( imageSize );
-
-			loader->readData( &tempImage[0], imageSize );
-
-			if( colorDepth == 24 )
+			if( dataOffset + imageSize > fileSize )
 			{
-				// 24 bits, not compressed
-				for( UInt32 i = 0; i < width * height; ++i )
-				{
-					math::Color pixel = { tempImage[i * 3 + 2], tempImage[i * 3 + 1], tempImage[i * 3 + 0], 0xff };
-					
-					if( pixel == MASK_COLOR )
-					{
-						pixel.a = 0x00;
-					}
-
-					image[( vMask & ~i ) | ( i & uMask )] = pixel;
-				}
+				output.errorMsg = String::format( TXT( "\"%s\" is truncated" ), *relativePath );
+				return false;
 			}
-			else
-			{
-				// 32 bits, not compressed
-				for( UInt32 i = 0; i < width * height; ++i )
-				{
-					math::Color pixel = { tempImage[i * 4 + 2], tempImage[i * 4 + 1], tempImage[i * 4 + 0], tempImage[i * 4 + 3] };
-					image[( vMask & ~i ) | ( i & uMask )] = pixel;
-				}
-			}		
+
+			pixels = &fileData[dataOffset];
 		}
-		else if( tgaHeader.imageType == 10 )
+		else
 		{
-			// 24 or 32 bits, rle compressed
-			const UInt32 stride = colorDepth / 8;
-
-			UInt32 imageWalker = 0;
-			UInt32 bufferWalker = 0;
-			UInt32 pixelsPassed = 0;
-
-			const SizeT bytesRemain = loader->totalSize() - sizeof( TGAHeader );
-			Array<UInt8> buffer( bytesRemain + 2 );
+			// rle compressed tga, unpack packets as is and convert all the rows later
+			unpackedPixels.setSize( imageSize + READ_PADDING );
 
-			const SizeT bytesRead = loader->readData( &buffer[0], bytesRemain );
-			assert( bytesRead == bytesRemain );
+			const UInt8* packet = &fileData[dataOffset];
+			const UInt8* packetsEnd = &fileData[0] + fileSize;
+			UInt8* unpacked = &unpackedPixels[0];
+			UInt8* unpackedEnd = unpacked + imageSize;
 
-			while( pixelsPassed < width * height )
+			while( unpacked < unpackedEnd && packet < packetsEnd )
 			{
-				UInt8 front = buffer[bufferWalker++];
+				const UInt8 front = *packet++;
+				const SizeT count = min<SizeT>( ( front & 0x7f ) + 1, ( unpackedEnd - unpacked ) / stride );
 
 				if( front < 128 )
 				{
-					for( Int32 i = 0; i <= front; ++i )
+					// raw packet
+					if( packet + count * stride > packetsEnd )
 					{
-						image[( vMask & ~imageWalker ) | ( imageWalker & uMask )].r = buffer[ bufferWalker + i * stride + 2 ];
-						image[( vMask & ~imageWalker ) | ( imageWalker & uMask )].g = buffer[ bufferWalker + i * stride + 1 ];
-						image[( vMask & ~imageWalker ) | ( imageWalker & uMask )].b = buffer[ bufferWalker + i * stride + 0 ];
-						image[( vMask & ~imageWalker ) | ( imageWalker & uMask )].a = buffer[ bufferWalker + i * stride + 3 ];
-
-						++imageWalker;
-						++pixelsPassed;
+						break;
 					}
 
-					bufferWalker += stride * ( static_cast<UInt32>( front ) + 1 );
+					mem::copy( unpacked, packet, count * stride );
+					packet += count * stride;
 				}
 				else
 				{
-					for( Int32 i = 0; i <= front - 128; ++i )
+					// run-length packet
+					if( packet + stride > packetsEnd )
 					{
-						image[( vMask & ~imageWalker ) | ( imageWalker & uMask )].r = buffer[ bufferWalker + 2 ];
-						image[( vMask & ~imageWalker ) | ( imageWalker & uMask )].g = buffer[ bufferWalker + 1 ];
-						image[( vMask & ~imageWalker ) | ( imageWalker & uMask )].b = buffer[ bufferWalker + 0 ];
-						image[( vMask & ~imageWalker ) | ( imageWalker & uMask )].a = buffer[ bufferWalker + 3 ];
+						break;
+					}
 
-						++imageWalker;
-						++pixelsPassed;
+					for( SizeT i = 0; i < count; ++i )
+					{
+						mem::copy( &unpacked[i * stride], packet, stride );
 					}
 
-					bufferWalker += stride;
+					packet += stride;
 				}
+
+				unpacked += count * stride;
 			}
 
-			// fix alpha channel for 24 bits
-			if( colorDepth == 24 )
+			if( unpacked != unpackedEnd )
 			{
-				for( auto& it : image )
-				{
-					it.a = 0xff;
-
-					if( it == MASK_COLOR )
-					{
-						it.a = 0x00;
-					}
-				}
+				output.errorMsg = String::format( TXT( "\"%s\" is truncated" ), *relativePath );
+				return false;
 			}
+
+			pixels = &unpackedPixels[0];
 		}
-		else
-		{
-			output.errorMsg = String::format( TXT( "\"%s\" unknown TGA image type %d" ), *relativePath, tgaHeader.imageType );
-			return false;
-		}
 
-		// save as rgba
-		LodePNGState state;
-		lodepng_state_init( &state );
+		// 24 bits images are color keyed, 32 bits have own alpha
+		image.setSize( width * height );
+		convertRows( pixels, width * stride, stride, true, colorDepth == 24, colorDepth == 24, &image[0], width, height );
+
+		return true;
+	}
 
-		state.info_png.color.colortype = LCT_RGBA;
-		state.info_png.color.bitdepth = 8;
-		state.info_raw.colortype = LCT_RGBA;
-		state.info_raw.bitdepth = 8;
-		state.encoder.auto_convert = false;
+	static Bool loadPng( String relativePath, res::IDependencyProvider& dependencyProvider, 
+		res::CompilationOutput& output, Array<math::Color>& image, UInt32& width, UInt32& height )
+	{
+		auto loader = dependencyProvider.getBinaryFile( relativePath );
+		assert( loader.hasObject() );
+
+		Array<UInt8> pngData( loader->totalSize() );
+		loader->readData( &pngData[0], pngData.size() );
 
-		UInt8* encodedData;
-		SizeT encodedSize;
-		auto pngError = lodepng_encode( &encodedData, &encodedSize, reinterpret_cast<unsigned char*>( &image[0] ), 
-			width, height, &state );
+		UInt8* imageData = nullptr;
+		auto pngError = lodepng_decode32( &imageData, &width, &height, &pngData[0], pngData.size() );
 
 		if( pngError )
 		{
-			output.errorMsg = String::format( TXT("Unable to encode to png with error: \"%hs\""), 
+			output.errorMsg = String::format( TXT( "Unable to decode png with error \"%hs\"" ), 
 				lodepng_error_text( pngError ) );
 
-			lodepng_state_cleanup( &state );
 			return false;
 		}
 
-		assert( encodedData && encodedSize > 0 );
+		image.setSize( width * height );
+		mem::copy( &image[0], imageData, width * height * sizeof( math::Color ) );
+		mem::free( imageData );
+
+		if( !isPowerOfTwo( width ) || !isPowerOfTwo( height ) )
+		{
+			output.errorMsg = String::format( TXT( "\"%s\" size is not power of two" ), *relativePath );
+			return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 *	Replace file extension, keeping the file folder
+	 */
+	static String replaceFileExt( String relativePath, const Char* newExt )
+	{
+		const String ext = fm::getFileExt( *relativePath );
+		return String::copy( relativePath, 0, relativePath.len() - ext.len() ) + newExt;
+	}
+
+	/**
+	 *	Read settings shared by images and atlases
+	 */
+	static Bool parseSettings( JSon::Ptr rootNode, res::CompilationOutput& output, ImageSettings& settings )
+	{
+		const String mipFilterName = rootNode->dotgetString( TXT( "MipFilter" ), TXT( "" ) );
+
+		if( mipFilterName )
+		{
+			settings.mipFilter = getMipFilterByName( mipFilterName );
+
+			if( settings.mipFilter == EMipFilter::MAX )
+			{
+				output.errorMsg = String::format( TXT( "Unknown mip filter \"%s\"" ), *mipFilterName );
+				return false;
+			}
+		}
+
+		settings.wrap = rootNode->dotgetBool( TXT( "Wrap" ), settings.wrap );
 
-		output.compiledResource.data.setSize( encodedSize );
-		mem::copy( &output.compiledResource.data[0], encodedData, encodedSize );
+		const String formatName = rootNode->dotgetString( TXT( "Format" ), TXT( "" ) );
 
-		mem::free( encodedData );
+		if( formatName )
+		{
+			settings.format = rend::getFormatByName( formatName );
 
-		lodepng_state_cleanup( &state );
+			if( settings.format != rend::EFormat::RGBA8_UNORM && !isBlockCompressed( settings.format ) )
+			{
+				output.errorMsg = String::format( TXT( "Unsupported image format \"%s\"" ), *formatName );
+				return false;
+			}
+		}
 
 		return true;
 	}
 
-	static Bool compilePng( String relativePath, res::IDependencyProvider& dependencyProvider, 
-		res::CompilationOutput& output )
+	/**
+	 *	Read optional settings from the sidecar file
+	 */
+	static Bool loadSettings( String relativePath, res::IDependencyProvider& dependencyProvider, 
+		res::CompilationOutput& output, ImageSettings& settings )
 	{
-		auto loader = dependencyProvider.getBinaryFile( relativePath );
-		assert( loader.hasObject() );
+		const String settingsPath = replaceFileExt( relativePath, TXT( "image" ) );
+		Text::Ptr settingsText = dependencyProvider.getTextFile( settingsPath );
+
+		if( !settingsText )
+		{
+			// use defaults
+			return true;
+		}
+
+		JSon::Ptr rootNode = JSon::loadFromText( settingsText, &output.errorMsg );
+		if( !rootNode )
+		{
+			return false;
+		}
+
+		settings.atlas = rootNode->dotgetString( TXT( "Atlas" ), TXT( "" ) );
+		settings.distanceField = rootNode->dotgetString( TXT( "DistanceField.Font" ), TXT( "" ) );
+		settings.spread = rootNode->dotgetInt( TXT( "DistanceField.Spread" ), settings.spread );
+		settings.downscale = rootNode->dotgetInt( TXT( "DistanceField.Downscale" ), settings.downscale );
+
+		return parseSettings( rootNode, output, settings );
+	}
+
+	/**
+	 *	Masked sprites have only fully opaque and fully transparent pixels
+	 */
+	static Bool isMaskedImage( const Array<math::Color>& image )
+	{
+		Bool hasTransparent = false;
+
+		for( const auto& it : image )
+		{
+			if( it.a != 0x00 && it.a != 0xff )
+			{
+				return false;
+			}
+
+			hasTransparent |= it.a == 0x00;
+		}
+
+		return hasTransparent;
+	}
+
+	static Bool saveImage( const Array<math::Color>& image, UInt32 width, UInt32 height, 
+		const ImageSettings& settings, const Array<AtlasRect>& regions, res::CompilationOutput& output )
+	{
+		assert( image.size() == Int32( width * height ) );
+
+		EMipFilter mipFilter = settings.mipFilter;
+
+		if( mipFilter == EMipFilter::MAX )
+		{
+			mipFilter = isMaskedImage( image ) ? EMipFilter::AlphaCoverage : EMipFilter::Box;
+		}
+
+		Array<math::Color> levels;
+
+		CompiledImageHeader header;
+		header.format = settings.format;
+		header.width = width;
+		header.height = height;
+		header.mips = generateMips( &image[0], width, height, mipFilter, settings.wrap, levels );
+		header.mips = min( header.mips, settings.maxMips );
+		header.numRegions = regions.size();
+		header.atlasRegion = 0;
+
+		SizeT dataSize = 0;
+
+		for( UInt32 i = 0; i < header.mips; ++i )
+		{
+			dataSize += rend::getLevelSize( header.format, max( width >> i, 1u ), max( height >> i, 1u ) );
+		}
+
+		const SizeT regionsSize = regions.size() * sizeof( AtlasRect );
 
-		// no conversation needs
 		Array<UInt8>& data = output.compiledResource.data;
-		data.setSize( loader->totalSize() );
-		loader->readData( &data[0], data.size() );
+		data.setSize( sizeof( CompiledImageHeader ) + dataSize + regionsSize );
+
+		if( isBlockCompressed( header.format ) )
+		{
+			const math::Color* level = &levels[0];
+			UInt8* compressedLevel = &data[sizeof( CompiledImageHeader )];
+
+			for( UInt32 i = 0; i < header.mips; ++i )
+			{
+				const UInt32 levelWidth = max( width >> i, 1u );
+				const UInt32 levelHeight = max( height >> i, 1u );
+
+				encodeBlocks( level, levelWidth, levelHeight, header.format, compressedLevel );
+
+				level += levelWidth * levelHeight;
+				compressedLevel += rend::getLevelSize( header.format, levelWidth, levelHeight );
+			}
+		}
+		else
+		{
+			mem::copy( &data[sizeof( CompiledImageHeader )], &levels[0], dataSize );
+		}
+
+		if( regionsSize > 0 )
+		{
+			mem::copy( &data[sizeof( CompiledImageHeader ) + dataSize], &regions[0], regionsSize );
+		}
+
+		mem::copy( &data[0], &header, sizeof( CompiledImageHeader ) );
 
 		return true;
 	}
@@ -501,28 +630,386 @@ namespace img
 		return true;
 	}
 
-	Bool Converter::compile( String relativePath, res::IDependencyProvider& dependencyProvider, 
-		res::CompilationOutput& output ) const
+	static Bool loadImage( String relativePath, res::IDependencyProvider& dependencyProvider, 
+		res::CompilationOutput& output, Array<math::Color>& image, UInt32& width, UInt32& height )
 	{
 		const String ext = fm::getFileExt( *relativePath );
 
 		if( ext == TXT( "bmp" ) )
 		{
-			return compileBmp( relativePath, dependencyProvider, output );
+			return loadBmp( relativePath, dependencyProvider, output, image, width, height );
 		}
 		else if( ext == TXT( "tga" ) )
 		{
-			return compileTga( relativePath, dependencyProvider, output );
+			return loadTga( relativePath, dependencyProvider, output, image, width, height );
 		}
 		else if( ext == TXT( "png" ) )
 		{
-			return compilePng( relativePath, dependencyProvider, output );
+			return loadPng( relativePath, dependencyProvider, output, image, width, height );
 		}
 		else
 		{
-			fatal( TXT( "Unknown image format in \"%s\"" ), *relativePath );
+			output.errorMsg = String::format( TXT( "Unknown image format in \"%s\"" ), *relativePath );
+			return false;
+		}
+	}
+
+	/**
+	 *	Load atlas description and list of the packed image files:
+	 *		{ "Images": [ "Sprites\\Hero.png", ... ], "MaxSize": 2048, "Padding": 2,
+	 *		  "Extrusion": 1, "MipSafeLevels": 2, "Format": "BC3_UNORM" }
+	 */
+	static JSon::Ptr loadAtlasDesc( String atlasPath, res::IDependencyProvider& dependencyProvider, 
+		res::CompilationOutput& output, Array<String>& images )
+	{
+		Text::Ptr atlasText = dependencyProvider.getTextFile( atlasPath );
+		if( !atlasText )
+		{
+			output.errorMsg = String::format( TXT( "Unable to open atlas file \"%s\"" ), *atlasPath );
+			return nullptr;
+		}
+
+		JSon::Ptr rootNode = JSon::loadFromText( atlasText, &output.errorMsg );
+		if( !rootNode )
+		{
+			return nullptr;
+		}
+
+		JSon::Ptr imagesNode = rootNode->getField( TXT( "Images" ), JSon::EMissingPolicy::USE_NULL );
+		if( !imagesNode || imagesNode->arraySize() == 0 )
+		{
+			output.errorMsg = String::format( TXT( "Atlas \"%s\" has no images" ), *atlasPath );
+			return nullptr;
+		}
+
+		for( Int32 i = 0; i < imagesNode->arraySize(); ++i )
+		{
+			String imagePath = imagesNode->getElement( i, JSon::EMissingPolicy::USE_STUB )->asString( TXT( "" ) );
+
+			for( SizeT j = 0; j < imagePath.len(); ++j )
+			{
+				if( imagePath[j] == TXT( '/' ) )
+				{
+					imagePath[j] = TXT( '\\' );
+				}
+			}
+
+			images.push( imagePath );
+		}
+
+		return rootNode;
+	}
+
+	static Bool compileAtlas( String relativePath, res::IDependencyProvider& dependencyProvider, 
+		res::CompilationOutput& output )
+	{
+		Array<String> imagePaths;
+		JSon::Ptr rootNode = loadAtlasDesc( relativePath, dependencyProvider, output, imagePaths );
+
+		if( !rootNode )
+		{
+			return false;
+		}
+
+		ImageSettings settings;
+
+		if( !parseSettings( rootNode, output, settings ) )
+		{
+			return false;
+		}
+
+		AtlasSettings atlasSettings;
+		atlasSettings.maxSize = rootNode->dotgetInt( TXT( "MaxSize" ), atlasSettings.maxSize );
+		atlasSettings.padding = rootNode->dotgetInt( TXT( "Padding" ), atlasSettings.padding );
+		atlasSettings.extrusion = rootNode->dotgetInt( TXT( "Extrusion" ), atlasSettings.extrusion );
+		atlasSettings.mipSafeLevels = rootNode->dotgetInt( TXT( "MipSafeLevels" ), atlasSettings.mipSafeLevels );
+
+		if( !isPowerOfTwo( atlasSettings.maxSize ) || atlasSettings.padding < 0 || atlasSettings.extrusion < 0 ||
+			atlasSettings.mipSafeLevels < 0 || ( 1 << atlasSettings.mipSafeLevels ) > atlasSettings.maxSize )
+		{
+			output.errorMsg = TXT( "Bad atlas settings" );
 			return false;
 		}
+
+		// atlas regions never wrap and smaller mips mix neighbours
+		settings.wrap = false;
+		settings.maxMips = atlasSettings.mipSafeLevels + 1;
+
+		Array<Array<math::Color>> images( imagePaths.size() );
+		Array<AtlasSource> sources( imagePaths.size() );
+
+		for( Int32 i = 0; i < imagePaths.size(); ++i )
+		{
+			UInt32 width = 0;
+			UInt32 height = 0;
+
+			if( !loadImage( imagePaths[i], dependencyProvider, output, images[i], width, height ) )
+			{
+				return false;
+			}
+
+			sources[i].image = &images[i][0];
+			sources[i].width = width;
+			sources[i].height = height;
+		}
+
+		Array<math::Color> atlas;
+		Array<AtlasRect> regions;
+		Int32 width = 0;
+		Int32 height = 0;
+
+		if( !buildAtlas( sources, atlasSettings, atlas, width, height, regions ) )
+		{
+			output.errorMsg = String::format( TXT( "Images don't fit into %dx%d atlas" ), 
+				atlasSettings.maxSize, atlasSettings.maxSize );
+			return false;
+		}
+
+		return saveImage( atlas, width, height, settings, regions, output );
+	}
+
+	/**
+	 *	Save image as a reference to its region in atlas
+	 */
+	static Bool saveAtlasRegion( String relativePath, UInt32 width, UInt32 height, const ImageSettings& settings,
+		res::IDependencyProvider& dependencyProvider, res::CompilationOutput& output )
+	{
+		String atlasPath = settings.atlas;
+
+		for( SizeT i = 0; i < atlasPath.len(); ++i )
+		{
+			if( atlasPath[i] == TXT( '.' ) )
+			{
+				atlasPath[i] = TXT( '\\' );
+			}
+		}
+
+		atlasPath += TXT( ".atlas" );
+
+		Array<String> imagePaths;
+
+		if( !loadAtlasDesc( atlasPath, dependencyProvider, output, imagePaths ) )
+		{
+			return false;
+		}
+
+		Int32 regionIndex = -1;
+
+		for( Int32 i = 0; i < imagePaths.size(); ++i )
+		{
+			if( String::insensitiveCompare( imagePaths[i], relativePath ) == 0 )
+			{
+				regionIndex = i;
+				break;
+			}
+		}
+
+		if( regionIndex == -1 )
+		{
+			output.errorMsg = String::format( TXT( "Image is not listed in atlas \"%s\"" ), *atlasPath );
+			return false;
+		}
+
+		CompiledImageHeader header;
+		header.format = rend::EFormat::Unknown;
+		header.width = width;
+		header.height = height;
+		header.mips = 0;
+		header.numRegions = 0;
+		header.atlasRegion = regionIndex;
+		header.atlasId = res::ResourceId( res::EResourceType::Image, settings.atlas );
+
+		output.references.put( header.atlasId, settings.atlas );
+
+		output.compiledResource.data.setSize( sizeof( CompiledImageHeader ) );
+		mem::copy( &output.compiledResource.data[0], &header, sizeof( CompiledImageHeader ) );
+
+		return true;
+	}
+
+	/**
+	 *	Convert font glyphs sheet to the distance field atlas. Each glyph of the
+	 *	font file gets its own region in glyphs order, so one atlas serves text
+	 *	of any size
+	 */
+	static Bool compileDistanceField( const Array<math::Color>& image, UInt32 width, UInt32 height, 
+		ImageSettings& settings, res::IDependencyProvider& dependencyProvider, res::CompilationOutput& output )
+	{
+		if( settings.spread <= 0 || settings.downscale <= 0 )
+		{
+			output.errorMsg = TXT( "Bad distance field settings" );
+			return false;
+		}
+
+		Text::Ptr fontText = dependencyProvider.getTextFile( settings.distanceField );
+		if( !fontText )
+		{
+			output.errorMsg = String::format( TXT( "Unable to open font file \"%s\"" ), *settings.distanceField );
+			return false;
+		}
+
+		JSon::Ptr rootNode = JSon::loadFromText( fontText, &output.errorMsg );
+		if( !rootNode )
+		{
+			return false;
+		}
+
+		JSon::Ptr glyphsNode = rootNode->getField( TXT( "Glyphs" ), JSon::EMissingPolicy::USE_NULL );
+		if( !glyphsNode || glyphsNode->arraySize() == 0 )
+		{
+			output.errorMsg = String::format( TXT( "Font \"%s\" has no glyphs" ), *settings.distanceField );
+			return false;
+		}
+
+		Array<AtlasRect> glyphs( glyphsNode->arraySize() );
+
+		for( Int32 i = 0; i < glyphs.size(); ++i )
+		{
+			JSon::Ptr charNode = glyphsNode->getElement( i, JSon::EMissingPolicy::USE_NULL );
+			AtlasRect& glyph = glyphs[i];
+
+			if( !charNode )
+			{
+				output.errorMsg = TXT( "Bad glyphs table" );
+				return false;
+			}
+
+			// empty glyphs still get a pixel
+			glyph.x = charNode->dotgetInt( TXT( "X" ), -1 );
+			glyph.y = charNode->dotgetInt( TXT( "Y" ), -1 );
+			glyph.width = max( charNode->dotgetInt( TXT( "W" ), 0 ), 1 );
+			glyph.height = max( charNode->dotgetInt( TXT( "H" ), 0 ), 1 );
+
+			if( glyph.x < 0 || glyph.y < 0 || glyph.x + glyph.width > Int32( width ) || 
+				glyph.y + glyph.height > Int32( height ) )
+			{
+				output.errorMsg = String::format( TXT( "Glyph %d is out of image" ), i );
+				return false;
+			}
+		}
+
+		// generate glyphs fields on all cores
+		struct GlyphsContext
+		{
+			const math::Color* image;
+			Int32 imageWidth;
+			const ImageSettings* settings;
+			const Array<AtlasRect>* glyphs;
+			Array<Array<math::Color>>* fields;
+			Array<AtlasSource>* sources;
+		};
+
+		Array<Array<math::Color>> fields( glyphs.size() );
+		Array<AtlasSource> sources( glyphs.size() );
+
+		GlyphsContext context;
+		context.image = &image[0];
+		context.imageWidth = width;
+		context.settings = &settings;
+		context.glyphs = &glyphs;
+		context.fields = &fields;
+		context.sources = &sources;
+
+		auto generateFunc = []( void* userData, Int32 taskIndex, Int32 first, Int32 last )
+		{
+			GlyphsContext* context = reinterpret_cast<GlyphsContext*>( userData );
+
+			for( Int32 i = first; i < last; ++i )
+			{
+				AtlasSource& source = ( *context->sources )[i];
+				Array<math::Color>& field = ( *context->fields )[i];
+
+				generateDistanceField( context->image, context->imageWidth, ( *context->glyphs )[i], 
+					context->settings->spread, context->settings->downscale, field, source.width, source.height );
+
+				source.image = &field[0];
+			}
+		};
+
+		job::parallelFor( glyphs.size(), 1, min<Int32>( threading::getCPUCoresCount(), MAX_GLYPH_TASKS ), 
+			generateFunc, &context );
+
+		// fields are sampled with linear filter, no mips needed
+		AtlasSettings atlasSettings;
+		atlasSettings.padding = 1;
+		atlasSettings.extrusion = 0;
+		atlasSettings.mipSafeLevels = 0;
+
+		settings.wrap = false;
+		settings.maxMips = 1;
+
+		Array<math::Color> atlas;
+		Array<AtlasRect> regions;
+		Int32 atlasWidth = 0;
+		Int32 atlasHeight = 0;
+
+		if( !buildAtlas( sources, atlasSettings, atlas, atlasWidth, atlasHeight, regions ) )
+		{
+			output.errorMsg = String::format( TXT( "Glyphs don't fit into %dx%d atlas" ), 
+				atlasSettings.maxSize, atlasSettings.maxSize );
+			return false;
+		}
+
+		// regions without spread match glyphs
+		for( auto& it : regions )
+		{
+			it.x += settings.spread;
+			it.y += settings.spread;
+			it.width -= settings.spread * 2;
+			it.height -= settings.spread * 2;
+		}
+
+		return saveImage( atlas, atlasWidth, atlasHeight, settings, regions, output );
+	}
+
+	Bool Converter::compile( String relativePath, res::IDependencyProvider& dependencyProvider, 
+		res::CompilationOutput& output ) const
+	{
+		if( fm::getFileExt( *relativePath ) == TXT( "atlas" ) )
+		{
+			return compileAtlas( relativePath, dependencyProvider, output );
+		}
+
+		Array<math::Color> image;
+		UInt32 width = 0;
+		UInt32 height = 0;
+
+		if( !loadImage( relativePath, dependencyProvider, output, image, width, height ) )
+		{
+			return false;
+		}
+
+		ImageSettings settings;
+
+		if( !loadSettings( relativePath, dependencyProvider, output, settings ) )
+		{
+			return false;
+		}
+
+		if( settings.distanceField )
+		{
+			if( settings.atlas )
+			{
+				output.errorMsg = TXT( "Distance field image can't be packed into atlas" );
+				return false;
+			}
+
+			return compileDistanceField( image, width, height, settings, dependencyProvider, output );
+		}
+
+		if( settings.atlas )
+		{
+			// tiled surfaces, like brushes and ropes, sample outside of the region
+			if( settings.wrap )
+			{
+				output.errorMsg = TXT( "Wrapped image can't be packed into atlas" );
+				return false;
+			}
+
+			return saveAtlasRegion( relativePath, width, height, settings, dependencyProvider, output );
+		}
+
+		return saveImage( image, width, height, settings, Array<AtlasRect>(), output );
 	}
 
 	Converter::Converter()
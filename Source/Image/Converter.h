@@ -13,6 +13,8 @@ namespace img
 	class Converter final: public res::IResourceCompiler
 	{
 	public:
+		static const constexpr Char* COMPILER_MARK = TXT( "img_6" );
+
 		Converter();
 		~Converter();
 
@@ -27,7 +29,12 @@ namespace img
 			const String ext = fm::getFileExt( *relativePath );
 
 			return ext == TXT( "bmp" ) || ext == TXT( "png" ) ||
-				ext == TXT( "tga" );
+				ext == TXT( "tga" ) || ext == TXT( "atlas" );
+		}
+
+		String compilerMark() const override
+		{
+			return COMPILER_MARK;
 		}
 	};
 }
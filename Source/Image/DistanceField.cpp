@@ -0,0 +1,159 @@
+//-----------------------------------------------------------------------------
+//	DistanceField.cpp: Signed distance field generation
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Image.h"
+
+namespace flu
+{
+namespace img
+{
+	static const Float INFINITE_DISTANCE = 1e20f;
+
+	/**
+	 *	Squared euclidean distance transform of the sampled function in linear time,
+	 *	by Felzenszwalb and Huttenlocher, lower envelope of parabolas rooted at samples
+	 */
+	static void distanceTransform1D( const Float* f, Int32 n, Float* d, Int32* v, Float* z )
+	{
+		Int32 k = 0;
+
+		v[0] = 0;
+		z[0] = -INFINITE_DISTANCE;
+		z[1] = INFINITE_DISTANCE;
+
+		for( Int32 q = 1; q < n; ++q )
+		{
+			Float s = ( ( f[q] + q * q ) - ( f[v[k]] + v[k] * v[k] ) ) / ( 2 * q - 2 * v[k] );
+
+			while( s <= z[k] )
+			{
+				--k;
+				s = ( ( f[q] + q * q ) - ( f[v[k]] + v[k] * v[k] ) ) / ( 2 * q - 2 * v[k] );
+			}
+
+			++k;
+			v[k] = q;
+			z[k] = s;
+			z[k + 1] = INFINITE_DISTANCE;
+		}
+
+		k = 0;
+
+		for( Int32 q = 0; q < n; ++q )
+		{
+			while( z[k + 1] < q )
+			{
+				++k;
+			}
+
+			d[q] = sqr( Float( q - v[k] ) ) + f[v[k]];
+		}
+	}
+
+	static void distanceTransform2D( Array<Float>& grid, Int32 width, Int32 height )
+	{
+		const Int32 n = max( width, height );
+
+		Array<Float> f( n );
+		Array<Float> d( n );
+		Array<Float> z( n + 1 );
+		Array<Int32> v( n );
+
+		// columns first
+		for( Int32 x = 0; x < width; ++x )
+		{
+			for( Int32 y = 0; y < height; ++y )
+			{
+				f[y] = grid[y * width + x];
+			}
+
+			distanceTransform1D( &f[0], height, &d[0], &v[0], &z[0] );
+
+			for( Int32 y = 0; y < height; ++y )
+			{
+				grid[y * width + x] = d[y];
+			}
+		}
+
+		// then rows
+		for( Int32 y = 0; y < height; ++y )
+		{
+			Float* row = &grid[y * width];
+
+			distanceTransform1D( row, width, &d[0], &v[0], &z[0] );
+			mem::copy( row, &d[0], width * sizeof( Float ) );
+		}
+	}
+
+	void generateDistanceField( const math::Color* image, Int32 imageWidth, const AtlasRect& rect,
+		Int32 spread, Int32 downscale, Array<math::Color>& output, Int32& outputWidth, Int32& outputHeight )
+	{
+		assert( image && imageWidth > 0 );
+		assert( rect.width > 0 && rect.height > 0 );
+		assert( spread > 0 && downscale > 0 );
+
+		const Int32 innerWidth = ( rect.width + downscale - 1 ) / downscale;
+		const Int32 innerHeight = ( rect.height + downscale - 1 ) / downscale;
+
+		// source pixels per output pixel, the rect maps exactly into the inner area
+		const Float scaleX = Float( rect.width ) / innerWidth;
+		const Float scaleY = Float( rect.height ) / innerHeight;
+
+		// source area around the rect, enough for spread
+		const Int32 border = spread * downscale;
+		const Int32 gridWidth = rect.width + border * 2;
+		const Int32 gridHeight = rect.height + border * 2;
+
+		Array<Float> toInside( gridWidth * gridHeight );
+		Array<Float> toOutside( gridWidth * gridHeight );
+
+		for( Int32 y = 0; y < gridHeight; ++y )
+		{
+			for( Int32 x = 0; x < gridWidth; ++x )
+			{
+				const Int32 u = x - border;
+				const Int32 v = y - border;
+
+				const Bool inside = u >= 0 && v >= 0 && u < rect.width && v < rect.height &&
+					image[( rect.y + v ) * imageWidth + rect.x + u].a >= 128;
+
+				toInside[y * gridWidth + x] = inside ? 0.f : INFINITE_DISTANCE;
+				toOutside[y * gridWidth + x] = inside ? INFINITE_DISTANCE : 0.f;
+			}
+		}
+
+		distanceTransform2D( toInside, gridWidth, gridHeight );
+		distanceTransform2D( toOutside, gridWidth, gridHeight );
+
+		outputWidth = innerWidth + spread * 2;
+		outputHeight = innerHeight + spread * 2;
+		output.setSize( outputWidth * outputHeight );
+
+		// distance in source pixels to the alpha
+		const Float distanceScale = 2.f / ( ( scaleX + scaleY ) * 2.f * spread );
+
+		for( Int32 y = 0; y < outputHeight; ++y )
+		{
+			const Float gridY = ( y - spread + 0.5f ) * scaleY - 0.5f + border;
+			const Int32 v = clamp( math::round( gridY ), 0, gridHeight - 1 );
+
+			for( Int32 x = 0; x < outputWidth; ++x )
+			{
+				const Float gridX = ( x - spread + 0.5f ) * scaleX - 0.5f + border;
+				const Int32 u = clamp( math::round( gridX ), 0, gridWidth - 1 );
+				const Int32 i = v * gridWidth + u;
+
+				// edge lies between inside and outside pixels
+				const Float distance = toInside[i] == 0.f ? math::sqrt( toOutside[i] ) - 0.5f :
+					0.5f - math::sqrt( toInside[i] );
+
+				const Float value = clamp( 0.5f + distance * distanceScale, 0.f, 1.f );
+
+				output[y * outputWidth + x] = math::Color( 0xff, 0xff, 0xff, UInt8( math::round( value * 255.f ) ) );
+			}
+		}
+	}
+}
+}
@@ -0,0 +1,19 @@
+//-----------------------------------------------------------------------------
+//	DistanceField.h: Signed distance field generation
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+namespace img
+{
+	/**
+	 *	Build signed distance field of the image rect, pixels with alpha >= 128
+	 *	are inside. Output is rect size divided by downscale plus spread pixels
+	 *	on each side. Distance is stored in alpha, 0.5 is the edge and spread
+	 *	output pixels cover the whole range, color is white
+	 */
+	extern void generateDistanceField( const math::Color* image, Int32 imageWidth, const AtlasRect& rect,
+		Int32 spread, Int32 downscale, Array<math::Color>& output, Int32& outputWidth, Int32& outputHeight );
+}
+}
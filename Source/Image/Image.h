@@ -14,6 +14,10 @@
 #include "ThirdParty/lodepng/lodepng.h" // todo: hide it out of public includes!
 
 // Image includes
+#include "AtlasPacker.h"
+#include "DistanceField.h"
 #include "ImageType.h"
+#include "Mipmap.h"
+#include "BlockCompression.h"
 #include "Converter.h"
 #include "System.h"
\ No newline at end of file
@@ -13,6 +13,10 @@ namespace img
 		:	Resource( name ),
 			m_handle( INVALID_HANDLE<rend::Texture2DHandle>() ),
 			m_srv(),
+			m_atlas(),
+			m_atlasRegion( 0 ),
+			m_region(),
+			m_regions(),
 			m_type( EImageType::MAX ),
 			m_uSize( 0 ), m_vSize( 0 ),
 			m_uBits( 0 ), m_vBits( 0 )
@@ -29,43 +33,159 @@ namespace img
 		assert( compiledResource.isValid() );
 		assert( m_handle == INVALID_HANDLE<rend::Texture2DHandle>() );
 
-		UInt32 width = 0;
-		UInt32 height = 0;
+		if( compiledResource.data.size() < sizeof( CompiledImageHeader ) )
+		{
+			error( TXT( "Image \"%s\" has no header" ), *m_name );
+			return false;
+		}
+
+		CompiledImageHeader header;
+		mem::copy( &header, &compiledResource.data[0], sizeof( CompiledImageHeader ) );
 
-		LodePNGState state;
-		lodepng_state_init( &state );
+		if( header.atlasId.getType() == res::EResourceType::Image )
+		{
+			if( compiledResource.data.size() != sizeof( CompiledImageHeader ) )
+			{
+				error( TXT( "Image \"%s\" has unexpected data for atlas region" ), *m_name );
+				return false;
+			}
+
+			return createRegion( header );
+		}
 
-		UInt8* imageData;
+		if( header.format == rend::EFormat::Unknown || header.format >= rend::EFormat::MAX ||
+			header.width == 0 || header.height == 0 ||
+			header.mips == 0 || header.mips > UInt32( rend::getMipsCount( header.width, header.height ) ) )
+		{
+			error( TXT( "Image \"%s\" has bad header" ), *m_name );
+			return false;
+		}
 
-		auto pngError = lodepng_decode( &imageData, &width, &height, &state, 
-			&compiledResource.data[0], compiledResource.data.size() );
+		SizeT dataSize = 0;
 
-		if( pngError )
+		for( UInt32 i = 0; i < header.mips; ++i )
 		{
-			error( TXT( "Unable to load image \"%s\" with error \"%s\"" ), *m_name, 
-				lodepng_error_text( pngError ) );
+			dataSize += rend::getLevelSize( header.format, max<Int32>( header.width >> i, 1 ), 
+				max<Int32>( header.height >> i, 1 ) );
+		}
+
+		const SizeT regionsSize = header.numRegions * sizeof( AtlasRect );
 
-			lodepng_state_cleanup( &state );
+		if( compiledResource.data.size() != sizeof( CompiledImageHeader ) + dataSize + regionsSize )
+		{
+			error( TXT( "Image \"%s\" has wrong data size %d, expected %d" ), *m_name,
+				compiledResource.data.size(), sizeof( CompiledImageHeader ) + dataSize + regionsSize );
 			return false;
 		}
 
-		//todo: only RGBA8 supported yet :(
-		assert( state.info_raw.bitdepth == 8 );
-		assert( state.info_raw.colortype == LCT_RGBA );
+		const UInt8* levelsData = &compiledResource.data[sizeof( CompiledImageHeader )];
+
+		if( header.numRegions > 0 )
+		{
+			// regions of the images packed into this atlas
+			m_regions.setSize( header.numRegions );
+			mem::copy( &m_regions[0], levelsData + dataSize, regionsSize );
+		}
+		Array<math::Color> decodedLevels;
 
-		m_handle = device->createTexture2D( rend::EFormat::RGBA8_UNORM, width, height, 1, rend::EUsage::Immutable, imageData, *wide2AnsiString( m_name ) );
+		if( isBlockCompressed( header.format ) && !device->isFormatSupported( header.format ) )
+		{
+			// decode on cpu for devices without block compression support
+			warn( TXT( "Image \"%s\" format %s is not supported by device, decoding" ), *m_name, 
+				rend::getFormatInfo( header.format ).name );
+
+			Int32 totalPixels = 0;
+
+			for( UInt32 i = 0; i < header.mips; ++i )
+			{
+				totalPixels += max<Int32>( header.width >> i, 1 ) * max<Int32>( header.height >> i, 1 );
+			}
+
+			decodedLevels.setSize( totalPixels );
+			math::Color* decodedLevel = &decodedLevels[0];
+
+			for( UInt32 i = 0; i < header.mips; ++i )
+			{
+				const Int32 levelWidth = max<Int32>( header.width >> i, 1 );
+				const Int32 levelHeight = max<Int32>( header.height >> i, 1 );
+
+				decodeBlocks( levelsData, levelWidth, levelHeight, header.format, decodedLevel );
+
+				decodedLevel += levelWidth * levelHeight;
+				levelsData += rend::getLevelSize( header.format, levelWidth, levelHeight );
+			}
+
+			header.format = rend::EFormat::RGBA8_UNORM;
+			levelsData = reinterpret_cast<const UInt8*>( &decodedLevels[0] );
+		}
+
+		m_handle = device->createTexture2D( header.format, header.width, header.height, header.mips, rend::EUsage::Immutable, 
+			levelsData, *wide2AnsiString( m_name ) );
 		m_srv = device->getShaderResourceView( m_handle );
 
-		m_uSize = width;
-		m_vSize = height;
+		m_uSize = header.width;
+		m_vSize = header.height;
+
+		m_type = EImageType::RGBA;
+
+		m_uBits = intLog2( m_uSize );
+		m_vBits = intLog2( m_vSize );
+
+		return true;
+	}
+
+	Bool Image::createRegion( const CompiledImageHeader& header )
+	{
+		assert( header.atlasId.getType() == res::EResourceType::Image );
+
+		if( header.width == 0 || header.height == 0 )
+		{
+			error( TXT( "Image \"%s\" has bad header" ), *m_name );
+			return false;
+		}
+
+		m_atlas = res::ResourceManager::get<Image>( header.atlasId, res::EFailPolicy::FATAL );
+		m_atlasRegion = header.atlasRegion;
+
+		m_uSize = header.width;
+		m_vSize = header.height;
 
 		m_type = EImageType::RGBA;
 
 		m_uBits = intLog2( m_uSize );
 		m_vBits = intLog2( m_vSize );
 
-		lodepng_state_cleanup( &state );
-		mem::free( imageData );
+		return resolveRegion();
+	}
+
+	Bool Image::resolveRegion()
+	{
+		assert( m_atlas.hasObject() );
+
+		if( m_atlasRegion >= UInt32( m_atlas->m_regions.size() ) )
+		{
+			error( TXT( "Image \"%s\" region %d is missing in atlas \"%s\"" ), *m_name,
+				m_atlasRegion, *m_atlas->getName() );
+			return false;
+		}
+
+		const AtlasRect& rect = m_atlas->m_regions[m_atlasRegion];
+
+		if( UInt32( rect.width ) != m_uSize || UInt32( rect.height ) != m_vSize )
+		{
+			error( TXT( "Image \"%s\" size mismatch with atlas \"%s\" region" ), *m_name,
+				*m_atlas->getName() );
+			return false;
+		}
+
+		// share atlas texture, it stays alive while we hold the atlas
+		m_handle = m_atlas->m_handle;
+		m_srv = m_atlas->m_srv;
+
+		m_region.min = { Float( rect.x ) / m_atlas->m_uSize, Float( rect.y ) / m_atlas->m_vSize };
+		m_region.max = { Float( rect.x + rect.width ) / m_atlas->m_uSize,
+			Float( rect.y + rect.height ) / m_atlas->m_vSize };
+
 		return true;
 	}
 
@@ -74,8 +194,18 @@ namespace img
 		assert( device );
 		assert( m_handle != INVALID_HANDLE<rend::Texture2DHandle>() );
 
-		device->destroyTexture2D( m_handle );
+		if( m_atlas.hasObject() )
+		{
+			m_atlas = nullptr;
+		}
+		else
+		{
+			device->destroyTexture2D( m_handle );
+		}
+
 		m_handle = INVALID_HANDLE<rend::Texture2DHandle>();
+		m_srv = rend::ShaderResourceView();
+		m_regions.empty();
 
 		m_type = EImageType::MAX;
 
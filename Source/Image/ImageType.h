@@ -21,6 +21,23 @@ namespace img
 		MAX
 	};
 
+	/**
+	 *	A compiled image header, followed by all the mip levels
+	 *	from the largest one down to 1x1 and atlas regions table.
+	 *	Images packed into an atlas have no levels, but atlas id
+	 */
+	struct CompiledImageHeader
+	{
+	public:
+		rend::EFormat format;
+		UInt32 width;
+		UInt32 height;
+		UInt32 mips;
+		UInt32 numRegions;
+		UInt32 atlasRegion;
+		res::ResourceId atlasId;
+	};
+
 	/**
 	 *	An image
 	 */
@@ -42,10 +59,40 @@ namespace img
 		rend::Texture2DHandle getHandle() const { return m_handle; }
 		rend::ShaderResourceView getSRV() const { return m_srv; }
 
+		/**
+		 *	Whether image is packed into an atlas, handle and srv are
+		 *	atlas ones then, so texture coords should be mapped to region
+		 */
+		Bool isAtlasRegion() const { return m_atlas.hasObject(); }
+
+		math::Vector mapTexCoords( const math::Vector& tc ) const
+		{
+			return { m_region.min.x + tc.x * ( m_region.max.x - m_region.min.x ),
+				m_region.min.y + tc.y * ( m_region.max.y - m_region.min.y ) };
+		}
+
+		math::Rect mapTexCoords( const math::Rect& tc ) const
+		{
+			math::Rect result;
+			result.min = mapTexCoords( tc.min );
+			result.max = mapTexCoords( tc.max );
+			return result;
+		}
+
+		/**
+		 *	Regions table of the atlas image, in pixels
+		 */
+		const Array<AtlasRect>& getRegions() const { return m_regions; }
+
 	private:
 		rend::Texture2DHandle m_handle;
 		rend::ShaderResourceView m_srv;
 
+		Ptr m_atlas;
+		UInt32 m_atlasRegion;
+		math::Rect m_region;
+		Array<AtlasRect> m_regions;
+
 		UInt32 m_uSize;
 		UInt32 m_vSize;
 
@@ -59,6 +106,9 @@ namespace img
 		Bool create( rend::Device* device, const res::CompiledResource& compiledResource );
 		void destroy( rend::Device* device );
 
+		Bool createRegion( const CompiledImageHeader& header );
+		Bool resolveRegion();
+
 		friend class System;
 	};
 }
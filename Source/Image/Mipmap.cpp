@@ -0,0 +1,421 @@
+//-----------------------------------------------------------------------------
+//	Mipmap.cpp: A mip chain generation
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Image.h"
+
+namespace flu
+{
+namespace img
+{
+	static const Char* MIP_FILTER_NAMES[] = { TXT( "None" ), TXT( "Box" ), TXT( "Kaiser" ), TXT( "AlphaCoverage" ) };
+	static_assert( arraySize( MIP_FILTER_NAMES ) == static_cast<SizeT>( EMipFilter::MAX ), "Mip filters names mismatched" );
+
+	static const Int32 KAISER_TAPS = 6;
+	static const Float KAISER_ALPHA = 4.f;
+
+	static const Float ALPHA_COVERAGE_REFERENCE = 0.5f;
+	static const Int32 ALPHA_COVERAGE_STEPS = 10;
+
+	static const Int32 ROWS_PER_TASK = 16;
+	static const Int32 MAX_TASKS = 32;
+
+	/**
+	 *	A single level downsampling. Levels are kept in premultiplied
+	 *	float colors between passes to avoid rounding accumulation
+	 */
+	struct LevelPass
+	{
+	public:
+		const math::FloatColor* source;
+		Int32 sourceWidth;
+		Int32 sourceHeight;
+
+		math::FloatColor* temp;
+
+		math::FloatColor* dest;
+		math::Color* output;
+		Int32 destWidth;
+		Int32 destHeight;
+
+		const Float* kaiserWeights;
+		Float alphaScale;
+		Bool wrap;
+	};
+
+	using RowsFunc = void(*)( const LevelPass& pass, Int32 firstRow, Int32 lastRow );
+
+	struct RowsContext
+	{
+	public:
+		RowsFunc func;
+		const LevelPass* pass;
+	};
+
+	/**
+	 *	Run func over rows, split across job workers
+	 */
+	static void forRows( RowsFunc func, const LevelPass& pass, Int32 numRows )
+	{
+		RowsContext context = { func, &pass };
+
+		job::parallelFor( numRows, ROWS_PER_TASK, MAX_TASKS, []( void* userData, Int32 taskIndex, Int32 first, Int32 last )
+		{
+			const RowsContext* context = reinterpret_cast<const RowsContext*>( userData );
+			context->func( *context->pass, first, last );
+		}, &context );
+	}
+
+	static inline Int32 addressPixel( Int32 i, Int32 size, Bool wrap )
+	{
+		return wrap ? i & ( size - 1 ) : clamp( i, 0, size - 1 );
+	}
+
+	static inline math::simd::Float4 loadColor( const math::FloatColor& color )
+	{
+		return math::simd::load( &color.r );
+	}
+
+	static inline void storeColor( math::FloatColor& color, math::simd::Float4 value )
+	{
+		math::simd::store( &color.r, value );
+	}
+
+	/**
+	 *	Modified Bessel function of the first kind, used by Kaiser window
+	 */
+	static Float besselI0( Float x )
+	{
+		Float sum = 1.f, term = 1.f;
+
+		for( Int32 k = 1; k < 20; ++k )
+		{
+			term *= sqr( x / ( 2.f * k ) );
+			sum += term;
+		}
+
+		return sum;
+	}
+
+	/**
+	 *	Weights for 2x downsampling, the destination pixel center lies
+	 *	between source pixels, so taps are at -2.5..2.5 source pixels
+	 */
+	static void computeKaiserWeights( Float weights[KAISER_TAPS] )
+	{
+		const Float halfWidth = KAISER_TAPS / 2.f;
+		Float totalWeight = 0.f;
+
+		for( Int32 i = 0; i < KAISER_TAPS; ++i )
+		{
+			const Float x = ( i - halfWidth + 0.5f ) / 2.f;
+			const Float sinc = math::sin( math::PI * x ) / ( math::PI * x );
+			const Float window = besselI0( KAISER_ALPHA * math::sqrt( 1.f - sqr( x / ( halfWidth / 2.f ) ) ) ) / besselI0( KAISER_ALPHA );
+
+			weights[i] = sinc * window;
+			totalWeight += weights[i];
+		}
+
+		for( Int32 i = 0; i < KAISER_TAPS; ++i )
+		{
+			weights[i] /= totalWeight;
+		}
+	}
+
+	static void boxRows( const LevelPass& pass, Int32 firstRow, Int32 lastRow )
+	{
+		using namespace math::simd;
+
+		const Int32 stepX = pass.sourceWidth > pass.destWidth ? 1 : 0;
+		const Int32 stepY = pass.sourceHeight > pass.destHeight ? pass.sourceWidth : 0;
+		const Float4 quarter = splat( 0.25f );
+
+		for( Int32 y = firstRow; y < lastRow; ++y )
+		{
+			const math::FloatColor* source = &pass.source[( stepY ? y * 2 : y ) * pass.sourceWidth];
+			math::FloatColor* dest = &pass.dest[y * pass.destWidth];
+
+			for( Int32 x = 0; x < pass.destWidth; ++x )
+			{
+				const math::FloatColor* pixel = &source[x << stepX];
+
+				Float4 sum = _mm_add_ps( loadColor( pixel[0] ), loadColor( pixel[stepX] ) );
+				sum = _mm_add_ps( sum, _mm_add_ps( loadColor( pixel[stepY] ), loadColor( pixel[stepX + stepY] ) ) );
+
+				storeColor( dest[x], _mm_mul_ps( sum, quarter ) );
+			}
+		}
+	}
+
+	static void kaiserHorizontalRows( const LevelPass& pass, Int32 firstRow, Int32 lastRow )
+	{
+		using namespace math::simd;
+
+		for( Int32 y = firstRow; y < lastRow; ++y )
+		{
+			const math::FloatColor* source = &pass.source[y * pass.sourceWidth];
+			math::FloatColor* temp = &pass.temp[y * pass.destWidth];
+
+			if( pass.sourceWidth == pass.destWidth )
+			{
+				mem::copy( temp, source, pass.destWidth * sizeof( math::FloatColor ) );
+				continue;
+			}
+
+			for( Int32 x = 0; x < pass.destWidth; ++x )
+			{
+				Float4 sum = _mm_setzero_ps();
+
+				for( Int32 i = 0; i < KAISER_TAPS; ++i )
+				{
+					const Int32 sourceX = addressPixel( 2 * x - KAISER_TAPS / 2 + 1 + i, pass.sourceWidth, pass.wrap );
+					sum = _mm_add_ps( sum, _mm_mul_ps( loadColor( source[sourceX] ), splat( pass.kaiserWeights[i] ) ) );
+				}
+
+				storeColor( temp[x], sum );
+			}
+		}
+	}
+
+	static void kaiserVerticalRows( const LevelPass& pass, Int32 firstRow, Int32 lastRow )
+	{
+		using namespace math::simd;
+
+		for( Int32 y = firstRow; y < lastRow; ++y )
+		{
+			math::FloatColor* dest = &pass.dest[y * pass.destWidth];
+
+			if( pass.sourceHeight == pass.destHeight )
+			{
+				mem::copy( dest, &pass.temp[y * pass.destWidth], pass.destWidth * sizeof( math::FloatColor ) );
+				continue;
+			}
+
+			const math::FloatColor* rows[KAISER_TAPS];
+
+			for( Int32 i = 0; i < KAISER_TAPS; ++i )
+			{
+				rows[i] = &pass.temp[addressPixel( 2 * y - KAISER_TAPS / 2 + 1 + i, pass.sourceHeight, pass.wrap ) * pass.destWidth];
+			}
+
+			for( Int32 x = 0; x < pass.destWidth; ++x )
+			{
+				Float4 sum = _mm_setzero_ps();
+
+				for( Int32 i = 0; i < KAISER_TAPS; ++i )
+				{
+					sum = _mm_add_ps( sum, _mm_mul_ps( loadColor( rows[i][x] ), splat( pass.kaiserWeights[i] ) ) );
+				}
+
+				storeColor( dest[x], sum );
+			}
+		}
+	}
+
+	/**
+	 *	Convert premultiplied float colors back to RGBA8
+	 */
+	static void quantizeRows( const LevelPass& pass, Int32 firstRow, Int32 lastRow )
+	{
+		using namespace math::simd;
+
+		const Float4 zero = _mm_setzero_ps();
+		const Float4 one = splat( 1.f );
+		const Float4 epsilon = splat( 1.f / 512.f );
+		const Float4 alphaLane = _mm_castsi128_ps( _mm_setr_epi32( 0, 0, 0, -1 ) );
+		const Float4 alphaScale = _mm_setr_ps( 1.f, 1.f, 1.f, pass.alphaScale );
+
+		for( Int32 i = firstRow * pass.destWidth; i < lastRow * pass.destWidth; ++i )
+		{
+			Float4 color = _mm_min_ps( _mm_max_ps( loadColor( pass.dest[i] ), zero ), one );
+			Float4 alpha = _mm_shuffle_ps( color, color, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+
+			// unpremultiply, transparent pixels become black
+			Float4 unpremultiplied = _mm_div_ps( _mm_min_ps( color, alpha ), _mm_max_ps( alpha, epsilon ) );
+			unpremultiplied = select( _mm_cmpgt_ps( alpha, epsilon ), unpremultiplied, zero );
+
+			color = _mm_min_ps( _mm_mul_ps( select( alphaLane, color, unpremultiplied ), alphaScale ), one );
+
+			__m128i packed = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( color, splat( 255.f ) ), splat( 0.5f ) ) );
+			packed = _mm_packs_epi32( packed, packed );
+			packed = _mm_packus_epi16( packed, packed );
+
+			pass.output[i].d = _mm_cvtsi128_si32( packed );
+		}
+	}
+
+	/**
+	 *	Convert RGBA8 to premultiplied float colors
+	 */
+	static void premultiplyRows( const LevelPass& pass, Int32 firstRow, Int32 lastRow )
+	{
+		using namespace math::simd;
+
+		const __m128i zero = _mm_setzero_si128();
+		const Float4 alphaOne = _mm_setr_ps( 0.f, 0.f, 0.f, 1.f );
+		const Float4 alphaLane = _mm_castsi128_ps( _mm_setr_epi32( 0, 0, 0, -1 ) );
+		const Float4 inv255 = splat( 1.f / 255.f );
+
+		for( Int32 i = firstRow * pass.destWidth; i < lastRow * pass.destWidth; ++i )
+		{
+			__m128i packed = _mm_cvtsi32_si128( pass.output[i].d );
+			packed = _mm_unpacklo_epi16( _mm_unpacklo_epi8( packed, zero ), zero );
+
+			Float4 color = _mm_mul_ps( _mm_cvtepi32_ps( packed ), inv255 );
+			Float4 alpha = _mm_or_ps( _mm_andnot_ps( alphaLane, _mm_shuffle_ps( color, color, _MM_SHUFFLE( 3, 3, 3, 3 ) ) ), alphaOne );
+
+			storeColor( pass.dest[i], _mm_mul_ps( color, alpha ) );
+		}
+	}
+
+	static Float alphaCoverage( const math::FloatColor* pixels, Int32 numPixels, Float alphaScale )
+	{
+		Int32 covered = 0;
+
+		for( Int32 i = 0; i < numPixels; ++i )
+		{
+			covered += pixels[i].a * alphaScale > ALPHA_COVERAGE_REFERENCE ? 1 : 0;
+		}
+
+		return Float( covered ) / Float( numPixels );
+	}
+
+	/**
+	 *	Find alpha scale, which gives the same alpha test coverage
+	 */
+	static Float findAlphaScale( const math::FloatColor* pixels, Int32 numPixels, Float targetCoverage )
+	{
+		Float minScale = 0.f, maxScale = 4.f;
+		Float bestScale = 1.f, bestError = abs( alphaCoverage( pixels, numPixels, 1.f ) - targetCoverage );
+
+		for( Int32 i = 0; i < ALPHA_COVERAGE_STEPS; ++i )
+		{
+			const Float scale = ( minScale + maxScale ) * 0.5f;
+			const Float coverage = alphaCoverage( pixels, numPixels, scale );
+
+			if( abs( coverage - targetCoverage ) < bestError )
+			{
+				bestError = abs( coverage - targetCoverage );
+				bestScale = scale;
+			}
+
+			if( coverage < targetCoverage )
+			{
+				minScale = scale;
+			}
+			else
+			{
+				maxScale = scale;
+			}
+		}
+
+		return bestScale;
+	}
+
+	EMipFilter getMipFilterByName( String name )
+	{
+		for( SizeT i = 0; i < arraySize( MIP_FILTER_NAMES ); ++i )
+		{
+			if( name == MIP_FILTER_NAMES[i] )
+			{
+				return static_cast<EMipFilter>( i );
+			}
+		}
+
+		return EMipFilter::MAX;
+	}
+
+	Int32 generateMips( const math::Color* image, Int32 width, Int32 height,
+		EMipFilter filter, Bool wrap, Array<math::Color>& output )
+	{
+		assert( image );
+		assert( isPowerOfTwo( width ) && isPowerOfTwo( height ) );
+		assert( filter < EMipFilter::MAX );
+
+		const Int32 numLevels = filter != EMipFilter::None ? rend::getMipsCount( width, height ) : 1;
+
+		Int32 totalPixels = 0;
+
+		for( Int32 i = 0; i < numLevels; ++i )
+		{
+			totalPixels += max( width >> i, 1 ) * max( height >> i, 1 );
+		}
+
+		// the first level is the source image as is
+		output.setSize( totalPixels );
+		mem::copy( &output[0], image, width * height * sizeof( math::Color ) );
+
+		if( numLevels == 1 )
+		{
+			return numLevels;
+		}
+
+		Float kaiserWeights[KAISER_TAPS];
+		computeKaiserWeights( kaiserWeights );
+
+		// the level 0 and all the next levels fit into two buffers
+		Array<math::FloatColor> levelsBuffer( width * height + width * height / 2 );
+		Array<math::FloatColor> tempLevel;
+
+		math::FloatColor* sourceLevel = &levelsBuffer[0];
+		math::FloatColor* destLevel = &levelsBuffer[width * height];
+
+		if( filter == EMipFilter::Kaiser )
+		{
+			tempLevel.setSize( width * height );
+		}
+
+		LevelPass pass;
+		pass.source = nullptr;
+		pass.sourceWidth = pass.sourceHeight = 0;
+		pass.temp = tempLevel.size() > 0 ? &tempLevel[0] : nullptr;
+		pass.dest = sourceLevel;
+		pass.output = &output[0];
+		pass.destWidth = width;
+		pass.destHeight = height;
+		pass.kaiserWeights = kaiserWeights;
+		pass.alphaScale = 1.f;
+		pass.wrap = wrap;
+
+		forRows( premultiplyRows, pass, height );
+
+		const Float targetCoverage = filter == EMipFilter::AlphaCoverage ?
+			alphaCoverage( sourceLevel, width * height, 1.f ) : 0.f;
+
+		for( Int32 level = 1; level < numLevels; ++level )
+		{
+			pass.source = sourceLevel;
+			pass.sourceWidth = pass.destWidth;
+			pass.sourceHeight = pass.destHeight;
+
+			pass.output += pass.destWidth * pass.destHeight;
+			pass.dest = destLevel;
+			pass.destWidth = max( pass.sourceWidth / 2, 1 );
+			pass.destHeight = max( pass.sourceHeight / 2, 1 );
+
+			if( filter == EMipFilter::Kaiser )
+			{
+				forRows( kaiserHorizontalRows, pass, pass.sourceHeight );
+				forRows( kaiserVerticalRows, pass, pass.destHeight );
+			}
+			else
+			{
+				forRows( boxRows, pass, pass.destHeight );
+			}
+
+			if( filter == EMipFilter::AlphaCoverage )
+			{
+				pass.alphaScale = findAlphaScale( pass.dest, pass.destWidth * pass.destHeight, targetCoverage );
+			}
+
+			forRows( quantizeRows, pass, pass.destHeight );
+
+			// next level is built from unscaled float colors
+			exchange( sourceLevel, destLevel );
+		}
+
+		return numLevels;
+	}
+}
+}
@@ -0,0 +1,36 @@
+//-----------------------------------------------------------------------------
+//	Mipmap.h: A mip chain generation
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+namespace img
+{
+	/**
+	 *	A mip levels downsampling filter
+	 */
+	enum class EMipFilter: UInt8
+	{
+		None,			// single level only
+		Box,			// 2x2 average
+		Kaiser,			// Kaiser windowed sinc, sharper for tiles
+		AlphaCoverage,	// box filter with preserved alpha test coverage for masked sprites
+		MAX
+	};
+
+	/**
+	 *	Return filter by name or EMipFilter::MAX if not found
+	 */
+	extern EMipFilter getMipFilterByName( String name );
+
+	/**
+	 *	Build a mip chain of RGBA image down to 1x1. All the levels are
+	 *	stored in output one after another, starting with the source
+	 *	image itself. Colors are filtered with alpha weighting, so
+	 *	transparent pixels don't bleed. Return number of levels
+	 */
+	extern Int32 generateMips( const math::Color* image, Int32 width, Int32 height,
+		EMipFilter filter, Bool wrap, Array<math::Color>& output );
+}
+}
@@ -52,6 +52,15 @@ namespace img
 		Image*& image = m_images.getRef( resourceId );
 		image->destroy( m_device );
 		image->create( m_device, compiledResource );
+
+		// atlas texture and regions are changed, so update all packed images
+		for( auto& it : m_images )
+		{
+			if( it.value->m_atlas.get() == image )
+			{
+				it.value->resolveRegion();
+			}
+		}
 	}
 
 	Bool System::allowHotReloading() const
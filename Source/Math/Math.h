@@ -6,6 +6,7 @@
 
 // std library
 #include <cmath>
+#include <emmintrin.h>
 
 // fluorine includes
 #include "Core/Core.h"
@@ -21,6 +22,7 @@
 // math includes
 #include "Constants.h"
 #include "Functions.h"
+#include "Simd.h"
 #include "Angle.h"
 #include "Vector.h"
 #include "Vector3.h"
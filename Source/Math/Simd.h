@@ -0,0 +1,94 @@
+//-----------------------------------------------------------------------------
+//	Simd.h: SSE helpers for four floats at once
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+namespace math
+{
+namespace simd
+{
+	using Float4 = __m128;
+
+	inline Float4 load( const Float* data )
+	{
+		return _mm_loadu_ps( data );
+	}
+
+	inline void store( Float* data, Float4 value )
+	{
+		_mm_storeu_ps( data, value );
+	}
+
+	inline Float4 splat( Float value )
+	{
+		return _mm_set1_ps( value );
+	}
+
+	/**
+	 *	Return a where mask is set and b otherwise
+	 */
+	inline Float4 select( Float4 mask, Float4 a, Float4 b )
+	{
+		return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+	}
+
+	/**
+	 *	Return mask of the first numLanes lanes
+	 */
+	inline Float4 laneMask( Int32 numLanes )
+	{
+		return _mm_castsi128_ps( _mm_cmplt_epi32( _mm_setr_epi32( 0, 1, 2, 3 ), _mm_set1_epi32( numLanes ) ) );
+	}
+
+	inline Float horizontalMin( Float4 value )
+	{
+		value = _mm_min_ps( value, _mm_shuffle_ps( value, value, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+		value = _mm_min_ps( value, _mm_shuffle_ps( value, value, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+		return _mm_cvtss_f32( value );
+	}
+
+	inline Float horizontalMax( Float4 value )
+	{
+		value = _mm_max_ps( value, _mm_shuffle_ps( value, value, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+		value = _mm_max_ps( value, _mm_shuffle_ps( value, value, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+		return _mm_cvtss_f32( value );
+	}
+
+	/**
+	 *	Polynomial sine, absolute error is below 1e-4
+	 */
+	inline Float4 sin( Float4 x )
+	{
+		const Float4 twoPi = _mm_set1_ps( 2.f * PI );
+		const Float4 invTwoPi = _mm_set1_ps( 0.5f / PI );
+		const Float4 pi = _mm_set1_ps( PI );
+		const Float4 halfPi = _mm_set1_ps( 0.5f * PI );
+		const Float4 signBit = _mm_set1_ps( -0.f );
+
+		// reduce to [-pi..pi]
+		const Float4 winding = _mm_cvtepi32_ps( _mm_cvtps_epi32( _mm_mul_ps( x, invTwoPi ) ) );
+		x = _mm_sub_ps( x, _mm_mul_ps( winding, twoPi ) );
+
+		// reflect to [-pi/2..pi/2], since sin(x) = sin(pi - x)
+		const Float4 sign = _mm_and_ps( x, signBit );
+		const Float4 absX = _mm_andnot_ps( signBit, x );
+		const Float4 reflected = _mm_sub_ps( pi, absX );
+		x = _mm_or_ps( select( _mm_cmpgt_ps( absX, halfPi ), reflected, absX ), sign );
+
+		// taylor series up to x^9
+		const Float4 x2 = _mm_mul_ps( x, x );
+
+		Float4 result = _mm_set1_ps( 1.f / 362880.f );
+		result = _mm_add_ps( _mm_mul_ps( result, x2 ), _mm_set1_ps( -1.f / 5040.f ) );
+		result = _mm_add_ps( _mm_mul_ps( result, x2 ), _mm_set1_ps( 1.f / 120.f ) );
+		result = _mm_add_ps( _mm_mul_ps( result, x2 ), _mm_set1_ps( -1.f / 6.f ) );
+		result = _mm_add_ps( _mm_mul_ps( result, x2 ), _mm_set1_ps( 1.f ) );
+
+		return _mm_mul_ps( result, x );
+	}
+
+} // namespace simd
+} // namespace math
+} // namespace flu
@@ -350,6 +350,8 @@ void COpenGLCanvas::DrawLine( const math::Vector& A, const math::Vector& B, math
 //
 void COpenGLCanvas::DrawRect( const TRenderRect& Rect )
 {
+	FlushBatches();
+
 	math::Vector Verts[4];
 
 	// Compute sprite vertices.
@@ -495,6 +497,8 @@ void COpenGLCanvas::DrawRect( const TRenderRect& Rect )
 //
 void COpenGLCanvas::DrawList( const TRenderList& List )
 {
+	FlushBatches();
+
 	if( List.Flags & POLY_FlatShade )
 	{
 		// Draw a colored rectangles.
@@ -563,6 +567,8 @@ void COpenGLCanvas::DrawList( const TRenderList& List )
 //
 void COpenGLCanvas::DrawPoly( const TRenderPoly& Poly )
 {
+	FlushBatches();
+
 	if( Poly.Flags & POLY_FlatShade )
 	{
 		// Draw colored polygon.
@@ -1357,6 +1363,8 @@ void drawGrid( COpenGLCanvas* Canvas )
 //
 void COpenGLCanvas::RenderLightmap()
 {
+	FlushBatches();
+
 	EnableShader( &FluShader );
 	FluShader.SetModeLightmap();
 	SetBlend( BLEND_Translucent );
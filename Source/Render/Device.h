@@ -107,6 +107,8 @@ namespace rend
 		virtual ShaderResourceView getShaderResourceView( RenderTargetHandle handle ) = 0;
 		virtual ShaderResourceView getShaderResourceView( DepthBufferHandle handle ) = 0;
 
+		virtual Bool isFormatSupported( EFormat format ) const = 0;
+
 		virtual Bool copyTextureToCPU( Texture2DHandle handle, EFormat& outFormat,
 			UInt32& outWidth, UInt32& outHeight, Array<UInt8>& outData ) = 0;
 
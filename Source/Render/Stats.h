@@ -35,6 +35,7 @@ namespace rend
 
 		Int32 m_blendStateSwitches = 0;
 		Int32 m_renderStateSwitches = 0;
+		Int32 m_srvSwitches = 0;
 	};
 }
 }
\ No newline at end of file
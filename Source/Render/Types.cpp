@@ -49,6 +49,10 @@ namespace rend
 		{	L"RGBA32_U",	16,			1,			1,			4	},
 
 		{	L"D24S8",		4,			1,			1,			2	},
+
+		{	L"BC1_UNORM",	8,			4,			4,			4	},
+		{	L"BC3_UNORM",	16,			4,			4,			4	},
+		{	L"BC7_UNORM",	16,			4,			4,			4	},
 	};
 
 	const FormatInfo& getFormatInfo( EFormat format )
@@ -69,5 +73,21 @@ namespace rend
 
 		return EFormat::Unknown;
 	}
+
+	SizeT getLevelSize( EFormat format, Int32 width, Int32 height )
+	{
+		const FormatInfo& info = getFormatInfo( format );
+
+		const SizeT blocksX = ( width + info.blockSizeX - 1 ) / info.blockSizeX;
+		const SizeT blocksY = ( height + info.blockSizeY - 1 ) / info.blockSizeY;
+
+		return blocksX * blocksY * info.blockBytes;
+	}
+
+	Int32 getMipsCount( Int32 width, Int32 height )
+	{
+		assert( width > 0 && height > 0 );
+		return intLog2( max( width, height ) ) + 1;
+	}
 }
 }
\ No newline at end of file
@@ -160,6 +160,10 @@ namespace rend
 
 		D24S8,
 
+		BC1_UNORM,
+		BC3_UNORM,
+		BC7_UNORM,
+
 		MAX
 	};
 
@@ -177,5 +181,15 @@ namespace rend
 	 */
 	extern const FormatInfo& getFormatInfo( EFormat format );
 	extern EFormat getFormatByName( String formatName );
+
+	/**
+	 *	Return size of a single texture level in bytes
+	 */
+	extern SizeT getLevelSize( EFormat format, Int32 width, Int32 height );
+
+	/**
+	 *	Return number of levels in a full mip chain down to 1x1
+	 */
+	extern Int32 getMipsCount( Int32 width, Int32 height );
 }
 }
\ No newline at end of file
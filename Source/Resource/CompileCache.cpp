@@ -0,0 +1,282 @@
+//-----------------------------------------------------------------------------
+//	CompileCache.cpp: A content-addressed cache of compiled resources implementation
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Resource.h"
+
+namespace flu
+{
+namespace res
+{
+	CompileCache::CompileCache( String cachePath, String packagesPath, SizeT capacity )
+		:	m_cachePath( cachePath ),
+			m_packagesPath( packagesPath ),
+			m_size( 0 ),
+			m_capacity( capacity ),
+			m_lock( concurrency::CriticalSection::create() )
+	{
+		// the cache may be left large by someone else
+		concurrency::CriticalSection::Guard guard( m_lock );
+		evict();
+	}
+
+	CompileCache::~CompileCache()
+	{
+	}
+
+	Bool CompileCache::load( ResourceId resourceId, String compilerMark, Entry& outEntry )
+	{
+		// the manifest tells which files were used last time
+		String manifestFileName = getFileName( getManifestKey( resourceId, compilerMark ), MANIFEST_EXTENSION );
+		auto manifestReader = fm::readBinaryFile( *manifestFileName );
+
+		if( !manifestReader.hasObject() )
+		{
+			return false;
+		}
+
+		UInt32 magic;
+		UInt32 version;
+		Array<String> dependencyFiles;
+
+		*manifestReader >> magic;
+		*manifestReader >> version;
+
+		if( magic != CACHE_MAGIC || version != CACHE_VERSION )
+		{
+			return false;
+		}
+
+		*manifestReader >> dependencyFiles;
+		manifestReader = nullptr;
+
+		// find entry by contents of these files
+		UInt64 contentKey;
+
+		if( !getContentKey( resourceId.getType(), compilerMark, dependencyFiles, contentKey ) )
+		{
+			return false;
+		}
+
+		String entryFileName = getFileName( contentKey, ENTRY_EXTENSION );
+		auto entryReader = fm::readBinaryFile( *entryFileName );
+
+		if( !entryReader.hasObject() )
+		{
+			return false;
+		}
+
+		UInt64 storedKey;
+
+		*entryReader >> magic;
+		*entryReader >> version;
+		*entryReader >> storedKey;
+
+		if( magic != CACHE_MAGIC || version != CACHE_VERSION || storedKey != contentKey )
+		{
+			return false;
+		}
+
+		*entryReader >> outEntry.dependencyFiles;
+		*entryReader >> outEntry.references;
+		*entryReader >> outEntry.compiledResource;
+		entryReader = nullptr;
+
+		if( !outEntry.compiledResource.isValid() )
+		{
+			return false;
+		}
+
+		// eviction goes by modification time, so mark hit files as recently used
+		fm::touchFile( *entryFileName );
+		fm::touchFile( *manifestFileName );
+
+		return true;
+	}
+
+	Bool CompileCache::save( ResourceId resourceId, String compilerMark, const CompilationOutput& output )
+	{
+		assert( !output.hasError() && output.compiledResource.isValid() );
+
+		UInt64 contentKey;
+
+		if( !getContentKey( resourceId.getType(), compilerMark, output.dependencyFiles, contentKey ) )
+		{
+			return false;
+		}
+
+		OwningBufferWriter entryWriter;
+		entryWriter << CACHE_MAGIC;
+		entryWriter << CACHE_VERSION;
+		entryWriter << contentKey;
+		entryWriter << output.dependencyFiles;
+		entryWriter << output.references;
+		entryWriter << output.compiledResource;
+
+		OwningBufferWriter manifestWriter;
+		manifestWriter << CACHE_MAGIC;
+		manifestWriter << CACHE_VERSION;
+		manifestWriter << output.dependencyFiles;
+
+		// entry goes first, so manifest never points to nothing
+		if( !writeFile( getFileName( contentKey, ENTRY_EXTENSION ), entryWriter.getData(), entryWriter.size() ) ||
+			!writeFile( getFileName( getManifestKey( resourceId, compilerMark ), MANIFEST_EXTENSION ), 
+				manifestWriter.getData(), manifestWriter.size() ) )
+		{
+			return false;
+		}
+
+		concurrency::CriticalSection::Guard guard( m_lock );
+		m_size += entryWriter.size() + manifestWriter.size();
+
+		if( m_size > m_capacity )
+		{
+			evict();
+		}
+
+		return true;
+	}
+
+	String CompileCache::getFileName( UInt64 key, const Char* extension ) const
+	{
+		return m_cachePath + String::format( TXT( "%016llx" ), key ) + extension;
+	}
+
+	UInt64 CompileCache::getManifestKey( ResourceId resourceId, String compilerMark ) const
+	{
+		OwningBufferWriter writer;
+		writer << CACHE_VERSION;
+		writer << resourceId;
+		writer << compilerMark;
+
+		return hashing::murmur64( writer.getData(), writer.size() );
+	}
+
+	Bool CompileCache::getContentKey( EResourceType type, String compilerMark, 
+		const Array<String>& dependencyFiles, UInt64& outKey ) const
+	{
+		OwningBufferWriter writer;
+		writer << CACHE_VERSION;
+		writer << type;
+		writer << compilerMark;
+
+		Array<UInt8> content;
+
+		for( const auto& it : dependencyFiles )
+		{
+			auto fileReader = fm::readBinaryFile( *( m_packagesPath + it ) );
+
+			if( !fileReader.hasObject() )
+			{
+				// dependency was removed
+				return false;
+			}
+
+			content.setSize( static_cast<Int32>( fileReader->totalSize() ) );
+
+			if( content.size() > 0 )
+			{
+				fileReader->readData( &content[0], content.size() );
+			}
+
+			writer << it;
+			writer << hashing::murmur64( content.size() > 0 ? &content[0] : nullptr, content.size() );
+		}
+
+		outKey = hashing::murmur64( writer.getData(), writer.size() );
+		return true;
+	}
+
+	Bool CompileCache::writeFile( String fileName, const void* data, SizeT dataSize )
+	{
+		// write to the temporary file first, cache may be shared between processes
+		String tempFileName = fileName + String::format( TXT( ".%u.%u.tmp" ), 
+			threading::getCurrentProcessId(), threading::getCurrentThreadId() );
+
+		{
+			auto fileWriter = fm::writeBinaryFile( *tempFileName );
+
+			if( !fileWriter.hasObject() )
+			{
+				return false;
+			}
+
+			fileWriter->writeData( data, dataSize );
+		}
+
+		if( fm::moveFile( *tempFileName, *fileName ) )
+		{
+			return true;
+		}
+		else
+		{
+			fm::deleteFile( *tempFileName );
+			return false;
+		}
+	}
+
+	void CompileCache::evict()
+	{
+		struct CachedFile
+		{
+			String fileName;
+			Int64 size;
+			Int64 modificationTime;
+		};
+
+		// directory may be changed by other processes, so rescan it. Manifests are
+		// evicted as well, a manifest without entry is just a cache miss
+		Array<CachedFile> files;
+		SizeT totalSize = 0;
+
+		// old cache files are never read
+		for( const auto& it : fm::findFiles( *m_cachePath, *( String( TXT( "*" ) ) + LEGACY_EXTENSION ) ) )
+		{
+			fm::deleteFile( *it );
+		}
+
+		for( const Char* extension : { ENTRY_EXTENSION, MANIFEST_EXTENSION } )
+		{
+			Array<String> fileNames = fm::findFiles( *m_cachePath, *( String( TXT( "*" ) ) + extension ) );
+
+			for( const auto& it : fileNames )
+			{
+				CachedFile file;
+				file.fileName = it;
+				file.size = max<Int64>( fm::getFileSize( *it ), 0 );
+				file.modificationTime = fm::getFileModificationTime( *it );
+
+				files.push( file );
+				totalSize += file.size;
+			}
+		}
+
+		if( totalSize > m_capacity )
+		{
+			// remove the least recently used until 3/4 of capacity
+			files.sort( []( const CachedFile& a, const CachedFile& b ) -> Bool
+			{
+				return a.modificationTime < b.modificationTime;
+			} );
+
+			const SizeT targetSize = m_capacity / 4 * 3;
+
+			for( const auto& it : files )
+			{
+				if( totalSize <= targetSize )
+				{
+					break;
+				}
+
+				if( fm::deleteFile( *it.fileName ) )
+				{
+					totalSize -= it.size;
+				}
+			}
+		}
+
+		m_size = totalSize;
+	}
+}
+}
@@ -0,0 +1,72 @@
+//-----------------------------------------------------------------------------
+//	CompileCache.h: A content-addressed cache of compiled resources
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+namespace res
+{
+	/**
+	 *	A content-addressed compilation cache. Compiled resources are keyed by
+	 *	hash of compiler mark and contents of all the files used for compilation,
+	 *	so the cache directory may be shared between working copies and machines
+	 */
+	class CompileCache final: public NonCopyable
+	{
+	public:
+		using UPtr = UniquePtr<CompileCache>;
+
+		/**
+		 *	A cached compilation result
+		 */
+		struct Entry
+		{
+		public:
+			Array<String> dependencyFiles;
+			Map<ResourceId, String> references;
+			CompiledResource compiledResource;
+		};
+
+		CompileCache( String cachePath, String packagesPath, SizeT capacity );
+		~CompileCache();
+
+		Bool load( ResourceId resourceId, String compilerMark, Entry& outEntry );
+		Bool save( ResourceId resourceId, String compilerMark, const CompilationOutput& output );
+
+		SizeT getSize() const
+		{
+			return m_size;
+		}
+
+	private:
+		static const UInt32 CACHE_MAGIC = 0x43434c46; // FLCC
+		static const UInt32 CACHE_VERSION = 1;
+
+		static constexpr const Char MANIFEST_EXTENSION[] = TXT( ".fman" );
+		static constexpr const Char ENTRY_EXTENSION[] = TXT( ".fres" );
+
+		// files of the old modification time based cache
+		static constexpr const Char LEGACY_EXTENSION[] = TXT( ".fcache" );
+
+		String m_cachePath;
+		String m_packagesPath;
+
+		SizeT m_size;
+		SizeT m_capacity;
+
+		concurrency::CriticalSection::UPtr m_lock;
+
+		CompileCache() = delete;
+
+		String getFileName( UInt64 key, const Char* extension ) const;
+
+		UInt64 getManifestKey( ResourceId resourceId, String compilerMark ) const;
+		Bool getContentKey( EResourceType type, String compilerMark, 
+			const Array<String>& dependencyFiles, UInt64& outKey ) const;
+
+		Bool writeFile( String fileName, const void* data, SizeT dataSize );
+		void evict();
+	};
+}
+}
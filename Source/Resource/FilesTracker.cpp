@@ -11,13 +11,24 @@ namespace res
 {
 	FilesTracker::FilesTracker( String directory )
 		:	m_trackedFiles(),
-			m_directory( directory )
+			m_directory( directory ),
+			m_watcher( nullptr ),
+			m_numChangedFiles( 0 ),
+			m_lastPollingTime( 0.0 )
 	{
 		assert( fm::directoryExists( *directory ) );
+
+		m_watcher = fm::watchDirectory( *directory );
+
+		if( !m_watcher.hasObject() )
+		{
+			warn( L"Unable to watch \"%s\", files will be polled", *directory );
+		}
 	}
 
 	FilesTracker::~FilesTracker()
 	{
+		m_watcher = nullptr;
 	}
 
 	void FilesTracker::addResourceFile( ResourceId resourceId, const Array<String> resourceFiles )
@@ -40,6 +51,7 @@ namespace res
 				File newTrackedFile;
 				newTrackedFile.lastModificationTime = fm::getFileModificationTime( *absoluteFileName );
 				newTrackedFile.resources.push( resourceId );
+				newTrackedFile.shortName = getShortName( it );
 
 				m_trackedFiles.put( it, newTrackedFile );
 			}		
@@ -62,6 +74,11 @@ namespace res
 
 		for( auto& it : filesToUntrack )
 		{
+			if( m_trackedFiles.get( it )->changeTime > 0.0 )
+			{
+				m_numChangedFiles--;
+			}
+
 			m_trackedFiles.remove( it );
 		}
 	}
@@ -69,34 +86,113 @@ namespace res
 	Array<ResourceId> FilesTracker::trackChanges()
 	{
 		Array<ResourceId> changedResources;
-	
-		for( auto& file : m_trackedFiles )
-		{
-			assert( file.value.resources.size() > 0 );
+		const Double now = time::cyclesToSec( time::cycles64() );
 
-			String fileName = m_directory + file.key;
+		if( m_watcher.hasObject() )
+		{
+			Array<String> changedFiles;
 
-			if( fm::fileExists( *fileName ) )
+			if( m_watcher->pollChanges( changedFiles ) )
 			{
-				Int64 fileTime = fm::getFileModificationTime( *fileName );
-
-				if( fileTime > file.value.lastModificationTime )
+				// notifications are matched by name only, because tracked names
+				// may be not canonical. Anyway files will be checked later
+				for( auto& it : changedFiles )
 				{
-					for( auto& res : file.value.resources )
+					String shortName = getShortName( it );
+
+					for( auto& file : m_trackedFiles )
 					{
-						changedResources.addUnique( res );
+						if( file.value.shortName == shortName )
+						{
+							markChanged( file.value, now );
+						}
 					}
-				
-					file.value.lastModificationTime = fileTime;
 				}
 			}
 			else
 			{
-				fatal( L"File \"%s\" removing is not allowed yet", *fileName );
+				// some notifications were lost
+				for( auto& file : m_trackedFiles )
+				{
+					markChanged( file.value, now );
+				}
+			}
+		}
+		else if( now - m_lastPollingTime >= POLLING_PERIOD_SEC )
+		{
+			// polling is slow enough, so don't debounce
+			for( auto& file : m_trackedFiles )
+			{
+				markChanged( file.value, now - DEBOUNCE_SEC );
+			}
+
+			m_lastPollingTime = now;
+		}
+
+		// report files which are settled down
+		if( m_numChangedFiles > 0 )
+		{
+			for( auto& file : m_trackedFiles )
+			{
+				if( file.value.changeTime > 0.0 && now - file.value.changeTime >= DEBOUNCE_SEC )
+				{
+					file.value.changeTime = 0.0;
+					m_numChangedFiles--;
+
+					if( checkFile( file.key, file.value ) )
+					{
+						for( auto& res : file.value.resources )
+						{
+							changedResources.addUnique( res );
+						}
+					}
+				}
 			}
 		}
 
 		return changedResources;
 	}
+
+	void FilesTracker::markChanged( File& file, Double time )
+	{
+		if( file.changeTime == 0.0 )
+		{
+			m_numChangedFiles++;
+		}
+
+		file.changeTime = time;
+	}
+
+	Bool FilesTracker::checkFile( const String& fileName, File& file )
+	{
+		String absoluteFileName = m_directory + fileName;
+
+		if( fm::fileExists( *absoluteFileName ) )
+		{
+			Int64 fileTime = fm::getFileModificationTime( *absoluteFileName );
+
+			// older file may be restored as well
+			if( fileTime != file.lastModificationTime )
+			{
+				file.lastModificationTime = fileTime;
+				return true;
+			}
+		}
+		else if( file.lastModificationTime != UNKNOWN_MODIFICATION_TIME )
+		{
+			// file will be tracked until it's back
+			warn( L"File \"%s\" was removed or renamed", *absoluteFileName );
+
+			file.lastModificationTime = UNKNOWN_MODIFICATION_TIME;
+			return true;
+		}
+
+		return false;
+	}
+
+	String FilesTracker::getShortName( String fileName )
+	{
+		return String::lowerCase( fm::getFileNameExt( *fm::normalizeFileName( *fileName ) ) );
+	}
 }
-}
\ No newline at end of file
+}
@@ -8,7 +8,8 @@ namespace flu
 namespace res
 {
 	/**
-	 *	FilesTracker
+	 *	FilesTracker. Uses OS notifications if possible and polls
+	 *	files modification time otherwise
 	 */
 	class FilesTracker final: public NonCopyable
 	{
@@ -21,22 +22,52 @@ namespace res
 		void addResourceFile( ResourceId resourceId, const Array<String> resourceFiles );
 		void removeResourceFiles( ResourceId resourceId );
 
+		/**
+		 *	Return resources which files were changed, removed or renamed.
+		 *	Cheap enough to be called every frame
+		 */
 		Array<ResourceId> trackChanges();
 
+		Bool isEventDriven() const
+		{
+			return m_watcher.hasObject();
+		}
+
 	private:
-		static const UInt64 UNKNOWN_MODIFICATION_TIME = 0;
+		static const Int64 UNKNOWN_MODIFICATION_TIME = 0;
+
+		// editors save files in a few steps, so wait for quiet
+		static constexpr Double DEBOUNCE_SEC = 0.1;
+
+		// fallback when there are no notifications
+		static constexpr Double POLLING_PERIOD_SEC = 2.0;
 
 		// single tracked file
 		struct File
 		{
 			Int64 lastModificationTime;
 			Array<ResourceId> resources;
+
+			// lower case name to match notifications
+			String shortName;
+
+			// time of the last notification, 0 if nothing happened
+			Double changeTime = 0.0;
 		};
 
 		Map<String, File> m_trackedFiles;
 		String m_directory;
 
+		fm::IDirectoryWatcher::UPtr m_watcher;
+		Int32 m_numChangedFiles;
+		Double m_lastPollingTime;
+
 		FilesTracker() = delete;
+
+		void markChanged( File& file, Double time );
+		Bool checkFile( const String& fileName, File& file );
+
+		static String getShortName( String fileName );
 	};
 }
-}
\ No newline at end of file
+}
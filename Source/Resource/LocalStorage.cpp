@@ -9,8 +9,9 @@ namespace flu
 {
 namespace res
 {
-	LocalStorage::LocalStorage( String packagesPath, String cachePath, Bool useCache )
-		:	m_listener( nullptr )
+	LocalStorage::LocalStorage( String packagesPath, String cachePath, Bool useCache, UInt32 cacheLimitMB )
+		:	m_listener( nullptr ),
+			m_lock( concurrency::CriticalSection::create() )
 	{
 		m_useCache = useCache;
 		m_packagesPath = fm::resolveFileName( *packagesPath, fm::EPathBase::Exe );
@@ -29,12 +30,18 @@ namespace res
 			}
 		}
 
+		if( m_useCache )
+		{
+			m_compileCache = new CompileCache( m_cachePath, m_packagesPath, SizeT( cacheLimitMB ) * 1024 * 1024 );
+		}
+
 		m_filesTracker = new FilesTracker( m_packagesPath );
 	}
 
 	LocalStorage::~LocalStorage()
 	{
 		m_filesTracker = nullptr;
+		m_compileCache = nullptr;
 
 		for( auto& it : m_compilers )
 		{
@@ -69,7 +76,11 @@ namespace res
 	CompiledResource LocalStorage::requestCompiledImpl( ResourceId resourceId, Bool allowCached )
 	{
 		// try to resolve ResourceId
-		String resourceName = m_namesResolver.getName( resourceId );
+		String resourceName;
+		{
+			concurrency::CriticalSection::Guard guard( m_lock );
+			resourceName = m_namesResolver.getName( resourceId );
+		}
 
 		if( resourceName )
 		{
@@ -117,11 +128,13 @@ namespace res
 
 	String LocalStorage::resolveResourceId( ResourceId resourceId )
 	{
+		concurrency::CriticalSection::Guard guard( m_lock );
 		return m_namesResolver.getName( resourceId );
 	}
 
 	Array<ResourceId> LocalStorage::trackChanges()
 	{
+		concurrency::CriticalSection::Guard guard( m_lock );
 		return m_filesTracker->trackChanges();
 	}
 
@@ -136,7 +149,11 @@ namespace res
 
 			if( system->allowHotReloading() )
 			{
-				String prettyName = m_namesResolver.getPrettyName( it );
+				String prettyName;
+				{
+					concurrency::CriticalSection::Guard guard( m_lock );
+					prettyName = m_namesResolver.getPrettyName( it );
+				}
 
 				if( m_listener )
 				{
@@ -162,107 +179,64 @@ namespace res
 
 	CompiledResource LocalStorage::loadFromCache( ResourceId resourceId, String resourceName )
 	{
-		assert( m_useCache && m_cachePath );
+		assert( m_useCache && m_compileCache.hasObject() );
 
-		String cacheFileName = m_cachePath + resourceId.toString() + CACHE_EXTENSION;
+		IResourceCompiler* compiler = getCompiler( resourceId.getType() );
+		assert( compiler );
 
-		if( fm::fileExists( *cacheFileName ) )
-		{
-			auto fileReader = fm::readBinaryFile( *cacheFileName );
+		CompileCache::Entry entry;
 
-			if( fileReader.hasObject() )
-			{
-				Array<String> dependencyFiles;
-				UInt64 lastModificationTime;
-				Map<ResourceId, String> references;
-				CompiledResource compiledResource;
-			
-				*fileReader >> dependencyFiles;
-				*fileReader >> lastModificationTime;
-				*fileReader >> references;
-				*fileReader >> compiledResource;
-
-				// validate cache
-				Bool isValidCache = true;
-				for( auto& it : dependencyFiles )
-				{
-					String itFileName = m_packagesPath + it;
+		if( m_compileCache->load( resourceId, compiler->compilerMark(), entry ) )
+		{
+			concurrency::CriticalSection::Guard guard( m_lock );
 
-					if( fm::fileExists( *itFileName ) )
-					{
-						UInt64 modificationTime = fm::getFileModificationTime( *itFileName );
-						if( modificationTime > lastModificationTime )
-						{
-							isValidCache = false;
-							break;
-						}
-					}
-					else
-					{
-						isValidCache = false;
-						break;
-					}
-				}
+			// start tracking dependency files
+			m_filesTracker->removeResourceFiles( resourceId );
+			m_filesTracker->addResourceFile( resourceId, entry.dependencyFiles );
 
-				// start tracking dependency files
-				if( isValidCache )
-				{
-					m_filesTracker->removeResourceFiles( resourceId );
-					m_filesTracker->addResourceFile( resourceId, dependencyFiles );
+			m_namesResolver.addName( resourceId, resourceName );
 
-					m_namesResolver.addName( resourceId, resourceName );
+			// store references info
+			for( const auto& it : entry.references )
+			{
+				m_namesResolver.addName( it.key, it.value );
+			}
 
-					// store references info
-					for( const auto& it : references )
-					{
-						m_namesResolver.addName( it.key, it.value );
-					}
+			if( m_listener )
+			{
+				m_listener->onInfo( resourceName, TXT( "found in cache" ) );
+			}
 
-					if( m_listener )
-					{
-						m_listener->onInfo( resourceName, TXT( "found in cache" ) );
-					}
+			CompiledResource compiledResource;
+			compiledResource.data = static_cast<Array<UInt8>&&>( entry.compiledResource.data );
 
-					return compiledResource;				
-				}
-				else
-				{
-					if( m_listener )
-					{
-						m_listener->onInfo( resourceName, TXT( "cache is out of date" ) );
-					}
-				}
-			}
+			return compiledResource;
+		}
+		else
+		{
+			// not found in cache
+			return CompiledResource();
 		}
-
-		// not found in cache
-		return CompiledResource();
 	}
 
 	void LocalStorage::saveToCache( ResourceId resourceId, String resourceName, const CompilationOutput& output )
 	{
-		assert( m_useCache && m_cachePath );
+		assert( m_useCache && m_compileCache.hasObject() );
 		assert( !output.hasError() && output.compiledResource.isValid() );
 
-		String cacheFileName = m_cachePath + resourceId.toString() + CACHE_EXTENSION;
-	
-		auto fileWriter = fm::writeBinaryFile( *cacheFileName );
+		IResourceCompiler* compiler = getCompiler( resourceId.getType() );
+		assert( compiler );
 
-		if( fileWriter.hasObject() )
+		if( m_compileCache->save( resourceId, compiler->compilerMark(), output ) )
 		{
-			*fileWriter << output.dependencyFiles;
-			*fileWriter << output.lastModificationTime;
-			*fileWriter << output.references;
-			*fileWriter << output.compiledResource;
-
 			if( m_listener )
-				m_listener->onInfo( resourceName, String::format( TXT( "Cache saved to \"%s\"" ), *cacheFileName ) );
+				m_listener->onInfo( resourceName, TXT( "cache saved" ) );
 		}
 		else
 		{
 			if( m_listener )
 				m_listener->onWarning( resourceName, 
-					String::format( TXT( "Unable save resource cache to \"%s\"" ), *cacheFileName ) );
+					String::format( TXT( "Unable save resource cache to \"%s\"" ), *m_cachePath ) );
 		}
 	}
 
@@ -379,6 +353,8 @@ namespace res
 				m_listener->onInfo( resourceName, String::format( L"compiled successfully in %.4f sec", 
 					time::elapsedSecFrom( startupTime ) ) );
 
+			concurrency::CriticalSection::Guard guard( m_lock );
+
 			m_namesResolver.addName( resourceId, resourceName );
 
 			// remember all references
@@ -9,14 +9,18 @@ namespace res
 {
 	/**
 	 *	A local storage, which compile, cache and reload resources
-	 *	from the disk ( working copy )
+	 *	from the disk ( working copy ). Resources may be requested from
+	 *	many threads at once, compilers should be thread-safe
 	 */
 	class LocalStorage: public IStorage
 	{
 	public:
 		using UPtr = UniquePtr<LocalStorage>;
 
-		LocalStorage( String packagesPath, String cachePath, Bool useCache );
+		static const UInt32 DEFAULT_CACHE_LIMIT_MB = 1024;
+
+		LocalStorage( String packagesPath, String cachePath, Bool useCache, 
+			UInt32 cacheLimitMB = DEFAULT_CACHE_LIMIT_MB );
 		~LocalStorage();
 
 		void registerCompiler( EResourceType type, IResourceCompiler* compiler );
@@ -42,19 +46,21 @@ namespace res
 			IListener& listener, Args... args );
 
 	private:
-		static constexpr const Char CACHE_EXTENSION[] = TXT( ".fcache" );
-
 		String m_packagesPath;
 		String m_cachePath;
 		Bool m_useCache;
 
 		FilesTracker::UPtr m_filesTracker;
+		CompileCache::UPtr m_compileCache;
 		NamesResolver m_namesResolver;
 
 		StaticArray<IResourceCompiler::UPtr, Resource::NUM_TYPES> m_compilers;
 
 		IListener* m_listener;
 
+		// guards names resolver and files tracker
+		concurrency::CriticalSection::UPtr m_lock;
+
 		LocalStorage() = delete;
 
 		CompiledResource requestCompiledImpl( EResourceType type, String resourceName, Bool allowCached );
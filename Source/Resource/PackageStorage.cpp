@@ -9,6 +9,8 @@ namespace flu
 {
 namespace res
 {
+	static const Int32 MAX_COMPILE_TASKS = 32;
+
 	PackageStorage::PackageStorage()
 		:	m_packages(),
 			m_resourceId2Package(),
@@ -299,13 +301,45 @@ namespace res
 				*writer << unused;
 			}
 
-			// compile each resource
+			// compile all package resources, resources are independent so
+			// spread them across job workers, local storage is thread safe
+			Array<CompiledResource> compiledResources( package.value.size() );
+			UInt64 compileTime = time::cycles64();
+
+			struct CompileContext
+			{
+				LocalStorage* localStorage;
+				const Array<ResourceInfo>* resources;
+				Array<CompiledResource>* compiled;
+			};
+
+			CompileContext context;
+			context.localStorage = localStorage;
+			context.resources = &package.value;
+			context.compiled = &compiledResources;
+
+			auto compileFunc = []( void* userData, Int32 taskIndex, Int32 first, Int32 last )
+			{
+				CompileContext* context = reinterpret_cast<CompileContext*>( userData );
+
+				for( Int32 i = first; i < last; ++i )
+				{
+					const ResourceInfo& resInfo = ( *context->resources )[i];
+					( *context->compiled )[i] = context->localStorage->requestCompiled( resInfo.resourceType, resInfo.resourceName );
+				}
+			};
+
+			job::parallelFor( package.value.size(), 1, min<Int32>( threading::getCPUCoresCount(), MAX_COMPILE_TASKS ), 
+				compileFunc, &context );
+
+			info( TXT( "Package \"%s\": %d resources compiled in %.2f sec" ), *package.key, 
+				package.value.size(), time::elapsedSecFrom( compileTime ) );
+
+			// write each resource
 			for( Int32 i = 0; i < package.value.size(); ++i )
 			{
 				const ResourceInfo& resInfo = package.value[i];
-
-				ListenerList listener;
-				CompiledResource compiledResource = localStorage->requestCompiled( resInfo.resourceType, resInfo.resourceName );
+				const CompiledResource& compiledResource = compiledResources[i];
 
 				if( !compiledResource.isValid() )
 				{
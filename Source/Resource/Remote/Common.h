@@ -13,6 +13,19 @@ namespace res
 	static const SizeT MAX_PACKET_SIZE = 16384;
 
 	/**
+	 *	Protocol versions. The first one sends resources by blocks with a
+	 *	round trip per block, the second one sends whole resources in a single
+	 *	frame and allows many requests in flight
+	 */
+	static const UInt32 PROTOCOL_VERSION_1 = 1;
+	static const UInt32 PROTOCOL_VERSION_2 = 2;
+	static const UInt32 CURRENT_PROTOCOL_VERSION = PROTOCOL_VERSION_2;
+
+	static const UInt32 MAX_FRAME_SIZE = 512 * 1024 * 1024;
+	static const UInt32 MIN_COMPRESSED_FRAME_SIZE = 1024;
+	static const UInt32 MAX_REQUESTS_IN_FLIGHT = 16;
+
+	/**
 	 *	A list of messages comming from server 
 	 */
 	enum class EServerMessage : UInt8
@@ -22,7 +35,8 @@ namespace res
 		ProvideResource,	// provide base resource information
 		NextResourceBlock,	// next resource block, if resource is too big
 		ResourceError,		// unable to provide requested resource
-		ResolvedName		// send resolved resource name
+		ResolvedName,		// send resolved resource name
+		AcceptInfo			// accepted protocol version, the last v1 message
 	};
 
 	/**
@@ -34,7 +48,8 @@ namespace res
 		RequestResourceById,	// request resource by ResourceId
 		RequestResourceByName,	// request resource by name
 		RequestNextBlock,		// request next resource block is resource is too big
-		ResolveName				// request name resolving
+		ResolveName,			// request name resolving
+		RequestBenchmark		// request a synthetic resource of the given size
 	};
 
 	/**
@@ -57,6 +72,25 @@ namespace res
 		UInt16 payloadSize;
 	};
 
+	/**
+	 *	A protocol v2 frame header, the same for both sides. Responses
+	 *	have the sequence number of their requests
+	 */
+	struct FrameHeader
+	{
+	public:
+		enum EFlags : UInt8
+		{
+			Compressed = 1 << 0		// payload is UInt32 raw size and compressed data
+		};
+
+		UInt8 message;
+		UInt8 flags;
+		UInt16 sequence;
+		UInt32 payloadSize;
+	};
+
+	static_assert( sizeof( FrameHeader ) == sizeof( UInt64 ), "FrameHeader size should be 8 bytes" );
 	static_assert( sizeof( ServerMessageHeader ) == sizeof( UInt32 ), "ServerMessageHeader size should be 4 bytes" );
 	static_assert( sizeof( ClientMessageHeader ) == sizeof( UInt32 ), "ClientMessageHeader size should be 4 bytes" );
 
@@ -0,0 +1,60 @@
+//-----------------------------------------------------------------------------
+//	Compression.cpp: A resource frames compression implementation
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Resource/Resource.h"
+
+namespace flu
+{
+namespace res
+{
+namespace compression
+{
+	Bool compressFrame( const void* data, SizeT dataSize, Array<UInt8>& frame )
+	{
+		const UInt32 rawSize = static_cast<UInt32>( dataSize );
+
+		frame.setSize( static_cast<Int32>( sizeof( UInt32 ) + lz::compressBound( dataSize ) ) );
+		mem::copy( &frame[0], &rawSize, sizeof( UInt32 ) );
+
+		// not worth if saves less than 1/8
+		const SizeT compressedSize = lz::compress( reinterpret_cast<const UInt8*>( data ), dataSize, 
+			&frame[sizeof( UInt32 )], dataSize - dataSize / 8 );
+
+		if( compressedSize > 0 )
+		{
+			frame.setSize( static_cast<Int32>( sizeof( UInt32 ) + compressedSize ) );
+			return true;
+		}
+		else
+		{
+			frame.empty();
+			return false;
+		}
+	}
+
+	Bool decompressFrame( const Array<UInt8>& frame, Array<UInt8>& data )
+	{
+		UInt32 rawSize;
+
+		if( frame.size() <= static_cast<Int32>( sizeof( UInt32 ) ) )
+		{
+			return false;
+		}
+
+		mem::copy( &rawSize, &frame[0], sizeof( UInt32 ) );
+
+		if( rawSize > MAX_FRAME_SIZE )
+		{
+			return false;
+		}
+
+		data.setSize( rawSize );
+
+		return lz::decompress( &frame[sizeof( UInt32 )], frame.size() - sizeof( UInt32 ), 
+			rawSize > 0 ? &data[0] : nullptr, rawSize );
+	}
+}
+}
+}
@@ -0,0 +1,24 @@
+//-----------------------------------------------------------------------------
+//	Compression.h: A resource frames compression
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+namespace res
+{
+namespace compression
+{
+	/**
+	 *	Compress a frame payload with lz codec, the result is UInt32 raw size
+	 *	followed by compressed data. Return false if data is incompressible
+	 */
+	extern Bool compressFrame( const void* data, SizeT dataSize, Array<UInt8>& frame );
+
+	/**
+	 *	Restore a compressed frame payload
+	 */
+	extern Bool decompressFrame( const Array<UInt8>& frame, Array<UInt8>& data );
+}
+}
+}
@@ -0,0 +1,101 @@
+//-----------------------------------------------------------------------------
+//	ResourceCache.cpp: An in-memory cache of compiled resources implementation
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Resource/Resource.h"
+
+namespace flu
+{
+namespace res
+{
+	ResourceCache::ResourceCache( SizeT capacity )
+		:	m_entries(),
+			m_size( 0 ),
+			m_capacity( capacity ),
+			m_accessCounter( 0 )
+	{
+	}
+
+	ResourceCache::~ResourceCache()
+	{
+		empty();
+	}
+
+	const CompiledResource* ResourceCache::get( ResourceId resourceId )
+	{
+		Entry* entry = m_entries.get( resourceId );
+
+		if( entry )
+		{
+			entry->lastAccess = ++m_accessCounter;
+			return &entry->resource;
+		}
+		else
+		{
+			return nullptr;
+		}
+	}
+
+	void ResourceCache::put( ResourceId resourceId, const CompiledResource& resource )
+	{
+		assert( resource.isValid() );
+
+		remove( resourceId );
+
+		const SizeT resourceSize = resource.data.size();
+
+		if( resourceSize > m_capacity )
+		{
+			// too large to be cached at all
+			return;
+		}
+
+		evict( resourceSize );
+
+		Entry entry;
+		entry.resource = resource;
+		entry.lastAccess = ++m_accessCounter;
+
+		m_entries.put( resourceId, entry );
+		m_size += resourceSize;
+	}
+
+	void ResourceCache::remove( ResourceId resourceId )
+	{
+		if( const Entry* entry = m_entries.get( resourceId ) )
+		{
+			m_size -= entry->resource.data.size();
+			m_entries.remove( resourceId );
+		}
+	}
+
+	void ResourceCache::empty()
+	{
+		m_entries.empty();
+		m_size = 0;
+	}
+
+	void ResourceCache::evict( SizeT requiredSize )
+	{
+		while( m_size + requiredSize > m_capacity && !m_entries.isEmpty() )
+		{
+			// find the least recently used, caches are not so big
+			const ResourceId* oldestId = nullptr;
+			UInt64 oldestAccess = -1;
+
+			for( const auto& it : m_entries )
+			{
+				if( it.value.lastAccess < oldestAccess )
+				{
+					oldestId = &it.key;
+					oldestAccess = it.value.lastAccess;
+				}
+			}
+
+			assert( oldestId );
+			remove( ResourceId( *oldestId ) );
+		}
+	}
+}
+}
@@ -0,0 +1,58 @@
+//-----------------------------------------------------------------------------
+//	ResourceCache.h: An in-memory cache of compiled resources
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+namespace res
+{
+	/**
+	 *	A size limited cache of compiled resources, the least
+	 *	recently used resources are evicted first
+	 */
+	class ResourceCache final: public NonCopyable
+	{
+	public:
+		ResourceCache( SizeT capacity );
+		~ResourceCache();
+
+		/**
+		 *	Return cached resource or nullptr if it's not in cache. The
+		 *	pointer is valid until the next cache modification
+		 */
+		const CompiledResource* get( ResourceId resourceId );
+
+		void put( ResourceId resourceId, const CompiledResource& resource );
+		void remove( ResourceId resourceId );
+		void empty();
+
+		SizeT getSize() const
+		{
+			return m_size;
+		}
+
+		SizeT getCapacity() const
+		{
+			return m_capacity;
+		}
+
+	private:
+		struct Entry
+		{
+			CompiledResource resource;
+			UInt64 lastAccess = 0;
+		};
+
+		Map<ResourceId, Entry> m_entries;
+
+		SizeT m_size;
+		SizeT m_capacity;
+		UInt64 m_accessCounter;
+
+		ResourceCache() = delete;
+
+		void evict( SizeT requiredSize );
+	};
+}
+}
@@ -9,7 +9,11 @@ namespace flu
 {
 namespace res
 {
-	ResourceClient::ResourceClient( String appName, const net::Address& serverAddress )
+	ResourceClient::ResourceClient( String appName, const net::Address& serverAddress, 
+		UInt32 protocolVersion, Bool useCompression )
+		:	m_protocolVersion( PROTOCOL_VERSION_1 ),
+			m_useCompression( useCompression ),
+			m_nextSequence( 0 )
 	{
 		m_tcpClient = net::NetworkManager::createTCPClient();
 		auto errorCode = m_tcpClient->connect( serverAddress );
@@ -47,15 +51,38 @@ namespace res
 			}
 		}
 
-		// send client data
+		// send client data, v1 clients send name only
 		{
 			OwningBufferWriter writer;
 			writer << appName;
 
+			if( protocolVersion >= PROTOCOL_VERSION_2 )
+			{
+				writer << protocolVersion;
+				writer << useCompression;
+			}
+
 			sendClientMessage( EClientMessage::ProvideInfo, writer.getData(), writer.size() );
 		}
 
-		info( L"Resource Server accepted this client" );
+		// wait for protocol agreement
+		if( protocolVersion >= PROTOCOL_VERSION_2 )
+		{
+			ServerMessageHeader header;
+			Array<UInt8> data;
+
+			receiveServerMessage( header, data );
+
+			if( header.message != EServerMessage::AcceptInfo )
+			{
+				fatal( L"Unexpected server respond %d", header.message );
+			}
+
+			BufferReader reader( data );
+			reader >> m_protocolVersion;
+		}
+
+		info( L"Resource Server accepted this client with protocol v%d", m_protocolVersion );
 	}
 
 	ResourceClient::~ResourceClient()
@@ -70,22 +97,25 @@ namespace res
 	Array<ResourceId> ResourceClient::trackChanges()
 	{
 		// check if something changed outside
-		ServerMessageHeader header;
-		Array<UInt8> data;
+		Response response;
 
-		if( receiveServerMessage( header, data, false ) == EReceiveResult::Ok )
+		while( receiveMessage( response, false ) == EReceiveResult::Ok )
 		{
-			assert( header.message == EServerMessage::NotifyReload );
+			assert( response.message == EServerMessage::NotifyReload );
 
-			BufferReader reader( data );
+			BufferReader reader( response.data );
 
 			Array<ResourceId> changedResources;
 			reader >> changedResources;
 
-			return changedResources;
+			for( auto& it : changedResources )
+			{
+				m_pendingChanges.addUnique( it );
+			}
 		}
 
-		return Array<ResourceId>();
+		Array<ResourceId> result = static_cast<Array<ResourceId>&&>( m_pendingChanges );
+		return result;
 	}
 
 	CompiledResource ResourceClient::requestCompiled( EResourceType type, String resourceName )
@@ -94,8 +124,8 @@ namespace res
 		writer << type;
 		writer << resourceName;
 
-		sendClientMessage( EClientMessage::RequestResourceByName, writer.getData(), writer.size() );
-		return receiveResource();
+		UInt16 sequence = sendRequest( EClientMessage::RequestResourceByName, writer.getData(), writer.size() );
+		return receiveResource( sequence );
 	}
 
 	CompiledResource ResourceClient::requestCompiled( ResourceId resourceId )
@@ -103,20 +133,37 @@ namespace res
 		OwningBufferWriter writer;
 		writer << resourceId;
 
-		sendClientMessage( EClientMessage::RequestResourceById, writer.getData(), writer.size() );
-		return receiveResource();
+		UInt16 sequence = sendRequest( EClientMessage::RequestResourceById, writer.getData(), writer.size() );
+		return receiveResource( sequence );
+	}
+
+	Array<CompiledResource> ResourceClient::requestCompiled( const Array<ResourceId>& resourceIds )
+	{
+		Array<Array<UInt8>> requests;
+		requests.setSize( resourceIds.size() );
+
+		for( Int32 i = 0; i < resourceIds.size(); ++i )
+		{
+			UserBufferWriter writer( requests[i] );
+			writer << resourceIds[i];
+		}
+
+		return requestPipelined( EClientMessage::RequestResourceById, requests );
 	}
 
 	String ResourceClient::resolveResourceId( ResourceId resourceId )
 	{
-		sendClientMessage( EClientMessage::ResolveName, &resourceId, sizeof( ResourceId ) );
+		UInt16 sequence = sendRequest( EClientMessage::ResolveName, &resourceId, sizeof( ResourceId ) );
 		
-		ServerMessageHeader header;
-		Array<UInt8> data;
+		Response response;
+		receiveResponse( sequence, response );
 
-		receiveServerMessage( header, data );
+		if( response.message != EServerMessage::ResolvedName )
+		{
+			fatal( L"Unexpected server respond %d", response.message );
+		}
 
-		BufferReader reader( data );
+		BufferReader reader( response.data );
 		String resourceName;
 
 		reader >> resourceName;
@@ -124,10 +171,82 @@ namespace res
 		return resourceName;
 	}
 
-	CompiledResource ResourceClient::receiveResource()
+	Double ResourceClient::benchmark( UInt32 resourceSize, Int32 numRequests )
+	{
+		Array<Array<UInt8>> requests;
+		requests.setSize( numRequests );
+
+		for( Int32 i = 0; i < numRequests; ++i )
+		{
+			UserBufferWriter writer( requests[i] );
+			writer << resourceSize;
+		}
+
+		const UInt64 startTime = time::cycles64();
+		Array<CompiledResource> resources = requestPipelined( EClientMessage::RequestBenchmark, requests );
+		const Double elapsedTime = time::elapsedSecFrom( startTime );
+
+		for( auto& it : resources )
+		{
+			if( static_cast<UInt32>( it.data.size() ) != resourceSize )
+			{
+				fatal( L"Benchmark resource size mismatch %d != %d", it.data.size(), resourceSize );
+			}
+		}
+
+		return ( Double( resourceSize ) * numRequests / ( 1024.0 * 1024.0 ) ) / max( elapsedTime, 1e-6 );
+	}
+
+	Array<CompiledResource> ResourceClient::requestPipelined( EClientMessage message, const Array<Array<UInt8>>& requests )
+	{
+		Array<CompiledResource> result;
+		result.setSize( requests.size() );
+
+		// v1 server keeps a single transfer per client
+		const Int32 maxInFlight = m_protocolVersion >= PROTOCOL_VERSION_2 ? MAX_REQUESTS_IN_FLIGHT : 1;
+
+		UInt16 firstSequence = m_nextSequence;
+		Int32 numSent = 0;
+
+		for( Int32 numReceived = 0; numReceived < requests.size(); ++numReceived )
+		{
+			// keep the window full
+			for( ; numSent < requests.size() && numSent - numReceived < maxInFlight; ++numSent )
+			{
+				const Array<UInt8>& request = requests[numSent];
+				sendRequest( message, request.size() > 0 ? &request[0] : nullptr, request.size() );
+			}
+
+			result[numReceived] = receiveResource( static_cast<UInt16>( firstSequence + numReceived ) );
+		}
+
+		return result;
+	}
+
+	CompiledResource ResourceClient::receiveResource( UInt16 sequence )
 	{
 		CompiledResource compiledResource;
 
+		if( m_protocolVersion >= PROTOCOL_VERSION_2 )
+		{
+			// whole resource in a single frame
+			Response response;
+			receiveResponse( sequence, response );
+
+			if( response.message == EServerMessage::ResourceError )
+			{
+				// resource missing
+				return CompiledResource();
+			}
+			else if( response.message != EServerMessage::ProvideResource )
+			{
+				fatal( L"Unexpected server respond %d", response.message );
+			}
+
+			compiledResource.data = static_cast<Array<UInt8>&&>( response.data );
+			return compiledResource;
+		}
+
 		Int32 resourceSize = 0;
 		Int32 resourceBytesTransferred = 0;
 
@@ -135,34 +254,36 @@ namespace res
 		{
 			// read block of resource data
 			{
-				ServerMessageHeader header;
-				Array<UInt8> data;
+				Response response;
+				receiveResponse( sequence, response );
 
-				receiveServerMessage( header, data );
+				BufferReader reader( response.data );
 
-				BufferReader reader( data );
-
-				if( header.message == EServerMessage::ResourceError )
+				if( response.message == EServerMessage::ResourceError )
 				{
 					// resource missing
 					return CompiledResource();
 				}
-				else if( header.message == EServerMessage::ProvideResource && resourceSize == 0 )
+				else if( response.message == EServerMessage::ProvideResource && resourceSize == 0 )
 				{
 					reader >> resourceSize;
 					compiledResource.data.setSize( resourceSize );
 				}
-				else if( header.message == EServerMessage::NextResourceBlock && resourceSize > 0 )
+				else if( response.message == EServerMessage::NextResourceBlock && resourceSize > 0 )
 				{
 				}
 				else
 				{
-					fatal( L"Unexpected server respond %d", header.message );
+					fatal( L"Unexpected server respond %d", response.message );
 				}
 
 				// insert new data to compiled resource
 				UInt32 bytesReceived = reader.totalSize() - reader.tell();
-				reader.readData( &compiledResource.data[resourceBytesTransferred], bytesReceived );
+
+				if( bytesReceived > 0 )
+				{
+					reader.readData( &compiledResource.data[resourceBytesTransferred], bytesReceived );
+				}
 
 				resourceBytesTransferred += bytesReceived;
 
@@ -180,6 +301,131 @@ namespace res
 		return compiledResource;
 	}
 
+	UInt16 ResourceClient::sendRequest( EClientMessage message, const void* data, SizeT dataSize )
+	{
+		const UInt16 sequence = m_nextSequence++;
+
+		if( m_protocolVersion >= PROTOCOL_VERSION_2 )
+		{
+			sendFrame( message, sequence, data, dataSize );
+		}
+		else
+		{
+			sendClientMessage( message, data, dataSize );
+		}
+
+		return sequence;
+	}
+
+	void ResourceClient::receiveResponse( UInt16 sequence, Response& response )
+	{
+		// server compiles in parallel, so responses may come out of order
+		for( Int32 i = 0; i < m_earlyResponses.size(); ++i )
+		{
+			if( m_earlyResponses[i].sequence == sequence )
+			{
+				response.message = m_earlyResponses[i].message;
+				response.sequence = m_earlyResponses[i].sequence;
+				response.data = static_cast<Array<UInt8>&&>( m_earlyResponses[i].data );
+
+				m_earlyResponses.removeShift( i );
+				return;
+			}
+		}
+
+		while( true )
+		{
+			receiveMessage( response, true );
+
+			if( response.message == EServerMessage::NotifyReload )
+			{
+				// not a response, keep it for trackChanges
+				BufferReader reader( response.data );
+
+				Array<ResourceId> changedResources;
+				reader >> changedResources;
+
+				for( auto& it : changedResources )
+				{
+					m_pendingChanges.addUnique( it );
+				}
+			}
+			else
+			{
+				if( m_protocolVersion >= PROTOCOL_VERSION_2 && response.sequence != sequence )
+				{
+					// keep it for later
+					m_earlyResponses.setSize( m_earlyResponses.size() + 1 );
+					Response& earlyResponse = m_earlyResponses.last();
+
+					earlyResponse.message = response.message;
+					earlyResponse.sequence = response.sequence;
+					earlyResponse.data = static_cast<Array<UInt8>&&>( response.data );
+				}
+				else
+				{
+					return;
+				}
+			}
+		}
+	}
+
+	ResourceClient::EReceiveResult ResourceClient::receiveMessage( Response& response, Bool blocking )
+	{
+		if( m_protocolVersion < PROTOCOL_VERSION_2 )
+		{
+			ServerMessageHeader header;
+			EReceiveResult result = receiveServerMessage( header, response.data, blocking );
+
+			response.message = header.message;
+			response.sequence = 0;
+			return result;
+		}
+
+		FrameHeader header;
+		SizeT bytesReceived;
+
+		if( m_tcpClient->receiveData( &header, sizeof( FrameHeader ), bytesReceived, blocking ) != net::EError::Ok )
+		{
+			fatal( L"Resource Server was disconnected" );
+		}
+
+		if( bytesReceived == 0 )
+		{
+			assert( !blocking );
+			return EReceiveResult::Pending;
+		}
+
+		assert( bytesReceived == sizeof( FrameHeader ) );
+
+		if( header.payloadSize > MAX_FRAME_SIZE )
+		{
+			fatal( L"Too large frame %u from Resource Server", header.payloadSize );
+		}
+
+		response.message = static_cast<EServerMessage>( header.message );
+		response.sequence = header.sequence;
+		response.data.setSize( header.payloadSize );
+
+		if( header.payloadSize > 0 && 
+			m_tcpClient->receiveData( &response.data[0], header.payloadSize, bytesReceived, true ) != net::EError::Ok )
+		{
+			fatal( L"Unexpected end of server request" );
+		}
+
+		if( header.flags & FrameHeader::Compressed )
+		{
+			Array<UInt8> compressedData = static_cast<Array<UInt8>&&>( response.data );
+
+			if( !compression::decompressFrame( compressedData, response.data ) )
+			{
+				fatal( L"Corrupted frame from Resource Server" );
+			}
+		}
+
+		return EReceiveResult::Ok;
+	}
+
 	ResourceClient::EReceiveResult ResourceClient::receiveServerMessage( ServerMessageHeader& header, Array<UInt8>& data, Bool blocking )
 	{
 		SizeT bytesReceived;
@@ -213,8 +459,9 @@ namespace res
 		{
 			// unable to read header
 			fatal( L"Resource Server was disconnected" );
-			return EReceiveResult::Pending;
 		}
+
+		return EReceiveResult::Pending;
 	}
 
 	void ResourceClient::sendClientMessage( EClientMessage message, const void* data, SizeT dataSize )
@@ -244,5 +491,32 @@ namespace res
 			fatal( L"Server connection was interrupted" );
 		}
 	}
+
+	void ResourceClient::sendFrame( EClientMessage message, UInt16 sequence, const void* data, SizeT dataSize )
+	{
+		assert( dataSize <= MAX_FRAME_SIZE );
+
+		FrameHeader header;
+		header.message = static_cast<UInt8>( message );
+		header.flags = 0;
+		header.sequence = sequence;
+		header.payloadSize = static_cast<UInt32>( dataSize );
+
+		// requests are small, so send them as a single packet
+		OwningBufferWriter writer;
+		writer.writeData( &header, sizeof( FrameHeader ) );
+		
+		if( data && dataSize > 0 )
+		{
+			writer.writeData( data, dataSize );
+		}
+
+		SizeT bytesSended;
+		if( m_tcpClient->sendData( writer.getData(), writer.size(), bytesSended, true ) != net::EError::Ok )
+		{
+			// send failed
+			fatal( L"Server connection was interrupted" );
+		}
+	}
 }
 }
\ No newline at end of file
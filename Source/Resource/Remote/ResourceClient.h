@@ -15,7 +15,8 @@ namespace res
 	public:
 		using UPtr = UniquePtr<ResourceClient>;
 
-		ResourceClient( String appName, const net::Address& serverAddress );
+		ResourceClient( String appName, const net::Address& serverAddress, 
+			UInt32 protocolVersion = CURRENT_PROTOCOL_VERSION, Bool useCompression = false );
 		~ResourceClient();
 
 		Array<ResourceId> trackChanges();
@@ -23,14 +24,56 @@ namespace res
 		CompiledResource requestCompiled( EResourceType type, String resourceName );
 		CompiledResource requestCompiled( ResourceId resourceId );
 
+		/**
+		 *	Request many resources at once, with protocol v2 requests are
+		 *	pipelined and responses are streamed back to back
+		 */
+		Array<CompiledResource> requestCompiled( const Array<ResourceId>& resourceIds );
+
 		String resolveResourceId( ResourceId resourceId );
 
+		/**
+		 *	Request synthetic resources of the given size,
+		 *	return transfer speed in MB/s
+		 */
+		Double benchmark( UInt32 resourceSize, Int32 numRequests );
+
+		UInt32 getProtocolVersion() const
+		{
+			return m_protocolVersion;
+		}
+
 	private:
 		static const UInt32 NET_IDLING_MS = 3;
 
 		net::TCPClient::UPtr m_tcpClient;
 
-		CompiledResource receiveResource();
+		UInt32 m_protocolVersion;
+		Bool m_useCompression;
+		UInt16 m_nextSequence;
+
+		// notifications received while waiting for responses
+		Array<ResourceId> m_pendingChanges;
+
+		/**
+		 *	A server response, the same for all protocol versions
+		 */
+		struct Response
+		{
+		public:
+			EServerMessage message;
+			UInt16 sequence;
+			Array<UInt8> data;
+		};
+
+		// v2 responses that overtook the awaited one
+		Array<Response> m_earlyResponses;
+
+		Array<CompiledResource> requestPipelined( EClientMessage message, const Array<Array<UInt8>>& requests );
+		CompiledResource receiveResource( UInt16 sequence );
+
+		UInt16 sendRequest( EClientMessage message, const void* data, SizeT dataSize );
+		void receiveResponse( UInt16 sequence, Response& response );
 
 		enum EReceiveResult
 		{
@@ -38,8 +81,11 @@ namespace res
 			Pending
 		};
 
+		EReceiveResult receiveMessage( Response& response, Bool blocking );
+
 		EReceiveResult receiveServerMessage( ServerMessageHeader& header, Array<UInt8>& data, Bool blocking = true );
 		void sendClientMessage( EClientMessage message, const void* data, SizeT dataSize );
+		void sendFrame( EClientMessage message, UInt16 sequence, const void* data, SizeT dataSize );
 	};
 }
 }
\ No newline at end of file
@@ -28,18 +28,43 @@ namespace res
 		String packagesPath = ConfigManager::readString( EConfigFile::Application, TXT("ResourceManager"), TXT("PackagesPath") );
 		String cachePath = ConfigManager::readString( EConfigFile::Application, TXT("ResourceManager"), TXT("CachePath") );
 		Bool useCache = ConfigManager::readBool( EConfigFile::Application, TXT("ResourceManager"), TXT("UseCache") );
+		UInt32 cacheLimitMB = ConfigManager::readInt( EConfigFile::Application, TXT("ResourceManager"), TXT("CacheLimitMB"), 
+			LocalStorage::DEFAULT_CACHE_LIMIT_MB );
 
-		instance().m_localStorage = new LocalStorage( packagesPath, cachePath, useCache );
+		instance().m_localStorage = new LocalStorage( packagesPath, cachePath, useCache, cacheLimitMB );
 		instance().m_localStorage->setListener( &instance().m_logListener );
 
+		// create shared memory cache
+		UInt32 cacheSizeMB = ConfigManager::readInt( EConfigFile::Application, TXT("ResourceServer"), 
+			TXT("CacheSizeMB"), DEFAULT_CACHE_SIZE_MB );
+
+		instance().m_resourceCache = new ResourceCache( SizeT( cacheSizeMB ) * 1024 * 1024 );
+
+		// start compilation threads
+		Int32 numCompileThreads = ConfigManager::readInt( EConfigFile::Application, TXT("ResourceServer"), 
+			TXT("NumCompileThreads"), max<Int32>( threading::getCPUCoresCount() - 1, 1 ) );
+
+		numCompileThreads = max( numCompileThreads, 1 );
+
+		instance().m_pendingJobsLock = concurrency::CriticalSection::create();
+		instance().m_pendingJobsSemaphore = concurrency::Semaphore::create( 0 );
+		instance().m_finishedJobsLock = concurrency::CriticalSection::create();
+		instance().m_exitCompileThreads.setValue( 0 );
+
+		instance().m_compileThreads.setSize( numCompileThreads );
+
+		for( Int32 i = 0; i < numCompileThreads; ++i )
+		{
+			instance().m_compileThreads[i] = threading::Thread::create( &compileThreadEntry, &instance(), 
+				*AnsiString::format( "Resource Compile Thread %d", i ) );
+		}
+
 		String hostName;
 		net::Address addr = net::NetworkManager::getLocalIP( &hostName );
 		addr.port = port;
 
-		instance().m_timeToTrackRemain = FILES_TRACKING_PERIOD_SEC;
-		instance().m_lastTickTime = time::cycles64();
-
-		info( L"Resource Server started successfully at \"%s\" %s", *hostName, *addr.toString() );
+		info( L"Resource Server started successfully at \"%s\" %s with %d compile threads", 
+			*hostName, *addr.toString(), numCompileThreads );
 		instance().m_isInitialized = true;
 		return true;
 	}
@@ -48,6 +73,32 @@ namespace res
 	{
 		assert( instance().m_isInitialized );
 
+		// stop compilation threads
+		instance().m_exitCompileThreads.setValue( 1 );
+		instance().m_pendingJobsSemaphore->push( instance().m_compileThreads.size() );
+
+		for( auto& it : instance().m_compileThreads )
+		{
+			it->wait();
+		}
+
+		instance().m_compileThreads.empty();
+
+		for( auto& it : instance().m_activeJobs )
+		{
+			delete it;
+		}
+
+		instance().m_activeJobs.empty();
+		instance().m_pendingJobs.empty();
+		instance().m_finishedJobs.empty();
+
+		instance().m_pendingJobsLock = nullptr;
+		instance().m_pendingJobsSemaphore = nullptr;
+		instance().m_finishedJobsLock = nullptr;
+
+		instance().m_resourceCache = nullptr;
+
 		instance().m_tcpServer->shutdown();
 		instance().m_tcpServer = nullptr;
 		instance().m_clients.empty();
@@ -71,23 +122,19 @@ namespace res
 		// poll new clients
 		instance().pollClients();
 
-		// track changed files
-		UInt64 thisTickTime = time::cycles64();
-		Double deltaTime = time::cyclesToSec( thisTickTime - instance().m_lastTickTime );
-		instance().m_lastTickTime = thisTickTime;
+		// track changed files, tracker is cheap when nothing happens
+		Array<ResourceId> changedResources = instance().m_localStorage->trackChanges();
 
-		Array<ResourceId> changedResources;
-		if( ( instance().m_timeToTrackRemain -= deltaTime ) < 0.0 )
+		if( changedResources.size() > 0 )
 		{
-			// time to track
-			changedResources = instance().m_localStorage->trackChanges();
-
-			if( changedResources.size() > 0 )
-			{
-				info( L"%d resources were changed...", changedResources.size() );
-			}
+			info( L"%d resources were changed...", changedResources.size() );
+			instance().invalidateResources( changedResources );
+		}
 
-			instance().m_timeToTrackRemain = FILES_TRACKING_PERIOD_SEC;
+		// send compiled resources
+		if( instance().finishCompileJobs() )
+		{
+			wasProcessed = true;
 		}
 
 		// serve all clients, warning client may disconnect
@@ -118,8 +165,8 @@ namespace res
 			m_localStorage( nullptr ),
 			m_tcpServer( nullptr ),
 			m_clients(),
-			m_lastTickTime( 0 ),
-			m_timeToTrackRemain( 0.f )
+			m_resourceCache( nullptr ),
+			m_exitCompileThreads( 0 )
 	{
 	}
 
@@ -166,7 +213,25 @@ namespace res
 			String clientInfo;
 			reader >> clientInfo;
 
-			info( L"Client: \"%s\" %s accepted", *clientInfo, *client.address.toString() );
+			// old clients send their name only
+			if( !reader.isEof() )
+			{
+				UInt32 clientVersion;
+				reader >> clientVersion;
+				reader >> client.useCompression;
+
+				client.protocolVersion = min( clientVersion, CURRENT_PROTOCOL_VERSION );
+
+				OwningBufferWriter writer;
+				writer << client.protocolVersion;
+
+				if( !sendServerMessage( client.id, EServerMessage::AcceptInfo, writer.getData(), writer.size() ) )
+				{
+					return false;
+				}
+			}
+
+			info( L"Client: \"%s\" %s accepted with protocol v%d", *clientInfo, *client.address.toString(), client.protocolVersion );
 			client.status = Client::EStatus::Accepted;
 
 			wasProcessed = true;
@@ -181,38 +246,31 @@ namespace res
 
 	Bool ResourceServer::serveAccepted( Client& client, const Array<ResourceId>& changedResources, Bool& wasProcessed )
 	{
-		// Handle all requests
-		{
-			ClientMessageHeader header;
-			Array<UInt8> data;
+		// Handle all requests, pipelined clients may send many of them
+		const UInt32 maxRequests = client.protocolVersion >= PROTOCOL_VERSION_2 ? MAX_REQUESTS_IN_FLIGHT : 1;
 
-			EReceiveResult result = receiveClientMessage( client.id, header, data, false );
+		for( UInt32 i = 0; i < maxRequests; ++i )
+		{
+			Request request;
+			EReceiveResult result = receiveRequest( client, request, false );
 
 			if( result == EReceiveResult::Ok )
 			{
 				wasProcessed = true;
 
-				switch( header.message )
+				if( !handleRequest( client, request ) )
 				{
-					case EClientMessage::RequestResourceById:
-					case EClientMessage::RequestResourceByName:
-						return handleRequestResource( client, header, data );
-
-					case EClientMessage::RequestNextBlock:
-						return handleRequestBlock( client, header, data );
-
-					case EClientMessage::ResolveName:
-						return handleResolveName( client, header, data );
-
-					default:
-						warn( L"Unexpected message from %s", *client.address.toString() );
-						return false;
+					return false;
 				}
 			}
 			else if( result == EReceiveResult::Failed )
 			{
 				return false;
 			}
+			else
+			{
+				break;
+			}
 		}
 
 		// Send changes notification
@@ -223,66 +281,134 @@ namespace res
 			OwningBufferWriter writer;
 			writer << changedResources;
 
-			assert( writer.size() <= MAX_PACKET_SIZE - sizeof( ServerMessageHeader ) );
-			return sendServerMessage( client.id, EServerMessage::NotifyReload, writer.getData(), writer.size() );
+			if( client.protocolVersion >= PROTOCOL_VERSION_2 )
+			{
+				return sendFrame( client.id, static_cast<UInt8>( EServerMessage::NotifyReload ), 0, 
+					writer.getData(), writer.size(), false );
+			}
+			else
+			{
+				assert( writer.size() <= MAX_PACKET_SIZE - sizeof( ServerMessageHeader ) );
+				return sendServerMessage( client.id, EServerMessage::NotifyReload, writer.getData(), writer.size() );
+			}
 		}
 
 		return true;
 	}
 
-	Bool ResourceServer::handleRequestResource( Client& client, const ClientMessageHeader& reqHeader, const Array<UInt8>& reqData )
+	Bool ResourceServer::handleRequest( Client& client, const Request& request )
+	{
+		switch( request.message )
+		{
+			case EClientMessage::RequestResourceById:
+			case EClientMessage::RequestResourceByName:
+				return handleRequestResource( client, request );
+
+			case EClientMessage::RequestNextBlock:
+				return handleRequestBlock( client, request );
+
+			case EClientMessage::ResolveName:
+				return handleResolveName( client, request );
+
+			case EClientMessage::RequestBenchmark:
+				return handleRequestBenchmark( client, request );
+
+			default:
+				warn( L"Unexpected message from %s", *client.address.toString() );
+				return false;
+		}
+	}
+
+	Bool ResourceServer::handleRequestResource( Client& client, const Request& request )
 	{
-		BufferReader reader( reqData );
+		BufferReader reader( request.data );
 
-		CompiledResource compiledResource;
-		ListenerList nullListener; // todo: get rid of it!!
+		ResourceId resId;
+		String resName;
 
-		// try to compile or load
-		if( reqHeader.message == EClientMessage::RequestResourceById )
+		if( request.message == EClientMessage::RequestResourceById )
 		{
-			ResourceId resId;
 			reader >> resId;
 
 			info( L"Client: %s requested resource %s", *client.name, *resId.toString() );
-			compiledResource = m_localStorage->requestCompiled( resId );
+
+			if( !m_localStorage->resolveResourceId( resId ) )
+			{
+				warn( L"Client: %s request denied, unknown resource", *client.name );
+				return sendResponse( client, request, EServerMessage::ResourceError, nullptr, 0 );
+			}
 		}
-		else if( reqHeader.message == EClientMessage::RequestResourceByName )
+		else
 		{
 			EResourceType resType;
-			String resName;
 
 			reader >> resType;
 			reader >> resName;
 
 			info( L"Client: %s requested resource \"%s\"", *client.name, *resName );
-			compiledResource = m_localStorage->requestCompiled( resType, resName );
+			resId = ResourceId( resType, resName );
 		}
 
-		assert( client.resourceBytesRemain == 0 );
+		// try memory cache first, empty entry is a miss
+		const CompiledResource* cachedResource = m_resourceCache->get( resId );
 
-		if( compiledResource.isValid() )
+		if( cachedResource && cachedResource->isValid() )
 		{
-			client.resourceData = compiledResource.data;
-			client.resourceBytesRemain = compiledResource.data.size();
-			client.transferStartTime = time::cycles64();
+			return sendResource( client, request, &cachedResource->data[0], cachedResource->data.size(), true );
+		}
 
-			OwningBufferWriter writer;
-			writer << compiledResource.data.size();
+		// compile or load on the worker thread
+		startCompileJob( client, request, resId, resName );
+		return true;
+	}
 
-			Int32 bytesToSend = min<Int32>( client.resourceBytesRemain, MAX_PACKET_SIZE - writer.size() - sizeof( ServerMessageHeader ) );
-			assert( bytesToSend <= MAX_PACKET_SIZE );
+	Bool ResourceServer::handleRequestBenchmark( Client& client, const Request& request )
+	{
+		BufferReader reader( request.data );
 
-			writer.writeData( &client.resourceData[client.resourceData.size() - client.resourceBytesRemain], bytesToSend );
+		UInt32 resourceSize;
+		reader >> resourceSize;
 
-			if( sendServerMessage( client.id, EServerMessage::ProvideResource, writer.getData(), writer.size() ) )
-			{	
-				info( L"\ttransferring: %d/%d bytes..", client.resourceData.size() - client.resourceBytesRemain, client.resourceData.size() );
-				client.resourceBytesRemain -= bytesToSend;
+		if( reader.hasError() || resourceSize > MAX_BENCHMARK_SIZE )
+		{
+			warn( L"Client: %s bad benchmark request", *client.name );
+			return false;
+		}
 
-				if( client.resourceBytesRemain == 0 )
+		// texture-like data, neither random nor constant. Pattern is repeated to keep
+		// generation cheap, data is released right after the reply
+		Array<UInt8> benchmarkData( resourceSize );
+		const Int32 patternSize = min<Int32>( benchmarkData.size(), BENCHMARK_PATTERN_SIZE );
+		UInt32 seed = 0x1234567;
+
+		for( Int32 i = 0; i < patternSize; ++i )
+		{
+			seed = seed * 1103515245 + 12345;
+			benchmarkData[i] = static_cast<UInt8>( ( i & 0xff ) ^ ( i >> 10 ) ^ ( ( seed >> 16 ) & 0x0f ) );
+		}
+
+		for( Int32 i = patternSize; i < benchmarkData.size(); i += patternSize )
+		{
+			mem::copy( &benchmarkData[i], &benchmarkData[0], min<Int32>( patternSize, benchmarkData.size() - i ) );
+		}
+
+		return sendResource( client, request, resourceSize > 0 ? &benchmarkData[0] : nullptr, resourceSize, false );
+	}
+
+	Bool ResourceServer::sendResource( Client& client, const Request& request, const UInt8* data, Int32 dataSize, Bool verbose )
+	{
+		if( client.protocolVersion >= PROTOCOL_VERSION_2 )
+		{
+			// whole resource in a single frame
+			const UInt64 transferStartTime = time::cycles64();
+
+			if( sendResponse( client, request, EServerMessage::ProvideResource, data, dataSize, true ) )
+			{
+				if( verbose )
 				{
-					info( L"\tdone in %.4f sec", time::elapsedSecFrom( client.transferStartTime ) );
+					info( L"\tdone %d bytes in %.4f sec", dataSize, time::elapsedSecFrom( transferStartTime ) );
 				}
+
 				return true;
 			}
 			else
@@ -290,16 +416,51 @@ namespace res
 				return false;
 			}
 		}
+
+		assert( client.resourceBytesRemain == 0 );
+
+		client.resourceData.setSize( dataSize );
+		mem::copy( client.resourceData.size() > 0 ? &client.resourceData[0] : nullptr, data, dataSize );
+
+		client.resourceBytesRemain = dataSize;
+		client.transferStartTime = time::cycles64();
+
+		OwningBufferWriter writer;
+		writer << dataSize;
+
+		Int32 bytesToSend = min<Int32>( client.resourceBytesRemain, MAX_PACKET_SIZE - writer.size() - sizeof( ServerMessageHeader ) );
+		assert( bytesToSend <= MAX_PACKET_SIZE );
+
+		if( bytesToSend > 0 )
+		{
+			writer.writeData( &client.resourceData[client.resourceData.size() - client.resourceBytesRemain], bytesToSend );
+		}
+
+		if( sendServerMessage( client.id, EServerMessage::ProvideResource, writer.getData(), writer.size() ) )
+		{	
+			if( verbose )
+			{
+				info( L"\ttransferring: %d/%d bytes..", client.resourceData.size() - client.resourceBytesRemain, client.resourceData.size() );
+			}
+
+			client.resourceBytesRemain -= bytesToSend;
+
+			if( client.resourceBytesRemain == 0 && verbose )
+			{
+				info( L"\tdone in %.4f sec", time::elapsedSecFrom( client.transferStartTime ) );
+			}
+
+			return true;
+		}
 		else
 		{
-			warn( L"Client: %s request denied", *client.name );
-			return sendServerMessage( client.id, EServerMessage::ResourceError, nullptr, 0 );
+			return false;
 		}
 	}
 
-	Bool ResourceServer::handleRequestBlock( Client& client, const ClientMessageHeader& reqHeader, const Array<UInt8>& reqData )
+	Bool ResourceServer::handleRequestBlock( Client& client, const Request& request )
 	{
-		if( client.resourceData.size() > 0 && client.resourceBytesRemain > 0 )
+		if( client.protocolVersion < PROTOCOL_VERSION_2 && client.resourceData.size() > 0 && client.resourceBytesRemain > 0 )
 		{
 			Int32 bytesToSend = min<Int32>( client.resourceBytesRemain, MAX_PACKET_SIZE - sizeof( ServerMessageHeader ) );
 			assert( bytesToSend <= MAX_PACKET_SIZE );
@@ -307,14 +468,12 @@ namespace res
 			if( sendServerMessage( client.id, EServerMessage::NextResourceBlock, 
 				&client.resourceData[client.resourceData.size() - client.resourceBytesRemain], bytesToSend ) )
 			{
-				info( L"\ttransferring: %d/%d bytes..", client.resourceData.size() - client.resourceBytesRemain, client.resourceData.size() );
-
 				client.resourceBytesRemain -= bytesToSend;
 				assert( client.resourceBytesRemain >= 0 );
 
 				if( client.resourceBytesRemain == 0 )
 				{
-					info( L"\tdone in %.4f sec", time::elapsedSecFrom( client.transferStartTime ) );
+					client.resourceData.empty();
 				}
 
 				return true;
@@ -331,9 +490,9 @@ namespace res
 		}
 	}
 
-	Bool ResourceServer::handleResolveName( Client& client, const ClientMessageHeader& reqHeader, const Array<UInt8>& reqData )
+	Bool ResourceServer::handleResolveName( Client& client, const Request& request )
 	{
-		BufferReader reader( reqData );
+		BufferReader reader( request.data );
 		
 		ResourceId resourceId;
 		reader >> resourceId;
@@ -346,7 +505,67 @@ namespace res
 
 		info( L"Client: %s requested resolve %s -> \"%s\"", *client.name, *resourceId.toString(), *resourceName );
 
-		return sendServerMessage( client.id, EServerMessage::ResolvedName, writer.getData(), writer.size() );
+		return sendResponse( client, request, EServerMessage::ResolvedName, writer.getData(), writer.size() );
+	}
+
+	ResourceServer::EReceiveResult ResourceServer::receiveRequest( Client& client, Request& request, Bool blocking )
+	{
+		if( client.protocolVersion < PROTOCOL_VERSION_2 )
+		{
+			ClientMessageHeader header;
+			EReceiveResult result = receiveClientMessage( client.id, header, request.data, blocking );
+
+			request.message = header.message;
+			request.sequence = 0;
+			return result;
+		}
+
+		FrameHeader header;
+		SizeT bytesReceived;
+
+		if( m_tcpServer->receiveData( client.id, &header, sizeof( FrameHeader ), bytesReceived, blocking ) != net::EError::Ok )
+		{
+			// unable to read header
+			return EReceiveResult::Failed;
+		}
+
+		if( bytesReceived == 0 )
+		{
+			// nothing to read yet
+			return EReceiveResult::Pending;
+		}
+
+		assert( bytesReceived == sizeof( FrameHeader ) );
+
+		if( header.payloadSize > MAX_FRAME_SIZE )
+		{
+			warn( L"Client: %s sent too large frame %u", *client.name, header.payloadSize );
+			return EReceiveResult::Failed;
+		}
+
+		request.message = static_cast<EClientMessage>( header.message );
+		request.sequence = header.sequence;
+		request.data.setSize( header.payloadSize );
+
+		if( header.payloadSize > 0 && 
+			m_tcpServer->receiveData( client.id, &request.data[0], header.payloadSize, bytesReceived, true ) != net::EError::Ok )
+		{
+			// unable to receive data
+			return EReceiveResult::Failed;
+		}
+
+		if( header.flags & FrameHeader::Compressed )
+		{
+			Array<UInt8> compressedData = static_cast<Array<UInt8>&&>( request.data );
+
+			if( !compression::decompressFrame( compressedData, request.data ) )
+			{
+				warn( L"Client: %s sent corrupted frame", *client.name );
+				return EReceiveResult::Failed;
+			}
+		}
+
+		return EReceiveResult::Ok;
 	}
 
 	ResourceServer::EReceiveResult ResourceServer::receiveClientMessage( net::TCPServer::ClientId id,
@@ -389,6 +608,20 @@ namespace res
 		}
 	}
 
+	Bool ResourceServer::sendResponse( Client& client, const Request& request, EServerMessage message, 
+		const void* data, SizeT dataSize, Bool allowCompression )
+	{
+		if( client.protocolVersion >= PROTOCOL_VERSION_2 )
+		{
+			return sendFrame( client.id, static_cast<UInt8>( message ), request.sequence, data, dataSize, 
+				allowCompression && client.useCompression );
+		}
+		else
+		{
+			return sendServerMessage( client.id, message, data, dataSize );
+		}
+	}
+
 	Bool ResourceServer::sendServerMessage( net::TCPServer::ClientId id, EServerMessage message, const void* data, SizeT dataSize )
 	{
 		assert( dataSize < MAX_PACKET_SIZE );
@@ -418,6 +651,184 @@ namespace res
 		}
 	}
 
+	Bool ResourceServer::sendFrame( net::TCPServer::ClientId id, UInt8 message, UInt16 sequence, 
+		const void* data, SizeT dataSize, Bool allowCompression )
+	{
+		assert( dataSize <= MAX_FRAME_SIZE );
+
+		FrameHeader header;
+		header.message = message;
+		header.flags = 0;
+		header.sequence = sequence;
+		header.payloadSize = static_cast<UInt32>( dataSize );
+
+		Array<UInt8> compressedData;
+
+		if( allowCompression && dataSize >= MIN_COMPRESSED_FRAME_SIZE && 
+			compression::compressFrame( data, dataSize, compressedData ) )
+		{
+			header.flags |= FrameHeader::Compressed;
+			header.payloadSize = compressedData.size();
+			data = &compressedData[0];
+		}
+
+		// payload is sent as is, without copying
+		SizeT bytesSended;
+		if( m_tcpServer->sendData( id, &header, sizeof( FrameHeader ), bytesSended, true ) != net::EError::Ok )
+		{
+			return false;
+		}
+
+		if( header.payloadSize > 0 && 
+			m_tcpServer->sendData( id, data, header.payloadSize, bytesSended, true ) != net::EError::Ok )
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	void ResourceServer::startCompileJob( Client& client, const Request& request, ResourceId resourceId, String resourceName )
+	{
+		CompileJob::Waiter waiter;
+		waiter.clientId = client.id;
+		waiter.request.message = request.message;
+		waiter.request.sequence = request.sequence;
+
+		// wait for the same compilation
+		for( auto& it : m_activeJobs )
+		{
+			if( it->resourceId == resourceId && !it->isOutdated )
+			{
+				it->waiters.push( waiter );
+				return;
+			}
+		}
+
+		CompileJob* job = new CompileJob();
+		job->resourceId = resourceId;
+		job->resourceName = resourceName;
+		job->waiters.push( waiter );
+
+		m_activeJobs.push( job );
+
+		{
+			concurrency::CriticalSection::Guard guard( m_pendingJobsLock );
+			m_pendingJobs.push( job );
+		}
+
+		m_pendingJobsSemaphore->push();
+	}
+
+	Bool ResourceServer::finishCompileJobs()
+	{
+		Array<CompileJob*> finishedJobs;
+		{
+			concurrency::CriticalSection::Guard guard( m_finishedJobsLock );
+			finishedJobs = static_cast<Array<CompileJob*>&&>( m_finishedJobs );
+		}
+
+		for( auto& job : finishedJobs )
+		{
+			m_activeJobs.removeUnique( job, true );
+
+			const CompiledResource& result = job->result;
+
+			// files were changed during compilation, so don't share it
+			if( result.isValid() && !job->isOutdated )
+			{
+				m_resourceCache->put( job->resourceId, result );
+			}
+
+			for( auto& waiter : job->waiters )
+			{
+				// client may disconnect while waiting
+				Client* client = findClient( waiter.clientId );
+
+				if( !client )
+				{
+					continue;
+				}
+
+				if( result.isValid() )
+				{
+					sendResource( *client, waiter.request, &result.data[0], result.data.size(), true );
+				}
+				else
+				{
+					warn( L"Client: %s request denied", *client->name );
+					sendResponse( *client, waiter.request, EServerMessage::ResourceError, nullptr, 0 );
+				}
+			}
+
+			delete job;
+		}
+
+		return finishedJobs.size() > 0;
+	}
+
+	void ResourceServer::invalidateResources( const Array<ResourceId>& changedResources )
+	{
+		for( const auto& resourceId : changedResources )
+		{
+			m_resourceCache->remove( resourceId );
+
+			for( auto& job : m_activeJobs )
+			{
+				if( job->resourceId == resourceId )
+				{
+					job->isOutdated = true;
+				}
+			}
+		}
+	}
+
+	void ResourceServer::compileThreadEntry( void* context )
+	{
+		ResourceServer* server = reinterpret_cast<ResourceServer*>( context );
+
+		while( server->m_exitCompileThreads.getValue() == 0 )
+		{
+			server->m_pendingJobsSemaphore->pop();
+
+			CompileJob* job = nullptr;
+			{
+				concurrency::CriticalSection::Guard guard( server->m_pendingJobsLock );
+
+				if( server->m_pendingJobs.size() > 0 )
+				{
+					job = server->m_pendingJobs[0];
+					server->m_pendingJobs.removeShift( 0 );
+				}
+			}
+
+			if( job )
+			{
+				CompiledResource result = job->resourceName ? 
+					server->m_localStorage->requestCompiled( job->resourceId.getType(), job->resourceName ) :
+					server->m_localStorage->requestCompiled( job->resourceId );
+
+				job->result.data = static_cast<Array<UInt8>&&>( result.data );
+
+				concurrency::CriticalSection::Guard guard( server->m_finishedJobsLock );
+				server->m_finishedJobs.push( job );
+			}
+		}
+	}
+
+	ResourceServer::Client* ResourceServer::findClient( net::TCPServer::ClientId id )
+	{
+		for( auto& it : m_clients )
+		{
+			if( it.id == id )
+			{
+				return &it;
+			}
+		}
+
+		return nullptr;
+	}
+
 	UInt32 ResourceServer::pollClients()
 	{
 		auto incomingClientId = m_tcpServer->pollConnection();
@@ -8,7 +8,9 @@ namespace flu
 namespace res
 {
 	/**
-	 *	A resource server based on TCP
+	 *	A resource server based on TCP. Clients are served on the thread
+	 *	which calls processRequests, while resources are compiled on the
+	 *	worker threads and shared between all clients via memory cache
 	 */
 	class ResourceServer final: public NonCopyable
 	{
@@ -20,6 +22,8 @@ namespace res
 
 		static Bool processRequests();
 
+		static const UInt16 DEFAULT_LISTENING_PORT = 28280;
+
 	private:
 		struct Client
 		{
@@ -36,16 +40,54 @@ namespace res
 
 			EStatus status;
 
-			// resource transfer
+			// negotiated protocol
+			UInt32 protocolVersion = PROTOCOL_VERSION_1;
+			Bool useCompression = false;
+
+			// resource transfer, protocol v1 only
 			Array<UInt8> resourceData;
 			Int32 resourceBytesRemain = 0;
 			UInt64 transferStartTime = 0;
 		};
 
-	private:
-		static const UInt16 DEFAULT_LISTENING_PORT = 28280;
+		/**
+		 *	A client request, the same for all protocol versions
+		 */
+		struct Request
+		{
+		public:
+			EClientMessage message;
+			UInt16 sequence;
+			Array<UInt8> data;
+		};
+
+		/**
+		 *	A resource compilation, all clients requested the same
+		 *	resource wait for the single job
+		 */
+		struct CompileJob
+		{
+		public:
+			struct Waiter
+			{
+				net::TCPServer::ClientId clientId;
+				Request request;
+			};
 
-		static constexpr Double FILES_TRACKING_PERIOD_SEC = 2.f;
+			ResourceId resourceId;
+			String resourceName; // empty if requested by id
+
+			CompiledResource result;
+
+			// touched by serving thread only
+			Array<Waiter> waiters;
+			Bool isOutdated = false;
+		};
+
+	private:
+		static const UInt32 MAX_BENCHMARK_SIZE = 16 * 1024 * 1024;
+		static const UInt32 BENCHMARK_PATTERN_SIZE = 64 * 1024;
+		static const UInt32 DEFAULT_CACHE_SIZE_MB = 256;
 
 		Bool m_isInitialized;
 	
@@ -54,22 +96,43 @@ namespace res
 		net::TCPServer::UPtr m_tcpServer;
 		Array<Client> m_clients;
 
-		UInt64 m_lastTickTime;
-		Double m_timeToTrackRemain;
+		UniquePtr<ResourceCache> m_resourceCache;
+		Array<CompileJob*> m_activeJobs;
+
+		Array<CompileJob*> m_pendingJobs;
+		concurrency::CriticalSection::UPtr m_pendingJobsLock;
+		concurrency::Semaphore::UPtr m_pendingJobsSemaphore;
+
+		Array<CompileJob*> m_finishedJobs;
+		concurrency::CriticalSection::UPtr m_finishedJobsLock;
+
+		Array<threading::Thread::UPtr> m_compileThreads;
+		concurrency::Atomic m_exitCompileThreads;
 
 		ResourceServer();
 		~ResourceServer();
 
 		UInt32 pollClients();
+		Client* findClient( net::TCPServer::ClientId id );
+
+		void startCompileJob( Client& client, const Request& request, ResourceId resourceId, String resourceName );
+		Bool finishCompileJobs();
+		void invalidateResources( const Array<ResourceId>& changedResources );
+
+		static void compileThreadEntry( void* context );
 
 		Bool serveClient( Client& client, const Array<ResourceId>& changedResources, Bool& wasProcessed );
 
 		Bool serveUnverified( Client& client, Bool& wasProcessed );
 		Bool serveAccepted( Client& client, const Array<ResourceId>& changedResources, Bool& wasProcessed );
 
-		Bool handleRequestResource( Client& client, const ClientMessageHeader& reqHeader, const Array<UInt8>& reqData );
-		Bool handleRequestBlock( Client& client, const ClientMessageHeader& reqHeader, const Array<UInt8>& reqData );
-		Bool handleResolveName( Client& client, const ClientMessageHeader& reqHeader, const Array<UInt8>& reqData );
+		Bool handleRequest( Client& client, const Request& request );
+		Bool handleRequestResource( Client& client, const Request& request );
+		Bool handleRequestBlock( Client& client, const Request& request );
+		Bool handleResolveName( Client& client, const Request& request );
+		Bool handleRequestBenchmark( Client& client, const Request& request );
+
+		Bool sendResource( Client& client, const Request& request, const UInt8* data, Int32 dataSize, Bool verbose );
 
 		enum EReceiveResult
 		{
@@ -78,10 +141,17 @@ namespace res
 			Failed
 		};
 
+		EReceiveResult receiveRequest( Client& client, Request& request, Bool blocking );
+
 		EReceiveResult receiveClientMessage( net::TCPServer::ClientId id, ClientMessageHeader& header, 
 			Array<UInt8>& data, Bool blocking );
 
+		Bool sendResponse( Client& client, const Request& request, EServerMessage message, 
+			const void* data, SizeT dataSize, Bool allowCompression = false );
+
 		Bool sendServerMessage( net::TCPServer::ClientId id, EServerMessage message, const void* data, SizeT dataSize );
+		Bool sendFrame( net::TCPServer::ClientId id, UInt8 message, UInt16 sequence, 
+			const void* data, SizeT dataSize, Bool allowCompression );
 
 		static ResourceServer& instance();
 
@@ -17,7 +17,10 @@ namespace res
 			fatal( L"Bad ResourceServer address \"%s\"", *serverAddress );
 		}
 
-		m_client = new ResourceClient( ConfigManager::getApplicationName(), address );
+		Bool useCompression = ConfigManager::readBool( EConfigFile::Application, TXT("ResourceManager"), TXT("RemoteCompression") );
+
+		m_client = new ResourceClient( ConfigManager::getApplicationName(), address, 
+			CURRENT_PROTOCOL_VERSION, useCompression );
 
 		m_listener = nullptr;
 	}
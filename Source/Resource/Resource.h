@@ -16,9 +16,12 @@
 #include "ResourceCompiler.h"
 #include "ResourceSystem.h"
 #include "FilesTracker.h"
+#include "CompileCache.h"
 #include "Package.h"
 
 #include "Remote/Common.h"
+#include "Remote/Compression.h"
+#include "Remote/ResourceCache.h"
 #include "Remote/ResourceClient.h"
 #include "Remote/ResourceServer.h"
 
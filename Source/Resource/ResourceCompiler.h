@@ -61,6 +61,12 @@ namespace res
 			CompilationOutput& output ) const = 0;
 
 		virtual Bool isSupportedFile( String relativePath ) const = 0;
+
+		/**
+		 *	A compiler version, change it whenever compiled data changes.
+		 *	It's a part of the compilation cache key
+		 */
+		virtual String compilerMark() const = 0;
 	};
 }
 }
\ No newline at end of file
@@ -77,8 +77,10 @@ namespace res
 			String packagesPath = ConfigManager::readString( EConfigFile::Application, TXT("ResourceManager"), TXT("PackagesPath") );
 			String cachePath = ConfigManager::readString( EConfigFile::Application, TXT("ResourceManager"), TXT("CachePath") );
 			Bool useCache = ConfigManager::readString( EConfigFile::Application, TXT("ResourceManager"), TXT("UseCache") );
+			UInt32 cacheLimitMB = ConfigManager::readInt( EConfigFile::Application, TXT("ResourceManager"), TXT("CacheLimitMB"), 
+				LocalStorage::DEFAULT_CACHE_LIMIT_MB );
 
-			m_localStorage = new LocalStorage( packagesPath, cachePath, useCache );
+			m_localStorage = new LocalStorage( packagesPath, cachePath, useCache, cacheLimitMB );
 			m_storage = m_localStorage.get();
 		}
 		else if( storageType == TXT("PACKAGE") )
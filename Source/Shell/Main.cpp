@@ -80,9 +80,9 @@ Int32 wmain( Int32 ArgC, Char *ArgV[] )
 	using namespace flu;
 	using namespace flu::shell;
 
-	LogManager::instance().addCallback( new LogCallbackFile( L"Shell.log" ) );
-	LogManager::instance().addCallback( new LogCallbackDebug( IsDebuggerPresent() ) );
-	LogManager::instance().addCallback( new LogCallbackShell() );
+	LogManager::instance().addAsyncCallback( new LogCallbackFile( L"Shell.log" ) );
+	LogManager::instance().addAsyncCallback( new LogCallbackDebug( IsDebuggerPresent() ) );
+	LogManager::instance().addAsyncCallback( new LogCallbackShell() );
 
 	// say hello to user
 	info( L"========================="			);
@@ -104,6 +104,10 @@ Int32 wmain( Int32 ArgC, Char *ArgV[] )
 	{
 		app = new ResourceServerApp();
 	}
+	else if( String::pos( TXT("resource_benchmark"), commandLine ) != -1 )
+	{
+		app = new ResourceBenchmarkApp();
+	}
 	else
 	{
 		// ...
@@ -0,0 +1,108 @@
+//-----------------------------------------------------------------------------
+//	ResourceBenchmarkApp.cpp: A resource protocol benchmark app implementation
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Shell.h"
+
+namespace flu
+{
+namespace shell
+{
+	ResourceBenchmarkApp::ResourceBenchmarkApp()
+		:	m_stopServer( 0 )
+	{
+	}
+
+	ResourceBenchmarkApp::~ResourceBenchmarkApp()
+	{
+	}
+
+	Bool ResourceBenchmarkApp::create( String commandLine )
+	{
+		// initialize network
+		if( !net::NetworkManager::create() )
+		{
+			return false;
+		}
+
+		// initialize resource server, no compilers required
+		if( !res::ResourceServer::create() )
+		{
+			return false;
+		}
+
+		m_serverThread = threading::Thread::create( serverThreadMain, this, "ResourceServer" );
+
+		info( L"ResourceBenchmarkApp successfully initialized" );
+		return true;
+	}
+
+	Bool ResourceBenchmarkApp::destroy()
+	{
+		if( m_serverThread.hasObject() )
+		{
+			m_stopServer.setValue( 1 );
+			m_serverThread->wait();
+			m_serverThread = nullptr;
+		}
+
+		res::ResourceServer::destroy();
+		net::NetworkManager::destroy();
+
+		info( L"ResourceBenchmarkApp shutdown" );
+		return true;
+	}
+
+	Int32 ResourceBenchmarkApp::run()
+	{
+		struct Mode
+		{
+			const Char* name;
+			UInt32 protocolVersion;
+			Bool useCompression;
+		};
+
+		static const Mode MODES[] =
+		{
+			{ TXT("v1"), res::PROTOCOL_VERSION_1, false },
+			{ TXT("v2"), res::PROTOCOL_VERSION_2, false },
+			{ TXT("v2 compressed"), res::PROTOCOL_VERSION_2, true }
+		};
+
+		UInt16 port = ConfigManager::readInt( EConfigFile::Application, TXT("ResourceServer"), 
+			TXT("Port"), res::ResourceServer::DEFAULT_LISTENING_PORT );
+
+		net::Address address( 0x7f000001, port );
+
+		for( const auto& mode : MODES )
+		{
+			res::ResourceClient client( TXT("ResourceBenchmark"), address, mode.protocolVersion, mode.useCompression );
+
+			for( UInt32 resourceSize = MIN_RESOURCE_SIZE; resourceSize <= MAX_RESOURCE_SIZE; resourceSize *= 4 )
+			{
+				const Int32 numRequests = clamp<Int32>( BYTES_PER_MODE / resourceSize / 4, 4, 1024 );
+				const Double throughput = client.benchmark( resourceSize, numRequests );
+
+				info( L"Resource %s: %8d KB x %4d requests: %.2f MB/s", 
+					mode.name, resourceSize / 1024, numRequests, throughput );
+			}
+		}
+
+		return 0;
+	}
+
+	void ResourceBenchmarkApp::serverThreadMain( void* arg )
+	{
+		ResourceBenchmarkApp* app = reinterpret_cast<ResourceBenchmarkApp*>( arg );
+
+		while( app->m_stopServer.getValue() == 0 )
+		{
+			if( !res::ResourceServer::processRequests() )
+			{
+				threading::sleep( SERVER_IDLE_MS );
+			}
+		}
+	}
+}
+}
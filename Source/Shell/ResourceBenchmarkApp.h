@@ -0,0 +1,37 @@
+//-----------------------------------------------------------------------------
+//	ResourceBenchmarkApp.h: A resource protocol benchmark app
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+namespace flu
+{
+namespace shell
+{
+	/**
+	 *	An app which runs the resource server and measures transfer
+	 *	speed of all protocol versions over loopback
+	 */
+	class ResourceBenchmarkApp: public IApp
+	{
+	public:
+		ResourceBenchmarkApp();
+		~ResourceBenchmarkApp();
+
+		Bool create( String commandLine ) override;
+		Bool destroy() override;
+
+		Int32 run() override;
+
+	private:
+		static const UInt32 SERVER_IDLE_MS = 1;
+		static const UInt32 MIN_RESOURCE_SIZE = 1024;
+		static const UInt32 MAX_RESOURCE_SIZE = 16 * 1024 * 1024;
+		static const UInt32 BYTES_PER_MODE = 256 * 1024 * 1024;
+
+		threading::Thread::UPtr m_serverThread;
+		concurrency::Atomic m_stopServer;
+
+		static void serverThreadMain( void* arg );
+	};
+}
+}
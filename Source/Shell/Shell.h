@@ -29,4 +29,5 @@
 
 // Shell includes
 #include "IApp.h"
-#include "ResourceServerApp.h"
\ No newline at end of file
+#include "ResourceServerApp.h"
+#include "ResourceBenchmarkApp.h"
\ No newline at end of file
@@ -0,0 +1,116 @@
+//-----------------------------------------------------------------------------
+//	Test_AtlasPacker.cpp: Sprites atlas packing tests
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Tests.h"
+
+namespace flu
+{
+namespace tests
+{
+	static const Int32 NUM_SPRITES = 100;
+
+	static Bool isRectsOverlapped( const img::AtlasRect& a, const img::AtlasRect& b, Int32 border )
+	{
+		return a.x - border < b.x + b.width + border && b.x - border < a.x + a.width + border &&
+			a.y - border < b.y + b.height + border && b.y - border < a.y + a.height + border;
+	}
+
+	void test_AtlasPacker()
+	{
+		enter_unit( AtlasPacker );
+
+		// raw packer keeps all rectangles inside and apart
+		{
+			img::AtlasPacker packer( 256, 256 );
+			Array<img::AtlasRect> rects;
+
+			for( Int32 i = 0; i < NUM_SPRITES; ++i )
+			{
+				img::AtlasRect rect;
+
+				if( packer.insert( 4 + Random( 28 ), 4 + Random( 28 ), rect ) )
+				{
+					check( rect.x >= 0 && rect.y >= 0 && rect.x + rect.width <= 256 && rect.y + rect.height <= 256 );
+
+					for( const auto& it : rects )
+					{
+						check( !isRectsOverlapped( it, rect, 0 ) );
+					}
+
+					rects.push( rect );
+				}
+			}
+
+			check( rects.size() > 0 );
+			info( L"Packer: %d rects, occupancy %.2f", rects.size(), packer.getOccupancy() );
+		}
+
+		// atlas with extruded and aligned cells
+		Array<Array<math::Color>> images( NUM_SPRITES );
+		Array<img::AtlasSource> sources( NUM_SPRITES );
+
+		for( Int32 i = 0; i < NUM_SPRITES; ++i )
+		{
+			sources[i].width = 1 << ( 2 + Random( 5 ) );
+			sources[i].height = 1 << ( 2 + Random( 5 ) );
+
+			images[i].setSize( sources[i].width * sources[i].height );
+
+			for( auto& it : images[i] )
+			{
+				it = math::Color( Random( 256 ), Random( 256 ), Random( 256 ), 255 );
+			}
+
+			sources[i].image = &images[i][0];
+		}
+
+		img::AtlasSettings settings;
+		Array<math::Color> atlas;
+		Array<img::AtlasRect> regions;
+		Int32 width = 0;
+		Int32 height = 0;
+
+		check( img::buildAtlas( sources, settings, atlas, width, height, regions ) );
+		check( isPowerOfTwo( width ) && isPowerOfTwo( height ) );
+		check( regions.size() == NUM_SPRITES );
+
+		const Int32 alignment = 1 << settings.mipSafeLevels;
+
+		for( Int32 i = 0; i < regions.size(); ++i )
+		{
+			const img::AtlasRect& region = regions[i];
+			const Int32 extrusion = settings.extrusion;
+
+			check( region.width == sources[i].width && region.height == sources[i].height );
+			check( ( region.x - extrusion ) % alignment == 0 && ( region.y - extrusion ) % alignment == 0 );
+
+			for( Int32 j = 0; j < i; ++j )
+			{
+				check( !isRectsOverlapped( regions[j], region, extrusion ) );
+			}
+
+			// image and its extruded edges
+			for( Int32 y = -extrusion; y < region.height + extrusion; ++y )
+			{
+				for( Int32 x = -extrusion; x < region.width + extrusion; ++x )
+				{
+					const Int32 u = clamp( x, 0, region.width - 1 );
+					const Int32 v = clamp( y, 0, region.height - 1 );
+
+					check( atlas[( region.y + y ) * width + region.x + x] == images[i][v * region.width + u] );
+				}
+			}
+		}
+
+		info( L"Atlas: %d sprites in %dx%d", NUM_SPRITES, width, height );
+
+		// too small atlas
+		settings.maxSize = 64;
+		check( !img::buildAtlas( sources, settings, atlas, width, height, regions ) );
+
+		leave_unit;
+	}
+}
+}
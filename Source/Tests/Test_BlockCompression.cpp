@@ -0,0 +1,146 @@
+//-----------------------------------------------------------------------------
+//	Test_BlockCompression.cpp: BC1/BC3/BC7 encoder and decoder tests
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Tests.h"
+
+namespace flu
+{
+namespace tests
+{
+	static const Int32 IMAGE_SIZE = 256;
+
+	struct FormatQuality
+	{
+		rend::EFormat format;
+		Double minPSNR;
+	};
+
+	static const FormatQuality g_formats[] =
+	{
+		{ rend::EFormat::BC1_UNORM, 38.0 },
+		{ rend::EFormat::BC3_UNORM, 36.0 },
+		{ rend::EFormat::BC7_UNORM, 40.0 }
+	};
+
+	static Double computePSNR( const Array<math::Color>& a, const Array<math::Color>& b )
+	{
+		Double error = 0.0;
+
+		for( Int32 i = 0; i < a.size(); ++i )
+		{
+			error += sqr( Double( a[i].r - b[i].r ) ) + sqr( Double( a[i].g - b[i].g ) ) +
+				sqr( Double( a[i].b - b[i].b ) ) + sqr( Double( a[i].a - b[i].a ) );
+		}
+
+		error /= a.size() * 4.0;
+
+		return error > 0.0 ? 10.0 * log10( 255.0 * 255.0 / error ) : 100.0;
+	}
+
+	static Array<math::Color> encodeAndDecode( const Array<math::Color>& image, Int32 width, Int32 height,
+		rend::EFormat format, Double* encodeTime = nullptr )
+	{
+		Array<UInt8> data( rend::getLevelSize( format, width, height ) );
+		Array<math::Color> result( width * height );
+
+		UInt64 startTime = time::cycles64();
+		img::encodeBlocks( &image[0], width, height, format, &data[0] );
+
+		if( encodeTime )
+		{
+			*encodeTime = time::elapsedMsFrom( startTime );
+		}
+
+		img::decodeBlocks( &data[0], width, height, format, &result[0] );
+		return result;
+	}
+
+	void test_BlockCompression()
+	{
+		enter_unit( BlockCompression );
+
+		job::ScopedJobSystem jobSystem( threading::getCPUCoresCount() );
+
+		// smooth image with noise and alpha gradient
+		Array<math::Color> image( IMAGE_SIZE * IMAGE_SIZE );
+
+		for( Int32 y = 0; y < IMAGE_SIZE; ++y )
+		{
+			for( Int32 x = 0; x < IMAGE_SIZE; ++x )
+			{
+				image[y * IMAGE_SIZE + x] = math::Color(
+					clamp( 128 + math::trunc( 100.f * math::sin( x * 0.05f ) ) + Random( 8 ), 0, 255 ),
+					y, ( x * y ) >> 8,
+					clamp( 128 + math::trunc( 127.f * math::cos( y * 0.03f ) ), 0, 255 ) );
+			}
+		}
+
+		for( const auto& it : g_formats )
+		{
+			Array<math::Color> reference = image;
+
+			if( it.format == rend::EFormat::BC1_UNORM )
+			{
+				// only 1 bit alpha
+				for( auto& pixel : reference )
+				{
+					pixel = pixel.a >= 128 ? math::Color( pixel.r, pixel.g, pixel.b, 0xff ) : math::Color( 0, 0, 0, 0 );
+				}
+			}
+
+			Double encodeTime;
+			Array<math::Color> decoded = encodeAndDecode( image, IMAGE_SIZE, IMAGE_SIZE, it.format, &encodeTime );
+			Double psnr = computePSNR( reference, decoded );
+
+			check( psnr >= it.minPSNR );
+
+			info( L"%s %dx%d: encode %.4f ms, PSNR %.2f dB", rend::getFormatInfo( it.format ).name,
+				IMAGE_SIZE, IMAGE_SIZE, encodeTime, psnr );
+		}
+
+		// solid color in the small levels
+		for( Int32 size : { 1, 2, 4, 8 } )
+		{
+			Array<math::Color> solid( size * size );
+
+			for( auto& pixel : solid )
+			{
+				pixel = math::Color( 40, 120, 200, 255 );
+			}
+
+			for( const auto& it : g_formats )
+			{
+				Array<math::Color> decoded = encodeAndDecode( solid, size, size, it.format );
+
+				for( const auto& pixel : decoded )
+				{
+					check( abs( pixel.r - 40 ) <= 4 && abs( pixel.g - 120 ) <= 4 && abs( pixel.b - 200 ) <= 4 );
+					check( pixel.a == 255 );
+				}
+			}
+		}
+
+		// masked sprite passes the same alpha test
+		Array<math::Color> masked( 16 * 16 );
+
+		for( auto& pixel : masked )
+		{
+			pixel = RandomBool() ? math::Color( Random( 256 ), Random( 256 ), Random( 256 ), 255 ) : math::Color( 0, 0, 0, 0 );
+		}
+
+		for( const auto& it : g_formats )
+		{
+			Array<math::Color> decoded = encodeAndDecode( masked, 16, 16, it.format );
+
+			for( Int32 i = 0; i < masked.size(); ++i )
+			{
+				check( ( decoded[i].a >= 128 ) == ( masked[i].a >= 128 ) );
+			}
+		}
+
+		leave_unit;
+	}
+}
+}
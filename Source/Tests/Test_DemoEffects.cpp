@@ -0,0 +1,162 @@
+//-----------------------------------------------------------------------------
+//	Test_DemoEffects.cpp: Demo effects kernels tests
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Tests.h"
+
+namespace flu
+{
+namespace tests
+{
+	static const Int32 NUM_FRAMES = 10;
+	static const Int32 FRAME_BITS[] = { 8, 10 };
+
+	static Int32 g_shiftTab[256];
+	static UInt8 g_sineTab[256];
+	static UInt8 g_waveTab[1536];
+	static UInt8 g_fireTable[512];
+	static UInt8 g_distTable[1024];
+	static UInt8 g_lightTable[580];
+	static UInt8 g_plasmaTable[4][256];
+
+	/**
+	 *	The same tables as demo bitmaps use
+	 */
+	static void initTables()
+	{
+		for( Int32 i = 0; i < 256; ++i )
+		{
+			g_shiftTab[i] = Random( 256 ) < 200 ? 0 : RandomBool() ? 1 : -1;
+			g_sineTab[i] = static_cast<UInt8>( math::sin( i / 256.f * 2.f * math::PI ) * 127.f + 128 );
+
+			for( Int32 j = 0; j < 4; ++j )
+			{
+				g_plasmaTable[j][i] = Random( 64 );
+			}
+		}
+
+		for( Int32 i = 0; i < 1536; ++i )
+		{
+			Int32 w = i / 2 - 256 + ( i - 512 < 256 ? 1 : 0 );
+			g_waveTab[i] = clamp( w, 0, 255 );
+		}
+
+		for( Int32 i = 0; i < 512; ++i )
+		{
+			g_fireTable[i] = clamp( math::round( ( i / 2.f - 16.f * RandomF() ) * 0.9f ), 0, 255 );
+		}
+
+		for( Int32 i = 0; i < 1024; ++i )
+		{
+			g_distTable[i] = clamp( math::trunc( ( i - 511 ) * ( 200.f / 512.f ) ), -128, 127 );
+		}
+
+		for( Int32 i = 0; i < 580; ++i )
+		{
+			g_lightTable[i] = Random( 256 );
+		}
+	}
+
+	struct DemoEffect
+	{
+		const Char* name;
+		void ( *render )( const UInt8* source, UInt8* work, UInt8* target, Int32 bits, Bool bScalar );
+	};
+
+	static const DemoEffect g_demoEffects[] =
+	{
+		{ L"Fire", []( const UInt8* source, UInt8* work, UInt8* target, Int32 bits, Bool bScalar )
+		{
+			DemoRisingFire( work, target, bits, bits, g_fireTable, g_shiftTab, 17, bScalar );
+			mem::copy( work, target, 1 << ( bits * 2 ) );
+		} },
+		{ L"Plasma", []( const UInt8* source, UInt8* work, UInt8* target, Int32 bits, Bool bScalar )
+		{
+			DemoPlasmaHeat( work, bits, bits, g_plasmaTable, g_sineTab, 33, bScalar );
+			DemoPlasmaRender( work, target, bits, bits, 33, bScalar );
+		} },
+		{ L"Water", []( const UInt8* source, UInt8* work, UInt8* target, Int32 bits, Bool bScalar )
+		{
+			DemoWaterFilter( work, target, bits, bits, g_waveTab, g_distTable, false, bScalar );
+			DemoWaterFilter( work, target, bits, bits, g_waveTab, g_distTable, true, bScalar );
+			DemoWaterRender( source, target, bits, bits, bScalar );
+		} },
+		{ L"Tech", []( const UInt8* source, UInt8* work, UInt8* target, Int32 bits, Bool bScalar )
+		{
+			DemoBumpMap( source, target, bits, bits, g_lightTable, bScalar );
+		} },
+		{ L"Glass", []( const UInt8* source, UInt8* work, UInt8* target, Int32 bits, Bool bScalar )
+		{
+			DemoGlass( source, work, target, bits, bits, 5, 7, true, bScalar );
+		} },
+		{ L"Harmonic", []( const UInt8* source, UInt8* work, UInt8* target, Int32 bits, Bool bScalar )
+		{
+			DemoHarmonic( source, target, bits, bits, g_sineTab, 4, 37, 200, 11, 3, true, bScalar );
+		} }
+	};
+
+	static void fillRandom( Array<UInt8>& frame )
+	{
+		for( auto& it : frame )
+		{
+			it = Random( 256 );
+		}
+	}
+
+	void test_DemoEffects()
+	{
+		enter_unit( DemoEffects );
+
+		job::ScopedJobSystem jobSystem( threading::getCPUCoresCount() );
+
+		initTables();
+
+		// kernels match scalar code and benchmark
+		for( Int32 bits : FRAME_BITS )
+		{
+			Int32 size = 1 << bits;
+
+			Array<UInt8> source( size * size );
+			Array<UInt8> work( size * size );
+			Array<UInt8> target( size * size );
+
+			fillRandom( source );
+			fillRandom( work );
+			fillRandom( target );
+
+			for( const auto& effect : g_demoEffects )
+			{
+				Array<UInt8> scalarWork = work;
+				Array<UInt8> scalarTarget = target;
+				Array<UInt8> fastWork = work;
+				Array<UInt8> fastTarget = target;
+
+				UInt64 startTime = time::cycles64();
+
+				for( Int32 frame = 0; frame < NUM_FRAMES; ++frame )
+				{
+					effect.render( &source[0], &scalarWork[0], &scalarTarget[0], bits, true );
+				}
+
+				Double scalarTime = time::elapsedMsFrom( startTime ) / NUM_FRAMES;
+				startTime = time::cycles64();
+
+				for( Int32 frame = 0; frame < NUM_FRAMES; ++frame )
+				{
+					effect.render( &source[0], &fastWork[0], &fastTarget[0], bits, false );
+				}
+
+				Double fastTime = time::elapsedMsFrom( startTime ) / NUM_FRAMES;
+
+				check( mem::cmp( &scalarWork[0], &fastWork[0], size * size ) );
+				check( mem::cmp( &scalarTarget[0], &fastTarget[0], size * size ) );
+
+				info( L"%s %dx%d: scalar %.4f ms, kernel %.4f ms per frame", effect.name, size, size, scalarTime, fastTime );
+			}
+		}
+
+		leave_unit;
+	}
+}
+}
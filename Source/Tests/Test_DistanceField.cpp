@@ -0,0 +1,92 @@
+//-----------------------------------------------------------------------------
+//	Test_DistanceField.cpp: Signed distance field generation tests
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Tests.h"
+
+namespace flu
+{
+namespace tests
+{
+	static const Int32 IMAGE_SIZE = 32;
+	static const Int32 SPREAD = 3;
+
+	void test_DistanceField()
+	{
+		enter_unit( DistanceField );
+
+		// random blobs
+		Array<math::Color> image( IMAGE_SIZE * IMAGE_SIZE );
+
+		for( Int32 y = 0; y < IMAGE_SIZE; ++y )
+		{
+			for( Int32 x = 0; x < IMAGE_SIZE; ++x )
+			{
+				const Bool inside = sqr( x - IMAGE_SIZE / 2 ) + sqr( y - IMAGE_SIZE / 2 ) < sqr( IMAGE_SIZE / 4 ) ||
+					Random( 20 ) == 0;
+
+				image[y * IMAGE_SIZE + x] = math::Color( 0, 0, 0, inside ? 255 : 0 );
+			}
+		}
+
+		const img::AtlasRect rect = { 2, 3, IMAGE_SIZE - 5, IMAGE_SIZE - 4 };
+
+		auto isInside = [&]( Int32 u, Int32 v ) -> Bool
+		{
+			return u >= 0 && v >= 0 && u < rect.width && v < rect.height &&
+				image[( rect.y + v ) * IMAGE_SIZE + rect.x + u].a >= 128;
+		};
+
+		// full resolution field matches brute force distance
+		Array<math::Color> field;
+		Int32 width = 0;
+		Int32 height = 0;
+
+		img::generateDistanceField( &image[0], IMAGE_SIZE, rect, SPREAD, 1, field, width, height );
+
+		check( width == rect.width + SPREAD * 2 && height == rect.height + SPREAD * 2 );
+
+		for( Int32 y = 0; y < height; ++y )
+		{
+			for( Int32 x = 0; x < width; ++x )
+			{
+				const Int32 u = x - SPREAD;
+				const Int32 v = y - SPREAD;
+				const Bool inside = isInside( u, v );
+
+				Float nearest = 1e10f;
+
+				for( Int32 j = -SPREAD * 2; j < rect.height + SPREAD * 2; ++j )
+				{
+					for( Int32 i = -SPREAD * 2; i < rect.width + SPREAD * 2; ++i )
+					{
+						if( isInside( i, j ) != inside )
+						{
+							nearest = min( nearest, math::sqrt( Float( sqr( i - u ) + sqr( j - v ) ) ) );
+						}
+					}
+				}
+
+				const Float distance = inside ? nearest - 0.5f : 0.5f - nearest;
+				const Float expected = clamp( 0.5f + distance / ( 2.f * SPREAD ), 0.f, 1.f ) * 255.f;
+				const math::Color texel = field[y * width + x];
+
+				check( abs( expected - texel.a ) <= 1.f );
+				check( texel.r == 255 && texel.g == 255 && texel.b == 255 );
+			}
+		}
+
+		// downscaled field keeps the shape
+		img::generateDistanceField( &image[0], IMAGE_SIZE, rect, SPREAD, 4, field, width, height );
+
+		check( width == ( rect.width + 3 ) / 4 + SPREAD * 2 && height == ( rect.height + 3 ) / 4 + SPREAD * 2 );
+		check( field[0].a < 128 );
+		check( field[( height / 2 ) * width + width / 2].a > 128 );
+
+		info( L"Field: %dx%d from %dx%d", width, height, rect.width, rect.height );
+
+		leave_unit;
+	}
+}
+}
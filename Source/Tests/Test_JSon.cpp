@@ -0,0 +1,114 @@
+//-----------------------------------------------------------------------------
+//	Test_JSon.cpp: JSon document parser tests
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Tests.h"
+
+namespace flu
+{
+namespace tests
+{
+	static JSonDocument::Ptr parseJSon( const Char* text, String* error = nullptr )
+	{
+		return JSonDocument::parse( text, cstr::length( text ), error );
+	}
+
+	void test_JSon()
+	{
+		enter_unit( JSon );
+
+		// legacy dialect
+		{
+			JSonDocument::Ptr document = parseJSon( L"{ name: \"Test\", \"count\": 3, scale: -1.5f, "
+				L"visible: TRUE, items: [ 1, 2e2, { a: false }, ], empty: {} }" );
+
+			check( document.hasObject() );
+			const JSonDocument::Value* root = document->root();
+
+			check( root->type == JSonDocument::EValueType::Object && root->object.count == 6 );
+			check( root->getField( L"name" )->stringValue.equals( L"Test", 4 ) );
+			check( root->getField( L"count" )->intValue == 3 );
+			check( root->getField( L"scale" )->floatValue == -1.5f );
+			check( root->getField( L"visible" )->boolValue == true );
+			check( root->getField( L"missing" ) == nullptr );
+
+			// keys are interned while parsing
+			check( root->getField( NameId( L"count" ) ) == root->getField( L"count" ) );
+			check( root->object.members[1].name == NameId::find( L"count" ) );
+			check( root->getField( NameId( L"Count" ) ) == nullptr );
+
+			const JSonDocument::Value* items = root->getField( L"items" );
+			check( items->type == JSonDocument::EValueType::Array && items->array.count == 3 );
+			check( items->getElement( 1 )->type == JSonDocument::EValueType::Float );
+			check( items->getElement( 1 )->floatValue == 200.f );
+			check( items->getElement( 2 )->getField( L"a" )->boolValue == false );
+			check( items->getElement( 3 ) == nullptr );
+
+			check( root->getField( L"empty" )->object.count == 0 );
+		}
+
+		// facade nodes
+		{
+			Text::Ptr text = new Text( L"{\n\tsize: 12,\n\tname: \"Verdana\"\n}" );
+			JSon::Ptr json = JSon::loadFromText( text );
+
+			check( json.hasObject() && json->isObject() );
+			check( json->dotgetInt( L"size" ) == 12 );
+			check( json->dotgetString( L"name" ) == L"Verdana" );
+		}
+
+		// exponents don't hang and out of range numbers are rejected
+		{
+			check( !parseJSon( L"[ 1e999999999 ]" ).hasObject() );
+			check( parseJSon( L"[ 1e-999999999 ]" )->root()->getElement( 0 )->floatValue == 0.f );
+			check( parseJSon( L"[ 12345678901234567890123 ]" ).hasObject() );
+		}
+
+		// malformed documents
+		{
+			check( !parseJSon( L"" ).hasObject() );
+			check( !parseJSon( L"{ a: 1 } }" ).hasObject() );
+			check( !parseJSon( L"[ 1 ] garbage" ).hasObject() );
+			check( !parseJSon( L"{ a 1 }" ).hasObject() );
+			check( !parseJSon( L"{ a: \"unterminated }" ).hasObject() );
+			check( !parseJSon( L"[ 1, 2" ).hasObject() );
+			check( !parseJSon( L"[ null ]" ).hasObject() );
+			check( parseJSon( L" { a: 1 } \n\n" ).hasObject() );
+		}
+
+		// nesting limit
+		{
+			String deep;
+
+			for( Int32 i = 0; i < 100000; ++i )
+			{
+				deep += L"[";
+			}
+
+			check( !parseJSon( *deep ).hasObject() );
+
+			String shallow;
+
+			for( Int32 i = 0; i < 100; ++i )
+			{
+				shallow = String::format( L"[%s]", *shallow );
+			}
+
+			check( parseJSon( *shallow ).hasObject() );
+		}
+
+		// error line numbers start from 1
+		{
+			String error;
+			check( !parseJSon( L"{ a: ? }", &error ).hasObject() );
+			check( String::pos( L"at line: 1", error ) != -1 );
+
+			check( !parseJSon( L"{\n\ta: 1,\n\tb: ?\n}", &error ).hasObject() );
+			check( String::pos( L"at line: 3", error ) != -1 );
+		}
+
+		leave_unit;
+	}
+}
+}
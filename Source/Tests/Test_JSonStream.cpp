@@ -0,0 +1,214 @@
+//-----------------------------------------------------------------------------
+//	Test_JSonStream.cpp: Streaming JSon reader and writer tests
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Tests.h"
+
+namespace flu
+{
+namespace tests
+{
+	/**
+	 *	A handler which records all the events to the string
+	 */
+	class JSonEventsRecorder: public IJSonHandler
+	{
+	public:
+		String events;
+
+		Bool onBool( Bool value ) override
+		{
+			events += value ? L"true " : L"false ";
+			return true;
+		}
+
+		Bool onInt( Int32 value ) override
+		{
+			events += String::format( L"%d ", value );
+			return true;
+		}
+
+		Bool onFloat( Float value ) override
+		{
+			events += String::format( L"%.2f ", value );
+			return true;
+		}
+
+		Bool onString( const Char* value, SizeT length ) override
+		{
+			events += L"\"" + String( value, length ) + L"\" ";
+			return true;
+		}
+
+		Bool onBeginObject() override
+		{
+			events += L"{ ";
+			return true;
+		}
+
+		Bool onKey( const Char* name, SizeT length ) override
+		{
+			events += String( name, length ) + L": ";
+			return true;
+		}
+
+		Bool onEndObject() override
+		{
+			events += L"} ";
+			return true;
+		}
+
+		Bool onBeginArray() override
+		{
+			events += L"[ ";
+			return true;
+		}
+
+		Bool onEndArray() override
+		{
+			events += L"] ";
+			return true;
+		}
+	};
+
+	static const Int32 LARGE_ARRAY_SIZE = 300;
+
+	static void writeTestDocument( JSonWriter& writer )
+	{
+		writer.beginObject();
+		{
+			writer.writeKey( L"name" );
+			writer.writeString( L"Level" );
+
+			writer.writeKey( L"visible" );
+			writer.writeBool( true );
+
+			writer.writeKey( L"scale" );
+			writer.writeFloat( 1.5f );
+
+			writer.writeKey( L"empty" );
+			writer.beginObject();
+			writer.endObject();
+
+			writer.writeKey( L"items" );
+			writer.beginArray();
+			{
+				for( Int32 i = 0; i < LARGE_ARRAY_SIZE; ++i )
+				{
+					writer.writeInt( i );
+				}
+
+				writer.beginObject();
+				writer.writeKey( L"nested" );
+				writer.writeInt( -7 );
+				writer.endObject();
+			}
+			writer.endArray();
+		}
+		writer.endObject();
+	}
+
+	static String getExpectedEvents()
+	{
+		String result = L"{ name: \"Level\" visible: true scale: 1.50 empty: { } items: [ ";
+
+		for( Int32 i = 0; i < LARGE_ARRAY_SIZE; ++i )
+		{
+			result += String::format( L"%d ", i );
+		}
+
+		return result + L"{ nested: -7 } ] } ";
+	}
+
+	void test_JSonStream()
+	{
+		enter_unit( JSonStream );
+
+		const String expectedEvents = getExpectedEvents();
+
+		// text roundtrip, writer flushes on destruction
+		{
+			OwningBufferWriter buffer;
+			{
+				JSonWriter::UPtr writer = JSonWriter::createTextWriter( buffer );
+				writeTestDocument( *writer );
+			}
+
+			check( buffer.size() > 0 );
+
+			Array<UInt8> data( Int32( buffer.size() ) );
+			mem::copy( &data[0], buffer.getData(), buffer.size() );
+
+			BufferReader reader( data );
+			JSonEventsRecorder recorder;
+
+			check( JSonReader::readText( reader, recorder ) );
+			check( recorder.events == expectedEvents );
+		}
+
+		// binary roundtrip, counts are patched on containers end
+		{
+			OwningBufferWriter buffer;
+			{
+				JSonWriter::UPtr writer = JSonWriter::createBinaryWriter( buffer );
+				writeTestDocument( *writer );
+			}
+
+			Array<UInt8> data( Int32( buffer.size() ) );
+			mem::copy( &data[0], buffer.getData(), buffer.size() );
+
+			BufferReader reader( data );
+			JSonEventsRecorder recorder;
+
+			check( JSonReader::readBinary( reader, recorder ) );
+			check( recorder.events == expectedEvents );
+			check( reader.isEof() );
+
+			// the tree loader sees the same counts
+			BufferReader treeReader( data );
+			JSon::Ptr json = JSon::loadFromStream( treeReader );
+
+			check( json.hasObject() && json->fieldsCount() == 5 );
+			check( json->getField( L"items" )->arraySize() == LARGE_ARRAY_SIZE + 1 );
+			check( json->getField( L"empty" )->fieldsCount() == 0 );
+		}
+
+		// tree saver goes through the binary writer
+		{
+			JSon::Ptr json = JSon::createObjectNode();
+			json->addField( L"value", JSon::createIntNode( 42 ) );
+
+			OwningBufferWriter buffer;
+			check( JSon::saveToStream( buffer, json ) );
+
+			Array<UInt8> data( Int32( buffer.size() ) );
+			mem::copy( &data[0], buffer.getData(), buffer.size() );
+
+			BufferReader reader( data );
+			JSon::Ptr loaded = JSon::loadFromStream( reader );
+
+			check( loaded.hasObject() && loaded->dotgetInt( L"value" ) == 42 );
+		}
+
+		// truncated binary data is rejected
+		{
+			OwningBufferWriter buffer;
+			{
+				JSonWriter::UPtr writer = JSonWriter::createBinaryWriter( buffer );
+				writeTestDocument( *writer );
+			}
+
+			Array<UInt8> data( Int32( buffer.size() / 2 ) );
+			mem::copy( &data[0], buffer.getData(), data.size() );
+
+			BufferReader reader( data );
+			JSonEventsRecorder recorder;
+
+			check( !JSonReader::readBinary( reader, recorder ) );
+		}
+
+		leave_unit;
+	}
+}
+}
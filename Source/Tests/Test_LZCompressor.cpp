@@ -0,0 +1,196 @@
+//-----------------------------------------------------------------------------
+//	Test_LZCompressor.cpp: LZ codec and framed compressor tests
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Tests.h"
+
+namespace flu
+{
+namespace tests
+{
+	static const SizeT FRAME_SIZE = 64 * 1024;
+
+	static Bool roundtrip( CLZCompressor& compressor, const Array<UInt8>& source, SizeT* outCompressedSize = nullptr )
+	{
+		void* compressed = nullptr;
+		SizeT compressedSize = 0;
+
+		compressor.Encode( source.size() ? &source[0] : nullptr, source.size(), compressed, compressedSize );
+
+		void* decompressed = nullptr;
+		SizeT decompressedSize = 0;
+
+		compressor.Decode( compressed, compressedSize, decompressed, decompressedSize );
+
+		const Bool result = decompressedSize == SizeT( source.size() ) &&
+			( source.size() == 0 || mem::cmp( decompressed, &source[0], source.size() ) );
+
+		if( outCompressedSize )
+		{
+			*outCompressedSize = compressedSize;
+		}
+
+		mem::free( compressed );
+		mem::free( decompressed );
+
+		return result;
+	}
+
+	static Bool blockRoundtrip( const Array<UInt8>& source, Bool highRatio, SizeT* outCompressedSize = nullptr )
+	{
+		const SizeT sourceSize = source.size();
+		Array<UInt8> compressed( Int32( lz::compressBound( sourceSize ) ) );
+
+		const SizeT compressedSize = lz::compress( sourceSize ? &source[0] : nullptr, sourceSize, 
+			&compressed[0], compressed.size(), highRatio );
+
+		if( compressedSize == 0 )
+		{
+			return false;
+		}
+
+		Array<UInt8> decompressed( Int32( sourceSize ) );
+
+		if( !lz::decompress( &compressed[0], compressedSize, sourceSize ? &decompressed[0] : nullptr, sourceSize ) )
+		{
+			return false;
+		}
+
+		if( outCompressedSize )
+		{
+			*outCompressedSize = compressedSize;
+		}
+
+		return sourceSize == 0 || mem::cmp( &decompressed[0], &source[0], sourceSize );
+	}
+
+	void test_LZCompressor()
+	{
+		enter_unit( LZCompressor );
+
+		CLZCompressor fast( false );
+		CLZCompressor high( true );
+
+		// empty input
+		{
+			Array<UInt8> source;
+			check( roundtrip( fast, source ) );
+			check( roundtrip( high, source ) );
+		}
+
+		// incompressible input is stored, overhead is header only
+		{
+			Array<UInt8> source( FRAME_SIZE + 1000 );
+
+			for( Int32 i = 0; i < source.size(); ++i )
+			{
+				source[i] = static_cast<UInt8>( Random( 256 ) );
+			}
+
+			SizeT compressedSize = 0;
+			check( roundtrip( fast, source, &compressedSize ) );
+			check( compressedSize == source.size() + sizeof( UInt32 ) * 4 );
+		}
+
+		// several frames, the last one is partial
+		{
+			Array<UInt8> source( FRAME_SIZE * 5 + 123 );
+
+			for( Int32 i = 0; i < source.size(); ++i )
+			{
+				source[i] = static_cast<UInt8>( ( i / 7 ) % 13 + ( Random( 8 ) == 0 ? Random( 4 ) : 0 ) );
+			}
+
+			SizeT fastSize = 0;
+			SizeT highSize = 0;
+
+			check( roundtrip( fast, source, &fastSize ) );
+			check( roundtrip( high, source, &highSize ) );
+			check( fastSize < SizeT( source.size() ) && highSize < SizeT( source.size() ) );
+		}
+
+		// tiny and highly compressible inputs
+		for( Int32 size : { 1, 5, 12, 13, 100, Int32( FRAME_SIZE ), Int32( FRAME_SIZE ) * 3 } )
+		{
+			Array<UInt8> source( size );
+			mem::set( &source[0], size, 'a' );
+
+			SizeT compressedSize = 0;
+			check( roundtrip( fast, source ) );
+			check( roundtrip( high, source, &compressedSize ) );
+
+			if( size >= Int32( FRAME_SIZE ) )
+			{
+				check( compressedSize < SizeT( size ) / 50 );
+			}
+		}
+
+		// lz block codec, empty input
+		{
+			Array<UInt8> source;
+			check( blockRoundtrip( source, false ) );
+			check( blockRoundtrip( source, true ) );
+		}
+
+		// incompressible input doesn't fit smaller destination
+		{
+			Array<UInt8> source( 32 * 1024 );
+
+			for( Int32 i = 0; i < source.size(); ++i )
+			{
+				source[i] = static_cast<UInt8>( Random( 256 ) );
+			}
+
+			Array<UInt8> compressed( source.size() - source.size() / 8 );
+
+			check( lz::compress( &source[0], source.size(), &compressed[0], compressed.size(), false ) == 0 );
+			check( lz::compress( &source[0], source.size(), &compressed[0], compressed.size(), true ) == 0 );
+
+			check( blockRoundtrip( source, false ) );
+			check( blockRoundtrip( source, true ) );
+		}
+
+		// different sizes of compressible input
+		for( Int32 size : { 1, 5, 12, 13, 100, 4096, 70000, 300000 } )
+		{
+			Array<UInt8> source( size );
+
+			for( Int32 i = 0; i < source.size(); ++i )
+			{
+				source[i] = static_cast<UInt8>( ( i / 7 ) % 13 + ( Random( 8 ) == 0 ? Random( 4 ) : 0 ) );
+			}
+
+			SizeT fastSize = 0;
+			SizeT highSize = 0;
+
+			check( blockRoundtrip( source, false, &fastSize ) );
+			check( blockRoundtrip( source, true, &highSize ) );
+
+			if( size >= 4096 )
+			{
+				check( fastSize < SizeT( size ) && highSize < SizeT( size ) );
+			}
+		}
+
+		// corrupted or truncated data is rejected
+		{
+			Array<UInt8> source( 10000 );
+			mem::set( &source[0], source.size(), 'a' );
+
+			Array<UInt8> compressed( Int32( lz::compressBound( source.size() ) ) );
+			const SizeT compressedSize = lz::compress( &source[0], source.size(), &compressed[0], compressed.size() );
+			check( compressedSize > 0 );
+
+			Array<UInt8> decompressed( source.size() );
+
+			check( lz::decompress( &compressed[0], compressedSize, &decompressed[0], decompressed.size() ) );
+			check( !lz::decompress( &compressed[0], compressedSize / 2, &decompressed[0], decompressed.size() ) );
+			check( !lz::decompress( &compressed[0], compressedSize, &decompressed[0], decompressed.size() - 1 ) );
+			check( !lz::decompress( &compressed[0], 0, &decompressed[0], decompressed.size() ) );
+		}
+
+		leave_unit;
+	}
+}
+}
@@ -0,0 +1,139 @@
+//-----------------------------------------------------------------------------
+//	Test_LayoutCache.cpp: Text layout cache tests
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Tests.h"
+
+namespace flu
+{
+namespace tests
+{
+	static const Float GLYPH_WIDTH = 8.f;
+	static const Float GLYPH_HEIGHT = 16.f;
+
+	/**
+	 *	Make a font where 'W' is twice wider than any other symbol
+	 */
+	static fnt::Font::Ptr makeFont( Float glyphWidth )
+	{
+		Array<fnt::Glyph> glyphs( 2 );
+
+		for( Int32 i = 0; i < glyphs.size(); ++i )
+		{
+			glyphs[i].x = glyphs[i].y = 0.f;
+			glyphs[i].width = glyphs[i].height = 1.f;
+			glyphs[i].pixelWidth = glyphWidth * ( i + 1 );
+			glyphs[i].pixelHeight = GLYPH_HEIGHT;
+		}
+
+		Array<UInt16> remap( 128 );
+		mem::zero( &remap[0], remap.size() * sizeof( UInt16 ) );
+		remap['W'] = 1;
+
+		return fnt::Font::createFromGlyphs( L"TestFont", glyphs, remap );
+	}
+
+	void test_LayoutCache()
+	{
+		enter_unit( LayoutCache );
+
+		fnt::Font::Ptr font = makeFont( GLYPH_WIDTH );
+
+		// measured width is taken from the laid out glyphs
+		{
+			fnt::LayoutCache cache;
+
+			const fnt::LayoutCache::Layout& layout = cache.getLayout( L"Wow", 3, font );
+			check( layout.vertices.size() == fnt::getBatchVertexCount( 3 ) );
+			check( layout.width == font->textWidth( L"Wow", 3 ) );
+			check( layout.width == 4.f * GLYPH_WIDTH );
+			check( layout.height == GLYPH_HEIGHT );
+			check( cache.getNumMisses() == 1 );
+
+			check( cache.textWidth( L"", 0, font ) == 0.f );
+			check( cache.textWidth( L"W", 1, font, 0.5f ) == GLYPH_WIDTH );
+			check( cache.getNumMisses() == 3 );
+		}
+
+		// same line, font and scale is a hit
+		{
+			fnt::LayoutCache cache;
+
+			const Float width = cache.textWidth( L"Hello", 5, font );
+			check( width == 5.f * GLYPH_WIDTH );
+			check( cache.getNumMisses() == 1 );
+
+			for( Int32 i = 0; i < 10; ++i )
+			{
+				check( cache.textWidth( L"Hello", 5, font ) == width );
+				check( cache.getLayout( L"Hello", 5, font ).width == width );
+			}
+
+			check( cache.getNumMisses() == 1 );
+
+			// prefix of the text is a different line
+			check( cache.textWidth( L"Hello", 4, font ) == 4.f * GLYPH_WIDTH );
+			check( cache.getNumMisses() == 2 );
+
+			// so is the different scale
+			check( cache.textWidth( L"Hello", 5, font, 2.f ) == 2.f * width );
+			check( cache.textWidth( L"Hello", 5, font, 1.f, 2.f ) == width );
+			check( cache.getNumMisses() == 4 );
+		}
+
+		// text and font changes invalidate layout
+		{
+			fnt::LayoutCache cache;
+
+			check( cache.textWidth( L"Hello", 5, font ) == 5.f * GLYPH_WIDTH );
+			check( cache.textWidth( L"HelloW", 6, font ) == 7.f * GLYPH_WIDTH );
+			check( cache.getNumMisses() == 2 );
+
+			// a new font with the same name has a new version
+			fnt::Font::Ptr reloaded = makeFont( 2.f * GLYPH_WIDTH );
+			check( reloaded->getVersion() != font->getVersion() );
+
+			check( cache.textWidth( L"Hello", 5, reloaded ) == 10.f * GLYPH_WIDTH );
+			check( cache.getNumMisses() == 3 );
+
+			// old font layout is still valid
+			check( cache.textWidth( L"Hello", 5, font ) == 5.f * GLYPH_WIDTH );
+			check( cache.getNumMisses() == 3 );
+		}
+
+		// least recently used line is evicted
+		{
+			fnt::LayoutCache cache( 2 );
+
+			cache.textWidth( L"A", 1, font );
+			cache.textWidth( L"B", 1, font );
+			cache.textWidth( L"A", 1, font );
+			check( cache.getNumMisses() == 2 );
+
+			// evicts "B"
+			cache.textWidth( L"C", 1, font );
+			check( cache.getNumMisses() == 3 );
+
+			cache.textWidth( L"A", 1, font );
+			cache.textWidth( L"C", 1, font );
+			check( cache.getNumMisses() == 3 );
+
+			// evicts "A"
+			check( cache.textWidth( L"B", 1, font ) == GLYPH_WIDTH );
+			check( cache.getNumMisses() == 4 );
+
+			cache.textWidth( L"A", 1, font );
+			check( cache.getNumMisses() == 5 );
+
+			cache.empty();
+			check( cache.getNumMisses() == 0 );
+
+			cache.textWidth( L"C", 1, font );
+			check( cache.getNumMisses() == 1 );
+		}
+
+		leave_unit;
+	}
+}
+}
@@ -0,0 +1,253 @@
+//-----------------------------------------------------------------------------
+//	Test_Log.cpp: Log queue tests
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Tests.h"
+
+namespace flu
+{
+namespace tests
+{
+	struct LogProducer
+	{
+		LogQueue* queue;
+		Int32 index;
+		Int32 numMessages;
+	};
+
+	static void logProducerEntry( void* arg )
+	{
+		LogProducer* producer = reinterpret_cast<LogProducer*>( arg );
+		Char buffer[64];
+
+		for( Int32 i = 0; i < producer->numMessages; ++i )
+		{
+			swprintf_s( buffer, arraySize( buffer ), L"%d %d", producer->index, i );
+
+			while( !producer->queue->tryPush( ELogLevel::Info, false, buffer, cstr::length( buffer ) ) )
+			{
+				threading::yield();
+			}
+		}
+	}
+
+	static const Double SINK_COST_MS = 0.02;
+
+	/**
+	 *	Emulate a slow log callback, like a flushed file or a console
+	 */
+	static void emulateSink()
+	{
+		const UInt64 startTime = time::cycles64();
+
+		while( time::elapsedMsFrom( startTime ) < SINK_COST_MS )
+		{
+		}
+	}
+
+	struct LogConsumer
+	{
+		LogQueue* queue;
+		Int32 numMessages;
+	};
+
+	static void logConsumerEntry( void* arg )
+	{
+		LogConsumer* consumer = reinterpret_cast<LogConsumer*>( arg );
+
+		ELogLevel level;
+		Bool isScript;
+		Char buffer[64];
+
+		for( Int32 i = 0; i < consumer->numMessages; )
+		{
+			if( consumer->queue->tryPop( level, isScript, buffer, arraySize( buffer ) ) )
+			{
+				emulateSink();
+				++i;
+			}
+			else
+			{
+				threading::yield();
+			}
+		}
+	}
+
+	void test_Log()
+	{
+		enter_unit( Log );
+
+		// LogQueue::tryPush and LogQueue::tryPop
+		{
+			UniquePtr<LogQueue> queue = new LogQueue();
+
+			ELogLevel level;
+			Bool isScript;
+			Char buffer[LogManager::MAX_MESSAGE_LENGTH];
+
+			check( !queue->tryPop( level, isScript, buffer, arraySize( buffer ) ) );
+
+			check( queue->tryPush( ELogLevel::Warning, true, L"Hello", 5 ) );
+			check( queue->tryPop( level, isScript, buffer, arraySize( buffer ) ) );
+			check( level == ELogLevel::Warning && isScript );
+			check( cstr::compare( buffer, L"Hello" ) == 0 );
+
+			check( !queue->tryPop( level, isScript, buffer, arraySize( buffer ) ) );
+			check( queue->getHead() == queue->getTail() );
+		}
+
+		// long messages take several slots
+		{
+			UniquePtr<LogQueue> queue = new LogQueue();
+
+			ELogLevel level;
+			Bool isScript;
+			Char message[LogQueue::SLOT_LENGTH * 5 + 7];
+			Char buffer[LogManager::MAX_MESSAGE_LENGTH];
+
+			for( SizeT i = 0; i < arraySize( message ) - 1; ++i )
+			{
+				message[i] = L'a' + i % 26;
+			}
+
+			message[arraySize( message ) - 1] = 0;
+
+			for( Int32 i = 0; i < LogQueue::NUM_SLOTS * 2; ++i )
+			{
+				check( queue->tryPush( ELogLevel::Error, false, message, cstr::length( message ) ) );
+				check( queue->tryPop( level, isScript, buffer, arraySize( buffer ) ) );
+				check( cstr::compare( buffer, message ) == 0 );
+			}
+		}
+
+		// overflow
+		{
+			UniquePtr<LogQueue> queue = new LogQueue();
+
+			for( Int32 i = 0; i < LogQueue::NUM_SLOTS; ++i )
+			{
+				check( queue->tryPush( ELogLevel::Info, false, L"x", 1 ) );
+			}
+
+			check( !queue->tryPush( ELogLevel::Info, false, L"x", 1 ) );
+		}
+
+		// many producers
+		{
+			static const Int32 NUM_PRODUCERS = 4;
+			static const Int32 NUM_MESSAGES = 50000;
+
+			UniquePtr<LogQueue> queue = new LogQueue();
+			LogProducer producers[NUM_PRODUCERS];
+			threading::Thread::UPtr threads[NUM_PRODUCERS];
+			Int32 nextMessage[NUM_PRODUCERS] = {};
+
+			const UInt64 startTime = time::cycles64();
+
+			for( Int32 i = 0; i < NUM_PRODUCERS; ++i )
+			{
+				producers[i].queue = queue.get();
+				producers[i].index = i;
+				producers[i].numMessages = NUM_MESSAGES;
+
+				threads[i] = threading::Thread::create( logProducerEntry, &producers[i], "Log Producer" );
+			}
+
+			ELogLevel level;
+			Bool isScript;
+			Char buffer[64];
+			Int32 numReceived = 0;
+			Bool inOrder = true;
+
+			while( numReceived < NUM_PRODUCERS * NUM_MESSAGES )
+			{
+				if( queue->tryPop( level, isScript, buffer, arraySize( buffer ) ) )
+				{
+					Int32 index, message;
+
+					if( swscanf_s( buffer, L"%d %d", &index, &message ) != 2 || 
+						index < 0 || index >= NUM_PRODUCERS || nextMessage[index] != message )
+					{
+						inOrder = false;
+						break;
+					}
+
+					nextMessage[index]++;
+					numReceived++;
+				}
+				else
+				{
+					threading::yield();
+				}
+			}
+
+			for( Int32 i = 0; i < NUM_PRODUCERS; ++i )
+			{
+				threads[i]->wait();
+			}
+
+			check( inOrder );
+			check( numReceived == NUM_PRODUCERS * NUM_MESSAGES );
+
+			info( L"Log queue throughput: %.4f ms per 1000 messages", 
+				time::elapsedMsFrom( startTime ) * 1000.0 / ( NUM_PRODUCERS * NUM_MESSAGES ) );
+		}
+
+		// frame time under heavy logging, slow sink called in place vs on the log thread
+		{
+			static const Int32 NUM_FRAMES = 30;
+			static const Int32 MESSAGES_PER_FRAME = 200;
+			static const UInt32 FRAME_WORK_MS = 5;
+
+			Char buffer[64];
+			Double syncFrameMs = 0.0;
+			Double asyncFrameMs = 0.0;
+
+			for( Int32 frame = 0; frame < NUM_FRAMES; ++frame )
+			{
+				const UInt64 frameStart = time::cycles64();
+
+				for( Int32 i = 0; i < MESSAGES_PER_FRAME; ++i )
+				{
+					swprintf_s( buffer, arraySize( buffer ), L"Frame %d message %d", frame, i );
+					emulateSink();
+				}
+
+				syncFrameMs += time::elapsedMsFrom( frameStart );
+				threading::sleep( FRAME_WORK_MS );
+			}
+
+			UniquePtr<LogQueue> queue = new LogQueue();
+			LogConsumer consumer = { queue.get(), NUM_FRAMES * MESSAGES_PER_FRAME };
+			threading::Thread::UPtr thread = threading::Thread::create( logConsumerEntry, &consumer, "Log Consumer" );
+
+			for( Int32 frame = 0; frame < NUM_FRAMES; ++frame )
+			{
+				const UInt64 frameStart = time::cycles64();
+
+				for( Int32 i = 0; i < MESSAGES_PER_FRAME; ++i )
+				{
+					swprintf_s( buffer, arraySize( buffer ), L"Frame %d message %d", frame, i );
+
+					while( !queue->tryPush( ELogLevel::Info, false, buffer, cstr::length( buffer ) ) )
+					{
+						threading::yield();
+					}
+				}
+
+				asyncFrameMs += time::elapsedMsFrom( frameStart );
+				threading::sleep( FRAME_WORK_MS );
+			}
+
+			thread->wait();
+			check( queue->getHead() == queue->getTail() );
+
+			info( L"Heavy logging, %d messages per frame: %.4f ms in place, %.4f ms async per frame", 
+				MESSAGES_PER_FRAME, syncFrameMs / NUM_FRAMES, asyncFrameMs / NUM_FRAMES );
+		}
+
+		leave_unit;
+	}
+}
+}
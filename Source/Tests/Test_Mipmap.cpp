@@ -0,0 +1,156 @@
+//-----------------------------------------------------------------------------
+//	Test_Mipmap.cpp: Mip chain generation tests
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Tests.h"
+
+namespace flu
+{
+namespace tests
+{
+	static const Int32 IMAGE_SIZES[][2] = { { 1, 1 }, { 8, 1 }, { 2, 64 }, { 256, 256 }, { 1024, 512 } };
+
+	/**
+	 *	Straightforward premultiplied 2x2 average of the previous level
+	 */
+	static void referenceBoxLevel( const Array<math::FloatColor>& source, Int32 width, Int32 height,
+		Array<math::FloatColor>& dest )
+	{
+		Int32 destWidth = max( width / 2, 1 );
+		Int32 destHeight = max( height / 2, 1 );
+
+		dest.setSize( destWidth * destHeight );
+
+		for( Int32 y = 0; y < destHeight; ++y )
+		{
+			for( Int32 x = 0; x < destWidth; ++x )
+			{
+				Int32 x0 = min( x * 2, width - 1 ), x1 = min( x * 2 + 1, width - 1 );
+				Int32 y0 = min( y * 2, height - 1 ), y1 = min( y * 2 + 1, height - 1 );
+
+				const math::FloatColor& a = source[y0 * width + x0];
+				const math::FloatColor& b = source[y0 * width + x1];
+				const math::FloatColor& c = source[y1 * width + x0];
+				const math::FloatColor& d = source[y1 * width + x1];
+
+				math::FloatColor& result = dest[y * destWidth + x];
+				result.r = ( a.r + b.r + c.r + d.r ) * 0.25f;
+				result.g = ( a.g + b.g + c.g + d.g ) * 0.25f;
+				result.b = ( a.b + b.b + c.b + d.b ) * 0.25f;
+				result.a = ( a.a + b.a + c.a + d.a ) * 0.25f;
+			}
+		}
+	}
+
+	static Bool isColorNear( const math::FloatColor& premultiplied, math::Color color )
+	{
+		static const Float TOLERANCE = 1.5f;
+
+		if( abs( premultiplied.a * 255.f - color.a ) > TOLERANCE )
+		{
+			return false;
+		}
+
+		if( premultiplied.a * 255.f < 1.f )
+		{
+			// color is meaningless
+			return true;
+		}
+
+		Float scale = 255.f / premultiplied.a;
+
+		return abs( premultiplied.r * scale - color.r ) <= TOLERANCE &&
+			abs( premultiplied.g * scale - color.g ) <= TOLERANCE &&
+			abs( premultiplied.b * scale - color.b ) <= TOLERANCE;
+	}
+
+	void test_Mipmap()
+	{
+		enter_unit( Mipmap );
+
+		job::ScopedJobSystem jobSystem( threading::getCPUCoresCount() );
+
+		for( const auto& size : IMAGE_SIZES )
+		{
+			Int32 width = size[0];
+			Int32 height = size[1];
+
+			Array<math::Color> image( width * height );
+
+			for( auto& it : image )
+			{
+				it = math::Color( Random( 256 ), Random( 256 ), Random( 256 ), Random( 256 ) );
+			}
+
+			// levels count and layout
+			Array<math::Color> levels;
+			Int32 numMips = img::generateMips( &image[0], width, height, img::EMipFilter::Box, false, levels );
+
+			check( numMips == rend::getMipsCount( width, height ) );
+			check( mem::cmp( &levels[0], &image[0], image.size() * sizeof( math::Color ) ) );
+
+			Int32 expectedSize = 0;
+
+			for( Int32 i = 0; i < numMips; ++i )
+			{
+				expectedSize += max( width >> i, 1 ) * max( height >> i, 1 );
+			}
+
+			check( levels.size() == expectedSize );
+
+			// box filter matches scalar reference
+			Array<math::FloatColor> reference( width * height );
+
+			for( Int32 i = 0; i < image.size(); ++i )
+			{
+				Float alpha = image[i].a / 255.f;
+				reference[i] = math::FloatColor( image[i].r / 255.f * alpha, image[i].g / 255.f * alpha,
+					image[i].b / 255.f * alpha, alpha );
+			}
+
+			Int32 levelWidth = width;
+			Int32 levelHeight = height;
+			Int32 levelOffset = width * height;
+
+			for( Int32 i = 1; i < numMips; ++i )
+			{
+				Array<math::FloatColor> nextReference;
+				referenceBoxLevel( reference, levelWidth, levelHeight, nextReference );
+
+				levelWidth = max( levelWidth / 2, 1 );
+				levelHeight = max( levelHeight / 2, 1 );
+
+				for( Int32 j = 0; j < nextReference.size(); ++j )
+				{
+					check( isColorNear( nextReference[j], levels[levelOffset + j] ) );
+				}
+
+				levelOffset += levelWidth * levelHeight;
+				reference = nextReference;
+			}
+
+			// kaiser filter keeps solid image solid
+			Array<math::Color> solid( width * height );
+
+			for( auto& it : solid )
+			{
+				it = math::Color( 40, 120, 200, 255 );
+			}
+
+			img::generateMips( &solid[0], width, height, img::EMipFilter::Kaiser, true, levels );
+
+			for( const auto& it : levels )
+			{
+				check( abs( it.r - 40 ) <= 1 && abs( it.g - 120 ) <= 1 && abs( it.b - 200 ) <= 1 && it.a == 255 );
+			}
+
+			// no mips requested
+			check( img::generateMips( &image[0], width, height, img::EMipFilter::None, false, levels ) == 1 );
+			check( levels.size() == image.size() );
+		}
+
+		leave_unit;
+	}
+}
+}
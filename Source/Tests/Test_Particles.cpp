@@ -0,0 +1,245 @@
+//-----------------------------------------------------------------------------
+//	Test_Particles.cpp: Particles update tests
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Tests.h"
+
+namespace flu
+{
+namespace tests
+{
+	static const Int32 NUM_EMITTERS = 50;
+	static const Int32 PARTICLES_PER_EMITTER = 2000;
+	static const Int32 NUM_FRAMES = 60;
+	static const Float FRAME_DELTA = 1.f / 60.f;
+
+	static const Int32 ANGLE_TOLERANCE = 128;
+
+	static Bool anglesMatch( math::Angle a, math::Angle b )
+	{
+		const Int32 difference = ( Int32( a ) - Int32( b ) ) & 0xffff;
+		return min( difference, 0x10000 - difference ) <= ANGLE_TOLERANCE;
+	}
+
+	static TParticle makeParticle( Float life )
+	{
+		TParticle particle;
+
+		particle.Location = math::Vector( RandomRange( -100.f, 100.f ), RandomRange( -100.f, 100.f ) );
+		particle.Speed = math::Vector( RandomRange( -5.f, 5.f ), RandomRange( -5.f, 5.f ) );
+		particle.Rotation = 0;
+		particle.SpinRate = RandomRange( -1.f, 1.f );
+		particle.Size = 1.f;
+		particle.Life = life;
+		particle.MaxLifeInv = 1.f / life;
+		particle.Phase = RandomRange( 0.f, 2.f * math::PI );
+		particle.iTile = 0;
+
+		return particle;
+	}
+
+	/**
+	 *	The scalar per particle update, as it was before
+	 */
+	static void updateReference( Array<TParticle>& particles, const TParticleStep& step )
+	{
+		for( auto& p : particles )
+		{
+			if( step.Motion == PMT_Physics )
+			{
+				p.Location += p.Speed * step.Delta;
+				p.Speed += step.Acceleration * step.Delta;
+			}
+			else
+			{
+				Float t = p.Life * p.MaxLifeInv * ( 2.f * math::PI ) + p.Phase;
+
+				p.Location.x = p.Speed.x + step.X * math::sin( step.Alpha * t + step.Shift );
+				p.Location.y = p.Speed.y + step.Y * math::sin( step.Beta * t );
+			}
+
+			p.Life -= step.Delta;
+			p.Rotation += step.Delta * p.SpinRate;
+
+			if( step.bLinearSize )
+			{
+				p.Size = step.SizeRange[0] + ( step.SizeRange[1] - step.SizeRange[0] ) * ( 1.f - p.Life * p.MaxLifeInv );
+			}
+		}
+	}
+
+	static Bool matchReference( const CParticleSet& set, const Array<TParticle>& particles )
+	{
+		if( set.Num() != particles.size() )
+		{
+			return false;
+		}
+
+		for( Int32 i = 0; i < set.Num(); ++i )
+		{
+			if( abs( set.LocationX[i] - particles[i].Location.x ) > 0.01f ||
+				abs( set.LocationY[i] - particles[i].Location.y ) > 0.01f ||
+				abs( set.Size[i] - particles[i].Size ) > 0.01f ||
+				!anglesMatch( set.Get( i ).Rotation, particles[i].Rotation ) )
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void test_Particles()
+	{
+		enter_unit( Particles );
+
+		// CParticleSet::Add and CParticleSet::Get
+		{
+			CParticleSet set;
+			set.SetLimit( 10 );
+
+			check( set.Num() == 0 && set.Limit() == 10 );
+			check( !set.HasBounds() );
+
+			TParticle particle = makeParticle( 1.f );
+			set.Add( particle );
+
+			TParticle stored = set.Get( 0 );
+			check( set.Num() == 1 && set.HasBounds() );
+			check( stored.Location == particle.Location );
+			check( stored.Life == particle.Life );
+			check( stored.SpinRate == particle.SpinRate );
+			check( anglesMatch( stored.Rotation, particle.Rotation ) );
+			check( set.Bounds().min == particle.Location && set.Bounds().max == particle.Location );
+		}
+
+		// outlived particles are removed, bounds cover alive only
+		{
+			CParticleSet set;
+			set.SetLimit( 7 );
+
+			for( Int32 i = 0; i < 7; ++i )
+			{
+				TParticle particle = makeParticle( i % 2 ? 10.f : 0.01f );
+				particle.Location = math::Vector( Float( i ), Float( -i ) );
+				particle.Speed = math::Vector( 0.f, 0.f );
+				set.Add( particle );
+			}
+
+			set.Update( TParticleStep( PMT_Physics, 0.1f ) );
+
+			check( set.Num() == 3 );
+			check( set.Bounds().min == math::Vector( 1.f, -5.f ) );
+			check( set.Bounds().max == math::Vector( 5.f, -1.f ) );
+		}
+
+		// spin rate is in radians per second, half turn in a second
+		{
+			CParticleSet set;
+			set.SetLimit( 1 );
+
+			TParticle particle = makeParticle( 100.f );
+			particle.Rotation = 0x1000;
+			particle.SpinRate = math::PI;
+			set.Add( particle );
+
+			for( Int32 frame = 0; frame < 60; ++frame )
+			{
+				set.Update( TParticleStep( PMT_Physics, 1.f / 60.f ) );
+			}
+
+			check( anglesMatch( set.Get( 0 ).Rotation, math::Angle( 0x1000 + 0x8000 ) ) );
+		}
+
+		// matches scalar update
+		{
+			TParticleStep physicsStep( PMT_Physics, FRAME_DELTA );
+			physicsStep.Acceleration = math::Vector( 0.f, -9.8f );
+			physicsStep.bLinearSize = true;
+			physicsStep.SizeRange[0] = 1.f;
+			physicsStep.SizeRange[1] = 3.f;
+
+			TParticleStep lissajousStep( PMT_Lissajous, FRAME_DELTA );
+			lissajousStep.Alpha = 1.5f;
+			lissajousStep.Shift = 20.f;
+			lissajousStep.X = 5.f;
+			lissajousStep.Y = 5.f;
+
+			const TParticleStep* steps[] = { &physicsStep, &lissajousStep };
+
+			for( const TParticleStep* step : steps )
+			{
+				CParticleSet set;
+				Array<TParticle> reference;
+
+				set.SetLimit( 1001 );
+
+				for( Int32 i = 0; i < set.Limit(); ++i )
+				{
+					TParticle particle = makeParticle( 100.f );
+					set.Add( particle );
+					reference.push( particle );
+				}
+
+				for( Int32 frame = 0; frame < NUM_FRAMES; ++frame )
+				{
+					set.Update( *step );
+					updateReference( reference, *step );
+				}
+
+				check( matchReference( set, reference ) );
+			}
+		}
+
+		// benchmark
+		{
+			TParticleStep step( PMT_Physics, FRAME_DELTA );
+			step.Acceleration = math::Vector( 0.f, -9.8f );
+
+			Array<CParticleSet> sets( NUM_EMITTERS );
+			Array<Array<TParticle>> references( NUM_EMITTERS );
+
+			for( Int32 i = 0; i < NUM_EMITTERS; ++i )
+			{
+				sets[i].SetLimit( PARTICLES_PER_EMITTER );
+
+				for( Int32 j = 0; j < PARTICLES_PER_EMITTER; ++j )
+				{
+					TParticle particle = makeParticle( 100.f );
+					sets[i].Add( particle );
+					references[i].push( particle );
+				}
+			}
+
+			UInt64 startTime = time::cycles64();
+
+			for( Int32 frame = 0; frame < NUM_FRAMES; ++frame )
+			{
+				for( auto& it : references )
+				{
+					updateReference( it, step );
+				}
+			}
+
+			Double scalarTime = time::elapsedMsFrom( startTime ) / NUM_FRAMES;
+			startTime = time::cycles64();
+
+			for( Int32 frame = 0; frame < NUM_FRAMES; ++frame )
+			{
+				for( auto& it : sets )
+				{
+					it.Update( step );
+				}
+			}
+
+			Double simdTime = time::elapsedMsFrom( startTime ) / NUM_FRAMES;
+
+			info( L"%d particles in %d emitters: scalar %.4f ms, soa %.4f ms per frame", 
+				NUM_EMITTERS * PARTICLES_PER_EMITTER, NUM_EMITTERS, scalarTime, simdTime );
+		}
+
+		leave_unit;
+	}
+}
+}
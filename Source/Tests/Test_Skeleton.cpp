@@ -0,0 +1,186 @@
+//-----------------------------------------------------------------------------
+//	Test_Skeleton.cpp: Skeleton animator tests
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Tests.h"
+
+namespace flu
+{
+namespace tests
+{
+	static const Int32 NUM_INSTANCES = 500;
+	static const Int32 NUM_DISTINCT_TIMES = 10;
+	static const Float LOCATION_TOLERANCE = 0.05f;
+	static const Int32 ROTATION_TOLERANCE = 64;
+
+	/**
+	 *	A skeleton with all kinds of controllers: a master, a chain
+	 *	of bones, IK solver, look-at bone and a free bone
+	 */
+	static void buildSkeleton( FSkeleton& skeleton )
+	{
+		skeleton.Bones.setSize( 7 );
+		skeleton.RefPose.BonesPose.setSize( 7 );
+
+		skeleton.Bones[0] = TBoneInfo( SC_Master, L"Root", math::colors::WHITE );
+		skeleton.Bones[1] = TBoneInfo( SC_Bone, L"Spine", math::colors::WHITE );
+		skeleton.Bones[2] = TBoneInfo( SC_Bone, L"Thigh", math::colors::WHITE );
+		skeleton.Bones[3] = TBoneInfo( SC_Bone, L"Calf", math::colors::WHITE );
+		skeleton.Bones[4] = TBoneInfo( SC_IKSolver, L"Foot", math::colors::WHITE );
+		skeleton.Bones[5] = TBoneInfo( SC_Bone, L"Head", math::colors::WHITE );
+		skeleton.Bones[6] = TBoneInfo( SC_Bone, L"Free", math::colors::WHITE );
+
+		skeleton.Bones[1].iPosCtrl = 0;
+		skeleton.Bones[1].iRotCtrl = 0;
+
+		skeleton.Bones[2].iPosCtrl = 1;
+		skeleton.Bones[2].iRotCtrl = 4;
+		skeleton.Bones[2].Scale = 5.f;
+
+		skeleton.Bones[3].iPosCtrl = 2;
+		skeleton.Bones[3].iRotCtrl = 4;
+		skeleton.Bones[3].Scale = 5.f;
+
+		skeleton.Bones[4].iPosCtrl = 0;
+		skeleton.Bones[4].iEndJoint = 3;
+		skeleton.Bones[4].bFlipIK = true;
+
+		skeleton.Bones[5].iPosCtrl = 1;
+		skeleton.Bones[5].iRotCtrl = 0;
+		skeleton.Bones[5].bLookAt = true;
+
+		const math::Vector locations[] = { { 0.f, 0.f }, { 0.f, 3.f }, { 0.5f, 0.f }, { 5.f, 0.f },
+			{ 1.f, -3.f }, { 0.f, 2.f }, { 7.f, 7.f } };
+
+		for( Int32 i = 0; i < skeleton.Bones.size(); ++i )
+		{
+			skeleton.RefPose.BonesPose[i] = TBonePose( locations[i], math::Angle( Random( 0x10000 ) ) );
+		}
+
+		skeleton.BuildTransformationTable();
+
+		// two actions, with and without position tracks
+		skeleton.Actions.setSize( 2 );
+
+		for( Int32 i = 0; i < skeleton.Actions.size(); ++i )
+		{
+			TSkeletonAction& action = skeleton.Actions[i];
+			action.Name = String::format( L"Action%d", i );
+
+			for( Int32 iBone : { 0, 1, 4, 6 } )
+			{
+				TBoneTrack track( iBone );
+
+				for( Float t = 0.f; t <= 1.f; t += 0.25f )
+				{
+					track.RotKeys.addSample( t, math::Angle( Random( 0x10000 ) ) );
+
+					if( i == 0 || iBone == 4 )
+					{
+						track.PosKeys.addSample( t, locations[iBone] +
+							math::Vector( RandomRange( -1.f, 1.f ), RandomRange( -1.f, 1.f ) ) );
+					}
+				}
+
+				action.BoneTracks.push( track );
+			}
+		}
+	}
+
+	static Bool isPoseEqual( const TSkelPose& a, const TSkelPose& b )
+	{
+		if( a.BonesPose.size() != b.BonesPose.size() )
+		{
+			return false;
+		}
+
+		for( Int32 i = 0; i < a.BonesPose.size(); ++i )
+		{
+			const TBonePose& boneA = a.BonesPose[i];
+			const TBonePose& boneB = b.BonesPose[i];
+
+			Int32 rotationDelta = ( Int32( boneA.Rotation ) - Int32( boneB.Rotation ) ) & 0xffff;
+
+			if( min( rotationDelta, 0x10000 - rotationDelta ) > ROTATION_TOLERANCE ||
+				abs( boneA.Location.x - boneB.Location.x ) > LOCATION_TOLERANCE ||
+				abs( boneA.Location.y - boneB.Location.y ) > LOCATION_TOLERANCE )
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void test_Skeleton()
+	{
+		enter_unit( Skeleton );
+
+		job::ScopedJobSystem jobSystem( threading::getCPUCoresCount() );
+
+		FSkeleton skeleton;
+		buildSkeleton( skeleton );
+
+		Array<Int32> actions( NUM_INSTANCES );
+		Array<Float> times( NUM_INSTANCES );
+		Array<Float> sharedTimes( NUM_INSTANCES );
+
+		for( Int32 i = 0; i < NUM_INSTANCES; ++i )
+		{
+			actions[i] = Random( skeleton.Actions.size() + 1 ) - 1;
+			times[i] = RandomF();
+			sharedTimes[i] = Random( NUM_DISTINCT_TIMES ) / Float( NUM_DISTINCT_TIMES );
+		}
+
+		// animator matches per instance evaluation
+		for( const Array<Float>* instanceTimes : { &times, &sharedTimes } )
+		{
+			Array<TSkelPose> referencePoses( NUM_INSTANCES );
+			Array<TSkelPose> batchedPoses( NUM_INSTANCES );
+
+			UInt64 startTime = time::cycles64();
+
+			for( Int32 i = 0; i < NUM_INSTANCES; ++i )
+			{
+				referencePoses[i] = skeleton.RefPose;
+
+				if( actions[i] != -1 )
+				{
+					referencePoses[i].CumputeAnimFrame( &skeleton, skeleton.Actions[actions[i]], ( *instanceTimes )[i] );
+				}
+				else
+				{
+					referencePoses[i].ComputeRefTransform( &skeleton );
+				}
+			}
+
+			Double referenceTime = time::elapsedMsFrom( startTime );
+			startTime = time::cycles64();
+
+			CSkeletonAnimator animator;
+
+			for( Int32 i = 0; i < NUM_INSTANCES; ++i )
+			{
+				animator.Submit( &skeleton, actions[i], ( *instanceTimes )[i], &batchedPoses[i] );
+			}
+
+			check( animator.NumRequests() == NUM_INSTANCES );
+			animator.Flush();
+			check( animator.NumRequests() == 0 );
+
+			Double batchedTime = time::elapsedMsFrom( startTime );
+
+			for( Int32 i = 0; i < NUM_INSTANCES; ++i )
+			{
+				check( isPoseEqual( referencePoses[i], batchedPoses[i] ) );
+			}
+
+			info( L"%d skeletons%s: per instance %.4f ms, batched %.4f ms", NUM_INSTANCES,
+				instanceTimes == &sharedTimes ? L" with shared frames" : L"", referenceTime, batchedTime );
+		}
+
+		leave_unit;
+	}
+}
+}
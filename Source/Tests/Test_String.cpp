@@ -0,0 +1,230 @@
+//-----------------------------------------------------------------------------
+//	Test_String.cpp: String tests
+//	Created by Vlad Gordienko, 2019
+//-----------------------------------------------------------------------------
+
+#include "Tests.h"
+
+namespace flu
+{
+namespace tests
+{
+	/**
+	 *	A shared data for the stress test threads
+	 */
+	struct StringStressContext
+	{
+		String sharedString;
+		Array<String> sharedArray;
+		concurrency::Atomic numFailed;
+	};
+
+	static const Int32 STRESS_THREADS_COUNT = 4;
+	static const Int32 STRESS_ITERATIONS_COUNT = 20000;
+
+	static void stringStressThread( void* arg )
+	{
+		StringStressContext* context = reinterpret_cast<StringStressContext*>( arg );
+
+		for( Int32 i = 0; i < STRESS_ITERATIONS_COUNT; ++i )
+		{
+			// copy shared heap data and drop it in different orders
+			String a = context->sharedString;
+			String b = context->sharedArray[i % context->sharedArray.size()];
+			String c( a );
+
+			c += L"!";
+			b = a;
+			a = String();
+
+			if( b != context->sharedString || c.len() != context->sharedString.len() + 1 )
+			{
+				context->numFailed.increment();
+			}
+
+			// thread local data goes to the thread's pool
+			String local = String::format( L"Thread local string number %d", i );
+			local += local;
+
+			if( local.len() == 0 )
+			{
+				context->numFailed.increment();
+			}
+		}
+	}
+
+	void test_String()
+	{
+		enter_unit( String );
+
+		// String::String
+		{
+			String emptyString;
+			String nullString( nullptr );
+			String copyString( emptyString );
+
+			check( emptyString.len() == 0 );
+			check( nullString.len() == 0 );
+			check( copyString.len() == 0 );
+			check( !emptyString );
+			check( *emptyString != nullptr && **emptyString == L'\0' );
+			check( emptyString == nullString );
+		}
+
+		// Inline storage
+		{
+			String shortString = L"Flu";
+			String copyString = shortString;
+
+			check( shortString.isInline() );
+			check( shortString.len() == 3 );
+			check( copyString == L"Flu" );
+			check( *copyString != *shortString );
+
+			Char boundary[String::INLINE_CAPACITY + 2];
+
+			for( SizeT i = 0; i < String::INLINE_CAPACITY + 1; ++i )
+			{
+				boundary[i] = L'a' + static_cast<Char>( i );
+			}
+
+			boundary[String::INLINE_CAPACITY] = L'\0';
+			String fitString = boundary;
+
+			check( fitString.isInline() );
+			check( fitString.len() == String::INLINE_CAPACITY );
+
+			boundary[String::INLINE_CAPACITY] = L'z';
+			boundary[String::INLINE_CAPACITY + 1] = L'\0';
+			String heapString = boundary;
+
+			check( !heapString.isInline() );
+			check( heapString.len() == String::INLINE_CAPACITY + 1 );
+			check( heapString.refsCount() == 1 );
+		}
+
+		// Shared data
+		{
+			String longString = L"A long string, which is stored in the heap";
+			String copyString = longString;
+
+			check( !longString.isInline() );
+			check( longString.refsCount() == 2 );
+			check( *copyString == *longString );
+
+			// copy on write
+			copyString[0] = L'B';
+			check( longString.refsCount() == 1 );
+			check( copyString.refsCount() == 1 );
+			check( longString[0] == L'A' );
+			check( copyString[0] == L'B' );
+
+			String movedString = static_cast<String&&>( copyString );
+			check( copyString.len() == 0 );
+			check( movedString.refsCount() == 1 );
+			check( movedString[0] == L'B' );
+		}
+
+		// String::operator+=
+		{
+			String myString = L"Hi";
+			myString += L", ";
+
+			check( myString == L"Hi, " );
+			check( myString.isInline() );
+
+			myString += L"World";
+			myString += L"! How are you doing?";
+			check( myString == L"Hi, World! How are you doing?" );
+			check( !myString.isInline() );
+
+			// append self
+			String twice = L"Abc";
+			twice += twice;
+			twice += *twice;
+			check( twice == L"AbcAbcAbcAbc" );
+
+			String shared = myString;
+			shared += L"!";
+			check( myString == L"Hi, World! How are you doing?" );
+			check( shared == L"Hi, World! How are you doing?!" );
+		}
+
+		// String comparison
+		{
+			String a = L"Alice";
+			String b = L"Bob";
+			String longA = L"Alice and Bob are the well known characters";
+			String longB = longA;
+
+			check( a != b );
+			check( a < b );
+			check( a == L"Alice" );
+			check( longA == longB );
+			check( longA != a );
+			check( String() == L"" );
+			check( a.hashCode() == String( L"Alice" ).hashCode() );
+		}
+
+		// Array of strings
+		{
+			Array<String> names;
+
+			for( Int32 i = 0; i < 100; ++i )
+			{
+				names.push( String::format( i % 2 ? L"%d" : L"Long name of the string number %d", i ) );
+			}
+
+			// bitwise relocation mustn't break inline strings
+			names.setSize( 1000 );
+
+			check( names[0] == L"Long name of the string number 0" );
+			check( names[1] == L"1" );
+			check( names[99] == L"99" );
+			check( names[999].len() == 0 );
+		}
+
+		// Multithreaded stress test
+		{
+			const WideStringManager::Stats statsBefore = g_wideStringManager.threadStats();
+
+			StringStressContext context;
+			context.sharedString = L"The string, which is shared between all the threads";
+			context.numFailed.setValue( 0 );
+
+			for( Int32 i = 0; i < 64; ++i )
+			{
+				context.sharedArray.push( context.sharedString );
+			}
+
+			check( context.sharedString.refsCount() == 65 );
+
+			threading::Thread* threads[STRESS_THREADS_COUNT];
+
+			for( Int32 i = 0; i < STRESS_THREADS_COUNT; ++i )
+			{
+				threads[i] = threading::Thread::create( stringStressThread, &context, "String Stress Thread" );
+			}
+
+			for( Int32 i = 0; i < STRESS_THREADS_COUNT; ++i )
+			{
+				threads[i]->wait();
+				delete threads[i];
+			}
+
+			check( context.numFailed.getValue() == 0 );
+			check( context.sharedString.refsCount() == 65 );
+
+			context.sharedArray.empty();
+			check( context.sharedString.refsCount() == 1 );
+
+			const WideStringManager::Stats& statsAfter = g_wideStringManager.threadStats();
+
+			info( L"Main thread strings: HeapAllocations: %d; PoolReuses: %d",
+				statsAfter.heapAllocations - statsBefore.heapAllocations, statsAfter.poolReuses - statsBefore.poolReuses );
+		}
+
+		leave_unit;
+	}
+}
+}
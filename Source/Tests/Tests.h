@@ -54,18 +54,41 @@ namespace tests
 	// all units, all units...
 	extern void test_Array();
 	//extern void test_Set();
-	//extern void test_String();
+	extern void test_String();
 	extern void test_File();
 	extern void test_Map();
+	extern void test_Log();
+	extern void test_Particles();
+	extern void test_DemoEffects();
+	extern void test_Skeleton();
+	extern void test_Mipmap();
+	extern void test_BlockCompression();
+	extern void test_AtlasPacker();
+	extern void test_DistanceField();
+	extern void test_LZCompressor();
+	extern void test_JSon();
+	extern void test_JSonStream();
+	extern void test_LayoutCache();
 
 	static const TestFunction g_tests[] = 
 	{
 		test_Array,
 		//test_Set,
-		//test_String,
+		test_String,
 		test_File,
-		test_Map
-		//test_JSon,
+		test_Map,
+		test_Log,
+		test_Particles,
+		test_DemoEffects,
+		test_Skeleton,
+		test_Mipmap,
+		test_BlockCompression,
+		test_AtlasPacker,
+		test_DistanceField,
+		test_LZCompressor,
+		test_JSon,
+		test_JSonStream,
+		test_LayoutCache
 		//test_Lexer,
 		//test_HandleArray,
 		//test_RingQueue
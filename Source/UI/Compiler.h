@@ -13,6 +13,8 @@ namespace ui
 	class Compiler final: public res::IResourceCompiler
 	{
 	public:
+		static const constexpr Char* COMPILER_MARK = TXT( "layout_1" );
+
 		Compiler();
 		~Compiler();
 
@@ -25,6 +27,11 @@ namespace ui
 
 			return ext == TXT( "layout" );
 		}
+
+		String compilerMark() const override
+		{
+			return COMPILER_MARK;
+		}
 	};
 }
 }
\ No newline at end of file
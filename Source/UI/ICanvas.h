@@ -47,6 +47,9 @@ namespace ui
 		virtual void drawTextLine( const Position& pos, const Char* text, Int32 len, math::Color color,
 			fnt::Font::Ptr font, Float xScale = 1.f, Float yScale = 1.f ) = 0;
 
+		virtual Float textWidth( const Char* text, Int32 len, fnt::Font::Ptr font, 
+			Float xScale = 1.f, Float yScale = 1.f ) = 0;
+
 		virtual void drawLine( const Position& from, const Position& to, math::Color color ) = 0;
 
 		virtual void pushClipArea( const Position& pos, const Size& size ) = 0;
@@ -80,25 +80,29 @@ namespace rendering
 		// experimental!!
 		ImageOp& op = findOrCreateImageOp( image->getSRV() );
 
+		// images from one atlas share the same op
+		const math::Vector uv0 = image->isAtlasRegion() ? image->mapTexCoords( tc0 ) : tc0;
+		const math::Vector uv1 = image->isAtlasRegion() ? image->mapTexCoords( tc1 ) : tc1;
+
 		UInt32 firstVtxIndex = op.vertices.size();
 
 		auto vertices = op.vertices.obtainRaw( 4 );
 		auto indices = op.indices.obtainRaw( 6 );
 
 		vertices[0].pos = { pos.x, pos.y };
-		vertices[0].tc = { tc0.x, tc0.y };
+		vertices[0].tc = { uv0.x, uv0.y };
 		vertices[0].color = math::colors::WHITE;
 
 		vertices[1].pos = { pos.x, pos.y + size.height };
-		vertices[1].tc = { tc0.x, tc1.y };
+		vertices[1].tc = { uv0.x, uv1.y };
 		vertices[1].color = math::colors::WHITE;
 
 		vertices[2].pos = { pos.x + size.width, pos.y + size.height };
-		vertices[2].tc = { tc1.x, tc1.y };
+		vertices[2].tc = { uv1.x, uv1.y };
 		vertices[2].color = math::colors::WHITE;
 
 		vertices[3].pos = { pos.x + size.width, pos.y };
-		vertices[3].tc = { tc1.x, tc0.y };
+		vertices[3].tc = { uv1.x, uv0.y };
 		vertices[3].color = math::colors::WHITE;
 
 		indices[0] = firstVtxIndex + 0;
@@ -123,14 +127,19 @@ namespace rendering
 	void Canvas::drawTextLine( const Position& pos, const Char* text, Int32 len, math::Color color,
 		fnt::Font::Ptr font, Float xScale, Float yScale )
 	{
-		TextOp& op = findOrCreateTextOp( font->getImage()->getSRV() );
+		TextOp& op = findOrCreateTextOp( font->getImage()->getSRV(), font->isDistanceField() );
 
 		UInt32 firstVtxIndex = op.vertices.size();
 
 		auto vertices = op.vertices.obtainRaw( fnt::getBatchVertexCount( len ) );
 		auto indices = op.indices.obtainRaw( fnt::getBatchIndexCount( len ) );
 
-		fnt::batchLine( text, len, font, color, vertices, firstVtxIndex, indices, {pos.x, pos.y}, xScale, yScale );
+		m_layoutCache.batchLine( text, len, font, color, vertices, firstVtxIndex, indices, {pos.x, pos.y}, xScale, yScale );
+	}
+
+	Float Canvas::textWidth( const Char* text, Int32 len, fnt::Font::Ptr font, Float xScale, Float yScale )
+	{
+		return m_layoutCache.textWidth( text, len, font, xScale, yScale );
 	}
 
 	void Canvas::drawLine( const Position& from, const Position& to, math::Color color )
@@ -175,7 +184,7 @@ namespace rendering
 		return count > 0 ? &m_textOps[0] : nullptr;
 	}
 
-	TextOp& Canvas::findOrCreateTextOp( rend::ShaderResourceView srv )
+	TextOp& Canvas::findOrCreateTextOp( rend::ShaderResourceView srv, Bool distanceField )
 	{
 		// O(n) is ok, still we have only a couple fonts per layout
 		for( Int32 i = 0; i < m_textOps.size(); ++i )
@@ -188,6 +197,7 @@ namespace rendering
 
 		TextOp newOp;
 		newOp.srv = srv;
+		newOp.distanceField = distanceField;
 		m_textOps.push( newOp );
 
 		return m_textOps.last();
@@ -41,6 +41,9 @@ namespace rendering
 		void drawTextLine( const Position& pos, const Char* text, Int32 len, math::Color color,
 			fnt::Font::Ptr font, Float xScale = 1.f, Float yScale = 1.f ) override;
 
+		Float textWidth( const Char* text, Int32 len, fnt::Font::Ptr font, 
+			Float xScale = 1.f, Float yScale = 1.f ) override;
+
 		void drawLine( const Position& from, const Position& to, math::Color color ) override;
 
 		void pushClipArea( const Position& pos, const Size& size ) override;
@@ -73,7 +76,10 @@ namespace rendering
 		Array<TextOp> m_textOps; // todo: replace with GrowOnlyArray
 		Array<ImageOp> m_imageOps; // todo: replace with GrowOnlyArray
 
-		TextOp& findOrCreateTextOp( rend::ShaderResourceView srv );
+		// most of labels are the same from frame to frame
+		fnt::LayoutCache m_layoutCache;
+
+		TextOp& findOrCreateTextOp( rend::ShaderResourceView srv, Bool distanceField );
 		ImageOp& findOrCreateImageOp( rend::ShaderResourceView srv );
 
 	private:
@@ -142,6 +142,7 @@ namespace rendering
 				batch.firstIndex = firstIdxIndex;
 				batch.numIndices = op->indices.size();
 				batch.srv = op->srv;
+				batch.distanceField = op->distanceField;
 				m_textBatches.push( batch );
 			}
 		}
@@ -180,8 +181,9 @@ namespace rendering
 		}
 	}
 
-	void Layer::drawTextBatches( rend::Device* device, ffx::Effect::Ptr effect )
+	void Layer::drawTextBatches( rend::Device* device, const TextStream& stream )
 	{
+		ffx::Effect::Ptr effect = stream.getEffect();
 		assert( device && effect.hasObject() );
 
 		device->setTopology( rend::EPrimitiveTopology::TriangleList );
@@ -191,6 +193,7 @@ namespace rendering
 
 		for( auto& it : m_textBatches )
 		{
+			effect->setTechnique( it.distanceField ? stream.getDistanceFieldTech() : stream.getMainTech() );
 			effect->setSRV( 0, it.srv );
 			effect->apply();
 
@@ -36,7 +36,7 @@ namespace rendering
 
 		void drawFlatShadeBatches( rend::Device* device, ffx::Effect::Ptr effect );
 		void drawImageBatches( rend::Device* device, ffx::Effect::Ptr effect );
-		void drawTextBatches( rend::Device* device, ffx::Effect::Ptr effect );
+		void drawTextBatches( rend::Device* device, const TextStream& stream );
 
 		Bool hasFlatShadeBatches() const
 		{
@@ -81,6 +81,7 @@ namespace rendering
 			UInt32 firstIndex;
 			UInt32 numIndices;
 			rend::ShaderResourceView srv;
+			Bool distanceField;
 		};
 
 		GrowOnlyArray<FlatShadeBatch> m_flatShadeBatches;
@@ -58,6 +58,7 @@ namespace rendering
 		GrowOnlyArray<Vertex> vertices;
 		GrowOnlyArray<UInt16> indices;
 		rend::ShaderResourceView srv;
+		Bool distanceField;
 	};
 }
 }
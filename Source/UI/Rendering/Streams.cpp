@@ -35,6 +35,8 @@ namespace rendering
 		:	StreamBase<TextStream, TextOp::Vertex>( device )
 	{
 		// read techniques and variables offset
+		m_mainTech = m_effect->getTechnique( L"Main" );
+		m_distanceFieldTech = m_effect->getTechnique( L"DistanceField" );
 	}
 
 	TextStream::~TextStream()
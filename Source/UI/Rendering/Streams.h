@@ -175,6 +175,13 @@ namespace rendering
 
 		TextStream( rend::Device* device );
 		~TextStream();
+
+		ffx::TechniqueId getMainTech() const { return m_mainTech; }
+		ffx::TechniqueId getDistanceFieldTech() const { return m_distanceFieldTech; }
+
+	private:
+		ffx::TechniqueId m_mainTech;
+		ffx::TechniqueId m_distanceFieldTech;
 	};
 }
 }
@@ -165,7 +165,7 @@ namespace ui
 			if( layer.hasTextBatches() )
 			{
 				m_textStream.bindBuffers();
-				layer.drawTextBatches( m_device, m_textStream.getEffect() );
+				layer.drawTextBatches( m_device, m_textStream );
 			}
 
 			layer.clear();
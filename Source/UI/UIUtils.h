@@ -10,12 +10,13 @@ namespace ui
 namespace utils
 {
 	/**
-	 *	Return centered text position inside an element
+	 *	Return centered text position inside an element, text is
+	 *	measured by the canvas which draws it
 	 */
-	inline Position getCenterTextPosition( const Position& position, const Size& size,
+	inline Position getCenterTextPosition( ICanvas& canvas, const Position& position, const Size& size,
 		fnt::Font::Ptr font, const Char* text, Int32 len, Float xScale = 1.f, Float yScale = 1.f )
 	{
-		Float xOffset = 0.5f * ( size.width - font->textWidth( text, len ) * xScale );
+		Float xOffset = 0.5f * ( size.width - canvas.textWidth( text, len, font, xScale, yScale ) );
 		Float yOffset = 0.5f * ( size.height - font->maxHeight() * yScale );
 
 		return Position( position.x + xOffset, position.y + yOffset );
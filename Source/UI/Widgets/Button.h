@@ -94,7 +94,7 @@ namespace ui
 
 			const Float SCALE = 1.0f;
 
-			canvas.drawTextLine( utils::getCenterTextPosition( m_position, m_size, m_tempFont, *m_name, m_name.len(), SCALE, SCALE ), 
+			canvas.drawTextLine( utils::getCenterTextPosition( canvas, m_position, m_size, m_tempFont, *m_name, m_name.len(), SCALE, SCALE ), 
 				*m_name, m_name.len(), math::colors::WHITE, m_tempFont, SCALE, SCALE );
 
 			//canvas.drawRect( m_position, m_size, math::colors::WHITE );
@@ -88,6 +88,8 @@ namespace flu
 		// CCanvas interface.
 	void DrawPoly( const TRenderPoly& poly )
 	{
+		FlushBatches();
+
 		if( poly.Flags & POLY_FlatShade )
 		{
 			m_coloredEffect->setColor( 0, poly.Color );
@@ -152,6 +154,8 @@ namespace flu
 
 	void DrawRect( const TRenderRect& rect )
 	{
+		FlushBatches();
+
 		math::Vector Verts[4];
 
 		// Compute sprite vertices.
@@ -330,14 +334,14 @@ void App::Initialize(CoreApplicationView^ applicationView)
 	//m_deviceResources = std::make_shared<DX::DeviceResources>();//////////////////////////////
 
 	// Initial logging
-	//flu::LogManager::instance().addCallback( new flu::LogCallbackFile( L"XBox.log" ) );
+	//flu::LogManager::instance().addAsyncCallback( new flu::LogCallbackFile( L"XBox.log" ) );
 
 #if FLU_DEBUG
-	flu::LogManager::instance().addCallback( new flu::LogCallbackDebug( true ) );
+	flu::LogManager::instance().addAsyncCallback( new flu::LogCallbackDebug( true ) );
 
 	if( !IsDebuggerPresent() )
 	{
-		flu::LogManager::instance().addCallback( new flu::LogCallbackConsole() );
+		flu::LogManager::instance().addAsyncCallback( new flu::LogCallbackConsole() );
 	}
 #endif
 